@@ -235,6 +235,7 @@ SOURCES += \
   src/common/formatter.cpp \
   src/common/fueltool.cpp \
   src/common/htmlinfobuilder.cpp \
+  src/common/idlescheduler.cpp \
   src/common/jumpback.cpp \
   src/common/mapcolors.cpp \
   src/common/mapflags.cpp \
@@ -242,6 +243,7 @@ SOURCES += \
   src/common/maptools.cpp \
   src/common/maptypes.cpp \
   src/common/maptypesfactory.cpp \
+  src/common/perftrace.cpp \
   src/common/proctypes.cpp \
   src/common/settingsmigrate.cpp \
   src/common/symbolpainter.cpp \
@@ -253,10 +255,12 @@ SOURCES += \
   src/common/vehicleicons.cpp \
   src/connect/connectclient.cpp \
   src/connect/connectdialog.cpp \
+  src/connect/simdatabuffer.cpp \
   src/db/databasedialog.cpp \
   src/db/databasemanager.cpp \
   src/db/databaseprogressdialog.cpp \
   src/db/dbtypes.cpp \
+  src/db/indexadvisor.cpp \
   src/export/csvexporter.cpp \
   src/export/exporter.cpp \
   src/export/htmlexporter.cpp \
@@ -286,6 +290,7 @@ SOURCES += \
   src/mapgui/mapscale.cpp \
   src/mapgui/mapscreenindex.cpp \
   src/mapgui/maptooltip.cpp \
+  src/mapgui/mapviewwindow.cpp \
   src/mapgui/mapvisible.cpp \
   src/mapgui/mapwidget.cpp \
   src/mappainter/mappainter.cpp \
@@ -376,7 +381,9 @@ SOURCES += \
   src/userdata/userdatadialog.cpp \
   src/userdata/userdataicons.cpp \
   src/weather/weatherreporter.cpp \
+  src/weather/weathertrend.cpp \
   src/weather/windreporter.cpp \
+  src/web/mapimagecache.cpp \
   src/web/requesthandler.cpp \
   src/web/webapp.cpp \
   src/web/webcontroller.cpp \
@@ -397,6 +404,7 @@ HEADERS  += \
   src/common/formatter.h \
   src/common/fueltool.h \
   src/common/htmlinfobuilder.h \
+  src/common/idlescheduler.h \
   src/common/jumpback.h \
   src/common/mapcolors.h \
   src/common/mapflags.h \
@@ -404,6 +412,7 @@ HEADERS  += \
   src/common/maptools.h \
   src/common/maptypes.h \
   src/common/maptypesfactory.h \
+  src/common/perftrace.h \
   src/common/proctypes.h \
   src/common/settingsmigrate.h \
   src/common/symbolpainter.h \
@@ -415,10 +424,12 @@ HEADERS  += \
   src/common/vehicleicons.h \
   src/connect/connectclient.h \
   src/connect/connectdialog.h \
+  src/connect/simdatabuffer.h \
   src/db/databasedialog.h \
   src/db/databasemanager.h \
   src/db/databaseprogressdialog.h \
   src/db/dbtypes.h \
+  src/db/indexadvisor.h \
   src/export/csvexporter.h \
   src/export/exporter.h \
   src/export/htmlexporter.h \
@@ -447,6 +458,7 @@ HEADERS  += \
   src/mapgui/mapscale.h \
   src/mapgui/mapscreenindex.h \
   src/mapgui/maptooltip.h \
+  src/mapgui/mapviewwindow.h \
   src/mapgui/mapvisible.h \
   src/mapgui/mapwidget.h \
   src/mappainter/mappainter.h \
@@ -486,6 +498,7 @@ HEADERS  += \
   src/query/mapquery.h \
   src/query/procedurequery.h \
   src/query/querytypes.h \
+  src/query/spatialindex.h \
   src/query/waypointquery.h \
   src/query/waypointtrackquery.h \
   src/route/customproceduredialog.h \
@@ -537,7 +550,9 @@ HEADERS  += \
   src/userdata/userdatadialog.h \
   src/userdata/userdataicons.h \
   src/weather/weatherreporter.h \
+  src/weather/weathertrend.h \
   src/weather/windreporter.h \
+  src/web/mapimagecache.h \
   src/web/requesthandler.h \
   src/web/webapp.h \
   src/web/webcontroller.h \
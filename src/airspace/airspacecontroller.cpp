@@ -31,6 +31,8 @@
 #include "options/optionsdialog.h"
 #include "fs/userdata/airspacereaderopenair.h"
 #include "sql/sqltransaction.h"
+#include "sql/sqlutil.h"
+#include "settings/settings.h"
 #include "gui/textdialog.h"
 #include "util/htmlbuilder.h"
 #include "fs/common/metadatawriter.h"
@@ -38,6 +40,7 @@
 #include "gui/errorhandler.h"
 
 #include <QAction>
+#include <QCryptographicHash>
 #include <QDir>
 #include <QDirIterator>
 #include <QProgressDialog>
@@ -193,17 +196,52 @@ void AirspaceController::getAirspacesInternal(AirspaceVector& airspaceVector, co
   }
 }
 
-void AirspaceController::getAirspaces(AirspaceVector& airspaces, const Marble::GeoDataLatLonBox& rect,
+bool AirspaceController::needsUpdateInternal(const Marble::GeoDataLatLonBox& rect, const MapLayer *mapLayer,
+                                             map::MapAirspaceFilter filter, float flightPlanAltitude,
+                                             map::MapAirspaceSources src) const
+{
+  if((src& map::AIRSPACE_SRC_USER) && loadingUserAirspaces)
+    return false;
+
+  if(src & sources)
+  {
+    AirspaceQuery *query = queries.value(src);
+    if(query != nullptr)
+      return query->needsUpdate(rect, mapLayer, filter, flightPlanAltitude);
+  }
+  return false;
+}
+
+bool AirspaceController::getAirspaces(AirspaceVector& airspaces, const Marble::GeoDataLatLonBox& rect,
                                       const MapLayer *mapLayer, map::MapAirspaceFilter filter,
                                       float flightPlanAltitude, bool lazy,
-                                      map::MapAirspaceSources sources)
+                                      map::MapAirspaceSources sources, bool incremental)
 {
+  bool complete = true, reloaded = false;
+
   // Merge airspace pointers from all sources/caches into one list
   for(map::MapAirspaceSources src : map::MAP_AIRSPACE_SRC_VALUES)
   {
     if(sources & src)
-      getAirspacesInternal(airspaces, rect, mapLayer, filter, flightPlanAltitude, lazy, src);
+    {
+      bool lazySrc = lazy;
+      if(incremental && !lazy && needsUpdateInternal(rect, mapLayer, filter, flightPlanAltitude, src))
+      {
+        if(reloaded)
+        {
+          // Another source already ran its queries in this call - keep this one on the
+          // stale cached list and report incomplete so the caller comes back for it
+          lazySrc = true;
+          complete = false;
+        }
+        else
+          reloaded = true;
+      }
+
+      getAirspacesInternal(airspaces, rect, mapLayer, filter, flightPlanAltitude, lazySrc, src);
+    }
   }
+  return complete;
 }
 
 const atools::geo::LineString *AirspaceController::getAirspaceGeometry(map::MapAirspaceId id)
@@ -219,6 +257,20 @@ const atools::geo::LineString *AirspaceController::getAirspaceGeometry(map::MapA
   return nullptr;
 }
 
+const atools::geo::LineString *AirspaceController::getSimplifiedAirspaceGeometry(map::MapAirspaceId id,
+                                                                                 float maxErrorMeter)
+{
+  if((id.src & map::AIRSPACE_SRC_USER) && loadingUserAirspaces)
+    // Avoid deadlock while loading user airspaces
+    return nullptr;
+
+  AirspaceQuery *query = queries.value(id.src);
+  if(query != nullptr)
+    return query->getSimplifiedAirspaceGeometry(id.id, maxErrorMeter);
+
+  return nullptr;
+}
+
 void AirspaceController::restoreState()
 {
   Ui::MainWindow *ui = NavApp::getMainUi();
@@ -334,11 +386,41 @@ void AirspaceController::loadAirspaces()
   {
     qDebug() << Q_FUNC_INFO << basePath;
 
+    // Prepare filters and flags for folder search ========================
+    QStringList filter = OptionData::instance().getCacheUserAirspaceExtensions().simplified().split(" ");
+    QDir::Filters filterFlags = QDir::Files | QDir::Hidden | QDir::System;
+    QDirIterator::IteratorFlags iterFlags = QDirIterator::Subdirectories | QDirIterator::FollowSymlinks;
+
+    // Count files for progress and build a fingerprint of the file set =========================
+    int numFiles = 0;
+    QCryptographicHash fileHash(QCryptographicHash::Md5);
+    QDirIterator countDirIter(basePath, filter, filterFlags, iterFlags);
+    while(countDirIter.hasNext())
+    {
+      countDirIter.next();
+      QFileInfo fileinfo = countDirIter.fileInfo();
+      fileHash.addData(fileinfo.filePath().toUtf8());
+      fileHash.addData(QByteArray::number(fileinfo.size()));
+      fileHash.addData(QByteArray::number(fileinfo.lastModified().toMSecsSinceEpoch()));
+      numFiles++;
+    }
+    QString fingerprint = QString(fileHash.result().toHex());
+
+    atools::settings::Settings& settings = atools::settings::Settings::instance();
+    if(fingerprint == settings.valueStr(lnm::AIRSPACE_CONTROLLER_FILE_FINGERPRINT) &&
+       atools::sql::SqlUtil(NavApp::getDatabaseUserAirspace()).hasTableAndRows("boundary"))
+    {
+      // Same files, sizes and timestamps as at the last successful load - keep the compiled database
+      qDebug() << Q_FUNC_INFO << "User airspace files unchanged - keeping database";
+      mainWindow->setStatusMessage(tr("User airspace files are unchanged."));
+      return;
+    }
+
     // Disable queries to avoid locked database
     preLoadAirpaces();
 
     bool success = false;
-    int sceneryId = 1, fileId = 1, numRead = 0, numFiles = 0;
+    int sceneryId = 1, fileId = 1, numRead = 0;
     QStringList errors;
 
     try
@@ -355,19 +437,6 @@ void AirspaceController::loadAirspaces()
       atools::fs::common::MetadataWriter metadataWriter(*dbUserAirspace);
       metadataWriter.writeSceneryArea(basePath, "User Airspaces", sceneryId);
 
-      // Prepare filters and flags for folder search ========================
-      QStringList filter = OptionData::instance().getCacheUserAirspaceExtensions().simplified().split(" ");
-      QDir::Filters filterFlags = QDir::Files | QDir::Hidden | QDir::System;
-      QDirIterator::IteratorFlags iterFlags = QDirIterator::Subdirectories | QDirIterator::FollowSymlinks;
-
-      // Count files for progress =================================================
-      QDirIterator countDirIter(basePath, filter, filterFlags, iterFlags);
-      while(countDirIter.hasNext())
-      {
-        countDirIter.next();
-        numFiles++;
-      }
-
       // Set up progress dialog ==================================================
       QProgressDialog progress(tr("Reading airspaces ..."), tr("&Cancel"), 0, numFiles, mainWindow);
       progress.setWindowModality(Qt::WindowModal);
@@ -413,6 +482,9 @@ void AirspaceController::loadAirspaces()
       else
       {
         transaction.commit();
+
+        // Remember the file set so the next load with unchanged files can keep the database
+        settings.setValue(lnm::AIRSPACE_CONTROLLER_FILE_FINGERPRINT, fingerprint);
         success = true;
       }
     }
@@ -69,14 +69,21 @@ public:
   /* Get boundary merged with scenery and file metadata records. Not for online centers. */
   atools::sql::SqlRecord getAirspaceInfoRecordById(map::MapAirspaceId id);
 
-  /* Get airspaces from all enabled sources for map display */
-  void getAirspaces(AirspaceVector& airspaces, const Marble::GeoDataLatLonBox& rect, const MapLayer *mapLayer,
+  /* Get airspaces from all enabled sources for map display. If incremental is set only the first
+   * source which needs a database reload runs its queries while the remaining stale sources
+   * return their cached lists. Returns false in this case so the caller can schedule a redraw
+   * to fetch the next source. Always returns true with incremental unset. */
+  bool getAirspaces(AirspaceVector& airspaces, const Marble::GeoDataLatLonBox& rect, const MapLayer *mapLayer,
                     map::MapAirspaceFilter filter, float flightPlanAltitude, bool lazy,
-                    map::MapAirspaceSources sources);
+                    map::MapAirspaceSources sources, bool incremental = false);
 
   /* Get Geometry for any airspace and source database */
   const atools::geo::LineString *getAirspaceGeometry(map::MapAirspaceId id);
 
+  /* As above but returns a cached simplified boundary with an error below maxErrorMeter for map
+   * display on zoomed out views */
+  const atools::geo::LineString *getSimplifiedAirspaceGeometry(map::MapAirspaceId id, float maxErrorMeter);
+
   /* Read and write widget states, source and airspace selection */
   void restoreState();
   void saveState();
@@ -144,6 +151,11 @@ private:
   void getAirspacesInternal(AirspaceVector& airspaceVector, const Marble::GeoDataLatLonBox& rect,
                             const MapLayer *mapLayer, map::MapAirspaceFilter filter, float flightPlanAltitude,
                             bool lazy, map::MapAirspaceSources src);
+
+  /* True if the query for the source would have to reload from the database */
+  bool needsUpdateInternal(const Marble::GeoDataLatLonBox& rect, const MapLayer *mapLayer,
+                           map::MapAirspaceFilter filter, float flightPlanAltitude,
+                           map::MapAirspaceSources src) const;
   void preLoadAirpaces();
   void postLoadAirpaces();
 
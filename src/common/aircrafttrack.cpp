@@ -26,6 +26,9 @@
 #include <QDateTime>
 #include <QFile>
 
+const float AircraftTrack::SIMPLIFY_TOLERANCES_METER[AircraftTrack::NUM_SIMPLIFY_BUCKETS] =
+{10.f, 50.f, 250.f, 1000.f};
+
 AircraftTrack::AircraftTrack()
 {
 
@@ -95,6 +98,7 @@ bool AircraftTrack::readFromStream(QDataStream& in)
 {
   bool retval = false;
   clear();
+  clearSimplified();
 
   quint32 magic;
   quint16 version;
@@ -108,6 +112,7 @@ bool AircraftTrack::readFromStream(QDataStream& in)
     if(version == FILE_VERSION)
     {
       in >> *this;
+      rebuildSimplified();
       retval = true;
     }
     else
@@ -149,6 +154,7 @@ bool AircraftTrack::appendTrackPos(const atools::geo::Pos& pos, const QDateTime&
       if(pos.distanceMeterTo(last().pos) > atools::geo::nmToMeter(MAX_POINT_DISTANCE_NM))
       {
         clear();
+        clearSimplified();
         pruned = true;
       }
       else
@@ -157,15 +163,113 @@ bool AircraftTrack::appendTrackPos(const atools::geo::Pos& pos, const QDateTime&
         {
           for(int i = 0; i < PRUNE_TRACK_ENTRIES; i++)
             removeFirst();
+          pruneSimplified(PRUNE_TRACK_ENTRIES);
           pruned = true;
         }
       }
       append({pos, timestamp.toTime_t(), onGround});
     }
+    else
+      return pruned;
   }
+
+  // Extend the simplified tracks by the new point
+  for(int bucket = 0; bucket < NUM_SIMPLIFY_BUCKETS; bucket++)
+    updateSimplified(simplifiedTracks[bucket], SIMPLIFY_TOLERANCES_METER[bucket], size() - 1);
+
   return pruned;
 }
 
+const QVector<int>& AircraftTrack::getSimplifiedIndexes(float maxErrorMeter) const
+{
+  const static QVector<int> EMPTY;
+
+  // Use the coarsest simplified track which keeps the error below the given value
+  for(int bucket = NUM_SIMPLIFY_BUCKETS - 1; bucket >= 0; bucket--)
+  {
+    if(SIMPLIFY_TOLERANCES_METER[bucket] <= maxErrorMeter)
+      return simplifiedTracks[bucket].indexes;
+  }
+  return EMPTY;
+}
+
+float AircraftTrack::simplifyTolerance(float maxErrorMeter)
+{
+  // Use the coarsest tolerance which keeps the error below the given value
+  for(int bucket = NUM_SIMPLIFY_BUCKETS - 1; bucket >= 0; bucket--)
+  {
+    if(SIMPLIFY_TOLERANCES_METER[bucket] <= maxErrorMeter)
+      return SIMPLIFY_TOLERANCES_METER[bucket];
+  }
+  return 0.f;
+}
+
+void AircraftTrack::updateSimplified(SimplifiedTrack& simplified, float toleranceMeter, int index)
+{
+  QVector<int>& indexes = simplified.indexes;
+
+  if(indexes.size() < 2)
+    // Keep the first two points unconditionally
+    indexes.append(index);
+  else
+  {
+    // Deviation of the skipped preliminary end point from the extended segment
+    const atools::geo::Pos& anchor = at(indexes.at(indexes.size() - 2)).pos;
+    const atools::geo::Pos& previous = at(indexes.last()).pos;
+
+    atools::geo::LineDistance result;
+    previous.distanceMeterToLine(anchor, at(index).pos, result);
+    simplified.maxDeviation = std::max(simplified.maxDeviation, std::abs(result.distance));
+
+    if(simplified.maxDeviation > toleranceMeter)
+    {
+      // Error got too large - commit the previous point and open a new segment
+      simplified.maxDeviation = 0.f;
+      indexes.append(index);
+    }
+    else
+      // Move the preliminary end of the open segment to the new point
+      indexes.last() = index;
+  }
+}
+
+void AircraftTrack::rebuildSimplified()
+{
+  clearSimplified();
+  for(int i = 0; i < size(); i++)
+  {
+    for(int bucket = 0; bucket < NUM_SIMPLIFY_BUCKETS; bucket++)
+      updateSimplified(simplifiedTracks[bucket], SIMPLIFY_TOLERANCES_METER[bucket], i);
+  }
+}
+
+void AircraftTrack::pruneSimplified(int numRemoved)
+{
+  for(int bucket = 0; bucket < NUM_SIMPLIFY_BUCKETS; bucket++)
+  {
+    QVector<int>& indexes = simplifiedTracks[bucket].indexes;
+
+    // Drop indexes pointing to removed points
+    int num = 0;
+    while(num < indexes.size() && indexes.at(num) < numRemoved)
+      num++;
+    indexes.remove(0, num);
+
+    // Shift the remaining ones
+    for(int& index : indexes)
+      index -= numRemoved;
+  }
+}
+
+void AircraftTrack::clearSimplified()
+{
+  for(int bucket = 0; bucket < NUM_SIMPLIFY_BUCKETS; bucket++)
+  {
+    simplifiedTracks[bucket].indexes.clear();
+    simplifiedTracks[bucket].maxDeviation = 0.f;
+  }
+}
+
 float AircraftTrack::getMaxAltitude() const
 {
   float maxAlt = 0.f;
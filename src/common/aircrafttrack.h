@@ -20,6 +20,8 @@
 
 #include "geo/pos.h"
 
+#include <QVector>
+
 namespace atools {
 namespace geo {
 class LineString;
@@ -60,6 +62,7 @@ public:
   void clearTrack()
   {
     clear();
+    clearSimplified();
   }
 
   /*
@@ -94,7 +97,48 @@ public:
   /* Convert to linestring and timestamp values for export functions like GPX */
   void convert(atools::geo::LineString *track, QVector<quint32> *timestamps) const;
 
+  /* Get indexes of a simplified version of the track where the cross track error stays approximately
+   * below maxErrorMeter. One simplified track is maintained incrementally per tolerance while points
+   * are appended so painting touches a bounded point count on far zoom levels. First and newest point
+   * are always included. Returns an empty list if the requested error is smaller than the finest
+   * tolerance. Does not affect saving which always keeps all points. */
+  const QVector<int>& getSimplifiedIndexes(float maxErrorMeter) const;
+
+  /* Get the coarsest simplification tolerance in meter which keeps the cross track error below
+   * maxErrorMeter or 0 if the error is smaller than the finest tolerance. Allows other track
+   * sources like logbook trails to share the same tolerance buckets. */
+  static float simplifyTolerance(float maxErrorMeter);
+
 private:
+  /* Simplified track for one cross track error tolerance */
+  struct SimplifiedTrack
+  {
+    /* Indexes of the kept points. The last index is preliminary and is moved forward while appending. */
+    QVector<int> indexes;
+
+    /* Largest deviation of the skipped points from the currently open segment */
+    float maxDeviation = 0.f;
+  };
+
+  /* Extend a simplified track incrementally by the point at the given index */
+  void updateSimplified(SimplifiedTrack& simplified, float toleranceMeter, int index);
+
+  /* Rebuild all simplified tracks from scratch after loading a track from stream */
+  void rebuildSimplified();
+
+  /* Drop and shift indexes after removing points at the beginning of the track */
+  void pruneSimplified(int numRemoved);
+
+  void clearSimplified();
+
+  /* Number of tolerances from fine to coarse to keep simplified tracks for */
+  static Q_DECL_CONSTEXPR int NUM_SIMPLIFY_BUCKETS = 4;
+
+  /* Cross track error tolerances in meter from fine to coarse */
+  static const float SIMPLIFY_TOLERANCES_METER[NUM_SIMPLIFY_BUCKETS];
+
+  SimplifiedTrack simplifiedTracks[NUM_SIMPLIFY_BUCKETS];
+
   /* Maximum number of track points. If exceeded entries will be removed from beginning of the list */
   int maxTrackEntries = 20000;
   /* Number of entries to remove at once */
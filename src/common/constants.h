@@ -114,9 +114,17 @@ const QLatin1Literal DATABASE_USE_NAV("Database/UseNav");
 const QLatin1Literal DATABASE_SCENERYCONFIG("Database/SceneryConfig");
 const QLatin1Literal DATABASE_SIMULATOR("Database/Simulator");
 const QLatin1Literal DATABASE_LOAD_INACTIVE("Database/LoadInactive");
+
+/* Databases found compatible on an earlier start keyed by file, size and modification time */
+const QLatin1Literal DATABASE_VALIDATED("Database/Validated");
 const QLatin1Literal DATABASE_LOAD_ADDONXML("Database/LoadAddOnXml");
 const QLatin1Literal DATABASE_USER_AIRSPACE_PATH("Database/UserAirspacePath");
 
+/* Program version and database directory fingerprints of the last run. Compared on startup
+ * to select the cold, warm or hot startup path - see main.cpp */
+const QLatin1Literal STARTUP_FINGERPRINT_PROGRAM("Startup/FingerprintProgram");
+const QLatin1Literal STARTUP_FINGERPRINT_DATABASES("Startup/FingerprintDatabases");
+
 const QLatin1Literal EXPORT_FILEDIALOG("Export/FileDialog");
 const QLatin1Literal INFOWINDOW_CURRENTMAPOBJECTS("InfoWindow/CurrentMapObjects");
 const QLatin1Literal INFOWINDOW_CURRENTAIRSPACES("InfoWindow/CurrentMapAirspaces");
@@ -126,6 +134,8 @@ const QLatin1Literal INFOWINDOW_WIDGET_AIRPORT_TABS("InfoWindow/WidgetAirportTab
 const QLatin1Literal INFOWINDOW_WIDGET_AIRCRAFT_TABS("InfoWindow/WidgetAircraftTabs");
 const QLatin1Literal INFOWINDOW_MORE_LESS_PROGRESS("InfoWindow/MoreLessProgress");
 const QLatin1Literal MAINWINDOW_FIRSTAPPLICATIONSTART("MainWindow/FirstApplicationStart");
+const QLatin1Literal MAINWINDOW_MAPVIEWWINDOW("MainWindow/MapViewWindow");
+const QLatin1Literal MAINWINDOW_MAPVIEWWINDOW_VISIBLE("MainWindow/MapViewWindowVisible");
 const QLatin1Literal MAINWINDOW_WIDGET("MainWindow/Widget");
 const QLatin1Literal MAINWINDOW_WIDGET_DOCKHANDLER("MainWindow/WidgetDockHandler");
 const QLatin1Literal MAINWINDOW_PRINT_SIZE("MainWindow/PrintPreviewSize");
@@ -204,9 +214,17 @@ const QLatin1Literal AIRCRAFT_PERF_MERGE_DIALOG("AircraftPerformance/MergeDialog
 
 const QLatin1Literal AIRSPACE_CONTROLLER_WIDGETS("AirspaceController/Widget");
 
+/* Fingerprint of the user airspace files from the last successful load.
+ * Used to skip the recompilation for an unchanged file set. */
+const QLatin1Literal AIRSPACE_CONTROLLER_FILE_FINGERPRINT("AirspaceController/UserAirspaceFileFingerprint");
+
 /* General settings in the configuration file not covered by any GUI elements */
 const QLatin1Literal SETTINGS_INFOQUERY("Settings/InfoQuery");
 const QLatin1Literal SETTINGS_MAPQUERY("Settings/MapQuery");
+
+/* Percent factor applied to all query cache sizes. Allows to shrink the memory consumption on
+ * small machines or to grow all caches on machines with plenty of memory. */
+const QLatin1Literal SETTINGS_QUERY_CACHE_SIZE_PERCENT("Settings/QueryCacheSizePercent");
 const QLatin1Literal SETTINGS_DATABASE("Settings/Database");
 
 const QLatin1Literal APPROACHTREE_WIDGET("ApproachTree/Widget");
@@ -264,7 +282,25 @@ const QLatin1Literal OPTIONS_DIALOG_FONT("OptionsDialog/Font");
 const QLatin1Literal OPTIONS_DIALOG_MAP_FONT("OptionsDialog/MapFont");
 const QLatin1Literal OPTIONS_PIXMAP_CACHE("Options/PixmapCache");
 const QLatin1Literal OPTIONS_MARBLE_DEBUG("Options/MarbleDebug");
+
+/* Show per-painter render times as an overlay on the map and dump aggregated
+ * statistics to a CSV file in the settings directory on exit */
+const QLatin1Literal OPTIONS_MAP_RENDER_DEBUG("Options/MapRenderDebug");
+
+/* Minimum interval in milliseconds between map repaints from merged redraw triggers */
+const QLatin1Literal OPTIONS_MAP_UPDATE_THROTTLE_MS("Options/MapUpdateThrottleMs");
+
+/* Maximum size of the cached tooltip HTML in characters */
+const QLatin1Literal OPTIONS_MAP_TOOLTIP_CACHE_SIZE("Options/MapTooltipCacheSize");
+
+/* Collect scoped timing spans and write them as a Chrome trace JSON file in the
+ * settings directory on exit - see perftrace.h */
+const QLatin1Literal OPTIONS_PERF_TRACE("Options/PerformanceTrace");
 const QLatin1Literal OPTIONS_CONNECTCLIENT_DEBUG("Options/ConnectClientDebug");
+
+/* Region of interest radius around the user aircraft in NM. AI aircraft and ships received
+ * from the simulator outside of this radius are dropped at ingestion. 0 disables the filter. */
+const QLatin1Literal OPTIONS_CONNECTCLIENT_AI_RADIUS_NM("Options/ConnectClientAiRadiusNm");
 const QLatin1Literal OPTIONS_DOCKHANDLER_DEBUG("Options/DockHandlerDebug");
 const QLatin1Literal OPTIONS_WHAZZUP_PARSER_DEBUG("Options/WhazzupParserDebug");
 const QLatin1Literal OPTIONS_DATAREADER_DEBUG("Options/DataReaderDebug");
@@ -273,6 +309,8 @@ const QLatin1Literal OPTIONS_TRACK_DEBUG("Options/TrackDebug");
 const QLatin1Literal OPTIONS_WEATHER_LEVELS("Options/WeatherLevels");
 const QLatin1Literal OPTIONS_WIND_DEBUG("Options/WindDebug");
 const QLatin1Literal OPTIONS_WEBSERVER_DEBUG("Options/WebserverDebug");
+const QLatin1Literal OPTIONS_WEBSERVER_IMAGE_CACHE_SIZE("Options/WebserverImageCacheSize");
+const QLatin1Literal OPTIONS_WEBSERVER_IMAGE_CACHE_AGE_MS("Options/WebserverImageCacheAgeMs");
 const QLatin1Literal OPTIONS_VERSION("Options/Version");
 const QLatin1Literal OPTIONS_NO_USER_AGENT("Options/NoUserAgent");
 const QLatin1Literal OPTIONS_WEATHER_UPDATE("Options/WeatherUpdate");
@@ -23,6 +23,7 @@
 #include "geo/linestring.h"
 
 #include <marble/GeoDataLineString.h>
+#include <marble/MarbleGlobal.h>
 #include <marble/ViewportParams.h>
 
 #include <QLineF>
@@ -320,6 +321,51 @@ QVector<QPolygonF> CoordinateConverter::wToS(const GeoDataLineString& line) cons
   return retval;
 }
 
+bool CoordinateConverter::wToS(const LineString& linestring, QVector<QPointF>& screenPoints,
+                               QVector<bool>& visiblePoints, QVector<bool>& hiddenPoints, const QSize& size) const
+{
+  screenPoints.clear();
+  visiblePoints.clear();
+  hiddenPoints.clear();
+  screenPoints.reserve(linestring.size());
+  visiblePoints.reserve(linestring.size());
+  hiddenPoints.reserve(linestring.size());
+
+  bool anyVisible = false;
+  bool mercator = viewport->projection() == Marble::Mercator;
+
+  // Reused for all positions to avoid building a Marble coordinate object per position
+  GeoDataCoordinates coords;
+
+  for(const Pos& pos : linestring)
+  {
+    double x = 0., y = 0.;
+    bool hidden = false, visible = false;
+
+    if(pos.isValid())
+    {
+      if(mercator)
+        // Nothing is hidden behind the globe - use the plain conversion as a fast path
+        visible = viewport->screenCoordinates(pos.getLonX() * DEG2RAD, pos.getLatY() * DEG2RAD, x, y);
+
+      if(!mercator || !visible)
+      {
+        // Globe projection or position reported as not visible -
+        // use the repetition aware conversion like the single position methods
+        coords.setLongitude(pos.getLonX(), DEG);
+        coords.setLatitude(pos.getLatY(), DEG);
+        visible = wToSInternal(coords, x, y, size, &hidden);
+      }
+    }
+
+    screenPoints.append(QPointF(x, y));
+    visiblePoints.append(visible);
+    hiddenPoints.append(hidden);
+    anyVisible |= visible;
+  }
+  return anyVisible;
+}
+
 bool CoordinateConverter::sToW(int x, int y, atools::geo::Pos& pos) const
 {
   qreal lon, lat;
@@ -96,6 +96,16 @@ public:
   QVector<QPolygonF> wToS(const atools::geo::LineString& line) const;
   QVector<QPolygonF> wToS(const Marble::GeoDataLineString& line) const;
 
+  /* Convert all positions of a line string to screen coordinates in one call for the tight loops
+   * in the painters. Uses a direct conversion for the flat Mercator projection where nothing can
+   * be hidden behind the globe and reuses one Marble coordinate object otherwise.
+   * All result vectors get the same size as the line string. Visible means on screen and not
+   * hidden like in the single position methods. Invalid positions are neither visible nor hidden.
+   * @return true if at least one position is visible */
+  bool wToS(const atools::geo::LineString& linestring, QVector<QPointF>& screenPoints,
+            QVector<bool>& visiblePoints, QVector<bool>& hiddenPoints,
+            const QSize& size = DEFAULT_WTOS_SIZE) const;
+
   /*
    * Convert world to screen coordinates for GeoDataCoordinates
    * @param coords world coordinates
@@ -53,7 +53,11 @@ ElevationProvider::ElevationProvider(QObject *parent, const Marble::ElevationMod
 
 ElevationProvider::~ElevationProvider()
 {
-  delete globeReader;
+}
+
+ElevationProvider::ReaderHolder::~ReaderHolder()
+{
+  delete reader;
 }
 
 void ElevationProvider::marbleUpdateAvailable()
@@ -64,9 +68,9 @@ void ElevationProvider::marbleUpdateAvailable()
 
 float ElevationProvider::getElevationMeter(const atools::geo::Pos& pos)
 {
-  QMutexLocker locker(&mutex);
+  GlobeReader *globeReader = globeReaderForThread();
 
-  if(isGlobeOfflineProvider())
+  if(globeReader != nullptr)
   {
     float elevation = globeReader->getElevation(pos);
     if(!(elevation > atools::fs::common::OCEAN && elevation < atools::fs::common::INVALID))
@@ -83,9 +87,9 @@ void ElevationProvider::getElevations(atools::geo::LineString& elevations, const
   if(!line.isValid())
     return;
 
-  QMutexLocker locker(&mutex);
+  GlobeReader *globeReader = globeReaderForThread();
 
-  if(isGlobeOfflineProvider())
+  if(globeReader != nullptr)
   {
     globeReader->getElevations(elevations, LineString(line.getPos1(), line.getPos2()));
     for(Pos& pos : elevations)
@@ -149,13 +153,45 @@ bool ElevationProvider::isGlobeDirectoryValid(const QString& path) const
 
 void ElevationProvider::optionsChanged()
 {
-  // Make sure to wait for other methods to finish before changing the reader
-  QMutexLocker locker(&mutex);
   updateReader();
 }
 
+atools::fs::common::GlobeReader *ElevationProvider::globeReaderForThread()
+{
+  QString dir;
+  int generation;
+  {
+    QMutexLocker locker(&mutex);
+    dir = globeDirectory;
+    generation = readerGeneration;
+  }
+
+  if(dir.isEmpty())
+    return nullptr;
+
+  if(!readers.hasLocalData())
+    readers.setLocalData(new ReaderHolder);
+
+  ReaderHolder *holder = readers.localData();
+  if(holder->generation != generation)
+  {
+    // Configuration changed - recreate the reader of this thread
+    delete holder->reader;
+    holder->reader = new GlobeReader(dir);
+    if(!holder->reader->openFiles())
+    {
+      qWarning() << Q_FUNC_INFO << "Cannot open GLOBE files in" << dir;
+      delete holder->reader;
+      holder->reader = nullptr;
+    }
+    holder->generation = generation;
+  }
+  return holder->reader;
+}
+
 void ElevationProvider::updateReader()
 {
+  QString dir;
   if(OptionData::instance().getFlags() & opts::CACHE_USE_OFFLINE_ELEVATION)
   {
     const QString& path = OptionData::instance().getOfflineElevationPath();
@@ -167,25 +203,27 @@ void ElevationProvider::updateReader()
     }
     else
     {
-      delete globeReader;
-      globeReader = new GlobeReader(path);
+      // Probe the files once to give immediate feedback - per-thread readers are created lazily
+      qDebug() << Q_FUNC_INFO << "Opening GLOBE files";
+      GlobeReader probe(path);
+      if(!probe.openFiles())
       {
-        qDebug() << Q_FUNC_INFO << "Opening GLOBE files";
-
-        if(!globeReader->openFiles())
-        {
-          NavApp::deleteSplashScreen();
-          atools::gui::Dialog::warning(NavApp::getQMainWidget(),
-                                       tr("Cannot open GLOBE data in directory<br/>\"%1\"").arg(path));
-          qDebug() << Q_FUNC_INFO << "Opening GLOBE done";
-        }
+        NavApp::deleteSplashScreen();
+        atools::gui::Dialog::warning(NavApp::getQMainWidget(),
+                                     tr("Cannot open GLOBE data in directory<br/>\"%1\"").arg(path));
       }
+      else
+        dir = path;
+      qDebug() << Q_FUNC_INFO << "Opening GLOBE done";
     }
   }
-  else
+
   {
-    delete globeReader;
-    globeReader = nullptr;
+    QMutexLocker locker(&mutex);
+    globeDirectory = dir;
+
+    // Let all threads recreate their readers on next call
+    readerGeneration++;
   }
 
   emit updateAvailable();
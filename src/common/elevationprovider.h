@@ -20,6 +20,7 @@
 
 #include <QMutex>
 #include <QObject>
+#include <QThreadStorage>
 
 namespace Marble {
 class ElevationModel;
@@ -64,7 +65,8 @@ public:
   /* true if the data is provided from the fast offline source */
   bool isGlobeOfflineProvider() const
   {
-    return globeReader != nullptr;
+    QMutexLocker locker(&mutex);
+    return !globeDirectory.isEmpty();
   }
 
   /* True if directory is valid and contains at least one valid GLOBE file */
@@ -81,10 +83,31 @@ private:
   void marbleUpdateAvailable();
   void updateReader();
 
+  /* Get or create the GLOBE reader of the calling thread. Returns null if the offline
+   * provider is not configured. Each thread has its own reader with own file handles
+   * so elevation queries from the profile thread and the GUI do not serialize on a lock. */
+  atools::fs::common::GlobeReader *globeReaderForThread();
+
+  /* Per-thread reader - recreated lazily by the owning thread if the generation changed */
+  struct ReaderHolder
+  {
+    ~ReaderHolder();
+
+    int generation = -1;
+    atools::fs::common::GlobeReader *reader = nullptr;
+  };
+
   const Marble::ElevationModel *marbleModel = nullptr;
-  atools::fs::common::GlobeReader *globeReader = nullptr;
 
-  /* Need to synchronize here since it is called from profile widget thread */
+  QThreadStorage<ReaderHolder *> readers;
+
+  /* Valid GLOBE data directory or empty if the online provider is used */
+  QString globeDirectory;
+
+  /* Incremented on option changes to invalidate the per-thread readers */
+  int readerGeneration = 0;
+
+  /* Guards globeDirectory and readerGeneration only - elevation reads run lock-free */
   mutable QMutex mutex;
 
 };
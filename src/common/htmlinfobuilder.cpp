@@ -53,6 +53,7 @@
 #include "userdata/userdatacontroller.h"
 #include "userdata/userdataicons.h"
 #include "util/htmlbuilder.h"
+#include "weather/weatherreporter.h"
 #include "weather/windreporter.h"
 #include "route/routealtitude.h"
 
@@ -1568,7 +1569,8 @@ void HtmlInfoBuilder::weatherText(const map::WeatherContext& context, const MapA
 
         if(!metar.metarForStation.isEmpty())
         {
-          Metar met(metar.metarForStation, metar.requestIdent, metar.timestamp, true);
+          const Metar& met = NavApp::getWeatherReporter()->
+                             getDecodedMetar(metar.metarForStation, metar.requestIdent, metar.timestamp, true);
 
           html.p(tr("%1Station Weather").arg(sim), WEATHER_TITLE_FLAGS);
           decodedMetar(html, airport, map::MapAirport(), met, false /* interpolated */, fsxP3d,
@@ -1577,7 +1579,8 @@ void HtmlInfoBuilder::weatherText(const map::WeatherContext& context, const MapA
 
         if(!metar.metarForNearest.isEmpty())
         {
-          Metar met(metar.metarForNearest, metar.requestIdent, metar.timestamp, true);
+          const Metar& met = NavApp::getWeatherReporter()->
+                             getDecodedMetar(metar.metarForNearest, metar.requestIdent, metar.timestamp, true);
           QString reportIcao = met.getParsedMetar().isValid() ? met.getParsedMetar().getId() : met.getStation();
 
           html.p(tr("%2Nearest Weather - %1").arg(reportIcao).arg(sim), WEATHER_TITLE_FLAGS);
@@ -1599,7 +1602,8 @@ void HtmlInfoBuilder::weatherText(const map::WeatherContext& context, const MapA
 
         if(!metar.metarForInterpolated.isEmpty())
         {
-          Metar met(metar.metarForInterpolated, metar.requestIdent, metar.timestamp, fsxP3d);
+          const Metar& met = NavApp::getWeatherReporter()->
+                             getDecodedMetar(metar.metarForInterpolated, metar.requestIdent, metar.timestamp, fsxP3d);
           html.p(tr("%2Interpolated Weather - %1").arg(met.getStation()).arg(sim), WEATHER_TITLE_FLAGS);
           decodedMetar(html, airport, map::MapAirport(), met, true /* interpolated */, fsxP3d, false /* map src */);
         }
@@ -1619,8 +1623,8 @@ void HtmlInfoBuilder::weatherText(const map::WeatherContext& context, const MapA
         else
           html.p(context.asType, WEATHER_TITLE_FLAGS);
 
-        decodedMetar(html, airport, map::MapAirport(), Metar(context.asMetar), false /* interpolated */,
-                     false /* FSX/P3D */, src == WEATHER_SOURCE_ACTIVE_SKY && weatherShown);
+        decodedMetar(html, airport, map::MapAirport(), NavApp::getWeatherReporter()->getDecodedMetar(context.asMetar),
+                     false /* interpolated */, false /* FSX/P3D */, src == WEATHER_SOURCE_ACTIVE_SKY && weatherShown);
       }
 
       // NOAA or nearest ===========================
@@ -1646,12 +1650,15 @@ void HtmlInfoBuilder::decodedMetars(HtmlBuilder& html, const atools::fs::weather
     {
       html.p(tr("%1 Station Weather").arg(name), WEATHER_TITLE_FLAGS);
       decodedMetar(html, airport, map::MapAirport(),
-                   Metar(metar.metarForStation, metar.requestIdent, metar.timestamp, true), false, false, mapDisplay);
+                   NavApp::getWeatherReporter()->
+                   getDecodedMetar(metar.metarForStation, metar.requestIdent, metar.timestamp, true),
+                   false, false, mapDisplay);
     }
 
     if(!metar.metarForNearest.isEmpty())
     {
-      Metar met(metar.metarForNearest, metar.requestIdent, metar.timestamp, true);
+      const Metar& met = NavApp::getWeatherReporter()->
+                         getDecodedMetar(metar.metarForNearest, metar.requestIdent, metar.timestamp, true);
       QString reportIcao = met.getParsedMetar().isValid() ? met.getParsedMetar().getId() : met.getStation();
 
       html.p(tr("%1 Nearest Weather - %2").arg(name).arg(reportIcao), WEATHER_TITLE_FLAGS);
@@ -1780,8 +1787,21 @@ void HtmlInfoBuilder::decodedMetar(HtmlBuilder& html, const map::MapAirport& air
   // Pressure  =============================================================
   float slp = parsed.getPressureMbar();
   if(slp < INVALID_METAR_VALUE)
+  {
+    // Show a trend arrow if the observed history covers enough time and the change is noticeable
+    QString upDown;
+    WeatherTrend::Values trend = NavApp::getWeatherReporter()->getWeatherTrend(airport.ident);
+    if(trend.valid)
+    {
+      if(trend.pressureChangeMbar >= 1.f)
+        upDown = tr(" <b>▲</b>");
+      else if(trend.pressureChangeMbar <= -1.f)
+        upDown = tr(" <b>▼</b>");
+    }
+
     html.row2(tr("Pressure:"), locale.toString(slp, 'f', 0) + tr(" hPa, ") +
-              locale.toString(ageo::mbarToInHg(slp), 'f', 2) + tr(" inHg"));
+              locale.toString(ageo::mbarToInHg(slp), 'f', 2) + tr(" inHg") + upDown, ahtml::NO_ENTITIES);
+  }
 
   // Visibility =============================================================
   const atools::fs::weather::MetarVisibility& minVis = parsed.getMinVisibility();
@@ -4282,7 +4302,7 @@ void HtmlInfoBuilder::addMetarLine(atools::util::HtmlBuilder& html, const QStrin
 {
   if(!metar.isEmpty())
   {
-    Metar m(metar, station, timestamp, fsMetar);
+    const Metar& m = NavApp::getWeatherReporter()->getDecodedMetar(metar, station, timestamp, fsMetar);
     const atools::fs::weather::MetarParser& parsed = m.getParsedMetar();
 
     if(!parsed.isValid())
@@ -0,0 +1,59 @@
+/*****************************************************************************
+* Copyright 2015-2020 Alexander Barthel alex@littlenavmap.org
+*
+* This program is free software: you can redistribute it and/or modify
+* it under the terms of the GNU General Public License as published by
+* the Free Software Foundation, either version 3 of the License, or
+* (at your option) any later version.
+*
+* This program is distributed in the hope that it will be useful,
+* but WITHOUT ANY WARRANTY; without even the implied warranty of
+* MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+* GNU General Public License for more details.
+*
+* You should have received a copy of the GNU General Public License
+* along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*****************************************************************************/
+
+#include "common/idlescheduler.h"
+
+#include <QCoreApplication>
+#include <QEvent>
+
+IdleScheduler::IdleScheduler(QObject *parent, int timeoutSeconds) : QObject(parent)
+{
+  timer.setSingleShot(true);
+  timer.setInterval(timeoutSeconds * 1000);
+  connect(&timer, &QTimer::timeout, this, &IdleScheduler::idle);
+
+  QCoreApplication::instance()->installEventFilter(this);
+  timer.start();
+}
+
+IdleScheduler::~IdleScheduler()
+{
+  QCoreApplication::instance()->removeEventFilter(this);
+  timer.stop();
+}
+
+bool IdleScheduler::eventFilter(QObject *object, QEvent *event)
+{
+  switch(event->type())
+  {
+    case QEvent::MouseButtonPress:
+    case QEvent::MouseButtonRelease:
+    case QEvent::MouseMove:
+    case QEvent::Wheel:
+    case QEvent::KeyPress:
+    case QEvent::KeyRelease:
+    case QEvent::TouchBegin:
+    case QEvent::TouchUpdate:
+      // User is interacting - push the idle timeout further out
+      timer.start();
+      break;
+
+    default:
+      break;
+  }
+  return QObject::eventFilter(object, event);
+}
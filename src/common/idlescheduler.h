@@ -0,0 +1,51 @@
+/*****************************************************************************
+* Copyright 2015-2020 Alexander Barthel alex@littlenavmap.org
+*
+* This program is free software: you can redistribute it and/or modify
+* it under the terms of the GNU General Public License as published by
+* the Free Software Foundation, either version 3 of the License, or
+* (at your option) any later version.
+*
+* This program is distributed in the hope that it will be useful,
+* but WITHOUT ANY WARRANTY; without even the implied warranty of
+* MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+* GNU General Public License for more details.
+*
+* You should have received a copy of the GNU General Public License
+* along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*****************************************************************************/
+
+#ifndef LNM_COMMON_IDLESCHEDULER_H
+#define LNM_COMMON_IDLESCHEDULER_H
+
+#include <QObject>
+#include <QTimer>
+
+/*
+ * Emits a signal once the user has not interacted with the application for a while.
+ * Installs an event filter on the application object and pushes the timeout out on
+ * every mouse, wheel, key or touch event. The signal fires once per idle period -
+ * firing again needs new user input first.
+ *
+ * Used to warm up caches in the background while the user is not busy with the program.
+ */
+class IdleScheduler :
+  public QObject
+{
+  Q_OBJECT
+
+public:
+  explicit IdleScheduler(QObject *parent, int timeoutSeconds);
+  virtual ~IdleScheduler() override;
+
+signals:
+  /* No user interaction for the given number of seconds */
+  void idle();
+
+private:
+  virtual bool eventFilter(QObject *object, QEvent *event) override;
+
+  QTimer timer;
+};
+
+#endif // LNM_COMMON_IDLESCHEDULER_H
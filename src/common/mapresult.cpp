@@ -23,6 +23,40 @@
 
 namespace map {
 
+MapResult& MapResult::clearAll()
+{
+  airports.clear();
+  airportIds.clear();
+  runwayEnds.clear();
+  towers.clear();
+  parkings.clear();
+  helipads.clear();
+  waypoints.clear();
+  waypointIds.clear();
+  vors.clear();
+  vorIds.clear();
+  ndbs.clear();
+  ndbIds.clear();
+  markers.clear();
+  ils.clear();
+  airways.clear();
+  airspaces.clear();
+  userpointsRoute.clear();
+  userpoints.clear();
+  userpointIds.clear();
+  logbookEntries.clear();
+  userAircraft.clear();
+  aiAircraft.clear();
+  onlineAircraft.clear();
+  onlineAircraftIds.clear();
+  windPos = atools::geo::EMPTY_POS;
+  holds.clear();
+  trafficPatterns.clear();
+  rangeMarkers.clear();
+  procPoints.clear();
+  return *this;
+}
+
 void MapResult::clear(const MapTypes& types)
 {
   if(types.testFlag(map::AIRPORT))
@@ -811,12 +845,21 @@ MapResultIndex& MapResultIndex::sort(const atools::geo::Pos& pos, bool sortNearT
     // Nothing to sort
     return *this;
 
-  std::sort(begin(), end(),
-            [pos, sortNearToFar](const MapBase *obj1, const MapBase *obj2) -> bool
+  // Calculate the great circle distance only once per object instead of twice per sort comparison
+  QVector<std::pair<float, const MapBase *> > keyed;
+  keyed.reserve(size());
+  for(const MapBase *obj : *this)
+    keyed.append(std::make_pair(obj->getPosition().distanceMeterTo(pos), obj));
+
+  std::sort(keyed.begin(), keyed.end(),
+            [sortNearToFar](const std::pair<float, const MapBase *>& pair1,
+                            const std::pair<float, const MapBase *>& pair2) -> bool
     {
-      bool res = obj1->getPosition().distanceMeterTo(pos) < obj2->getPosition().distanceMeterTo(pos);
-      return sortNearToFar ? res : !res;
+      return sortNearToFar ? pair1.first < pair2.first : pair1.first > pair2.first;
     });
+
+  for(int i = 0; i < size(); i++)
+    (*this)[i] = keyed.at(i).second;
   return *this;
 }
 
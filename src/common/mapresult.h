@@ -96,6 +96,10 @@ struct MapResult
   /* Remove the given types only */
   void clear(const MapTypes& types = map::ALL);
 
+  /* Clear all lists, sets and other members in place. Allows reusing one result object between
+   * queries instead of constructing and destroying the whole aggregate for every tooltip or click. */
+  MapResult& clearAll();
+
   /* Remove all except first for the given types only */
   void clearAllButFirst(const MapTypes& types = map::ALL);
 
@@ -22,9 +22,12 @@
 #include "geo/calculations.h"
 #include "common/mapflags.h"
 #include "geo/pos.h"
+#include "geo/rect.h"
 
 #include <QList>
 #include <QSet>
+#include <QSize>
+#include <QVector>
 #include <algorithm>
 #include <functional>
 
@@ -112,18 +115,35 @@ void removeByDirection(QList<TYPE>& list, const atools::geo::Pos& pos, int lastD
 
 }
 
-/* Sorts elements by distance to a point */
+/* Sorts elements by distance to a point. The great circle distance is calculated only once
+ * per element instead of twice per sort comparison. */
 template<typename TYPE>
 void sortByDistance(QList<TYPE>& list, const atools::geo::Pos& pos)
 {
   if(list.isEmpty() || !pos.isValid())
     return;
 
-  std::sort(list.begin(), list.end(),
-            [ = ](const TYPE& t1, const TYPE& t2) -> bool
+  QVector<float> distances;
+  distances.reserve(list.size());
+  for(const TYPE& type : list)
+    distances.append(type.getPosition().distanceMeterTo(pos));
+
+  // Sort list indexes by the precalculated distances
+  QVector<int> indexes;
+  indexes.reserve(list.size());
+  for(int i = 0; i < list.size(); i++)
+    indexes.append(i);
+
+  std::sort(indexes.begin(), indexes.end(), [&distances](int index1, int index2) -> bool
     {
-      return t1.getPosition().distanceMeterTo(pos) < t2.getPosition().distanceMeterTo(pos);
+      return distances.at(index1) < distances.at(index2);
     });
+
+  QList<TYPE> sorted;
+  sorted.reserve(list.size());
+  for(int index : indexes)
+    sorted.append(list.at(index));
+  list = sorted;
 }
 
 template<typename TYPE>
@@ -132,11 +152,27 @@ void sortByDistance(QVector<TYPE>& list, const atools::geo::Pos& pos)
   if(list.isEmpty() || !pos.isValid())
     return;
 
-  std::sort(list.begin(), list.end(),
-            [ = ](const TYPE& t1, const TYPE& t2) -> bool
+  QVector<float> distances;
+  distances.reserve(list.size());
+  for(const TYPE& type : list)
+    distances.append(type.getPosition().distanceMeterTo(pos));
+
+  // Sort list indexes by the precalculated distances
+  QVector<int> indexes;
+  indexes.reserve(list.size());
+  for(int i = 0; i < list.size(); i++)
+    indexes.append(i);
+
+  std::sort(indexes.begin(), indexes.end(), [&distances](int index1, int index2) -> bool
     {
-      return t1.getPosition().distanceMeterTo(pos) < t2.getPosition().distanceMeterTo(pos);
+      return distances.at(index1) < distances.at(index2);
     });
+
+  QVector<TYPE> sorted;
+  sorted.reserve(list.size());
+  for(int index : indexes)
+    sorted.append(list.at(index));
+  list = sorted;
 }
 
 /* Functions will stop adding of number of elements exceeds this value */
@@ -182,6 +218,103 @@ void insertSorted(const CoordinateConverter& conv, int xs, int ys, const QList<T
   }
 }
 
+/* Calculates an approximate world coordinate rectangle covering the screen square around
+ * xs/ys. Used to reject objects cheaply before the expensive screen projection when hit
+ * testing large object caches. Returns an invalid rectangle near the poles or other
+ * projection edge cases - callers have to skip the pre-filter then. */
+inline atools::geo::Rect screenToWorldRect(const CoordinateConverter& conv, int xs, int ys, int maxDistance)
+{
+  atools::geo::Rect rect;
+  for(const QPoint& corner : {QPoint(xs - maxDistance, ys - maxDistance),
+                              QPoint(xs + maxDistance, ys - maxDistance),
+                              QPoint(xs - maxDistance, ys + maxDistance),
+                              QPoint(xs + maxDistance, ys + maxDistance)})
+  {
+    atools::geo::Pos pos = conv.sToW(corner);
+    if(!pos.isValid())
+      return atools::geo::Rect();
+
+    rect.extend(pos);
+  }
+  return rect;
+}
+
+/* Screen coordinate grid over a list of point-like map objects for fast hit testing.
+ * update() projects the whole list once after view or selection changes and query() then only
+ * examines the grid cells around the cursor. This keeps the cost of a mouse move independent of
+ * the list size. */
+template<typename TYPE>
+class ScreenPointIndex
+{
+public:
+  /* Project all objects of the list to screen and sort their list indexes into the grid cells.
+   * Has to be called whenever the view or the list changes. */
+  void update(const CoordinateConverter& conv, const QList<TYPE>& list, const QSize& screenSize)
+  {
+    cells.clear();
+    numCellsX = std::max(1, (screenSize.width() + CELL_SIZE - 1) / CELL_SIZE);
+    numCellsY = std::max(1, (screenSize.height() + CELL_SIZE - 1) / CELL_SIZE);
+    cells.resize(numCellsX * numCellsY);
+
+    int x, y;
+    for(int i = 0; i < list.size(); i++)
+    {
+      // Objects that are hidden behind the globe cannot be picked
+      if(conv.wToS(list.at(i).getPosition(), x, y))
+        cells[cellCoordY(y) * numCellsX + cellCoordX(x)].append(i);
+    }
+  }
+
+  /* Adds all objects near xs/ys to result sorted by screen distance. Gives the same result as
+   * insertSorted() over the whole list which has to be the same that was passed to update(). */
+  void query(const CoordinateConverter& conv, int xs, int ys, const QList<TYPE>& list, QList<TYPE>& result,
+             QSet<int> *ids, int maxDistance) const
+  {
+    if(cells.isEmpty())
+      return;
+
+    int x, y;
+    for(int cy = cellCoordY(ys - maxDistance); cy <= cellCoordY(ys + maxDistance); cy++)
+    {
+      for(int cx = cellCoordX(xs - maxDistance); cx <= cellCoordX(xs + maxDistance); cx++)
+      {
+        for(int i : cells.at(cy * numCellsX + cx))
+        {
+          const TYPE& obj = list.at(i);
+          if(conv.wToS(obj.getPosition(), x, y))
+            if((atools::geo::manhattanDistance(x, y, xs, ys)) < maxDistance)
+              maptools::insertSortedByDistance(conv, result, ids, xs, ys, obj);
+        }
+      }
+    }
+  }
+
+  void clear()
+  {
+    cells.clear();
+    numCellsX = numCellsY = 0;
+  }
+
+private:
+  /* Cell coordinates clamped to the grid. Off-screen objects end up in the border cells. */
+  int cellCoordX(int x) const
+  {
+    return std::max(0, std::min(x / CELL_SIZE, numCellsX - 1));
+  }
+
+  int cellCoordY(int y) const
+  {
+    return std::max(0, std::min(y / CELL_SIZE, numCellsY - 1));
+  }
+
+  /* Cell edge length in pixels */
+  static Q_DECL_CONSTEXPR int CELL_SIZE = 64;
+
+  /* List indexes of the objects by cell in row-major order */
+  QVector<QVector<int> > cells;
+  int numCellsX = 0, numCellsY = 0;
+};
+
 /* Inserts element into list sorted by screen distance of tower to xs/ys using ids set for deduplication */
 template<typename TYPE>
 void insertSortedByTowerDistance(const CoordinateConverter& conv, QList<TYPE>& list, int xs, int ys,
@@ -646,6 +646,9 @@ struct MapUserpoint
   }
 
   QString name, ident, region, type, description, tags;
+
+  /* Point is shown if the map view distance in km is below this value */
+  float visibleFrom = 0.f;
   bool temp = false;
 };
 
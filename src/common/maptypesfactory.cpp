@@ -18,20 +18,134 @@
 #include "common/maptypesfactory.h"
 
 #include <cmath>
+#include "sql/sqlquery.h"
 #include "sql/sqlrecord.h"
 #include "geo/calculations.h"
 #include "common/maptypes.h"
 #include "io/binaryutil.h"
 
 using namespace atools::geo;
+using atools::sql::SqlQuery;
 using atools::sql::SqlRecord;
 using namespace map;
 
+namespace {
+/* Unify the differently named column presence checks of the two row sources for the
+ * fill templates below */
+inline bool hasColumn(const SqlRecord& record, const QString& name)
+{
+  return record.contains(name);
+}
+
+inline bool hasColumn(const SqlQuery& query, const QString& name)
+{
+  return query.hasField(name);
+}
+
+}
+
+/* Drop the intern pool if this many distinct values accumulated. Can only happen if several
+ * databases with disjunct idents were loaded in one session. */
+static const int MAX_INTERN_POOL_SIZE = 500000;
+
+QSet<QString> MapTypesFactory::internPool;
+
+namespace apcol {
+/* Positions of the airport columns in AIRPORT_COLUMN_NAMES below. Order has to match. */
+enum AirportColumn
+{
+  AIRPORT_ID, TOWER_FREQUENCY, IDENT, ICAO, IATA, XPIDENT, NAME, RATING,
+  LONGEST_RUNWAY_LENGTH, LONGEST_RUNWAY_HEADING, MAG_VAR, TRANSITION_ALTITUDE, FLATTEN,
+  LEFT_LONX, TOP_LATY, RIGHT_LONX, BOTTOM_LATY,
+  HAS_TOWER_OBJECT, TOWER_LONX, TOWER_LATY,
+  ATIS_FREQUENCY, AWOS_FREQUENCY, ASOS_FREQUENCY, UNICOM_FREQUENCY,
+  LONX, LATY, ALTITUDE, REGION,
+  NUM_HELIPAD, HAS_AVGAS, HAS_JETFUEL, IS_CLOSED, IS_MILITARY, IS_ADDON, IS_3D,
+  NUM_RUNWAY_HARD, NUM_RUNWAY_SOFT, NUM_RUNWAY_WATER,
+  NUM_APPROACH, NUM_RUNWAY_LIGHT, NUM_RUNWAY_END_ILS, NUM_APRON, NUM_TAXI_PATH,
+  NUM_PARKING_GATE, NUM_PARKING_GA_RAMP, NUM_PARKING_CARGO, NUM_PARKING_MIL_CARGO,
+  NUM_PARKING_MIL_COMBAT, NUM_RUNWAY_END_VASI, NUM_RUNWAY_END_ALS, NUM_BOUNDARY_FENCE,
+  NUM_RUNWAY_END_CLOSED
+};
+
+const QVector<QString> AIRPORT_COLUMN_NAMES(
+{
+  "airport_id", "tower_frequency", "ident", "icao", "iata", "xpident", "name", "rating",
+  "longest_runway_length", "longest_runway_heading", "mag_var", "transition_altitude", "flatten",
+  "left_lonx", "top_laty", "right_lonx", "bottom_laty",
+  "has_tower_object", "tower_lonx", "tower_laty",
+  "atis_frequency", "awos_frequency", "asos_frequency", "unicom_frequency",
+  "lonx", "laty", "altitude", "region",
+  "num_helipad", "has_avgas", "has_jetfuel", "is_closed", "is_military", "is_addon", "is_3d",
+  "num_runway_hard", "num_runway_soft", "num_runway_water",
+  "num_approach", "num_runway_light", "num_runway_end_ils", "num_apron", "num_taxi_path",
+  "num_parking_gate", "num_parking_ga_ramp", "num_parking_cargo", "num_parking_mil_cargo",
+  "num_parking_mil_combat", "num_runway_end_vasi", "num_runway_end_als", "num_boundary_fence",
+  "num_runway_end_closed"
+});
+}
+
+void ColumnBinding::bind(const SqlRecord& record, const QVector<QString>& columnNames)
+{
+  if(names.size() == columnNames.size() && !names.isEmpty())
+  {
+    // Check if the record still matches the bound layout - one comparison per column
+    bool same = true;
+    for(int i = 0; i < names.size() && same; i++)
+    {
+      int idx = indexes.at(i);
+      if(idx >= 0)
+        same = idx < record.count() && record.fieldName(idx) == names.at(i);
+      else
+        same = !record.contains(names.at(i));
+    }
+
+    if(same)
+      return;
+  }
+
+  // Record comes from another query - resolve all columns for the new layout
+  names = columnNames;
+  indexes.clear();
+  indexes.reserve(names.size());
+  for(const QString& name : names)
+    indexes.append(record.contains(name) ? record.indexOf(name) : -1);
+}
+
+int ColumnBinding::valueInt(const SqlRecord& record, int column, int defaultValue) const
+{
+  int idx = indexes.at(column);
+  return idx >= 0 ? record.value(idx).toInt() : defaultValue;
+}
+
+float ColumnBinding::valueFloat(const SqlRecord& record, int column, float defaultValue) const
+{
+  int idx = indexes.at(column);
+  return idx >= 0 ? record.value(idx).toFloat() : defaultValue;
+}
+
+QString ColumnBinding::valueStr(const SqlRecord& record, int column, const QString& defaultValue) const
+{
+  int idx = indexes.at(column);
+  return idx >= 0 ? record.value(idx).toString() : defaultValue;
+}
+
 MapTypesFactory::MapTypesFactory()
 {
 
 }
 
+QString MapTypesFactory::intern(const QString& str)
+{
+  if(str.isEmpty())
+    return str;
+
+  if(internPool.size() >= MAX_INTERN_POOL_SIZE)
+    internPool.clear();
+
+  return *internPool.insert(str);
+}
+
 MapTypesFactory::~MapTypesFactory()
 {
 
@@ -40,6 +154,9 @@ MapTypesFactory::~MapTypesFactory()
 void MapTypesFactory::fillAirport(const SqlRecord& record, map::MapAirport& airport, bool complete, bool nav,
                                   bool xplane)
 {
+  // Resolve or verify the column indexes once per query layout and read by position below
+  airportBinding.bind(record, apcol::AIRPORT_COLUMN_NAMES);
+
   fillAirportBase(record, airport, complete);
   airport.navdata = nav;
   airport.xplane = xplane;
@@ -47,31 +164,38 @@ void MapTypesFactory::fillAirport(const SqlRecord& record, map::MapAirport& airp
   if(complete)
   {
     airport.flags = fillAirportFlags(record, false);
-    if(record.contains("has_tower_object"))
-      airport.towerCoords = Pos(record.valueFloat("tower_lonx"), record.valueFloat("tower_laty"));
+    if(airportBinding.contains(apcol::HAS_TOWER_OBJECT))
+      airport.towerCoords = Pos(airportBinding.valueFloat(record, apcol::TOWER_LONX),
+                                airportBinding.valueFloat(record, apcol::TOWER_LATY));
 
-    airport.atisFrequency = record.valueInt("atis_frequency");
-    airport.awosFrequency = record.valueInt("awos_frequency");
-    airport.asosFrequency = record.valueInt("asos_frequency");
-    airport.unicomFrequency = record.valueInt("unicom_frequency");
+    airport.atisFrequency = airportBinding.valueInt(record, apcol::ATIS_FREQUENCY);
+    airport.awosFrequency = airportBinding.valueInt(record, apcol::AWOS_FREQUENCY);
+    airport.asosFrequency = airportBinding.valueInt(record, apcol::ASOS_FREQUENCY);
+    airport.unicomFrequency = airportBinding.valueInt(record, apcol::UNICOM_FREQUENCY);
 
-    airport.position = Pos(record.valueFloat("lonx"), record.valueFloat("laty"),
-                           record.valueFloat("altitude"));
+    airport.position = Pos(airportBinding.valueFloat(record, apcol::LONX),
+                           airportBinding.valueFloat(record, apcol::LATY),
+                           airportBinding.valueFloat(record, apcol::ALTITUDE));
 
-    airport.region = record.valueStr("region", QString());
+    airport.region = intern(airportBinding.valueStr(record, apcol::REGION, QString()));
   }
   else
-    airport.position = Pos(record.valueFloat("lonx"), record.valueFloat("laty"), 0.f);
+    airport.position = Pos(airportBinding.valueFloat(record, apcol::LONX),
+                           airportBinding.valueFloat(record, apcol::LATY), 0.f);
 }
 
 void MapTypesFactory::fillAirportForOverview(const SqlRecord& record, map::MapAirport& airport, bool nav, bool xplane)
 {
+  // Resolve or verify the column indexes once per query layout and read by position below
+  airportBinding.bind(record, apcol::AIRPORT_COLUMN_NAMES);
+
   fillAirportBase(record, airport, true);
   airport.navdata = nav;
   airport.xplane = xplane;
 
   airport.flags = fillAirportFlags(record, true);
-  airport.position = Pos(record.valueFloat("lonx"), record.valueFloat("laty"), 0.f);
+  airport.position = Pos(airportBinding.valueFloat(record, apcol::LONX),
+                         airportBinding.valueFloat(record, apcol::LATY), 0.f);
 }
 
 void MapTypesFactory::fillRunway(const atools::sql::SqlRecord& record, map::MapRunway& runway, bool overview)
@@ -139,25 +263,28 @@ void MapTypesFactory::fillRunwayEnd(const atools::sql::SqlRecord& record, MapRun
 
 void MapTypesFactory::fillAirportBase(const SqlRecord& record, map::MapAirport& ap, bool complete)
 {
-  ap.id = record.valueInt("airport_id");
+  ap.id = airportBinding.valueInt(record, apcol::AIRPORT_ID);
 
   if(complete)
   {
-    ap.towerFrequency = record.valueInt("tower_frequency");
-    ap.ident = record.valueStr("ident");
-    ap.icao = record.valueStr("icao", QString());
-    ap.iata = record.valueStr("iata", QString());
-    ap.xpident = record.valueStr("xpident", QString());
-    ap.name = record.valueStr("name");
-    ap.rating = record.valueInt("rating", -1);
-    ap.longestRunwayLength = record.valueInt("longest_runway_length");
-    ap.longestRunwayHeading = static_cast<int>(std::round(record.valueFloat("longest_runway_heading")));
-    ap.magvar = record.valueFloat("mag_var");
-    ap.transitionAltitude = record.valueInt("transition_altitude", 0);
-    ap.flatten = record.valueInt("flatten", -1);
-
-    ap.bounding = Rect(record.valueFloat("left_lonx"), record.valueFloat("top_laty"),
-                       record.valueFloat("right_lonx"), record.valueFloat("bottom_laty"));
+    ap.towerFrequency = airportBinding.valueInt(record, apcol::TOWER_FREQUENCY);
+    ap.ident = intern(airportBinding.valueStr(record, apcol::IDENT));
+    ap.icao = intern(airportBinding.valueStr(record, apcol::ICAO, QString()));
+    ap.iata = intern(airportBinding.valueStr(record, apcol::IATA, QString()));
+    ap.xpident = intern(airportBinding.valueStr(record, apcol::XPIDENT, QString()));
+    ap.name = airportBinding.valueStr(record, apcol::NAME);
+    ap.rating = airportBinding.valueInt(record, apcol::RATING, -1);
+    ap.longestRunwayLength = airportBinding.valueInt(record, apcol::LONGEST_RUNWAY_LENGTH);
+    ap.longestRunwayHeading =
+      static_cast<int>(std::round(airportBinding.valueFloat(record, apcol::LONGEST_RUNWAY_HEADING)));
+    ap.magvar = airportBinding.valueFloat(record, apcol::MAG_VAR);
+    ap.transitionAltitude = airportBinding.valueInt(record, apcol::TRANSITION_ALTITUDE, 0);
+    ap.flatten = airportBinding.valueInt(record, apcol::FLATTEN, -1);
+
+    ap.bounding = Rect(airportBinding.valueFloat(record, apcol::LEFT_LONX),
+                       airportBinding.valueFloat(record, apcol::TOP_LATY),
+                       airportBinding.valueFloat(record, apcol::RIGHT_LONX),
+                       airportBinding.valueFloat(record, apcol::BOTTOM_LATY));
     ap.flags |= AP_COMPLETE;
   }
 }
@@ -165,43 +292,43 @@ void MapTypesFactory::fillAirportBase(const SqlRecord& record, map::MapAirport&
 map::MapAirportFlags MapTypesFactory::fillAirportFlags(const SqlRecord& record, bool overview)
 {
   MapAirportFlags flags = AP_NONE;
-  flags |= airportFlag(record, "num_helipad", AP_HELIPAD);
-  flags |= airportFlag(record, "has_avgas", AP_AVGAS);
-  flags |= airportFlag(record, "has_jetfuel", AP_JETFUEL);
-  flags |= airportFlag(record, "tower_frequency", AP_TOWER);
-  flags |= airportFlag(record, "is_closed", AP_CLOSED);
-  flags |= airportFlag(record, "is_military", AP_MIL);
-  flags |= airportFlag(record, "is_addon", AP_ADDON);
-  flags |= airportFlag(record, "is_3d", AP_3D);
-  flags |= airportFlag(record, "num_runway_hard", AP_HARD);
-  flags |= airportFlag(record, "num_runway_soft", AP_SOFT);
-  flags |= airportFlag(record, "num_runway_water", AP_WATER);
+  flags |= airportFlag(record, apcol::NUM_HELIPAD, AP_HELIPAD);
+  flags |= airportFlag(record, apcol::HAS_AVGAS, AP_AVGAS);
+  flags |= airportFlag(record, apcol::HAS_JETFUEL, AP_JETFUEL);
+  flags |= airportFlag(record, apcol::TOWER_FREQUENCY, AP_TOWER);
+  flags |= airportFlag(record, apcol::IS_CLOSED, AP_CLOSED);
+  flags |= airportFlag(record, apcol::IS_MILITARY, AP_MIL);
+  flags |= airportFlag(record, apcol::IS_ADDON, AP_ADDON);
+  flags |= airportFlag(record, apcol::IS_3D, AP_3D);
+  flags |= airportFlag(record, apcol::NUM_RUNWAY_HARD, AP_HARD);
+  flags |= airportFlag(record, apcol::NUM_RUNWAY_SOFT, AP_SOFT);
+  flags |= airportFlag(record, apcol::NUM_RUNWAY_WATER, AP_WATER);
 
   if(!overview)
   {
-    flags |= airportFlag(record, "num_approach", AP_PROCEDURE);
-    flags |= airportFlag(record, "num_runway_light", AP_LIGHT);
-    flags |= airportFlag(record, "num_runway_end_ils", AP_ILS);
+    flags |= airportFlag(record, apcol::NUM_APPROACH, AP_PROCEDURE);
+    flags |= airportFlag(record, apcol::NUM_RUNWAY_LIGHT, AP_LIGHT);
+    flags |= airportFlag(record, apcol::NUM_RUNWAY_END_ILS, AP_ILS);
 
-    flags |= airportFlag(record, "num_apron", AP_APRON);
-    flags |= airportFlag(record, "num_taxi_path", AP_TAXIWAY);
-    flags |= airportFlag(record, "has_tower_object", AP_TOWER_OBJ);
+    flags |= airportFlag(record, apcol::NUM_APRON, AP_APRON);
+    flags |= airportFlag(record, apcol::NUM_TAXI_PATH, AP_TAXIWAY);
+    flags |= airportFlag(record, apcol::HAS_TOWER_OBJECT, AP_TOWER_OBJ);
 
-    flags |= airportFlag(record, "num_parking_gate", AP_PARKING);
-    flags |= airportFlag(record, "num_parking_ga_ramp", AP_PARKING);
-    flags |= airportFlag(record, "num_parking_cargo", AP_PARKING);
-    flags |= airportFlag(record, "num_parking_mil_cargo", AP_PARKING);
-    flags |= airportFlag(record, "num_parking_mil_combat", AP_PARKING);
+    flags |= airportFlag(record, apcol::NUM_PARKING_GATE, AP_PARKING);
+    flags |= airportFlag(record, apcol::NUM_PARKING_GA_RAMP, AP_PARKING);
+    flags |= airportFlag(record, apcol::NUM_PARKING_CARGO, AP_PARKING);
+    flags |= airportFlag(record, apcol::NUM_PARKING_MIL_CARGO, AP_PARKING);
+    flags |= airportFlag(record, apcol::NUM_PARKING_MIL_COMBAT, AP_PARKING);
 
-    flags |= airportFlag(record, "num_runway_end_vasi", AP_VASI);
-    flags |= airportFlag(record, "num_runway_end_als", AP_ALS);
-    flags |= airportFlag(record, "num_boundary_fence", AP_FENCE);
-    flags |= airportFlag(record, "num_runway_end_closed", AP_RW_CLOSED);
+    flags |= airportFlag(record, apcol::NUM_RUNWAY_END_VASI, AP_VASI);
+    flags |= airportFlag(record, apcol::NUM_RUNWAY_END_ALS, AP_ALS);
+    flags |= airportFlag(record, apcol::NUM_BOUNDARY_FENCE, AP_FENCE);
+    flags |= airportFlag(record, apcol::NUM_RUNWAY_END_CLOSED, AP_RW_CLOSED);
 
   }
   else
   {
-    if(record.valueInt("rating") > 0)
+    if(airportBinding.valueInt(record, apcol::RATING) > 0)
     {
       // Force non empty airports for overview results
       flags |= AP_APRON;
@@ -213,10 +340,11 @@ map::MapAirportFlags MapTypesFactory::fillAirportFlags(const SqlRecord& record,
   return flags;
 }
 
-map::MapAirportFlags MapTypesFactory::airportFlag(const SqlRecord& record, const QString& field,
+map::MapAirportFlags MapTypesFactory::airportFlag(const SqlRecord& record, int column,
                                                   map::MapAirportFlags flag)
 {
-  if(!record.contains(field) || record.isNull(field) || record.valueInt(field) == 0)
+  // Null values read as zero
+  if(!airportBinding.contains(column) || airportBinding.valueInt(record, column) == 0)
     return AP_NONE;
   else
     return flag;
@@ -224,10 +352,21 @@ map::MapAirportFlags MapTypesFactory::airportFlag(const SqlRecord& record, const
 
 void MapTypesFactory::fillVor(const SqlRecord& record, map::MapVor& vor)
 {
-  fillVorBase(record, vor);
+  fillVorInternal(record, vor);
+}
 
-  vor.dmeOnly = record.valueInt("dme_only") > 0;
-  vor.hasDme = !record.isNull("dme_altitude");
+void MapTypesFactory::fillVor(const SqlQuery& query, map::MapVor& vor)
+{
+  fillVorInternal(query, vor);
+}
+
+template<typename Source>
+void MapTypesFactory::fillVorInternal(const Source& source, map::MapVor& vor)
+{
+  fillVorBase(source, vor);
+
+  vor.dmeOnly = source.valueInt("dme_only") > 0;
+  vor.hasDme = !source.isNull("dme_altitude");
 }
 
 void MapTypesFactory::fillVorFromNav(const SqlRecord& record, map::MapVor& vor)
@@ -289,15 +428,16 @@ void MapTypesFactory::fillVorFromNav(const SqlRecord& record, map::MapVor& vor)
   vor.frequency /= 10;
 }
 
-void MapTypesFactory::fillVorBase(const SqlRecord& record, map::MapVor& vor)
+template<typename Source>
+void MapTypesFactory::fillVorBase(const Source& source, map::MapVor& vor)
 {
-  vor.id = record.valueInt("vor_id");
-  vor.ident = record.valueStr("ident");
-  vor.region = record.valueStr("region");
-  vor.name = atools::capString(record.valueStr("name"));
+  vor.id = source.valueInt("vor_id");
+  vor.ident = intern(source.valueStr("ident"));
+  vor.region = intern(source.valueStr("region"));
+  vor.name = atools::capString(source.valueStr("name"));
 
   // Check also for types from the nav_search table and VORTACs
-  QString type = record.valueStr("type");
+  QString type = source.valueStr("type");
   if(type == "VH" || type == "VTH")
     vor.type = "H";
   else if(type == "VL" || type == "VTL")
@@ -310,16 +450,16 @@ void MapTypesFactory::fillVorBase(const SqlRecord& record, map::MapVor& vor)
   vor.tacan = type == "TC";
   vor.vortac = type.startsWith("VT");
 
-  vor.channel = record.valueStr("channel");
-  vor.frequency = record.valueInt("frequency");
+  vor.channel = source.valueStr("channel");
+  vor.frequency = source.valueInt("frequency");
 
-  vor.range = record.valueInt("range");
-  vor.magvar = record.valueFloat("mag_var");
+  vor.range = source.valueInt("range");
+  vor.magvar = source.valueFloat("mag_var");
 
-  if(record.isNull("altitude"))
-    vor.position = Pos(record.valueFloat("lonx"), record.valueFloat("laty"), INVALID_ALTITUDE_VALUE);
+  if(source.isNull("altitude"))
+    vor.position = Pos(source.valueFloat("lonx"), source.valueFloat("laty"), INVALID_ALTITUDE_VALUE);
   else
-    vor.position = Pos(record.valueFloat("lonx"), record.valueFloat("laty"), record.valueFloat("altitude"));
+    vor.position = Pos(source.valueFloat("lonx"), source.valueFloat("laty"), source.valueFloat("altitude"));
 }
 
 void MapTypesFactory::fillUserdataPoint(const SqlRecord& rec, map::MapUserpoint& obj)
@@ -333,6 +473,7 @@ void MapTypesFactory::fillUserdataPoint(const SqlRecord& rec, map::MapUserpoint&
     obj.type = rec.valueStr("type");
     obj.description = rec.valueStr("description");
     obj.tags = rec.valueStr("tags");
+    obj.visibleFrom = rec.valueFloat("visible_from", 0.f);
     obj.temp = rec.valueBool("temp", false);
     obj.position = atools::geo::Pos(rec.valueFloat("lonx"), rec.valueFloat("laty"));
   }
@@ -381,19 +522,30 @@ void MapTypesFactory::fillLogbookEntry(const atools::sql::SqlRecord& rec, MapLog
 
 void MapTypesFactory::fillNdb(const SqlRecord& record, map::MapNdb& ndb)
 {
-  ndb.id = record.valueInt("ndb_id");
-  ndb.ident = record.valueStr("ident");
-  ndb.region = record.valueStr("region");
-  ndb.name = atools::capString(record.valueStr("name"));
-  ndb.type = record.valueStr("type");
-  ndb.frequency = record.valueInt("frequency");
-  ndb.range = record.valueInt("range");
-  ndb.magvar = record.valueFloat("mag_var");
-
-  if(record.isNull("altitude"))
-    ndb.position = Pos(record.valueFloat("lonx"), record.valueFloat("laty"), INVALID_ALTITUDE_VALUE);
+  fillNdbInternal(record, ndb);
+}
+
+void MapTypesFactory::fillNdb(const SqlQuery& query, map::MapNdb& ndb)
+{
+  fillNdbInternal(query, ndb);
+}
+
+template<typename Source>
+void MapTypesFactory::fillNdbInternal(const Source& source, map::MapNdb& ndb)
+{
+  ndb.id = source.valueInt("ndb_id");
+  ndb.ident = intern(source.valueStr("ident"));
+  ndb.region = intern(source.valueStr("region"));
+  ndb.name = atools::capString(source.valueStr("name"));
+  ndb.type = source.valueStr("type");
+  ndb.frequency = source.valueInt("frequency");
+  ndb.range = source.valueInt("range");
+  ndb.magvar = source.valueFloat("mag_var");
+
+  if(source.isNull("altitude"))
+    ndb.position = Pos(source.valueFloat("lonx"), source.valueFloat("laty"), INVALID_ALTITUDE_VALUE);
   else
-    ndb.position = Pos(record.valueFloat("lonx"), record.valueFloat("laty"), record.valueFloat("altitude"));
+    ndb.position = Pos(source.valueFloat("lonx"), source.valueFloat("laty"), source.valueFloat("altitude"));
 }
 
 void MapTypesFactory::fillHelipad(const SqlRecord& record, map::MapHelipad& helipad)
@@ -417,23 +569,34 @@ void MapTypesFactory::fillHelipad(const SqlRecord& record, map::MapHelipad& heli
 
 void MapTypesFactory::fillWaypoint(const SqlRecord& record, map::MapWaypoint& waypoint, bool track)
 {
-  waypoint.id = record.valueInt(track ? "trackpoint_id" : "waypoint_id");
-  waypoint.ident = record.valueStr("ident");
-  waypoint.region = record.valueStr("region");
-  waypoint.type = record.valueStr("type");
-  waypoint.magvar = record.valueFloat("mag_var");
-  waypoint.hasVictorAirways = record.valueInt("num_victor_airway") > 0;
-  waypoint.hasJetAirways = record.valueInt("num_jet_airway") > 0;
-  waypoint.artificial = record.valueInt("artificial", 0);
+  fillWaypointInternal(record, waypoint, track);
+}
+
+void MapTypesFactory::fillWaypoint(const SqlQuery& query, map::MapWaypoint& waypoint, bool track)
+{
+  fillWaypointInternal(query, waypoint, track);
+}
+
+template<typename Source>
+void MapTypesFactory::fillWaypointInternal(const Source& source, map::MapWaypoint& waypoint, bool track)
+{
+  waypoint.id = source.valueInt(track ? "trackpoint_id" : "waypoint_id");
+  waypoint.ident = intern(source.valueStr("ident"));
+  waypoint.region = intern(source.valueStr("region"));
+  waypoint.type = source.valueStr("type");
+  waypoint.magvar = source.valueFloat("mag_var");
+  waypoint.hasVictorAirways = source.valueInt("num_victor_airway") > 0;
+  waypoint.hasJetAirways = source.valueInt("num_jet_airway") > 0;
+  waypoint.artificial = hasColumn(source, "artificial") ? source.valueInt("artificial") : 0;
   waypoint.hasTracks = track;
-  waypoint.position = Pos(record.valueFloat("lonx"), record.valueFloat("laty"));
+  waypoint.position = Pos(source.valueFloat("lonx"), source.valueFloat("laty"));
 }
 
 void MapTypesFactory::fillWaypointFromNav(const SqlRecord& record, map::MapWaypoint& waypoint)
 {
   waypoint.id = record.valueInt("waypoint_id");
-  waypoint.ident = record.valueStr("ident");
-  waypoint.region = record.valueStr("region");
+  waypoint.ident = intern(record.valueStr("ident"));
+  waypoint.region = intern(record.valueStr("region"));
   waypoint.type = record.valueStr("type");
   waypoint.magvar = record.valueFloat("mag_var");
   waypoint.hasVictorAirways = record.valueInt("waypoint_num_victor_airway") > 0;
@@ -459,7 +622,7 @@ void MapTypesFactory::fillAirwayOrTrack(const SqlRecord& record, map::MapAirway&
   if(track)
   {
     airway.id = record.valueInt("track_id");
-    airway.name = record.valueStr("track_name");
+    airway.name = intern(record.valueStr("track_name"));
     airway.fragment = record.valueInt("track_fragment_no");
     airway.airwayId = record.valueInt("airway_id");
 
@@ -497,7 +660,7 @@ void MapTypesFactory::fillAirwayOrTrack(const SqlRecord& record, map::MapAirway&
     airway.id = record.valueInt("airway_id");
     airway.type = airwayTrackTypeFromString(record.valueStr("airway_type"));
     airway.routeType = airwayRouteTypeFromString(record.valueStr("route_type", QString()));
-    airway.name = record.valueStr("airway_name");
+    airway.name = intern(record.valueStr("airway_name"));
 
     airway.minAltitude = record.valueInt("minimum_altitude");
     if(record.contains("maximum_altitude") && record.valueInt("maximum_altitude") > 0)
@@ -524,34 +687,56 @@ void MapTypesFactory::fillAirwayOrTrack(const SqlRecord& record, map::MapAirway&
 
 void MapTypesFactory::fillMarker(const SqlRecord& record, map::MapMarker& marker)
 {
-  marker.id = record.valueInt("marker_id");
-  marker.type = record.valueStr("type");
-  marker.ident = record.valueStr("ident");
-  marker.heading = static_cast<int>(std::round(record.valueFloat("heading")));
-  marker.position = Pos(record.valueFloat("lonx"),
-                        record.valueFloat("laty"));
+  fillMarkerInternal(record, marker);
+}
+
+void MapTypesFactory::fillMarker(const SqlQuery& query, map::MapMarker& marker)
+{
+  fillMarkerInternal(query, marker);
+}
+
+template<typename Source>
+void MapTypesFactory::fillMarkerInternal(const Source& source, map::MapMarker& marker)
+{
+  marker.id = source.valueInt("marker_id");
+  marker.type = intern(source.valueStr("type"));
+  marker.ident = intern(source.valueStr("ident"));
+  marker.heading = static_cast<int>(std::round(source.valueFloat("heading")));
+  marker.position = Pos(source.valueFloat("lonx"),
+                        source.valueFloat("laty"));
 }
 
 void MapTypesFactory::fillIls(const SqlRecord& record, map::MapIls& ils)
 {
-  ils.id = record.valueInt("ils_id");
-  ils.ident = record.valueStr("ident");
-  ils.name = record.valueStr("name");
-  ils.region = record.valueStr("region", QString());
-  ils.heading = record.valueFloat("loc_heading");
-  ils.width = record.isNull("loc_width") ? INVALID_COURSE_VALUE : record.valueFloat("loc_width");
-  ils.magvar = record.valueFloat("mag_var");
-  ils.slope = record.valueFloat("gs_pitch");
-
-  ils.frequency = record.valueInt("frequency");
-  ils.range = record.valueInt("range");
-  ils.hasDme = record.valueInt("dme_range") > 0;
-
-  ils.position = Pos(record.valueFloat("lonx"), record.valueFloat("laty"),
-                     record.valueFloat("altitude"));
-  ils.pos1 = Pos(record.valueFloat("end1_lonx"), record.valueFloat("end1_laty"));
-  ils.pos2 = Pos(record.valueFloat("end2_lonx"), record.valueFloat("end2_laty"));
-  ils.posmid = Pos(record.valueFloat("end_mid_lonx"), record.valueFloat("end_mid_laty"));
+  fillIlsInternal(record, ils);
+}
+
+void MapTypesFactory::fillIls(const SqlQuery& query, map::MapIls& ils)
+{
+  fillIlsInternal(query, ils);
+}
+
+template<typename Source>
+void MapTypesFactory::fillIlsInternal(const Source& source, map::MapIls& ils)
+{
+  ils.id = source.valueInt("ils_id");
+  ils.ident = intern(source.valueStr("ident"));
+  ils.name = source.valueStr("name");
+  ils.region = hasColumn(source, "region") ? intern(source.valueStr("region")) : QString();
+  ils.heading = source.valueFloat("loc_heading");
+  ils.width = source.isNull("loc_width") ? INVALID_COURSE_VALUE : source.valueFloat("loc_width");
+  ils.magvar = source.valueFloat("mag_var");
+  ils.slope = source.valueFloat("gs_pitch");
+
+  ils.frequency = source.valueInt("frequency");
+  ils.range = source.valueInt("range");
+  ils.hasDme = source.valueInt("dme_range") > 0;
+
+  ils.position = Pos(source.valueFloat("lonx"), source.valueFloat("laty"),
+                     source.valueFloat("altitude"));
+  ils.pos1 = Pos(source.valueFloat("end1_lonx"), source.valueFloat("end1_laty"));
+  ils.pos2 = Pos(source.valueFloat("end2_lonx"), source.valueFloat("end2_laty"));
+  ils.posmid = Pos(source.valueFloat("end_mid_lonx"), source.valueFloat("end_mid_laty"));
 
   ils.bounding = Rect(ils.position);
   ils.bounding.extend(ils.pos1);
@@ -587,40 +772,56 @@ void MapTypesFactory::fillStart(const SqlRecord& record, map::MapStart& start)
 
 void MapTypesFactory::fillAirspace(const SqlRecord& record, map::MapAirspace& airspace, map::MapAirspaceSources src)
 {
-  if(record.contains("boundary_id"))
-    airspace.id = record.valueInt("boundary_id");
-  else if(record.contains("atc_id"))
-    airspace.id = record.valueInt("atc_id");
+  fillAirspaceInternal(record, airspace, src);
+}
+
+void MapTypesFactory::fillAirspace(const SqlQuery& query, map::MapAirspace& airspace, map::MapAirspaceSources src)
+{
+  fillAirspaceInternal(query, airspace, src);
+}
+
+template<typename Source>
+void MapTypesFactory::fillAirspaceInternal(const Source& source, map::MapAirspace& airspace,
+                                           map::MapAirspaceSources src)
+{
+  if(hasColumn(source, "boundary_id"))
+    airspace.id = source.valueInt("boundary_id");
+  else if(hasColumn(source, "atc_id"))
+    airspace.id = source.valueInt("atc_id");
 
   airspace.src = src;
 
-  airspace.type = map::airspaceTypeFromDatabase(record.valueStr("type"));
-  airspace.name = record.valueStr(airspace.isOnline() ? "callsign" : "name");
-  airspace.comType = record.valueStr("com_type");
+  airspace.type = map::airspaceTypeFromDatabase(source.valueStr("type"));
+  airspace.name = source.valueStr(airspace.isOnline() ? "callsign" : "name");
+  airspace.comType = source.valueStr("com_type");
 
-  for(const QString& str : record.valueStr("com_frequency", QString()).split("&"))
+  if(hasColumn(source, "com_frequency"))
   {
-    bool ok;
-    int frequency = str.toInt(&ok);
+    for(const QString& str : source.valueStr("com_frequency").split("&"))
+    {
+      bool ok;
+      int frequency = str.toInt(&ok);
 
-    if(frequency > 0 && ok)
-      airspace.comFrequencies.append(frequency);
+      if(frequency > 0 && ok)
+        airspace.comFrequencies.append(frequency);
+    }
   }
 
   // Use default values for online network ATC centers
-  airspace.comName = record.valueStr("com_name", QString());
-  airspace.multipleCode = record.valueStr("multiple_code", QString());
-  airspace.restrictiveDesignation = record.valueStr("restrictive_designation", QString());
-  airspace.restrictiveType = record.valueStr("restrictive_type", QString());
-  airspace.timeCode = record.valueStr("time_code", QString());
-  airspace.minAltitudeType = record.valueStr("min_altitude_type", QString());
-  airspace.maxAltitudeType = record.valueStr("max_altitude_type", QString());
-  airspace.maxAltitude = record.valueInt("max_altitude", 0);
-  airspace.minAltitude = record.valueInt("min_altitude", 60000);
+  airspace.comName = hasColumn(source, "com_name") ? source.valueStr("com_name") : QString();
+  airspace.multipleCode = hasColumn(source, "multiple_code") ? source.valueStr("multiple_code") : QString();
+  airspace.restrictiveDesignation =
+    hasColumn(source, "restrictive_designation") ? source.valueStr("restrictive_designation") : QString();
+  airspace.restrictiveType = hasColumn(source, "restrictive_type") ? source.valueStr("restrictive_type") : QString();
+  airspace.timeCode = hasColumn(source, "time_code") ? source.valueStr("time_code") : QString();
+  airspace.minAltitudeType = hasColumn(source, "min_altitude_type") ? source.valueStr("min_altitude_type") : QString();
+  airspace.maxAltitudeType = hasColumn(source, "max_altitude_type") ? source.valueStr("max_altitude_type") : QString();
+  airspace.maxAltitude = hasColumn(source, "max_altitude") ? source.valueInt("max_altitude") : 0;
+  airspace.minAltitude = hasColumn(source, "min_altitude") ? source.valueInt("min_altitude") : 60000;
 
   // explicit Rect(double leftLonX, double topLatY, double rightLonX, double bottomLatY);
-  airspace.bounding = Rect(record.valueFloat("min_lonx"), record.valueFloat("max_laty"),
-                           record.valueFloat("max_lonx"), record.valueFloat("min_laty"));
+  airspace.bounding = Rect(source.valueFloat("min_lonx"), source.valueFloat("max_laty"),
+                           source.valueFloat("max_lonx"), source.valueFloat("min_laty"));
 
   airspace.position = airspace.bounding.getCenter();
 }
@@ -20,9 +20,14 @@
 
 #include "common/mapflags.h"
 
+#include <QSet>
+#include <QVector>
+#include <QString>
+
 namespace atools {
 namespace sql {
 
+class SqlQuery;
 class SqlRecord;
 }
 }
@@ -60,6 +65,37 @@ struct MapLogbookEntry;
 
 }
 
+/*
+ * Caches the resolution of column names to indexes for one query result layout allowing to read
+ * records by position instead of searching every field by name for each row. The cached layout is
+ * verified with one cheap comparison per column and record and re-resolved if the layout changed,
+ * i.e. the owning fill method was called with records from a different query.
+ */
+class ColumnBinding
+{
+public:
+  /* Resolve or verify the indexes for the given column names. Call for each record before
+   * reading. Missing optional columns get index -1. */
+  void bind(const atools::sql::SqlRecord& record, const QVector<QString>& columnNames);
+
+  /* True if the column exists in the bound record layout */
+  bool contains(int column) const
+  {
+    return indexes.at(column) >= 0;
+  }
+
+  /* Read a value by position. The default is returned if the column is missing in the record. */
+  int valueInt(const atools::sql::SqlRecord& record, int column, int defaultValue = 0) const;
+  float valueFloat(const atools::sql::SqlRecord& record, int column, float defaultValue = 0.f) const;
+  QString valueStr(const atools::sql::SqlRecord& record, int column,
+                   const QString& defaultValue = QString()) const;
+
+private:
+  /* Column index in the bound record layout for each column name or -1 if missing */
+  QVector<int> indexes;
+  QVector<QString> names;
+};
+
 /*
  * Create all map objects (namespace maptypes) from sql records. The sql records can be
  * a result from sql queries or manually built.
@@ -100,6 +136,16 @@ public:
   void fillMarker(const atools::sql::SqlRecord& record, map::MapMarker& marker);
   void fillIls(const atools::sql::SqlRecord& record, map::MapIls& ils);
 
+  /* Overloads reading the current result row directly from the query. Avoids building a
+   * SqlRecord per row which copies every column value into a fresh QVariant buffer - use
+   * these in loops fetching many rows. */
+  void fillVor(const atools::sql::SqlQuery& query, map::MapVor& vor);
+  void fillNdb(const atools::sql::SqlQuery& query, map::MapNdb& ndb);
+  void fillWaypoint(const atools::sql::SqlQuery& query, map::MapWaypoint& waypoint, bool track);
+  void fillMarker(const atools::sql::SqlQuery& query, map::MapMarker& marker);
+  void fillIls(const atools::sql::SqlQuery& query, map::MapIls& ils);
+  void fillAirspace(const atools::sql::SqlQuery& query, map::MapAirspace& airspace, map::MapAirspaceSources src);
+
   void fillParking(const atools::sql::SqlRecord& record, map::MapParking& parking);
   void fillStart(const atools::sql::SqlRecord& record, map::MapStart& start);
 
@@ -111,15 +157,49 @@ public:
 
   void fillLogbookEntry(const atools::sql::SqlRecord& rec, map::MapLogbookEntry& obj);
 
+  /* Return the shared instance of a short string like an ident, region code or airway name from
+   * the intern pool inserting it if needed. All map objects built by any factory share one string
+   * object per distinct value which keeps the heap small when loading thousands of objects with
+   * repeating codes. Only to be used in the GUI thread like the factories themselves. */
+  static QString intern(const QString& str);
+
 private:
-  void fillVorBase(const atools::sql::SqlRecord& record, map::MapVor& vor);
+  /* Shared implementations reading from a SqlRecord or directly from a SqlQuery result row.
+   * Both sources offer the same named value accessors. Instantiated in the translation unit
+   * by the public overloads above. */
+  template<typename Source>
+  void fillVorBase(const Source& source, map::MapVor& vor);
+
+  template<typename Source>
+  void fillVorInternal(const Source& source, map::MapVor& vor);
+
+  template<typename Source>
+  void fillNdbInternal(const Source& source, map::MapNdb& ndb);
+
+  template<typename Source>
+  void fillWaypointInternal(const Source& source, map::MapWaypoint& waypoint, bool track);
+
+  template<typename Source>
+  void fillMarkerInternal(const Source& source, map::MapMarker& marker);
+
+  template<typename Source>
+  void fillIlsInternal(const Source& source, map::MapIls& ils);
+
+  template<typename Source>
+  void fillAirspaceInternal(const Source& source, map::MapAirspace& airspace, map::MapAirspaceSources src);
 
   void fillAirportBase(const atools::sql::SqlRecord& record, map::MapAirport& ap, bool complete);
 
-  map::MapAirportFlags airportFlag(const atools::sql::SqlRecord& record, const QString& field,
+  map::MapAirportFlags airportFlag(const atools::sql::SqlRecord& record, int column,
                                    map::MapAirportFlags airportFlag);
   map::MapAirportFlags fillAirportFlags(const atools::sql::SqlRecord& record, bool overview);
 
+  /* Resolved airport columns of the last seen query layout - reused between rows */
+  ColumnBinding airportBinding;
+
+  /* Interned idents, region codes and airway names shared by all factory instances.
+   * Bounded by the number of distinct values in the loaded databases. */
+  static QSet<QString> internPool;
 };
 
 #endif // LITTLENAVMAP_MAPTYPESFACTORY_H
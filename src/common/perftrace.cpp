@@ -0,0 +1,183 @@
+/*****************************************************************************
+* Copyright 2015-2020 Alexander Barthel alex@littlenavmap.org
+*
+* This program is free software: you can redistribute it and/or modify
+* it under the terms of the GNU General Public License as published by
+* the Free Software Foundation, either version 3 of the License, or
+* (at your option) any later version.
+*
+* This program is distributed in the hope that it will be useful,
+* but WITHOUT ANY WARRANTY; without even the implied warranty of
+* MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+* GNU General Public License for more details.
+*
+* You should have received a copy of the GNU General Public License
+* along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*****************************************************************************/
+
+#include "common/perftrace.h"
+
+#include "common/constants.h"
+#include "settings/settings.h"
+
+#include <QDebug>
+#include <QElapsedTimer>
+#include <QFile>
+#include <QJsonArray>
+#include <QJsonDocument>
+#include <QJsonObject>
+#include <QMutex>
+#include <QThread>
+
+namespace perftrace {
+
+namespace {
+
+struct TraceEvent
+{
+  QString name;
+  qint64 startUs, durUs; /* durUs is -1 for instant events */
+  int threadNum;
+};
+
+/* Keep the buffer bounded for long sessions - newer events are dropped once full */
+const int MAX_EVENTS = 100000;
+
+QVector<TraceEvent> events;
+QMutex eventMutex;
+QElapsedTimer traceClock;
+/* Maps Qt thread ids to small sequential numbers usable in the JSON tid field */
+QHash<Qt::HANDLE, int> threadNumbers;
+int numDropped = 0;
+
+/* Monotonic microseconds since the first recorded event. Needs the lock held. */
+qint64 nowUs()
+{
+  if(!traceClock.isValid())
+    traceClock.start();
+  return traceClock.nsecsElapsed() / 1000;
+}
+
+void record(const QString& name, qint64 startUs, qint64 durUs)
+{
+  QMutexLocker locker(&eventMutex);
+  if(events.size() >= MAX_EVENTS)
+  {
+    numDropped++;
+    return;
+  }
+
+  Qt::HANDLE threadId = QThread::currentThreadId();
+  auto it = threadNumbers.find(threadId);
+  if(it == threadNumbers.end())
+    it = threadNumbers.insert(threadId, threadNumbers.size());
+
+  events.append({name, startUs, durUs, it.value()});
+}
+
+} // namespace
+
+bool isEnabled()
+{
+  static const bool enabled = atools::settings::Settings::instance().
+                              getAndStoreValue(lnm::OPTIONS_PERF_TRACE, false).toBool();
+  return enabled;
+}
+
+Span::Span(const QString& nameParam)
+{
+  if(isEnabled())
+  {
+    name = nameParam;
+    QMutexLocker locker(&eventMutex);
+    startUs = nowUs();
+  }
+}
+
+Span::~Span()
+{
+  if(startUs >= 0)
+  {
+    qint64 endUs;
+    {
+      QMutexLocker locker(&eventMutex);
+      endUs = nowUs();
+    }
+    record(name, startUs, endUs - startUs);
+  }
+}
+
+void instant(const QString& name)
+{
+  if(isEnabled())
+  {
+    qint64 startUs;
+    {
+      QMutexLocker locker(&eventMutex);
+      startUs = nowUs();
+    }
+    record(name, startUs, -1);
+  }
+}
+
+QString save()
+{
+  QMutexLocker locker(&eventMutex);
+  if(events.isEmpty())
+    return QString();
+
+  QJsonArray traceEvents;
+  for(const TraceEvent& event : events)
+  {
+    QJsonObject obj;
+    obj.insert("name", event.name);
+    obj.insert("cat", QString("app"));
+    obj.insert("pid", 1);
+    obj.insert("tid", event.threadNum);
+    obj.insert("ts", event.startUs);
+    if(event.durUs >= 0)
+    {
+      obj.insert("ph", QString("X"));
+      obj.insert("dur", event.durUs);
+    }
+    else
+    {
+      // Instant event with thread scope
+      obj.insert("ph", QString("i"));
+      obj.insert("s", QString("t"));
+    }
+    traceEvents.append(obj);
+  }
+
+  QJsonObject root;
+  root.insert("traceEvents", traceEvents);
+
+  QString filename = atools::settings::Settings::getConfigFilename("_trace.json");
+  QFile file(filename);
+  if(file.open(QIODevice::WriteOnly | QIODevice::Text))
+  {
+    file.write(QJsonDocument(root).toJson(QJsonDocument::Compact));
+    file.close();
+  }
+  else
+  {
+    qWarning() << "Cannot write performance trace" << file.fileName() << ":" << file.errorString();
+    return QString();
+  }
+
+  if(numDropped > 0)
+    qWarning() << Q_FUNC_INFO << numDropped << "trace events dropped since the buffer was full";
+
+  events.clear();
+  numDropped = 0;
+  return filename;
+}
+
+void clear()
+{
+  QMutexLocker locker(&eventMutex);
+  events.clear();
+  numDropped = 0;
+}
+
+} // namespace perftrace
@@ -0,0 +1,66 @@
+/*****************************************************************************
+* Copyright 2015-2020 Alexander Barthel alex@littlenavmap.org
+*
+* This program is free software: you can redistribute it and/or modify
+* it under the terms of the GNU General Public License as published by
+* the Free Software Foundation, either version 3 of the License, or
+* (at your option) any later version.
+*
+* This program is distributed in the hope that it will be useful,
+* but WITHOUT ANY WARRANTY; without even the implied warranty of
+* MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+* GNU General Public License for more details.
+*
+* You should have received a copy of the GNU General Public License
+* along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*****************************************************************************/
+
+#ifndef LITTLENAVMAP_PERFTRACE_H
+#define LITTLENAVMAP_PERFTRACE_H
+
+#include <QString>
+
+/*
+ * Lightweight performance tracing for long running operations like flight plan load,
+ * route calculation, altitude profile calculation and map painting.
+ *
+ * Scoped spans are collected in memory and written as Chrome trace JSON which can be
+ * opened in chrome://tracing or Perfetto. Parent and child relations follow from the
+ * nesting of spans on the same thread, so one file shows where the time of a slow
+ * plan load went across subsystems and threads.
+ *
+ * Disabled by default and enabled with the settings key Options/PerformanceTrace.
+ * When disabled recording a span is a single flag check.
+ */
+namespace perftrace {
+
+/* True if tracing was enabled in the settings. Read once on first use -
+ * changing the key needs a restart like the other debug flags. */
+bool isEnabled();
+
+/* Records the enclosing scope as a span from construction to destruction.
+ * Does nothing if tracing is disabled. */
+class Span
+{
+public:
+  explicit Span(const QString& nameParam);
+  ~Span();
+
+private:
+  QString name;
+  qint64 startUs = -1;
+};
+
+/* Records a zero length event like a merged redraw trigger */
+void instant(const QString& name);
+
+/* Writes all collected events as Chrome trace JSON to the settings directory and
+ * clears the buffer. Returns the filename or an empty string if nothing was collected. */
+QString save();
+
+/* Drops all collected events */
+void clear();
+
+} // namespace perftrace
+
+#endif // LITTLENAVMAP_PERFTRACE_H
@@ -18,6 +18,7 @@
 #include "symbolpainter.h"
 
 #include "common/maptypes.h"
+#include "common/textplacement.h"
 #include "query/mapquery.h"
 #include "common/mapcolors.h"
 #include "options/optiondata.h"
@@ -30,6 +31,7 @@
 
 #include <QPainter>
 #include <QApplication>
+#include <QPixmapCache>
 #include <marble/GeoPainter.h>
 
 using namespace Marble;
@@ -43,6 +45,9 @@ const QVector<QLine> AIRCRAFTLINES({QLine(0, -20, 0, 16), // Body
                                     QLine(-10, 18, 0, 14), QLine(0, 14, 10, 18) // Horizontal stabilizer
                                    });
 
+/* Margin around cached symbol pixmaps to avoid clipping pen strokes extending beyond the symbol size */
+const static int SYMBOL_PIXMAP_MARGIN = 4;
+
 SymbolPainter::SymbolPainter()
 {
 }
@@ -302,6 +307,39 @@ void SymbolPainter::drawAirportSymbol(QPainter *painter, const map::MapAirport&
 }
 
 void SymbolPainter::drawWaypointSymbol(QPainter *painter, const QColor& col, float x, float y, int size, bool fill)
+{
+  // Rasterize the symbol once per parameter combination and blit it from the pixmap cache afterwards
+  float dpr = static_cast<float>(painter->device()->devicePixelRatioF());
+  quint32 color = col.isValid() ? col.rgba() : 0;
+
+  if(waypointKeyMemo.key.isEmpty() || size != waypointKeyMemo.size || dpr != waypointKeyMemo.dpr ||
+     color != waypointKeyMemo.color || fill != waypointKeyMemo.flags)
+  {
+    waypointKeyMemo.key = QString("waypointsymbol_%1_%2_%3_%4").arg(size).arg(color).arg(fill).arg(dpr);
+    waypointKeyMemo.size = size;
+    waypointKeyMemo.dpr = dpr;
+    waypointKeyMemo.color = color;
+    waypointKeyMemo.flags = fill;
+  }
+  const QString& key = waypointKeyMemo.key;
+
+  QPixmap pixmap;
+  if(!QPixmapCache::find(key, &pixmap))
+  {
+    int width = size + SYMBOL_PIXMAP_MARGIN * 2;
+    pixmap = symbolPixmap(width, width, dpr);
+    QPainter pixmapPainter(&pixmap);
+    prepareForIcon(pixmapPainter);
+    paintWaypointSymbol(&pixmapPainter, col, width / 2.f, width / 2.f, size, fill);
+    pixmapPainter.end();
+    QPixmapCache::insert(key, pixmap);
+  }
+
+  float offset = size / 2.f + SYMBOL_PIXMAP_MARGIN;
+  painter->drawPixmap(QPointF(x - offset, y - offset), pixmap);
+}
+
+void SymbolPainter::paintWaypointSymbol(QPainter *painter, const QColor& col, float x, float y, int size, bool fill)
 {
   atools::util::PainterContextSaver saver(painter);
   painter->setBackgroundMode(Qt::TransparentMode);
@@ -745,6 +783,46 @@ void SymbolPainter::drawProcedureFaf(QPainter *painter, int x, int y, int size)
 
 void SymbolPainter::drawVorSymbol(QPainter *painter, const map::MapVor& vor, float x, float y, float size,
                                   bool routeFill, bool fast, int largeSize)
+{
+  if(largeSize > 0 && !vor.dmeOnly)
+  {
+    // Symbol is rotated by magnetic variation and gets a compass rose - cannot be cached
+    paintVorSymbol(painter, vor, x, y, size, routeFill, fast, largeSize);
+    return;
+  }
+
+  // Rasterize the symbol once per parameter combination and blit it from the pixmap cache afterwards
+  float dpr = static_cast<float>(painter->device()->devicePixelRatioF());
+  int flags = (vor.tacan << 0) | (vor.vortac << 1) | (vor.hasDme << 2) | (vor.dmeOnly << 3) | (routeFill << 4);
+
+  if(vorKeyMemo.key.isEmpty() || size != vorKeyMemo.size || dpr != vorKeyMemo.dpr || flags != vorKeyMemo.flags)
+  {
+    vorKeyMemo.key = QString("vorsymbol_%1_%2_%3_%4_%5_%6_%7").
+                     arg(size).arg(vor.tacan).arg(vor.vortac).arg(vor.hasDme).arg(vor.dmeOnly).arg(routeFill).arg(dpr);
+    vorKeyMemo.size = size;
+    vorKeyMemo.dpr = dpr;
+    vorKeyMemo.flags = flags;
+  }
+  const QString& key = vorKeyMemo.key;
+
+  QPixmap pixmap;
+  if(!QPixmapCache::find(key, &pixmap))
+  {
+    int width = static_cast<int>(std::ceil(size)) + SYMBOL_PIXMAP_MARGIN * 2;
+    pixmap = symbolPixmap(width, width, dpr);
+    QPainter pixmapPainter(&pixmap);
+    prepareForIcon(pixmapPainter);
+    paintVorSymbol(&pixmapPainter, vor, width / 2.f, width / 2.f, size, routeFill, fast, largeSize);
+    pixmapPainter.end();
+    QPixmapCache::insert(key, pixmap);
+  }
+
+  float offset = std::ceil(size) / 2.f + SYMBOL_PIXMAP_MARGIN;
+  painter->drawPixmap(QPointF(x - offset, y - offset), pixmap);
+}
+
+void SymbolPainter::paintVorSymbol(QPainter *painter, const map::MapVor& vor, float x, float y, float size,
+                                   bool routeFill, bool fast, int largeSize)
 {
   atools::util::PainterContextSaver saver(painter);
   Q_UNUSED(saver);
@@ -881,6 +959,37 @@ void SymbolPainter::drawVorSymbol(QPainter *painter, const map::MapVor& vor, flo
 }
 
 void SymbolPainter::drawNdbSymbol(QPainter *painter, float x, float y, float size, bool routeFill, bool fast)
+{
+  // Rasterize the symbol once per parameter combination and blit it from the pixmap cache afterwards
+  float dpr = static_cast<float>(painter->device()->devicePixelRatioF());
+  int flags = (routeFill << 0) | (fast << 1);
+
+  if(ndbKeyMemo.key.isEmpty() || size != ndbKeyMemo.size || dpr != ndbKeyMemo.dpr || flags != ndbKeyMemo.flags)
+  {
+    ndbKeyMemo.key = QString("ndbsymbol_%1_%2_%3_%4").arg(size).arg(routeFill).arg(fast).arg(dpr);
+    ndbKeyMemo.size = size;
+    ndbKeyMemo.dpr = dpr;
+    ndbKeyMemo.flags = flags;
+  }
+  const QString& key = ndbKeyMemo.key;
+
+  QPixmap pixmap;
+  if(!QPixmapCache::find(key, &pixmap))
+  {
+    int width = static_cast<int>(std::ceil(size)) + SYMBOL_PIXMAP_MARGIN * 2;
+    pixmap = symbolPixmap(width, width, dpr);
+    QPainter pixmapPainter(&pixmap);
+    prepareForIcon(pixmapPainter);
+    paintNdbSymbol(&pixmapPainter, width / 2.f, width / 2.f, size, routeFill, fast);
+    pixmapPainter.end();
+    QPixmapCache::insert(key, pixmap);
+  }
+
+  float offset = std::ceil(size) / 2.f + SYMBOL_PIXMAP_MARGIN;
+  painter->drawPixmap(QPointF(x - offset, y - offset), pixmap);
+}
+
+void SymbolPainter::paintNdbSymbol(QPainter *painter, float x, float y, float size, bool routeFill, bool fast)
 {
   atools::util::PainterContextSaver saver(painter);
 
@@ -1109,14 +1218,15 @@ QStringList SymbolPainter::airportTexts(optsd::DisplayOptions dispOpts, textflag
 }
 
 void SymbolPainter::textBox(QPainter *painter, const QStringList& texts, const QPen& textPen, int x, int y,
-                            textatt::TextAttributes atts, int transparency, const QColor& backgroundColor)
+                            textatt::TextAttributes atts, int transparency, const QColor& backgroundColor,
+                            LabelCollisionGrid *collisionGrid)
 {
-  textBoxF(painter, texts, textPen, x, y, atts, transparency, backgroundColor);
+  textBoxF(painter, texts, textPen, x, y, atts, transparency, backgroundColor, collisionGrid);
 }
 
 void SymbolPainter::textBoxF(QPainter *painter, const QStringList& texts, const QPen& textPen,
                              float x, float y, textatt::TextAttributes atts, int transparency,
-                             const QColor& backgroundColor)
+                             const QColor& backgroundColor, LabelCollisionGrid *collisionGrid)
 {
   if(texts.isEmpty())
     return;
@@ -1173,6 +1283,25 @@ void SymbolPainter::textBoxF(QPainter *painter, const QStringList& texts, const
   QFontMetricsF metrics = painter->fontMetrics();
   float h = static_cast<float>(metrics.height()) - 1.f;
   float yoffset = (static_cast<float>(texts.size() * h)) / 2.f - static_cast<float>(metrics.descent());
+
+  if(collisionGrid != nullptr)
+  {
+    // Calculate the bounding rectangle of all lines like the drawing loop below does
+    float maxWidth = 0.f;
+    for(const QString& text : texts)
+      maxWidth = std::max(maxWidth, static_cast<float>(metrics.width(text)));
+
+    float left = x;
+    if(atts.testFlag(textatt::RIGHT))
+      left -= maxWidth;
+    else if(atts.testFlag(textatt::CENTER))
+      left -= maxWidth / 2.f;
+
+    if(!collisionGrid->insertIfFree(QRectF(left, y - texts.size() * h / 2.f, maxWidth, texts.size() * h)))
+      // Would be drawn on top of an already placed label - skip the whole box
+      return;
+  }
+
   painter->setPen(textPen);
 
   // Draw text in reverse order to avoid undercut
@@ -1262,6 +1391,15 @@ const QPixmap *SymbolPainter::trackLineFromCache(int size)
   }
 }
 
+QPixmap SymbolPainter::symbolPixmap(int width, int height, float dpr)
+{
+  // Create the pixmap in physical pixels to keep cached symbols crisp on high DPI screens
+  QPixmap pixmap(atools::roundToInt(width * dpr), atools::roundToInt(height * dpr));
+  pixmap.setDevicePixelRatio(static_cast<qreal>(dpr));
+  pixmap.fill(Qt::transparent);
+  return pixmap;
+}
+
 void SymbolPainter::prepareForIcon(QPainter& painter)
 {
   painter.setRenderHint(QPainter::Antialiasing, true);
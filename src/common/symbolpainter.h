@@ -36,6 +36,7 @@ class MetarParser;
 }
 }
 
+class LabelCollisionGrid;
 class QPainter;
 class QPen;
 
@@ -59,6 +60,10 @@ struct MapHelipad;
  * Separate functions are available for texts/captions.
  * An additional parameter "fast" is used to draw icons with less details while scrolling the map.
  * Instead of using a text collision detection text are placed on different sides of the symbols.
+ *
+ * Waypoint, VOR and NDB symbols are rasterized once per parameter combination into the application
+ * wide pixmap cache and blitted afterwards which is much cheaper than path drawing on every frame.
+ * The pixmap cache is cleared by the StyleHandler when the GUI style changes.
  */
 class SymbolPainter
 {
@@ -146,13 +151,16 @@ public:
   /* Maltese cross to indicate FAF on the map */
   void drawProcedureFaf(QPainter *painter, int x, int y, int size);
 
-  /* Draw a custom text box */
+  /* Draw a custom text box. If a collision grid is given the box is skipped entirely if it
+   * would overlap an already placed label and is registered in the grid otherwise. */
   void textBox(QPainter *painter, const QStringList& texts, const QPen& textPen, int x, int y,
                textatt::TextAttributes atts = textatt::NONE,
-               int transparency = 255, const QColor& backgroundColor = QColor());
+               int transparency = 255, const QColor& backgroundColor = QColor(),
+               LabelCollisionGrid *collisionGrid = nullptr);
   void textBoxF(QPainter *painter, const QStringList& texts, const QPen& textPen, float x, float y,
                 textatt::TextAttributes atts = textatt::NONE,
-                int transparency = 255, const QColor& backgroundColor = QColor());
+                int transparency = 255, const QColor& backgroundColor = QColor(),
+                LabelCollisionGrid *collisionGrid = nullptr);
 
   /* Get dimensions of a custom text box */
   QRect textBoxSize(QPainter *painter, const QStringList& texts, textatt::TextAttributes atts);
@@ -170,6 +178,30 @@ private:
   QCache<int, QPixmap> windPointerPixmaps, trackLinePixmaps;
   void prepareForIcon(QPainter& painter);
 
+  /* Remembers the last pixmap cache key built per symbol type. The paint loops draw long runs
+   * of symbols with identical parameters so the key string construction can be skipped for all
+   * but the first object. Only the key is memoized - the pixmap itself is still taken from the
+   * pixmap cache which may be cleared on a style change at any time. */
+  struct KeyMemo
+  {
+    QString key;
+    float size = -1.f, dpr = -1.f;
+    quint32 color = 0;
+    int flags = -1;
+  };
+
+  KeyMemo waypointKeyMemo, vorKeyMemo, ndbKeyMemo;
+
+  /* Paint the symbols directly bypassing the pixmap cache. Used to rasterize the cached pixmaps
+   * and as fallback for variants that cannot be cached like the rotated VOR compass rose. */
+  void paintWaypointSymbol(QPainter *painter, const QColor& col, float x, float y, int size, bool fill);
+  void paintVorSymbol(QPainter *painter, const map::MapVor& vor, float x, float y, float size, bool routeFill,
+                      bool fast, int largeSize);
+  void paintNdbSymbol(QPainter *painter, float x, float y, float size, bool routeFill, bool fast);
+
+  /* Create a transparent pixmap for the symbol cache honoring the device pixel ratio of the target */
+  QPixmap symbolPixmap(int width, int height, float dpr);
+
   void drawWindBarbs(QPainter *painter, const atools::fs::weather::MetarParser& parsedMetar, float x, float y,
                      float size, bool windBarbs, bool altWind, bool route, bool fast) const;
 
@@ -27,6 +27,67 @@
 using atools::geo::Line;
 using atools::geo::Pos;
 
+void LabelCollisionGrid::init(const QRect& screenRectParam, int cellSizeParam)
+{
+  screenRect = screenRectParam;
+  cellSize = cellSizeParam;
+  numCellsX = (screenRect.width() + cellSize - 1) / cellSize;
+  numCellsY = (screenRect.height() + cellSize - 1) / cellSize;
+
+  cells.clear();
+  cells.resize(numCellsX * numCellsY);
+}
+
+void LabelCollisionGrid::cellRange(const QRectF& rectangle, int& xmin, int& xmax, int& ymin, int& ymax) const
+{
+  xmin = std::max(0, (static_cast<int>(rectangle.left()) - screenRect.left()) / cellSize);
+  xmax = std::min(numCellsX - 1, (static_cast<int>(rectangle.right()) - screenRect.left()) / cellSize);
+  ymin = std::max(0, (static_cast<int>(rectangle.top()) - screenRect.top()) / cellSize);
+  ymax = std::min(numCellsY - 1, (static_cast<int>(rectangle.bottom()) - screenRect.top()) / cellSize);
+}
+
+bool LabelCollisionGrid::isOccupied(const QRectF& rectangle) const
+{
+  if(!isValid())
+    return false;
+
+  int xmin, xmax, ymin, ymax;
+  cellRange(rectangle, xmin, xmax, ymin, ymax);
+
+  for(int ycell = ymin; ycell <= ymax; ycell++)
+  {
+    for(int xcell = xmin; xcell <= xmax; xcell++)
+    {
+      for(const QRectF& occupied : cells.at(ycell * numCellsX + xcell))
+      {
+        if(occupied.intersects(rectangle))
+          return true;
+      }
+    }
+  }
+  return false;
+}
+
+bool LabelCollisionGrid::insertIfFree(const QRectF& rectangle)
+{
+  if(!isValid())
+    // Not initialized - draw everything
+    return true;
+
+  if(isOccupied(rectangle))
+    return false;
+
+  int xmin, xmax, ymin, ymax;
+  cellRange(rectangle, xmin, xmax, ymin, ymax);
+
+  for(int ycell = ymin; ycell <= ymax; ycell++)
+  {
+    for(int xcell = xmin; xcell <= xmax; xcell++)
+      cells[ycell * numCellsX + xcell].append(rectangle);
+  }
+  return true;
+}
+
 TextPlacement::TextPlacement(QPainter *painterParam, CoordinateConverter *coordinateConverter,
                              const QRect& screenRectParam)
   : painter(painterParam), converter(coordinateConverter)
@@ -45,6 +106,7 @@ TextPlacement::TextPlacement(QPainter *painterParam, CoordinateConverter *coordi
 void TextPlacement::calculateTextPositions(const atools::geo::LineString& points)
 {
   visibleStartPoints.resize(points.size() + 1);
+  startPoints.reserve(startPoints.size() + points.size());
 
   for(int i = 0; i < points.size(); i++)
   {
@@ -65,6 +127,7 @@ void TextPlacement::calculateTextPositions(const atools::geo::LineString& points
 void TextPlacement::calculateTextAlongLines(const QVector<atools::geo::Line>& lines, const QStringList& routeTexts)
 {
   visibleStartPoints.resize(lines.size() + 1);
+  textCoords.reserve(textCoords.size() + lines.size());
 
   QFontMetrics metrics = painter->fontMetrics();
   int x1, y1, x2, y2;
@@ -173,6 +236,29 @@ void TextPlacement::drawTextAlongOneLine(const QString& text, float bearing, con
   }
 }
 
+void TextPlacement::saveLayout(Layout& layout) const
+{
+  layout.textCoords = textCoords;
+  layout.startPoints = startPoints;
+  layout.textBearing = textBearing;
+  layout.texts = texts;
+  layout.textLineLengths = textLineLengths;
+  layout.visibleStartPoints = visibleStartPoints;
+  layout.colors2 = colors2;
+  layout.valid = true;
+}
+
+void TextPlacement::restoreLayout(const Layout& layout)
+{
+  textCoords = layout.textCoords;
+  startPoints = layout.startPoints;
+  textBearing = layout.textBearing;
+  texts = layout.texts;
+  textLineLengths = layout.textLineLengths;
+  visibleStartPoints = layout.visibleStartPoints;
+  colors2 = layout.colors2;
+}
+
 void TextPlacement::drawTextAlongLines()
 {
   if(!fast)
@@ -24,6 +24,7 @@
 #include <QPoint>
 #include <QApplication>
 #include <QColor>
+#include <QRect>
 #include <QVector>
 
 namespace atools {
@@ -37,6 +38,43 @@ class Pos;
 class QPainter;
 class CoordinateConverter;
 
+/*
+ * Uniform screen space grid keeping the rectangles of already placed labels.
+ * Allows to drop labels that would be drawn on top of an already placed one with a single
+ * insertion pass instead of comparing all label rectangles pairwise.
+ * Use one instance per paint pass and share it between painters to avoid overlaps across types.
+ */
+class LabelCollisionGrid
+{
+public:
+  /* Prepare the grid for the given screen rectangle and clear all stored rectangles.
+   * Cell size is in pixel. */
+  void init(const QRect& screenRectParam, int cellSizeParam = 64);
+
+  /* Insert the label rectangle if it does not overlap an already inserted one.
+   * Rectangles outside of the screen rectangle are reported as free but not stored.
+   * @return true if the rectangle was free and is now occupied */
+  bool insertIfFree(const QRectF& rectangle);
+
+  /* True if the rectangle overlaps an already inserted label rectangle */
+  bool isOccupied(const QRectF& rectangle) const;
+
+  bool isValid() const
+  {
+    return cellSize > 0;
+  }
+
+private:
+  /* Calculate the covered cell index range clamped to the grid */
+  void cellRange(const QRectF& rectangle, int& xmin, int& xmax, int& ymin, int& ymax) const;
+
+  int cellSize = 0, numCellsX = 0, numCellsY = 0;
+  QRect screenRect;
+
+  /* Label rectangles by cell - rectangles covering multiple cells are stored in each of them */
+  QVector<QVector<QRectF> > cells;
+};
+
 /* Contains methods for text placement along line strings. */
 class TextPlacement
 {
@@ -52,6 +90,26 @@ public:
   /* Calculate point coordinates and visibility */
   void calculateTextPositions(const atools::geo::LineString& points);
 
+  /* Result of the two calculate methods above. Can be kept by the caller across paint passes
+   * and loaded again with restoreLayout() to skip the whole placement calculation as long as
+   * viewport and texts are unchanged. */
+  struct Layout
+  {
+    QVector<QPointF> textCoords, startPoints;
+    QList<float> textBearing;
+    QStringList texts;
+    QList<int> textLineLengths;
+    QBitArray visibleStartPoints;
+    QVector<QColor> colors2;
+    bool valid = false;
+  };
+
+  /* Copy the placement state computed by the calculate methods into layout */
+  void saveLayout(Layout& layout) const;
+
+  /* Load a previously saved placement state instead of calculating it again */
+  void restoreLayout(const Layout& layout);
+
   /* Draw text after calling calculateTextAlongLines. Text is aligned with lines and kept in an
    * upwards readable position. Arrows are optionally added to end or start.
    *  the tree methods drawTextAlongLines, calculateTextAlongScreenLines and clearLineTextData work with a class state */
@@ -85,7 +143,7 @@ public:
   }
 
   /* Get all screen start points including the last one. Filled by calculateTextAlongLines */
-  const QList<QPointF>& getStartPoints() const
+  const QVector<QPointF>& getStartPoints() const
   {
     return startPoints;
   }
@@ -125,13 +183,13 @@ public:
   }
 
 private:
-  QList<QPointF> textCoords;
+  QVector<QPointF> textCoords;
   QList<float> textBearing;
   QStringList texts;
   QList<int> textLineLengths;
 
   // Collect start and end points of legs and visibility
-  QList<QPointF> startPoints;
+  QVector<QPointF> startPoints;
   QBitArray visibleStartPoints;
 
   /* Evaluate 50 text placement positions along line */
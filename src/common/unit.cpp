@@ -21,6 +21,8 @@
 
 #include "geo/pos.h"
 
+#include <QHash>
+
 const static QString COORDS_DEC_FORMAT_LONX("%L1° %L2");
 const static QString COORDS_DEC_FORMAT_LATY("%L1° %L2");
 const static QString COORDS_DMS_FORMAT_LONX("%L1° %L2' %L3\" %L4");
@@ -28,6 +30,38 @@ const static QString COORDS_DMS_FORMAT_LATY("%L1° %L2' %L3\" %L4");
 const static QString COORDS_DM_FORMAT_LONX("%L1° %L2' %L3");
 const static QString COORDS_DM_FORMAT_LATY("%L1° %L2' %L3");
 
+namespace {
+
+/* Key for the memoized formatter results below. The suffix is identified by the address of its
+ * static member which is stable. The cache is cleared when unit or language options change. */
+struct UnitKey
+{
+  const QString *suffix;
+  int value;
+  bool addUnit, narrow;
+};
+
+inline bool operator==(const UnitKey& key1, const UnitKey& key2)
+{
+  return key1.suffix == key2.suffix && key1.value == key2.value &&
+         key1.addUnit == key2.addUnit && key1.narrow == key2.narrow;
+}
+
+inline uint qHash(const UnitKey& key, uint seed)
+{
+  return ::qHash(key.value, seed) ^ ::qHash(reinterpret_cast<quintptr>(key.suffix)) ^
+         static_cast<uint>(key.addUnit << 1 | key.narrow);
+}
+
+}
+
+/* Formatted texts for the most frequent value and unit pairs. Map labels, the route table and the
+ * information display format the same rounded values over and over for every update. */
+static QHash<UnitKey, QString> formattedTextCache;
+
+/* Start over if too many distinct values accumulated - simpler than least recently used tracking */
+const static int FORMATTED_TEXT_CACHE_MAX_SIZE = 1000;
+
 QLocale *Unit::locale = nullptr;
 QLocale *Unit::clocale = nullptr;
 const OptionData *Unit::opts = nullptr;
@@ -145,6 +179,9 @@ void Unit::deInit()
 
 void Unit::initTranslateableTexts()
 {
+  // Cached texts have the suffixes of the previous language
+  formattedTextCache.clear();
+
   suffixDistNm = Unit::tr("nm");
   suffixDistKm = Unit::tr("km");
   suffixDistMi = Unit::tr("mi");
@@ -716,14 +753,31 @@ QString Unit::u(const QString& num, const QString& un, bool addUnit, bool narrow
 
 QString Unit::u(float num, const QString& un, bool addUnit, bool narrow)
 {
+  // Key on the rounded value which defines the printed digits - the returned string is
+  // implicitly shared so a cache hit avoids the locale formatting and the concatenations
+  UnitKey key = {&un, atools::roundToInt(num), addUnit, narrow};
+  QHash<UnitKey, QString>::const_iterator it = formattedTextCache.constFind(key);
+  if(it != formattedTextCache.constEnd())
+    return it.value();
+
+  if(formattedTextCache.size() > FORMATTED_TEXT_CACHE_MAX_SIZE)
+    formattedTextCache.clear();
+
+  QString text;
   if(narrow)
-    return clocale->toString(num, 'f', 0) + (addUnit ? QString() + un : QString());
+    text = clocale->toString(num, 'f', 0) + (addUnit ? QString() + un : QString());
   else
-    return locale->toString(num, 'f', 0) + (addUnit ? " " + un : QString());
+    text = locale->toString(num, 'f', 0) + (addUnit ? " " + un : QString());
+
+  formattedTextCache.insert(key, text);
+  return text;
 }
 
 void Unit::optionsChanged()
 {
+  // Cached texts have the old suffixes
+  formattedTextCache.clear();
+
   unitDist = opts->getUnitDist();
   unitShortDist = opts->getUnitShortDist();
   unitAlt = opts->getUnitAlt();
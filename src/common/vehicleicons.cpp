@@ -26,7 +26,8 @@
 
 VehicleIcons::VehicleIcons()
 {
-
+  // Make room for the pre-rotated variants of all types and sizes used by the map painters
+  aircraftPixmaps.setMaxCost(1000);
 }
 
 VehicleIcons::~VehicleIcons()
@@ -41,7 +42,7 @@ QIcon VehicleIcons::iconFromCache(const atools::fs::sc::SimConnectAircraft& ac,
 
 uint qHash(const VehicleIcons::PixmapKey& key)
 {
-  return static_cast<uint>(key.size | (key.type << 8) | (key.ground << 10) | (key.user << 11) | (key.rotate << 11));
+  return static_cast<uint>(key.size | (key.type << 8) | (key.ground << 10) | (key.user << 11) | (key.rotate << 12));
 }
 
 bool VehicleIcons::PixmapKey::operator==(const VehicleIcons::PixmapKey& other) const
@@ -29,6 +29,7 @@
 #include "settings/settings.h"
 #include "fs/sc/simconnecthandler.h"
 #include "fs/sc/xpconnecthandler.h"
+#include "geo/calculations.h"
 
 #include <QDataStream>
 #include <QTcpSocket>
@@ -45,6 +46,11 @@ ConnectClient::ConnectClient(MainWindow *parent)
   atools::settings::Settings& settings = atools::settings::Settings::instance();
   verbose = settings.getAndStoreValue(lnm::OPTIONS_CONNECTCLIENT_DEBUG, false).toBool();
 
+  // Region of interest around the user aircraft - AI received from the simulator outside of
+  // this radius is dropped at ingestion before any consumer sees the packet. 0 disables the filter.
+  aiRadiusMeter = atools::geo::nmToMeter(
+    settings.getAndStoreValue(lnm::OPTIONS_CONNECTCLIENT_AI_RADIUS_NM, 200).toFloat());
+
   errorMessageBox = new QMessageBox(QMessageBox::Critical, QApplication::applicationName(),
                                     QString(), QMessageBox::Ok, mainWindow);
 
@@ -222,30 +228,39 @@ void ConnectClient::disconnectedFromSimulatorDirect()
 }
 
 /* Posts data received directly from simconnect or the socket and caches any metar reports */
-void ConnectClient::postSimConnectData(atools::fs::sc::SimConnectData dataPacket)
+void ConnectClient::postSimConnectData(const atools::fs::sc::SimConnectData& dataPacket)
 {
+  // Copy once into the ring buffer - all consumers read the sample in place by reference
+  atools::fs::sc::SimConnectData& packet = simDataBuffer.nextSlot();
+  packet = dataPacket;
+
+  // Drop AI outside of the region of interest before any further per-aircraft processing -
+  // MSFS and others inject hundreds of parked aircraft at distant airports with every packet
+  filterAiByRegionOfInterest(packet);
+
   // Modify AI aircraft and set shadow flag if a online network with the same callsign exists
-  for(atools::fs::sc::SimConnectAircraft& aircraft : dataPacket.getAiAircraft())
+  for(atools::fs::sc::SimConnectAircraft& aircraft : packet.getAiAircraft())
   {
     if(NavApp::getOnlinedataController()->isShadowAircraft(aircraft))
       aircraft.setFlags(atools::fs::sc::SIM_ONLINE_SHADOW | aircraft.getFlags());
   }
 
   // Same as above for user aircraft
-  atools::fs::sc::SimConnectUserAircraft& userAircraft = dataPacket.getUserAircraft();
+  atools::fs::sc::SimConnectUserAircraft& userAircraft = packet.getUserAircraft();
   if(NavApp::getOnlinedataController()->isShadowAircraft(userAircraft))
     userAircraft.setFlags(atools::fs::sc::SIM_ONLINE_SHADOW | userAircraft.getFlags());
 
-  if(dataPacket.getStatus() == atools::fs::sc::OK)
+  if(packet.getStatus() == atools::fs::sc::OK)
   {
-    emit dataPacketReceived(dataPacket);
+    simDataBuffer.commit();
+    emit dataPacketReceived(simDataBuffer.latest());
 
-    if(!dataPacket.getMetars().isEmpty())
+    if(!packet.getMetars().isEmpty())
     {
       if(verbose)
-        qDebug() << "Metars number" << dataPacket.getMetars().size();
+        qDebug() << "Metars number" << packet.getMetars().size();
 
-      for(atools::fs::weather::MetarResult metar : dataPacket.getMetars())
+      for(atools::fs::weather::MetarResult metar : packet.getMetars())
       {
         QString ident = metar.requestIdent;
         if(verbose)
@@ -273,14 +288,14 @@ void ConnectClient::postSimConnectData(atools::fs::sc::SimConnectData dataPacket
         metarIdentCache.insert(ident, metar);
       }
 
-      if(!dataPacket.getMetars().isEmpty())
+      if(!packet.getMetars().isEmpty())
         emit weatherUpdated();
     }
-  } // if(dataPacket.getStatus() == atools::fs::sc::OK)
+  } // if(packet.getStatus() == atools::fs::sc::OK)
   else
   {
     bool xplane = dataReader != nullptr ? dataReader->isXplaneHandler() : false, network = isConnectedNetwork();
-    atools::fs::sc::SimConnectStatus status = dataPacket.getStatus();
+    atools::fs::sc::SimConnectStatus status = packet.getStatus();
     QString statusText = simConnectData->getStatusText();
 
     disconnectClicked();
@@ -288,6 +303,28 @@ void ConnectClient::postSimConnectData(atools::fs::sc::SimConnectData dataPacket
   }
 }
 
+void ConnectClient::filterAiByRegionOfInterest(atools::fs::sc::SimConnectData& packet)
+{
+  const atools::geo::Pos& userPos = packet.getUserAircraft().getPosition();
+
+  // Keep all vehicles if the filter is disabled or there is no valid user position to measure from
+  if(aiRadiusMeter <= 0.f || !userPos.isValid())
+    return;
+
+  QVector<atools::fs::sc::SimConnectAircraft>& ai = packet.getAiAircraft();
+  int before = ai.size();
+
+  ai.erase(std::remove_if(ai.begin(), ai.end(),
+                          [this, &userPos](const atools::fs::sc::SimConnectAircraft& aircraft) -> bool
+  {
+    return aircraft.getPosition().isValid() &&
+    userPos.distanceMeterTo(aircraft.getPosition()) > aiRadiusMeter;
+  }), ai.end());
+
+  if(verbose && ai.size() != before)
+    qDebug() << Q_FUNC_INFO << "Dropped" << before - ai.size() << "of" << before << "AI vehicles";
+}
+
 void ConnectClient::handleError(atools::fs::sc::SimConnectStatus status, const QString& error,
                                 bool xplane, bool network)
 {
@@ -21,6 +21,7 @@
 #include "fs/sc/simconnectdata.h"
 #include "util/timedcache.h"
 #include "connectdialog.h"
+#include "connect/simdatabuffer.h"
 
 #include <QAbstractSocket>
 #include <QCache>
@@ -87,10 +88,18 @@ public:
   bool isFetchAiShip() const;
   bool isFetchAiAircraft() const;
 
+  /* Ring buffer with the recently received data packets. Allows to poll the latest
+   * sample in place using sequence numbers instead of keeping a copy per consumer. */
+  const SimDataBuffer& getSimDataBuffer() const
+  {
+    return simDataBuffer;
+  }
+
 signals:
   /* Emitted when new data was received from the server (Little Navconnect), SimConnect or X-Plane.
-   * can be aircraft position or weather update */
-  void dataPacketReceived(atools::fs::sc::SimConnectData simConnectData);
+   * can be aircraft position or weather update. The reference points into the ring buffer
+   * and stays valid for the duration of the slot call. */
+  void dataPacketReceived(const atools::fs::sc::SimConnectData& simConnectData);
 
   /* Emitted when a new SimConnect data was received that contains weather data */
   void weatherUpdated();
@@ -123,7 +132,10 @@ private:
   void connectInternalAuto();
   void writeReplyToSocket(atools::fs::sc::SimConnectReply& reply);
   void disconnectClicked();
-  void postSimConnectData(atools::fs::sc::SimConnectData dataPacket);
+  void postSimConnectData(const atools::fs::sc::SimConnectData& dataPacket);
+
+  /* Remove AI vehicles outside of the region of interest around the user aircraft from the packet */
+  void filterAiByRegionOfInterest(atools::fs::sc::SimConnectData& packet);
   void connectedToSimulatorDirect();
   void disconnectedFromSimulatorDirect();
   void autoConnectToggled(bool state);
@@ -152,11 +164,18 @@ private:
   /* Have to keep it since it is read multiple times */
   atools::fs::sc::SimConnectData *simConnectData = nullptr;
 
+  /* Latest packets - consumers read the samples in place */
+  SimDataBuffer simDataBuffer;
+
   QTcpSocket *socket = nullptr;
   /* Used to trigger reconnects on socket base connections */
   QTimer reconnectNetworkTimer, flushQueuedRequestsTimer;
   MainWindow *mainWindow;
   bool verbose = false;
+
+  /* Region of interest radius in meter - AI outside is dropped before the packet is published.
+   * 0 disables the filter. */
+  float aiRadiusMeter = 0.f;
   atools::util::TimedCache<QString, atools::fs::weather::MetarResult> metarIdentCache;
 
   /* Waiting for these replies for airport idents */
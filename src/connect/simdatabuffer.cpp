@@ -0,0 +1,46 @@
+/*****************************************************************************
+* Copyright 2015-2020 Alexander Barthel alex@littlenavmap.org
+*
+* This program is free software: you can redistribute it and/or modify
+* it under the terms of the GNU General Public License as published by
+* the Free Software Foundation, either version 3 of the License, or
+* (at your option) any later version.
+*
+* This program is distributed in the hope that it will be useful,
+* but WITHOUT ANY WARRANTY; without even the implied warranty of
+* MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+* GNU General Public License for more details.
+*
+* You should have received a copy of the GNU General Public License
+* along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*****************************************************************************/
+
+#include "connect/simdatabuffer.h"
+
+SimDataBuffer::SimDataBuffer()
+{
+  slots.resize(BUFFER_SIZE);
+}
+
+atools::fs::sc::SimConnectData& SimDataBuffer::nextSlot()
+{
+  // Sequence is incremented on commit - this addresses the slot after the latest one
+  return slots[static_cast<int>((sequence + 1) % BUFFER_SIZE)];
+}
+
+quint64 SimDataBuffer::commit()
+{
+  return ++sequence;
+}
+
+const atools::fs::sc::SimConnectData& SimDataBuffer::latest() const
+{
+  return slots.at(static_cast<int>(sequence % BUFFER_SIZE));
+}
+
+void SimDataBuffer::clear()
+{
+  for(atools::fs::sc::SimConnectData& data : slots)
+    data = atools::fs::sc::SimConnectData();
+  sequence = 0;
+}
@@ -0,0 +1,71 @@
+/*****************************************************************************
+* Copyright 2015-2020 Alexander Barthel alex@littlenavmap.org
+*
+* This program is free software: you can redistribute it and/or modify
+* it under the terms of the GNU General Public License as published by
+* the Free Software Foundation, either version 3 of the License, or
+* (at your option) any later version.
+*
+* This program is distributed in the hope that it will be useful,
+* but WITHOUT ANY WARRANTY; without even the implied warranty of
+* MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+* GNU General Public License for more details.
+*
+* You should have received a copy of the GNU General Public License
+* along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*****************************************************************************/
+
+#ifndef LITTLENAVMAP_SIMDATABUFFER_H
+#define LITTLENAVMAP_SIMDATABUFFER_H
+
+#include "fs/sc/simconnectdata.h"
+
+#include <QVector>
+
+/*
+ * Ring buffer of SimConnectData packets written by ConnectClient and read in place by
+ * all consumers. Avoids one heap allocated copy per consumer and per packet since the
+ * buffered samples are handed around by reference.
+ *
+ * Each published sample gets a monotonically increasing sequence number which allows
+ * consumers to detect if they missed or already processed a sample.
+ *
+ * Producer and consumers have to live in the GUI thread - no internal locking.
+ */
+class SimDataBuffer
+{
+public:
+  SimDataBuffer();
+
+  /* Slot for the producer to fill in place. Call commit() once the data is complete. */
+  atools::fs::sc::SimConnectData& nextSlot();
+
+  /* Publish the slot returned by nextSlot() and get its sequence number. */
+  quint64 commit();
+
+  /* Latest published sample. Reference remains valid for BUFFER_SIZE - 1 further commits.
+   * Only valid if hasData() is true. */
+  const atools::fs::sc::SimConnectData& latest() const;
+
+  /* Sequence number of the latest published sample. 0 if nothing was published yet. */
+  quint64 latestSequence() const
+  {
+    return sequence;
+  }
+
+  bool hasData() const
+  {
+    return sequence > 0;
+  }
+
+  void clear();
+
+private:
+  /* Number of retained samples. Has to cover all in-flight references of one event loop cycle. */
+  static Q_DECL_CONSTEXPR int BUFFER_SIZE = 8;
+
+  QVector<atools::fs::sc::SimConnectData> slots;
+  quint64 sequence = 0;
+};
+
+#endif // LITTLENAVMAP_SIMDATABUFFER_H
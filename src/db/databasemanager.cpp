@@ -23,6 +23,7 @@
 #include "common/constants.h"
 #include "fs/db/databasemeta.h"
 #include "db/databasedialog.h"
+#include "db/indexadvisor.h"
 #include "settings/settings.h"
 #include "fs/navdatabaseoptions.h"
 #include "fs/navdatabaseprogress.h"
@@ -225,6 +226,7 @@ DatabaseManager::DatabaseManager(MainWindow *parent)
       logdataManager->createSchema();
     else
       logdataManager->updateSchema();
+    createLogbookIndexes();
 
     // Open user airspace database =================================
     openWriteableDatabase(databaseUserAirspace, "userairspace", "userairspace", false /* backup */);
@@ -309,12 +311,29 @@ bool DatabaseManager::checkIncompatibleDatabases(bool *databasesErased)
     SqlDatabase sqlDb(DATABASE_NAME_TEMP);
     QStringList databaseNames, databaseFiles;
 
+    // Databases found compatible on an earlier start - unchanged files skip the
+    // open and schema check below which takes seconds for several simulators
+    Settings& settings = Settings::instance();
+    QStringList validated = settings.valueStrList(lnm::DATABASE_VALIDATED);
+    QStringList stillValidated;
+
     // Collect all incompatible databases
     for(atools::fs::FsPaths::SimulatorType type : simulators.keys())
     {
       QString dbName = buildDatabaseFileName(type);
-      if(QFile::exists(dbName))
+      QFileInfo dbFileinfo(dbName);
+      if(dbFileinfo.exists())
       {
+        QString validationKey = dbName + "|" + QString::number(dbFileinfo.size()) + "|" +
+                                QString::number(dbFileinfo.lastModified().toMSecsSinceEpoch());
+
+        if(validated.contains(validationKey))
+        {
+          // Found compatible earlier and file is unchanged
+          stillValidated.append(validationKey);
+          continue;
+        }
+
         // Database file exists
         sqlDb.setDatabaseName(dbName);
         sqlDb.open();
@@ -330,10 +349,16 @@ bool DatabaseManager::checkIncompatibleDatabases(bool *databasesErased)
           databaseFiles.append(dbName);
           qWarning() << "Incompatible database" << dbName;
         }
+        else
+          // Compatible - remember so the next start can skip the check
+          stillValidated.append(validationKey);
         sqlDb.close();
       }
     }
 
+    // Drop entries of erased, changed or no longer configured databases
+    settings.setValue(lnm::DATABASE_VALIDATED, stillValidated);
+
     // Delete the dummy database without dialog if needed
     QString dummyName = buildDatabaseFileName(atools::fs::FsPaths::UNKNOWN);
     sqlDb.setDatabaseName(dummyName);
@@ -743,8 +768,6 @@ void DatabaseManager::switchNavFromMainMenu()
   // Disconnect all queries
   emit preDatabaseLoad();
 
-  closeAllDatabases();
-
   QString text;
   if(navDbActionAll->isChecked())
   {
@@ -788,9 +811,7 @@ void DatabaseManager::switchSimFromMainMenu()
     // Disconnect all queries
     emit preDatabaseLoad();
 
-    closeAllDatabases();
-
-    // Set new simulator
+    // Set new simulator - only the connections whose file changes are reopened
     currentFsType = action->data().value<atools::fs::FsPaths::SimulatorType>();
     openAllDatabases();
 
@@ -940,13 +961,34 @@ void DatabaseManager::openDatabaseFile(atools::sql::SqlDatabase *db, const QStri
 void DatabaseManager::openDatabaseFileInternal(atools::sql::SqlDatabase *db, const QString& file, bool readonly,
                                                bool createSchema, bool exclusive, bool autoTransactions)
 {
+  if(db->isOpen())
+  {
+    if(db->databaseName() == file && db->isReadonly() == readonly)
+    {
+      // Already open with the same file and mode. Keeping the connection alive preserves the
+      // SQLite page and memory map caches across simulator and navdata mode switches.
+      qDebug() << "Database already open" << file;
+      return;
+    }
+    else
+      // Connection has to point to another file now - all queries were closed by preDatabaseLoad
+      db->close();
+  }
+
   atools::settings::Settings& settings = atools::settings::Settings::instance();
   int databaseCacheKb = settings.getAndStoreValue(lnm::SETTINGS_DATABASE + "CacheKb", 50000).toInt();
+  int databaseMmapMb = settings.getAndStoreValue(lnm::SETTINGS_DATABASE + "MmapSizeMb", 1024).toInt();
+  bool walJournal = settings.getAndStoreValue(lnm::SETTINGS_DATABASE + "WalJournal", false).toBool();
   bool foreignKeys = settings.getAndStoreValue(lnm::SETTINGS_DATABASE + "ForeignKeys", false).toBool();
 
   // cache_size * 1024 bytes if value is negative
   QStringList databasePragmas({QString("PRAGMA cache_size=-%1").arg(databaseCacheKb), "PRAGMA page_size=8196"});
 
+  if(readonly && databaseMmapMb > 0)
+    // Map the scenery and navdata files into memory up to the limit so pages are read
+    // through the OS page cache instead of repeated read calls. Set to 0 to disable.
+    databasePragmas.append(QString("PRAGMA mmap_size=%1").arg(static_cast<qint64>(databaseMmapMb) * 1024L * 1024L));
+
   if(exclusive)
   {
     // Best settings for loading databases accessed write only - unsafe
@@ -958,7 +1000,13 @@ void DatabaseManager::openDatabaseFileInternal(atools::sql::SqlDatabase *db, con
   {
     // Best settings for online and user databases which are updated often - read/write
     databasePragmas.append("PRAGMA locking_mode=NORMAL");
-    databasePragmas.append("PRAGMA journal_mode=DELETE");
+
+    if(walJournal)
+      // Write ahead log keeps readers off the journal lock and batches fsync calls
+      databasePragmas.append("PRAGMA journal_mode=WAL");
+    else
+      databasePragmas.append("PRAGMA journal_mode=DELETE");
+
     databasePragmas.append("PRAGMA synchronous=NORMAL");
   }
 
@@ -1091,6 +1139,38 @@ void DatabaseManager::run()
   saveState();
 }
 
+void DatabaseManager::checkUserDatabaseIndexes()
+{
+  qDebug() << Q_FUNC_INFO;
+
+  IndexAdvisor advisor;
+  advisor.checkDatabase(databaseUser, tr("Userpoints"), IndexAdvisor::userdataStatements());
+  advisor.checkDatabase(databaseLogbook, tr("Logbook"), IndexAdvisor::logbookStatements());
+
+  if(advisor.hasMissingIndexes())
+  {
+    int result = QMessageBox::question(
+      mainWindow, QApplication::applicationName(),
+      tr("The queries below fall back to a full table scan which slows down "
+         "search and map display for large databases:<br/><br/>%1<br/><br/>"
+         "This can happen after importing into a database created by an older program version."
+         "<br/><br/>Create the missing indexes now?").arg(advisor.getReport().join("<br/>")),
+      QMessageBox::Yes | QMessageBox::No, QMessageBox::Yes);
+
+    if(result == QMessageBox::Yes)
+    {
+      QGuiApplication::setOverrideCursor(Qt::WaitCursor);
+      advisor.createMissingIndexes();
+      QGuiApplication::restoreOverrideCursor();
+
+      mainWindow->setStatusMessage(tr("Database indexes created."));
+    }
+  }
+  else
+    QMessageBox::information(mainWindow, QApplication::applicationName(),
+                             tr("All checked queries on the userpoint and logbook databases use indexes."));
+}
+
 /* Shows scenery database loading dialog.
  * @return true if execution was successfull. false if it was cancelled */
 bool DatabaseManager::runInternal()
@@ -1413,6 +1493,24 @@ void DatabaseManager::simulatorChangedFromComboBox(FsPaths::SimulatorType value)
   updateDialogInfo(selectedFsType);
 }
 
+QString DatabaseManager::formatElapsedThroughput(const atools::fs::NavDatabaseProgress& progress,
+                                                 const QElapsedTimer& timer)
+{
+  QString text = formatter::formatElapsed(timer);
+
+  qint64 seconds = timer.elapsed() / 1000L;
+  if(seconds > 0)
+  {
+    // Sum up all object counters to get an overall rows per second indication
+    qint64 objects = progress.getNumAirports() + progress.getNumVors() + progress.getNumIls() +
+                     progress.getNumNdbs() + progress.getNumMarker() + progress.getNumWaypoints() +
+                     progress.getNumBoundaries();
+    text.append(tr(" (%L1 files/s, %L2 objects/s)").
+                arg(progress.getNumFiles() / seconds).arg(objects / seconds));
+  }
+  return text;
+}
+
 /* Called by atools::fs::NavDatabase. Updates progress bar and statistics */
 bool DatabaseManager::progressCallback(const atools::fs::NavDatabaseProgress& progress, QElapsedTimer& timer)
 {
@@ -1438,7 +1536,7 @@ bool DatabaseManager::progressCallback(const atools::fs::NavDatabaseProgress& pr
       // Run script etc.
       progressDialog->setLabelText(
         databaseTimeText.arg(atools::elideTextShortMiddle(progress.getOtherAction(), MAX_TEXT_LENGTH)).
-        arg(formatter::formatElapsed(timer)).
+        arg(formatElapsedThroughput(progress, timer)).
         arg(QString()).
         arg(QString()).
         arg(progress.getNumErrors()).
@@ -1460,7 +1558,7 @@ bool DatabaseManager::progressCallback(const atools::fs::NavDatabaseProgress& pr
         databaseLoadingText.arg(atools::elideTextShortMiddle(progress.getSceneryTitle(), MAX_TEXT_LENGTH)).
         arg(atools::elideTextShortMiddle(progress.getSceneryPath(), MAX_TEXT_LENGTH)).
         arg(atools::elideTextShortMiddle(progress.getBglFileName(), MAX_TEXT_LENGTH)).
-        arg(formatter::formatElapsed(timer)).
+        arg(formatElapsedThroughput(progress, timer)).
         arg(progress.getNumErrors()).
         arg(progress.getNumFiles()).
         arg(progress.getNumAirports()).
@@ -1479,7 +1577,7 @@ bool DatabaseManager::progressCallback(const atools::fs::NavDatabaseProgress& pr
       // Last report
       progressDialog->setLabelText(
         databaseTimeText.arg(tr("<big>Done.</big>")).
-        arg(formatter::formatElapsed(timer)).
+        arg(formatElapsedThroughput(progress, timer)).
         arg(QString()).
         arg(QString()).
         arg(progress.getNumErrors()).
@@ -1575,6 +1673,31 @@ void DatabaseManager::createEmptySchema(atools::sql::SqlDatabase *db, bool bound
   }
 }
 
+void DatabaseManager::createLogbookIndexes()
+{
+  try
+  {
+    // The schema created by the atools manager has no indexes for the search columns.
+    // The logbook view sorts by departure time by default and the ident filters are case
+    // insensitive prefix matches which can use the nocase indexes. Without them every
+    // keystroke in the search filters scans and sorts the whole table.
+    SqlTransaction transaction(databaseLogbook);
+    SqlQuery query(databaseLogbook);
+    query.exec("create index if not exists idx_logbook_departure_time on logbook(departure_time)");
+    query.exec("create index if not exists idx_logbook_departure_ident on logbook(departure_ident collate nocase)");
+    query.exec("create index if not exists idx_logbook_destination_ident on logbook(destination_ident collate nocase)");
+    transaction.commit();
+  }
+  catch(atools::Exception& e)
+  {
+    ATOOLS_HANDLE_EXCEPTION(e);
+  }
+  catch(...)
+  {
+    ATOOLS_HANDLE_UNKNOWN_EXCEPTION;
+  }
+}
+
 bool DatabaseManager::hasInstalledSimulators() const
 {
   return !simulators.getAllInstalled().isEmpty();
@@ -82,6 +82,11 @@ public:
   /* Opens the dialog that allows to (re)load a new scenery database. */
   void run();
 
+  /* Run "explain query plan" for the representative statement set of each query class against
+   * the userpoint and logbook databases, flag full table scans and offer to create the missing
+   * indexes. Called from the scenery library menu. */
+  void checkUserDatabaseIndexes();
+
   /* Save and restore all paths and current simulator settings */
   void saveState();
 
@@ -204,6 +209,9 @@ public:
   /* Create an empty database schema. Boundary option does not use transaction. */
   void createEmptySchema(atools::sql::SqlDatabase *db, bool boundary = false);
 
+  /* Add missing indexes for the logbook search to the logbook database */
+  void createLogbookIndexes();
+
 signals:
   /* Emitted before opening the scenery database dialog, loading a database or switching to a new simulator database.
    * Recipients have to close all database connections and clear all caches. The database instance itself is not changed
@@ -233,6 +241,9 @@ private:
 
   bool progressCallback(const atools::fs::NavDatabaseProgress& progress, QElapsedTimer& timer);
 
+  /* Elapsed time plus aggregate compile throughput (files and objects per second) for the progress dialog */
+  QString formatElapsedThroughput(const atools::fs::NavDatabaseProgress& progress, const QElapsedTimer& timer);
+
   void simulatorChangedFromComboBox(atools::fs::FsPaths::SimulatorType value);
   bool runInternal();
   void updateDialogInfo(atools::fs::FsPaths::SimulatorType value);
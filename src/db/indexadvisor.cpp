@@ -0,0 +1,153 @@
+/*****************************************************************************
+* Copyright 2015-2020 Alexander Barthel alex@littlenavmap.org
+*
+* This program is free software: you can redistribute it and/or modify
+* it under the terms of the GNU General Public License as published by
+* the Free Software Foundation, either version 3 of the License, or
+* (at your option) any later version.
+*
+* This program is distributed in the hope that it will be useful,
+* but WITHOUT ANY WARRANTY; without even the implied warranty of
+* MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+* GNU General Public License for more details.
+*
+* You should have received a copy of the GNU General Public License
+* along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*****************************************************************************/
+
+#include "db/indexadvisor.h"
+
+#include "exception.h"
+#include "sql/sqldatabase.h"
+#include "sql/sqlquery.h"
+#include "sql/sqltransaction.h"
+
+#include <QDebug>
+#include <QSet>
+
+using atools::sql::SqlDatabase;
+using atools::sql::SqlQuery;
+using atools::sql::SqlTransaction;
+
+const QVector<IndexAdvisor::Statement>& IndexAdvisor::userdataStatements()
+{
+  // Statements mirror the filters built by the userpoint search table: the line edit filters
+  // are case insensitive "like" prefix matches which SQLite can only serve from an index
+  // declared with the nocase collation. "like" filters with a leading wildcard cannot use
+  // an index and are not checked.
+  const static QVector<Statement> STATEMENTS(
+  {
+    {QObject::tr("Userpoint search by ident"),
+     "select userdata_id from userdata where ident like 'AB%'",
+     "create index if not exists idx_userdata_ident on userdata(ident collate nocase)"},
+    {QObject::tr("Userpoint search by type"),
+     "select userdata_id from userdata where type like 'VRP%'",
+     "create index if not exists idx_userdata_type on userdata(type collate nocase)"},
+    {QObject::tr("Userpoint search by name"),
+     "select userdata_id from userdata where name like 'Test%'",
+     "create index if not exists idx_userdata_name on userdata(name collate nocase)"},
+    {QObject::tr("Userpoint search by tags"),
+     "select userdata_id from userdata where tags like 'Test%'",
+     "create index if not exists idx_userdata_tags on userdata(tags collate nocase)"},
+    {QObject::tr("Userpoint distance search"),
+     "select userdata_id from userdata where lonx between 0 and 1 and laty between 0 and 1",
+     "create index if not exists idx_userdata_lonx_laty on userdata(lonx, laty)"}
+  });
+
+  return STATEMENTS;
+}
+
+const QVector<IndexAdvisor::Statement>& IndexAdvisor::logbookStatements()
+{
+  // The ident and time definitions have to stay identical to the ones in
+  // DatabaseManager::createLogbookIndexes() - "create index if not exists" goes by name only
+  // and would silently skip a differing definition
+  const static QVector<Statement> STATEMENTS(
+  {
+    {QObject::tr("Logbook search by departure"),
+     "select logbook_id from logbook where departure_ident like 'EDDF%'",
+     "create index if not exists idx_logbook_departure_ident on logbook(departure_ident collate nocase)"},
+    {QObject::tr("Logbook search by destination"),
+     "select logbook_id from logbook where destination_ident like 'EDDF%'",
+     "create index if not exists idx_logbook_destination_ident on logbook(destination_ident collate nocase)"},
+    {QObject::tr("Logbook search by aircraft registration"),
+     "select logbook_id from logbook where aircraft_registration like 'DEABC%'",
+     "create index if not exists idx_logbook_aircraft_registration on logbook(aircraft_registration collate nocase)"},
+    {QObject::tr("Logbook search by simulator"),
+     "select logbook_id from logbook where simulator like 'XP11%'",
+     "create index if not exists idx_logbook_simulator on logbook(simulator collate nocase)"},
+    {QObject::tr("Logbook search by departure time"),
+     "select logbook_id from logbook where departure_time between 0 and 1",
+     "create index if not exists idx_logbook_departure_time on logbook(departure_time)"}
+  });
+
+  return STATEMENTS;
+}
+
+void IndexAdvisor::checkDatabase(SqlDatabase *db, const QString& databaseName,
+                                 const QVector<Statement>& statements)
+{
+  if(db == nullptr || !db->isOpen())
+  {
+    qWarning() << Q_FUNC_INFO << databaseName << "database not open";
+    return;
+  }
+
+  for(const Statement& statement : statements)
+  {
+    try
+    {
+      SqlQuery query(db);
+      query.exec("explain query plan " + statement.query);
+
+      bool scan = false;
+      while(query.next())
+      {
+        // The detail column reads "SCAN TABLE userdata" or "SCAN userdata" depending on the
+        // SQLite version. Scans over a covering index mention the index and are fine.
+        QString detail = query.valueStr("detail");
+        qDebug() << Q_FUNC_INFO << databaseName << statement.query << "plan" << detail;
+
+        if(detail.startsWith("SCAN") && !detail.contains("INDEX"))
+          scan = true;
+      }
+
+      if(scan)
+      {
+        qWarning() << Q_FUNC_INFO << "Full table scan for" << statement.query
+                   << "- suggesting" << statement.createIndex;
+        report.append(QObject::tr("%1 (%2)").arg(statement.description).arg(databaseName));
+        missing.append({db, statement.createIndex});
+      }
+    }
+    catch(atools::Exception& e)
+    {
+      // A statement can fail on old schemas missing a column - not an indexing problem
+      qWarning() << Q_FUNC_INFO << "Error checking" << statement.query << e.what();
+    }
+  }
+}
+
+void IndexAdvisor::createMissingIndexes()
+{
+  QSet<SqlDatabase *> changed;
+
+  for(const Missing& entry : missing)
+  {
+    qInfo() << Q_FUNC_INFO << entry.createIndex;
+
+    SqlTransaction transaction(entry.db);
+    SqlQuery query(entry.db);
+    query.exec(entry.createIndex);
+    transaction.commit();
+
+    changed.insert(entry.db);
+  }
+
+  // Refresh the optimizer statistics so the new indexes are picked up
+  for(SqlDatabase *db : changed)
+    db->analyze();
+
+  missing.clear();
+  report.clear();
+}
@@ -0,0 +1,83 @@
+/*****************************************************************************
+* Copyright 2015-2020 Alexander Barthel alex@littlenavmap.org
+*
+* This program is free software: you can redistribute it and/or modify
+* it under the terms of the GNU General Public License as published by
+* the Free Software Foundation, either version 3 of the License, or
+* (at your option) any later version.
+*
+* This program is distributed in the hope that it will be useful,
+* but WITHOUT ANY WARRANTY; without even the implied warranty of
+* MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+* GNU General Public License for more details.
+*
+* You should have received a copy of the GNU General Public License
+* along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*****************************************************************************/
+
+#ifndef LITTLENAVMAP_INDEXADVISOR_H
+#define LITTLENAVMAP_INDEXADVISOR_H
+
+#include <QStringList>
+#include <QVector>
+
+namespace atools {
+namespace sql {
+class SqlDatabase;
+}
+}
+
+/*
+ * Diagnoses the index usage of the user writable databases. Runs "explain query plan" for a
+ * representative statement set of each query class, flags statements which fall back to a full
+ * table scan - typically after imports into a database created by an older version - and can
+ * create the missing indexes covering them.
+ */
+class IndexAdvisor
+{
+public:
+  /* One representative statement of a query class together with the index covering it */
+  struct Statement
+  {
+    QString description; /* Short text for the report shown to the user */
+    QString query; /* Statement as built by the query class with literal example values */
+    QString createIndex; /* "create index if not exists" statement covering the query */
+  };
+
+  /* Run "explain query plan" for all statements against the open database and remember full
+   * table scans. Can be called for several databases - the results accumulate. */
+  void checkDatabase(atools::sql::SqlDatabase *db, const QString& databaseName,
+                     const QVector<Statement>& statements);
+
+  /* Create all indexes flagged by checkDatabase and update the optimizer statistics of the
+   * affected databases */
+  void createMissingIndexes();
+
+  /* One line per flagged statement like "Userpoint search by ident (Userpoints)" */
+  const QStringList& getReport() const
+  {
+    return report;
+  }
+
+  bool hasMissingIndexes() const
+  {
+    return !missing.isEmpty();
+  }
+
+  /* Representative statement sets for the user writable databases */
+  static const QVector<Statement>& userdataStatements();
+  static const QVector<Statement>& logbookStatements();
+
+private:
+  /* Index creation flagged for one database */
+  struct Missing
+  {
+    atools::sql::SqlDatabase *db;
+    QString createIndex;
+  };
+
+  QVector<Missing> missing;
+  QStringList report;
+};
+
+#endif // LITTLENAVMAP_INDEXADVISOR_H
@@ -175,21 +175,27 @@ int CsvExporter::selectionAsCsv(QTableView *view, bool header, bool rows, QStrin
     {
       // Copy full rows
       QTextStream stream(&result, QIODevice::WriteOnly);
-      QHeaderView *headerView = view->horizontalHeader();
       if(header)
         stream << buildHeader(view, exporter, additionalHeader, additionalFields) << endl;
 
+      // Resolve the visible columns to model indexes once for all rows
+      QVector<int> exportColumns = visibleColumns(view);
+      bool additional = !additionalHeader.isEmpty() && additionalFields;
+
+      QVariantList vars;
+      vars.reserve(exportColumns.size());
       for(QItemSelectionRange rng : selection->selection())
       {
         // Add data
         for(int row = rng.top(); row <= rng.bottom(); ++row)
         {
-          QVariantList vars;
-          for(int i = 0; i < model->columnCount(); i++)
-            if(!view->isColumnHidden(i))
-              vars.append(model->data(model->index(row, headerView->logicalIndex(i))));
-          stream << exporter.getResultSetRow(vars) +
-          (additionalHeader.isEmpty() || !additionalFields ? QString() : ";" + additionalFields(row).join(";")) << endl;
+          vars.clear();
+          for(int logicalIndex : exportColumns)
+            vars.append(model->data(model->index(row, logicalIndex)));
+          stream << exporter.getResultSetRow(vars);
+          if(additional)
+            stream << ";" << additionalFields(row).join(";");
+          stream << endl;
 
           exported++;
         }
@@ -225,18 +231,24 @@ int CsvExporter::tableAsCsv(QTableView *view, bool header, QString& result,
 
   // Copy full rows
   QTextStream stream(&result, QIODevice::WriteOnly);
-  QHeaderView *headerView = view->horizontalHeader();
   if(header)
     stream << buildHeader(view, exporter, additionalHeader, additionalFields) << endl;
 
+  // Resolve the visible columns to model indexes once for all rows
+  QVector<int> exportColumns = visibleColumns(view);
+  bool additional = !additionalHeader.isEmpty() && additionalFields;
+
+  QVariantList vars;
+  vars.reserve(exportColumns.size());
   for(int row = 0; row < model->rowCount(); row++)
   {
-    QVariantList vars;
-    for(int i = 0; i < model->columnCount(); i++)
-      if(!view->isColumnHidden(i))
-        vars.append(model->data(model->index(row, headerView->logicalIndex(i))));
-    stream << exporter.getResultSetRow(vars) +
-    (additionalHeader.isEmpty() || !additionalFields ? QString() : ";" + additionalFields(row).join(";")) << endl;
+    vars.clear();
+    for(int logicalIndex : exportColumns)
+      vars.append(model->data(model->index(row, logicalIndex)));
+    stream << exporter.getResultSetRow(vars);
+    if(additional)
+      stream << ";" << additionalFields(row).join(";");
+    stream << endl;
 
     exported++;
   }
@@ -244,6 +256,16 @@ int CsvExporter::tableAsCsv(QTableView *view, bool header, QString& result,
   return exported;
 }
 
+QVector<int> CsvExporter::visibleColumns(QTableView *view)
+{
+  QHeaderView *headerView = view->horizontalHeader();
+  QVector<int> columns;
+  for(int i = 0; i < view->model()->columnCount(); i++)
+    if(!view->isColumnHidden(i))
+      columns.append(headerView->logicalIndex(i));
+  return columns;
+}
+
 QString CsvExporter::buildHeader(QTableView *view, atools::sql::SqlExport& exporter,
                                  const QStringList& additionalHeader,
                                  std::function<QStringList(int index)> additionalFields)
@@ -82,6 +82,10 @@ private:
   static QString buildHeader(QTableView *view, atools::sql::SqlExport& exporter,
                              const QStringList& additionalHeader, std::function<QStringList(int)> additionalFields);
 
+  /* Model indexes of the visible view columns in view order. Resolved once per export
+   * instead of once per cell. */
+  static QVector<int> visibleColumns(QTableView *view);
+
   /* Get file from save dialog */
   QString saveCsvFileDialog();
 
@@ -18,6 +18,8 @@
 #include "gui/mainwindow.h"
 
 #include "common/constants.h"
+#include "common/idlescheduler.h"
+#include "common/perftrace.h"
 #include "common/proctypes.h"
 #include "navapp.h"
 #include "atools.h"
@@ -44,6 +46,7 @@
 #include "query/airportquery.h"
 #include "mapgui/mapwidget.h"
 #include "mapgui/aprongeometrycache.h"
+#include "common/aircrafttrack.h"
 #include "profile/profilewidget.h"
 #include "route/routecontroller.h"
 #include "gui/filehistoryhandler.h"
@@ -79,6 +82,7 @@
 #include "search/logdatasearch.h"
 #include "airspace/airspacecontroller.h"
 #include "mapgui/mapmarkhandler.h"
+#include "mapgui/mapviewwindow.h"
 #include "gui/choicedialog.h"
 #include "gui/dockwidgethandler.h"
 #include "track/trackcontroller.h"
@@ -91,6 +95,7 @@
 
 #include <QDebug>
 #include <QCloseEvent>
+#include <QElapsedTimer>
 #include <QDesktopServices>
 #include <QFileInfo>
 #include <QScreen>
@@ -102,6 +107,7 @@
 #include <QEvent>
 #include <QMimeData>
 #include <QClipboard>
+#include <QPainter>
 #include <QProgressDialog>
 #include <QThread>
 
@@ -111,6 +117,10 @@ static const int WEATHER_UPDATE_MS = 15000;
 
 static const int MAX_STATUS_MESSAGES = 10;
 
+/* Strip height for rendering map image exports. Keeps the progress dialog
+ * responsive and allows canceling high resolution exports. */
+static const int IMAGE_EXPORT_STRIP_HEIGHT = 1024;
+
 using namespace Marble;
 using atools::settings::Settings;
 using atools::gui::FileHistoryHandler;
@@ -122,6 +132,11 @@ MainWindow::MainWindow()
 {
   qDebug() << Q_FUNC_INFO << "constructor";
 
+  // Startup timeline - each phase marker below logs the total time spent in the constructor
+  // so far. Used to track startup time regressions across releases.
+  QElapsedTimer startupTimer;
+  startupTimer.start();
+
   aboutMessage =
     QObject::tr("<p>is a free open source flight planner, navigation tool, moving map, "
                   "airport search and airport information system for X-Plane 11, Flight Simulator X and Prepar3D.</p>"
@@ -193,7 +208,7 @@ MainWindow::MainWindow()
 
     routeExport = new RouteExport(this);
 
-    qDebug() << Q_FUNC_INFO << "Creating OptionsDialog";
+    qDebug() << Q_FUNC_INFO << "Creating OptionsDialog" << "after" << startupTimer.elapsed() << "ms";
     optionsDialog = new OptionsDialog(this);
     // Has to load the state now so options are available for all controller and manager classes
     optionsDialog->restoreState();
@@ -230,7 +245,7 @@ MainWindow::MainWindow()
     mainWindowTitle = windowTitle();
 
     // Prepare database and queries
-    qDebug() << Q_FUNC_INFO << "Creating DatabaseManager";
+    qDebug() << Q_FUNC_INFO << "Creating DatabaseManager" << "after" << startupTimer.elapsed() << "ms";
 
     NavApp::init(this);
 
@@ -241,30 +256,30 @@ MainWindow::MainWindow()
     // Add actions for flight simulator database switch in main menu
     NavApp::getDatabaseManager()->insertSimSwitchActions();
 
-    qDebug() << Q_FUNC_INFO << "Creating WeatherReporter";
+    qDebug() << Q_FUNC_INFO << "Creating WeatherReporter" << "after" << startupTimer.elapsed() << "ms";
     weatherReporter = new WeatherReporter(this, NavApp::getCurrentSimulatorDb());
 
-    qDebug() << Q_FUNC_INFO << "Creating WindReporter";
+    qDebug() << Q_FUNC_INFO << "Creating WindReporter" << "after" << startupTimer.elapsed() << "ms";
     windReporter = new WindReporter(this, NavApp::getCurrentSimulatorDb());
     windReporter->addToolbarButton();
 
-    qDebug() << Q_FUNC_INFO << "Creating FileHistoryHandler for flight plans";
+    qDebug() << Q_FUNC_INFO << "Creating FileHistoryHandler for flight plans" << "after" << startupTimer.elapsed() << "ms";
     routeFileHistory = new FileHistoryHandler(this, lnm::ROUTE_FILENAMES_RECENT, ui->menuRecentRoutes,
                                               ui->actionRecentRoutesClear);
 
-    qDebug() << Q_FUNC_INFO << "Creating RouteController";
+    qDebug() << Q_FUNC_INFO << "Creating RouteController" << "after" << startupTimer.elapsed() << "ms";
     routeController = new RouteController(this, ui->tableViewRoute);
 
-    qDebug() << Q_FUNC_INFO << "Creating FileHistoryHandler for KML files";
+    qDebug() << Q_FUNC_INFO << "Creating FileHistoryHandler for KML files" << "after" << startupTimer.elapsed() << "ms";
     kmlFileHistory = new FileHistoryHandler(this, lnm::ROUTE_FILENAMESKML_RECENT, ui->menuRecentKml,
                                             ui->actionClearKmlMenu);
 
-    qDebug() << Q_FUNC_INFO << "Creating FileHistoryHandler for layout files";
+    qDebug() << Q_FUNC_INFO << "Creating FileHistoryHandler for layout files" << "after" << startupTimer.elapsed() << "ms";
     layoutFileHistory = new FileHistoryHandler(this, lnm::LAYOUT_RECENT, ui->menuWindowLayoutRecent,
                                                ui->actionWindowLayoutClearRecent);
 
     // Create map widget and replace dummy widget in window
-    qDebug() << Q_FUNC_INFO << "Creating MapWidget";
+    qDebug() << Q_FUNC_INFO << "Creating MapWidget" << "after" << startupTimer.elapsed() << "ms";
     mapWidget = new MapWidget(this);
     if(OptionData::instance().getFlags2() & opts2::MAP_ALLOW_UNDOCK)
     {
@@ -277,16 +292,27 @@ MainWindow::MainWindow()
       ui->dockWidgetMap->hide();
     }
 
+    // Create the additional map window sharing queries, caches and the simulator
+    // connection with the main map and its menu action ==========================
+    mapViewWindow = new MapViewWindow(this);
+    actionMapViewWindow = new QAction(tr("Show Additional Map &View"), ui->menuView);
+    actionMapViewWindow->setToolTip(tr("Show an additional top level map window for a second display"));
+    actionMapViewWindow->setStatusTip(actionMapViewWindow->toolTip());
+    actionMapViewWindow->setCheckable(true);
+    ui->menuView->insertAction(ui->actionShowFloatingWindows, actionMapViewWindow);
+    connect(actionMapViewWindow, &QAction::toggled, this, &MainWindow::mapViewWindowToggled);
+    connect(mapViewWindow, &MapViewWindow::windowHidden, this, &MainWindow::mapViewWindowHidden);
+
     NavApp::initElevationProvider();
 
     // Create elevation profile widget and replace dummy widget in window
-    qDebug() << Q_FUNC_INFO << "Creating ProfileWidget";
+    qDebug() << Q_FUNC_INFO << "Creating ProfileWidget" << "after" << startupTimer.elapsed() << "ms";
     profileWidget = new ProfileWidget(ui->scrollAreaProfile->viewport());
     ui->scrollAreaProfile->setWidget(profileWidget);
     profileWidget->show();
 
     // Have to create searches in the same order as the tabs
-    qDebug() << Q_FUNC_INFO << "Creating SearchController";
+    qDebug() << Q_FUNC_INFO << "Creating SearchController" << "after" << startupTimer.elapsed() << "ms";
     searchController = new SearchController(this, ui->tabWidgetSearch);
     searchController->createAirportSearch(ui->tableViewAirportSearch);
     searchController->createNavSearch(ui->tableViewNavSearch);
@@ -300,15 +326,15 @@ MainWindow::MainWindow()
     searchController->createOnlineCenterSearch(ui->tableViewOnlineCenterSearch);
     searchController->createOnlineServerSearch(ui->tableViewOnlineServerSearch);
 
-    qDebug() << Q_FUNC_INFO << "Creating InfoController";
+    qDebug() << Q_FUNC_INFO << "Creating InfoController" << "after" << startupTimer.elapsed() << "ms";
     infoController = new InfoController(this);
 
-    qDebug() << Q_FUNC_INFO << "Creating PrintSupport";
+    qDebug() << Q_FUNC_INFO << "Creating PrintSupport" << "after" << startupTimer.elapsed() << "ms";
     printSupport = new PrintSupport(this);
 
     setStatusMessage(tr("Started."));
 
-    qDebug() << Q_FUNC_INFO << "Connecting slots";
+    qDebug() << Q_FUNC_INFO << "Connecting slots" << "after" << startupTimer.elapsed() << "ms";
     connectAllSlots();
     NavApp::getAircraftPerfController()->connectAllSlots();
 
@@ -319,7 +345,7 @@ MainWindow::MainWindow()
     // Add user defined points toolbar button and submenu items
     NavApp::getUserdataController()->addToolbarButton();
 
-    qDebug() << Q_FUNC_INFO << "Reading settings";
+    qDebug() << Q_FUNC_INFO << "Reading settings" << "after" << startupTimer.elapsed() << "ms";
     restoreStateMain();
 
     allowDockingWindows();
@@ -330,10 +356,10 @@ MainWindow::MainWindow()
     NavApp::getAirspaceController()->updateButtonsAndActions();
     updateOnlineActionStates();
 
-    qDebug() << Q_FUNC_INFO << "Setting theme";
+    qDebug() << Q_FUNC_INFO << "Setting theme" << "after" << startupTimer.elapsed() << "ms";
     changeMapTheme();
 
-    qDebug() << Q_FUNC_INFO << "Setting projection";
+    qDebug() << Q_FUNC_INFO << "Setting projection" << "after" << startupTimer.elapsed() << "ms";
     mapWidget->setProjection(mapProjectionComboBox->currentData().toInt());
 
     // Wait until everything is set up and update map
@@ -355,7 +381,11 @@ MainWindow::MainWindow()
     renderStatusTimer.setSingleShot(true);
     connect(&renderStatusTimer, &QTimer::timeout, this, &MainWindow::renderStatusReset);
 
-    qDebug() << Q_FUNC_INFO << "Constructor done";
+    // Warm up caches for the arrival when the user is not interacting =====================
+    idleScheduler = new IdleScheduler(this, 30 /* seconds without user input */);
+    connect(idleScheduler, &IdleScheduler::idle, this, &MainWindow::warmupCachesOnIdle);
+
+    qInfo() << Q_FUNC_INFO << "Constructor done after" << startupTimer.elapsed() << "ms";
   }
   // Exit application if something goes wrong
   catch(atools::Exception& e)
@@ -383,15 +413,25 @@ MainWindow::MainWindow()
   QAction *debugAction4 = new QAction("DEBUG - Reload flight plan");
   this->addAction(debugAction4);
 
+  QAction *debugAction5 = new QAction("DEBUG - Dump Cache Sizes");
+  this->addAction(debugAction5);
+
+  QAction *debugAction6 = new QAction("DEBUG - Save Performance Trace");
+  this->addAction(debugAction6);
+
   ui->menuHelp->addSeparator();
   ui->menuHelp->addAction(debugAction1);
   ui->menuHelp->addAction(debugAction2);
   ui->menuHelp->addAction(debugAction3);
   ui->menuHelp->addAction(debugAction4);
+  ui->menuHelp->addAction(debugAction5);
+  ui->menuHelp->addAction(debugAction6);
   connect(debugAction1, &QAction::triggered, this, &MainWindow::debugActionTriggered1);
   connect(debugAction2, &QAction::triggered, this, &MainWindow::debugActionTriggered2);
   connect(debugAction3, &QAction::triggered, this, &MainWindow::debugActionTriggered3);
   connect(debugAction4, &QAction::triggered, this, &MainWindow::debugActionTriggered4);
+  connect(debugAction5, &QAction::triggered, this, &MainWindow::debugActionTriggered5);
+  connect(debugAction6, &QAction::triggered, this, &MainWindow::debugActionTriggered6);
 
 #endif
 
@@ -401,6 +441,14 @@ MainWindow::~MainWindow()
 {
   qDebug() << Q_FUNC_INFO;
 
+  if(perftrace::isEnabled())
+  {
+    // Write the collected spans like the render statistics on shutdown
+    QString traceFile = perftrace::save();
+    if(!traceFile.isEmpty())
+      qDebug() << Q_FUNC_INFO << "Performance trace written to" << traceFile;
+  }
+
   clockTimer.stop();
 
   NavApp::setShuttingDown(true);
@@ -516,6 +564,35 @@ void MainWindow::debugActionTriggered4()
   routeController->loadFlightplan(file);
 }
 
+void MainWindow::debugActionTriggered5()
+{
+  qDebug() << "======================================================================================";
+  qDebug() << Q_FUNC_INFO;
+
+  const AircraftTrack& track = mapWidget->getAircraftTrack();
+  qDebug() << "Aircraft track" << track.size() << "points"
+           << track.size() * static_cast<int>(sizeof(at::AircraftTrackPos)) << "bytes";
+
+  qDebug() << "Apron geometry cache" << mapWidget->getApronGeometryCache()->getCacheSizeBytes() << "bytes";
+
+  const QList<atools::fs::sc::SimConnectAircraft> *onlineAircraft =
+    NavApp::getOnlinedataController()->getAircraftFromCache();
+  qDebug() << "Online aircraft cache" << (onlineAircraft != nullptr ? onlineAircraft->size() : 0) << "aircraft";
+
+  qDebug() << "Marble volatile tile cache limit" << mapWidget->volatileTileCacheLimit() << "kB"
+           << "persistent tile cache limit" << mapWidget->model()->persistentTileCacheLimit() << "kB";
+  qDebug() << "======================================================================================";
+}
+
+void MainWindow::debugActionTriggered6()
+{
+  QString filename = perftrace::save();
+  if(filename.isEmpty())
+    qDebug() << Q_FUNC_INFO << "No trace events collected - enable with" << lnm::OPTIONS_PERF_TRACE;
+  else
+    qDebug() << Q_FUNC_INFO << "Performance trace written to" << filename;
+}
+
 #endif
 
 void MainWindow::updateMap() const
@@ -930,6 +1007,7 @@ void MainWindow::connectAllSlots()
   connect(optionsDialog, &OptionsDialog::optionsChanged, routeController, &RouteController::optionsChanged);
   connect(optionsDialog, &OptionsDialog::optionsChanged, infoController, &InfoController::optionsChanged);
   connect(optionsDialog, &OptionsDialog::optionsChanged, mapWidget, &MapPaintWidget::optionsChanged);
+  connect(optionsDialog, &OptionsDialog::optionsChanged, mapViewWindow, &MapViewWindow::optionsChanged);
   connect(optionsDialog, &OptionsDialog::optionsChanged, profileWidget, &ProfileWidget::optionsChanged);
   connect(optionsDialog, &OptionsDialog::optionsChanged,
           NavApp::getOnlinedataController(), &OnlinedataController::optionsChanged);
@@ -952,10 +1030,10 @@ void MainWindow::connectAllSlots()
   connect(NavApp::getStyleHandler(), &StyleHandler::preStyleChange, this, &MainWindow::saveStateNow);
 
   connect(NavApp::getStyleHandler(), &StyleHandler::styleChanged, mapcolors::styleChanged);
-  connect(NavApp::getStyleHandler(), &StyleHandler::styleChanged, infoController, &InfoController::optionsChanged);
   connect(NavApp::getStyleHandler(), &StyleHandler::styleChanged, routeController, &RouteController::styleChanged);
   connect(NavApp::getStyleHandler(), &StyleHandler::styleChanged, searchController, &SearchController::styleChanged);
   connect(NavApp::getStyleHandler(), &StyleHandler::styleChanged, mapWidget, &MapPaintWidget::styleChanged);
+  connect(NavApp::getStyleHandler(), &StyleHandler::styleChanged, mapViewWindow, &MapViewWindow::styleChanged);
   connect(NavApp::getStyleHandler(), &StyleHandler::styleChanged, profileWidget, &ProfileWidget::styleChanged);
   connect(NavApp::getStyleHandler(), &StyleHandler::styleChanged,
           NavApp::getAircraftPerfController(), &AircraftPerfController::optionsChanged);
@@ -968,6 +1046,9 @@ void MainWindow::connectAllSlots()
   // Wind has to be calculated first - receive routeChanged signal first
   connect(routeController, &RouteController::routeChanged, windReporter, &WindReporter::updateManualRouteWinds);
   connect(routeController, &RouteController::routeChanged, windReporter, &WindReporter::updateToolButtonState);
+
+  // Prefetch weather reports for the flight plan airports
+  connect(routeController, &RouteController::routeChanged, weatherReporter, &WeatherReporter::preloadRouteWeather);
   connect(perfController, &AircraftPerfController::aircraftPerformanceChanged,
           windReporter, &WindReporter::updateToolButtonState);
 
@@ -1184,6 +1265,14 @@ void MainWindow::connectAllSlots()
   connect(ui->actionReloadScenery, &QAction::triggered, NavApp::getDatabaseManager(), &DatabaseManager::run);
   connect(ui->actionDatabaseFiles, &QAction::triggered, this, &MainWindow::showDatabaseFiles);
 
+  // Database index health check - action created in code
+  QAction *actionDatabaseCheckIndexes = new QAction(tr("Check Database &Indexes"), ui->menuDatabase);
+  actionDatabaseCheckIndexes->setToolTip(tr("Check the userpoint and logbook databases for missing indexes"));
+  actionDatabaseCheckIndexes->setStatusTip(actionDatabaseCheckIndexes->toolTip());
+  ui->menuDatabase->addAction(actionDatabaseCheckIndexes);
+  connect(actionDatabaseCheckIndexes, &QAction::triggered,
+          NavApp::getDatabaseManager(), &DatabaseManager::checkUserDatabaseIndexes);
+
   connect(ui->actionOptions, &QAction::triggered, optionsDialog, &QDialog::open);
   connect(ui->actionResetMessages, &QAction::triggered, this, &MainWindow::resetMessages);
   connect(ui->actionSaveAllNow, &QAction::triggered, this, &MainWindow::saveStateNow);
@@ -1406,6 +1495,7 @@ void MainWindow::connectAllSlots()
   connect(ui->actionRouteDownloadTracks, &QAction::toggled, trackController, &TrackController::downloadToggled);
   connect(ui->actionRouteDownloadTracksNow, &QAction::triggered, trackController, &TrackController::startDownload);
   connect(ui->actionRouteDeleteTracks, &QAction::triggered, trackController, &TrackController::deleteTracks);
+  connect(ui->actionRouteDownloadMapTiles, &QAction::triggered, mapWidget, &MapWidget::downloadRouteTiles);
 
   // Weather source =======================================================
   connect(ui->actionMapShowWeatherSimulator, &QAction::toggled, this, &MainWindow::updateMapObjectsShown);
@@ -1494,6 +1584,7 @@ void MainWindow::connectAllSlots()
   connect(connectClient, &ConnectClient::dataPacketReceived, routeController, &RouteController::simDataChanged);
 
   connect(connectClient, &ConnectClient::dataPacketReceived, mapWidget, &MapWidget::simDataChanged);
+  connect(connectClient, &ConnectClient::dataPacketReceived, mapViewWindow, &MapViewWindow::simDataChanged);
   connect(connectClient, &ConnectClient::dataPacketReceived, profileWidget, &ProfileWidget::simDataChanged);
   connect(connectClient, &ConnectClient::dataPacketReceived, infoController, &InfoController::simDataChanged);
 
@@ -1530,12 +1621,13 @@ void MainWindow::connectAllSlots()
 
   // Weather update ===================================================
   connect(weatherReporter, &WeatherReporter::weatherUpdated, mapWidget, &MapWidget::updateTooltip);
-  connect(weatherReporter, &WeatherReporter::weatherUpdated, infoController, &InfoController::updateAirportWeather);
+  // Completed downloads rebuild the tabs only if the METAR of the shown airport has changed
+  connect(weatherReporter, &WeatherReporter::weatherUpdated, infoController, &InfoController::updateAirport);
   connect(weatherReporter, &WeatherReporter::weatherUpdated, mapWidget, &MapPaintWidget::weatherUpdated);
 
   connect(connectClient, &ConnectClient::weatherUpdated, mapWidget, &MapPaintWidget::weatherUpdated);
   connect(connectClient, &ConnectClient::weatherUpdated, mapWidget, &MapWidget::updateTooltip);
-  connect(connectClient, &ConnectClient::weatherUpdated, infoController, &InfoController::updateAirportWeather);
+  connect(connectClient, &ConnectClient::weatherUpdated, infoController, &InfoController::updateAirport);
 
   // Wind update ===================================================
   connect(windReporter, &WindReporter::windUpdated, routeController, &RouteController::windUpdated);
@@ -1693,11 +1785,12 @@ void MainWindow::actionShortcutAircraftProgressTriggered()
   ui->textBrowserAircraftProgressInfo->setFocus();
 }
 
-/* Update the info weather */
+/* Update the info weather. Triggers new requests for stale cache entries while the
+ * tabs are only rebuilt if a METAR has changed. */
 void MainWindow::weatherUpdateTimeout()
 {
   // if(connectClient != nullptr && connectClient->isConnected() && infoController != nullptr)
-  infoController->updateAirportWeather();
+  infoController->updateAirport();
 }
 
 void MainWindow::themeMenuTriggered(bool checked)
@@ -2573,24 +2666,46 @@ bool MainWindow::createMapImage(QPixmap& pixmap, const QString& dialogTitle, con
         activeJobs = active;
       });
 
-      // Loop until seconds are over
-      for(int i = 0; i < numSeconds; i++)
+      // Loop until seconds are over - check render status and cancel button four times a second
+      for(int i = 0; i < numSeconds * 4; i++)
       {
-        progress.setValue(i);
+        progress.setValue(i / 4);
         QApplication::processEvents();
 
         if(progress.wasCanceled() || paintWidget.renderStatus() == Marble::Complete ||
            (queuedJobs == 0 && activeJobs == 0))
           break;
 
-        QThread::sleep(1);
+        QThread::msleep(250);
       }
       progress.setValue(numSeconds);
 
-      // Now draw the actual image including navaids
-      QGuiApplication::setOverrideCursor(Qt::WaitCursor);
-      pixmap = paintWidget.getPixmap(exportDialog.getSize());
-      QGuiApplication::restoreOverrideCursor();
+      // Now draw the actual image including navaids. Render in horizontal strips to keep the
+      // progress dialog responsive and to allow canceling high resolution exports which can
+      // take a long time.
+      QSize size = exportDialog.getSize();
+      int numStrips = (size.height() + IMAGE_EXPORT_STRIP_HEIGHT - 1) / IMAGE_EXPORT_STRIP_HEIGHT;
+
+      QProgressDialog renderProgress(tr("Drawing map image ..."), tr("&Cancel"), 0, numStrips, this);
+      renderProgress.setWindowModality(Qt::WindowModal);
+      renderProgress.setMinimumDuration(500);
+
+      pixmap = QPixmap(size);
+      QPainter painter(&pixmap);
+      for(int strip = 0; strip < numStrips; strip++)
+      {
+        renderProgress.setValue(strip);
+        QApplication::processEvents();
+
+        if(renderProgress.wasCanceled())
+          return false;
+
+        QRect stripRect(0, strip * IMAGE_EXPORT_STRIP_HEIGHT, size.width(),
+                        std::min(IMAGE_EXPORT_STRIP_HEIGHT, size.height() - strip * IMAGE_EXPORT_STRIP_HEIGHT));
+        painter.drawPixmap(stripRect.topLeft(), paintWidget.grab(stripRect));
+      }
+      painter.end();
+      renderProgress.setValue(numStrips);
 
       if(json != nullptr)
         // Create Avitab reference if needed
@@ -2901,11 +3016,27 @@ void MainWindow::updateMapObjectsShown()
   // saveActionStates();
 
   mapWidget->updateMapObjectsShown();
+  mapViewWindow->updateMapObjectsShown();
   profileWidget->update();
   updateActionStates();
   // setStatusMessage(tr("Map settings changed."));
 }
 
+void MainWindow::mapViewWindowToggled(bool checked)
+{
+  if(checked)
+    mapViewWindow->showWindow();
+  else
+    mapViewWindow->hide();
+}
+
+void MainWindow::mapViewWindowHidden()
+{
+  actionMapViewWindow->blockSignals(true);
+  actionMapViewWindow->setChecked(false);
+  actionMapViewWindow->blockSignals(false);
+}
+
 /* Map history has changed */
 void MainWindow::updateMapHistoryActions(int minIndex, int curIndex, int maxIndex)
 {
@@ -3029,9 +3160,16 @@ void MainWindow::mainWindowShown()
   // Postpone loading of KML etc. until now when everything is set up
   mapWidget->mainWindowShown();
   profileWidget->mainWindowShown();
+  infoController->mainWindowShown();
 
   mapWidget->showSavedPosOnStartup();
 
+  // Restore the additional map window and check the action if it was open on exit
+  mapViewWindow->restoreState();
+  actionMapViewWindow->blockSignals(true);
+  actionMapViewWindow->setChecked(mapViewWindow->isVisible());
+  actionMapViewWindow->blockSignals(false);
+
   atools::gui::Application::sendFontChanged();
 
   // Show a warning if SSL was not intiaized properly. Can happen if the redist packages are not installed.
@@ -3195,6 +3333,30 @@ void MainWindow::mainWindowShown()
   qDebug() << Q_FUNC_INFO << "leave";
 }
 
+void MainWindow::warmupCachesOnIdle()
+{
+  if(hasDatabaseLoadStatus || NavApp::isShuttingDown() || !NavApp::isConnectedAndAircraftFlying())
+    return;
+
+  const map::MapAirport& destination = NavApp::getRouteConst().getDestinationAirportLeg().getAirport();
+  if(destination.isValid())
+  {
+    // Pull runways, aprons, taxiways and parking of the destination into the diagram caches
+    // so the first zoom into the airport on arrival does not have to go to the database
+    AirportQuery *airportQuery = NavApp::getAirportQuerySim();
+    airportQuery->getRunways(destination.id);
+    airportQuery->getAprons(destination.id);
+    airportQuery->getTaxiPaths(destination.id);
+    airportQuery->getParkingsForAirport(destination.id);
+    airportQuery->getStartPositionsForAirport(destination.id);
+    airportQuery->getHelipads(destination.id);
+
+    // Request the flight plan weather reports again - the weather caches are cleared on
+    // every update so the reports might have gone cold since the last preload
+    weatherReporter->preloadRouteWeather();
+  }
+}
+
 void MainWindow::exitFullScreenPressed()
 {
   qDebug() << Q_FUNC_INFO;
@@ -3353,6 +3515,7 @@ void MainWindow::updateActionStates()
   ui->actionPrintFlightplan->setEnabled(hasFlightplan);
   ui->actionRouteCopyString->setEnabled(hasFlightplan);
   ui->actionRouteAdjustAltitude->setEnabled(hasFlightplan);
+  ui->actionRouteDownloadMapTiles->setEnabled(hasFlightplan);
 
   bool hasTracks = NavApp::hasTracks();
   ui->actionRouteDeleteTracks->setEnabled(hasTracks);
@@ -3672,6 +3835,10 @@ void MainWindow::saveStateMain()
   if(mapWidget != nullptr)
     mapWidget->saveState();
 
+  qDebug() << "mapViewWindow";
+  if(mapViewWindow != nullptr)
+    mapViewWindow->saveState();
+
   qDebug() << "userDataController";
   if(NavApp::getUserdataController() != nullptr)
     NavApp::getUserdataController()->saveState();
@@ -3929,6 +4096,7 @@ void MainWindow::preDatabaseLoad()
     searchController->preDatabaseLoad();
     routeController->preDatabaseLoad();
     mapWidget->preDatabaseLoad();
+    mapViewWindow->preDatabaseLoad();
     profileWidget->preDatabaseLoad();
     infoController->preDatabaseLoad();
     weatherReporter->preDatabaseLoad();
@@ -3952,6 +4120,7 @@ void MainWindow::postDatabaseLoad(atools::fs::FsPaths::SimulatorType type)
     searchController->postDatabaseLoad();
     routeController->postDatabaseLoad();
     mapWidget->postDatabaseLoad();
+    mapViewWindow->postDatabaseLoad();
     profileWidget->postDatabaseLoad();
     infoController->postDatabaseLoad();
     weatherReporter->postDatabaseLoad(type);
@@ -3993,8 +4162,14 @@ bool MainWindow::buildWeatherContextForInfo(map::WeatherContext& weatherContext,
   {
     if(NavApp::getCurrentSimulatorDb() == atools::fs::FsPaths::XPLANE11)
     {
-      currentWeatherContext->fsMetar = weatherReporter->getXplaneMetar(airport.ident, airport.position);
-      changed = true;
+      atools::fs::weather::MetarResult metar = weatherReporter->getXplaneMetar(airport.ident, airport.position);
+
+      if(newAirport || (!metar.isEmpty() && metar != currentWeatherContext->fsMetar))
+      {
+        // Airport has changed or METAR has changed
+        currentWeatherContext->fsMetar = metar;
+        changed = true;
+      }
     }
     else if(NavApp::isConnected())
     {
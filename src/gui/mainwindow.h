@@ -29,6 +29,7 @@
 
 class ConnectClient;
 class DatabaseManager;
+class IdleScheduler;
 class InfoController;
 class OptionsDialog;
 class PrintSupport;
@@ -76,6 +77,7 @@ namespace Ui {
 class MainWindow;
 }
 
+class MapViewWindow;
 class MapWidget;
 class MapQuery;
 class InfoQuery;
@@ -233,6 +235,10 @@ private:
 
   void connectAllSlots();
   void mainWindowShown();
+
+  /* Called by the idle scheduler when there was no user interaction for a while.
+   * Warms up caches for the expected arrival. */
+  void warmupCachesOnIdle();
   void raiseFloatingWindows();
   void allowDockingWindows();
 
@@ -268,6 +274,12 @@ private:
 
   void updateMapObjectsShown();
 
+  /* Show or hide the additional top level map window from the menu action */
+  void mapViewWindowToggled(bool checked);
+
+  /* Additional map window was closed by the user */
+  void mapViewWindowHidden();
+
   /* Reset drawing settings */
   void resetMapObjectsShown();
 
@@ -389,6 +401,8 @@ private:
   void debugActionTriggered2();
   void debugActionTriggered3();
   void debugActionTriggered4();
+  void debugActionTriggered5();
+  void debugActionTriggered6();
 
 #endif
 
@@ -416,6 +430,11 @@ private:
 
   Ui::MainWindow *ui;
   MapWidget *mapWidget = nullptr;
+
+  /* Additional top level map window sharing queries, caches and the simulator connection */
+  MapViewWindow *mapViewWindow = nullptr;
+  QAction *actionMapViewWindow = nullptr;
+
   ProfileWidget *profileWidget = nullptr;
   PrintSupport *printSupport = nullptr;
 
@@ -450,6 +469,7 @@ private:
   QList<QAction *> customMapThemeMenuActions;
 
   /* Managment and controller classes */
+  IdleScheduler *idleScheduler = nullptr;
   WeatherReporter *weatherReporter = nullptr;
   WindReporter *windReporter = nullptr;
   InfoController *infoController = nullptr;
@@ -39,6 +39,7 @@
 #include "mapgui/mapwidget.h"
 #include "gui/tabwidgethandler.h"
 
+#include <QTimer>
 #include <QUrlQuery>
 
 using atools::util::HtmlBuilder;
@@ -412,7 +413,13 @@ void InfoController::restoreState()
   tabHandlerInfo->restoreState();
   tabHandlerAirportInfo->restoreState();
   tabHandlerAircraft->restoreState();
+  updateTextEditFontSizes();
+}
 
+void InfoController::mainWindowShown()
+{
+  // Fill the tabs with the objects of the last session now. This needs database queries and
+  // HTML building and is postponed to avoid delaying the first window paint.
   if(OptionData::instance().getFlags() & opts::STARTUP_LOAD_INFO)
   {
     lessAircraftProgress =
@@ -445,7 +452,6 @@ void InfoController::restoreState()
     Ui::MainWindow *ui = NavApp::getMainUi();
     atools::gui::WidgetState(lnm::INFOWINDOW_WIDGET).restore(ui->tabWidgetLegend);
   }
-  updateTextEditFontSizes();
 }
 
 void InfoController::updateAirport()
@@ -519,6 +525,41 @@ void InfoController::updateAirportInternal(bool newAirport, bool bearingChange,
   }
 }
 
+void InfoController::updateDeferredAirportTabs()
+{
+  if(!deferredTabsPending || databaseLoadStatus)
+    return;
+
+  deferredTabsPending = false;
+
+  // Canceled if the selection changed in the meantime
+  if(!currentSearchResult.hasAirports() || currentSearchResult.airports.first().id != deferredTabsAirport.id)
+    return;
+
+  Ui::MainWindow *ui = NavApp::getMainUi();
+  HtmlBuilder html(true);
+  bool scrollToTop = deferredTabsScrollToTop;
+
+  infoBuilder->runwayText(deferredTabsAirport, html);
+  atools::gui::util::updateTextEdit(ui->textBrowserRunwayInfo, html.getHtml(),
+                                    scrollToTop, !scrollToTop /* keep selection */);
+
+  html.clear();
+  infoBuilder->comText(deferredTabsAirport, html);
+  atools::gui::util::updateTextEdit(ui->textBrowserComInfo, html.getHtml(),
+                                    scrollToTop, !scrollToTop /* keep selection */);
+
+  html.clear();
+  infoBuilder->procedureText(deferredTabsAirport, html);
+  atools::gui::util::updateTextEdit(ui->textBrowserApproachInfo, html.getHtml(),
+                                    scrollToTop, !scrollToTop /* keep selection */);
+
+  html.clear();
+  infoBuilder->nearestText(deferredTabsAirport, html);
+  atools::gui::util::updateTextEdit(ui->textBrowserNearestInfo, html.getHtml(),
+                                    scrollToTop, !scrollToTop /* keep selection */);
+}
+
 void InfoController::clearInfoTextBrowsers()
 {
   Ui::MainWindow *ui = NavApp::getMainUi();
@@ -599,7 +640,9 @@ void InfoController::showInformationInternal(map::MapResult result, bool showWin
   // Remember the clicked AI for the next update - copy to currentSearchResult ====================
   if(!result.aiAircraft.isEmpty())
   {
+#ifdef DEBUG_INFORMATION
     qDebug() << "Found AI";
+#endif
     currentSearchResult.aiAircraft.clear();
 
     for(const map::MapAiAircraft& mapAiAircraft : result.aiAircraft)
@@ -693,26 +736,12 @@ void InfoController::showInformationInternal(map::MapResult result, bool showWin
 
     if(changed || forceUpdate)
     {
-      // Update parts that have now weather or bearing depenedency =====================
-      html.clear();
-      infoBuilder->runwayText(airport, html);
-      atools::gui::util::updateTextEdit(ui->textBrowserRunwayInfo, html.getHtml(),
-                                        scrollToTop, !scrollToTop /* keep selection */);
-
-      html.clear();
-      infoBuilder->comText(airport, html);
-      atools::gui::util::updateTextEdit(ui->textBrowserComInfo, html.getHtml(),
-                                        scrollToTop, !scrollToTop /* keep selection */);
-
-      html.clear();
-      infoBuilder->procedureText(airport, html);
-      atools::gui::util::updateTextEdit(ui->textBrowserApproachInfo, html.getHtml(),
-                                        scrollToTop, !scrollToTop /* keep selection */);
-
-      html.clear();
-      infoBuilder->nearestText(airport, html);
-      atools::gui::util::updateTextEdit(ui->textBrowserNearestInfo, html.getHtml(),
-                                        scrollToTop, !scrollToTop /* keep selection */);
+      // Build the tabs that have no weather or bearing dependency in the next event loop pass
+      // so the click response stays immediate. A newer selection overwrites a pending update.
+      deferredTabsAirport = airport;
+      deferredTabsScrollToTop = scrollToTop;
+      deferredTabsPending = true;
+      QTimer::singleShot(0, this, &InfoController::updateDeferredAirportTabs);
     }
 
     foundAirport = true;
@@ -740,7 +769,9 @@ void InfoController::showInformationInternal(map::MapResult result, bool showWin
 
     for(const map::MapAirspace& airspace : result.getSimNavUserAirspaces())
     {
+#ifdef DEBUG_INFORMATION
       qDebug() << "Found airspace" << airspace.id;
+#endif
 
       currentSearchResult.airspaces.append(airspace);
       infoBuilder->airspaceText(airspace, onlineRec, html);
@@ -780,7 +811,9 @@ void InfoController::showInformationInternal(map::MapResult result, bool showWin
 
     for(const map::MapAirspace& airspace : onlineAirspaces)
     {
+#ifdef DEBUG_INFORMATION
       qDebug() << "Found airspace" << airspace.id;
+#endif
 
       currentSearchResult.airspaces.append(airspace);
 
@@ -808,7 +841,9 @@ void InfoController::showInformationInternal(map::MapResult result, bool showWin
 
     for(const map::MapLogbookEntry& logEntry : result.logbookEntries)
     {
+#ifdef DEBUG_INFORMATION
       qDebug() << "Found log entry" << logEntry.id;
+#endif
 
       currentSearchResult.logbookEntries.append(logEntry);
       foundLogbookEntry |= infoBuilder->logEntryText(logEntry, html);
@@ -1046,6 +1081,7 @@ void InfoController::preDatabaseLoad()
 {
   // Clear current airport and navaids result
   currentSearchResult = map::MapResult();
+  deferredTabsPending = false;
   databaseLoadStatus = true;
   clearInfoTextBrowsers();
 }
@@ -1063,6 +1099,10 @@ void InfoController::styleChanged()
   tabHandlerAircraft->styleChanged();
   showInformationInternal(currentSearchResult, false /* Show windows */, false /* scroll to top */,
                           true /* forceUpdate */);
+
+  // Rebuild the aircraft progress as well - this is the only part of optionsChanged() needed
+  // for a style switch which otherwise rebuilt all information tabs a second time
+  updateAircraftInfo();
 }
 
 void InfoController::tracksChanged()
@@ -1097,15 +1137,28 @@ void InfoController::updateUserAircraftText()
         HtmlBuilder html(true /* has background color */);
         infoBuilder->aircraftText(lastSimData.getUserAircraftConst(), html);
         infoBuilder->aircraftTextWeightAndFuel(lastSimData.getUserAircraftConst(), html);
-        atools::gui::util::updateTextEdit(ui->textBrowserAircraftInfo, html.getHtml(),
-                                          false /* scroll to top*/, true /* keep selection */);
+
+        if(html.getHtml() != lastAircraftHtml)
+        {
+          // Displayed values changed - update the document. Avoids the expensive re-layout
+          // when the aircraft is parked or the simulator is paused.
+          atools::gui::util::updateTextEdit(ui->textBrowserAircraftInfo, html.getHtml(),
+                                            false /* scroll to top*/, true /* keep selection */);
+          lastAircraftHtml = html.getHtml();
+        }
       }
     }
     else
+    {
       ui->textBrowserAircraftInfo->setPlainText(tr("Connected. Waiting for update."));
+      lastAircraftHtml.clear();
+    }
   }
   else
+  {
     ui->textBrowserAircraftInfo->clear();
+    lastAircraftHtml.clear();
+  }
 }
 
 void InfoController::updateAircraftProgressText()
@@ -1125,15 +1178,28 @@ void InfoController::updateAircraftProgressText()
         HtmlBuilder html(true /* has background color */);
         infoBuilder->aircraftProgressText(lastSimData.getUserAircraftConst(), html, NavApp::getRouteConst(),
                                           true /* show more/less switch */, lessAircraftProgress);
-        atools::gui::util::updateTextEdit(ui->textBrowserAircraftProgressInfo, html.getHtml(),
-                                          false /* scroll to top*/, true /* keep selection */);
+
+        if(html.getHtml() != lastAircraftProgressHtml)
+        {
+          // Displayed values changed - update the document. Avoids the expensive re-layout
+          // when the aircraft is parked or the simulator is paused.
+          atools::gui::util::updateTextEdit(ui->textBrowserAircraftProgressInfo, html.getHtml(),
+                                            false /* scroll to top*/, true /* keep selection */);
+          lastAircraftProgressHtml = html.getHtml();
+        }
       }
     }
     else
+    {
       ui->textBrowserAircraftProgressInfo->setPlainText(tr("Connected. Waiting for update."));
+      lastAircraftProgressHtml.clear();
+    }
   }
   else
+  {
     ui->textBrowserAircraftProgressInfo->clear();
+    lastAircraftProgressHtml.clear();
+  }
 }
 
 void InfoController::updateAiAircraftText()
@@ -1190,7 +1256,7 @@ void InfoController::updateAiAircraftText()
     ui->textBrowserAircraftAiInfo->clear();
 }
 
-void InfoController::simDataChanged(atools::fs::sc::SimConnectData data)
+void InfoController::simDataChanged(const atools::fs::sc::SimConnectData& data)
 {
   if(databaseLoadStatus)
     return;
@@ -62,6 +62,8 @@ public:
   /* Update the currently shown airport information if weather data or connection status has changed.
    * Does not raise windows and does not scroll to top. */
   void updateAirport();
+
+  /* Rebuild airport and weather tab unconditionally. Used when the weather display options change. */
   void updateAirportWeather();
 
   /* Updates aircraft progress only. */
@@ -80,6 +82,10 @@ public:
   void saveState();
   void restoreState();
 
+  /* Fills the tabs with the objects of the last session. Called after the main window is shown
+   * since this needs database queries and HTML building. */
+  void mainWindowShown();
+
   /* Clear all panels and result set */
   void preDatabaseLoad();
   void postDatabaseLoad();
@@ -88,7 +94,7 @@ public:
   void tracksChanged();
 
   /* Update aircraft and aircraft progress tab */
-  void simDataChanged(atools::fs::sc::SimConnectData data);
+  void simDataChanged(const atools::fs::sc::SimConnectData& data);
   void connectedToSimulator();
   void disconnectedFromSimulator();
 
@@ -118,6 +124,10 @@ private:
   static Q_DECL_CONSTEXPR int MIN_SIM_UPDATE_BEARING_TIME_MS = 1000;
 
   void updateAirportInternal(bool newAirport, bool bearingChange, bool scrollToTop, bool forceWeatherUpdate);
+
+  /* Build the HTML for the runway, COM, procedure and nearest tabs in the next event loop pass.
+   * A newer selection supersedes a pending update. */
+  void updateDeferredAirportTabs();
   bool updateNavaidInternal(const map::MapResult& result, bool bearingChanged, bool scrollToTop,
                             bool forceUpdate);
   bool updateUserpointInternal(const map::MapResult& result, bool bearingChanged, bool scrollToTop);
@@ -148,9 +158,17 @@ private:
   qint64 lastSimUpdate = 0;
   qint64 lastSimBearingUpdate = 0;
 
+  /* HTML shown in the aircraft and progress tabs by the last update. All values are rounded for
+   * display so unchanged text means unchanged content and the document update can be skipped. */
+  QString lastAircraftHtml, lastAircraftProgressHtml;
+
   /* Airport and navaids that are currently shown in the tabs */
   map::MapResult currentSearchResult;
 
+  /* Airport for the deferred tab update scheduled from showInformationInternal() */
+  map::MapAirport deferredTabsAirport;
+  bool deferredTabsPending = false, deferredTabsScrollToTop = false;
+
   MainWindow *mainWindow = nullptr;
   MapQuery *mapQuery = nullptr;
   AirportQuery *airportQuery = nullptr;
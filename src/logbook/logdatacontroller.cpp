@@ -35,6 +35,7 @@
 #include "logbook/logdatadialog.h"
 #include "logbook/logstatisticsdialog.h"
 #include "zip/gzip.h"
+#include "geo/calculations.h"
 #include "navapp.h"
 #include "query/airportquery.h"
 #include "route/route.h"
@@ -59,6 +60,14 @@ using atools::sql::SqlRecord;
 using atools::geo::Pos;
 using atools::fs::pln::FlightplanIO;
 
+/* Maximum cross track error in meter when thinning the aircraft trail out before saving
+ * it to a logbook entry. Well below the GPS resolution of the stored coordinates. */
+const float TRAIL_STORAGE_TOLERANCE_METER = 5.f;
+
+/* Commit a trail point latest when the altitude changed by this amount to keep the
+ * vertical profile intact on long straight segments */
+const float TRAIL_STORAGE_MAX_ALTITUDE_DIFF_FT = 100.f;
+
 LogdataController::LogdataController(atools::fs::userdata::LogdataManager *logdataManager, MainWindow *parent)
   : manager(logdataManager), mainWindow(parent)
 {
@@ -116,33 +125,68 @@ atools::sql::SqlRecord LogdataController::getLogEntryRecordById(int id)
 void LogdataController::getFlightStatsTime(QDateTime& earliest, QDateTime& latest, QDateTime& earliestSim,
                                            QDateTime& latestSim)
 {
-  manager->getFlightStatsTime(earliest, latest, earliestSim, latestSim);
+  updateFlightStatsCache();
+  earliest = statsCache.earliest;
+  latest = statsCache.latest;
+  earliestSim = statsCache.earliestSim;
+  latestSim = statsCache.latestSim;
 }
 
 void LogdataController::getFlightStatsDistance(float& distTotal, float& distMax, float& distAverage)
 {
-  manager->getFlightStatsDistance(distTotal, distMax, distAverage);
+  updateFlightStatsCache();
+  distTotal = statsCache.distTotal;
+  distMax = statsCache.distMax;
+  distAverage = statsCache.distAverage;
 }
 
 void LogdataController::getFlightStatsAirports(int& numDepartAirports, int& numDestAirports)
 {
-  manager->getFlightStatsAirports(numDepartAirports, numDestAirports);
+  updateFlightStatsCache();
+  numDepartAirports = statsCache.numDepartAirports;
+  numDestAirports = statsCache.numDestAirports;
 }
 
 void LogdataController::getFlightStatsTripTime(float& timeMaximum, float& timeAverage, float& timeMaximumSim,
                                                float& timeAverageSim)
 {
-  manager->getFlightStatsTripTime(timeMaximum, timeAverage, timeMaximumSim, timeAverageSim);
+  updateFlightStatsCache();
+  timeMaximum = statsCache.timeMaximum;
+  timeAverage = statsCache.timeAverage;
+  timeMaximumSim = statsCache.timeMaximumSim;
+  timeAverageSim = statsCache.timeAverageSim;
 }
 
 void LogdataController::getFlightStatsAircraft(int& numTypes, int& numRegistrations, int& numNames, int& numSimulators)
 {
-  manager->getFlightStatsAircraft(numTypes, numRegistrations, numNames, numSimulators);
+  updateFlightStatsCache();
+  numTypes = statsCache.numTypes;
+  numRegistrations = statsCache.numRegistrations;
+  numNames = statsCache.numNames;
+  numSimulators = statsCache.numSimulators;
 }
 
 void LogdataController::getFlightStatsSimulator(QVector<std::pair<int, QString> >& numSimulators)
 {
-  manager->getFlightStatsSimulator(numSimulators);
+  updateFlightStatsCache();
+  numSimulators = statsCache.simulators;
+}
+
+void LogdataController::updateFlightStatsCache()
+{
+  if(statsCache.valid)
+    return;
+
+  statsCache = FlightStatsCache();
+  manager->getFlightStatsTime(statsCache.earliest, statsCache.latest, statsCache.earliestSim, statsCache.latestSim);
+  manager->getFlightStatsDistance(statsCache.distTotal, statsCache.distMax, statsCache.distAverage);
+  manager->getFlightStatsAirports(statsCache.numDepartAirports, statsCache.numDestAirports);
+  manager->getFlightStatsTripTime(statsCache.timeMaximum, statsCache.timeAverage, statsCache.timeMaximumSim,
+                                  statsCache.timeAverageSim);
+  manager->getFlightStatsAircraft(statsCache.numTypes, statsCache.numRegistrations, statsCache.numNames,
+                                  statsCache.numSimulators);
+  manager->getFlightStatsSimulator(statsCache.simulators);
+  statsCache.valid = true;
 }
 
 void LogdataController::showStatistics()
@@ -259,6 +303,10 @@ void LogdataController::createTakeoffLanding(const atools::fs::sc::SimConnectUse
       atools::geo::LineString track;
       QVector<quint32> timestamps;
       NavApp::getAircraftTrack().convert(&track, &timestamps);
+
+      // Thin the trail out before saving to keep the logbook database small
+      simplifyTrackForStorage(track, timestamps);
+
       record.setValue("aircraft_trail",
                       FlightplanIO().saveGpxGz(NavApp::getRoute().
                                                updatedAltitudes().adjustedToOptions(rf::DEFAULT_OPTS_GPX).getFlightplan(),
@@ -296,14 +344,61 @@ void LogdataController::createTakeoffLanding(const atools::fs::sc::SimConnectUse
 
 void LogdataController::logChanged(bool loadAll, bool keepSelection)
 {
-  // Clear cache and update map screen index
+  // Clear caches and update map screen index
   manager->clearGeometryCache();
+  simplifiedTrackCache.clear();
+  statsCache.valid = false;
   emit logDataChanged();
 
   // Reload search
   emit refreshLogSearch(loadAll, keepSelection);
 }
 
+void LogdataController::simplifyTrackForStorage(atools::geo::LineString& track, QVector<quint32>& timestamps)
+{
+  if(track.size() <= 2 || track.size() != timestamps.size())
+    return;
+
+  // Same cross track error scheme as in getSimplifiedTrackGeometry() but keeping the
+  // timestamps in sync and committing points on altitude changes too
+  atools::geo::LineString simplified;
+  QVector<quint32> simplifiedTimestamps;
+  simplified.append(track.at(0));
+  simplified.append(track.at(1));
+  simplifiedTimestamps.append(timestamps.at(0));
+  simplifiedTimestamps.append(timestamps.at(1));
+
+  float maxDeviation = 0.f;
+  for(int i = 2; i < track.size(); i++)
+  {
+    const atools::geo::Pos& anchor = simplified.at(simplified.size() - 2);
+
+    atools::geo::LineDistance result;
+    simplified.last().distanceMeterToLine(anchor, track.at(i), result);
+    maxDeviation = std::max(maxDeviation, std::abs(result.distance));
+
+    if(maxDeviation > TRAIL_STORAGE_TOLERANCE_METER ||
+       std::abs(track.at(i).getAltitude() - anchor.getAltitude()) > TRAIL_STORAGE_MAX_ALTITUDE_DIFF_FT)
+    {
+      // Error got too large - commit the previous point and open a new segment
+      maxDeviation = 0.f;
+      simplified.append(track.at(i));
+      simplifiedTimestamps.append(timestamps.at(i));
+    }
+    else
+    {
+      // Move the preliminary end of the open segment to the new point
+      simplified.last() = track.at(i);
+      simplifiedTimestamps.last() = timestamps.at(i);
+    }
+  }
+
+  qDebug() << Q_FUNC_INFO << "Thinned trail from" << track.size() << "to" << simplified.size() << "points";
+
+  track = simplified;
+  timestamps = simplifiedTimestamps;
+}
+
 void LogdataController::recordFlightplanAndPerf(atools::sql::SqlRecord& record)
 {
   atools::fs::pln::Flightplan fp = NavApp::getRoute().
@@ -356,11 +451,14 @@ void LogdataController::preDatabaseLoad()
 void LogdataController::postDatabaseLoad()
 {
   manager->clearGeometryCache();
+  simplifiedTrackCache.clear();
+  statsCache.valid = false;
 }
 
 void LogdataController::displayOptionsChanged()
 {
   manager->clearGeometryCache();
+  simplifiedTrackCache.clear();
 }
 
 const atools::geo::LineString *LogdataController::getRouteGeometry(int id)
@@ -375,6 +473,52 @@ const atools::geo::LineString *LogdataController::getTrackGeometry(int id)
   return entry != nullptr ? &entry->track : nullptr;
 }
 
+const atools::geo::LineString *LogdataController::getSimplifiedTrackGeometry(int id, float maxErrorMeter)
+{
+  const atools::fs::userdata::LogEntryGeometry *entry = manager->getGeometry(id);
+  if(entry == nullptr)
+    return nullptr;
+
+  float tolerance = AircraftTrack::simplifyTolerance(maxErrorMeter);
+  if(tolerance <= 0.f || entry->track.size() <= 2)
+    // Zoomed in too far - use the full resolution trail
+    return &entry->track;
+
+  QString key = QString::number(id) + "_" + QString::number(tolerance);
+  atools::geo::LineString *simplified = simplifiedTrackCache.object(key);
+  if(simplified == nullptr)
+  {
+    // Walk along the trail and commit a point whenever the cross track error of the skipped
+    // points to the open segment exceeds the tolerance - same scheme as the live aircraft trail
+    const atools::geo::LineString& track = entry->track;
+    simplified = new atools::geo::LineString;
+    simplified->append(track.at(0));
+    simplified->append(track.at(1));
+
+    float maxDeviation = 0.f;
+    for(int i = 2; i < track.size(); i++)
+    {
+      const atools::geo::Pos& anchor = simplified->at(simplified->size() - 2);
+
+      atools::geo::LineDistance result;
+      simplified->last().distanceMeterToLine(anchor, track.at(i), result);
+      maxDeviation = std::max(maxDeviation, std::abs(result.distance));
+
+      if(maxDeviation > tolerance)
+      {
+        // Error got too large - commit the previous point and open a new segment
+        maxDeviation = 0.f;
+        simplified->append(track.at(i));
+      }
+      else
+        // Move the preliminary end of the open segment to the new point
+        simplified->last() = track.at(i);
+    }
+    simplifiedTrackCache.insert(key, simplified);
+  }
+  return simplified;
+}
+
 void LogdataController::editLogEntryFromMap(int id)
 {
   qDebug() << Q_FUNC_INFO;
@@ -495,7 +639,11 @@ void LogdataController::importXplane()
     int numImported = 0;
     if(!file.isEmpty())
     {
+      // Batch all inserts into one transaction
+      SqlTransaction transaction(manager->getDatabase());
       numImported += manager->importXplane(file, fetchAirportCoordinates);
+      transaction.commit();
+
       mainWindow->setStatusMessage(tr("Imported %1 %2 X-Plane logbook.").arg(numImported).
                                    arg(numImported == 1 ? tr("entry") : tr("entries")));
 
@@ -530,7 +678,15 @@ void LogdataController::importCsv()
     int numImported = 0;
     if(!file.isEmpty())
     {
+      QGuiApplication::setOverrideCursor(Qt::WaitCursor);
+
+      // Batch all inserts into one transaction
+      SqlTransaction transaction(manager->getDatabase());
       numImported += manager->importCsv(file);
+      transaction.commit();
+
+      QGuiApplication::restoreOverrideCursor();
+
       mainWindow->setStatusMessage(tr("Imported %1 %2 from CSV file.").arg(numImported).
                                    arg(numImported == 1 ? tr("entry") : tr("entries")));
       mainWindow->showLogbookSearch();
@@ -604,12 +760,17 @@ void LogdataController::exportCsv()
         if(choiceDialog.isChecked(SELECTED))
           ids = NavApp::getLogdataSearch()->getSelectedIds();
 
+        // Can take a while with attachments enabled on a large logbook
+        QGuiApplication::setOverrideCursor(Qt::WaitCursor);
+
         int numExported = manager->exportCsv(file, ids,
                                              choiceDialog.isChecked(EXPORTPLAN),
                                              choiceDialog.isChecked(EXPORTPERF),
                                              choiceDialog.isChecked(EXPORTGPX),
                                              choiceDialog.isChecked(HEADER) && !choiceDialog.isChecked(APPEND),
                                              choiceDialog.isChecked(APPEND));
+        QGuiApplication::restoreOverrideCursor();
+
         mainWindow->setStatusMessage(tr("%1 logbook %2 exported.").
                                      arg(numExported).arg(numExported == 1 ? tr("entry") : tr("entries")));
       }
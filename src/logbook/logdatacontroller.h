@@ -20,6 +20,8 @@
 
 #include "common/maptypes.h"
 
+#include <QCache>
+#include <QDateTime>
 #include <QObject>
 #include <QVector>
 
@@ -139,6 +141,11 @@ public:
   const atools::geo::LineString *getTrackGeometry(int id);
   const atools::geo::LineString *getRouteGeometry(int id);
 
+  /* Get a simplified copy of the aircraft trail where the cross track error stays approximately
+   * below maxErrorMeter. Uses the same tolerance buckets as the live aircraft trail and falls
+   * back to the full geometry for close zoom levels. Returns null if no geometry is available. */
+  const atools::geo::LineString *getSimplifiedTrackGeometry(int id, float maxErrorMeter);
+
   /* Clear caches */
   void preDatabaseLoad();
   void postDatabaseLoad();
@@ -187,12 +194,38 @@ private:
   /* Attach the current flight plan and performance file to the record as Gzipped XML files */
   void recordFlightplanAndPerf(atools::sql::SqlRecord& record);
 
+  /* Drop trail points within the cross track error tolerance and their timestamps before
+   * saving the trail to a logbook entry. Keeps the stored GPX blobs small. */
+  void simplifyTrackForStorage(atools::geo::LineString& track, QVector<quint32>& timestamps);
+
   /* Connect buttons in dialog with above */
   void connectDialogSignals(LogdataDialog *dialog);
 
   /* Emit signals for changed */
   void logChanged(bool loadAll, bool keepSelection);
 
+  /* Run the aggregate queries and fill the statistics cache if it is not valid */
+  void updateFlightStatsCache();
+
+  /* Cached aggregate values for the statistics dialog overview. Computed once after a change
+   * instead of running all aggregate queries over the whole logbook on each dialog update. */
+  struct FlightStatsCache
+  {
+    QDateTime earliest, latest, earliestSim, latestSim;
+    float distTotal = 0.f, distMax = 0.f, distAverage = 0.f;
+    float timeMaximum = 0.f, timeAverage = 0.f, timeMaximumSim = 0.f, timeAverageSim = 0.f;
+    int numTypes = 0, numRegistrations = 0, numNames = 0, numSimulators = 0;
+    int numDepartAirports = 0, numDestAirports = 0;
+    QVector<std::pair<int, QString> > simulators;
+    bool valid = false;
+  };
+
+  FlightStatsCache statsCache;
+
+  /* Simplified trail geometry for showing many logbook entries on far zoom levels.
+   * Keyed by entry id and simplification tolerance. */
+  QCache<QString, atools::geo::LineString> simplifiedTrackCache;
+
   /* Remember last aircraft for fuel calculations */
   const atools::fs::sc::SimConnectUserAircraft *aircraftAtTakeoff = nullptr;
   int logEntryId = -1;
@@ -80,6 +80,10 @@ int LogdataConverter::convertFromUserdata()
   query.exec();
   atools::sql::SqlRecord rec = logManager->getEmptyRecord();
   Type lasttype = NONE;
+
+  // Airports already resolved in this run - avoids hitting the database again for
+  // every entry since logbooks repeat the same airports many times
+  QHash<QString, map::MapAirport> resolvedAirports;
   while(query.next())
   {
     QString ident = query.valueStr("ident");
@@ -143,7 +147,16 @@ int LogdataConverter::convertFromUserdata()
     QString prefix = type == DEPARTURE ? "departure_" : "destination_";
     rec.setValue(prefix + "ident", ident);
 
-    map::MapAirport airport = airportQuery->getAirportByIdent(ident);
+    map::MapAirport airport;
+    auto resolved = resolvedAirports.constFind(ident);
+    if(resolved != resolvedAirports.constEnd())
+      airport = resolved.value();
+    else
+    {
+      airport = airportQuery->getAirportByIdent(ident);
+      resolvedAirports.insert(ident, airport);
+    }
+
     if(airport.isValid())
     {
       // Use values found in database ==========================
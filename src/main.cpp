@@ -45,12 +45,14 @@
 
 #include <QCommandLineParser>
 #include <QDebug>
+#include <QDir>
 #include <QSplashScreen>
 #include <QSslSocket>
 #include <QStyleFactory>
 #include <QSharedMemory>
 #include <QMessageBox>
 #include <QLibrary>
+#include <QElapsedTimer>
 #include <QPixmapCache>
 #include <QSettings>
 #include <QScreen>
@@ -66,8 +68,30 @@ using atools::logging::LoggingUtil;
 using atools::settings::Settings;
 using atools::gui::Translator;
 
+/* Startup path selected by comparing the program version and the database directory content
+ * with fingerprints stored on the last run. Controls how much validation work is done before
+ * the main window appears and which time budgets apply to the startup phases. */
+enum StartupMode
+{
+  /* Program version changed or first start - all database validation shortcuts are dropped
+   * and every database is checked for schema compatibility again */
+  STARTUP_COLD,
+
+  /* Same program version but database files changed - only the changed files are validated */
+  STARTUP_WARM,
+
+  /* Nothing changed since the last run - all validation shortcuts apply and the map
+   * has to get on screen quickly */
+  STARTUP_HOT
+};
+
 int main(int argc, char *argv[])
 {
+  // Startup timeline - phases log their total elapsed time below to track
+  // startup time regressions across releases
+  QElapsedTimer startupTimer;
+  startupTimer.start();
+
   // Initialize the resources from atools static library
   Q_INIT_RESOURCE(atools);
 
@@ -170,6 +194,20 @@ int main(int argc, char *argv[])
   QApplication::addLibraryPath(QApplication::applicationDirPath() + QDir::separator() + "plugins");
 #endif
 
+  // Logs the elapsed time since program start for one startup phase and compares it against the
+  // phase budget. Overruns are logged as warnings to make startup time regressions visible when
+  // scanning the log.
+  auto logStartupPhase = [&startupTimer](const QString& phase, qint64 budgetMs) -> void
+  {
+    qint64 elapsedMs = startupTimer.elapsed();
+    if(elapsedMs > budgetMs)
+      qWarning() << "Startup phase" << phase << "done after" << elapsedMs
+                 << "ms - over budget of" << budgetMs << "ms";
+    else
+      qInfo() << "Startup phase" << phase << "done after" << elapsedMs
+              << "ms - budget" << budgetMs << "ms";
+  };
+
   try
   {
     app.processEvents();
@@ -235,10 +273,47 @@ int main(int argc, char *argv[])
               << "DPI x" << screen->logicalDotsPerInchX()
               << "y" << screen->logicalDotsPerInchX();
 
+    logStartupPhase("logging and system information", 500);
+
     migrate::checkAndMigrateSettings();
 
     Settings& settings = Settings::instance();
 
+    // Select the startup mode by comparing the program version and the database directory
+    // content with the fingerprints of the last run ======================================
+    QString programFingerprint = QApplication::applicationVersion() + "|" + atools::gitRevision();
+    QStringList databaseFingerprint;
+    QDir databaseDir(Settings::getPath() + QDir::separator() + lnm::DATABASE_DIR);
+    for(const QFileInfo& fileinfo : databaseDir.entryInfoList({"*.sqlite"}, QDir::Files, QDir::Name))
+      databaseFingerprint.append(fileinfo.fileName() + "|" + QString::number(fileinfo.size()) + "|" +
+                                 QString::number(fileinfo.lastModified().toMSecsSinceEpoch()));
+
+    StartupMode startupMode;
+    if(settings.valueStr(lnm::STARTUP_FINGERPRINT_PROGRAM) != programFingerprint)
+      startupMode = STARTUP_COLD;
+    else if(settings.valueStrList(lnm::STARTUP_FINGERPRINT_DATABASES) != databaseFingerprint)
+      startupMode = STARTUP_WARM;
+    else
+      startupMode = STARTUP_HOT;
+
+    qInfo() << "Startup mode"
+            << (startupMode == STARTUP_COLD ? "cold" : startupMode == STARTUP_WARM ? "warm" : "hot");
+
+    if(startupMode == STARTUP_COLD)
+      // Drop the validation shortcuts after a program update or on first start - all databases
+      // are checked for schema compatibility again and the list is rebuilt from scratch
+      settings.setValue(lnm::DATABASE_VALIDATED, QStringList());
+
+    // Remember the fingerprints for the next run. A scenery reload during this session changes
+    // the files on disk and the comparison above detects this on the next start.
+    settings.setValue(lnm::STARTUP_FINGERPRINT_PROGRAM, programFingerprint);
+    settings.setValue(lnm::STARTUP_FINGERPRINT_DATABASES, databaseFingerprint);
+
+    // Budgets of the later phases depend on the startup mode - a hot start has to get the map
+    // on screen in under two seconds while cold and warm starts may validate or rebuild databases
+    qint64 databaseBudgetMs = startupMode == STARTUP_HOT ? 1200 : (startupMode == STARTUP_WARM ? 4000 : 10000);
+    qint64 windowShownBudgetMs = startupMode == STARTUP_HOT ? 2000 : (startupMode == STARTUP_WARM ? 6000 : 15000);
+
     int pixmapCache = settings.valueInt(lnm::OPTIONS_PIXMAP_CACHE, -1);
     qInfo() << "QPixmapCache cacheLimit" << QPixmapCache::cacheLimit() << "KB";
     if(pixmapCache != -1)
@@ -290,6 +365,8 @@ int main(int argc, char *argv[])
     atools::fs::weather::initTranslateableTexts();
     formatter::initTranslateableTexts();
 
+    logStartupPhase("settings and translations", 1000);
+
 #if defined(Q_OS_MACOS)
     // Check for minimum macOS version 10.10
     if(QSysInfo::macVersion() != QSysInfo::MV_None && QSysInfo::macVersion() < QSysInfo::MV_10_10)
@@ -349,6 +426,8 @@ int main(int argc, char *argv[])
     QApplication::setEffectEnabled(Qt::UI_FadeTooltip, false);
     QApplication::setEffectEnabled(Qt::UI_AnimateTooltip, false);
 
+    logStartupPhase("Marble setup", 1500);
+
     // Check if database is compatible and ask the user to erase all incompatible ones
     // If erasing databases is refused exit application
     bool databasesErased = false;
@@ -362,6 +441,8 @@ int main(int argc, char *argv[])
       delete dbManager;
       dbManager = nullptr;
 
+      logStartupPhase("database preparation", databaseBudgetMs);
+
       MainWindow mainWindow;
 
       // Show database dialog if something was removed
@@ -372,6 +453,8 @@ int main(int argc, char *argv[])
       // Hide splash once main window is shown
       NavApp::finishSplashScreen();
 
+      logStartupPhase("main window shown", windowShownBudgetMs);
+
       qDebug() << "Before app.exec()";
       retval = app.exec();
     }
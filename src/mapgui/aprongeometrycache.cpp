@@ -46,11 +46,17 @@ bool ApronGeometryCache::Key::operator!=(const ApronGeometryCache::Key& other) c
 
 // ======= ApronGeometryCache ===============================================================
 ApronGeometryCache::ApronGeometryCache()
-  : geometryCache(CACHE_SIZE)
+  : geometryCache(CACHE_SIZE_BYTES)
 {
 
 }
 
+int ApronGeometryCache::pathCost(const QPainterPath& path)
+{
+  // Element array plus object overhead
+  return path.elementCount() * static_cast<int>(sizeof(QPainterPath::Element)) + 64;
+}
+
 ApronGeometryCache::~ApronGeometryCache()
 {
   delete converter;
@@ -118,8 +124,8 @@ QPainterPath ApronGeometryCache::getApronGeometry(const map::MapApron& apron, fl
     // Move the whole path, so that the reference is at 0,0
     painterPath->translate(-refPoint.x(), -refPoint.y());
 
-    // Insert path with reference 0,0
-    geometryCache.insert(key, painterPath);
+    // Insert path with reference 0,0 - cost is the approximate size in bytes
+    geometryCache.insert(key, painterPath, pathCost(*painterPath));
 #endif
 
     // Return copy with correct position for drawing
@@ -51,6 +51,12 @@ public:
   /* Clear the cache */
   void clear();
 
+  /* Current size of all cached paths in bytes. For diagnostics. */
+  int getCacheSizeBytes() const
+  {
+    return geometryCache.totalCost();
+  }
+
   /* Has to be set before using it */
   void setViewportParams(const Marble::ViewportParams *viewport);
 
@@ -74,8 +80,12 @@ private:
   /* Calculate X-Plane aprons including bezier curves */
   QPainterPath pathForBoundary(const atools::fs::common::Boundary& boundaryNodes, bool fast);
 
-  /* Some airport have more than 100 apron parts */
-  static const int CACHE_SIZE = 2000;
+  /* Approximate heap size of a path in bytes used as cache cost */
+  static int pathCost(const QPainterPath& path);
+
+  /* Byte budget for cached paths. Some airports have more than 100 apron parts which
+   * can vary from a few points to thousands - evict by size and not by entry count. */
+  static const int CACHE_SIZE_BYTES = 4 * 1024 * 1024;
 
   /* Used to convert world to screen coordinates */
   CoordinateConverter *converter = nullptr;
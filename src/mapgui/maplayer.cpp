@@ -46,7 +46,8 @@ bool MapLayer::hasSameQueryParametersAirspace(const MapLayer *other) const
          layerAirspaceFirUir == other->layerAirspaceFirUir &&
          layerAirspaceRestricted == other->layerAirspaceRestricted &&
          layerAirspaceSpecial == other->layerAirspaceSpecial &&
-         layerAirspaceOther == other->layerAirspaceOther;
+         layerAirspaceOther == other->layerAirspaceOther &&
+         layerAirspaceLocal == other->layerAirspaceLocal;
 }
 
 bool MapLayer::hasSameQueryParametersAirwayTrack(const MapLayer *other) const
@@ -413,6 +414,12 @@ MapLayer& MapLayer::airspaceOther(bool value)
   return *this;
 }
 
+MapLayer& MapLayer::airspaceLocal(bool value)
+{
+  layerAirspaceLocal = value;
+  return *this;
+}
+
 MapLayer& MapLayer::aiAircraftLarge(bool value)
 {
   layerAiAircraftLarge = value;
@@ -176,6 +176,7 @@ public:
   MapLayer& airspaceRestricted(bool value = true);
   MapLayer& airspaceSpecial(bool value = true);
   MapLayer& airspaceOther(bool value = true);
+  MapLayer& airspaceLocal(bool value = true);
 
   MapLayer& aiAircraftGround(bool value = true);
   MapLayer& aiAircraftSmall(bool value = true);
@@ -511,6 +512,13 @@ public:
     return layerAirspaceOther;
   }
 
+  /* Small facilities like tower, ground, clearance, departure and approach. Mostly relevant for
+   * online centers which can appear by the thousands - kept to the closer zoom levels. */
+  bool isAirspaceLocal() const
+  {
+    return layerAirspaceLocal;
+  }
+
   bool isAiAircraftLarge() const
   {
     return layerAiAircraftLarge;
@@ -635,7 +643,8 @@ private:
   int maximumTextLengthUserpoint = 10;
 
   bool layerAirspaceCenter = false, layerAirspaceIcao = false, layerAirspaceFg = false, layerAirspaceFirUir = false,
-       layerAirspaceRestricted = false, layerAirspaceSpecial = false, layerAirspaceOther = false;
+       layerAirspaceRestricted = false, layerAirspaceSpecial = false, layerAirspaceOther = false,
+       layerAirspaceLocal = false;
 
   bool layerAiAircraftGround = false, layerAiAircraftLarge = false, layerAiAircraftSmall = false,
        layerOnlineAircraft = false, layerAiShipLarge = false, layerAiShipSmall = false,
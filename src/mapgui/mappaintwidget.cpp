@@ -24,8 +24,11 @@
 #include "route/route.h"
 #include "mapgui/mapscreenindex.h"
 #include "mapgui/maplayersettings.h"
+#include "common/constants.h"
+#include "common/perftrace.h"
 #include "common/unit.h"
 #include "common/aircrafttrack.h"
+#include "settings/settings.h"
 #include "mapgui/aprongeometrycache.h"
 
 #include <QPainter>
@@ -43,6 +46,12 @@ const static double MINIMUM_DISTANCE_KM = 0.1;
 const static double MAXIMUM_DISTANCE_KM = 6000.;
 const static int MAXIMUM_ZOOM = 1120;
 
+/* Debounce window collecting route change signals before updating indexes and caches once */
+const static int ROUTE_UPDATE_COALESCE_MS = 50;
+
+/* Default minimum interval between repaints from merged triggers - about 30 frames per second */
+const static int UPDATE_THROTTLE_INTERVAL_MS = 33;
+
 using namespace Marble;
 using atools::geo::Rect;
 using atools::geo::Pos;
@@ -64,9 +73,25 @@ MapPaintWidget::MapPaintWidget(QWidget *parent, bool visible)
 
   screenIndex = new MapScreenIndex(this, paintLayer);
 
+  routeUpdateTimer.setSingleShot(true);
+  routeUpdateTimer.setInterval(ROUTE_UPDATE_COALESCE_MS);
+  connect(&routeUpdateTimer, &QTimer::timeout, this, &MapPaintWidget::routeUpdateTimeout);
+
+  // Limit the repaint rate for merged redraw triggers - useful to lower further on big displays
+  updateThrottleIntervalMs = atools::settings::Settings::instance().
+                             getAndStoreValue(lnm::OPTIONS_MAP_UPDATE_THROTTLE_MS,
+                                              UPDATE_THROTTLE_INTERVAL_MS).toInt();
+  updateThrottleTimer.setSingleShot(true);
+  connect(&updateThrottleTimer, &QTimer::timeout, this, &MapPaintWidget::scheduledUpdateTimeout);
+
+  screenGeometryUpdateTimer.setSingleShot(true);
+  screenGeometryUpdateTimer.setInterval(0);
+  connect(&screenGeometryUpdateTimer, &QTimer::timeout, this, &MapPaintWidget::screenGeometryUpdateTimeout);
+
   const OptionData& options = OptionData::instance();
 
-  setSunShadingDimFactor(static_cast<double>(options.getDisplaySunShadingDimFactor()) / 100.);
+  appliedSunShadingDimFactor = static_cast<double>(options.getDisplaySunShadingDimFactor()) / 100.;
+  setSunShadingDimFactor(appliedSunShadingDimFactor);
   avoidBlurredMap = options.getFlags2() & opts2::MAP_AVOID_BLURRED_MAP;
 
   setFont(options.getMapFont());
@@ -131,13 +156,20 @@ void MapPaintWidget::copySettings(const MapPaintWidget& other)
   setShowOtherPlaces(other.showOtherPlaces());
   setShowIceLayer(other.showIceLayer());
 
-  // Adapt cache settings if changed
+  // Adapt cache settings if changed. Hidden widgets for the web server and image export get a
+  // fraction of the in-memory tile cache to avoid doubling the memory consumption - the
+  // persistent tile cache on disk is shared between all instances anyway.
+  quint64 volatileLimitKb = other.volatileTileCacheLimit();
+  if(!visibleWidget)
+    volatileLimitKb = std::max(volatileLimitKb / 4, static_cast<quint64>(10000L));
+
   if(model()->persistentTileCacheLimit() != other.model()->persistentTileCacheLimit())
     model()->setPersistentTileCacheLimit(other.model()->persistentTileCacheLimit());
-  if(volatileTileCacheLimit() != other.volatileTileCacheLimit())
-    setVolatileTileCacheLimit(other.volatileTileCacheLimit());
+  if(volatileTileCacheLimit() != volatileLimitKb)
+    setVolatileTileCacheLimit(volatileLimitKb);
 
-  setSunShadingDimFactor(static_cast<double>(OptionData::instance().getDisplaySunShadingDimFactor()) / 100.);
+  appliedSunShadingDimFactor = static_cast<double>(OptionData::instance().getDisplaySunShadingDimFactor()) / 100.;
+  setSunShadingDimFactor(appliedSunShadingDimFactor);
 
   // Copy own/internal settings
   currentThemeIndex = other.currentThemeIndex;
@@ -243,19 +275,28 @@ void MapPaintWidget::optionsChanged()
 
   unitsUpdated();
 
-  // Updated sun shadow and force a tile refresh by changing the show status again
-  setSunShadingDimFactor(static_cast<double>(options.getDisplaySunShadingDimFactor()) / 100.);
-  setShowSunShading(showSunShading());
+  // Apply the sun shadow and tile refresh only for a real change - the forced refresh
+  // rebuilds the whole map and is far too expensive for unrelated option changes
+  // Exact comparison is sufficient since the value is derived from the same integer option
+  double dimFactor = static_cast<double>(options.getDisplaySunShadingDimFactor()) / 100.;
+  if(dimFactor != appliedSunShadingDimFactor)
+  {
+    appliedSunShadingDimFactor = dimFactor;
+
+    // Updated sun shadow and force a tile refresh by changing the show status again
+    setSunShadingDimFactor(dimFactor);
+    setShowSunShading(showSunShading());
+  }
   avoidBlurredMap = options.getFlags2() & opts2::MAP_AVOID_BLURRED_MAP;
 
   // reloadMap();
   updateCacheSizes();
-  update();
+  scheduleUpdate();
 }
 
 void MapPaintWidget::styleChanged()
 {
-  update();
+  scheduleUpdate();
 }
 
 void MapPaintWidget::updateCacheSizes()
@@ -283,14 +324,46 @@ void MapPaintWidget::setShowMapSunShading(bool show)
 void MapPaintWidget::weatherUpdated()
 {
   if(paintLayer->getShownMapObjects() | map::AIRPORT_WEATHER)
-    update();
+    scheduleUpdate();
 }
 
 void MapPaintWidget::windUpdated()
 {
   if(paintLayer->getShownMapObjectDisplayTypes() | map::WIND_BARBS ||
      paintLayer->getShownMapObjectDisplayTypes() | map::WIND_BARBS_ROUTE)
+    scheduleUpdate();
+}
+
+void MapPaintWidget::scheduleUpdate()
+{
+  // Shows each trigger in relation to the merged paints in the trace
+  perftrace::instant("map redraw trigger");
+
+  if(updateThrottleTimer.isActive())
+    // A repaint is already pending - this trigger is merged into it
+    return;
+
+  qint64 now = QDateTime::currentMSecsSinceEpoch();
+  if(now - lastScheduledUpdateMs >= updateThrottleIntervalMs)
+  {
+    // Last repaint is long enough ago - paint right away
+    lastScheduledUpdateMs = now;
     update();
+  }
+  else
+    // Too early - postpone and collect all further triggers until the interval has passed
+    updateThrottleTimer.start(static_cast<int>(updateThrottleIntervalMs - (now - lastScheduledUpdateMs)));
+}
+
+void MapPaintWidget::scheduledUpdateTimeout()
+{
+  lastScheduledUpdateMs = QDateTime::currentMSecsSinceEpoch();
+  update();
+}
+
+void MapPaintWidget::screenGeometryUpdateTimeout()
+{
+  screenIndex->updateAllGeometry(currentViewBoundingBox);
 }
 
 map::MapWeatherSource MapPaintWidget::getMapWeatherSource() const
@@ -309,7 +382,7 @@ void MapPaintWidget::setSunShadingDateTime(const QDateTime& datetime)
   {
     // Update only if difference more than 5 minutes
     model()->setClockDateTime(datetime);
-    update();
+    scheduleUpdate();
   }
 }
 
@@ -439,7 +512,7 @@ void MapPaintWidget::postDatabaseLoad()
   databaseLoadStatus = false;
   paintLayer->postDatabaseLoad();
   screenIndex->updateAllGeometry(getCurrentViewBoundingBox());
-  update();
+  scheduleUpdate();
   updateMapVisibleUi();
 }
 
@@ -778,7 +851,7 @@ void MapPaintWidget::showAircraft(bool centerAircraftChecked)
 void MapPaintWidget::changeRouteHighlights(const QList<int>& routeHighlight)
 {
   screenIndex->setRouteHighlights(routeHighlight);
-  update();
+  scheduleUpdate();
 }
 
 void MapPaintWidget::routeChanged(bool geometryChanged)
@@ -788,9 +861,12 @@ void MapPaintWidget::routeChanged(bool geometryChanged)
   if(geometryChanged)
   {
     cancelDragAll();
-    screenIndex->updateRouteScreenGeometry(getCurrentViewBoundingBox());
+    routeUpdateGeometry = true;
   }
-  update();
+
+  // Only collect the work and repaint - routeUpdateTimeout runs it once for the whole burst
+  routeUpdateTimer.start();
+  scheduleUpdate();
 }
 
 void MapPaintWidget::routeAltitudeChanged(float altitudeFeet)
@@ -801,15 +877,36 @@ void MapPaintWidget::routeAltitudeChanged(float altitudeFeet)
     return;
 
   qDebug() << Q_FUNC_INFO;
-  screenIndex->updateAirspaceScreenGeometry(getCurrentViewBoundingBox());
-  update();
+  routeUpdateAirspaces = true;
+  routeUpdateTimer.start();
+  scheduleUpdate();
+}
+
+void MapPaintWidget::routeUpdateTimeout()
+{
+  if(databaseLoadStatus)
+    // Keep the pending flags - the indexes are rebuilt after loading anyway
+    return;
+
+  if(routeUpdateGeometry)
+    screenIndex->updateRouteScreenGeometry(getCurrentViewBoundingBox());
+
+  if(routeUpdateAirspaces)
+  {
+    // Altitude changes the airspaces shown at flight plan altitude
+    screenIndex->updateAirspaceScreenGeometry(getCurrentViewBoundingBox());
+    paintLayer->invalidateStaticPaintCache();
+  }
+
+  routeUpdateGeometry = routeUpdateAirspaces = false;
+  scheduleUpdate();
 }
 
 void MapPaintWidget::connectedToSimulator()
 {
   qDebug() << Q_FUNC_INFO;
   jumpBackToAircraftCancel();
-  update();
+  scheduleUpdate();
 }
 
 void MapPaintWidget::disconnectedFromSimulator()
@@ -819,7 +916,7 @@ void MapPaintWidget::disconnectedFromSimulator()
   screenIndex->updateSimData(atools::fs::sc::SimConnectData());
   updateMapVisibleUi();
   jumpBackToAircraftCancel();
-  update();
+  scheduleUpdate();
 }
 
 bool MapPaintWidget::addKmlFile(const QString& kmlFile)
@@ -854,21 +951,23 @@ void MapPaintWidget::clearSearchHighlights()
 
   screenIndex->updateLogEntryScreenGeometry(getCurrentViewBoundingBox());
   screenIndex->updateAirspaceScreenGeometry(getCurrentViewBoundingBox());
-  update();
+  paintLayer->invalidateStaticPaintCache();
+  scheduleUpdate();
 }
 
 void MapPaintWidget::clearAirspaceHighlights()
 {
   screenIndex->changeAirspaceHighlights(QList<map::MapAirspace>());
   screenIndex->updateAirspaceScreenGeometry(getCurrentViewBoundingBox());
-  update();
+  paintLayer->invalidateStaticPaintCache();
+  scheduleUpdate();
 }
 
 void MapPaintWidget::clearAirwayHighlights()
 {
   screenIndex->changeAirwayHighlights(QList<QList<map::MapAirway> >());
   screenIndex->updateAirwayScreenGeometry(getCurrentViewBoundingBox());
-  update();
+  scheduleUpdate();
 }
 
 bool MapPaintWidget::hasHighlights() const
@@ -916,7 +1015,7 @@ void MapPaintWidget::changeApproachHighlight(const proc::MapProcedureLegs& appro
   cancelDragAll();
   screenIndex->getProcedureHighlight() = approach;
   screenIndex->updateRouteScreenGeometry(getCurrentViewBoundingBox());
-  update();
+  scheduleUpdate();
 }
 
 /* Also clicked airspaces in the info window */
@@ -924,7 +1023,8 @@ void MapPaintWidget::changeAirspaceHighlights(const QList<map::MapAirspace>& air
 {
   screenIndex->changeAirspaceHighlights(airspaces);
   screenIndex->updateAirspaceScreenGeometry(getCurrentViewBoundingBox());
-  update();
+  paintLayer->invalidateStaticPaintCache();
+  scheduleUpdate();
 }
 
 /* Also clicked airways in the info window */
@@ -932,7 +1032,7 @@ void MapPaintWidget::changeAirwayHighlights(const QList<QList<map::MapAirway> >&
 {
   screenIndex->changeAirwayHighlights(airways);
   screenIndex->updateAirwayScreenGeometry(getCurrentViewBoundingBox());
-  update();
+  scheduleUpdate();
 }
 
 void MapPaintWidget::updateLogEntryScreenGeometry()
@@ -948,13 +1048,14 @@ void MapPaintWidget::changeSearchHighlights(const map::MapResult& newHighlights,
     screenIndex->updateLogEntryScreenGeometry(getCurrentViewBoundingBox());
   if(updateAirspace)
     screenIndex->updateAirspaceScreenGeometry(getCurrentViewBoundingBox());
-  update();
+  paintLayer->invalidateStaticPaintCache();
+  scheduleUpdate();
 }
 
 void MapPaintWidget::changeProcedureLegHighlights(const proc::MapProcedureLeg *leg)
 {
   screenIndex->setApproachLegHighlights(leg);
-  update();
+  scheduleUpdate();
 }
 
 void MapPaintWidget::changeProfileHighlight(const atools::geo::Pos& pos)
@@ -962,7 +1063,7 @@ void MapPaintWidget::changeProfileHighlight(const atools::geo::Pos& pos)
   if(pos != screenIndex->getProfileHighlight())
   {
     screenIndex->setProfileHighlight(pos);
-    update();
+    scheduleUpdate();
   }
 }
 
@@ -1042,17 +1143,18 @@ const QList<int>& MapPaintWidget::getRouteHighlights() const
 
 const QList<map::RangeMarker>& MapPaintWidget::getRangeRings() const
 {
-  return screenIndex->getRangeMarks();
+  // Use the const accessors to avoid marking the categories as changed for saving
+  return getScreenIndexConst()->getRangeMarks();
 }
 
 const QList<map::DistanceMarker>& MapPaintWidget::getDistanceMarkers() const
 {
-  return screenIndex->getDistanceMarks();
+  return getScreenIndexConst()->getDistanceMarks();
 }
 
 const QList<map::TrafficPattern>& MapPaintWidget::getTrafficPatterns() const
 {
-  return screenIndex->getTrafficPatterns();
+  return getScreenIndexConst()->getTrafficPatterns();
 }
 
 QList<map::TrafficPattern>& MapPaintWidget::getTrafficPatterns()
@@ -1062,7 +1164,7 @@ QList<map::TrafficPattern>& MapPaintWidget::getTrafficPatterns()
 
 const QList<map::Hold>& MapPaintWidget::getHolds() const
 {
-  return screenIndex->getHolds();
+  return getScreenIndexConst()->getHolds();
 }
 
 QList<map::Hold>& MapPaintWidget::getHolds()
@@ -1147,9 +1249,11 @@ void MapPaintWidget::paintEvent(QPaintEvent *paintEvent)
 
   if(changed)
   {
-    // Major change - update index and visible objects
+    // Major change - update visible objects now but rebuild the screen index right after the
+    // event instead of inside it. The frame with the new view appears without waiting for the
+    // geometry updates which removes the stutter at the end of a pan or zoom gesture.
     updateMapVisibleUi();
-    screenIndex->updateAllGeometry(currentViewBoundingBox);
+    screenGeometryUpdateTimer.start();
   }
 
   if(paintLayer->getOverflow() > 0)
@@ -1172,12 +1276,12 @@ bool MapPaintWidget::loadKml(const QString& filename, bool center)
 void MapPaintWidget::onlineClientAndAtcUpdated()
 {
   screenIndex->updateAirspaceScreenGeometry(currentViewBoundingBox);
-  update();
+  scheduleUpdate();
 }
 
 void MapPaintWidget::onlineNetworkChanged()
 {
   screenIndex->resetAirspaceOnlineScreenGeometry();
   screenIndex->updateAirspaceScreenGeometry(currentViewBoundingBox);
-  update();
+  scheduleUpdate();
 }
@@ -23,6 +23,8 @@
 #include <marble/GeoDataLatLonAltBox.h>
 #include <marble/MarbleWidget.h>
 
+#include <QTimer>
+
 namespace atools {
 
 namespace fs {
@@ -92,7 +94,7 @@ public:
   void changeApproachHighlight(const proc::MapProcedureLegs& approach);
 
   /* Update route screen coordinate index */
-  void routeChanged(bool geometryChanged);
+  virtual void routeChanged(bool geometryChanged);
   void routeAltitudeChanged(float altitudeFeet);
 
   /* Stop showing aircraft position on map */
@@ -158,7 +160,7 @@ public:
   void styleChanged();
 
   /* Update map */
-  void postDatabaseLoad();
+  virtual void postDatabaseLoad();
 
   /* Set map theme.
    * @param theme filename of the map theme
@@ -209,6 +211,11 @@ public:
   /* Redraw map to reflect wind barb changes */
   void windUpdated();
 
+  /* Request a repaint like update() but merge bursts of triggers from options, weather, route,
+   * highlight and other state changes into one paint per frame interval. Paints immediately if
+   * the last repaint is old enough, otherwise postpones until the interval has passed. */
+  void scheduleUpdate();
+
   /* Current weather source for icon display */
   map::MapWeatherSource getMapWeatherSource() const;
 
@@ -319,6 +326,12 @@ public:
     return screenIndex;
   }
 
+  /* Layer stack used for painting. Needed by the web API to select feature detail levels. */
+  MapPaintLayer *getMapPaintLayer()
+  {
+    return paintLayer;
+  }
+
   /* Saved bounding box from last zoom or scroll operation. Needed to detect view changes. */
   const Marble::GeoDataLatLonBox& getCurrentViewBoundingBox() const;
 
@@ -441,6 +454,10 @@ protected:
   /* Zoom one step out to avoid blurred maps */
   bool avoidBlurredMap = false;
 
+  /* Last applied sun shading dim factor. Used to skip the forced tile refresh in
+   * optionsChanged when the setting did not change. -1. if never applied. */
+  double appliedSunShadingDimFactor = -1.;
+
   /* true if real window/widget */
   bool visibleWidget = false;
 
@@ -462,6 +479,29 @@ private:
 
   void unitsUpdated();
 
+  /* Execute the collected index and cache updates once for a burst of route change signals */
+  void routeUpdateTimeout();
+
+  /* Run the repaint postponed by scheduleUpdate() */
+  void scheduledUpdateTimeout();
+
+  /* Rebuild the screen index geometry after a view change was painted */
+  void screenGeometryUpdateTimeout();
+
+  /* Coalesces the expensive parts of routeChanged and routeAltitudeChanged. A single flight
+   * plan edit fires several change signals through the main window within a short time. */
+  QTimer routeUpdateTimer;
+  bool routeUpdateGeometry = false, routeUpdateAirspaces = false;
+
+  /* Limits the repaint rate of scheduleUpdate(). Interval is configurable in the settings file. */
+  QTimer updateThrottleTimer;
+  qint64 lastScheduledUpdateMs = 0;
+  int updateThrottleIntervalMs = 0;
+
+  /* Defers the screen index rebuild out of the paint event after panning or zooming so the
+   * frame showing the new view is not blocked by the geometry updates. */
+  QTimer screenGeometryUpdateTimer;
+
   /* Keeps geographical objects as index in screen coordinates */
   MapScreenIndex *screenIndex = nullptr;
 
@@ -36,6 +36,11 @@
 #include "airspace/airspacecontroller.h"
 
 #include <marble/GeoDataLineString.h>
+#include <marble/ViewportParams.h>
+
+#include <QtConcurrent/QtConcurrentRun>
+#include <QElapsedTimer>
+#include <QFuture>
 
 using atools::geo::Pos;
 using atools::geo::Line;
@@ -45,6 +50,10 @@ using map::MapAirway;
 using Marble::GeoDataLineString;
 using Marble::GeoDataCoordinates;
 
+/* Airway and ILS screen geometry is kept this factor beyond the visible screen so pure pans
+ * in the Mercator projection can reuse it by translation until the margin is used up */
+static const double SCREEN_GEOMETRY_INFLATE = 0.25;
+
 MapScreenIndex::MapScreenIndex(MapPaintWidget *mapPaintWidgetParam, MapPaintLayer *mapPaintLayer)
   : mapPaintWidget(mapPaintWidgetParam), paintLayer(mapPaintLayer)
 {
@@ -55,6 +64,10 @@ MapScreenIndex::MapScreenIndex(MapPaintWidget *mapPaintWidgetParam, MapPaintLaye
   searchHighlights = new map::MapResult;
   approachLegHighlights = new proc::MapProcedureLeg;
   approachHighlight = new proc::MapProcedureLegs;
+
+  // Start with empty snapshots so the getters can always dereference
+  simData = QSharedPointer<const atools::fs::sc::SimConnectData>::create();
+  lastSimData = QSharedPointer<const atools::fs::sc::SimConnectData>::create();
 }
 
 MapScreenIndex::~MapScreenIndex()
@@ -86,10 +99,15 @@ void MapScreenIndex::copy(const MapScreenIndex& other)
   ilsLines = other.ilsLines;
   routePoints = other.routePoints;
   routePointsAll = other.routePointsAll;
+
+  // Grids refer to the list indexes of the copied highlights - rebuild for this widget's view
+  updateSearchHighlightScreenGeometry();
 }
 
-void MapScreenIndex::updateAirspaceScreenGeometryInternal(QSet<map::MapAirspaceId>& ids, map::MapAirspaceSources source,
-                                                          const Marble::GeoDataLatLonBox& curBox, bool highlights)
+void MapScreenIndex::fetchAirspacesInternal(QVector<std::pair<map::MapAirspaceId,
+                                                              const atools::geo::LineString *> >& airspaceGeometries,
+                                            QSet<map::MapAirspaceId>& ids, const Marble::GeoDataLatLonBox& curBox,
+                                            bool highlights) const
 {
   const MapScale *scale = paintLayer->getMapScale();
   AirspaceController *controller = NavApp::getAirspaceController();
@@ -102,7 +120,8 @@ void MapScreenIndex::updateAirspaceScreenGeometryInternal(QSet<map::MapAirspaceI
     if(!highlights && paintLayer->getShownMapObjects().testFlag(map::AIRSPACE))
       controller->getAirspaces(airspaces,
                                curBox, paintLayer->getMapLayer(), mapPaintWidget->getShownAirspaceTypesByLayer(),
-                               NavApp::getRouteConst().getCruisingAltitudeFeet(), false, source);
+                               NavApp::getRouteConst().getCruisingAltitudeFeet(), false,
+                               controller->getAirspaceSources());
 
     // Get highlighted airspaces from info window ================================
     for(const map::MapAirspace& airspace : airspaceHighlights)
@@ -123,25 +142,38 @@ void MapScreenIndex::updateAirspaceScreenGeometryInternal(QSet<map::MapAirspaceI
       // Check if airspace overlaps with current screen and is not already in list
       if(airspacebox.intersects(curBox) && !ids.contains(airspace->combinedId()))
       {
-
         const atools::geo::LineString *lines = controller->getAirspaceGeometry(airspace->combinedId());
         if(lines != nullptr)
         {
-          QVector<QPolygonF> polygons = conv.wToS(*lines);
-
-          for(const QPolygonF& poly : polygons)
-          {
-            // Cut off all polygon parts that are not visible on screen
-            airspacePolygons.append(std::make_pair(airspace->combinedId(),
-                                                   poly.intersected(QPolygon(mapPaintWidget->rect())).toPolygon()));
-            ids.insert(airspace->combinedId());
-          }
+          airspaceGeometries.append(std::make_pair(airspace->combinedId(), lines));
+          ids.insert(airspace->combinedId());
         }
       }
     }
   }
 }
 
+void MapScreenIndex::fetchAirspaces(QVector<std::pair<map::MapAirspaceId,
+                                                      const atools::geo::LineString *> >& airspaceGeometries,
+                                    const Marble::GeoDataLatLonBox& curBox) const
+{
+  if(paintLayer != nullptr && paintLayer->getMapLayer() != nullptr)
+  {
+    // Use ID set to check for duplicates between calls
+    QSet<map::MapAirspaceId> ids;
+
+    // First get geometry from highlights
+    fetchAirspacesInternal(airspaceGeometries, ids, curBox, true);
+
+    if(paintLayer->getMapLayer()->isAirspace() && paintLayer->getShownMapObjects().testFlag(map::AIRSPACE) &&
+       !paintLayer->getMapLayerEffective()->isAirportDiagram() &&
+       // Do not put into index if nothing is drawn
+       mapPaintWidget->distance() < layer::DISTANCE_CUT_OFF_LIMIT)
+      // Get geometry from visible airspaces
+      fetchAirspacesInternal(airspaceGeometries, ids, curBox, false);
+  }
+}
+
 void MapScreenIndex::resetAirspaceOnlineScreenGeometry()
 {
   // Clear internal caches
@@ -156,87 +188,195 @@ void MapScreenIndex::resetIlsScreenGeometry()
 
 void MapScreenIndex::updateAirspaceScreenGeometry(const Marble::GeoDataLatLonBox& curBox)
 {
-  airspacePolygons.clear();
-  if(paintLayer == nullptr || paintLayer->getMapLayer() == nullptr)
-    return;
+  QVector<std::pair<map::MapAirspaceId, const atools::geo::LineString *> > airspaceGeometries;
+  fetchAirspaces(airspaceGeometries, curBox);
+  updateAirspaceScreenGeometry(airspaceGeometries);
+}
 
-  // Use ID set to check for duplicates between calls
-  QSet<map::MapAirspaceId> ids;
+void MapScreenIndex::updateAirspaceScreenGeometry(const QVector<std::pair<map::MapAirspaceId,
+                                                                          const atools::geo::LineString *> >&
+                                                  airspaceGeometries)
+{
+  // Build into a local buffer and swap at the end so this can run concurrently
+  // to other geometry rebuilds without exposing a half-filled list
+  QVector<AirspacePolygon> polygons;
 
-  // First get geometry from highlights
-  updateAirspaceScreenGeometryInternal(ids, NavApp::getAirspaceController()->getAirspaceSources(), curBox, true);
+  CoordinateConverter conv(mapPaintWidget->viewport());
+  for(const std::pair<map::MapAirspaceId, const atools::geo::LineString *>& geometry : airspaceGeometries)
+  {
+    for(const QPolygonF& poly : conv.wToS(*geometry.second))
+    {
+      // Cut off all polygon parts that are not visible on screen
+      QPolygon screenPoly = poly.intersected(QPolygon(mapPaintWidget->rect())).toPolygon();
+      polygons.append({geometry.first, screenPoly.boundingRect(), screenPoly});
+    }
+  }
 
-  if(!paintLayer->getMapLayer()->isAirspace() || !paintLayer->getShownMapObjects().testFlag(map::AIRSPACE))
-    return;
+  airspacePolygons = polygons;
+}
 
-  if(paintLayer->getMapLayerEffective()->isAirportDiagram())
-    return;
+bool MapScreenIndex::checkPanDelta(GeometryPanState& state, QPoint& delta) const
+{
+  const Marble::ViewportParams *viewport = mapPaintWidget->viewport();
+  Pos center(atools::geo::toDegree(viewport->centerLongitude()),
+             atools::geo::toDegree(viewport->centerLatitude()));
+
+  bool reuse = false;
+  if(viewport->projection() == Marble::Mercator && state.center.isValid() &&
+     state.layer == paintLayer->getMapLayer() && state.shownTypes == paintLayer->getShownMapObjects() &&
+     state.radius == viewport->radius())
+  {
+    // Project the center of the last update into the new viewport. A pure pan moves all
+    // screen coordinates by the same amount in the Mercator projection.
+    CoordinateConverter conv(viewport);
+    int x, y;
+    bool hidden;
+    if(conv.wToS(state.center, x, y, CoordinateConverter::DEFAULT_WTOS_SIZE, &hidden) && !hidden)
+    {
+      delta = QPoint(x - viewport->width() / 2, y - viewport->height() / 2);
 
-  // Do not put into index if nothing is drawn
-  if(mapPaintWidget->distance() >= layer::DISTANCE_CUT_OFF_LIMIT)
-    return;
+      // Force a full rebuild once the accumulated movement leaves the inflated
+      // rectangle the geometry was built with
+      QPoint total = state.offset + delta;
+      if(std::abs(total.x()) < viewport->width() * SCREEN_GEOMETRY_INFLATE &&
+         std::abs(total.y()) < viewport->height() * SCREEN_GEOMETRY_INFLATE)
+      {
+        state.offset = total;
+        reuse = true;
+      }
+    }
+  }
+
+  if(!reuse)
+    state.offset = QPoint();
 
-  // Get geometry from visible airspaces
-  updateAirspaceScreenGeometryInternal(ids, NavApp::getAirspaceController()->getAirspaceSources(), curBox, false);
+  state.center = center;
+  state.layer = paintLayer->getMapLayer();
+  state.shownTypes = paintLayer->getShownMapObjects();
+  state.radius = viewport->radius();
+  return reuse;
 }
 
-void MapScreenIndex::updateIlsScreenGeometry(const Marble::GeoDataLatLonBox& curBox)
+const QList<map::MapIls> *MapScreenIndex::fetchIls(const Marble::GeoDataLatLonBox& curBox) const
 {
-  resetIlsScreenGeometry();
+  if(paintLayer != nullptr && paintLayer->getMapLayer() != nullptr && paintLayer->getMapScale()->isValid() &&
+     paintLayer->getMapLayer()->isIls() && paintLayer->getShownMapObjects().testFlag(map::ILS) &&
+     // Do not put into index if nothing is drawn
+     mapPaintWidget->distance() < layer::DISTANCE_CUT_OFF_LIMIT)
+    return mapQuery->getIls(curBox, paintLayer->getMapLayer(), false);
 
-  if(paintLayer == nullptr || paintLayer->getMapLayer() == nullptr)
-    return;
+  return nullptr;
+}
 
-  if(!paintLayer->getMapLayer()->isIls() || !paintLayer->getShownMapObjects().testFlag(map::ILS))
-    return;
+void MapScreenIndex::updateIlsScreenGeometry(const Marble::GeoDataLatLonBox& curBox)
+{
+  updateIlsScreenGeometry(fetchIls(curBox), curBox);
+}
 
-  // Do not put into index if nothing is drawn
-  if(mapPaintWidget->distance() >= layer::DISTANCE_CUT_OFF_LIMIT)
-    return;
+void MapScreenIndex::updateIlsScreenGeometry(const QList<map::MapIls> *ilsList, const Marble::GeoDataLatLonBox& curBox)
+{
+  // Build into local buffers and swap at the end so this can run concurrently
+  // to other geometry rebuilds without exposing half-filled lists
+  QVector<std::pair<int, QPolygon> > polygons;
+  QVector<std::pair<int, QLine> > lines;
 
-  if(paintLayer->getShownMapObjects().testFlag(map::ILS))
+  if(ilsList != nullptr)
   {
     const MapScale *scale = paintLayer->getMapScale();
 
     if(scale->isValid())
     {
-      const QList<map::MapIls> *ilsList = mapQuery->getIls(curBox, paintLayer->getMapLayer(), false);
+      // Shift the already projected geometry if the viewport only panned and remember the ids.
+      // Only ILS entering the viewport are projected below then.
+      QSet<int> retainedIds;
+      QPoint delta;
+      if(checkPanDelta(ilsPanState, delta))
+      {
+        for(std::pair<int, QPolygon> polygon : ilsPolygons)
+        {
+          polygon.second.translate(delta);
+          polygons.append(polygon);
+          retainedIds.insert(polygon.first);
+        }
+
+        for(std::pair<int, QLine> line : ilsLines)
+        {
+          line.second.translate(delta);
+          lines.append(line);
+          retainedIds.insert(line.first);
+        }
+      }
+
+      CoordinateConverter conv(mapPaintWidget->viewport());
+
+      // Clip to a larger rectangle than the screen so the geometry stays complete while panning
+      QRect clipRect = mapPaintWidget->rect();
+      clipRect.adjust(-clipRect.width() / 4, -clipRect.height() / 4,
+                      clipRect.width() / 4, clipRect.height() / 4);
 
-      if(ilsList != nullptr)
+      for(const map::MapIls& ils : *ilsList)
       {
-        CoordinateConverter conv(mapPaintWidget->viewport());
-        for(const map::MapIls& ils : *ilsList)
+        if(retainedIds.contains(ils.id))
+          continue;
+
+        Marble::GeoDataLatLonBox ilsbox(ils.bounding.getNorth(), ils.bounding.getSouth(),
+                                        ils.bounding.getEast(), ils.bounding.getWest(),
+                                        Marble::GeoDataCoordinates::Degree);
+
+        if(ilsbox.intersects(curBox))
         {
-          Marble::GeoDataLatLonBox ilsbox(ils.bounding.getNorth(), ils.bounding.getSouth(),
-                                          ils.bounding.getEast(), ils.bounding.getWest(),
-                                          Marble::GeoDataCoordinates::Degree);
+          updateLineScreenGeometry(lines, ils.id, ils.centerLine(), curBox, conv);
 
-          if(ilsbox.intersects(curBox))
+          QPolygon polygon;
+          bool hidden;
+          for(const Pos& pos : ils.boundary())
           {
-            updateLineScreenGeometry(ilsLines, ils.id, ils.centerLine(), curBox, conv);
-
-            QPolygon polygon;
-            bool hidden;
-            for(const Pos& pos : ils.boundary())
-            {
-              int xs, ys;
-              conv.wToS(pos, xs, ys, CoordinateConverter::DEFAULT_WTOS_SIZE, &hidden);
-              if(!hidden)
-                polygon.append(QPoint(xs, ys));
-            }
-            polygon = polygon.intersected(QPolygon(mapPaintWidget->rect()));
-            if(!polygon.isEmpty())
-              ilsPolygons.append(std::make_pair(ils.id, polygon));
+            int xs, ys;
+            conv.wToS(pos, xs, ys, CoordinateConverter::DEFAULT_WTOS_SIZE, &hidden);
+            if(!hidden)
+              polygon.append(QPoint(xs, ys));
           }
+          polygon = polygon.intersected(QPolygon(clipRect));
+          if(!polygon.isEmpty())
+            polygons.append(std::make_pair(ils.id, polygon));
         }
       }
     }
   }
+
+  ilsPolygons = polygons;
+  ilsLines = lines;
+}
+
+void MapScreenIndex::fetchLogEntryRouteGeometry(QVector<const atools::geo::LineString *>& routeGeometries) const
+{
+  if(!paintLayer->getMapScale()->isValid())
+    return;
+
+  map::MapObjectDisplayTypes types = paintLayer->getShownMapObjectDisplayTypes();
+  for(const map::MapLogbookEntry& entry : searchHighlights->logbookEntries)
+  {
+    // Get geometry for flight plan if preview is enabled
+    const atools::geo::LineString *geo = nullptr;
+    if(entry.isValid() && types.testFlag(map::LOGBOOK_ROUTE))
+      geo = NavApp::getLogdataController()->getRouteGeometry(entry.id);
+    routeGeometries.append(geo);
+  }
 }
 
 void MapScreenIndex::updateLogEntryScreenGeometry(const Marble::GeoDataLatLonBox& curBox)
 {
-  logEntryLines.clear();
+  QVector<const atools::geo::LineString *> routeGeometries;
+  fetchLogEntryRouteGeometry(routeGeometries);
+  updateLogEntryScreenGeometry(routeGeometries, curBox);
+}
+
+void MapScreenIndex::updateLogEntryScreenGeometry(const QVector<const atools::geo::LineString *>& routeGeometries,
+                                                  const Marble::GeoDataLatLonBox& curBox)
+{
+  // Build into a local buffer and swap at the end so this can run concurrently
+  // to other geometry rebuilds without exposing a half-filled list
+  QVector<std::pair<int, QLine> > lines;
 
   const MapScale *scale = paintLayer->getMapScale();
 
@@ -247,48 +387,102 @@ void MapScreenIndex::updateLogEntryScreenGeometry(const Marble::GeoDataLatLonBox
     if(types.testFlag(map::LOGBOOK_DIRECT) || types.testFlag(map::LOGBOOK_ROUTE))
     {
       CoordinateConverter conv(mapPaintWidget->viewport());
-      for(map::MapLogbookEntry& entry : searchHighlights->logbookEntries)
+      for(int entryIdx = 0; entryIdx < searchHighlights->logbookEntries.size(); entryIdx++)
       {
+        const map::MapLogbookEntry& entry = searchHighlights->logbookEntries.at(entryIdx);
         if(entry.isValid())
         {
           if(types.testFlag(map::LOGBOOK_DIRECT))
-            updateLineScreenGeometry(logEntryLines, entry.id, entry.line(), curBox, conv);
+            updateLineScreenGeometry(lines, entry.id, entry.line(), curBox, conv);
 
-          if(types.testFlag(map::LOGBOOK_ROUTE))
+          // Geometry was prefetched if present and the flight plan preview is enabled
+          const atools::geo::LineString *geo = routeGeometries.value(entryIdx, nullptr);
+          if(geo != nullptr)
           {
-            // Get geometry for flight plan if preview is enabled
-            const atools::geo::LineString *geo = NavApp::getLogdataController()->getRouteGeometry(entry.id);
-            if(geo != nullptr)
-            {
-              for(int i = 0; i < geo->size() - 1; i++)
-                updateLineScreenGeometry(logEntryLines, entry.id, Line(geo->at(i), geo->at(i + 1)), curBox, conv);
-            }
+            for(int i = 0; i < geo->size() - 1; i++)
+              updateLineScreenGeometry(lines, entry.id, Line(geo->at(i), geo->at(i + 1)), curBox, conv);
           }
         }
       }
     }
   }
+
+  logEntryLines = lines;
 }
 
-void MapScreenIndex::updateAirwayScreenGeometry(const Marble::GeoDataLatLonBox& curBox)
+void MapScreenIndex::fetchAirways(QList<map::MapAirway>& airways, QList<map::MapAirway>& tracks,
+                                  const Marble::GeoDataLatLonBox& curBox) const
 {
-  if(paintLayer == nullptr || paintLayer->getMapLayer() == nullptr)
+  if(paintLayer == nullptr || paintLayer->getMapLayer() == nullptr || !paintLayer->getMapScale()->isValid())
     return;
 
-  airwayLines.clear();
+  bool showJet = paintLayer->getShownMapObjects().testFlag(map::AIRWAYJ);
+  bool showVictor = paintLayer->getShownMapObjects().testFlag(map::AIRWAYV);
+  if(paintLayer->getMapLayer()->isAirway() && (showJet || showVictor))
+    // Airways are visible on map - get them from the cache/database
+    airwayQuery->getAirways(airways, curBox, paintLayer->getMapLayer(), false);
 
-  // Use ID set to check for duplicates between calls
-  QSet<int> ids;
+  if(paintLayer->getMapLayer()->isTrack() && paintLayer->getShownMapObjects().testFlag(map::TRACK))
+    airwayQuery->getTracks(tracks, curBox, paintLayer->getMapLayer(), false);
+}
+
+void MapScreenIndex::updateAirwayScreenGeometry(const Marble::GeoDataLatLonBox& curBox)
+{
+  QList<map::MapAirway> airways, tracks;
+  fetchAirways(airways, tracks, curBox);
+  updateAirwayScreenGeometry(airways, tracks, curBox);
+}
+
+void MapScreenIndex::updateAirwayScreenGeometry(const QList<map::MapAirway>& airways,
+                                                const QList<map::MapAirway>& tracks,
+                                                const Marble::GeoDataLatLonBox& curBox)
+{
+  // Build into a local buffer and swap at the end so this can run concurrently
+  // to other geometry rebuilds without exposing a half-filled list
+  QVector<std::pair<int, QLine> > lines;
+  QSet<int> screenIds;
+
+  if(paintLayer != nullptr && paintLayer->getMapLayer() != nullptr)
+  {
+    // Use ID set to check for duplicates between calls
+    QSet<int> ids;
 
-  // First get geometry from highlights
-  updateAirwayScreenGeometryInternal(ids, curBox, true /* highlight */);
+    // First get geometry from highlights - these change independently of the viewport
+    // and are always projected freshly
+    updateAirwayScreenGeometryInternal(lines, ids, airways, tracks, curBox, true /* highlight */);
+    QSet<int> highlightIds = ids;
 
-  // Get geometry from visible airspaces
-  updateAirwayScreenGeometryInternal(ids, curBox, false /* highlight */);
+    QPoint delta;
+    if(checkPanDelta(airwayPanState, delta))
+    {
+      // Viewport only panned - shift the retained non-highlight geometry so the
+      // projection below only has to handle airways entering the viewport
+      for(std::pair<int, QLine> line : airwayLines)
+      {
+        if(!airwayScreenIds.contains(line.first) || ids.contains(line.first))
+          // Was a highlight entry or is highlighted now - already rebuilt above
+          continue;
+
+        line.second.translate(delta);
+        lines.append(line);
+        ids.insert(line.first);
+      }
+    }
+
+    // Get geometry from visible airways and tracks not retained above
+    updateAirwayScreenGeometryInternal(lines, ids, airways, tracks, curBox, false /* highlight */);
+
+    screenIds = ids - highlightIds;
+  }
+
+  airwayLines = lines;
+  airwayScreenIds = screenIds;
 }
 
-void MapScreenIndex::updateAirwayScreenGeometryInternal(QSet<int>& ids, const Marble::GeoDataLatLonBox& curBox,
-                                                        bool highlight)
+void MapScreenIndex::updateAirwayScreenGeometryInternal(QVector<std::pair<int, QLine> >& lines, QSet<int>& ids,
+                                                        const QList<map::MapAirway>& airways,
+                                                        const QList<map::MapAirway>& tracks,
+                                                        const Marble::GeoDataLatLonBox& curBox, bool highlight)
 {
   const MapScale *scale = paintLayer->getMapScale();
 
@@ -297,51 +491,38 @@ void MapScreenIndex::updateAirwayScreenGeometryInternal(QSet<int>& ids, const Ma
     CoordinateConverter conv(mapPaintWidget->viewport());
     if(!highlight)
     {
-      // Get geometry from visible airspaces
+      // Project the prefetched visible airways
       bool showJet = paintLayer->getShownMapObjects().testFlag(map::AIRWAYJ);
       bool showVictor = paintLayer->getShownMapObjects().testFlag(map::AIRWAYV);
-      if(paintLayer->getMapLayer()->isAirway() && (showJet || showVictor))
+      for(int i = 0; i < airways.size(); i++)
       {
-        // Airways are visible on map - get them from the cache/database
-        QList<MapAirway> airways;
-        airwayQuery->getAirways(airways, curBox, paintLayer->getMapLayer(), false);
-
-        for(int i = 0; i < airways.size(); i++)
-        {
-          const MapAirway& airway = airways.at(i);
-          if(ids.contains(airway.id))
-            continue;
+        const MapAirway& airway = airways.at(i);
+        if(ids.contains(airway.id))
+          continue;
 
-          if((airway.type == map::AIRWAY_VICTOR && !showVictor) ||
-             (airway.type == map::AIRWAY_JET && !showJet))
-            // Not visible by map setting
-            continue;
+        if((airway.type == map::AIRWAY_VICTOR && !showVictor) ||
+           (airway.type == map::AIRWAY_JET && !showJet))
+          // Not visible by map setting
+          continue;
 
-          updateLineScreenGeometry(airwayLines, airway.id, Line(airway.from, airway.to), curBox, conv);
-          ids.insert(airway.id);
-        }
+        updateLineScreenGeometry(lines, airway.id, Line(airway.from, airway.to), curBox, conv);
+        ids.insert(airway.id);
       }
 
+      // Project the prefetched visible tracks
       bool showTrack = paintLayer->getShownMapObjects().testFlag(map::TRACK);
-      if(paintLayer->getMapLayer()->isTrack() && showTrack)
+      for(int i = 0; i < tracks.size(); i++)
       {
-        // Airways are visible on map - get them from the cache/database
-        QList<MapAirway> tracks;
-        airwayQuery->getTracks(tracks, curBox, paintLayer->getMapLayer(), false);
+        const MapAirway& track = tracks.at(i);
+        if(ids.contains(track.id))
+          continue;
 
-        for(int i = 0; i < tracks.size(); i++)
-        {
-          const MapAirway& track = tracks.at(i);
-          if(ids.contains(track.id))
-            continue;
-
-          if(track.isTrack() && !showTrack)
-            // Not visible by map setting
-            continue;
+        if(track.isTrack() && !showTrack)
+          // Not visible by map setting
+          continue;
 
-          updateLineScreenGeometry(airwayLines, track.id, Line(track.from, track.to), curBox, conv);
-          ids.insert(track.id);
-        }
+        updateLineScreenGeometry(lines, track.id, Line(track.from, track.to), curBox, conv);
+        ids.insert(track.id);
       }
     }
     else
@@ -353,7 +534,7 @@ void MapScreenIndex::updateAirwayScreenGeometryInternal(QSet<int>& ids, const Ma
         {
           if(ids.contains(airway.id))
             continue;
-          updateLineScreenGeometry(airwayLines, airway.id, Line(airway.from, airway.to), curBox, conv);
+          updateLineScreenGeometry(lines, airway.id, Line(airway.from, airway.to), curBox, conv);
           ids.insert(airway.id);
         }
       }
@@ -361,13 +542,16 @@ void MapScreenIndex::updateAirwayScreenGeometryInternal(QSet<int>& ids, const Ma
   }
 }
 
-void MapScreenIndex::updateLineScreenGeometry(QList<std::pair<int, QLine> >& index,
+void MapScreenIndex::updateLineScreenGeometry(QVector<std::pair<int, QLine> >& index,
                                               int id, const atools::geo::Line& line,
                                               const Marble::GeoDataLatLonBox& curBox,
                                               const CoordinateConverter& conv)
 {
   Marble::GeoDataLineString geoLineStr = conv.toGdcStr(line);
+
+  // Keep segments a bit beyond the screen so pure pans can reuse the geometry by translation
   QRect mapGeo = mapPaintWidget->rect();
+  mapGeo.adjust(-mapGeo.width() / 4, -mapGeo.height() / 4, mapGeo.width() / 4, mapGeo.height() / 4);
 
   QList<Marble::GeoDataLatLonBox> curBoxCorrectedList = query::splitAtAntiMeridian(curBox);
   QVector<Marble::GeoDataLineString *> geoLineStringVector = geoLineStr.toDateLineCorrected();
@@ -400,11 +584,27 @@ void MapScreenIndex::updateLineScreenGeometry(QList<std::pair<int, QLine> >& ind
 
 void MapScreenIndex::saveState() const
 {
+  // Serialize only the categories that were touched since the last save - sessions with large
+  // libraries of saved marks and patterns keep saves constant-time this way
   atools::settings::Settings& s = atools::settings::Settings::instance();
-  s.setValueVar(lnm::MAP_DISTANCEMARKERS, QVariant::fromValue<QList<map::DistanceMarker> >(distanceMarks));
-  s.setValueVar(lnm::MAP_RANGEMARKERS, QVariant::fromValue<QList<map::RangeMarker> >(rangeMarks));
-  s.setValueVar(lnm::MAP_TRAFFICPATTERNS, QVariant::fromValue<QList<map::TrafficPattern> >(trafficPatterns));
-  s.setValueVar(lnm::MAP_HOLDS, QVariant::fromValue<QList<map::Hold> >(holds));
+
+  if(distanceMarksDirty)
+    s.setValueVar(lnm::MAP_DISTANCEMARKERS, QVariant::fromValue<QList<map::DistanceMarker> >(distanceMarks));
+
+  if(rangeMarksDirty)
+    s.setValueVar(lnm::MAP_RANGEMARKERS, QVariant::fromValue<QList<map::RangeMarker> >(rangeMarks));
+
+  if(trafficPatternsDirty)
+    s.setValueVar(lnm::MAP_TRAFFICPATTERNS, QVariant::fromValue<QList<map::TrafficPattern> >(trafficPatterns));
+
+  if(holdsDirty)
+    s.setValueVar(lnm::MAP_HOLDS, QVariant::fromValue<QList<map::Hold> >(holds));
+
+  qDebug() << Q_FUNC_INFO << "saved categories"
+           << "distance" << distanceMarksDirty << "range" << rangeMarksDirty
+           << "pattern" << trafficPatternsDirty << "hold" << holdsDirty;
+
+  distanceMarksDirty = rangeMarksDirty = trafficPatternsDirty = holdsDirty = false;
 }
 
 void MapScreenIndex::restoreState()
@@ -414,11 +614,17 @@ void MapScreenIndex::restoreState()
   rangeMarks = s.valueVar(lnm::MAP_RANGEMARKERS).value<QList<map::RangeMarker> >();
   trafficPatterns = s.valueVar(lnm::MAP_TRAFFICPATTERNS).value<QList<map::TrafficPattern> >();
   holds = s.valueVar(lnm::MAP_HOLDS).value<QList<map::Hold> >();
+
+  // The stored state matches the lists now
+  distanceMarksDirty = rangeMarksDirty = trafficPatternsDirty = holdsDirty = false;
 }
 
 void MapScreenIndex::changeSearchHighlights(const map::MapResult& newHighlights)
 {
   *searchHighlights = newHighlights;
+
+  // Update hit testing grids for the new selection
+  updateSearchHighlightScreenGeometry();
 }
 
 void MapScreenIndex::setApproachLegHighlights(const proc::MapProcedureLeg *leg)
@@ -437,9 +643,10 @@ void MapScreenIndex::updateRouteScreenGeometry(const Marble::GeoDataLatLonBox& c
   routePoints.clear();
   routePointsAll.clear();
 
-  QList<std::pair<int, QPoint> > airportPoints;
-  QList<std::pair<int, QPoint> > otherPointsEditable;
-  QList<std::pair<int, QPoint> > otherPointsNotEditable;
+  QVector<std::pair<int, QPoint> > airportPoints;
+  QVector<std::pair<int, QPoint> > otherPointsEditable;
+  QVector<std::pair<int, QPoint> > otherPointsNotEditable;
+  otherPointsEditable.reserve(route.size());
 
   CoordinateConverter conv(mapPaintWidget->viewport());
   const MapScale *scale = paintLayer->getMapScale();
@@ -497,11 +704,13 @@ void MapScreenIndex::getAllNearest(int xs, int ys, int maxDistance, map::MapResu
   map::MapTypes shown = paintLayer->getShownMapObjects();
   map::MapObjectDisplayTypes shownDisplay = paintLayer->getShownMapObjectDisplayTypes();
 
+  // Clear all members in place - allows callers to reuse one result object between queries
+  result.clearAll();
+
   // Check for user aircraft
-  result.userAircraft.clear();
   if(shown & map::AIRCRAFT && NavApp::isConnectedAndAircraft())
   {
-    const atools::fs::sc::SimConnectUserAircraft& user = simData.getUserAircraftConst();
+    const atools::fs::sc::SimConnectUserAircraft& user = simData->getUserAircraftConst();
     int x, y;
     if(conv.wToS(user.getPosition(), x, y))
     {
@@ -514,12 +723,11 @@ void MapScreenIndex::getAllNearest(int xs, int ys, int maxDistance, map::MapResu
   int x, y;
 
   // Add boats ======================================
-  result.aiAircraft.clear();
   if(NavApp::isConnected())
   {
     if(shown & map::AIRCRAFT_AI_SHIP && mapLayer->isAiShipLarge())
     {
-      for(const atools::fs::sc::SimConnectAircraft& obj : simData.getAiAircraftConst())
+      for(const atools::fs::sc::SimConnectAircraft& obj : simData->getAiAircraftConst())
       {
         if(obj.isAnyBoat() && (obj.getModelRadiusCorrected() * 2 > layer::LARGE_SHIP_SIZE || mapLayer->isAiShipSmall()))
         {
@@ -630,17 +838,24 @@ void MapScreenIndex::getNearestHighlights(int xs, int ys, int maxDistance, map::
 {
   using maptools::insertSorted;
   CoordinateConverter conv(mapPaintWidget->viewport());
-  insertSorted(conv, xs, ys, searchHighlights->airports, result.airports, &result.airportIds, maxDistance);
-  insertSorted(conv, xs, ys, searchHighlights->vors, result.vors, &result.vorIds, maxDistance);
-  insertSorted(conv, xs, ys, searchHighlights->ndbs, result.ndbs, &result.ndbIds, maxDistance);
-  insertSorted(conv, xs, ys, searchHighlights->waypoints, result.waypoints, &result.waypointIds, maxDistance);
-  insertSorted(conv, xs, ys, searchHighlights->userpoints, result.userpoints, &result.userpointIds, maxDistance);
+
+  // Large lists from search result selections are hit tested through the screen coordinate grids
+  airportHighlightIndex.query(conv, xs, ys, searchHighlights->airports, result.airports, &result.airportIds,
+                              maxDistance);
+  vorHighlightIndex.query(conv, xs, ys, searchHighlights->vors, result.vors, &result.vorIds, maxDistance);
+  ndbHighlightIndex.query(conv, xs, ys, searchHighlights->ndbs, result.ndbs, &result.ndbIds, maxDistance);
+  waypointHighlightIndex.query(conv, xs, ys, searchHighlights->waypoints, result.waypoints, &result.waypointIds,
+                               maxDistance);
+  userpointHighlightIndex.query(conv, xs, ys, searchHighlights->userpoints, result.userpoints, &result.userpointIds,
+                                maxDistance);
+  onlineAircraftHighlightIndex.query(conv, xs, ys, searchHighlights->onlineAircraft, result.onlineAircraft,
+                                     &result.onlineAircraftIds, maxDistance);
+
+  // Remaining lists stay small and are scanned directly
   insertSorted(conv, xs, ys, searchHighlights->airspaces, result.airspaces, nullptr, maxDistance);
   insertSorted(conv, xs, ys, searchHighlights->airways, result.airways, nullptr, maxDistance);
   insertSorted(conv, xs, ys, searchHighlights->ils, result.ils, nullptr, maxDistance);
   insertSorted(conv, xs, ys, searchHighlights->aiAircraft, result.aiAircraft, nullptr, maxDistance);
-  insertSorted(conv, xs, ys, searchHighlights->onlineAircraft, result.onlineAircraft, &result.onlineAircraftIds,
-               maxDistance);
   insertSorted(conv, xs, ys, searchHighlights->runwayEnds, result.runwayEnds, nullptr, maxDistance);
 
   // Add only if requested and visible on map
@@ -757,13 +972,69 @@ int MapScreenIndex::getNearestRoutePointIndex(int xs, int ys, int maxDistance, b
   return minIndex;
 }
 
+void MapScreenIndex::updateSearchHighlightScreenGeometry()
+{
+  CoordinateConverter conv(mapPaintWidget->viewport());
+  QSize size = mapPaintWidget->size();
+
+  airportHighlightIndex.update(conv, searchHighlights->airports, size);
+  vorHighlightIndex.update(conv, searchHighlights->vors, size);
+  ndbHighlightIndex.update(conv, searchHighlights->ndbs, size);
+  waypointHighlightIndex.update(conv, searchHighlights->waypoints, size);
+  userpointHighlightIndex.update(conv, searchHighlights->userpoints, size);
+  onlineAircraftHighlightIndex.update(conv, searchHighlights->onlineAircraft, size);
+}
+
 void MapScreenIndex::updateAllGeometry(const Marble::GeoDataLatLonBox& curBox)
 {
+  QElapsedTimer timer;
+  timer.start();
+
+  // Fetch all database backed data on this thread first. The queries, their caches and the
+  // string pool behind the factory are all bound to the GUI thread.
+  QList<map::MapAirway> airways, tracks;
+  fetchAirways(airways, tracks, curBox);
+
+  const QList<map::MapIls> *ilsList = fetchIls(curBox);
+
+  QVector<std::pair<map::MapAirspaceId, const atools::geo::LineString *> > airspaceGeometries;
+  fetchAirspaces(airspaceGeometries, curBox);
+
+  QVector<const atools::geo::LineString *> logEntryRouteGeometries;
+  fetchLogEntryRouteGeometry(logEntryRouteGeometries);
+
+  // Project the prefetched lists to screen concurrently on the global thread pool.
+  // Each method builds into a local buffer and swaps the complete list at the end
+  // so the futures do not share any state. The fetched lists and cache pointers stay
+  // valid since no queries run until all futures are finished.
+  QFuture<void> airwayFuture = QtConcurrent::run([this, &airways, &tracks, &curBox]()
+  {
+    updateAirwayScreenGeometry(airways, tracks, curBox);
+  });
+  QFuture<void> logEntryFuture = QtConcurrent::run([this, &logEntryRouteGeometries, &curBox]()
+  {
+    updateLogEntryScreenGeometry(logEntryRouteGeometries, curBox);
+  });
+  QFuture<void> airspaceFuture = QtConcurrent::run([this, &airspaceGeometries]()
+  {
+    updateAirspaceScreenGeometry(airspaceGeometries);
+  });
+  QFuture<void> ilsFuture = QtConcurrent::run([this, ilsList, &curBox]()
+  {
+    updateIlsScreenGeometry(ilsList, curBox);
+  });
+
+  // Rebuild route geometry on the calling thread meanwhile
   updateRouteScreenGeometry(curBox);
-  updateAirwayScreenGeometry(curBox);
-  updateLogEntryScreenGeometry(curBox);
-  updateAirspaceScreenGeometry(curBox);
-  updateIlsScreenGeometry(curBox);
+  updateSearchHighlightScreenGeometry();
+
+  // Wait for completion so painters never see a half-built index
+  airwayFuture.waitForFinished();
+  logEntryFuture.waitForFinished();
+  airspaceFuture.waitForFinished();
+  ilsFuture.waitForFinished();
+
+  lastUpdateAllTimeMs = timer.elapsed();
 }
 
 /* Get all airways near cursor position */
@@ -771,18 +1042,20 @@ void MapScreenIndex::getNearestAirspaces(int xs, int ys, map::MapResult& result)
 {
   for(int i = 0; i < airspacePolygons.size(); i++)
   {
-    const std::pair<map::MapAirspaceId, QPolygon>& polyPair = airspacePolygons.at(i);
+    const AirspacePolygon& poly = airspacePolygons.at(i);
 
-    if(polyPair.second.containsPoint(QPoint(xs, ys), Qt::OddEvenFill))
+    // Check the precomputed bounding rectangle first which rejects most of the
+    // stacked polygons without walking their vertices
+    if(poly.boundingRect.contains(xs, ys) && poly.polygon.containsPoint(QPoint(xs, ys), Qt::OddEvenFill))
     {
       map::MapAirspace airspace;
-      NavApp::getAirspaceController()->getAirspaceById(airspace, polyPair.first);
+      NavApp::getAirspaceController()->getAirspaceById(airspace, poly.id);
       result.airspaces.append(airspace);
     }
   }
 }
 
-QSet<int> MapScreenIndex::nearestLineIds(const QList<std::pair<int, QLine> >& lineList, int xs, int ys,
+QSet<int> MapScreenIndex::nearestLineIds(const QVector<std::pair<int, QLine> >& lineList, int xs, int ys,
                                          int maxDistance, bool lineDistanceOnly) const
 {
   QSet<int> ids;
@@ -20,10 +20,15 @@
 
 #include "fs/sc/simconnectdata.h"
 #include "common/mapflags.h"
+#include "common/maptools.h"
+
+#include <QDateTime>
+#include <QSharedPointer>
 
 namespace atools {
 namespace geo {
 class Line;
+class LineString;
 }
 }
 
@@ -45,6 +50,7 @@ struct MapParking;
 struct MapHelipad;
 struct MapAirspace;
 struct MapUserpoint;
+struct MapOnlineAircraft;
 struct MapLogbookEntry;
 struct RangeMarker;
 struct DistanceMarker;
@@ -59,6 +65,7 @@ class GeoDataLatLonBox;
 class MapPaintWidget;
 class AirwayTrackQuery;
 class AirportQuery;
+class MapLayer;
 class MapPaintLayer;
 class MapQuery;
 class CoordinateConverter;
@@ -115,6 +122,7 @@ public:
   void updateAirspaceScreenGeometry(const Marble::GeoDataLatLonBox& curBox);
   void updateIlsScreenGeometry(const Marble::GeoDataLatLonBox& curBox);
   void updateLogEntryScreenGeometry(const Marble::GeoDataLatLonBox& curBox);
+  void updateSearchHighlightScreenGeometry();
 
   /* Clear internal caches */
   void resetAirspaceOnlineScreenGeometry();
@@ -150,9 +158,11 @@ public:
     return *approachLegHighlights;
   }
 
-  /* Get range rings */
+  /* Get range rings. The non-const accessors are the mutation channel and conservatively mark
+   * their category as changed, so the next saveState() only serializes touched categories. */
   QList<map::RangeMarker>& getRangeMarks()
   {
+    rangeMarksDirty = true;
     return rangeMarks;
   }
 
@@ -164,6 +174,7 @@ public:
   /* Get distance measurement lines */
   QList<map::DistanceMarker>& getDistanceMarks()
   {
+    distanceMarksDirty = true;
     return distanceMarks;
   }
 
@@ -175,6 +186,7 @@ public:
   /* Airfield traffic patterns. */
   QList<map::TrafficPattern>& getTrafficPatterns()
   {
+    trafficPatternsDirty = true;
     return trafficPatterns;
   }
 
@@ -186,6 +198,7 @@ public:
   /* Airfield traffic patterns. */
   QList<map::Hold>& getHolds()
   {
+    holdsDirty = true;
     return holds;
   }
 
@@ -196,37 +209,48 @@ public:
 
   const atools::fs::sc::SimConnectUserAircraft& getUserAircraft() const
   {
-    return simData.getUserAircraftConst();
+    return simData->getUserAircraftConst();
   }
 
   const atools::fs::sc::SimConnectData& getSimConnectData() const
   {
-    return simData;
+    return *simData;
   }
 
   const atools::fs::sc::SimConnectUserAircraft& getLastUserAircraft() const
   {
-    return lastSimData.getUserAircraftConst();
+    return lastSimData->getUserAircraftConst();
   }
 
   const QVector<atools::fs::sc::SimConnectAircraft>& getAiAircraft() const
   {
-    return simData.getAiAircraftConst();
+    return simData->getAiAircraftConst();
   }
 
+  /* Publishes a new immutable snapshot by swapping the pointer. Readers holding the previous
+   * snapshot keep it alive and see consistent data. The AI aircraft vector is implicitly
+   * shared and not deep copied. */
   void updateSimData(const atools::fs::sc::SimConnectData& data)
   {
-    simData = data;
+    simData = QSharedPointer<const atools::fs::sc::SimConnectData>::create(data);
+    simDataReceivedMs = QDateTime::currentMSecsSinceEpoch();
+  }
+
+  /* Wall clock time when the current snapshot was received. Used to extrapolate aircraft
+   * positions between samples when painting. */
+  qint64 getSimDataReceivedMs() const
+  {
+    return simDataReceivedMs;
   }
 
   bool isUserAircraftValid() const
   {
-    return simData.getUserAircraftConst().getPosition().isValid();
+    return simData->getUserAircraftConst().getPosition().isValid();
   }
 
   void updateLastSimData(const atools::fs::sc::SimConnectData& data)
   {
-    lastSimData = data;
+    lastSimData = QSharedPointer<const atools::fs::sc::SimConnectData>::create(data);
   }
 
   const proc::MapProcedureLegs& getProcedureHighlight() const
@@ -270,12 +294,27 @@ public:
   }
 
   /* For debug functions */
-  QList<std::pair<int, QLine> > getAirwayLines() const
+  QVector<std::pair<int, QLine> > getAirwayLines() const
   {
     return airwayLines;
   }
 
+  /* Time spent in the last updateAllGeometry() call. Shown in the render debug overlay. */
+  qint64 getLastUpdateAllTimeMs() const
+  {
+    return lastUpdateAllTimeMs;
+  }
+
 private:
+  /* Airspace outline projected to screen. The bounding rectangle is precomputed so hit tests
+   * can reject most of the stacked polygons without walking their vertices. */
+  struct AirspacePolygon
+  {
+    map::MapAirspaceId id;
+    QRect boundingRect;
+    QPolygon polygon;
+  };
+
   void getNearestAirways(int xs, int ys, int maxDistance, map::MapResult& result) const;
   void getNearestLogEntries(int xs, int ys, int maxDistance, map::MapResult& result) const;
 
@@ -285,22 +324,70 @@ private:
                             map::MapObjectQueryTypes types) const;
   void getNearestProcedureHighlights(int xs, int ys, int maxDistance, map::MapResult& result,
                                      map::MapObjectQueryTypes types) const;
-  void updateAirspaceScreenGeometryInternal(QSet<map::MapAirspaceId>& ids,
-                                            map::MapAirspaceSources source,
-                                            const Marble::GeoDataLatLonBox& curBox, bool highlights);
-  void updateAirwayScreenGeometryInternal(QSet<int>& ids, const Marble::GeoDataLatLonBox& curBox, bool highlight);
-
-  void updateLineScreenGeometry(QList<std::pair<int, QLine> >& index, int id, const atools::geo::Line& line,
+  /* Fetch all database backed data for the geometry rebuilds. The queries and their caches
+   * are bound to the GUI thread, so these have to run on it - in contrast to the pure
+   * projection methods below which are safe on the thread pool. */
+  void fetchAirways(QList<map::MapAirway>& airways, QList<map::MapAirway>& tracks,
+                    const Marble::GeoDataLatLonBox& curBox) const;
+
+  /* Returns null if ILS are not shown on the current layer */
+  const QList<map::MapIls> *fetchIls(const Marble::GeoDataLatLonBox& curBox) const;
+
+  /* Fetch the boundary geometry of all displayed and highlighted airspaces touching the viewport */
+  void fetchAirspaces(QVector<std::pair<map::MapAirspaceId, const atools::geo::LineString *> >& airspaceGeometries,
+                      const Marble::GeoDataLatLonBox& curBox) const;
+  void fetchAirspacesInternal(QVector<std::pair<map::MapAirspaceId, const atools::geo::LineString *> >& airspaceGeometries,
+                              QSet<map::MapAirspaceId>& ids, const Marble::GeoDataLatLonBox& curBox,
+                              bool highlights) const;
+
+  /* Fetch the route preview geometry for the highlighted logbook entries.
+   * One entry per highlight - null if there is no geometry or the preview is disabled. */
+  void fetchLogEntryRouteGeometry(QVector<const atools::geo::LineString *>& routeGeometries) const;
+
+  /* Pure screen projection of the prefetched lists. Free of database access so the lists
+   * can be projected concurrently on the global thread pool in updateAllGeometry(). */
+  void updateAirwayScreenGeometry(const QList<map::MapAirway>& airways, const QList<map::MapAirway>& tracks,
+                                  const Marble::GeoDataLatLonBox& curBox);
+  void updateIlsScreenGeometry(const QList<map::MapIls> *ilsList, const Marble::GeoDataLatLonBox& curBox);
+  void updateAirspaceScreenGeometry(const QVector<std::pair<map::MapAirspaceId,
+                                                            const atools::geo::LineString *> >& airspaceGeometries);
+  void updateLogEntryScreenGeometry(const QVector<const atools::geo::LineString *>& routeGeometries,
+                                    const Marble::GeoDataLatLonBox& curBox);
+
+  void updateAirwayScreenGeometryInternal(QVector<std::pair<int, QLine> >& lines, QSet<int>& ids,
+                                          const QList<map::MapAirway>& airways, const QList<map::MapAirway>& tracks,
+                                          const Marble::GeoDataLatLonBox& curBox, bool highlight);
+
+  void updateLineScreenGeometry(QVector<std::pair<int, QLine> >& index, int id, const atools::geo::Line& line,
                                 const Marble::GeoDataLatLonBox& curBox,
                                 const CoordinateConverter& conv);
 
-  QSet<int> nearestLineIds(const QList<std::pair<int, QLine> >& lineList, int xs, int ys, int maxDistance,
+  QSet<int> nearestLineIds(const QVector<std::pair<int, QLine> >& lineList, int xs, int ys, int maxDistance,
                            bool lineDistanceOnly) const;
 
+  /* Viewport state of the last airway or ILS geometry update. Used to detect pure pans in the
+   * Mercator projection which can reuse the projected geometry by translation. */
+  struct GeometryPanState
+  {
+    atools::geo::Pos center; /* Projection center at the last update */
+    const MapLayer *layer = nullptr;
+    map::MapTypes shownTypes = map::NONE;
+    int radius = 0; /* Marble zoom radius in pixels */
+    QPoint offset; /* Accumulated translation since the last full rebuild */
+  };
+
+  /* Returns true and fills the screen pixel delta if the viewport only panned since the last
+   * call so the retained geometry can be shifted instead of re-projected.
+   * Updates the state for the next call. */
+  bool checkPanDelta(GeometryPanState& state, QPoint& delta) const;
+
   template<typename TYPE>
   int getNearestIndex(int xs, int ys, int maxDistance, const QList<TYPE>& typeList) const;
 
-  atools::fs::sc::SimConnectData simData, lastSimData;
+  /* Current and previous simulator data published as immutable snapshots. Updates create a
+   * new snapshot instead of assigning into the object so references handed out to painters
+   * are never modified behind their back. Always non-null. */
+  QSharedPointer<const atools::fs::sc::SimConnectData> simData, lastSimData;
   MapPaintWidget *mapPaintWidget;
   MapQuery *mapQuery;
   AirwayTrackQuery *airwayQuery;
@@ -309,6 +396,16 @@ private:
 
   /* All highlights from search windows - also online airspaces */
   map::MapResult *searchHighlights;
+
+  /* Screen coordinate grids over the point-like search highlight lists above. Rebuilt on view
+   * and selection changes so mouse moves do not have to scan all highlights linearly.
+   * Only kept for the lists that can grow large when selecting many search results. */
+  maptools::ScreenPointIndex<map::MapAirport> airportHighlightIndex;
+  maptools::ScreenPointIndex<map::MapVor> vorHighlightIndex;
+  maptools::ScreenPointIndex<map::MapNdb> ndbHighlightIndex;
+  maptools::ScreenPointIndex<map::MapWaypoint> waypointHighlightIndex;
+  maptools::ScreenPointIndex<map::MapUserpoint> userpointHighlightIndex;
+  maptools::ScreenPointIndex<map::MapOnlineAircraft> onlineAircraftHighlightIndex;
   proc::MapProcedureLeg *approachLegHighlights;
   proc::MapProcedureLegs *approachHighlight;
 
@@ -330,21 +427,41 @@ private:
   QList<map::TrafficPattern> trafficPatterns;
   QList<map::Hold> holds;
 
-  /* Cached screen coordinates for flight plan to ease mouse cursor change. */
-  QList<std::pair<int, QLine> > routeLines;
-  QList<std::pair<int, QPoint> > routePoints; /* Editable points */
-  QList<std::pair<int, QPoint> > routePointsAll; /* All points */
+  /* Categories touched since the last save. Serializing hundreds of marks into settings on
+   * every state save stutters, so saveState() skips clean categories. Mutable since saving
+   * a const index clears the flags. */
+  mutable bool rangeMarksDirty = false, distanceMarksDirty = false,
+               trafficPatternsDirty = false, holdsDirty = false;
+
+  /* Cached screen coordinates for flight plan to ease mouse cursor change.
+   * All screen geometry lists use QVector for contiguous storage since QList
+   * heap-allocates every element for types larger than a pointer. */
+  QVector<std::pair<int, QLine> > routeLines;
+  QVector<std::pair<int, QPoint> > routePoints; /* Editable points */
+  QVector<std::pair<int, QPoint> > routePointsAll; /* All points */
 
   /* Geometry objects that are cached in screen coordinate system for faster access to tooltips etc. */
-  QList<std::pair<int, QLine> > airwayLines;
+  QVector<std::pair<int, QLine> > airwayLines;
+
+  /* Ids of the non-highlight airway geometry currently in airwayLines. Allows retaining
+   * already projected airways when the viewport only panned. */
+  QSet<int> airwayScreenIds;
+
+  GeometryPanState airwayPanState, ilsPanState;
 
   /* Collects logbook entry route and direct line geometry */
-  QList<std::pair<int, QLine> > logEntryLines;
-  QList<std::pair<map::MapAirspaceId, QPolygon> > airspacePolygons;
-  QList<std::pair<int, QPolygon> > ilsPolygons;
-  QList<std::pair<int, QLine> > ilsLines; /* Index ILS center lines separately to allow
+  QVector<std::pair<int, QLine> > logEntryLines;
+  QVector<AirspacePolygon> airspacePolygons;
+  QVector<std::pair<int, QPolygon> > ilsPolygons;
+  QVector<std::pair<int, QLine> > ilsLines; /* Index ILS center lines separately to allow
                                            * tooltips when getting the cursor near a line */
 
+  /* Duration of the last updateAllGeometry() call */
+  qint64 lastUpdateAllTimeMs = 0;
+
+  /* Wall clock time of the last sim data snapshot */
+  qint64 simDataReceivedMs = 0;
+
 };
 
 #endif // LITTLENAVMAP_MAPSCREENINDEX_H
@@ -24,8 +24,11 @@
 #include "gui/mainwindow.h"
 #include "route/route.h"
 #include "airspace/airspacecontroller.h"
+#include "common/constants.h"
 #include "options/optiondata.h"
+#include "settings/settings.h"
 #include "sql/sqlrecord.h"
+#include "weather/weatherreporter.h"
 #include "weather/windreporter.h"
 #include "grib/windquery.h"
 #include "route/routealtitudeleg.h"
@@ -41,10 +44,18 @@ using atools::fs::sc::SimConnectUserAircraft;
 /* Number of characters in the divider */
 static const int TEXT_BAR_LENGTH = 15;
 
+/* Maximum time for building the tooltip in milliseconds. Remaining objects are cut off with a
+ * "More ..." marker since weather fetching or procedure queries for several objects can
+ * otherwise block the event loop noticeably. */
+static const int MAX_BUILD_TIME_MS = 50;
+
 MapTooltip::MapTooltip(MainWindow *parentWindow)
   : mainWindow(parentWindow), mapQuery(NavApp::getMapQuery()), weather(NavApp::getWeatherReporter())
 {
   qDebug() << Q_FUNC_INFO;
+
+  tooltipCache.setMaxCost(atools::settings::Settings::instance().
+                          getAndStoreValue(lnm::OPTIONS_MAP_TOOLTIP_CACHE_SIZE, 200000).toInt());
 }
 
 MapTooltip::~MapTooltip()
@@ -60,10 +71,26 @@ QString MapTooltip::buildTooltip(const map::MapResult& mapSearchResult, const Ro
   qDebug() << Q_FUNC_INFO << mapSearchResult;
 #endif
 
+  // Serve the text from the cache if the result contains only objects with stable content.
+  // Hits when hovering back to an already visited flight plan waypoint or airport.
+  QString key;
+  if(canCacheResult(mapSearchResult))
+  {
+    key = cacheKey(mapSearchResult, airportDiagram);
+
+    const QString *cached = tooltipCache.object(key);
+    if(cached != nullptr)
+      return *cached;
+  }
+
   HtmlBuilder html(false);
   HtmlInfoBuilder info(mainWindow, false);
   int numEntries = 0;
 
+  timer.start();
+  lastSectionMs = 0L;
+  lastSection = nullptr;
+
   // Append HTML text for all objects found in order of importance (airports first, etc.)
   // Objects are separated by a horizontal ruler
   // If max number of entries or lines is exceeded return the html
@@ -73,7 +100,7 @@ QString MapTooltip::buildTooltip(const map::MapResult& mapSearchResult, const Ro
   {
     if(mapSearchResult.userAircraft.getPosition().isValid())
     {
-      if(checkText(html))
+      if(checkText(html, "user aircraft"))
         return html.getHtml();
 
       if(!html.isEmpty())
@@ -92,7 +119,7 @@ QString MapTooltip::buildTooltip(const map::MapResult& mapSearchResult, const Ro
     // Online Aircraft ===========================================================================
     for(const map::MapOnlineAircraft& aircraft : mapSearchResult.onlineAircraft)
     {
-      if(checkText(html))
+      if(checkText(html, "online aircraft"))
         return html.getHtml();
 
       if(!html.isEmpty())
@@ -108,7 +135,7 @@ QString MapTooltip::buildTooltip(const map::MapResult& mapSearchResult, const Ro
     // AI Aircraft ===========================================================================
     for(const map::MapAiAircraft& aircraft : mapSearchResult.aiAircraft)
     {
-      if(checkText(html))
+      if(checkText(html, "AI aircraft"))
         return html.getHtml();
 
       if(!html.isEmpty())
@@ -127,7 +154,7 @@ QString MapTooltip::buildTooltip(const map::MapResult& mapSearchResult, const Ro
   {
     for(const proc::MapProcedurePoint& ap : mapSearchResult.procPoints)
     {
-      if(checkText(html))
+      if(checkText(html, "procedure point"))
         return html.getHtml();
 
       if(!html.isEmpty())
@@ -142,7 +169,7 @@ QString MapTooltip::buildTooltip(const map::MapResult& mapSearchResult, const Ro
   // Holds ===========================================================================
   for(const Hold& entry : mapSearchResult.holds)
   {
-    if(checkText(html))
+    if(checkText(html, "hold"))
       return html.getHtml();
 
     if(!html.isEmpty())
@@ -156,7 +183,7 @@ QString MapTooltip::buildTooltip(const map::MapResult& mapSearchResult, const Ro
   // Traffic pattern ===========================================================================
   for(const TrafficPattern& entry : mapSearchResult.trafficPatterns)
   {
-    if(checkText(html))
+    if(checkText(html, "traffic pattern"))
       return html.getHtml();
 
     if(!html.isEmpty())
@@ -170,7 +197,7 @@ QString MapTooltip::buildTooltip(const map::MapResult& mapSearchResult, const Ro
   // Range rings ===========================================================================
   for(const RangeMarker& entry : mapSearchResult.rangeMarkers)
   {
-    if(checkText(html))
+    if(checkText(html, "range marker"))
       return html.getHtml();
 
     if(!html.isEmpty())
@@ -186,7 +213,7 @@ QString MapTooltip::buildTooltip(const map::MapResult& mapSearchResult, const Ro
   {
     for(const MapLogbookEntry& entry : mapSearchResult.logbookEntries)
     {
-      if(checkText(html))
+      if(checkText(html, "logbook entry"))
         return html.getHtml();
 
       if(!html.isEmpty())
@@ -201,7 +228,7 @@ QString MapTooltip::buildTooltip(const map::MapResult& mapSearchResult, const Ro
   // Userpoints ===========================================================================
   for(const MapUserpoint& up : mapSearchResult.userpoints)
   {
-    if(checkText(html))
+    if(checkText(html, "userpoint"))
       return html.getHtml();
 
     if(!html.isEmpty())
@@ -217,7 +244,7 @@ QString MapTooltip::buildTooltip(const map::MapResult& mapSearchResult, const Ro
   {
     for(const MapAirport& airport : mapSearchResult.airports)
     {
-      if(checkText(html))
+      if(checkText(html, "airport"))
         return html.getHtml();
 
       if(!html.isEmpty())
@@ -238,7 +265,7 @@ QString MapTooltip::buildTooltip(const map::MapResult& mapSearchResult, const Ro
 
     for(const MapVor& vor : mapSearchResult.vors)
     {
-      if(checkText(html))
+      if(checkText(html, "VOR"))
         return html.getHtml();
 
       if(!html.isEmpty())
@@ -251,7 +278,7 @@ QString MapTooltip::buildTooltip(const map::MapResult& mapSearchResult, const Ro
 
     for(const MapNdb& ndb : mapSearchResult.ndbs)
     {
-      if(checkText(html))
+      if(checkText(html, "NDB"))
         return html.getHtml();
 
       if(!html.isEmpty())
@@ -264,7 +291,7 @@ QString MapTooltip::buildTooltip(const map::MapResult& mapSearchResult, const Ro
 
     for(const MapWaypoint& wp : mapSearchResult.waypoints)
     {
-      if(checkText(html))
+      if(checkText(html, "waypoint"))
         return html.getHtml();
 
       if(!html.isEmpty())
@@ -277,7 +304,7 @@ QString MapTooltip::buildTooltip(const map::MapResult& mapSearchResult, const Ro
 
     for(const MapMarker& m : mapSearchResult.markers)
     {
-      if(checkText(html))
+      if(checkText(html, "marker"))
         return html.getHtml();
 
       if(!html.isEmpty())
@@ -290,7 +317,7 @@ QString MapTooltip::buildTooltip(const map::MapResult& mapSearchResult, const Ro
 
     for(const MapIls& ils : mapSearchResult.ils)
     {
-      if(checkText(html))
+      if(checkText(html, "ILS"))
         return html.getHtml();
 
       if(!html.isEmpty())
@@ -307,7 +334,7 @@ QString MapTooltip::buildTooltip(const map::MapResult& mapSearchResult, const Ro
   {
     for(const MapAirport& ap : mapSearchResult.towers)
     {
-      if(checkText(html))
+      if(checkText(html, "tower"))
         return html.getHtml();
 
       if(!html.isEmpty())
@@ -319,7 +346,7 @@ QString MapTooltip::buildTooltip(const map::MapResult& mapSearchResult, const Ro
     }
     for(const MapParking& p : mapSearchResult.parkings)
     {
-      if(checkText(html))
+      if(checkText(html, "parking"))
         return html.getHtml();
 
       if(!html.isEmpty())
@@ -331,7 +358,7 @@ QString MapTooltip::buildTooltip(const map::MapResult& mapSearchResult, const Ro
     }
     for(const MapHelipad& p : mapSearchResult.helipads)
     {
-      if(checkText(html))
+      if(checkText(html, "helipad"))
         return html.getHtml();
 
       if(!html.isEmpty())
@@ -347,7 +374,7 @@ QString MapTooltip::buildTooltip(const map::MapResult& mapSearchResult, const Ro
   {
     for(const MapUserpointRoute& up : mapSearchResult.userpointsRoute)
     {
-      if(checkText(html))
+      if(checkText(html, "userpoint route"))
         return html.getHtml();
 
       if(!html.isEmpty())
@@ -360,7 +387,7 @@ QString MapTooltip::buildTooltip(const map::MapResult& mapSearchResult, const Ro
 
     for(const MapAirway& airway : mapSearchResult.airways)
     {
-      if(checkText(html))
+      if(checkText(html, "airway"))
         return html.getHtml();
 
       if(!html.isEmpty())
@@ -379,7 +406,7 @@ QString MapTooltip::buildTooltip(const map::MapResult& mapSearchResult, const Ro
     atools::grib::WindPosVector winds = windReporter->getWindStackForPos(mapSearchResult.windPos);
     if(!winds.isEmpty())
     {
-      if(checkText(html))
+      if(checkText(html, "wind"))
         return html.getHtml();
 
       if(!html.isEmpty())
@@ -406,7 +433,7 @@ QString MapTooltip::buildTooltip(const map::MapResult& mapSearchResult, const Ro
 
     for(const MapAirspace& airspace : res.airspaces)
     {
-      if(checkText(html))
+      if(checkText(html, "airspace"))
         return html.getHtml();
 
       if(!html.isEmpty())
@@ -426,6 +453,10 @@ QString MapTooltip::buildTooltip(const map::MapResult& mapSearchResult, const Ro
   if(str.endsWith("<br/>"))
     str.chop(5);
 
+  if(!key.isEmpty())
+    // Only completely built texts get here - the line and time budget cutoffs above return directly
+    tooltipCache.insert(key, new QString(str), str.size());
+
 #ifdef DEBUG_INFORMATION_TOOLTIP
 
   qDebug().noquote().nospace() << Q_FUNC_INFO << html.getHtml();
@@ -436,8 +467,79 @@ QString MapTooltip::buildTooltip(const map::MapResult& mapSearchResult, const Ro
 
 }
 
-/* Check if the result HTML has more than the allowed number of lines and add a "more" text */
-bool MapTooltip::checkText(HtmlBuilder& html)
+bool MapTooltip::canCacheResult(const map::MapResult& result) const
+{
+  // Texts contain bearing and distance fields from the user aircraft while flying
+  if(NavApp::isConnectedAndAircraft())
+    return false;
+
+  // Only objects whose text depends on nothing but the route, weather, wind and database state.
+  // All of these either clear the cache or are part of the key.
+  return (result.hasAirports() || result.hasVor() || result.hasNdb() || result.hasWaypoints() ||
+          !result.markers.isEmpty() || result.hasIls() || result.hasAirways() ||
+          result.hasUserpointsRoute() || result.windPos.isValid()) &&
+         !result.userAircraft.getPosition().isValid() &&
+         result.aiAircraft.isEmpty() && result.onlineAircraft.isEmpty() &&
+         result.procPoints.isEmpty() && result.holds.isEmpty() && result.trafficPatterns.isEmpty() &&
+         result.rangeMarkers.isEmpty() && result.logbookEntries.isEmpty() &&
+         !result.hasUserpoints() && !result.hasAirspaces() &&
+         result.towers.isEmpty() && result.parkings.isEmpty() && result.helipads.isEmpty();
+}
+
+QString MapTooltip::cacheKey(const map::MapResult& result, bool airportDiagram) const
+{
+  QStringList key;
+  for(const MapAirport& airport : result.airports)
+    key.append("A" + QString::number(airport.id));
+  for(const MapVor& vor : result.vors)
+    key.append("V" + QString::number(vor.id));
+  for(const MapNdb& ndb : result.ndbs)
+    key.append("N" + QString::number(ndb.id));
+  for(const MapWaypoint& waypoint : result.waypoints)
+    key.append("W" + QString::number(waypoint.id));
+  for(const MapMarker& marker : result.markers)
+    key.append("M" + QString::number(marker.id));
+  for(const MapIls& ils : result.ils)
+    key.append("I" + QString::number(ils.id));
+  for(const MapAirway& airway : result.airways)
+    key.append("R" + QString::number(airway.id));
+  for(const MapUserpointRoute& up : result.userpointsRoute)
+    key.append("U" + QString::number(up.id));
+
+  if(result.windPos.isValid())
+    // The wind stack depends on position, downloaded data and the selected level
+    key.append("P" + QString::number(result.windPos.getLonX()) + "," +
+               QString::number(result.windPos.getLatY()) + "," +
+               QString::number(NavApp::getWindReporter()->getChangeNumber()) + "," +
+               QString::number(NavApp::getWindReporter()->getCurrentLevel()));
+
+  // Weather updates have to rebuild the airport reports instead of serving stale text
+  key.append(QString::number(weather->getChangeNumber()));
+  key.append(QString::number(airportDiagram));
+  return key.join('_');
+}
+
+/* Check if the result HTML has more than the allowed number of lines or took too long to
+ * build and add a "more" text. Also logs the cost of the previously built section. */
+bool MapTooltip::checkText(HtmlBuilder& html, const char *section)
 {
+  qint64 elapsedMs = timer.elapsed();
+
+#ifdef DEBUG_INFORMATION
+  if(lastSection != nullptr && elapsedMs > lastSectionMs)
+    qDebug() << Q_FUNC_INFO << lastSection << "section took" << (elapsedMs - lastSectionMs) << "ms";
+#endif
+
+  lastSection = section;
+  lastSectionMs = elapsedMs;
+
+  if(elapsedMs > MAX_BUILD_TIME_MS)
+  {
+    qWarning() << Q_FUNC_INFO << "Time budget exhausted after" << elapsedMs << "ms before" << section << "section";
+    html.textBar(TEXT_BAR_LENGTH);
+    html.b(tr("More ..."));
+    return true;
+  }
+
   return html.checklengthTextBar(MAX_LINES, tr("More ..."), TEXT_BAR_LENGTH);
 }
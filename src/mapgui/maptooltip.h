@@ -18,8 +18,10 @@
 #ifndef LITTLENAVMAP_MAPTOOLTIP_H
 #define LITTLENAVMAP_MAPTOOLTIP_H
 
+#include <QCache>
 #include <QColor>
 #include <QApplication>
+#include <QElapsedTimer>
 
 namespace map {
 struct MapResult;
@@ -65,14 +67,40 @@ public:
   QString buildTooltip(const map::MapResult& mapSearchResult, const Route& route,
                        bool airportDiagram);
 
+  /* Remove all cached tooltip HTML. Called when the route, the options or the databases
+   * change since the cached texts embed route flags, units and object ids. */
+  void clearCache()
+  {
+    tooltipCache.clear();
+  }
+
 private:
-  bool checkText(atools::util::HtmlBuilder& html);
+  /* true if the result contains only objects whose text is stable between route, weather and
+   * database changes. Aircraft with their live data and user editable objects are excluded. */
+  bool canCacheResult(const map::MapResult& result) const;
+
+  /* Cache key from the object ids and the change numbers of the volatile data sources */
+  QString cacheKey(const map::MapResult& result, bool airportDiagram) const;
+
+  /* Check line and time budget before building a section for the next object. Also logs the cost
+   * of the previously built section to find slow data sources like weather decoding. */
+  bool checkText(atools::util::HtmlBuilder& html, const char *section);
 
   static Q_DECL_CONSTEXPR int MAX_LINES = 20;
 
   MainWindow *mainWindow = nullptr;
   MapQuery *mapQuery;
   WeatherReporter *weather;
+
+  /* Completely built tooltip HTML keyed by object ids. Hovering along the flight plan hits
+   * the cache when moving back to an already visited object. Costs are text lengths in
+   * characters and the maximum size is configurable in the settings file. */
+  QCache<QString, QString> tooltipCache;
+
+  /* Runtime of the current buildTooltip call for the time budget and the section cost log */
+  QElapsedTimer timer;
+  qint64 lastSectionMs = 0L;
+  const char *lastSection = nullptr;
 };
 
 #endif // LITTLENAVMAP_MAPTOOLTIP_H
@@ -0,0 +1,172 @@
+/*****************************************************************************
+* Copyright 2015-2020 Alexander Barthel alex@littlenavmap.org
+*
+* This program is free software: you can redistribute it and/or modify
+* it under the terms of the GNU General Public License as published by
+* the Free Software Foundation, either version 3 of the License, or
+* (at your option) any later version.
+*
+* This program is distributed in the hope that it will be useful,
+* but WITHOUT ANY WARRANTY; without even the implied warranty of
+* MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+* GNU General Public License for more details.
+*
+* You should have received a copy of the GNU General Public License
+* along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*****************************************************************************/
+
+#include "mapgui/mapviewwindow.h"
+
+#include "common/constants.h"
+#include "common/mapflags.h"
+#include "fs/sc/simconnectdata.h"
+#include "mapgui/mappaintwidget.h"
+#include "mapgui/mapscreenindex.h"
+#include "mapgui/mapwidget.h"
+#include "mappainter/mappaintlayer.h"
+#include "navapp.h"
+#include "settings/settings.h"
+
+#include <QApplication>
+#include <QCloseEvent>
+#include <QDebug>
+#include <QResizeEvent>
+
+#include <marble/GeoDataLatLonBox.h>
+
+using atools::settings::Settings;
+
+MapViewWindow::MapViewWindow(QWidget *parent)
+  : QWidget(parent, Qt::Window)
+{
+  setWindowTitle(tr("%1 - Map View").arg(QApplication::applicationName()));
+  setObjectName("MapViewWindow");
+
+  // The widget shares all query classes, caches and the simulator connection with the main map.
+  // No layout since copySettings() resizes the widget - the geometry is kept in resizeEvent.
+  mapPaintWidget = new MapPaintWidget(this, true /* real visible widget */);
+
+  resize(QSize(800, 600));
+}
+
+MapViewWindow::~MapViewWindow()
+{
+  qDebug() << Q_FUNC_INFO;
+}
+
+void MapViewWindow::showWindow()
+{
+  if(!initialized)
+    initFromMainMap();
+  else
+  {
+    // Pick up feature, theme and projection changes done while the window was hidden
+    mapPaintWidget->copySettings(*NavApp::getMapWidget());
+    mapPaintWidget->setGeometry(rect());
+  }
+
+  show();
+  raise();
+  activateWindow();
+}
+
+void MapViewWindow::initFromMainMap()
+{
+  qDebug() << Q_FUNC_INFO;
+
+  const MapPaintWidget *mainMap = NavApp::getMapWidget();
+
+  // Enable map painting, take over shown features, theme and projection and start with the
+  // same view as the main map
+  mapPaintWidget->setActive();
+  mapPaintWidget->copySettings(*mainMap);
+  mapPaintWidget->setGeometry(rect());
+  mapPaintWidget->centerRectOnMap(mainMap->getCurrentViewBoundingBox(), false /* allowAdjust */);
+
+  initialized = true;
+}
+
+void MapViewWindow::updateMapObjectsShown()
+{
+  if(!initialized || !isVisible())
+    return;
+
+  // Mirror shown features, theme and projection but keep the own center position and zoom
+  mapPaintWidget->copySettings(*NavApp::getMapWidget());
+  mapPaintWidget->setGeometry(rect());
+  mapPaintWidget->scheduleUpdate();
+}
+
+void MapViewWindow::simDataChanged(const atools::fs::sc::SimConnectData& simulatorData)
+{
+  if(!initialized || !isVisible())
+    return;
+
+  if(!simulatorData.getUserAircraftConst().isValid())
+    return;
+
+  if(mapPaintWidget->getMapPaintLayer()->getShownMapObjects() & map::AIRCRAFT_ALL)
+  {
+    // Publish the new sample to the own screen index - the repaint is merged and throttled
+    // by the widget
+    mapPaintWidget->getScreenIndex()->updateSimData(simulatorData);
+    mapPaintWidget->getScreenIndex()->updateLastSimData(simulatorData);
+    mapPaintWidget->scheduleUpdate();
+  }
+}
+
+void MapViewWindow::optionsChanged()
+{
+  if(initialized)
+  {
+    mapPaintWidget->optionsChanged();
+    updateMapObjectsShown();
+  }
+}
+
+void MapViewWindow::styleChanged()
+{
+  if(initialized)
+    mapPaintWidget->styleChanged();
+}
+
+void MapViewWindow::preDatabaseLoad()
+{
+  mapPaintWidget->preDatabaseLoad();
+}
+
+void MapViewWindow::postDatabaseLoad()
+{
+  mapPaintWidget->postDatabaseLoad();
+}
+
+void MapViewWindow::saveState()
+{
+  Settings& settings = Settings::instance();
+  settings.setValueVar(lnm::MAINWINDOW_MAPVIEWWINDOW, saveGeometry());
+  settings.setValue(lnm::MAINWINDOW_MAPVIEWWINDOW_VISIBLE, isVisible());
+}
+
+void MapViewWindow::restoreState()
+{
+  Settings& settings = Settings::instance();
+  if(settings.contains(lnm::MAINWINDOW_MAPVIEWWINDOW))
+    restoreGeometry(settings.valueVar(lnm::MAINWINDOW_MAPVIEWWINDOW).toByteArray());
+
+  if(settings.valueBool(lnm::MAINWINDOW_MAPVIEWWINDOW_VISIBLE, false))
+    showWindow();
+}
+
+void MapViewWindow::closeEvent(QCloseEvent *event)
+{
+  QWidget::closeEvent(event);
+
+  // Uncheck the menu action
+  emit windowHidden();
+}
+
+void MapViewWindow::resizeEvent(QResizeEvent *event)
+{
+  QWidget::resizeEvent(event);
+  mapPaintWidget->setGeometry(rect());
+}
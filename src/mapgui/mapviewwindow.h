@@ -0,0 +1,90 @@
+/*****************************************************************************
+* Copyright 2015-2020 Alexander Barthel alex@littlenavmap.org
+*
+* This program is free software: you can redistribute it and/or modify
+* it under the terms of the GNU General Public License as published by
+* the Free Software Foundation, either version 3 of the License, or
+* (at your option) any later version.
+*
+* This program is distributed in the hope that it will be useful,
+* but WITHOUT ANY WARRANTY; without even the implied warranty of
+* MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+* GNU General Public License for more details.
+*
+* You should have received a copy of the GNU General Public License
+* along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*****************************************************************************/
+
+#ifndef LITTLENAVMAP_MAPVIEWWINDOW_H
+#define LITTLENAVMAP_MAPVIEWWINDOW_H
+
+#include <QWidget>
+
+namespace atools {
+namespace fs {
+namespace sc {
+class SimConnectData;
+}
+}
+}
+
+class MapPaintWidget;
+
+/*
+ * Additional top level window with an independent map viewport for a second display.
+ *
+ * Hosts a visible MapPaintWidget that shares all query classes, caches and the simulator
+ * connection with the main map instead of running a second program instance which would
+ * duplicate databases, tile caches and the connection stream. Shown features, theme and
+ * projection are mirrored from the main map while center position and zoom can be changed
+ * freely with the mouse.
+ */
+class MapViewWindow :
+  public QWidget
+{
+  Q_OBJECT
+
+public:
+  explicit MapViewWindow(QWidget *parent);
+  virtual ~MapViewWindow() override;
+
+  /* Show and raise the window. The first call takes view and settings from the main map. */
+  void showWindow();
+
+  /* Mirror shown features, theme and projection from the main map widget. Called whenever
+   * the main map updates its own state from the menus and the toolbar. */
+  void updateMapObjectsShown();
+
+  /* New data package from simulator, driven by connection. Publishes the aircraft to the
+   * own screen index so the symbol moves independently of the main map viewport. */
+  void simDataChanged(const atools::fs::sc::SimConnectData& simulatorData);
+
+  void optionsChanged();
+  void styleChanged();
+
+  /* Avoid painting while the database is reloaded */
+  void preDatabaseLoad();
+  void postDatabaseLoad();
+
+  /* Window geometry and visibility */
+  void saveState();
+  void restoreState();
+
+signals:
+  /* Window was closed by the user - used to uncheck the menu action */
+  void windowHidden();
+
+private:
+  virtual void closeEvent(QCloseEvent *event) override;
+
+  /* Keep the map widget geometry in sync - no layout is used since copySettings() resizes the widget */
+  virtual void resizeEvent(QResizeEvent *event) override;
+
+  /* Copy settings and resync the view from the main map on first show */
+  void initFromMainMap();
+
+  MapPaintWidget *mapPaintWidget = nullptr;
+  bool initialized = false;
+};
+
+#endif // LITTLENAVMAP_MAPVIEWWINDOW_H
@@ -57,8 +57,10 @@
 #include <QClipboard>
 
 #include <marble/AbstractFloatItem.h>
+#include <marble/DownloadRegion.h>
 #include <marble/MarbleWidgetInputHandler.h>
 #include <marble/MarbleModel.h>
+#include <marble/TileCoordsPyramid.h>
 
 /* Stores delta values depending on fast or slow update. User aircraft is only updated if
  * delta values are exceeded. */
@@ -99,9 +101,37 @@ const int FUEL_ON_OFF_TIMEOUT = 1000;
 /* Update rate on tooltip for bearing display */
 const int MAX_SIM_UPDATE_TOOLTIP_MS = 500;
 
+/* Paint interval for the extrapolated aircraft position between simulator samples */
+const int AIRCRAFT_EXTRAPOLATION_UPDATE_MS = 100;
+
+/* Stop gap filling repaints when the last sample is older than this. Has to match the limit
+ * in the vehicle painter which falls back to the sample position then. */
+const qint64 AIRCRAFT_EXTRAPOLATION_MAX_MS = 2000;
+
+/* Raster in pixel for reusing the last tooltip query result while the cursor dwells over the same spot */
+const int TOOLTIP_QUERY_RASTER = 8;
+
+/* Margin around old and new aircraft position for partial repaints. Has to cover the
+ * largest symbol plus the attached text labels. */
+const int AIRCRAFT_DIRTY_RECT_MARGIN = 300;
+
+/* Height of the top strip containing the wind pointer which is included in partial repaints */
+const int AIRCRAFT_DIRTY_WIND_POINTER_HEIGHT = 100;
+
 // Disable center waypoint and aircraft if distance to flight plan is larger
 const float MAX_FLIGHT_PLAN_DIST_FOR_CENTER_NM = 50.f;
 
+/* Corridor width in degree added around each flight plan leg for the background map tile download */
+const float ROUTE_TILE_CORRIDOR_DEGREE = 0.5f;
+
+/* Delay after the view settled before the tiles around the viewport are prefetched.
+ * Avoids queueing downloads while the user is still panning or zooming through. */
+const int TILE_PREFETCH_DELAY_MS = 1000;
+
+/* Fraction of the viewport width and height added on each side for the tile prefetch area.
+ * 0.5 means a pan by up to half a screen finds all tiles already in the local cache. */
+const float TILE_PREFETCH_VIEWPORT_FACTOR = 0.5f;
+
 // Default zoom distance if start position was not set (usually first start after installation */
 const int DEFAULT_MAP_DISTANCE = 7000;
 
@@ -137,6 +167,10 @@ MapWidget::MapWidget(MainWindow *parent)
   elevationDisplayTimer.setSingleShot(true);
   connect(&elevationDisplayTimer, &QTimer::timeout, this, &MapWidget::elevationDisplayTimerTimeout);
 
+  tilePrefetchTimer.setInterval(TILE_PREFETCH_DELAY_MS);
+  tilePrefetchTimer.setSingleShot(true);
+  connect(&tilePrefetchTimer, &QTimer::timeout, this, &MapWidget::tilePrefetchTimeout);
+
   jumpBack = new JumpBack(this);
   connect(jumpBack, &JumpBack::jumpBack, this, &MapWidget::jumpBackToAircraftTimeout);
 
@@ -146,6 +180,9 @@ MapWidget::MapWidget(MainWindow *parent)
   fuelOnOffTimer.setSingleShot(true);
   connect(&fuelOnOffTimer, &QTimer::timeout, this, &MapWidget::fuelOnOffTimeout);
 
+  aircraftExtrapolationTimer.setInterval(AIRCRAFT_EXTRAPOLATION_UPDATE_MS);
+  connect(&aircraftExtrapolationTimer, &QTimer::timeout, this, &MapWidget::aircraftExtrapolationTimeout);
+
   // Fill overlay / action map ============================
   // "Compass" id "compass"
   // "License" id "license"
@@ -163,8 +200,10 @@ MapWidget::MapWidget(MainWindow *parent)
 MapWidget::~MapWidget()
 {
   elevationDisplayTimer.stop();
+  tilePrefetchTimer.stop();
   takeoffLandingTimer.stop();
   fuelOnOffTimer.stop();
+  aircraftExtrapolationTimer.stop();
 
   qDebug() << Q_FUNC_INFO << "removeEventFilter";
   removeEventFilter(this);
@@ -271,7 +310,7 @@ void MapWidget::handleInfoClick(QPoint point)
     NavApp::getRouteController()->debugNetworkClick(Pos(lon, lat));
 #endif
 
-  mapSearchResultInfoClick.clear();
+  // Result is cleared completely in getAllNearest
   getScreenIndexConst()->getAllNearest(point.x(), point.y(), screenSearchDistance, mapSearchResultInfoClick,
                                        map::QUERY_NONE /* For double click */);
 
@@ -338,6 +377,17 @@ void MapWidget::fuelOnOffTimeout()
   }
 }
 
+void MapWidget::aircraftExtrapolationTimeout()
+{
+  qint64 ageMs = QDateTime::currentMSecsSinceEpoch() - getScreenIndexConst()->getSimDataReceivedMs();
+
+  if(databaseLoadStatus || !NavApp::isConnectedAndAircraft() || ageMs > AIRCRAFT_EXTRAPOLATION_MAX_MS)
+    // Simulator stopped sending or is paused - the painter stopped extrapolating too
+    aircraftExtrapolationTimer.stop();
+  else if(!contextMenuActive)
+    update();
+}
+
 void MapWidget::takeoffLandingTimeout()
 {
   const atools::fs::sc::SimConnectUserAircraft aircraft = getScreenIndexConst()->getLastUserAircraft();
@@ -434,16 +484,22 @@ bool MapWidget::event(QEvent *event)
     {
       QHelpEvent *helpEvent = static_cast<QHelpEvent *>(event);
 
-      // Load tooltip data into mapSearchResultTooltip
-      mapSearchResultTooltip = map::MapResult();
-      getScreenIndexConst()->getAllNearest(helpEvent->pos().x(),
-                                           helpEvent->pos().y(), screenSearchDistanceTooltip,
-                                           mapSearchResultTooltip,
-                                           map::QUERY_PROC_POINTS | map::QUERY_HOLDS | map::QUERY_PATTERNS |
-                                           map::QUERY_RANGEMARKER);
-
-      NavApp::getOnlinedataController()->filterOnlineShadowAircraft(mapSearchResultTooltip.onlineAircraft,
-                                                                    mapSearchResultTooltip.aiAircraft);
+      // Reuse the last result if the cursor dwells in the same raster cell and the map did not
+      // change since. tooltipQueryPos is reset on all map changes which hide the tooltip.
+      QPoint queryPos(helpEvent->pos().x() / TOOLTIP_QUERY_RASTER, helpEvent->pos().y() / TOOLTIP_QUERY_RASTER);
+      if(queryPos != tooltipQueryPos || tooltipQueryPos.isNull())
+      {
+        // Load tooltip data into mapSearchResultTooltip - result is cleared in getAllNearest
+        getScreenIndexConst()->getAllNearest(helpEvent->pos().x(),
+                                             helpEvent->pos().y(), screenSearchDistanceTooltip,
+                                             mapSearchResultTooltip,
+                                             map::QUERY_PROC_POINTS | map::QUERY_HOLDS | map::QUERY_PATTERNS |
+                                             map::QUERY_RANGEMARKER);
+
+        NavApp::getOnlinedataController()->filterOnlineShadowAircraft(mapSearchResultTooltip.onlineAircraft,
+                                                                      mapSearchResultTooltip.aiAircraft);
+        tooltipQueryPos = queryPos;
+      }
 
       tooltipPos = helpEvent->globalPos();
 
@@ -461,6 +517,9 @@ void MapWidget::hideTooltip()
 {
   QToolTip::hideText();
   tooltipPos = QPoint();
+
+  // Invalidate the cached tooltip query result
+  tooltipQueryPos = QPoint();
 }
 
 void MapWidget::handleHistory()
@@ -470,6 +529,9 @@ void MapWidget::handleHistory()
     history.addEntry(Pos(centerLongitude(), centerLatitude()), distance());
 
   noStoreInHistory = false;
+
+  // View settled on a new position or zoom level - schedule the tile prefetch around the viewport
+  tilePrefetchTimer.start();
 }
 
 void MapWidget::updateTooltip()
@@ -2041,6 +2103,13 @@ void MapWidget::simDataChanged(const atools::fs::sc::SimConnectData& simulatorDa
   getScreenIndex()->updateSimData(simulatorData);
   const atools::fs::sc::SimConnectUserAircraft& last = getScreenIndexConst()->getLastUserAircraft();
 
+  if(paintLayer->getShownMapObjects() & map::AIRCRAFT && aircraft.isFlying())
+    // Restart repaints between samples - the timer only fires if no new sample
+    // arrives within its interval
+    aircraftExtrapolationTimer.start();
+  else
+    aircraftExtrapolationTimer.stop();
+
   simDataCalcTakeoffLanding(aircraft, last);
   simDataCalcFuelOnOff(aircraft, last);
 
@@ -2067,7 +2136,9 @@ void MapWidget::simDataChanged(const atools::fs::sc::SimConnectData& simulatorDa
   qDebug() << "widgetRectSmall" << widgetRectSmall;
 #endif
 
-  if(aircraftTrack->appendTrackPos(aircraft.getPosition(), aircraft.getZuluTime(), aircraft.isOnGround()))
+  bool trackPruned = aircraftTrack->appendTrackPos(aircraft.getPosition(), aircraft.getZuluTime(),
+                                                   aircraft.isOnGround());
+  if(trackPruned)
     emit aircraftTrackPruned();
 
   if(wasEmpty != aircraftTrack->isEmpty())
@@ -2262,8 +2333,28 @@ void MapWidget::simDataChanged(const atools::fs::sc::SimConnectData& simulatorDa
         setUpdatesEnabled(true);
 
       if((dataHasChanged || aiVisible) && !contextMenuActive)
+      {
         // Not scrolled or zoomed but needs a redraw
-        update();
+        map::MapObjectDisplayTypes displayTypes = paintLayer->getShownMapObjectDisplayTypes();
+        QPoint lastPoint = curPoint - diff;
+
+        if(!aiVisible && !trackPruned && viewContext() == Marble::Still &&
+           last.isValid() && curPosVisible && widgetRectSmall.contains(lastPoint) &&
+           !(displayTypes.testFlag(map::COMPASS_ROSE) && displayTypes.testFlag(map::COMPASS_ROSE_ATTACH)))
+        {
+          // Only the user aircraft moved a few pixels over a still map - repaint the united
+          // area around old and new position instead of the whole widget. The trail extension
+          // falls into the same area. The strip at the top covers the wind pointer.
+          QRect dirtyRect = QRect(curPoint, lastPoint).normalized().
+                            adjusted(-AIRCRAFT_DIRTY_RECT_MARGIN, -AIRCRAFT_DIRTY_RECT_MARGIN,
+                                     AIRCRAFT_DIRTY_RECT_MARGIN, AIRCRAFT_DIRTY_RECT_MARGIN);
+          update(dirtyRect.intersected(rect()));
+          update(QRect(0, 0, width(), AIRCRAFT_DIRTY_WIND_POINTER_HEIGHT));
+        }
+        else
+          // AI moved, trail was pruned or the compass rose is attached to the aircraft
+          update();
+      }
     }
   }
   else if(paintLayer->getShownMapObjects() & map::AIRCRAFT_TRACK)
@@ -2301,6 +2392,69 @@ void MapWidget::mainWindowShown()
   emit searchMarkChanged(searchMarkPos);
 }
 
+void MapWidget::downloadRouteTiles()
+{
+  qDebug() << Q_FUNC_INFO;
+
+  const Route& route = NavApp::getRouteConst();
+  if(route.isFlightplanEmpty())
+    return;
+
+  // Download all tile levels from zero up to the currently shown one
+  Marble::DownloadRegion region;
+  region.setMarbleModel(model());
+  region.setVisibleTileLevel(tileZoomLevel());
+  region.setTileLevelRange(0, tileZoomLevel());
+
+  // Collect the tile pyramids for a corridor around each flight plan leg including
+  // the legs to the alternate airports
+  QVector<Marble::TileCoordsPyramid> pyramid;
+  for(int i = 1; i < route.size(); i++)
+  {
+    atools::geo::Rect rect(route.value(i - 1).getPosition());
+    rect.extend(route.value(i).getPosition());
+    rect.inflate(ROUTE_TILE_CORRIDOR_DEGREE, ROUTE_TILE_CORRIDOR_DEGREE);
+
+    Marble::GeoDataLatLonAltBox box(rect.getNorth(), rect.getSouth(), rect.getEast(), rect.getWest(),
+                                    Marble::GeoDataCoordinates::Degree);
+    pyramid.append(region.region(textureLayer(), box));
+  }
+
+  // Queue the downloads - tiles already in the cache are skipped
+  downloadRegion(pyramid);
+
+  mainWindow->setStatusMessage(tr("Downloading map tiles along flight plan."));
+}
+
+void MapWidget::tilePrefetchTimeout()
+{
+  if(!active || viewContext() != Marble::Still || textureLayer() == nullptr)
+    return;
+
+  atools::geo::Rect rect = getCurrentViewRect();
+
+  // Skip for spherical projection showing the whole globe or other degenerated viewports
+  if(rect.getWidthDegree() >= 180.f || rect.getHeightDegree() >= 180.f ||
+     rect.getWidthDegree() < POS_IS_POINT_EPSILON || rect.getHeightDegree() < POS_IS_POINT_EPSILON)
+    return;
+
+  // Prefetch only the currently shown tile level - the lower levels were already fetched while zooming in
+  Marble::DownloadRegion region;
+  region.setMarbleModel(model());
+  region.setVisibleTileLevel(tileZoomLevel());
+  region.setTileLevelRange(tileZoomLevel(), tileZoomLevel());
+
+  // Grow the viewport so a moderate pan in any direction hits only cached tiles
+  rect.inflate(rect.getWidthDegree() * TILE_PREFETCH_VIEWPORT_FACTOR,
+               rect.getHeightDegree() * TILE_PREFETCH_VIEWPORT_FACTOR);
+
+  Marble::GeoDataLatLonAltBox box(rect.getNorth(), rect.getSouth(), rect.getEast(), rect.getWest(),
+                                  Marble::GeoDataCoordinates::Degree);
+
+  // Queue the downloads on the asynchronous Marble queue - tiles already in the cache are skipped
+  downloadRegion(region.region(textureLayer(), box));
+}
+
 void MapWidget::showSavedPosOnStartup()
 {
   qDebug() << Q_FUNC_INFO;
@@ -2451,9 +2605,26 @@ void MapWidget::optionsChanged()
 {
   screenSearchDistance = OptionData::instance().getMapClickSensitivity();
   screenSearchDistanceTooltip = OptionData::instance().getMapTooltipSensitivity();
+
+  // Cached tooltip texts depend on units and display options
+  mapTooltip->clearCache();
   MapPaintWidget::optionsChanged();
 }
 
+void MapWidget::routeChanged(bool geometryChanged)
+{
+  // Cached tooltip texts embed route flags like departure and destination
+  mapTooltip->clearCache();
+  MapPaintWidget::routeChanged(geometryChanged);
+}
+
+void MapWidget::postDatabaseLoad()
+{
+  // Object ids in the tooltip cache keys are not stable across database switches
+  mapTooltip->clearCache();
+  MapPaintWidget::postDatabaseLoad();
+}
+
 void MapWidget::saveState()
 {
   atools::settings::Settings& s = atools::settings::Settings::instance();
@@ -115,6 +115,11 @@ public:
   /* Show home position or last postion on map after program startup */
   void showSavedPosOnStartup();
 
+  /* Queue background downloads which warm the Marble tile cache in a corridor around the
+   * flight plan for the current map theme and zoom level. Allows to go offline with all
+   * needed background map tiles local. */
+  void downloadRouteTiles();
+
   /* Show or hide all map overlays (optionally excluding scalebar) */
   void showOverlays(bool show, bool showScalebar);
 
@@ -299,6 +304,9 @@ private:
   /* Display elevation at mouse cursor after a short timeout */
   void elevationDisplayTimerTimeout();
 
+  /* View was still for a moment - prefetch the map tiles around the current viewport */
+  void tilePrefetchTimeout();
+
   /* Start a line measurement after context menu selection or click+modifier */
   void addMeasurement(const atools::geo::Pos& pos, const map::MapResult& result);
   void addMeasurement(const atools::geo::Pos& pos, const map::MapAirport *airport, const map::MapVor *vor,
@@ -311,6 +319,9 @@ private:
   void takeoffLandingTimeout();
   void fuelOnOffTimeout();
 
+  /* Repaint between simulator samples so the extrapolated aircraft position is drawn */
+  void aircraftExtrapolationTimeout();
+
   void simDataCalcTakeoffLanding(const atools::fs::sc::SimConnectUserAircraft& aircraft,
                                  const atools::fs::sc::SimConnectUserAircraft& last);
   void simDataCalcFuelOnOff(const atools::fs::sc::SimConnectUserAircraft& aircraft,
@@ -335,6 +346,8 @@ private:
 
   /* MapPaintWidget overrides for UI updates mostly ============================================================ */
   virtual void optionsChanged() override;
+  virtual void routeChanged(bool geometryChanged) override;
+  virtual void postDatabaseLoad() override;
   virtual void overlayStateFromMenu() override;
   virtual void overlayStateToMenu() override;
   virtual void jumpBackToAircraftStart(bool saveDistance) override;
@@ -402,6 +415,10 @@ private:
 
   /* Save last tooltip position. If invalid/null no tooltip will be shown */
   QPoint tooltipPos;
+
+  /* Raster cell of the last tooltip query. Null if the cached result in mapSearchResultTooltip
+   * is invalid because the map changed. */
+  QPoint tooltipQueryPos;
   map::MapResult mapSearchResultTooltip;
   map::MapResult mapSearchResultInfoClick;
 
@@ -418,9 +435,16 @@ private:
   /* Delay display of elevation display to avoid lagging mouse movements */
   QTimer elevationDisplayTimer;
 
+  /* Waits until the view settled before prefetching the map tiles around the viewport */
+  QTimer tilePrefetchTimer;
+
   /* Delay takeoff and landing messages to avoid false recognition of bumpy landings */
   QTimer takeoffLandingTimer, fuelOnOffTimer;
 
+  /* Fills repaints into the gaps between simulator data samples. Restarted with every sample
+   * so it only fires when the data rate is lower than the paint rate. */
+  QTimer aircraftExtrapolationTimer;
+
   /* Simulator zulu time timestamp of takeoff event */
   qint64 takeoffTimeMs = 0L;
 
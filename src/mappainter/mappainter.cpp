@@ -21,6 +21,7 @@
 #include "navapp.h"
 #include "common/symbolpainter.h"
 #include "geo/calculations.h"
+#include "geo/linestring.h"
 #include "mapgui/mapwidget.h"
 #include "common/mapcolors.h"
 #include "common/maptypes.h"
@@ -36,6 +37,37 @@ using namespace Marble;
 using namespace atools::geo;
 using atools::roundToInt;
 
+namespace {
+
+/* Outcodes for the Cohen-Sutherland line clipping in MapPainter::drawLine below */
+enum ClipCode
+{
+  CLIP_INSIDE = 0,
+  CLIP_LEFT = 1 << 0,
+  CLIP_RIGHT = 1 << 1,
+  CLIP_BOTTOM = 1 << 2,
+  CLIP_TOP = 1 << 3
+};
+
+int clipCode(const QRectF& rect, double x, double y)
+{
+  int code = CLIP_INSIDE;
+
+  if(x < rect.left())
+    code |= CLIP_LEFT;
+  else if(x > rect.right())
+    code |= CLIP_RIGHT;
+
+  if(y < rect.top())
+    code |= CLIP_TOP;
+  else if(y > rect.bottom())
+    code |= CLIP_BOTTOM;
+
+  return code;
+}
+
+}
+
 void PaintContext::szFont(float scale) const
 {
   return mapcolors::scaleFont(painter, scale, &defaultFont);
@@ -91,6 +123,9 @@ MapPainter::MapPainter(MapPaintWidget *parentMapWidget, MapScale *mapScale, Pain
   waypointQuery = NavApp::getWaypointTrackQuery();
   airportQuery = NavApp::getAirportQuerySim();
   symbolPainter = new SymbolPainter();
+
+  // Covers all visible range rings plus a moving compass rose
+  circlePointCache.setMaxCost(100);
 }
 
 MapPainter::~MapPainter()
@@ -137,6 +172,22 @@ void MapPainter::paintCircle(GeoPainter *painter, const Pos& centerPos, float ra
   float radiusMeter = nmToMeter(radiusNm);
 
   int step = 360 / numPoints;
+
+  // Fetch or build the geographic ring points. They are the same for every frame as long as
+  // position, radius and the zoom dependent point count do not change - only the screen
+  // projection below has to run per frame.
+  QString key = QString::number(centerPos.getLonX()) + "_" + QString::number(centerPos.getLatY()) + "_" +
+                QString::number(radiusMeter) + "_" + QString::number(numPoints);
+  LineString *circlePoints = circlePointCache.object(key);
+  if(circlePoints == nullptr)
+  {
+    circlePoints = new LineString;
+    circlePoints->reserve(360 / step + 1);
+    for(int i = 0; i <= 360; i += step)
+      circlePoints->append(centerPos.endpoint(radiusMeter, i));
+    circlePointCache.insert(key, circlePoints);
+  }
+
   int x1, y1, x2 = -1, y2 = -1;
   xtext = -1;
   ytext = -1;
@@ -145,7 +196,7 @@ void MapPainter::paintCircle(GeoPainter *painter, const Pos& centerPos, float ra
   QVector<int> ytexts;
 
   // Use north endpoint of radius as start position
-  Pos startPoint = centerPos.endpoint(radiusMeter, 0);
+  Pos startPoint = circlePoints->first();
   Pos p1 = startPoint;
   bool hidden1 = true, hidden2 = true;
   bool visible1 = wToS(p1, x1, y1, DEFAULT_WTOS_SIZE, &hidden1);
@@ -153,10 +204,10 @@ void MapPainter::paintCircle(GeoPainter *painter, const Pos& centerPos, float ra
   bool ringVisible = false, lastVisible = false;
   LineString ellipse;
   // Draw ring segments and collect potential text positions
-  for(int i = 0; i <= 360; i += step)
+  for(int i = 0; i < circlePoints->size(); i++)
   {
     // Line segment from p1 to p2
-    Pos p2 = centerPos.endpoint(radiusMeter, i);
+    const Pos& p2 = circlePoints->at(i);
 
     bool visible2 = wToS(p2, x2, y2, DEFAULT_WTOS_SIZE, &hidden2);
 
@@ -237,17 +288,81 @@ void MapPainter::drawLineStraight(Marble::GeoPainter *painter, const atools::geo
 
 void MapPainter::drawLine(QPainter *painter, const QLineF& line)
 {
-  QRectF rect(line.p1(), line.p2());
-  // Add margins to avoid null width and height which will not intersect with viewport
-  rect = rect.normalized().marginsAdded(QMarginsF(1., 1., 1., 1.));
+  if(!atools::geo::lineValid(line))
+    return;
 
-  if(atools::geo::lineValid(line) && QRectF(painter->viewport()).intersects(rect))
+  if(painter->pen().style() != Qt::SolidLine)
   {
-    // if(line.intersect(QLineF(rect.topLeft(), rect.topRight()), nullptr) == QLineF::BoundedIntersection ||
-    // line.intersect(QLineF(rect.topRight(), rect.bottomRight()), nullptr) == QLineF::BoundedIntersection ||
-    // line.intersect(QLineF(rect.bottomRight(), rect.bottomLeft()), nullptr) == QLineF::BoundedIntersection ||
-    // line.intersect(QLineF(rect.bottomLeft(), rect.topLeft()), nullptr) == QLineF::BoundedIntersection)
-    painter->drawLine(line);
+    // Clipping would shift the dash phase while panning - hand patterned lines to QPainter
+    // unchanged if the bounding rectangle touches the viewport
+    QRectF rect(line.p1(), line.p2());
+    // Add margins to avoid null width and height which will not intersect with viewport
+    rect = rect.normalized().marginsAdded(QMarginsF(1., 1., 1., 1.));
+
+    if(QRectF(painter->viewport()).intersects(rect))
+      painter->drawLine(line);
+    return;
+  }
+
+  // Clip the segment with Cohen-Sutherland against the viewport plus a margin covering line
+  // width and caps so QPainter receives only the visible part instead of clipping long
+  // mostly off-screen lines internally
+  QRectF clipRect = QRectF(painter->viewport()).marginsAdded(QMarginsF(10., 10., 10., 10.));
+
+  double x1 = line.x1(), y1 = line.y1(), x2 = line.x2(), y2 = line.y2();
+  int code1 = clipCode(clipRect, x1, y1), code2 = clipCode(clipRect, x2, y2);
+
+  while(true)
+  {
+    if((code1 | code2) == CLIP_INSIDE)
+    {
+      // Both endpoints inside - draw the remaining segment
+      painter->drawLine(QPointF(x1, y1), QPointF(x2, y2));
+      return;
+    }
+    else if(code1 & code2)
+      // Both endpoints share an outside half plane - nothing visible
+      return;
+    else
+    {
+      // Move the outside endpoint onto the crossed clip rectangle border
+      int codeOut = code1 != CLIP_INSIDE ? code1 : code2;
+      double x = 0., y = 0.;
+
+      if(codeOut & CLIP_TOP)
+      {
+        x = x1 + (x2 - x1) * (clipRect.top() - y1) / (y2 - y1);
+        y = clipRect.top();
+      }
+      else if(codeOut & CLIP_BOTTOM)
+      {
+        x = x1 + (x2 - x1) * (clipRect.bottom() - y1) / (y2 - y1);
+        y = clipRect.bottom();
+      }
+      else if(codeOut & CLIP_RIGHT)
+      {
+        y = y1 + (y2 - y1) * (clipRect.right() - x1) / (x2 - x1);
+        x = clipRect.right();
+      }
+      else if(codeOut & CLIP_LEFT)
+      {
+        y = y1 + (y2 - y1) * (clipRect.left() - x1) / (x2 - x1);
+        x = clipRect.left();
+      }
+
+      if(codeOut == code1)
+      {
+        x1 = x;
+        y1 = y;
+        code1 = clipCode(clipRect, x1, y1);
+      }
+      else
+      {
+        x2 = x;
+        y2 = y;
+        code2 = clipCode(clipRect, x2, y2);
+      }
+    }
   }
 }
 
@@ -654,26 +769,85 @@ void MapPainter::getPixmap(QPixmap& pixmap, const QString& resource, int size)
 
 void MapPainter::paintTrack(Marble::GeoPainter *painter, const AircraftTrack& aircraftTrack, bool mercator)
 {
-  /* Specialize TrackAdapter for access to AircraftTrack */
-  struct Adapter :
-    public TrackAdapter
+  // Use a simplified track if available which keeps the error below half a pixel at the current zoom
+  float pixelPerMeter = scale->getPixelForMeter(1.f);
+  const QVector<int>& indexes =
+    aircraftTrack.getSimplifiedIndexes(pixelPerMeter > 0.f ? 0.5f / pixelPerMeter : 0.f);
+
+  // Projection and point merging only change with the viewport or the trail tail -
+  // reuse the merged polylines for all frames in between
+  const Marble::ViewportParams *viewport = context->viewport;
+  atools::geo::Pos lastPos = aircraftTrack.isEmpty() ? atools::geo::EMPTY_POS : aircraftTrack.last().pos;
+  QString cacheKey = QStringList({QString::number(viewport->projection()),
+                                  QString::number(viewport->radius()),
+                                  QString::number(viewport->centerLongitude()),
+                                  QString::number(viewport->centerLatitude()),
+                                  QString::number(viewport->width()),
+                                  QString::number(viewport->height()),
+                                  QString::number(aircraftTrack.size()),
+                                  QString::number(indexes.size()),
+                                  QString::number(lastPos.getLonX()),
+                                  QString::number(lastPos.getLatY())}).join('_');
+
+  if(cacheKey == trackPolylineCacheKey)
   {
-    virtual const atools::geo::Pos& at(int i) const
+    for(const QPolygon& polyline : trackPolylineCache)
+      painter->drawPolyline(polyline);
+    return;
+  }
+
+  trackPolylineCache.clear();
+  trackPolylineCacheKey = cacheKey;
+
+  if(!indexes.isEmpty())
+  {
+    /* Specialize TrackAdapter for access to the simplified AircraftTrack */
+    struct Adapter :
+      public TrackAdapter
     {
-      return track->at(i).pos;
-    }
+      virtual const atools::geo::Pos& at(int i) const
+      {
+        return track->at(indexes->at(i)).pos;
+      }
 
-    virtual int size() const
+      virtual int size() const
+      {
+        return indexes->size();
+      }
+
+      const AircraftTrack *track;
+      const QVector<int> *indexes;
+    } adapter;
+
+    adapter.track = &aircraftTrack;
+    adapter.indexes = &indexes;
+    buildTrackPolylines(trackPolylineCache, adapter, mercator);
+  }
+  else
+  {
+    /* Specialize TrackAdapter for access to AircraftTrack */
+    struct Adapter :
+      public TrackAdapter
     {
-      return track->size();
-    }
+      virtual const atools::geo::Pos& at(int i) const
+      {
+        return track->at(i).pos;
+      }
 
-    const AircraftTrack *track;
-  } adapter;
-  adapter.track = &aircraftTrack;
+      virtual int size() const
+      {
+        return track->size();
+      }
 
-  adapter.track = &aircraftTrack;
-  paintTrackInternal(painter, adapter, mercator);
+      const AircraftTrack *track;
+    } adapter;
+
+    adapter.track = &aircraftTrack;
+    buildTrackPolylines(trackPolylineCache, adapter, mercator);
+  }
+
+  for(const QPolygon& polyline : trackPolylineCache)
+    painter->drawPolyline(polyline);
 }
 
 void MapPainter::paintTrack(Marble::GeoPainter *painter, const atools::geo::LineString& linestring, bool mercator)
@@ -700,22 +874,44 @@ void MapPainter::paintTrack(Marble::GeoPainter *painter, const atools::geo::Line
 }
 
 void MapPainter::paintTrackInternal(Marble::GeoPainter *painter, const TrackAdapter& linestring, bool mercator)
+{
+  QVector<QPolygon> polylines;
+  buildTrackPolylines(polylines, linestring, mercator);
+
+  for(const QPolygon& polyline : polylines)
+    painter->drawPolyline(polyline);
+}
+
+void MapPainter::buildTrackPolylines(QVector<QPolygon>& polylines, const TrackAdapter& linestring, bool mercator)
 {
   if(linestring.size() > 0)
   {
+    // Collect the positions and project all of them to screen in one call
+    LineString positions;
+    positions.reserve(linestring.size());
+    for(int i = 0; i < linestring.size(); i++)
+      positions.append(linestring.at(i));
+
+    QVector<QPointF> screenPoints;
+    QVector<bool> visiblePoints, hiddenPoints;
+    wToS(positions, screenPoints, visiblePoints, hiddenPoints);
+
     QPolygon polyline;
 
     bool visible1 = false;
     int x1, y1;
     int x2 = -1, y2 = -1;
     bool hidden1, hidden2;
-    QRect vpRect(painter->viewport());
-    wToS(linestring.at(0), x1, y1, DEFAULT_WTOS_SIZE, &hidden1);
+    QRect vpRect(context->painter->viewport());
+    x1 = roundToInt(screenPoints.at(0).x());
+    y1 = roundToInt(screenPoints.at(0).y());
+    hidden1 = hiddenPoints.at(0);
 
     for(int i = 1; i < linestring.size(); i++)
     {
-      const Pos& trackPos = linestring.at(i);
-      wToS(trackPos, x2, y2, DEFAULT_WTOS_SIZE, &hidden2);
+      x2 = roundToInt(screenPoints.at(i).x());
+      y2 = roundToInt(screenPoints.at(i).y());
+      hidden2 = hiddenPoints.at(i);
 
       QRect rect(QPoint(x1, y1), QPoint(x2, y2));
       rect = rect.normalized();
@@ -746,8 +942,8 @@ void MapPainter::paintTrackInternal(Marble::GeoPainter *painter, const TrackAdap
 
       if(visible1 && !visible2)
       {
-        // Not visible anymore draw previous line segment
-        painter->drawPolyline(polyline);
+        // Not visible anymore - complete previous line segment
+        polylines.append(polyline);
         polyline.clear();
       }
 
@@ -757,11 +953,11 @@ void MapPainter::paintTrackInternal(Marble::GeoPainter *painter, const TrackAdap
       hidden1 = hidden2;
     }
 
-    // Draw rest
+    // Add rest
     if(!polyline.isEmpty())
     {
       polyline.append(QPoint(x2, y2));
-      painter->drawPolyline(polyline);
+      polylines.append(polyline);
     }
   }
 }
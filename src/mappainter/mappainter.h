@@ -24,7 +24,9 @@
 #include "geo/rect.h"
 
 #include <marble/MarbleWidget.h>
+#include <QCache>
 #include <QPen>
+#include <QSharedPointer>
 #include <QApplication>
 
 namespace atools {
@@ -82,6 +84,9 @@ struct PaintContext
               userPointTypesAll; /* All available tyes */
   bool userPointTypeUnknown; /* Show unknown types */
 
+  /* Immutable route snapshot for this frame. The shared pointer keeps the snapshot alive
+   * while painting even if the controller publishes a new one. route points into it. */
+  QSharedPointer<const Route> routeSnapshot;
   const Route *route;
 
   // All waypoints from the route and add them to the map to avoid duplicate drawing
@@ -257,7 +262,8 @@ protected:
   /* No GC and no rhumb */
   void drawLineStraight(Marble::GeoPainter *painter, const atools::geo::Line& line);
 
-  /* Save versions of drawLine which check for valid coordinates and bounds */
+  /* Save versions of drawLine which check for valid coordinates and bounds. Solid lines are
+   * clipped against the viewport before drawing so QPainter receives only the visible part. */
   void drawLine(QPainter *painter, const QLineF& line);
 
   void drawLine(QPainter *painter, const QLine& line)
@@ -332,6 +338,19 @@ private:
   /* Draw a long line with many small segments and optimize drawing */
   void paintTrackInternal(Marble::GeoPainter *painter, const TrackAdapter& linestring, bool mercator);
 
+  /* Project the points and merge them into screen polylines without drawing */
+  void buildTrackPolylines(QVector<QPolygon>& polylines, const TrackAdapter& linestring, bool mercator);
+
+  /* Geographic circle points for paintCircle keyed by center, radius and point count. The
+   * points depend only on these inputs while the number of points changes with the zoom
+   * distance. Only the screen projection has to run for every frame. */
+  QCache<QString, atools::geo::LineString> circlePointCache;
+
+  /* Merged screen polylines of the user aircraft trail. Valid until the viewport or the
+   * trail tail changes which avoids reprojecting and merging thousands of points per frame. */
+  QVector<QPolygon> trackPolylineCache;
+  QString trackPolylineCacheKey;
+
 };
 
 #endif // LITTLENAVMAP_MAPPAINTER_H
@@ -18,6 +18,7 @@
 #include "mappainter/mappainteraircraft.h"
 
 #include "mapgui/mapwidget.h"
+#include "common/symbolpainter.h"
 #include "navapp.h"
 #include "online/onlinedatacontroller.h"
 #include "mapgui/mapfunctions.h"
@@ -33,6 +34,11 @@ const int NUM_CLOSEST_AI_LABELS = 5;
 const float DIST_METER_CLOSEST_AI_LABELS = atools::geo::nmToMeter(20);
 const float DIST_FT_CLOSEST_AI_LABELS = 5000;
 
+/* Aircraft closer together on screen than this are collapsed into the one nearest to the user
+ * which gets a count badge. Keeps busy online events readable and bounds the paint cost.
+ * Zooming in expands the groups again since the threshold is in pixels. */
+const int CLUSTER_DIST_PIXEL = 32;
+
 MapPainterAircraft::MapPainterAircraft(MapPaintWidget *mapWidget, MapScale *mapScale, PaintContext *paintContext)
   : MapPainterVehicle(mapWidget, mapScale, paintContext)
 {
@@ -83,6 +89,9 @@ void MapPainterAircraft::render()
     {
       const SimConnectAircraft *aircraft;
       float distanceLateralMeter, distanceVerticalFt;
+      float x, y; /* Screen position - only valid if paint is true */
+      int hiddenAircraft; /* Number of overlapping aircraft collapsed into this one */
+      bool paint; /* false if filtered out by layer or hidden behind a closer aircraft */
     };
 
     QVector<AiDistType> aiSorted;
@@ -90,7 +99,8 @@ void MapPainterAircraft::render()
     for(const SimConnectAircraft *ac : allAircraft)
       aiSorted.append({ac,
                        pos.distanceMeterTo(ac->getPosition()),
-                       std::abs(pos.getAltitude() - ac->getPosition().getAltitude())});
+                       std::abs(pos.getAltitude() - ac->getPosition().getAltitude()),
+                       0.f, 0.f, 0, false});
 
     std::sort(aiSorted.begin(), aiSorted.end(), [](const AiDistType& ai1,
                                                    const AiDistType& ai2) -> bool
@@ -99,15 +109,70 @@ void MapPainterAircraft::render()
       return ai1.distanceLateralMeter > ai2.distanceLateralMeter;
     });
 
+    // Thin out dense traffic ====================================================================
+    // Aircraft within the pixel threshold are collapsed into one group. Walks from the nearest
+    // to the farthest so the aircraft closest to the user survives as the group representative.
+    float clusterDistPixel = context->sz(context->symbolSizeAircraftAi, CLUSTER_DIST_PIXEL);
+
+    // Grid cell to index of the representative in aiSorted - allows lookup without comparing
+    // against all accepted aircraft
+    QHash<QPair<int, int>, int> cellToAircraft;
+
+    for(int i = aiSorted.size() - 1; i >= 0; i--)
+    {
+      AiDistType& adt = aiSorted[i];
+      if(!mapfunc::aircraftVisible(*adt.aircraft, context->mapLayer))
+        continue;
+
+      bool hidden = false;
+      float x, y;
+      if(!wToS(adt.aircraft->getPosition(), x, y, DEFAULT_WTOS_SIZE, &hidden) || hidden)
+        continue;
+
+      int xCell = static_cast<int>(x / clusterDistPixel), yCell = static_cast<int>(y / clusterDistPixel);
+
+      // Look for an already accepted aircraft within the threshold in this and all neighboring cells
+      int repIndex = -1;
+      for(int dx = -1; dx <= 1 && repIndex == -1; dx++)
+      {
+        for(int dy = -1; dy <= 1 && repIndex == -1; dy++)
+        {
+          int idx = cellToAircraft.value({xCell + dx, yCell + dy}, -1);
+          if(idx != -1 && (QPointF(x, y) - QPointF(aiSorted.at(idx).x, aiSorted.at(idx).y)).manhattanLength() <
+             clusterDistPixel)
+            repIndex = idx;
+        }
+      }
+
+      if(repIndex != -1)
+        // Too close to a nearer aircraft - count it into the group instead of drawing
+        aiSorted[repIndex].hiddenAircraft++;
+      else
+      {
+        adt.paint = true;
+        adt.x = x;
+        adt.y = y;
+        cellToAircraft.insert({xCell, yCell}, i);
+      }
+    }
+
     int num = aiSorted.size();
     for(const AiDistType& adt : aiSorted)
     {
-      const SimConnectAircraft& ac = *adt.aircraft;
-      if(mapfunc::aircraftVisible(ac, context->mapLayer))
+      num--;
+      if(!adt.paint)
+        continue;
+
+      paintAiVehicle(*adt.aircraft, num < NUM_CLOSEST_AI_LABELS &&
+                     adt.distanceLateralMeter < DIST_METER_CLOSEST_AI_LABELS &&
+                     adt.distanceVerticalFt < DIST_FT_CLOSEST_AI_LABELS);
+
+      if(adt.hiddenAircraft > 0)
       {
-        paintAiVehicle(ac, --num < NUM_CLOSEST_AI_LABELS &&
-                       adt.distanceLateralMeter < DIST_METER_CLOSEST_AI_LABELS &&
-                       adt.distanceVerticalFt < DIST_FT_CLOSEST_AI_LABELS);
+        // Show how many overlapping aircraft were collapsed into this symbol
+        context->szFont(context->textSizeAircraftAi);
+        symbolPainter->textBoxF(context->painter, {tr("+%1").arg(adt.hiddenAircraft)}, QPen(Qt::black),
+                                adt.x + clusterDistPixel / 2.f, adt.y - clusterDistPixel / 2.f, textatt::NONE, 255);
       }
     }
   }
@@ -122,7 +187,9 @@ void MapPainterAircraft::render()
 
       bool hidden = false;
       float x, y;
-      if(wToS(pos, x, y, DEFAULT_WTOS_SIZE, &hidden))
+      // Draw at the position estimated from the age of the sample to keep the symbol
+      // moving smoothly with low simulator data rates
+      if(wToS(extrapolatedPosition(userAircraft), x, y, DEFAULT_WTOS_SIZE, &hidden))
       {
         if(!hidden)
           paintUserAircraft(userAircraft, x, y);
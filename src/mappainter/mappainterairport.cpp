@@ -118,6 +118,40 @@ void MapPainterAirport::render()
 
   std::sort(visibleAirports.begin(), visibleAirports.end(), sortAirportFunction);
 
+  // At low zoom levels most symbols collapse onto the same few pixels. Keep only the topmost
+  // airport per grid cell of symbol size - the sort order puts it last - and draw one symbol
+  // instead of a stack of identical dots. Layers showing idents or more are not thinned out.
+  if(!context->mapLayer->isAirportIdent() && !context->mapLayerEffective->isAirportDiagramRunway() &&
+     visibleAirports.size() > 1)
+  {
+    int cellSize = std::max(context->sz(context->symbolSizeAirport, context->mapLayer->getAirportSymbolSize()), 4);
+    auto cellKey = [cellSize](const QPointF& point) -> qint64
+    {
+      return (static_cast<qint64>(static_cast<int>(point.x()) / cellSize) << 32) |
+             static_cast<quint32>(static_cast<int>(point.y()) / cellSize);
+    };
+
+    // Grid cell to index of the topmost airport in the cell - later airports overwrite earlier ones
+    QHash<qint64, int> cells;
+    for(int i = 0; i < visibleAirports.size(); i++)
+    {
+      if(!context->routeIdMap.contains(visibleAirports.at(i).airport->getRef()))
+        cells.insert(cellKey(visibleAirports.at(i).point), i);
+    }
+
+    QList<PaintAirportType> declutteredAirports;
+    declutteredAirports.reserve(cells.size());
+    for(int i = 0; i < visibleAirports.size(); i++)
+    {
+      const PaintAirportType& airport = visibleAirports.at(i);
+
+      // Always keep flight plan airports
+      if(context->routeIdMap.contains(airport.airport->getRef()) || cells.value(cellKey(airport.point)) == i)
+        declutteredAirports.append(airport);
+    }
+    visibleAirports = declutteredAirports;
+  }
+
   if(context->mapLayerEffective->isAirportDiagramRunway() && context->flags2 & opts2::MAP_AIRPORT_BOUNDARY)
   {
     // In diagram mode draw background first to avoid overwriting other airports
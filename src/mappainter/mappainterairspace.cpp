@@ -21,6 +21,8 @@
 #include "util/paintercontextsaver.h"
 #include "route/route.h"
 #include "mapgui/maplayer.h"
+#include "mapgui/mappaintwidget.h"
+#include "mapgui/mapscale.h"
 #include "query/mapquery.h"
 #include "airspace/airspacecontroller.h"
 #include "navapp.h"
@@ -36,6 +38,10 @@ using namespace Marble;
 using namespace atools::geo;
 using namespace map;
 
+/* Airspaces with a bounding rectangle below this size on screen are skipped. Invisible at low
+ * zoom but still expensive to tessellate and fill. */
+static const int MIN_AIRSPACE_SIZE_PIXEL = 3;
+
 MapPainterAirspace::MapPainterAirspace(MapPaintWidget *mapWidget, MapScale *mapScale, PaintContext *paintContext)
   : MapPainter(mapWidget, mapScale, paintContext)
 {
@@ -63,9 +69,14 @@ void MapPainterAirspace::render()
   if(context->objectTypes.testFlag(map::AIRSPACE))
   {
     // qDebug() << Q_FUNC_INFO << "NON ONLINE";
-    controller->getAirspaces(airspaces, curBox, context->mapLayer, context->airspaceFilterByLayer,
-                             context->route->getCruisingAltitudeFeet(),
-                             context->viewContext == Marble::Animation, map::AIRSPACE_SRC_ALL);
+    // Incremental: at most one source runs its database queries per frame while the others
+    // keep painting their last cached lists
+    if(!controller->getAirspaces(airspaces, curBox, context->mapLayer, context->airspaceFilterByLayer,
+                                 context->route->getCruisingAltitudeFeet(),
+                                 context->viewContext == Marble::Animation, map::AIRSPACE_SRC_ALL,
+                                 true /* incremental */))
+      // Sources are still pending - schedule another paint which loads the next one
+      mapPaintWidget->scheduleUpdate();
   }
 
   if(!airspaces.isEmpty())
@@ -76,6 +87,8 @@ void MapPainterAirspace::render()
 
     painter->setBackgroundMode(Qt::TransparentMode);
 
+    float pixelPerMeter = scale->getPixelForMeter(1.f);
+
     for(const MapAirspace *airspace : airspaces)
     {
       if(!(airspace->type & context->airspaceFilterByLayer.types))
@@ -83,6 +96,11 @@ void MapPainterAirspace::render()
 
       if(context->viewportRect.overlaps(airspace->bounding))
       {
+        // Skip sub-pixel airspaces before fetching and projecting the geometry
+        QSize size = scale->getScreeenSizeForRect(airspace->bounding);
+        if(size.width() < MIN_AIRSPACE_SIZE_PIXEL && size.height() < MIN_AIRSPACE_SIZE_PIXEL)
+          continue;
+
         if(context->objCount())
           return;
 
@@ -96,7 +114,10 @@ void MapPainterAirspace::render()
         if(!context->drawFast)
           painter->setBrush(mapcolors::colorForAirspaceFill(*airspace));
 
-        const LineString *lines = controller->getAirspaceGeometry(airspace->combinedId());
+        // Use a simplified boundary with an error below one pixel at the current zoom
+        const LineString *lines =
+          controller->getSimplifiedAirspaceGeometry(airspace->combinedId(),
+                                                    pixelPerMeter > 0.f ? 1.f / pixelPerMeter : 0.f);
 
         if(lines != nullptr)
         {
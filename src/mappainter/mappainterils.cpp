@@ -61,7 +61,8 @@ void MapPainterIls::render()
       {
         int x, y;
         // Need to get the real ILS size on the screen for mercator projection - otherwise feather may vanish
-        bool visible = wToS(ils.position, x, y, scale->getScreeenSizeForRect(ils.bounding));
+        QSize size = scale->getScreeenSizeForRect(ils.bounding);
+        bool visible = wToS(ils.position, x, y, size);
 
         if(!visible)
           // Check bounding rect for visibility
@@ -72,14 +73,14 @@ void MapPainterIls::render()
           if(context->objCount())
             return;
 
-          drawIlsSymbol(ils);
+          drawIlsSymbol(ils, size);
         }
       }
     }
   }
 }
 
-void MapPainterIls::drawIlsSymbol(const map::MapIls& ils)
+void MapPainterIls::drawIlsSymbol(const map::MapIls& ils, const QSize& size)
 {
   atools::util::PainterContextSaver saver(context->painter);
 
@@ -87,7 +88,6 @@ void MapPainterIls::drawIlsSymbol(const map::MapIls& ils)
   context->painter->setBrush(mapcolors::ilsFillColor);
   context->painter->setPen(QPen(mapcolors::ilsSymbolColor, 2, Qt::SolidLine, Qt::FlatCap));
 
-  QSize size = scale->getScreeenSizeForRect(ils.bounding);
   bool visible;
   // Use visible dummy here since we need to call the method that also returns coordinates outside the screen
   QPoint pmid = wToS(ils.posmid, size, &visible);
@@ -46,7 +46,9 @@ private:
   static Q_DECL_CONSTEXPR int FEATHER_LEN_NM = 9;
   static Q_DECL_CONSTEXPR int MIN_LENGHT_FOR_TEXT = 40;
 
-  void drawIlsSymbol(const map::MapIls& ils);
+  /* Draw feather and text. size is the screen size of the bounding rectangle already
+   * calculated for the visibility check. */
+  void drawIlsSymbol(const map::MapIls& ils, const QSize& size);
 
 };
 
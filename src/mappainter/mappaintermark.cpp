@@ -40,6 +40,7 @@
 #include "common/textplacement.h"
 #include "mapgui/mapmarkhandler.h"
 #include "fs/userdata/logdatamanager.h"
+#include "logbook/logdatacontroller.h"
 #include "mapgui/mapscreenindex.h"
 
 #include <marble/GeoDataLineString.h>
@@ -97,7 +98,7 @@ void MapPainterMark::render()
   context->painter->setPen(QPen(QColor(0, 0, 255, 50), 10, Qt::SolidLine, Qt::RoundCap));
   MapScreenIndex *screenIndex = mapPaintWidget->getScreenIndex();
   screenIndex->updateAirwayScreenGeometry(mapPaintWidget->getCurrentViewBoundingBox());
-  QList<std::pair<int, QLine> > airwayLines = screenIndex->getAirwayLines();
+  QVector<std::pair<int, QLine> > airwayLines = screenIndex->getAirwayLines();
   for(std::pair<int, QLine> pair: airwayLines)
     context->painter->drawLine(pair.second);
 #endif
@@ -385,7 +386,15 @@ void MapPainterMark::paintLogEntries(const QList<map::MapLogbookEntry>& entries)
       // Limit number of visible tracks
       if(context->objectDisplayTypes & map::LOGBOOK_TRACK && visibleTrackGeometries.size() < 10 &&
          context->viewportRect.overlaps(geometry->trackRect))
-        visibleTrackGeometries.append(&geometry->track);
+      {
+        // Use a simplified trail which keeps the error below half a pixel at the current zoom
+        float pixelPerMeter = scale->getPixelForMeter(1.f);
+        const atools::geo::LineString *track = NavApp::getLogdataController()->
+                                               getSimplifiedTrackGeometry(entry.id, pixelPerMeter > 0.f ?
+                                                                          0.5f / pixelPerMeter : 0.f);
+        if(track != nullptr)
+          visibleTrackGeometries.append(track);
+      }
     }
   }
 
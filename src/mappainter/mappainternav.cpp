@@ -20,6 +20,7 @@
 #include "common/symbolpainter.h"
 #include "common/mapcolors.h"
 #include "common/unit.h"
+#include "geo/linestring.h"
 #include "mapgui/mapwidget.h"
 #include "common/textplacement.h"
 #include "util/paintercontextsaver.h"
@@ -63,9 +64,9 @@ void MapPainterNav::render()
   if(drawAirway && !context->isOverflow())
   {
     // Draw airway lines
-    QList<MapAirway> airways;
-    airwayQuery->getAirways(airways, curBox, context->mapLayer, context->lazyUpdate);
-    paintAirways(&airways, context->drawFast);
+    const QList<MapAirway> *airways = airwayQuery->getAirways(curBox, context->mapLayer, context->lazyUpdate);
+    if(airways != nullptr)
+      paintAirways(airways, context->drawFast);
   }
 
   // Tracks -------------------------------------------------
@@ -73,9 +74,9 @@ void MapPainterNav::render()
   if(drawTrack && !context->isOverflow())
   {
     // Draw track lines
-    QList<MapAirway> tracks;
-    airwayQuery->getTracks(tracks, curBox, context->mapLayer, context->lazyUpdate);
-    paintAirways(&tracks, context->drawFast);
+    const QList<MapAirway> *tracks = airwayQuery->getTracks(curBox, context->mapLayer, context->lazyUpdate);
+    if(tracks != nullptr)
+      paintAirways(tracks, context->drawFast);
   }
 
   context->szFont(context->textSizeNavaid);
@@ -154,6 +155,19 @@ void MapPainterNav::paintAirways(const QList<MapAirway> *airways, bool fast)
   QPolygonF arrowTrack = buildArrow(static_cast<float>(linewidthTrack * 2.5));
   Marble::GeoPainter *painter = context->painter;
 
+  // Project all segment endpoints to screen in one call - only the visibility flags are used below
+  LineString endpoints;
+  endpoints.reserve(airways->size() * 2);
+  for(const MapAirway& airway : *airways)
+  {
+    endpoints.append(airway.from);
+    endpoints.append(airway.to);
+  }
+
+  QVector<QPointF> endpointsScreen;
+  QVector<bool> endpointsVisible, endpointsHidden;
+  wToS(endpoints, endpointsScreen, endpointsVisible, endpointsHidden);
+
   for(int i = 0; i < airways->size(); i++)
   {
     const MapAirway& airway = airways->at(i);
@@ -172,10 +186,9 @@ void MapPainterNav::paintAirways(const QList<MapAirway> *airways, bool fast)
     painter->setPen(QPen(mapcolors::colorForAirwayTrack(airway), isTrack ? linewidthTrack : linewidthAirway));
     painter->setBrush(painter->pen().color());
 
-    // Get start and end point of airway segment in screen coordinates
-    int x1, y1, x2, y2;
-    bool visible1 = wToS(airway.from, x1, y1);
-    bool visible2 = wToS(airway.to, x2, y2);
+    // Get visibility of start and end point of the airway segment from the batch conversion
+    bool visible1 = endpointsVisible.at(i * 2);
+    bool visible2 = endpointsVisible.at(i * 2 + 1);
 
     if(!visible1 && !visible2)
     {
@@ -192,7 +205,19 @@ void MapPainterNav::paintAirways(const QList<MapAirway> *airways, bool fast)
       if(context->objCount())
         return;
 
-      drawLine(painter, Line(airway.from, airway.to));
+      const QPointF& from = endpointsScreen.at(i * 2);
+      const QPointF& to = endpointsScreen.at(i * 2 + 1);
+
+      if(fast && !endpointsHidden.at(i * 2) && !endpointsHidden.at(i * 2 + 1) &&
+         std::abs(from.x() - to.x()) < context->screenRect.width() &&
+         std::abs(from.y() - to.y()) < context->screenRect.height())
+        // Fast drawing during animations reuses the batch projected endpoints and hands
+        // QPainter a straight segment clipped to the viewport. The full paint afterwards
+        // replaces this with the tessellated great circle path. The size check above catches
+        // segments wrapping around the anti-meridian which need the slow path.
+        drawLine(painter, QLineF(from, to));
+      else
+        drawLine(painter, Line(airway.from, airway.to));
 
       if(!fast)
       {
@@ -265,6 +290,10 @@ void MapPainterNav::paintAirways(const QList<MapAirway> *airways, bool fast)
 
   TextPlacement textPlacement(painter, this, QRect());
 
+  // Drop labels which would be drawn on top of an already placed one
+  LabelCollisionGrid labelGrid;
+  labelGrid.init(painter->viewport());
+
   // Draw texts ----------------------------------------
   if(!textlist.isEmpty())
   {
@@ -285,8 +314,11 @@ void MapPainterNav::paintAirways(const QList<MapAirway> *airways, bool fast)
 
       // First find text position with incomplete text
       QString text = place.texts.join(tr(", "));
-      if(textPlacement.findTextPos(airway.from, airway.to, metrics.width(text), metrics.height() * 2,
-                                   xt, yt, &textBearing))
+      int textWidth = metrics.width(text), textHeight = metrics.height() * 2;
+
+      // Use the axis aligned rectangle around the center as an approximation for the rotated label
+      if(textPlacement.findTextPos(airway.from, airway.to, textWidth, textHeight, xt, yt, &textBearing) &&
+         labelGrid.insertIfFree(QRect(xt - textWidth / 2, yt - textHeight / 2, textWidth, textHeight)))
       {
         // Prepend arrows to all texts
         for(int j = 0; j < place.texts.size(); ++j)
@@ -322,6 +354,12 @@ void MapPainterNav::paintWaypoints(const QList<MapWaypoint> *waypoints, bool dra
 
   bool fill = context->flags2 & opts2::MAP_NAVAID_TEXT_BACKGROUND;
 
+  // All these depend only on layer and options - evaluate them outside of the loop
+  bool drawWaypointName = context->mapLayer->isWaypointName();
+  bool drawAirwayIdent = context->mapLayer->isAirwayIdent();
+  bool drawTrackIdent = context->mapLayer->isTrackIdent();
+  int size = context->sz(context->symbolSizeNavaid, context->mapLayerEffective->getWaypointSymbolSize());
+
   // Use margins for text placed on the right side of the object to avoid disappearing at the left screen border
   QMargins margins(50, 10, 10, 10);
   for(const MapWaypoint& waypoint : *waypoints)
@@ -340,14 +378,13 @@ void MapPainterNav::paintWaypoints(const QList<MapWaypoint> *waypoints, bool dra
       if(context->objCount())
         return;
 
-      int size = context->sz(context->symbolSizeNavaid, context->mapLayerEffective->getWaypointSymbolSize());
       symbolPainter->drawWaypointSymbol(context->painter, QColor(), x, y, size, false);
 
       // If airways are drawn force display of the respecive waypoints
-      if(context->mapLayer->isWaypointName() || // Draw all waypoint names or ...
-         (context->mapLayer->isAirwayIdent() && // Draw names for specific airway waypoints
+      if(drawWaypointName || // Draw all waypoint names or ...
+         (drawAirwayIdent && // Draw names for specific airway waypoints
           ((drawAirwayV && waypoint.hasVictorAirways) || (drawAirwayJ && waypoint.hasJetAirways))) ||
-         (context->mapLayer->isTrackIdent() && // Draw names for specific airway waypoints
+         (drawTrackIdent && // Draw names for specific airway waypoints
           (drawTrack && waypoint.hasTracks)))
         symbolPainter->drawWaypointText(context->painter, waypoint, x, y, textflags::IDENT, size, fill);
     }
@@ -366,6 +403,13 @@ void MapPainterNav::paintVors(const QList<MapVor> *vors, bool drawFast)
   int margin = std::max(vorSize, size);
   QMargins margins(margin, margin, std::max(margin, 50), margin);
 
+  // Text content depends only on the layer - evaluate outside of the loop
+  textflags::TextFlags flags;
+  if(context->mapLayer->isVorInfo())
+    flags = textflags::IDENT | textflags::TYPE | textflags::FREQ;
+  else if(context->mapLayer->isVorIdent())
+    flags = textflags::IDENT;
+
   for(const MapVor& vor : *vors)
   {
     if(context->routeIdMap.contains(vor.getRef()))
@@ -378,14 +422,6 @@ void MapPainterNav::paintVors(const QList<MapVor> *vors, bool drawFast)
         return;
 
       symbolPainter->drawVorSymbol(context->painter, vor, x, y, size, false, drawFast, vorSize);
-
-      textflags::TextFlags flags;
-
-      if(context->mapLayer->isVorInfo())
-        flags = textflags::IDENT | textflags::TYPE | textflags::FREQ;
-      else if(context->mapLayer->isVorIdent())
-        flags = textflags::IDENT;
-
       symbolPainter->drawVorText(context->painter, vor, x, y, flags, size, fill);
     }
   }
@@ -400,6 +436,13 @@ void MapPainterNav::paintNdbs(const QList<MapNdb> *ndbs, bool drawFast)
   // Use margins for text placed on the bottom of the object to avoid disappearing at the top screen border
   QMargins margins(size, std::max(size, 50), size, size);
 
+  // Text content depends only on the layer - evaluate outside of the loop
+  textflags::TextFlags flags;
+  if(context->mapLayer->isNdbInfo())
+    flags = textflags::IDENT | textflags::TYPE | textflags::FREQ;
+  else if(context->mapLayer->isNdbIdent())
+    flags = textflags::IDENT;
+
   for(const MapNdb& ndb : *ndbs)
   {
     if(context->routeIdMap.contains(ndb.getRef()))
@@ -412,14 +455,6 @@ void MapPainterNav::paintNdbs(const QList<MapNdb> *ndbs, bool drawFast)
         return;
 
       symbolPainter->drawNdbSymbol(context->painter, x, y, size, false, drawFast);
-
-      textflags::TextFlags flags;
-
-      if(context->mapLayer->isNdbInfo())
-        flags = textflags::IDENT | textflags::TYPE | textflags::FREQ;
-      else if(context->mapLayer->isNdbIdent())
-        flags = textflags::IDENT;
-
       symbolPainter->drawNdbText(context->painter, ndb, x, y, flags, size, fill);
     }
   }
@@ -47,6 +47,8 @@ namespace ageo = atools::geo;
 MapPainterRoute::MapPainterRoute(MapPaintWidget *mapWidget, MapScale *mapScale, PaintContext *paintContext)
   : MapPainter(mapWidget, mapScale, paintContext)
 {
+  // Large enough to cover all visible legs of a long oceanic plan
+  routeLineCache.setMaxCost(500);
 }
 
 MapPainterRoute::~MapPainterRoute()
@@ -268,31 +270,31 @@ void MapPainterRoute::drawRouteInternal(QStringList routeTexts, QVector<Line> li
       // Draw gray line for passed legs
       painter->setPen(routePassedPen);
       for(int i = 0; i < passedRouteLeg; i++)
-        drawLine(painter, lines.at(i));
+        drawRouteLine(painter, lines.at(i));
 
       painter->setPen(routeAlternateOutlinePen);
       if(alternateOffset != map::INVALID_INDEX_VALUE)
       {
         for(int idx = alternateOffset; idx < alternateOffset + route->getNumAlternateLegs(); idx++)
-          drawLine(painter, lines.at(idx - 1));
+          drawRouteLine(painter, lines.at(idx - 1));
       }
 
       // Draw background for legs ahead
       painter->setPen(routeOutlinePen);
       for(int i = passedRouteLeg; i < route->getDestinationAirportLegIndex(); i++)
-        drawLine(painter, lines.at(i));
+        drawRouteLine(painter, lines.at(i));
 
       // Draw center line for legs ahead
       painter->setPen(routePen);
       for(int i = passedRouteLeg; i < destAptIdx; i++)
-        drawLine(painter, lines.at(i));
+        drawRouteLine(painter, lines.at(i));
 
       // Draw center line for alternates all from destination airport to each alternate
       if(alternateOffset != map::INVALID_INDEX_VALUE)
       {
         mapcolors::adjustPenForAlternate(painter);
         for(int idx = alternateOffset; idx < alternateOffset + route->getNumAlternateLegs(); idx++)
-          drawLine(painter, lines.at(idx - 1));
+          drawRouteLine(painter, lines.at(idx - 1));
       }
     }
 
@@ -302,12 +304,12 @@ void MapPainterRoute::drawRouteInternal(QStringList routeTexts, QVector<Line> li
 
       // Draw active leg on top of all others to keep it visible ===========================
       painter->setPen(routeOutlinePen);
-      drawLine(painter, lines.at(activeRouteLeg - 1));
+      drawRouteLine(painter, lines.at(activeRouteLeg - 1));
 
       painter->setPen(QPen(OptionData::instance().getFlightplanActiveSegmentColor(), innerlinewidth,
                            Qt::SolidLine, Qt::RoundCap, Qt::RoundJoin));
 
-      drawLine(painter, lines.at(activeRouteLeg - 1));
+      drawRouteLine(painter, lines.at(activeRouteLeg - 1));
     }
   }
   context->szFont(context->textSizeFlightplan);
@@ -321,8 +323,31 @@ void MapPainterRoute::drawRouteInternal(QStringList routeTexts, QVector<Line> li
   TextPlacement textPlacement(painter, this, context->screenRect.marginsAdded(QMargins(100, 50, 100, 50)));
   textPlacement.setDrawFast(context->drawFast);
   textPlacement.setLineWidth(outerlinewidth);
-  textPlacement.calculateTextPositions(positions);
-  textPlacement.calculateTextAlongLines(lines, routeTexts);
+
+  // Viewport, font and all texts going into the layout. Waypoint coordinates are included to
+  // catch route edits which do not change the leg texts.
+  QString layoutKey = QStringList({QString::number(context->viewport->projection()),
+                                   QString::number(context->viewport->radius()),
+                                   QString::number(context->viewport->centerLongitude()),
+                                   QString::number(context->viewport->centerLatitude()),
+                                   QString::number(context->screenRect.width()),
+                                   QString::number(context->screenRect.height()),
+                                   QString::number(outerlinewidth),
+                                   QString::number(context->drawFast),
+                                   painter->font().key()}).join('_') + routeTexts.join(';');
+  for(const Pos& pos : positions)
+    layoutKey += QString::number(pos.getLonX(), 'f', 6) + QString::number(pos.getLatY(), 'f', 6);
+
+  if(textPlacementLayout.valid && layoutKey == textPlacementLayoutKey)
+    // Still viewport and unchanged plan - reuse the layout computed in the last frame
+    textPlacement.restoreLayout(textPlacementLayout);
+  else
+  {
+    textPlacement.calculateTextPositions(positions);
+    textPlacement.calculateTextAlongLines(lines, routeTexts);
+    textPlacement.saveLayout(textPlacementLayout);
+    textPlacementLayoutKey = layoutKey;
+  }
   painter->save();
   if(!(context->flags2 & opts2::MAP_ROUTE_TEXT_BACKGROUND))
     painter->setBackgroundMode(Qt::TransparentMode);
@@ -365,6 +390,42 @@ void MapPainterRoute::drawRouteInternal(QStringList routeTexts, QVector<Line> li
     drawWindBarbs(visibleStartPoints, textPlacement.getStartPoints());
 }
 
+void MapPainterRoute::drawRouteLine(Marble::GeoPainter *painter, const atools::geo::Line& line)
+{
+  if(!line.isValid())
+    return;
+
+  QString key = QString::number(line.getPos1().getLonX()) + "_" + QString::number(line.getPos1().getLatY()) + "_" +
+                QString::number(line.getPos2().getLonX()) + "_" + QString::number(line.getPos2().getLatY());
+
+  QVector<GeoDataLineString> *corrected = routeLineCache.object(key);
+  if(corrected == nullptr)
+  {
+    // Build the same geometry as MapPainter::drawLine but keep the corrected result.
+    // Legs are drawn up to three times per frame for outline, fill and active pen.
+    qreal latCorrection = 0.;
+    if(atools::almostEqual(line.getPos1().getLatY(), line.getPos2().getLatY()))
+      // Avoid the straight line Marble draws for equal latitudes - needed to force GC path
+      latCorrection = 0.000001;
+
+    GeoDataLineString ls;
+    ls.setTessellate(true);
+    ls << GeoDataCoordinates(line.getPos1().getLonX(), line.getPos1().getLatY() - latCorrection, 0, DEG)
+       << GeoDataCoordinates(line.getPos2().getLonX(), line.getPos2().getLatY() + latCorrection, 0, DEG);
+
+    corrected = new QVector<GeoDataLineString>();
+    QVector<GeoDataLineString *> dateLineCorrected = ls.toDateLineCorrected();
+    for(const GeoDataLineString *dlc : dateLineCorrected)
+      corrected->append(*dlc);
+    qDeleteAll(dateLineCorrected);
+
+    routeLineCache.insert(key, corrected);
+  }
+
+  for(const GeoDataLineString& dlc : *corrected)
+    painter->drawPolyline(dlc);
+}
+
 void MapPainterRoute::paintTopOfDescentAndClimb()
 {
   const Route *route = context->route;
@@ -389,7 +450,7 @@ void MapPainterRoute::paintTopOfDescentAndClimb()
     QMargins margins(50, 10, 10, 10);
 
     // Draw the top of climb circle and text ======================
-    if(!(OptionData::instance().getFlags2() & opts2::MAP_ROUTE_DIM_PASSED) ||
+    if(!(context->flags2 & opts2::MAP_ROUTE_DIM_PASSED) ||
        activeLegIndex == map::INVALID_INDEX_VALUE || route->getTopOfClimbLegIndex() > activeLegIndex - 1)
     {
       Pos pos = route->getTopOfClimbPos();
@@ -412,7 +473,7 @@ void MapPainterRoute::paintTopOfDescentAndClimb()
     }
 
     // Draw the top of descent circle and text ======================
-    if(!(OptionData::instance().getFlags2() & opts2::MAP_ROUTE_DIM_PASSED) ||
+    if(!(context->flags2 & opts2::MAP_ROUTE_DIM_PASSED) ||
        activeLegIndex == map::INVALID_INDEX_VALUE || route->getTopOfDescentLegIndex() > activeLegIndex - 1)
     {
       Pos pos = route->getTopOfDescentPos();
@@ -1543,7 +1604,7 @@ void MapPainterRoute::paintText(const QColor& color, float x, float y,
     symbolPainter->textBoxF(context->painter, texts, color, x + size / 2.f + 2.f, y, atts, transparency);
 }
 
-void MapPainterRoute::drawSymbols(const QBitArray& visibleStartPoints, const QList<QPointF>& startPoints, bool preview)
+void MapPainterRoute::drawSymbols(const QBitArray& visibleStartPoints, const QVector<QPointF>& startPoints, bool preview)
 {
   int i = 0;
   for(const QPointF& pt : startPoints)
@@ -1581,7 +1642,7 @@ void MapPainterRoute::drawSymbols(const QBitArray& visibleStartPoints, const QLi
   }
 }
 
-void MapPainterRoute::drawWindBarbs(const QBitArray& visibleStartPoints, const QList<QPointF>& startPoints)
+void MapPainterRoute::drawWindBarbs(const QBitArray& visibleStartPoints, const QVector<QPointF>& startPoints)
 {
   const Route *route = context->route;
 
@@ -1612,7 +1673,7 @@ void MapPainterRoute::drawWindBarbs(const QBitArray& visibleStartPoints, const Q
   }
 }
 
-void MapPainterRoute::drawRouteSymbolText(const QBitArray& visibleStartPoints, const QList<QPointF>& startPoints)
+void MapPainterRoute::drawRouteSymbolText(const QBitArray& visibleStartPoints, const QVector<QPointF>& startPoints)
 {
   int i = 0;
   for(const QPointF& pt : startPoints)
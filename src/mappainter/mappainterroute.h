@@ -18,10 +18,13 @@
 #ifndef LITTLENAVMAP_MAPPAINTERROUTE_H
 #define LITTLENAVMAP_MAPPAINTERROUTE_H
 
+#include "common/textplacement.h"
 #include "mappainter/mappainter.h"
 
 #include "geo/line.h"
 
+#include <QCache>
+
 namespace Marble {
 class GeoDataLineString;
 }
@@ -96,9 +99,9 @@ private:
                            const proc::MapProcedureLegs& legs, int index, bool preview,
                            bool drawTextFlag);
 
-  void drawSymbols(const QBitArray& visibleStartPoints, const QList<QPointF>& startPoints, bool preview);
+  void drawSymbols(const QBitArray& visibleStartPoints, const QVector<QPointF>& startPoints, bool preview);
 
-  void drawRouteSymbolText(const QBitArray& visibleStartPoints, const QList<QPointF>& startPoints);
+  void drawRouteSymbolText(const QBitArray& visibleStartPoints, const QVector<QPointF>& startPoints);
 
   void paintProcedureSegment(const proc::MapProcedureLegs& legs,
                              int index, QVector<QLineF>& lastLines, QVector<DrawText> *drawTextLines, bool noText,
@@ -115,12 +118,26 @@ private:
   void paintProcedureUnderlay(const proc::MapProcedureLeg& leg, int x, int y, int size);
 
   void drawStartParking();
-  void drawWindBarbs(const QBitArray& visibleStartPoints, const QList<QPointF>& startPoints);
+  void drawWindBarbs(const QBitArray& visibleStartPoints, const QVector<QPointF>& startPoints);
   void drawWindBarbAtWaypoint(float windSpeed, float windDir, float x, float y);
   void drawRouteInternal(QStringList routeTexts, QVector<atools::geo::Line> lines, int passedRouteLeg);
   QString buildLegText(const RouteLeg& leg);
   QString buildLegText(float dist, float courseGcMag, float courseGcTrue);
 
+  /* Draw a great circle route leg like MapPainter::drawLine but keep the date line corrected
+   * Marble geometry in the cache below for the next frame and pen pass */
+  void drawRouteLine(Marble::GeoPainter *painter, const atools::geo::Line& line);
+
+  /* Tessellation ready leg geometry keyed by the leg coordinates. A changed or removed leg
+   * simply misses the cache and stale entries are evicted - no extra dirty tracking needed. */
+  QCache<QString, QVector<Marble::GeoDataLineString> > routeLineCache;
+
+  /* Label layout of the last frame and the viewport and texts it was computed for. Still
+   * viewports while cruising produce the identical layout so the placement calculation with
+   * its coordinate projections along every leg can be skipped. A route change alters the leg
+   * texts and invalidates the key implicitly. */
+  TextPlacement::Layout textPlacementLayout;
+  QString textPlacementLayoutKey;
 };
 
 #endif // LITTLENAVMAP_MAPPAINTERROUTE_H
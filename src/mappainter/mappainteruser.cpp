@@ -67,22 +67,26 @@ void MapPainterUser::paintUserpoints(const QList<MapUserpoint>& userpoints, bool
   bool fill = context->flags2 & opts2::MAP_NAVAID_TEXT_BACKGROUND;
   UserdataIcons *icons = NavApp::getUserdataIcons();
 
+  float size = context->sz(context->symbolSizeNavaid, context->mapLayerEffective->getUserPointSymbolSize());
+
   // Use margins for text placed on the right side of the object to avoid disappearing at the left screen border
   QMargins margins(100, 10, 10, 10);
+
+  // Collect visible points and group the icon positions by type so every pixmap is drawn
+  // in one batch instead of switching the painter between pixmaps for each point
+  QVector<std::pair<const MapUserpoint *, QPointF> > visiblePoints;
+  QHash<QString, QVector<QPointF> > iconBatches;
+
   for(const MapUserpoint& userpoint : userpoints)
   {
     float x, y;
-    bool visible = wToSBuf(userpoint.position, x, y, margins);
-
-    if(visible)
+    if(wToSBuf(userpoint.position, x, y, margins))
     {
       if(context->objCount())
-        return;
+        break;
 
       if(icons->hasType(userpoint.type) || context->userPointTypeUnknown)
       {
-
-        float size = context->sz(context->symbolSizeNavaid, context->mapLayerEffective->getUserPointSymbolSize());
         if(userpoint.type == "Logbook")
         {
           x += size / 2.f;
@@ -90,25 +94,41 @@ void MapPainterUser::paintUserpoints(const QList<MapUserpoint>& userpoints, bool
         }
 
         if(x < INVALID_INDEX_VALUE / 2 && y < INVALID_INDEX_VALUE / 2)
-          context->painter->drawPixmap(QPointF(x - size / 2.f, y - size / 2.f),
-                                       *icons->getIconPixmap(userpoint.type, atools::roundToInt(size)));
+          iconBatches[userpoint.type].append(QPointF(x - size / 2.f, y - size / 2.f));
 
-        if(context->mapLayer->isUserpointInfo() && !drawFast)
-        {
-          int maxTextLength = context->mapLayer->getMaxTextLengthUserpoint();
-
-          // Avoid showing same text twice
-          QStringList texts;
-          texts.append(atools::elideTextShort(userpoint.ident, maxTextLength));
-          QString name = userpoint.name != userpoint.ident ?
-                         atools::elideTextShort(userpoint.name, maxTextLength) : QString();
-          if(!name.isEmpty())
-            texts.append(name);
-
-          symbolPainter->textBoxF(context->painter, texts, QPen(Qt::black),
-                                  x + size / 2, y, textatt::LEFT, fill ? 255 : 0);
-        }
+        visiblePoints.append(std::make_pair(&userpoint, QPointF(x, y)));
       }
     }
   }
+
+  // Draw all icons of one type in one batch
+  for(auto it = iconBatches.constBegin(); it != iconBatches.constEnd(); ++it)
+  {
+    const QPixmap *pixmap = icons->getIconPixmap(it.key(), atools::roundToInt(size));
+    for(const QPointF& point : it.value())
+      context->painter->drawPixmap(point, *pixmap);
+  }
+
+  // Draw the texts above the icons
+  if(context->mapLayer->isUserpointInfo() && !drawFast)
+  {
+    int maxTextLength = context->mapLayer->getMaxTextLengthUserpoint();
+
+    for(const std::pair<const MapUserpoint *, QPointF>& visible : visiblePoints)
+    {
+      const MapUserpoint& userpoint = *visible.first;
+
+      // Avoid showing same text twice
+      QStringList texts;
+      texts.append(atools::elideTextShort(userpoint.ident, maxTextLength));
+      QString name = userpoint.name != userpoint.ident ?
+                     atools::elideTextShort(userpoint.name, maxTextLength) : QString();
+      if(!name.isEmpty())
+        texts.append(name);
+
+      symbolPainter->textBoxF(context->painter, texts, QPen(Qt::black),
+                              static_cast<float>(visible.second.x()) + size / 2.f,
+                              static_cast<float>(visible.second.y()), textatt::LEFT, fill ? 255 : 0);
+    }
+  }
 }
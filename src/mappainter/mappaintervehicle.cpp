@@ -17,6 +17,8 @@
 
 #include "mappainter/mappaintervehicle.h"
 
+#include "atools.h"
+#include "mapgui/mapscreenindex.h"
 #include "mapgui/mapwidget.h"
 #include "common/mapcolors.h"
 #include "geo/calculations.h"
@@ -39,6 +41,10 @@ using atools::fs::sc::SimConnectUserAircraft;
 using atools::fs::sc::SimConnectAircraft;
 using atools::fs::sc::SimConnectData;
 
+/* Do not extrapolate positions from samples older than this - the jump on the next real
+ * sample would be worse than the lag */
+const static qint64 MAX_EXTRAPOLATION_MS = 2000;
+
 MapPainterVehicle::MapPainterVehicle(MapPaintWidget *mapWidget, MapScale *mapScale, PaintContext *paintContext)
   : MapPainter(mapWidget, mapScale, paintContext)
 {
@@ -55,7 +61,8 @@ void MapPainterVehicle::paintAiVehicle(const SimConnectAircraft& vehicle, bool f
   if(vehicle.isUser())
     return;
 
-  const Pos& pos = vehicle.getPosition();
+  // Online aircraft are not tied to the simulator sample time - draw them at the reported position
+  Pos pos = vehicle.isOnline() ? vehicle.getPosition() : extrapolatedPosition(vehicle);
 
   if(!pos.isValid())
     return;
@@ -70,20 +77,17 @@ void MapPainterVehicle::paintAiVehicle(const SimConnectAircraft& vehicle, bool f
 
       if(rotate < map::INVALID_COURSE_VALUE)
       {
-        // Position is visible
-        context->painter->translate(x, y);
-        context->painter->rotate(rotate);
-
         int modelSize = vehicle.getWingSpan() > 0 ? vehicle.getWingSpan() : vehicle.getModelRadiusCorrected() * 2;
         int minSize = vehicle.isAnyBoat() ? 28 : 32;
 
         int size = std::max(context->sz(context->symbolSizeAircraftAi, minSize), scale->getPixelIntForFeet(modelSize));
         int offset = -(size / 2);
 
-        // Draw symbol
-        context->painter->drawPixmap(offset, offset, *NavApp::getVehicleIcons()->pixmapFromCache(vehicle, size, 0));
-
-        context->painter->resetTransform();
+        // Draw symbol pre-rotated in five degree steps from the cache instead of rotating the
+        // painter which would transform the pixmap again for every vehicle and frame
+        int rotateStep = (atools::roundToInt(atools::geo::normalizeCourse(rotate) / 5.f) * 5) % 360;
+        context->painter->drawPixmap(QPointF(x + offset, y + offset),
+                                     *NavApp::getVehicleIcons()->pixmapFromCache(vehicle, size, rotateStep));
 
         // Build text label
         if(!vehicle.isAnyBoat())
@@ -136,6 +140,28 @@ void MapPainterVehicle::paintUserAircraft(const SimConnectUserAircraft& userAirc
   }
 }
 
+atools::geo::Pos MapPainterVehicle::extrapolatedPosition(const SimConnectAircraft& aircraft)
+{
+  const Pos& pos = aircraft.getPosition();
+
+  qint64 ageMs = QDateTime::currentMSecsSinceEpoch() - mapPaintWidget->getScreenIndexConst()->getSimDataReceivedMs();
+
+  if(ageMs <= 0 || ageMs > MAX_EXTRAPOLATION_MS || !aircraft.isFlying() ||
+     aircraft.getGroundSpeedKts() < 30.f || aircraft.getGroundSpeedKts() >= atools::fs::sc::SC_INVALID_FLOAT ||
+     aircraft.getTrackDegTrue() >= atools::fs::sc::SC_INVALID_FLOAT)
+    return pos;
+
+  // Dead reckoning along the ground track
+  float distanceMeter = nmToMeter(aircraft.getGroundSpeedKts() * static_cast<float>(ageMs) / 3600000.f);
+  Pos extrapolated = pos.endpoint(distanceMeter, aircraft.getTrackDegTrue());
+
+  if(aircraft.getVerticalSpeedFeetPerMin() < atools::fs::sc::SC_INVALID_FLOAT)
+    extrapolated.setAltitude(pos.getAltitude() +
+                             aircraft.getVerticalSpeedFeetPerMin() * static_cast<float>(ageMs) / 60000.f);
+
+  return extrapolated;
+}
+
 float MapPainterVehicle::calcRotation(const SimConnectAircraft& aircraft)
 {
   float rotate;
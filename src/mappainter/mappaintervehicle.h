@@ -75,6 +75,12 @@ protected:
   /* Calculate rotation for aircraft icon */
   float calcRotation(const atools::fs::sc::SimConnectAircraft& aircraft);
 
+  /* Estimate the current position from the age of the last simulator sample using ground
+   * track, speed and vertical speed. Keeps the symbol moving smoothly when the data arrives
+   * slower than the paint rate. Returns the sample position on ground, for invalid values
+   * or if the sample is too old. */
+  atools::geo::Pos extrapolatedPosition(const atools::fs::sc::SimConnectAircraft& aircraft);
+
   static Q_DECL_CONSTEXPR int WIND_POINTER_SIZE = 40;
 
 };
@@ -95,15 +95,25 @@ void MapPainterWeather::render()
   WeatherReporter *reporter = NavApp::getWeatherReporter();
   for(const PaintAirportType& airportWeather: visibleAirportWeather)
   {
-    atools::fs::weather::Metar metar =
-      reporter->getAirportWeather(airportWeather.airport->ident,
-                                  airportWeather.airport->position, context->weatherSource);
+    // Resolve from the parsed report cache which avoids copying the report per airport and frame
+    const atools::fs::weather::Metar *metar =
+      reporter->getAirportWeatherCached(airportWeather.airport->ident,
+                                        airportWeather.airport->position, context->weatherSource);
 
-    if(metar.isValid())
+    atools::fs::weather::Metar simMetar;
+    if(metar == nullptr)
+    {
+      // Not cacheable - weather fetched live through a FSX/P3D connection
+      simMetar = reporter->getAirportWeather(airportWeather.airport->ident,
+                                             airportWeather.airport->position, context->weatherSource);
+      metar = &simMetar;
+    }
+
+    if(metar->isValid())
     {
       float x = static_cast<float>(airportWeather.point.x());
       float y = static_cast<float>(airportWeather.point.y());
-      drawAirportWeather(metar, x, y);
+      drawAirportWeather(*metar, x, y);
     }
   }
 }
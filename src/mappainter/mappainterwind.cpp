@@ -49,36 +49,63 @@ void MapPainterWind::render()
   atools::util::PainterContextSaver saver(context->painter);
   Q_UNUSED(saver);
 
+  WindReporter *windReporter = NavApp::getWindReporter();
   const atools::grib::WindPosList *windForRect =
-    NavApp::getWindReporter()->getWindForRect(context->viewport->viewLatLonAltBox(),
-                                              context->mapLayer, context->lazyUpdate);
+    windReporter->getWindForRect(context->viewport->viewLatLonAltBox(),
+                                 context->mapLayer, context->lazyUpdate);
 
   if(windForRect != nullptr)
   {
-    atools::geo::Rect rect = context->viewportRect;
+    // Projection and glyph drawing only change with the viewport, the selected level or new
+    // wind data - render the grid into a pixmap once and blit it for all frames in between
+    const Marble::ViewportParams *viewport = context->viewport;
+    QString cacheKey = QStringList({QString::number(viewport->projection()),
+                                    QString::number(viewport->radius()),
+                                    QString::number(viewport->centerLongitude()),
+                                    QString::number(viewport->centerLatitude()),
+                                    QString::number(viewport->width()),
+                                    QString::number(viewport->height()),
+                                    QString::number(windReporter->getCurrentLevel()),
+                                    QString::number(windReporter->getChangeNumber()),
+                                    QString::number(context->symbolSizeWindBarbs),
+                                    QString::number(context->drawFast)}).join('_');
 
-    // Inflate for half a grid cell size to avoid disappearing symbols at map border
-    rect.inflate(0.5f, 0.5f);
-
-    for(const atools::grib::WindPos& windPos : *windForRect)
+    if(cacheKey != windBarbCacheKey || windBarbCache.isNull())
     {
-      if(!windPos.wind.isValid())
-        continue;
+      windBarbCache = QPixmap(mapPaintWidget->size());
+      windBarbCache.fill(Qt::transparent);
+      windBarbCacheKey = cacheKey;
+
+      QPainter pixmapPainter(&windBarbCache);
+      pixmapPainter.setRenderHints(context->painter->renderHints());
+
+      atools::geo::Rect rect = context->viewportRect;
 
-      if(rect.contains(windPos.pos))
+      // Inflate for half a grid cell size to avoid disappearing symbols at map border
+      rect.inflate(0.5f, 0.5f);
+
+      for(const atools::grib::WindPos& windPos : *windForRect)
       {
-        bool isVisible, isHidden;
-        QPoint pos = wToS(windPos.pos, DEFAULT_WTOS_SIZE, &isVisible, &isHidden);
-        if(!pos.isNull() && /*isVisible && */ !isHidden)
-          drawWindBarb(windPos.wind.speed, windPos.wind.dir, pos.x(), pos.y());
+        if(!windPos.wind.isValid())
+          continue;
+
+        if(rect.contains(windPos.pos))
+        {
+          bool isVisible, isHidden;
+          QPoint pos = wToS(windPos.pos, DEFAULT_WTOS_SIZE, &isVisible, &isHidden);
+          if(!pos.isNull() && /*isVisible && */ !isHidden)
+            drawWindBarb(&pixmapPainter, windPos.wind.speed, windPos.wind.dir, pos.x(), pos.y());
+        }
       }
     }
+
+    context->painter->drawPixmap(0, 0, windBarbCache);
   }
 }
 
-void MapPainterWind::drawWindBarb(float speed, float direction, float x, float y)
+void MapPainterWind::drawWindBarb(QPainter *painter, float speed, float direction, float x, float y)
 {
   float size = context->sz(context->symbolSizeWindBarbs, context->mapLayer->getWindBarbsSymbolSize());
-  symbolPainter->drawWindBarbs(context->painter, speed, 0.f, direction, x, y, size,
+  symbolPainter->drawWindBarbs(painter, speed, 0.f, direction, x, y, size,
                                true /* wind barbs */, true /* alt wind */, false /* route */, context->drawFast);
 }
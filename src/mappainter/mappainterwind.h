@@ -35,7 +35,12 @@ public:
   virtual void render() override;
 
 private:
-  void drawWindBarb(float speed, float direction, float x, float y);
+  void drawWindBarb(QPainter *painter, float speed, float direction, float x, float y);
+
+  /* Barb grid rendered into a transparent pixmap. Valid until viewport, selected level or
+   * wind data change so most frames only blit the image. */
+  QPixmap windBarbCache;
+  QString windBarbCacheKey;
 
 };
 
@@ -18,10 +18,14 @@
 #include "mappainter/mappaintlayer.h"
 
 #include "navapp.h"
+#include "common/constants.h"
+#include "settings/settings.h"
+#include "mapgui/mapscreenindex.h"
 #include "mappainter/mappainterweather.h"
 #include "mappainter/mappainterwind.h"
 #include "connect/connectclient.h"
 #include "common/mapcolors.h"
+#include "common/perftrace.h"
 #include "mapgui/mapwidget.h"
 #include "mapgui/maplayersettings.h"
 #include "mappainter/mappainteraircraft.h"
@@ -39,16 +43,37 @@
 #include "mapgui/mapscale.h"
 #include "userdata/userdatacontroller.h"
 #include "route/route.h"
+#include "route/routecontroller.h"
 #include "geo/calculations.h"
 #include "options/optiondata.h"
 
+#include <QDebug>
 #include <QElapsedTimer>
+#include <QFile>
+#include <QTextStream>
 
 #include <marble/GeoPainter.h>
 
 using namespace Marble;
 using namespace atools::geo;
 
+/* Milliseconds of painting time per frame before the remaining painters of the static stack
+ * are postponed to the next frame. Keeps the GUI responsive on slow machines while the cached
+ * pixmap fills up over a few frames. */
+static const int RENDER_BUDGET_MS = 30;
+
+/* Closed-loop detail governor: full quality still frames taking longer than this are over
+ * budget. Sustained over-budget frames reduce the effective detail level down to the minimum
+ * and sustained headroom brings it back up to the user setting. */
+static const int ADAPT_FRAME_BUDGET_MS = 150;
+
+/* Consecutive over-budget still frames before stepping the detail down */
+static const int ADAPT_FRAMES_DOWN = 3;
+
+/* Consecutive frames with at least half the budget left before stepping back up.
+ * Much higher than the value above to avoid oscillating around the budget. */
+static const int ADAPT_FRAMES_UP = 30;
+
 MapPaintLayer::MapPaintLayer(MapPaintWidget *widget, MapQuery *mapQueries)
   : mapQuery(mapQueries), mapWidget(widget)
 {
@@ -76,10 +101,16 @@ MapPaintLayer::MapPaintLayer(MapPaintWidget *widget, MapQuery *mapQueries)
   // Default for visible object types
   objectTypes = map::MapTypes(map::AIRPORT | map::VOR | map::NDB | map::AP_ILS | map::MARKER | map::WAYPOINT);
   objectDisplayTypes = map::DISPLAY_TYPE_NONE;
+
+  renderDebug = atools::settings::Settings::instance().getAndStoreValue(lnm::OPTIONS_MAP_RENDER_DEBUG,
+                                                                        false).toBool();
 }
 
 MapPaintLayer::~MapPaintLayer()
 {
+  if(renderDebug)
+    saveRenderStats();
+
   delete mapPainterNav;
   delete mapPainterIls;
   delete mapPainterAirport;
@@ -114,11 +145,20 @@ void MapPaintLayer::copySettings(const MapPaintLayer& other)
 void MapPaintLayer::preDatabaseLoad()
 {
   databaseLoadStatus = true;
+  invalidateStaticPaintCache();
 }
 
 void MapPaintLayer::postDatabaseLoad()
 {
   databaseLoadStatus = false;
+  invalidateStaticPaintCache();
+}
+
+void MapPaintLayer::invalidateStaticPaintCache()
+{
+  staticPaintCacheKey.clear();
+  staticPaintCache = QPixmap();
+  staticPaintCacheObjectCount = 0;
 }
 
 void MapPaintLayer::setShowMapObjects(map::MapTypes type, bool show)
@@ -145,9 +185,58 @@ void MapPaintLayer::setShowAirspaces(map::MapAirspaceFilter types)
 void MapPaintLayer::setDetailFactor(int factor)
 {
   detailFactor = factor;
+
+  // A manual detail change overrides any adaptive reduction
+  adaptiveDetailOffset = 0;
+  framesOverBudget = framesUnderBudget = 0;
+
   updateLayers();
 }
 
+int MapPaintLayer::effectiveDetailFactor() const
+{
+  return std::max(detailFactor + adaptiveDetailOffset, MapLayerSettings::MAP_MIN_DETAIL_FACTOR);
+}
+
+void MapPaintLayer::adaptDetail(qint64 frameMs)
+{
+  if(frameMs > ADAPT_FRAME_BUDGET_MS)
+  {
+    framesUnderBudget = 0;
+    if(++framesOverBudget >= ADAPT_FRAMES_DOWN)
+    {
+      framesOverBudget = 0;
+      if(effectiveDetailFactor() > MapLayerSettings::MAP_MIN_DETAIL_FACTOR)
+      {
+        adaptiveDetailOffset--;
+        updateLayers();
+        mapWidget->scheduleUpdate();
+
+        qInfo() << Q_FUNC_INFO << "Frame took" << frameMs << "ms - reducing detail offset to" << adaptiveDetailOffset;
+        NavApp::setStatusMessage(QObject::tr("Map detail reduced to keep the map responsive."));
+      }
+    }
+  }
+  else if(frameMs < ADAPT_FRAME_BUDGET_MS / 2)
+  {
+    framesOverBudget = 0;
+    if(adaptiveDetailOffset < 0 && ++framesUnderBudget >= ADAPT_FRAMES_UP)
+    {
+      framesUnderBudget = 0;
+      adaptiveDetailOffset++;
+      updateLayers();
+      mapWidget->scheduleUpdate();
+
+      qInfo() << Q_FUNC_INFO << "Headroom returned - raising detail offset to" << adaptiveDetailOffset;
+      if(adaptiveDetailOffset == 0)
+        NavApp::setStatusMessage(QObject::tr("Map detail restored."));
+    }
+  }
+  else
+    // Between the thresholds - start both counts over
+    framesOverBudget = framesUnderBudget = 0;
+}
+
 map::MapAirspaceFilter MapPaintLayer::getShownAirspacesTypesByLayer() const
 {
   // Mask out all types that are not visible in the current layer
@@ -173,6 +262,11 @@ map::MapAirspaceFilter MapPaintLayer::getShownAirspacesTypesByLayer() const
   if(!mapLayer->isAirspaceOther())
     filter.types &= ~map::AIRSPACE_OTHER;
 
+  if(!mapLayer->isAirspaceLocal())
+    // Keep the small facility circles to closer zoom levels - these appear by the thousands
+    // from the online networks during events while only a handful is ever visible
+    filter.types &= ~(map::TOWER | map::CLEARANCE | map::GROUND | map::DEPARTURE | map::APPROACH);
+
   return filter;
 }
 
@@ -210,7 +304,7 @@ void MapPaintLayer::initMapLayerSettings()
                       onlineAircraft().onlineAircraftText().
 
                       airspaceCenter().airspaceFg().airspaceFirUir().airspaceOther().airspaceRestricted().
-                      airspaceSpecial().airspaceIcao().
+                      airspaceSpecial().airspaceIcao().airspaceLocal().
 
                       vorRouteIdent().vorRouteInfo().ndbRouteIdent().ndbRouteInfo().waypointRouteName().
                       airportRouteInfo();
@@ -364,6 +458,7 @@ void MapPaintLayer::initMapLayerSettings()
          aiAircraftGround(false).aiShipSmall(false).
          aiAircraftGroundText(false).aiAircraftText(false).
          onlineAircraftText(false).
+         airspaceLocal(false).
          trackIdent().trackInfo(false).trackWaypoint().
          ndb(false).waypoint(false).marker(false).ils(false).
          trackIdent().trackInfo(false).trackWaypoint().
@@ -465,13 +560,36 @@ void MapPaintLayer::initMapLayerSettings()
   qDebug() << *layers;
 }
 
+const MapLayer *MapPaintLayer::getMapLayerForDistance(float distanceKm) const
+{
+  return layers->getLayer(distanceKm, effectiveDetailFactor());
+}
+
 /* Update the stored layer pointers after zoom distance has changed */
 void MapPaintLayer::updateLayers()
 {
   float dist = static_cast<float>(mapWidget->distance());
   // Get the uncorrected effective layer - route painting is independent of declutter
   mapLayerEffective = layers->getLayer(dist);
-  mapLayer = layers->getLayer(dist, detailFactor);
+  mapLayer = layers->getLayer(dist, effectiveDetailFactor());
+}
+
+QString MapPaintLayer::buildStaticPaintCacheKey(const Marble::ViewportParams *viewport) const
+{
+  map::MapAirspaceFilter filter = getShownAirspacesTypesByLayer();
+
+  // Projection, zoom and all feature selections affecting the static painter stack.
+  // The viewport center is kept separately so the image can be reused shifted while panning.
+  return QStringList({QString::number(viewport->projection()),
+                      QString::number(viewport->radius()),
+                      QString::number(viewport->width()),
+                      QString::number(viewport->height()),
+                      QString::number(static_cast<int>(objectTypes)),
+                      QString::number(static_cast<int>(objectDisplayTypes)),
+                      QString::number(static_cast<int>(filter.types)),
+                      QString::number(static_cast<int>(filter.flags)),
+                      QString::number(effectiveDetailFactor()),
+                      QString::number(NavApp::getRouteConst().size())}).join('_');
 }
 
 bool MapPaintLayer::render(GeoPainter *painter, ViewportParams *viewport, const QString& renderPos,
@@ -500,7 +618,10 @@ bool MapPaintLayer::render(GeoPainter *painter, ViewportParams *viewport, const
 #endif
 
       context = PaintContext();
-      context.route = &NavApp::getRouteConst();
+      // Keep the current route snapshot alive for the whole frame so all painters
+      // draw the same consistent plan
+      context.routeSnapshot = NavApp::getRouteController()->getRouteSnapshot();
+      context.route = context.routeSnapshot.data();
       context.mapLayer = mapLayer;
       context.mapLayerEffective = mapLayerEffective;
       context.painter = painter;
@@ -621,65 +742,175 @@ bool MapPaintLayer::render(GeoPainter *painter, ViewportParams *viewport, const
       // =========================================================================
       // Draw ====================================
 
+      // Used to check the per-frame budget below
+      QElapsedTimer frameTimer;
+      frameTimer.start();
+
+      // Frame span with the painter spans below as children
+      perftrace::Span frameSpan("map paint");
+
+      // Collect per-painter timing to find expensive layers
+      renderTimes.clear();
+      auto renderTimed = [this](const QString& name, MapPainter *mapPainter)
+      {
+        perftrace::Span painterSpan(name);
+        QElapsedTimer timer;
+        timer.start();
+        mapPainter->render();
+        renderTimes.append(std::make_pair(name, timer.elapsed()));
+      };
+
       // Altitude below all others
-      mapPainterAltitude->render();
+      renderTimed("altitude", mapPainterAltitude);
 
       // Ship below other navaids and airports
-      mapPainterShip->render();
+      renderTimed("ship", mapPainterShip);
 
       if(mapWidget->distance() < layer::DISTANCE_CUT_OFF_LIMIT)
       {
-        if(!context.isOverflow())
-          mapPainterAirspace->render();
-
+        // Render airspaces, ILS, navaids and airports into a cached pixmap. The cache hits
+        // whenever viewport and shown features are unchanged, i.e. for all repaints that are
+        // triggered by aircraft updates, highlights or other dynamic objects. While panning
+        // the complete image is reused shifted by the pan offset.
+        // The stack is filled progressively: once the frame budget is used up the remaining
+        // painters are postponed and another repaint is scheduled. The cheap dynamic layers
+        // below always paint so aircraft and route never disappear on slow machines.
+        QString cacheKey = buildStaticPaintCacheKey(viewport);
+
+        // Static stack in drawing order
+        QVector<std::pair<QString, MapPainter *> > staticPainters;
+        staticPainters.append(std::make_pair(QString("airspace"), static_cast<MapPainter *>(mapPainterAirspace)));
         if(context.mapLayerEffective->isAirportDiagram())
         {
           // Put ILS below and navaids on top of airport diagram
-          mapPainterIls->render();
-
-          if(!context.isOverflow())
-            mapPainterAirport->render();
-
-          if(!context.isOverflow())
-            mapPainterNav->render();
+          staticPainters.append(std::make_pair(QString("ils"), static_cast<MapPainter *>(mapPainterIls)));
+          staticPainters.append(std::make_pair(QString("airport"), static_cast<MapPainter *>(mapPainterAirport)));
+          staticPainters.append(std::make_pair(QString("nav"), static_cast<MapPainter *>(mapPainterNav)));
         }
         else
         {
           // Airports on top of all
-          if(!context.isOverflow())
-            mapPainterIls->render();
+          staticPainters.append(std::make_pair(QString("ils"), static_cast<MapPainter *>(mapPainterIls)));
+          staticPainters.append(std::make_pair(QString("nav"), static_cast<MapPainter *>(mapPainterNav)));
+          staticPainters.append(std::make_pair(QString("airport"), static_cast<MapPainter *>(mapPainterAirport)));
+        }
 
-          if(!context.isOverflow())
-            mapPainterNav->render();
+        bool sameKey = cacheKey == staticPaintCacheKey && !staticPaintCache.isNull();
+        bool sameCenter = viewport->centerLongitude() == staticPaintCacheCenterLon &&
+                          viewport->centerLatitude() == staticPaintCacheCenterLat;
 
-          if(!context.isOverflow())
-            mapPainterAirport->render();
+        QPoint cacheOffset;
+        bool reuseShifted = false;
+        if(sameKey && !sameCenter && mapWidget->viewContext() == Marble::Animation &&
+           staticPaintCacheProgress >= staticPainters.size())
+        {
+          // Only the center moved while panning - blit the last complete static image shifted
+          // by the pan offset instead of rebuilding the whole stack for every animation frame.
+          // The shift is exact for the Mercator projection and a close approximation on the
+          // globe. The exact image is rendered again with the final still frame.
+          qreal x, y;
+          if(viewport->screenCoordinates(staticPaintCacheCenterLon, staticPaintCacheCenterLat, x, y))
+          {
+            cacheOffset = QPoint(qRound(x) - viewport->width() / 2, qRound(y) - viewport->height() / 2);
+            reuseShifted = true;
+          }
+        }
+
+        if(!reuseShifted && (!sameKey || !sameCenter || (staticPaintCacheDrawFast && !context.drawFast)))
+        {
+          // View or features changed - restart the progressive build. A cache drawn with
+          // reduced detail while moving is also rebuilt for the full quality still frame.
+          staticPaintCache = QPixmap(mapWidget->size());
+          staticPaintCache.fill(Qt::transparent);
+          staticPaintCacheKey = cacheKey;
+          staticPaintCacheCenterLon = viewport->centerLongitude();
+          staticPaintCacheCenterLat = viewport->centerLatitude();
+          staticPaintCacheDrawFast = context.drawFast;
+          staticPaintCacheProgress = 0;
+          staticPaintCacheObjectCount = 0;
         }
+
+        // Keep object count consistent with a full paint for the overflow checks
+        context.objectCount += staticPaintCacheObjectCount;
+
+        if(!reuseShifted && staticPaintCacheProgress < staticPainters.size())
+        {
+          GeoPainter cachePainter(&staticPaintCache, viewport, mapWidget->mapQuality(mapWidget->viewContext()));
+          cachePainter.setRenderHints(painter->renderHints());
+          cachePainter.setFont(context.defaultFont);
+          context.painter = &cachePainter;
+
+          while(staticPaintCacheProgress < staticPainters.size() && !context.isOverflow())
+          {
+            int objectCountBefore = context.objectCount;
+            renderTimed(staticPainters.at(staticPaintCacheProgress).first,
+                        staticPainters.at(staticPaintCacheProgress).second);
+            staticPaintCacheObjectCount += context.objectCount - objectCountBefore;
+            staticPaintCacheProgress++;
+
+            // Postpone the remaining painters if the budget is used up. At least one painter
+            // completes per frame to guarantee progress.
+            if(staticPaintCacheProgress < staticPainters.size() && frameTimer.elapsed() > RENDER_BUDGET_MS)
+            {
+              mapWidget->update();
+              break;
+            }
+          }
+
+          context.painter = painter;
+        }
+
+        painter->drawPixmap(cacheOffset, staticPaintCache);
       }
 
       if(!context.isOverflow())
-        mapPainterUser->render();
+        renderTimed("user", mapPainterUser);
 
-      mapPainterWind->render();
+      // Wind barbs and airport weather are expensive and can be dropped while the map is moving
+      // once the budget is used up - they appear again with the final still frame
+      bool budgetLeft = mapWidget->viewContext() == Marble::Still || frameTimer.elapsed() < RENDER_BUDGET_MS;
+      if(budgetLeft)
+        renderTimed("wind", mapPainterWind);
 
       // if(!context.isOverflow()) always paint route even if number of objets is too large
-      mapPainterRoute->render();
+      renderTimed("route", mapPainterRoute);
 
-      mapPainterWeather->render();
+      if(budgetLeft)
+        renderTimed("weather", mapPainterWeather);
 
-      mapPainterTrack->render();
+      renderTimed("track", mapPainterTrack);
 
       // if(!context.isOverflow())
-      mapPainterMark->render();
+      renderTimed("mark", mapPainterMark);
 
-      mapPainterAircraft->render();
+      renderTimed("aircraft", mapPainterAircraft);
 
-      mapPainterTop->render();
+      renderTimed("top", mapPainterTop);
 
       if(context.isOverflow())
         overflow = PaintContext::MAX_OBJECT_COUNT;
       else
         overflow = 0;
+
+#ifdef DEBUG_INFORMATION_PAINT
+      for(const std::pair<QString, qint64>& time : renderTimes)
+        qDebug() << Q_FUNC_INFO << "painter" << time.first << time.second << "ms";
+#endif
+
+      qint64 frameMs = frameTimer.elapsed();
+
+      // Feed the detail governor with full quality still frames of the visible map only
+      if(mapWidget->isVisibleWidget() && !mapWidget->isPrinting() &&
+         mapWidget->viewContext() == Marble::Still && !context.drawFast)
+        adaptDetail(frameMs);
+
+      if(renderDebug)
+      {
+        updateRenderStats(frameMs);
+
+        if(mapWidget->isVisibleWidget() && !mapWidget->isPrinting())
+          paintRenderDebug(painter, frameMs);
+      }
     }
 
     if(!mapWidget->isPrinting() && mapWidget->isVisibleWidget())
@@ -688,3 +919,82 @@ bool MapPaintLayer::render(GeoPainter *painter, ViewportParams *viewport, const
   }
   return true;
 }
+
+void MapPaintLayer::updateRenderStats(qint64 frameMs)
+{
+  for(const std::pair<QString, qint64>& time : renderTimes)
+  {
+    RenderStat& stat = renderStats[time.first];
+    stat.frames++;
+    stat.totalMs += time.second;
+    stat.maxMs = std::max(stat.maxMs, time.second);
+  }
+
+  frameStat.frames++;
+  frameStat.totalMs += frameMs;
+  frameStat.maxMs = std::max(frameStat.maxMs, frameMs);
+}
+
+void MapPaintLayer::paintRenderDebug(Marble::GeoPainter *painter, qint64 frameMs)
+{
+  // One line per painter in paint order plus frame and screen index summary
+  QStringList lines;
+  for(const std::pair<QString, qint64>& time : renderTimes)
+  {
+    const RenderStat& stat = renderStats.value(time.first);
+    lines.append(QString("%1 %2 ms avg %3 max %4").
+                 arg(time.first, -8).arg(time.second, 4).
+                 arg(stat.frames > 0 ? stat.totalMs / stat.frames : 0, 4).arg(stat.maxMs, 4));
+  }
+  lines.append(QString("%1 %2 ms avg %3 max %4").
+               arg(QString("frame"), -8).arg(frameMs, 4).
+               arg(frameStat.frames > 0 ? frameStat.totalMs / frameStat.frames : 0, 4).
+               arg(frameStat.maxMs, 4));
+  lines.append(QString("%1 %2 ms objects %3").
+               arg(QString("index"), -8).
+               arg(mapWidget->getScreenIndexConst()->getLastUpdateAllTimeMs(), 4).arg(context.objectCount));
+
+  painter->save();
+  painter->setFont(QFont("Monospace", 8));
+
+  QFontMetrics metrics = painter->fontMetrics();
+  int textWidth = 0;
+  for(const QString& line : lines)
+    textWidth = std::max(textWidth, metrics.width(line));
+
+  painter->setPen(Qt::NoPen);
+  painter->setBrush(QColor(0, 0, 0, 140));
+  painter->drawRect(0, 0, textWidth + 10, metrics.height() * lines.size() + 10);
+
+  painter->setPen(Qt::white);
+  int y = 5 + metrics.ascent();
+  for(const QString& line : lines)
+  {
+    painter->drawText(5, y, line);
+    y += metrics.height();
+  }
+  painter->restore();
+}
+
+void MapPaintLayer::saveRenderStats() const
+{
+  if(renderStats.isEmpty())
+    return;
+
+  QFile file(atools::settings::Settings::getConfigFilename("_render_stats.csv"));
+  if(file.open(QIODevice::WriteOnly | QIODevice::Text))
+  {
+    QTextStream stream(&file);
+    stream << "painter,frames,total_ms,avg_ms,max_ms" << endl;
+    for(auto it = renderStats.constBegin(); it != renderStats.constEnd(); ++it)
+      stream << it.key() << "," << it.value().frames << "," << it.value().totalMs << ","
+             << (it.value().frames > 0 ? it.value().totalMs / it.value().frames : 0) << ","
+             << it.value().maxMs << endl;
+    stream << "frame," << frameStat.frames << "," << frameStat.totalMs << ","
+           << (frameStat.frames > 0 ? frameStat.totalMs / frameStat.frames : 0) << ","
+           << frameStat.maxMs << endl;
+    file.close();
+  }
+  else
+    qWarning() << "Cannot write render statistics" << file.fileName() << ":" << file.errorString();
+}
@@ -21,6 +21,7 @@
 #include "mappainter/mappainter.h"
 
 #include <QPen>
+#include <QPixmap>
 
 #include <marble/LayerInterface.h>
 
@@ -68,6 +69,10 @@ public:
   void preDatabaseLoad();
   void postDatabaseLoad();
 
+  /* Drop the cached rendering of the static feature stack. Has to be called if underlying
+   * data changed without any viewport or shown-feature change like after a userpoint edit. */
+  void invalidateStaticPaintCache();
+
   /* Get the current map layer for the zoom distance and detail level */
   const MapLayer *getMapLayer() const
   {
@@ -80,6 +85,10 @@ public:
     return mapLayerEffective;
   }
 
+  /* Get a map layer for the given zoom distance independent of the current view.
+   * Used by the web API to select the feature detail level. */
+  const MapLayer *getMapLayerForDistance(float distanceKm) const;
+
   /* Set the flags for map objects on or off depending on value show. Does not repaint */
   void setShowMapObjects(map::MapTypes type, bool show);
   void setShowMapObjectsDisplay(map::MapObjectDisplayTypes type, bool show);
@@ -93,6 +102,13 @@ public:
     return detailFactor;
   }
 
+  /* Detail factor reduction applied by the adaptive governor when the machine cannot keep up
+   * with the frame budget. Zero while the map renders fast enough. */
+  int getAdaptiveDetailOffset() const
+  {
+    return adaptiveDetailOffset;
+  }
+
   /* Get all shown map objects like airports, VOR, NDB, etc. */
   map::MapTypes getShownMapObjects() const
   {
@@ -124,6 +140,12 @@ public:
     return overflow;
   }
 
+  /* Rendering time of the last paint pass in milliseconds by painter name in paint order */
+  const QVector<std::pair<QString, qint64> >& getRenderTimesMs() const
+  {
+    return renderTimes;
+  }
+
   map::MapWeatherSource getWeatherSource() const
   {
     return weatherSource;
@@ -148,6 +170,18 @@ private:
   void initMapLayerSettings();
   void updateLayers();
 
+  /* Key describing viewport and all shown-feature state of the static painter stack */
+  QString buildStaticPaintCacheKey(const Marble::ViewportParams *viewport) const;
+
+  /* Add the per-painter times of the last frame to the aggregated statistics */
+  void updateRenderStats(qint64 frameMs);
+
+  /* Draw last, average and maximum render times per painter on top of the map */
+  void paintRenderDebug(Marble::GeoPainter *painter, qint64 frameMs);
+
+  /* Write the aggregated statistics to a CSV file in the settings directory */
+  void saveRenderStats() const;
+
   /* Implemented from LayerInterface: We  draw above all but below user tools */
   virtual QStringList renderPosition() const override
   {
@@ -165,9 +199,20 @@ private:
   map::MapWeatherSource weatherSource = map::WEATHER_SOURCE_SIMULATOR;
   map::MapSunShading sunShading = map::SUN_SHADING_SIMULATOR_TIME;
 
+  /* Measure still frame times and step the effective detail level down when the map stays
+   * over budget and back up when headroom returns. */
+  void adaptDetail(qint64 frameMs);
+
+  /* User detail factor with the adaptive reduction applied and clamped to the allowed range */
+  int effectiveDetailFactor() const;
+
   /* Default detail factor. Range is from 5 to 15 */
   int detailFactor = 10;
 
+  /* State of the adaptive detail governor - see adaptDetail() */
+  int adaptiveDetailOffset = 0;
+  int framesOverBudget = 0, framesUnderBudget = 0;
+
   bool databaseLoadStatus = false;
 
   PaintContext context;
@@ -197,6 +242,35 @@ private:
   const MapLayer *mapLayer = nullptr, *mapLayerEffective = nullptr;
   int overflow = 0;
 
+  /* Cached rendering of the static feature stack (airspaces, ILS, navaids and airports).
+   * Valid as long as the viewport and the shown features captured in the key do not change. */
+  QPixmap staticPaintCache;
+  QString staticPaintCacheKey;
+  int staticPaintCacheObjectCount = 0;
+
+  /* Number of painters of the static stack already rendered into the pixmap. The stack is
+   * filled progressively across frames if the frame time budget is used up. */
+  int staticPaintCacheProgress = 0;
+
+  /* Viewport center the pixmap was rendered for in radians and the fast drawing state.
+   * Kept outside of the key so a complete cache can be reused shifted while panning. */
+  double staticPaintCacheCenterLon = 0., staticPaintCacheCenterLat = 0.;
+  bool staticPaintCacheDrawFast = false;
+
+  /* Per-painter timing of the last paint pass */
+  QVector<std::pair<QString, qint64> > renderTimes;
+
+  /* Aggregated render times since program start. Only collected if the render debug
+   * overlay is enabled in the configuration file. */
+  struct RenderStat
+  {
+    qint64 frames = 0, totalMs = 0, maxMs = 0;
+  };
+
+  QMap<QString, RenderStat> renderStats;
+  RenderStat frameStat;
+  bool renderDebug = false;
+
 };
 
 #endif // LITTLENAVMAP_MAPPAINTLAYER_H
@@ -56,6 +56,7 @@
 
 #include <QIcon>
 #include <QSplashScreen>
+#include <QTimer>
 
 AirportQuery *NavApp::airportQuerySim = nullptr;
 AirportQuery *NavApp::airportQueryNav = nullptr;
@@ -142,8 +143,9 @@ void NavApp::init(MainWindow *mainWindowParam)
 
   // Create a CSV backup - not needed since the database is backed up now
   // userdataController->backup();
-  // Clear temporary userpoints
-  userdataController->clearTemporary();
+  // Clear temporary userpoints deferred once the event loop runs to keep the database write
+  // off the startup path
+  QTimer::singleShot(0, userdataController, &UserdataController::clearTemporary);
 
   onlinedataController = new OnlinedataController(databaseManager->getOnlinedataManager(), mainWindow);
   onlinedataController->initQueries();
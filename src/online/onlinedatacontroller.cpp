@@ -37,6 +37,7 @@
 #include <QMessageBox>
 #include <QTextCodec>
 #include <QApplication>
+#include <QtConcurrent/QtConcurrentRun>
 
 // #define DEBUG_ONLINE_DOWNLOAD 1
 
@@ -87,6 +88,9 @@ OnlinedataController::OnlinedataController(atools::fs::online::OnlinedataManager
   // Recurring downloads
   connect(&downloadTimer, &QTimer::timeout, this, &OnlinedataController::startDownloadInternal);
 
+  // Applies parsed whazzup data after decompression and decoding on the worker
+  connect(&whazzupWatcher, &QFutureWatcher<QString>::finished, this, &OnlinedataController::whazzupDecodingFinished);
+
   using namespace std::placeholders;
   manager->setGeometryCallback(std::bind(&OnlinedataController::geometryCallback, this, _1, _2));
 
@@ -258,60 +262,24 @@ void OnlinedataController::downloadFinished(const QByteArray& data, QString url)
   }
   else if(currentState == DOWNLOADING_WHAZZUP)
   {
-    QByteArray whazzupData;
-
-    if(whazzupGzipped)
-    {
-      if(!atools::zip::gzipDecompress(data, whazzupData))
-        qWarning() << Q_FUNC_INFO << "Error unzipping data";
-    }
-    else
-      whazzupData = data;
-
-    if(manager->readFromWhazzup(codec->toUnicode(whazzupData),
-                                convertFormat(OptionData::instance().getOnlineFormat()),
-                                manager->getLastUpdateTimeFromWhazzup()))
-    {
-      // Get all callsigns and positions from online list to allow deduplication
-      clientCallsignAndPosMap.clear();
-      manager->getClientCallsignAndPosMap(clientCallsignAndPosMap);
-      qDebug() << Q_FUNC_INFO << clientCallsignAndPosMap.size();
-
-      QString whazzupVoiceUrlFromStatus = manager->getWhazzupVoiceUrlFromStatus();
-      if(!whazzupVoiceUrlFromStatus.isEmpty() &&
-         lastServerDownload < QDateTime::currentDateTime().addSecs(-MIN_SERVER_DOWNLOAD_INTERVAL_MIN * 60))
+    // Decompress and decode the multi-megabyte file on a worker thread to avoid
+    // freezing the map on every update cycle. The watcher continues the chain.
+    bool gzipped = whazzupGzipped;
+    QTextCodec *textCodec = codec;
+    whazzupFuture = QtConcurrent::run([data, gzipped, textCodec]() -> QString {
+      QByteArray whazzupData;
+
+      if(gzipped)
       {
-        // Next in chain is server file
-        currentState = DOWNLOADING_WHAZZUP_SERVERS;
-        downloader->setUrl(whazzupVoiceUrlFromStatus);
-
-        // Call later in the event loop to avoid recursion
-        QTimer::singleShot(0, downloader, &HttpDownloader::startDownload);
+        if(!atools::zip::gzipDecompress(data, whazzupData))
+          qWarning() << Q_FUNC_INFO << "Error unzipping data";
       }
       else
-      {
-        // Done after downloading whazzup.txt - start timer for next session
-        startDownloadTimer();
-        currentState = NONE;
-        lastUpdateTime = QDateTime::currentDateTime();
-
-        aircraftCache.clear();
-        simulatorAiRegistrations.clear();
-
-        // Message for search tabs, map widget and info
-        emit onlineClientAndAtcUpdated(true /* load all */, true /* keep selection */);
-        statusBarMessage();
-      }
-    }
-    else
-    {
-      qInfo() << Q_FUNC_INFO << "whazzup.txt is not recent";
+        whazzupData = data;
 
-      // Done after old update - try again later
-      startDownloadTimer();
-      currentState = NONE;
-      lastUpdateTime = QDateTime::currentDateTime();
-    }
+      return textCodec->toUnicode(whazzupData);
+    });
+    whazzupWatcher.setFuture(whazzupFuture);
   }
   else if(currentState == DOWNLOADING_WHAZZUP_SERVERS)
   {
@@ -327,6 +295,7 @@ void OnlinedataController::downloadFinished(const QByteArray& data, QString url)
 
     aircraftCache.clear();
     simulatorAiRegistrations.clear();
+    updateAggregates();
 
     // Message for search tabs, map widget and info
     emit onlineClientAndAtcUpdated(true /* load all */, true /* keep selection */);
@@ -335,6 +304,59 @@ void OnlinedataController::downloadFinished(const QByteArray& data, QString url)
   }
 }
 
+void OnlinedataController::whazzupDecodingFinished()
+{
+  if(currentState != DOWNLOADING_WHAZZUP)
+    // Processes were stopped while the worker was busy
+    return;
+
+  if(manager->readFromWhazzup(whazzupFuture.result(),
+                              convertFormat(OptionData::instance().getOnlineFormat()),
+                              manager->getLastUpdateTimeFromWhazzup()))
+  {
+    // Get all callsigns and positions from online list to allow deduplication
+    clientCallsignAndPosMap.clear();
+    manager->getClientCallsignAndPosMap(clientCallsignAndPosMap);
+    qDebug() << Q_FUNC_INFO << clientCallsignAndPosMap.size();
+
+    QString whazzupVoiceUrlFromStatus = manager->getWhazzupVoiceUrlFromStatus();
+    if(!whazzupVoiceUrlFromStatus.isEmpty() &&
+       lastServerDownload < QDateTime::currentDateTime().addSecs(-MIN_SERVER_DOWNLOAD_INTERVAL_MIN * 60))
+    {
+      // Next in chain is server file
+      currentState = DOWNLOADING_WHAZZUP_SERVERS;
+      downloader->setUrl(whazzupVoiceUrlFromStatus);
+
+      // Call later in the event loop to avoid recursion
+      QTimer::singleShot(0, downloader, &HttpDownloader::startDownload);
+    }
+    else
+    {
+      // Done after downloading whazzup.txt - start timer for next session
+      startDownloadTimer();
+      currentState = NONE;
+      lastUpdateTime = QDateTime::currentDateTime();
+
+      aircraftCache.clear();
+      simulatorAiRegistrations.clear();
+      updateAggregates();
+
+      // Message for search tabs, map widget and info
+      emit onlineClientAndAtcUpdated(true /* load all */, true /* keep selection */);
+      statusBarMessage();
+    }
+  }
+  else
+  {
+    qInfo() << Q_FUNC_INFO << "whazzup.txt is not recent";
+
+    // Done after old update - try again later
+    startDownloadTimer();
+    currentState = NONE;
+    lastUpdateTime = QDateTime::currentDateTime();
+  }
+}
+
 void OnlinedataController::downloadFailed(const QString& error, int errorCode, QString url)
 {
   qWarning() << Q_FUNC_INFO << "Failed" << error << errorCode << url;
@@ -368,13 +390,25 @@ void OnlinedataController::downloadSslErrors(const QStringList& errors, const QS
 
 void OnlinedataController::statusBarMessage()
 {
-  mainWindow->setOnlineConnectionStatusMessageText(QString(), tr("Connected to %1.").arg(getNetworkTranslated()));
+  if(numClientsAggregated > 0 || numAtcAggregated > 0)
+    // Traffic counter from the aggregates of the last update
+    mainWindow->setOnlineConnectionStatusMessageText(QString(),
+                                                     tr("Connected to %1. %2 clients and %3 ATC online.").
+                                                     arg(getNetworkTranslated()).
+                                                     arg(numClientsAggregated).arg(numAtcAggregated));
+  else
+    mainWindow->setOnlineConnectionStatusMessageText(QString(), tr("Connected to %1.").arg(getNetworkTranslated()));
 }
 
 void OnlinedataController::stopAllProcesses()
 {
   downloader->cancelDownload();
   downloadTimer.stop();
+
+  // Let a running decode job finish - the result is discarded since the state is reset
+  if(whazzupFuture.isRunning())
+    whazzupFuture.waitForFinished();
+
   currentState = NONE;
   simulatorAiRegistrations.clear();
   // clientCallsignAndPosMap.clear(); // Do not clear these until the download is finished
@@ -423,6 +457,7 @@ void OnlinedataController::optionsChanged()
   clientCallsignAndPosMap.clear();
 
   updateAtcSizes();
+  updateAggregates();
 
   emit onlineClientAndAtcUpdated(true /* load all */, true /* keep selection */);
   emit onlineServersUpdated(true /* load all */, true /* keep selection */);
@@ -503,6 +538,22 @@ const QList<atools::fs::sc::SimConnectAircraft> *OnlinedataController::getAircra
   return &aircraftCache.list;
 }
 
+/* Compares the registration keys of two hashes without depending on hash order and without
+ * building temporary key lists. Called for each paint pass. */
+static bool sameRegistrationKeys(const QHash<QString, atools::geo::Pos>& hash1,
+                                 const QHash<QString, atools::geo::Pos>& hash2)
+{
+  if(hash1.size() != hash2.size())
+    return false;
+
+  for(auto it = hash1.constBegin(); it != hash1.constEnd(); ++it)
+  {
+    if(!hash2.contains(it.key()))
+      return false;
+  }
+  return true;
+}
+
 const QList<atools::fs::sc::SimConnectAircraft> *OnlinedataController::getAircraft(const Marble::GeoDataLatLonBox& rect,
                                                                                    const MapLayer *mapLayer, bool lazy)
 {
@@ -529,7 +580,7 @@ const QList<atools::fs::sc::SimConnectAircraft> *OnlinedataController::getAircra
   }
   curRegistrations.remove(QString());
 
-  if(simulatorAiRegistrations.keys() != curRegistrations.keys())
+  if(!sameRegistrationKeys(simulatorAiRegistrations, curRegistrations))
     // List of registrations has changed - clear cache and reload
     aircraftCache.clear();
 
@@ -542,14 +593,18 @@ const QList<atools::fs::sc::SimConnectAircraft> *OnlinedataController::getAircra
       aircraftByRectQuery->exec();
       while(aircraftByRectQuery->next())
       {
-        atools::fs::sc::SimConnectAircraft aircraft;
-        fillAircraftFromClient(aircraft, aircraftByRectQuery->record());
-
-        if(!curRegistrations.contains(aircraft.getAirplaneRegistration()) ||
-           aircraft.getPosition().distanceMeterTo(curRegistrations.value(aircraft.getAirplaneRegistration())) >
-           MIN_DISTANCE_DUPLICATE_M)
+        // Check the duplicate condition on the raw callsign and coordinate columns before
+        // converting the whole record - most shadowed clients are dropped here
+        QString callsign = aircraftByRectQuery->valueStr("callsign");
+        if(curRegistrations.contains(callsign) &&
+           Pos(aircraftByRectQuery->valueFloat("lonx"), aircraftByRectQuery->valueFloat("laty")).
+           distanceMeterTo(curRegistrations.value(callsign)) <= MIN_DISTANCE_DUPLICATE_M)
           // Avoid duplicates with simulator aircraft that are close by
-          aircraftCache.list.append(aircraft);
+          continue;
+
+        // Build the aircraft in place in the cache list
+        aircraftCache.list.append(atools::fs::sc::SimConnectAircraft());
+        fillAircraftFromClient(aircraftCache.list.last(), aircraftByRectQuery->record());
       }
     }
     simulatorAiRegistrations = curRegistrations;
@@ -642,6 +697,8 @@ void OnlinedataController::initQueries()
 void OnlinedataController::deInitQueries()
 {
   aircraftCache.clear();
+  numClientsAggregated = numAtcAggregated = 0;
+  numAtcByFacility.clear();
 
   manager->deInitQueries();
 
@@ -649,9 +706,23 @@ void OnlinedataController::deInitQueries()
   aircraftByRectQuery = nullptr;
 }
 
-int OnlinedataController::getNumClients() const
+void OnlinedataController::updateAggregates()
 {
-  return manager->getNumClients();
+  // One pass over both tables per update instead of count queries on each refresh
+  numClientsAggregated = manager->getNumClients();
+
+  numAtcAggregated = 0;
+  numAtcByFacility.clear();
+
+  atools::sql::SqlQuery query("select facility_type, count(1) as cnt from atc group by facility_type",
+                              getDatabase());
+  query.exec();
+  while(query.next())
+  {
+    int num = query.valueInt("cnt");
+    numAtcByFacility.insert(static_cast<atools::fs::online::fac::FacilityType>(query.valueInt("facility_type")), num);
+    numAtcAggregated += num;
+  }
 }
 
 void OnlinedataController::startDownloadTimer()
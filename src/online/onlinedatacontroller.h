@@ -19,6 +19,8 @@
 #define LNM_ONLINECONTROLLER_H
 
 #include <QDateTime>
+#include <QFuture>
+#include <QFutureWatcher>
 #include <QObject>
 #include <QTimer>
 
@@ -125,7 +127,24 @@ public:
   /* Create and prepare all queries */
   void deInitQueries();
 
-  int getNumClients() const;
+  /* Client and ATC counts aggregated in one pass when a whazzup update is applied.
+   * Status bar and info tabs read these instead of running count queries against the
+   * online tables on every refresh. */
+  int getNumClients() const
+  {
+    return numClientsAggregated;
+  }
+
+  int getNumAtc() const
+  {
+    return numAtcAggregated;
+  }
+
+  /* Number of ATC per facility type from the last update */
+  const QHash<atools::fs::online::fac::FacilityType, int>& getNumAtcByFacility() const
+  {
+    return numAtcByFacility;
+  }
 
   /* Get an online network aircraft that has the same registration as the simulator aircraft and is close by */
   bool getShadowAircraft(atools::fs::sc::SimConnectAircraft& onlineClient,
@@ -155,6 +174,13 @@ private:
   void stopAllProcesses();
   void updateAtcSizes();
 
+  /* Recount clients and ATC once after applying or clearing downloaded data */
+  void updateAggregates();
+
+  /* Called by watcher when whazzup decompression and decoding on the worker is done.
+   * Applies the parsed data to the database and continues the download chain. */
+  void whazzupDecodingFinished();
+
   /* Show message from status.txt */
   void showMessageDialog();
 
@@ -195,6 +221,14 @@ private:
 
   query::SimpleRectCache<atools::fs::sc::SimConnectAircraft> aircraftCache;
   atools::sql::SqlQuery *aircraftByRectQuery = nullptr;
+
+  /* Aggregates from the last update - see updateAggregates() */
+  int numClientsAggregated = 0, numAtcAggregated = 0;
+  QHash<atools::fs::online::fac::FacilityType, int> numAtcByFacility;
+
+  /* Decompresses and decodes the downloaded whazzup data off the GUI thread */
+  QFuture<QString> whazzupFuture;
+  QFutureWatcher<QString> whazzupWatcher;
 };
 
 #endif // LNM_ONLINECONTROLLER_H
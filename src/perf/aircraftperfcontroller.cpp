@@ -61,7 +61,6 @@ AircraftPerfController::AircraftPerfController(MainWindow *parent)
 
   perf = new AircraftPerf();
 
-  lastSimData = new atools::fs::sc::SimConnectData();
   // Remember original font for resizing in options
   infoFontPtSize = static_cast<float>(ui->textBrowserAircraftPerformanceReport->font().pointSizeF());
 
@@ -101,7 +100,6 @@ AircraftPerfController::~AircraftPerfController()
   delete fileHistory;
   delete perfHandler;
   delete perf;
-  delete lastSimData;
 }
 
 void AircraftPerfController::create()
@@ -975,7 +973,7 @@ void AircraftPerfController::fuelReport(atools::util::HtmlBuilder& html, bool pr
       html.p().warning(tr("Aircraft type is not set.")).pEnd();
     else
     {
-      QString model = lastSimData->getUserAircraft().getAirplaneModel();
+      const QString& model = lastAircraftModel;
       if(!model.isEmpty() && perf->getAircraftType() != model)
         html.p().
         warning(tr("Airplane model does not match:")).br().
@@ -1232,18 +1230,19 @@ void AircraftPerfController::optionsChanged()
 void AircraftPerfController::connectedToSimulator()
 {
   currentReportLastSampleTimeMs = reportLastSampleTimeMs = 0L; // Force update on next simDataChanged
-  *lastSimData = atools::fs::sc::SimConnectData();
+  lastAircraftModel.clear();
 }
 
 void AircraftPerfController::disconnectedFromSimulator()
 {
-  *lastSimData = atools::fs::sc::SimConnectData();
+  lastAircraftModel.clear();
   updateReports();
 }
 
 void AircraftPerfController::simDataChanged(const atools::fs::sc::SimConnectData& simulatorData)
 {
-  *lastSimData = simulatorData;
+  // Only the airplane model is needed from the data - the implicit sharing makes this copy free
+  lastAircraftModel = simulatorData.getUserAircraft().getAirplaneModel();
 
   // Pass to handler for averaging
   perfHandler->simDataChanged(simulatorData);
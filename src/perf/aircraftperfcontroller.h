@@ -240,7 +240,9 @@ private:
 
   /* Timer to delay wind updates */
   QTimer windChangeTimer;
-  atools::fs::sc::SimConnectData *lastSimData;
+
+  /* Simulator airplane model for the type mismatch warning in the report */
+  QString lastAircraftModel;
 };
 
 #endif // LNM_AIRCRAFTPERFCONTROLLER_H
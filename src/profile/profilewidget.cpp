@@ -31,7 +31,9 @@
 #include "route/routealtitude.h"
 #include "common/aircrafttrack.h"
 #include "common/unit.h"
+#include "common/constants.h"
 #include "common/formatter.h"
+#include "common/perftrace.h"
 #include "settings/settings.h"
 #include "mapgui/mapwidget.h"
 #include "options/optiondata.h"
@@ -99,6 +101,10 @@ ProfileWidget::ProfileWidget(QWidget *parent)
 
   routeController = NavApp::getRouteController();
 
+  // Same switch that controls merging of the altitude profile legs
+  simplifyProfile = atools::settings::Settings::instance().
+                    getAndStoreValue(lnm::OPTIONS_PROFILE_SIMPLYFY, true).toBool();
+
   // Create single shot timer that will restart the thread after a delay
   updateTimer = new QTimer(this);
   updateTimer->setSingleShot(true);
@@ -273,6 +279,9 @@ void ProfileWidget::updateScreenCoords()
 {
   /* Update all screen coordinates and scale factors */
 
+  // Geometry or display settings changed - repaint the static background on the next paint event
+  backgroundPixmapKey.clear();
+
   // Widget drawing region width and height
   int w = rect().width() - X0 * 2, h = rect().height() - Y0;
 
@@ -595,56 +604,20 @@ void ProfileWidget::paintVasi(QPainter& painter, const Route& route)
   }
 }
 
-void ProfileWidget::paintEvent(QPaintEvent *)
+/* Paints terrain, scale lines, flight plan legs, symbols and labels into the background
+ * pixmap. Expensive and only executed if the geometry, display settings or progress changed. */
+void ProfileWidget::paintBackground(QPainter& painter, const Route& route, int activeRouteLeg,
+                                    int passedRouteLeg)
 {
-  // Saved route that was used to create the geometry
-  // const Route& route = legList.route;
-
-  // Get a copy of the active route
-  Route route = NavApp::getRoute();
   const RouteAltitude& altitudeLegs = route.getAltitudeLegs();
 
   // Keep margin to left, right and top
   int w = rect().width() - X0 * 2, h = rect().height() - Y0;
 
-  // Nothing to show label =========================
-  SymbolPainter symPainter;
-  QPainter painter(this);
-  if(route.isEmpty())
-  {
-    symPainter.textBox(&painter, {tr("No Flight Plan loaded.")}, QApplication::palette().color(QPalette::Text),
-                       X0 + w / 2, Y0 + h / 2, textatt::BOLD | textatt::CENTER, 0);
-    scrollArea->updateLabelWidget();
-    return;
-  }
-  else if(!hasValidRouteForDisplay(route))
-  {
-    symPainter.textBox(&painter, {tr("Flight Plan not valid.")}, QApplication::palette().color(QPalette::Text),
-                       X0 + w / 2, Y0 + h / 2, textatt::BOLD | textatt::CENTER, 0);
-    scrollArea->updateLabelWidget();
-    return;
-  }
-
-  if(legList.route.size() != route.size() ||
-     atools::almostNotEqual(legList.route.getTotalDistance(), route.getTotalDistance()))
-    // Do not draw if route is updated to avoid invalid indexes
-    return;
-
-  if(altitudeLegs.size() != route.size())
-  {
-    // Do not draw if route altitudes are not updated to avoid invalid indexes
-    qWarning() << Q_FUNC_INFO << "Route altitudes not udpated";
-    return;
-  }
-
-  // Draw grey vertical lines for waypoints
   int flightplanY = getFlightplanAltY();
   int safeAltY = getMinSafeAltitudeY();
-  if(flightplanY == map::INVALID_INDEX_VALUE || safeAltY == map::INVALID_INDEX_VALUE)
-  {
-    qWarning() << Q_FUNC_INFO << "No flight plan elevation";
-    return;
-  }
+
+  SymbolPainter symPainter;
 
   // Fill background sky blue ====================================================
   painter.setRenderHint(QPainter::Antialiasing);
@@ -808,21 +781,6 @@ void ProfileWidget::paintEvent(QPaintEvent *)
 
   const OptionData& optData = OptionData::instance();
 
-  // Get active route leg but ignore alternate legs
-  bool activeValid = route.isActiveValid();
-
-  // Active normally start at 1 - this will consider all legs as not passed
-  int activeRouteLeg = activeValid ? std::min(route.getActiveLegIndex(), waypointX.size() - 1) : 0;
-  int passedRouteLeg = optData.getFlags2() & opts2::MAP_ROUTE_DIM_PASSED ? activeRouteLeg : 0;
-
-  if(route.isActiveAlternate())
-  {
-    // Disable active leg and show all legs as passed if an alternate is enabled
-    activeRouteLeg = 0;
-    passedRouteLeg = optData.getFlags2() & opts2::MAP_ROUTE_DIM_PASSED ?
-                     std::min(passedRouteLeg + 1, waypointX.size()) : 0;
-  }
-
   if(NavApp::getMapWidget()->getShownMapFeaturesDisplay().testFlag(map::FLIGHTPLAN))
   {
     // Draw background line ======================================================
@@ -1129,6 +1087,109 @@ void ProfileWidget::paintEvent(QPaintEvent *)
     symPainter.textBox(&painter, {destAltStr}, labelColor, X0 + w + 4, destinationAltTextY,
                        textatt::BOLD | textatt::LEFT, 255);
   } // if(NavApp::getMapWidget()->getShownMapFeatures() & map::FLIGHTPLAN)
+}
+
+QString ProfileWidget::buildBackgroundPixmapKey(int activeRouteLeg, int passedRouteLeg) const
+{
+  Ui::MainWindow *ui = NavApp::getMainUi();
+
+  // Progress and all toggles which repaint the profile without calling updateScreenCoords()
+  return QStringList({QString::number(activeRouteLeg),
+                      QString::number(passedRouteLeg),
+                      QString::number(static_cast<int>(NavApp::getMapWidget()->getShownMapFeaturesDisplay())),
+                      QString::number(ui->actionProfileShowIls->isChecked()),
+                      QString::number(ui->actionProfileShowVasi->isChecked())}).join('_');
+}
+
+void ProfileWidget::paintEvent(QPaintEvent *)
+{
+  // Saved route that was used to create the geometry
+  // const Route& route = legList.route;
+
+  // Get a copy of the active route
+  Route route = NavApp::getRoute();
+  const RouteAltitude& altitudeLegs = route.getAltitudeLegs();
+
+  // Keep margin to left, right and top
+  int w = rect().width() - X0 * 2, h = rect().height() - Y0;
+
+  // Nothing to show label =========================
+  SymbolPainter symPainter;
+  QPainter painter(this);
+  if(route.isEmpty())
+  {
+    symPainter.textBox(&painter, {tr("No Flight Plan loaded.")}, QApplication::palette().color(QPalette::Text),
+                       X0 + w / 2, Y0 + h / 2, textatt::BOLD | textatt::CENTER, 0);
+    scrollArea->updateLabelWidget();
+    return;
+  }
+  else if(!hasValidRouteForDisplay(route))
+  {
+    symPainter.textBox(&painter, {tr("Flight Plan not valid.")}, QApplication::palette().color(QPalette::Text),
+                       X0 + w / 2, Y0 + h / 2, textatt::BOLD | textatt::CENTER, 0);
+    scrollArea->updateLabelWidget();
+    return;
+  }
+
+  if(legList.route.size() != route.size() ||
+     atools::almostNotEqual(legList.route.getTotalDistance(), route.getTotalDistance()))
+    // Do not draw if route is updated to avoid invalid indexes
+    return;
+
+  if(altitudeLegs.size() != route.size())
+  {
+    // Do not draw if route altitudes are not updated to avoid invalid indexes
+    qWarning() << Q_FUNC_INFO << "Route altitudes not udpated";
+    return;
+  }
+
+  // Check for valid cruise and safe altitude positions
+  int flightplanY = getFlightplanAltY();
+  int safeAltY = getMinSafeAltitudeY();
+  if(flightplanY == map::INVALID_INDEX_VALUE || safeAltY == map::INVALID_INDEX_VALUE)
+  {
+    qWarning() << Q_FUNC_INFO << "No flight plan elevation";
+    return;
+  }
+
+  painter.setRenderHint(QPainter::Antialiasing);
+  painter.setRenderHint(QPainter::SmoothPixmapTransform);
+
+  const OptionData& optData = OptionData::instance();
+
+  // Get active route leg but ignore alternate legs
+  bool activeValid = route.isActiveValid();
+
+  // Active normally start at 1 - this will consider all legs as not passed
+  int activeRouteLeg = activeValid ? std::min(route.getActiveLegIndex(), waypointX.size() - 1) : 0;
+  int passedRouteLeg = optData.getFlags2() & opts2::MAP_ROUTE_DIM_PASSED ? activeRouteLeg : 0;
+
+  if(route.isActiveAlternate())
+  {
+    // Disable active leg and show all legs as passed if an alternate is enabled
+    activeRouteLeg = 0;
+    passedRouteLeg = optData.getFlags2() & opts2::MAP_ROUTE_DIM_PASSED ?
+                     std::min(passedRouteLeg + 1, waypointX.size()) : 0;
+  }
+
+  // Repaint the static background only if geometry, display settings or flight progress
+  // changed. Plain aircraft updates reuse the cached image and draw only the overlay below.
+  QString backgroundKey = buildBackgroundPixmapKey(activeRouteLeg, passedRouteLeg);
+  if(backgroundPixmap.isNull() || backgroundPixmap.size() != size() || backgroundKey != backgroundPixmapKey)
+  {
+    backgroundPixmap = QPixmap(size());
+    backgroundPixmap.fill(Qt::transparent);
+
+    QPainter backgroundPainter(&backgroundPixmap);
+    paintBackground(backgroundPainter, route, activeRouteLeg, passedRouteLeg);
+    backgroundPixmapKey = backgroundKey;
+  }
+  painter.drawPixmap(0, 0, backgroundPixmap);
+
+  // Apply the same font scaling chain as the background painting for the aircraft label
+  mapcolors::scaleFont(&painter, 0.9f);
+  if(NavApp::getMapWidget()->getShownMapFeaturesDisplay().testFlag(map::FLIGHTPLAN))
+    mapcolors::scaleFont(&painter, optData.getDisplayTextSizeFlightplan() / 100.f, &painter.font());
 
   // Draw user aircraft track =========================================================
   if(!aircraftTrackPoints.isEmpty() && showAircraftTrack)
@@ -1273,10 +1334,13 @@ void ProfileWidget::updateTimeout()
   // Need a copy of the leg list before starting thread to avoid synchronization problems
   // Start the computation in background
   ElevationLegList legs;
-  legs.route = routeController->getRoute();
 
-  // Start thread
-  future = QtConcurrent::run(this, &ProfileWidget::fetchRouteElevationsThread, legs);
+  // Use the published snapshot which shares its data with the painters instead of
+  // copying the live route
+  legs.route = *routeController->getRouteSnapshot();
+
+  // Start thread - pass the last result to allow reusing elevation samples of unchanged legs
+  future = QtConcurrent::run(this, &ProfileWidget::fetchRouteElevationsThread, legs, legList);
 
   // Watcher will call updateThreadFinished when finished
   watcher.setFuture(future);
@@ -1351,11 +1415,62 @@ bool ProfileWidget::fetchRouteElevations(atools::geo::LineString& elevations,
   return true;
 }
 
+void ProfileWidget::simplifyElevations(atools::geo::LineString& elevations) const
+{
+  if(elevations.size() <= 2)
+    return;
+
+  LineString result;
+  result.append(elevations.first());
+
+  // Collect stretches of points that stay within the altitude corridor and replace each
+  // stretch by its lowest and highest point. On slopes the corridor breaks about every
+  // corridor height which samples them proportionally to the terrain change.
+  int i = 1;
+  while(i < elevations.size() - 1)
+  {
+    float minAlt = elevations.at(i).getAltitude(), maxAlt = minAlt;
+    int minIndex = i, maxIndex = i;
+
+    int j = i + 1;
+    while(j < elevations.size() - 1)
+    {
+      float alt = elevations.at(j).getAltitude();
+      if(std::max(maxAlt, alt) - std::min(minAlt, alt) > ELEVATION_SIMPLIFY_CORRIDOR_METER)
+        break;
+
+      if(alt < minAlt)
+      {
+        minAlt = alt;
+        minIndex = j;
+      }
+      if(alt > maxAlt)
+      {
+        maxAlt = alt;
+        maxIndex = j;
+      }
+      j++;
+    }
+
+    // Keep the extremes of the stretch in order of occurrence
+    result.append(elevations.at(std::min(minIndex, maxIndex)));
+    if(maxIndex != minIndex)
+      result.append(elevations.at(std::max(minIndex, maxIndex)));
+
+    i = j;
+  }
+
+  result.append(elevations.last());
+  elevations = result;
+}
+
 /* Background thread. Fetches elevation points from Marble elevation model and updates totals. */
-ProfileWidget::ElevationLegList ProfileWidget::fetchRouteElevationsThread(ElevationLegList legs) const
+ProfileWidget::ElevationLegList ProfileWidget::fetchRouteElevationsThread(ElevationLegList legs,
+                                                                         ElevationLegList previousLegs) const
 {
   QThread::currentThread()->setPriority(QThread::LowestPriority);
   // qDebug() << "priority" << QThread::currentThread()->priority();
+  perftrace::Span span("elevation profile fetch");
 
   using atools::geo::meterToNm;
   using atools::geo::meterToFeet;
@@ -1369,6 +1484,11 @@ ProfileWidget::ElevationLegList ProfileWidget::fetchRouteElevationsThread(Elevat
     // Return empty result
     return ElevationLegList();
 
+  // Samples of unchanged legs can only be reused with the static offline data since
+  // the online elevation model refines results between runs
+  bool reuseUnchanged = NavApp::getElevationProvider()->isGlobeOfflineProvider();
+  int numLegsReused = 0;
+
   // Loop over all route legs
   for(int i = 1; i <= legs.route.getDestinationLegIndex(); i++)
   {
@@ -1381,6 +1501,34 @@ ProfileWidget::ElevationLegList ProfileWidget::fetchRouteElevationsThread(Elevat
       break;
 
     const RouteLeg& lastLeg = legs.route.value(i - 1);
+
+    // Reuse the elevation samples of an unchanged leg and shift only the distances to
+    // the new leg start - avoids re-sampling the whole route after single leg edits
+    if(reuseUnchanged && i < previousLegs.route.size() && i - 1 < previousLegs.elevationLegs.size())
+    {
+      const RouteLeg& prevRouteLeg = previousLegs.route.value(i);
+      const RouteLeg& prevLastLeg = previousLegs.route.value(i - 1);
+      const ElevationLeg& prevLeg = previousLegs.elevationLegs.at(i - 1);
+
+      if(prevLeg.elevation.size() >= 2 && !prevLeg.distances.isEmpty() &&
+         routeLeg.getPosition() == prevRouteLeg.getPosition() &&
+         lastLeg.getPosition() == prevLastLeg.getPosition() &&
+         routeLeg.getGeometry() == prevRouteLeg.getGeometry())
+      {
+        ElevationLeg reusedLeg(prevLeg);
+        float shift = legs.totalDistance - prevLeg.distances.first();
+        for(float& distance : reusedLeg.distances)
+          distance += shift;
+
+        legs.maxElevationFt = std::max(legs.maxElevationFt, reusedLeg.maxElevation);
+        legs.totalNumPoints += reusedLeg.elevation.size() - 1;
+        legs.totalDistance += routeLeg.getDistanceTo();
+        legs.elevationLegs.append(reusedLeg);
+        numLegsReused++;
+        continue;
+      }
+    }
+
     ElevationLeg leg;
 
     // Skip for too long segments when using the marble online provider
@@ -1398,6 +1546,10 @@ ProfileWidget::ElevationLegList ProfileWidget::fetchRouteElevationsThread(Elevat
       if(!fetchRouteElevations(elevations, geometry))
         return ElevationLegList();
 
+      if(simplifyProfile)
+        // Thin out before the expensive per-point distance loop below
+        simplifyElevations(elevations);
+
       float dist = legs.totalDistance;
       // Loop over all elevation points for the current leg
       Pos lastPos;
@@ -1445,6 +1597,12 @@ ProfileWidget::ElevationLegList ProfileWidget::fetchRouteElevationsThread(Elevat
     legs.elevationLegs.append(leg);
   }
 
+#ifdef DEBUG_INFORMATION
+  qDebug() << Q_FUNC_INFO << "reused" << numLegsReused << "of" << legs.elevationLegs.size() << "legs";
+#else
+  Q_UNUSED(numLegsReused)
+#endif
+
   return legs;
 }
 
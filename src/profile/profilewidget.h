@@ -22,6 +22,7 @@
 #include "fs/sc/simconnectdata.h"
 
 #include <QFutureWatcher>
+#include <QPixmap>
 #include <QWidget>
 
 namespace atools {
@@ -187,7 +188,12 @@ private:
   virtual void contextMenuEvent(QContextMenuEvent *event) override;
 
   bool fetchRouteElevations(atools::geo::LineString& elevations, const atools::geo::LineString& geometry) const;
-  ElevationLegList fetchRouteElevationsThread(ElevationLegList legs) const;
+
+  /* Thin out fetched elevation samples adaptively. Level stretches like oceans collapse to a
+   * few points while rough terrain keeps the full resolution. The lowest and highest point of
+   * every dropped stretch are kept so maxima stay exact. */
+  void simplifyElevations(atools::geo::LineString& elevations) const;
+  ElevationLegList fetchRouteElevationsThread(ElevationLegList legs, ElevationLegList previousLegs) const;
   void elevationUpdateAvailable();
   void updateTimeout();
   void updateThreadFinished();
@@ -219,6 +225,14 @@ private:
   void paintIls(QPainter& painter, const Route& route);
   void paintVasi(QPainter& painter, const Route& route);
 
+  /* Paint the static part of the profile into the background pixmap: terrain, scale lines,
+   * flight plan legs, symbols and labels. Aircraft and trail are drawn on top in paintEvent. */
+  void paintBackground(QPainter& painter, const Route& route, int activeRouteLeg, int passedRouteLeg);
+
+  /* Key for all display settings affecting the background pixmap which do not invalidate it
+   * through updateScreenCoords() */
+  QString buildBackgroundPixmapKey(int activeRouteLeg, int passedRouteLeg) const;
+
   void jumpBackToAircraftStart();
   void jumpBackToAircraftTimeout();
 
@@ -249,6 +263,10 @@ private:
   /* Do not calculate a profile for legs longer than this value */
   static Q_DECL_CONSTEXPR int ELEVATION_MAX_LEG_NM = 2000;
 
+  /* Drop elevation samples that stay within this altitude corridor. Well below one vertical
+   * pixel at typical window sizes and altitudes. */
+  static Q_DECL_CONSTEXPR float ELEVATION_SIMPLIFY_CORRIDOR_METER = 10.f;
+
   /* User aircraft data */
   atools::fs::sc::SimConnectData simData, lastSimData;
 
@@ -273,6 +291,9 @@ private:
   QFutureWatcher<ElevationLegList> watcher;
   bool terminateThreadSignal = false;
 
+  /* Thin out elevation samples in the update thread. Read once from settings. */
+  bool simplifyProfile = true;
+
   bool databaseLoadStatus = false;
 
   QRubberBand *rubberBand = nullptr;
@@ -296,6 +317,11 @@ private:
   float verticalScale = 1.f /* Factor to convert altitude in feet to screen coordinates*/,
         horizontalScale = 1.f /* Factor to convert distance along flight plan in nautical miles to screen coordinates*/;
 
+  /* Pre-rendered static background so aircraft updates do not repaint terrain, legs and labels.
+   * Invalidated by updateScreenCoords() and by key changes like a new active leg. */
+  QPixmap backgroundPixmap;
+  QString backgroundPixmapKey;
+
   /* Numbers for aircraft track */
   static Q_DECL_CONSTEXPR quint32 FILE_MAGIC_NUMBER = 0x6B7C2A3C;
   static Q_DECL_CONSTEXPR quint16 FILE_VERSION = 1;
@@ -69,15 +69,16 @@ AirportQuery::AirportQuery(atools::sql::SqlDatabase *sqlDb, bool nav)
   mapTypesFactory = new MapTypesFactory();
   atools::settings::Settings& settings = atools::settings::Settings::instance();
 
-  runwayCache.setMaxCost(settings.getAndStoreValue(lnm::SETTINGS_MAPQUERY + "RunwayCache", 2000).toInt());
-  apronCache.setMaxCost(settings.getAndStoreValue(lnm::SETTINGS_MAPQUERY + "ApronCache", 1000).toInt());
-  taxipathCache.setMaxCost(settings.getAndStoreValue(lnm::SETTINGS_MAPQUERY + "TaxipathCache", 1000).toInt());
-  parkingCache.setMaxCost(settings.getAndStoreValue(lnm::SETTINGS_MAPQUERY + "ParkingCache", 1000).toInt());
-  startCache.setMaxCost(settings.getAndStoreValue(lnm::SETTINGS_MAPQUERY + "StartCache", 1000).toInt());
-  helipadCache.setMaxCost(settings.getAndStoreValue(lnm::SETTINGS_MAPQUERY + "HelipadCache", 1000).toInt());
-  airportIdCache.setMaxCost(settings.getAndStoreValue(lnm::SETTINGS_MAPQUERY + "AirportIdCache", 1000).toInt());
-  airportIdentCache.setMaxCost(settings.getAndStoreValue(lnm::SETTINGS_MAPQUERY + "AirportIdentCache", 1000).toInt());
-  airportIcaoCache.setMaxCost(settings.getAndStoreValue(lnm::SETTINGS_MAPQUERY + "AirportIcaoCache", 1000).toInt());
+  runwayCache.setMaxCost(query::cacheSize(settings, lnm::SETTINGS_MAPQUERY + "RunwayCache", 2000));
+  apronCache.setMaxCost(query::cacheSize(settings, lnm::SETTINGS_MAPQUERY + "ApronCache", 1000));
+  taxipathCache.setMaxCost(query::cacheSize(settings, lnm::SETTINGS_MAPQUERY + "TaxipathCache", 1000));
+  parkingCache.setMaxCost(query::cacheSize(settings, lnm::SETTINGS_MAPQUERY + "ParkingCache", 1000));
+  startCache.setMaxCost(query::cacheSize(settings, lnm::SETTINGS_MAPQUERY + "StartCache", 1000));
+  helipadCache.setMaxCost(query::cacheSize(settings, lnm::SETTINGS_MAPQUERY + "HelipadCache", 1000));
+  airportIdCache.setMaxCost(query::cacheSize(settings, lnm::SETTINGS_MAPQUERY + "AirportIdCache", 1000));
+  airportIdentCache.setMaxCost(query::cacheSize(settings, lnm::SETTINGS_MAPQUERY + "AirportIdentCache", 1000));
+  airportIcaoCache.setMaxCost(query::cacheSize(settings, lnm::SETTINGS_MAPQUERY + "AirportIcaoCache", 1000));
+  airportFuzzyCache.setMaxCost(query::cacheSize(settings, lnm::SETTINGS_MAPQUERY + "AirportFuzzyCache", 1000));
 }
 
 AirportQuery::~AirportQuery()
@@ -88,6 +89,8 @@ AirportQuery::~AirportQuery()
 
 void AirportQuery::getAirportAdminNamesById(int airportId, QString& city, QString& state, QString& country)
 {
+  ensureQueries();
+
   airportAdminByIdQuery->bindValue(":id", airportId);
   airportAdminByIdQuery->exec();
   if(airportAdminByIdQuery->next())
@@ -108,6 +111,8 @@ map::MapAirport AirportQuery::getAirportById(int airportId)
 
 void AirportQuery::getAirportById(map::MapAirport& airport, int airportId)
 {
+  ensureQueries();
+
   map::MapAirport *ap = airportIdCache.object(airportId);
 
   if(ap != nullptr)
@@ -137,6 +142,8 @@ map::MapAirport AirportQuery::getAirportByIdent(const QString& ident)
 
 void AirportQuery::getAirportByIdent(map::MapAirport& airport, const QString& ident)
 {
+  ensureQueries();
+
   map::MapAirport *ap = airportIdentCache.object(ident);
 
   if(ap != nullptr)
@@ -166,6 +173,8 @@ map::MapAirport AirportQuery::getAirportByIcao(const QString& icao)
 
 void AirportQuery::getAirportByIcao(map::MapAirport& airport, const QString& icao)
 {
+  ensureQueries();
+
   if(airportByIcaoQuery != nullptr)
   {
     map::MapAirport *ap = airportIcaoCache.object(icao);
@@ -192,6 +201,18 @@ void AirportQuery::getAirportByIcao(map::MapAirport& airport, const QString& ica
 void AirportQuery::getAirportFuzzy(map::MapAirport& airport, const QString& ident, const QString& icao,
                                    const atools::geo::Pos& pos)
 {
+  ensureQueries();
+
+  // Check if this airport was already resolved to avoid repeating the fallback chain below.
+  // Mixed navdata/simulator setups resolve the same airports over and over again.
+  QString fuzzyKey = ident + "|" + icao;
+  map::MapAirport *cachedAirport = airportFuzzyCache.object(fuzzyKey);
+  if(cachedAirport != nullptr)
+  {
+    airport = *cachedAirport;
+    return;
+  }
+
   // airportFrom has to be copied to avoid overwriting
   // Try ident first
   getAirportByIdent(airport, ident);
@@ -202,29 +223,35 @@ void AirportQuery::getAirportFuzzy(map::MapAirport& airport, const QString& iden
 
   if(!airport.isValid() && pos.isValid())
   {
-    // Fall back to coordinate based search and look for centers withing 0.2 NM
-    ageo::Rect rect(pos, ageo::nmToMeter(10.f));
-    QList<map::MapAirport> airports;
-
-    bool xplane = NavApp::getCurrentSimulatorDb() == atools::fs::FsPaths::XPLANE11;
-    query::fetchObjectsForRect(rect, airportByPosQuery, [ =, &airports](atools::sql::SqlQuery *query) -> void {
-      map::MapAirport obj;
-      mapTypesFactory->fillAirport(query->record(), obj, true, navdata, xplane);
+    if(!airportCoordIndex.isValid())
+      loadAirportCoordIndex();
 
-      if(obj.position.distanceMeterTo(pos) < atools::geo::nmToMeter(0.2f))
-        airports.append(obj);
+    // Fall back to coordinate based search and look for centers withing 0.2 NM
+    QList<AirportCoordinate> coordinates;
+    airportCoordIndex.query(ageo::Rect(pos, ageo::nmToMeter(10.f)), coordinates, queryRowLimit,
+                            [&pos](const AirportCoordinate& coordinate) -> bool {
+      return coordinate.position.distanceMeterTo(pos) < ageo::nmToMeter(0.2f);
     });
 
+    QList<map::MapAirport> airports;
+    for(const AirportCoordinate& coordinate : coordinates)
+      airports.append(getAirportById(coordinate.id));
+
     if(!airports.isEmpty())
     {
       maptools::sortByDistance(airports, pos);
       airport = airports.first();
     }
   }
+
+  // Also remember invalid airports to avoid repeating the expensive lookup
+  airportFuzzyCache.insert(fuzzyKey, new map::MapAirport(airport));
 }
 
 atools::geo::Pos AirportQuery::getAirportPosByIdent(const QString& ident)
 {
+  ensureQueries();
+
   ageo::Pos pos;
   airportCoordsByIdentQuery->bindValue(":ident", ident);
   airportCoordsByIdentQuery->exec();
@@ -235,18 +262,24 @@ atools::geo::Pos AirportQuery::getAirportPosByIdent(const QString& ident)
   return pos;
 }
 
-bool AirportQuery::hasProcedures(const QString& ident) const
+bool AirportQuery::hasProcedures(const QString& ident)
 {
+  ensureQueries();
+
   return hasQueryByAirportIdent(*airportProcByIdentQuery, ident);
 }
 
-bool AirportQuery::hasAnyArrivalProcedures(const QString& ident) const
+bool AirportQuery::hasAnyArrivalProcedures(const QString& ident)
 {
+  ensureQueries();
+
   return hasQueryByAirportIdent(*procArrivalByAirportIdentQuery, ident);
 }
 
-bool AirportQuery::hasDepartureProcedures(const QString& ident) const
+bool AirportQuery::hasDepartureProcedures(const QString& ident)
 {
+  ensureQueries();
+
   return hasQueryByAirportIdent(*procDepartureByAirportIdentQuery, ident);
 }
 
@@ -284,6 +317,8 @@ void AirportQuery::getAirportRegion(map::MapAirport& airport)
 
 map::MapRunwayEnd AirportQuery::getRunwayEndById(int id)
 {
+  ensureQueries();
+
   map::MapRunwayEnd end;
   runwayEndByIdQuery->bindValue(":id", id);
   runwayEndByIdQuery->exec();
@@ -307,6 +342,8 @@ void AirportQuery::getRunwayEndByNames(map::MapResult& result, const QString& ru
 void AirportQuery::runwayEndByNames(map::MapResult& result, const QString& runwayName,
                                     const QString& airportIdent)
 {
+  ensureQueries();
+
   QString rname(runwayName);
   if(rname.startsWith("RW"))
     rname.remove(0, 2);
@@ -324,6 +361,8 @@ void AirportQuery::runwayEndByNames(map::MapResult& result, const QString& runwa
 
 const QList<map::MapApron> *AirportQuery::getAprons(int airportId)
 {
+  ensureQueries();
+
   if(apronCache.contains(airportId))
     return apronCache.object(airportId);
   else
@@ -386,6 +425,8 @@ const QList<map::MapApron> *AirportQuery::getAprons(int airportId)
 
 const QList<map::MapParking> *AirportQuery::getParkingsForAirport(int airportId)
 {
+  ensureQueries();
+
   if(parkingCache.contains(airportId))
     return parkingCache.object(airportId);
   else
@@ -409,6 +450,8 @@ const QList<map::MapParking> *AirportQuery::getParkingsForAirport(int airportId)
 
 const QList<map::MapStart> *AirportQuery::getStartPositionsForAirport(int airportId)
 {
+  ensureQueries();
+
   if(startCache.contains(airportId))
     return startCache.object(airportId);
   else
@@ -547,6 +590,8 @@ void AirportQuery::startByNameAndPos(map::MapStart& start, int airportId,
 
 void AirportQuery::getStartById(map::MapStart& start, int startId)
 {
+  ensureQueries();
+
   startByIdQuery->bindValue(":id", startId);
   startByIdQuery->exec();
 
@@ -558,6 +603,8 @@ void AirportQuery::getStartById(map::MapStart& start, int startId)
 void AirportQuery::getParkingByNameAndNumber(QList<map::MapParking>& parkings, int airportId,
                                              const QString& name, int number)
 {
+  ensureQueries();
+
   parkingTypeAndNumberQuery->bindValue(":airportId", airportId);
   if(name.isEmpty())
     // Use "like "%" if name is empty
@@ -578,6 +625,8 @@ void AirportQuery::getParkingByNameAndNumber(QList<map::MapParking>& parkings, i
 void AirportQuery::getParkingByName(QList<map::MapParking>& parkings, int airportId, const QString& name,
                                     const ageo::Pos& sortByDistancePos)
 {
+  ensureQueries();
+
   parkingNameQuery->bindValue(":airportId", airportId);
   if(name.isEmpty())
     // Use "like "%" if name is empty
@@ -597,6 +646,8 @@ void AirportQuery::getParkingByName(QList<map::MapParking>& parkings, int airpor
 
 const QList<map::MapHelipad> *AirportQuery::getHelipads(int airportId)
 {
+  ensureQueries();
+
   if(helipadCache.contains(airportId))
     return helipadCache.object(airportId);
   else
@@ -626,23 +677,31 @@ map::MapResultIndex *AirportQuery::getNearestAirportsProc(const map::MapAirport&
 
 map::MapResultIndex *AirportQuery::nearestAirportsProcInternal(const map::MapAirport& airport, float distanceNm)
 {
+  ensureQueries();
+
   NearestCacheKeyAirport key = {airport.position, distanceNm};
 
   map::MapResultIndex *result = nearestAirportCache.object(key);
 
   if(result == nullptr)
   {
+    if(!airportCoordIndex.isValid())
+      loadAirportCoordIndex();
+
+    // Collect all airports with procedures in a rectangle that roughly covers the requested region
+    QList<AirportCoordinate> coordinates;
+    airportCoordIndex.query(ageo::Rect(airport.position, ageo::nmToMeter(distanceNm)), coordinates, queryRowLimit,
+                            [](const AirportCoordinate& coordinate) -> bool {
+      return coordinate.proc;
+    });
+
     map::MapResult res;
-    // Create a rectangle that roughly covers the requested region
-    ageo::Rect rect(airport.position, ageo::nmToMeter(distanceNm));
-
-    bool xplane = NavApp::getCurrentSimulatorDb() == atools::fs::FsPaths::XPLANE11;
-    query::fetchObjectsForRect(rect, airportByRectAndProcQuery, [ =, &res](atools::sql::SqlQuery *query) -> void {
-      map::MapAirport obj;
-      mapTypesFactory->fillAirport(query->record(), obj, true, navdata, xplane);
-      if(obj.ident != airport.ident)
+    for(const AirportCoordinate& coordinate : coordinates)
+    {
+      map::MapAirport obj = getAirportById(coordinate.id);
+      if(obj.isValid() && obj.ident != airport.ident)
         res.airports.append(obj);
-    });
+    }
 
     result = new map::MapResultIndex;
     result->add(res);
@@ -658,6 +717,25 @@ map::MapResultIndex *AirportQuery::nearestAirportsProcInternal(const map::MapAir
   return result;
 }
 
+void AirportQuery::loadAirportCoordIndex()
+{
+  airportCoordIndex.clear();
+
+  SqlQuery query(db);
+  query.exec("select airport_id, num_approach, lonx, laty from airport");
+  while(query.next())
+  {
+    AirportCoordinate coordinate;
+    coordinate.id = query.valueInt("airport_id");
+    coordinate.proc = query.valueInt("num_approach") > 0;
+    coordinate.position = ageo::Pos(query.valueFloat("lonx"), query.valueFloat("laty"));
+    airportCoordIndex.append(coordinate);
+  }
+  airportCoordIndex.finishBuilding();
+
+  qDebug() << Q_FUNC_INFO << airportCoordIndex.size() << "airports";
+}
+
 void AirportQuery::getBestRunwayEndAndAirport(map::MapRunwayEnd& runwayEnd, map::MapAirport& airport,
                                               const QVector<map::MapRunway>& runways, const ageo::Pos& pos,
                                               float heading, float maxRwDistance, float maxHeadingDeviation)
@@ -741,6 +819,8 @@ void AirportQuery::getRunways(QVector<map::MapRunway>& runways, const ageo::Rect
 
 const QList<map::MapTaxiPath> *AirportQuery::getTaxiPaths(int airportId)
 {
+  ensureQueries();
+
   if(taxipathCache.contains(airportId))
     return taxipathCache.object(airportId);
   else
@@ -771,6 +851,8 @@ const QList<map::MapTaxiPath> *AirportQuery::getTaxiPaths(int airportId)
 
 const QList<map::MapRunway> *AirportQuery::getRunways(int airportId)
 {
+  ensureQueries();
+
   if(runwayCache.contains(airportId))
     return runwayCache.object(airportId);
   else
@@ -939,6 +1021,19 @@ QStringList AirportQuery::airportOverviewColumns(const atools::sql::SqlDatabase
 }
 
 void AirportQuery::initQueries()
+{
+  // Delete all statements and invalidate the caches only. The statements are prepared again
+  // by ensureQueries() on first access which keeps database switches fast.
+  deInitQueries();
+}
+
+void AirportQuery::ensureQueries()
+{
+  if(!queriesPrepared)
+    initQueriesInternal();
+}
+
+void AirportQuery::initQueriesInternal()
 {
   // Common where clauses
   static const QString whereRect("lonx between :leftx and :rightx and laty between :bottomy and :topy");
@@ -980,18 +1075,9 @@ void AirportQuery::initQueries()
     airportByIcaoQuery->prepare("select " + airportQueryBase.join(", ") + " from airport where icao = :icao ");
   }
 
-  airportByPosQuery = new SqlQuery(db);
-  airportByPosQuery->prepare("select " + airportQueryBase.join(", ") +
-                             " from airport "
-                             "where " + whereRect + " " + whereLimit);
-
   airportCoordsByIdentQuery = new SqlQuery(db);
   airportCoordsByIdentQuery->prepare("select lonx, laty from airport where ident = :ident ");
 
-  airportByRectAndProcQuery = new SqlQuery(db);
-  airportByRectAndProcQuery->prepare("select " + airportQueryBase.join(", ") + " from airport where " + whereRect +
-                                     " and num_approach > 0 " + whereLimit);
-
   runwayEndByIdQuery = new SqlQuery(db);
   runwayEndByIdQuery->prepare("select runway_end_id, end_type, name, heading, left_vasi_pitch, right_vasi_pitch, is_pattern, "
                               "left_vasi_type, right_vasi_type, "
@@ -1070,10 +1156,14 @@ void AirportQuery::initQueries()
     "join runway_end p on r.primary_end_id = p.runway_end_id "
     "join runway_end s on r.secondary_end_id = s.runway_end_id "
     "where r.airport_id = :airportId");
+
+  queriesPrepared = true;
 }
 
 void AirportQuery::deInitQueries()
 {
+  queriesPrepared = false;
+
   runwayCache.clear();
   apronCache.clear();
   taxipathCache.clear();
@@ -1081,7 +1171,10 @@ void AirportQuery::deInitQueries()
   startCache.clear();
   helipadCache.clear();
   airportIdentCache.clear();
+  airportIcaoCache.clear();
+  airportFuzzyCache.clear();
   airportIdCache.clear();
+  airportCoordIndex.clear();
 
   delete runwayOverviewQuery;
   runwayOverviewQuery = nullptr;
@@ -1133,15 +1226,9 @@ void AirportQuery::deInitQueries()
   delete airportByIcaoQuery;
   airportByIcaoQuery = nullptr;
 
-  delete airportByPosQuery;
-  airportByPosQuery = nullptr;
-
   delete airportCoordsByIdentQuery;
   airportCoordsByIdentQuery = nullptr;
 
-  delete airportByRectAndProcQuery;
-  airportByRectAndProcQuery = nullptr;
-
   delete runwayEndByIdQuery;
   runwayEndByIdQuery = nullptr;
 
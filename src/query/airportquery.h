@@ -18,6 +18,8 @@
 #ifndef LITTLENAVMAP_AIRPORTQUERY_H
 #define LITTLENAVMAP_AIRPORTQUERY_H
 
+#include "query/spatialindex.h"
+
 #include <QCache>
 
 namespace Marble {
@@ -89,13 +91,13 @@ public:
 
   atools::geo::Pos getAirportPosByIdent(const QString& ident);
 
-  bool hasProcedures(const QString& ident) const;
+  bool hasProcedures(const QString& ident);
 
   /* True if there are STAR or approaches */
-  bool hasAnyArrivalProcedures(const QString& ident) const;
+  bool hasAnyArrivalProcedures(const QString& ident);
 
   /* True if airport has SID */
-  bool hasDepartureProcedures(const QString& ident) const;
+  bool hasDepartureProcedures(const QString& ident);
 
   /* Get the region for airports where it is missing. This uses an expensive query to get the
    * region from the nearest waypoints. Region is set in MapAirport.
@@ -162,10 +164,11 @@ public:
 
   map::MapRunwayEnd getRunwayEndById(int id);
 
-  /* Close all query objects thus disconnecting from the database */
+  /* Invalidate all queries and clear the caches. The statements are prepared lazily on
+   * first use which makes switching between simulator and navdata databases fast. */
   void initQueries();
 
-  /* Create and prepare all queries */
+  /* Close all query objects thus disconnecting from the database */
   void deInitQueries();
 
   QHash<int, QList<map::MapParking> > getParkingCache() const;
@@ -184,6 +187,13 @@ private:
                                               atools::sql::SqlQuery *query, bool reverse,
                                               bool lazy, bool overview);
 
+  /* Create and prepare all queries. Called on first access after construction or a database switch. */
+  void initQueriesInternal();
+  void ensureQueries();
+
+  /* Load all airport coordinates into the index on first use after a database switch */
+  void loadAirportCoordIndex();
+
   bool runwayCompare(const map::MapRunway& r1, const map::MapRunway& r2);
   bool hasQueryByAirportIdent(atools::sql::SqlQuery& query, const QString& ident) const;
   void startByNameAndPos(map::MapStart& start, int airportId, const QString& runwayEndName,
@@ -196,9 +206,28 @@ private:
   /* true if third party navdata */
   bool navdata;
 
+  /* false after construction or a database switch until the statements were prepared */
+  bool queriesPrepared = false;
+
   MapTypesFactory *mapTypesFactory;
   atools::sql::SqlDatabase *db;
 
+  /* Lightweight entry of the coordinate index. Full objects are fetched by id on demand. */
+  struct AirportCoordinate
+  {
+    atools::geo::Pos position;
+    int id;
+    bool proc; /* Airport has procedures */
+
+    const atools::geo::Pos& getPosition() const
+    {
+      return position;
+    }
+  };
+
+  /* In-memory index over all airport coordinates answering the nearest and radius searches */
+  query::SpatialGridIndex<AirportCoordinate> airportCoordIndex;
+
   /* ID/object caches */
   QCache<int, QList<map::MapRunway> > runwayCache;
   QCache<int, QList<map::MapApron> > apronCache;
@@ -208,6 +237,10 @@ private:
   QCache<int, QList<map::MapHelipad> > helipadCache;
 
   QCache<QString, map::MapAirport> airportIdentCache, airportIcaoCache;
+
+  /* Resolved airports from getAirportFuzzy keyed by "ident|icao".
+   * Caches invalid airports too so the whole ident/icao/coordinate fallback chain runs only once */
+  QCache<QString, map::MapAirport> airportFuzzyCache;
   QCache<int, map::MapAirport> airportIdCache;
   QCache<NearestCacheKeyAirport, map::MapResultIndex> nearestAirportCache;
 
@@ -219,8 +252,8 @@ private:
                         *parkingTypeAndNumberQuery = nullptr,
                         *parkingNameQuery = nullptr;
 
-  atools::sql::SqlQuery *airportByIdentQuery = nullptr, *airportByIcaoQuery = nullptr, *airportByPosQuery = nullptr,
-                        *airportCoordsByIdentQuery = nullptr, *airportByRectAndProcQuery = nullptr,
+  atools::sql::SqlQuery *airportByIdentQuery = nullptr, *airportByIcaoQuery = nullptr,
+                        *airportCoordsByIdentQuery = nullptr,
                         *runwayEndByIdQuery = nullptr, *runwayEndByNameQuery = nullptr, *airportByIdQuery = nullptr,
                         *airportAdminByIdQuery = nullptr, *airportProcByIdentQuery = nullptr,
                         *procArrivalByAirportIdentQuery = nullptr, *procDepartureByAirportIdentQuery = nullptr;
@@ -37,18 +37,19 @@ static double queryRectInflationFactor = 0.2;
 static double queryRectInflationIncrement = 0.1;
 int AirspaceQuery::queryMaxRows = 5000;
 
+/* Error tolerances in meter from fine to coarse for the simplified boundary cache */
+const static QVector<float> SIMPLIFY_AIRSPACE_TOLERANCES_METER({100.f, 500.f, 2500.f, 10000.f});
+
 AirspaceQuery::AirspaceQuery(SqlDatabase *sqlDb, map::MapAirspaceSources src)
   : db(sqlDb), source(src)
 {
   mapTypesFactory = new MapTypesFactory();
   atools::settings::Settings& settings = atools::settings::Settings::instance();
 
-  airspaceLineCache.setMaxCost(settings.getAndStoreValue(
-                                 lnm::SETTINGS_MAPQUERY + "AirspaceLineCache", 10000).toInt());
-  onlineCenterGeoCache.setMaxCost(settings.getAndStoreValue(
-                                    lnm::SETTINGS_MAPQUERY + "OnlineCenterGeoCache", 10000).toInt());
-  onlineCenterGeoFileCache.setMaxCost(settings.getAndStoreValue(
-                                        lnm::SETTINGS_MAPQUERY + "OnlineCenterGeoFileCache", 10000).toInt());
+  airspaceLineCache.setMaxCost(query::cacheSize(settings, lnm::SETTINGS_MAPQUERY + "AirspaceLineCache", 10000));
+  onlineCenterGeoCache.setMaxCost(query::cacheSize(settings, lnm::SETTINGS_MAPQUERY + "OnlineCenterGeoCache", 10000));
+  onlineCenterGeoFileCache.setMaxCost(query::cacheSize(settings, lnm::SETTINGS_MAPQUERY + "OnlineCenterGeoFileCache", 10000));
+  airspaceSimpleLineCache.setMaxCost(query::cacheSize(settings, lnm::SETTINGS_MAPQUERY + "AirspaceSimpleLineCache", 10000));
 
   queryRectInflationFactor = settings.getAndStoreValue(
     lnm::SETTINGS_MAPQUERY + "QueryRectInflationFactor", 0.3).toDouble();
@@ -107,6 +108,21 @@ void AirspaceQuery::getAirspaceById(map::MapAirspace& airspace, int airspaceId)
   airspaceByIdQuery->finish();
 }
 
+bool AirspaceQuery::needsUpdate(const GeoDataLatLonBox& rect, const MapLayer *mapLayer,
+                                map::MapAirspaceFilter filter, float flightPlanAltitude) const
+{
+  if(airspaceCache.needsUpdate(rect, mapLayer, queryRectInflationFactor, queryRectInflationIncrement,
+                               [](const MapLayer *curLayer, const MapLayer *newLayer) -> bool
+  {
+    return curLayer->hasSameQueryParametersAirspace(newLayer);
+  }))
+    return true;
+
+  // Filter and altitude changes clear the cache too in getAirspaces()
+  return filter.types != lastAirspaceFilter.types || filter.flags != lastAirspaceFilter.flags ||
+         atools::almostNotEqual(lastFlightplanAltitude, flightPlanAltitude);
+}
+
 const QList<map::MapAirspace> *AirspaceQuery::getAirspaces(const GeoDataLatLonBox& rect, const MapLayer *mapLayer,
                                                            map::MapAirspaceFilter filter, float flightPlanAltitude,
                                                            bool lazy)
@@ -214,7 +230,7 @@ const QList<map::MapAirspace> *AirspaceQuery::getAirspaces(const GeoDataLatLonBo
             }
 
             map::MapAirspace airspace;
-            mapTypesFactory->fillAirspace(query->record(), airspace, source);
+            mapTypesFactory->fillAirspace(*query, airspace, source);
             airspaceCache.list.append(airspace);
 
             ids.insert(airspace.id);
@@ -256,6 +272,52 @@ const LineString *AirspaceQuery::getAirspaceGeometryByName(int airspaceId)
   }
 }
 
+const LineString *AirspaceQuery::getSimplifiedAirspaceGeometry(int airspaceId, float maxErrorMeter)
+{
+  // Use the coarsest tolerance bucket which keeps the error below the given value
+  int bucket = -1;
+  for(int i = SIMPLIFY_AIRSPACE_TOLERANCES_METER.size() - 1; i >= 0; i--)
+  {
+    if(SIMPLIFY_AIRSPACE_TOLERANCES_METER.at(i) <= maxErrorMeter)
+    {
+      bucket = i;
+      break;
+    }
+  }
+
+  if(bucket == -1)
+    // Zoomed in too closely - use the full boundary
+    return getAirspaceGeometryByName(airspaceId);
+
+  QString key = QString::number(airspaceId) + "_" + QString::number(bucket);
+  if(airspaceSimpleLineCache.contains(key))
+    return airspaceSimpleLineCache.object(key);
+  else
+  {
+    float toleranceMeter = SIMPLIFY_AIRSPACE_TOLERANCES_METER.at(bucket);
+    const LineString *full = getAirspaceGeometryByName(airspaceId);
+
+    // Decimate vertices closer to the last kept one than the tolerance - keep first and last
+    LineString *simplified = new LineString;
+    if(full != nullptr && !full->isEmpty())
+    {
+      simplified->append(full->first());
+      for(int i = 1; i < full->size() - 1; i++)
+      {
+        const Pos& pos = full->at(i);
+        if(simplified->last().distanceMeterTo(pos) > toleranceMeter)
+          simplified->append(pos);
+      }
+
+      if(full->size() > 1)
+        simplified->append(full->last());
+    }
+    airspaceSimpleLineCache.insert(key, simplified);
+
+    return simplified;
+  }
+}
+
 LineString *AirspaceQuery::getAirspaceGeometryByFile(QString callsign)
 {
   if(airspaceGeoByFileQuery != nullptr)
@@ -496,6 +558,7 @@ void AirspaceQuery::clearCache()
   airspaceLineCache.clear();
   onlineCenterGeoCache.clear();
   onlineCenterGeoFileCache.clear();
+  airspaceSimpleLineCache.clear();
 
   updateAirspaceStatus();
 }
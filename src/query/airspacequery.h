@@ -64,8 +64,19 @@ public:
   /* Get airspaces for map display */
   const QList<map::MapAirspace> *getAirspaces(const Marble::GeoDataLatLonBox& rect, const MapLayer *mapLayer,
                                               map::MapAirspaceFilter filter, float flightPlanAltitude, bool lazy);
+
+  /* True if a non-lazy getAirspaces() call with the same parameters would have to run the
+   * database queries again. Does not modify any caches. */
+  bool needsUpdate(const Marble::GeoDataLatLonBox& rect, const MapLayer *mapLayer,
+                   map::MapAirspaceFilter filter, float flightPlanAltitude) const;
   const atools::geo::LineString *getAirspaceGeometryByName(int airspaceId);
 
+  /* Get a vertex decimated boundary where the error stays below maxErrorMeter. Simplified on
+   * first access per tolerance bucket and cached by airspace id afterwards so zoomed out views
+   * draw far fewer vertices. Falls back to the full geometry if the requested error is smaller
+   * than the finest tolerance. */
+  const atools::geo::LineString *getSimplifiedAirspaceGeometry(int airspaceId, float maxErrorMeter);
+
   /* Query raw geometry blob by online callsign (name) and facility type */
   atools::geo::LineString *getAirspaceGeometryByName(const QString& callsign, const QString& facilityType);
 
@@ -102,6 +113,9 @@ private:
   QCache<int, atools::geo::LineString> airspaceLineCache;
   QCache<QString, atools::geo::LineString> onlineCenterGeoCache, onlineCenterGeoFileCache;
 
+  /* Simplified boundaries keyed by airspace id and tolerance bucket */
+  QCache<QString, atools::geo::LineString> airspaceSimpleLineCache;
+
   static int queryMaxRows;
 
   /* True if tables atc or boundary have content. Updated in clearCache and initQueries */
@@ -54,6 +54,8 @@ AirwayQuery::~AirwayQuery()
 
 void AirwayQuery::getAirwaysForWaypoint(QList<map::MapAirway>& airways, int waypointId)
 {
+  ensureQueries();
+
   airwayByWaypointIdQuery->bindValue(":id", waypointId);
   airwayByWaypointIdQuery->exec();
   while(airwayByWaypointIdQuery->next())
@@ -81,6 +83,8 @@ void AirwayQuery::getAirwaysForWaypoints(QList<map::MapAirway>& airways, int way
 void AirwayQuery::getWaypointsForAirway(QList<map::MapWaypoint>& waypoints, const QString& airwayName,
                                         const QString& waypointIdent)
 {
+  ensureQueries();
+
   airwayWaypointByIdentQuery->bindValue(":waypoint", waypointIdent.isEmpty() ? "%" : waypointIdent);
   airwayWaypointByIdentQuery->bindValue(":airway", airwayName.isEmpty() ? "%" : airwayName);
   airwayWaypointByIdentQuery->exec();
@@ -95,6 +99,8 @@ void AirwayQuery::getWaypointsForAirway(QList<map::MapWaypoint>& waypoints, cons
 void AirwayQuery::getWaypointListForAirwayName(QList<map::MapAirwayWaypoint>& waypoints, const QString& airwayName,
                                                int airwayFragment)
 {
+  ensureQueries();
+
   airwayWaypointsQuery->bindValue(":name", airwayName);
   airwayWaypointsQuery->exec();
 
@@ -137,6 +143,8 @@ void AirwayQuery::getWaypointListForAirwayName(QList<map::MapAirwayWaypoint>& wa
 
 map::MapWaypoint AirwayQuery::waypointById(int id)
 {
+  ensureQueries();
+
   map::MapWaypoint wp;
   waypointByIdQuery->bindValue(":id", id);
   waypointByIdQuery->exec();
@@ -149,6 +157,8 @@ map::MapWaypoint AirwayQuery::waypointById(int id)
 void AirwayQuery::getAirwayFull(QList<map::MapAirway>& airways, atools::geo::Rect& bounding, const QString& airwayName,
                                 int fragment)
 {
+  ensureQueries();
+
   airwayFullQuery->bindValue(":name", airwayName);
   airwayFullQuery->bindValue(":fragment", fragment);
   airwayFullQuery->exec();
@@ -170,6 +180,8 @@ map::MapAirway AirwayQuery::getAirwayById(int airwayId)
 
 void AirwayQuery::getAirwayById(map::MapAirway& airway, int airwayId)
 {
+  ensureQueries();
+
   airwayByIdQuery->bindValue(":id", airwayId);
   airwayByIdQuery->exec();
   if(airwayByIdQuery->next())
@@ -180,6 +192,8 @@ void AirwayQuery::getAirwayById(map::MapAirway& airway, int airwayId)
 
 void AirwayQuery::getAirwaysByName(QList<map::MapAirway>& airways, const QString& name)
 {
+  ensureQueries();
+
   airwayByNameQuery->bindValue(":name", name);
   airwayByNameQuery->exec();
   while(airwayByNameQuery->next())
@@ -193,6 +207,8 @@ void AirwayQuery::getAirwaysByName(QList<map::MapAirway>& airways, const QString
 void AirwayQuery::getAirwaysByNameAndWaypoint(QList<map::MapAirway>& airways, const QString& airwayName,
                                               const QString& waypoint1, const QString& waypoint2)
 {
+  ensureQueries();
+
   if(airwayName.isEmpty() || waypoint1.isEmpty())
     return;
 
@@ -226,6 +242,8 @@ void AirwayQuery::getAirwaysByNameAndWaypoint(QList<map::MapAirway>& airways, co
 
 const QList<map::MapAirway> *AirwayQuery::getAirways(const GeoDataLatLonBox& rect, const MapLayer *mapLayer, bool lazy)
 {
+  ensureQueries();
+
   airwayCache.updateCache(rect, mapLayer, queryRectInflationFactor, queryRectInflationIncrement, lazy,
                           [](const MapLayer *curLayer, const MapLayer *newLayer) -> bool
   {
@@ -257,6 +275,19 @@ const QList<map::MapAirway> *AirwayQuery::getAirways(const GeoDataLatLonBox& rec
 }
 
 void AirwayQuery::initQueries()
+{
+  // Delete all statements and invalidate the caches only. The statements are prepared again
+  // by ensureQueries() on first access which keeps database switches fast.
+  deInitQueries();
+}
+
+void AirwayQuery::ensureQueries()
+{
+  if(!queriesPrepared)
+    initQueriesInternal();
+}
+
+void AirwayQuery::initQueriesInternal()
 {
   airwayTable = trackDatabase ? "track" : "airway";
   airwayIdCol = trackDatabase ? "track_id" : "airway_id";
@@ -345,10 +376,14 @@ void AirwayQuery::initQueries()
   airwayFullQuery->prepare("select " + queryBase +
                            " from " + airwayTable +
                            " where " + prefix + "fragment_no = :fragment and " + airwayNameCol + " = :name");
+
+  queriesPrepared = true;
 }
 
 void AirwayQuery::deInitQueries()
 {
+  queriesPrepared = false;
+
   clearCache();
 
   delete airwayByRectQuery;
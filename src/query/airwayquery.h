@@ -91,15 +91,20 @@ public:
    * if they have to be kept between event loop calls. */
   const QList<map::MapAirway> *getAirways(const Marble::GeoDataLatLonBox& rect, const MapLayer *mapLayer, bool lazy);
 
-  /* Close all query objects thus disconnecting from the database */
+  /* Invalidate all queries and clear the caches. The statements are prepared lazily on
+   * first use which makes switching between simulator and navdata databases fast. */
   void initQueries();
 
-  /* Create and prepare all queries */
+  /* Close all query objects thus disconnecting from the database */
   void deInitQueries();
 
   void clearCache();
 
 private:
+  /* Create and prepare all queries. Called on first access after construction or a database switch. */
+  void initQueriesInternal();
+  void ensureQueries();
+
   map::MapWaypoint waypointById(int id);
 
   MapTypesFactory *mapTypesFactory;
@@ -119,6 +124,9 @@ private:
 
   static int queryMaxRows;
 
+  /* false after construction or a database switch until the statements were prepared */
+  bool queriesPrepared = false;
+
   /* Database queries */
   atools::sql::SqlQuery *airwayByRectQuery = nullptr;
 
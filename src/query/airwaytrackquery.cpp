@@ -153,6 +153,24 @@ void AirwayTrackQuery::getTracks(QList<map::MapAirway>& airways, const GeoDataLa
   }
 }
 
+const QList<map::MapAirway> *AirwayTrackQuery::getAirways(const GeoDataLatLonBox& rect, const MapLayer *mapLayer,
+                                                          bool lazy)
+{
+  if(mapLayer->isAirway())
+    return airwayQuery->getAirways(rect, mapLayer, lazy);
+
+  return nullptr;
+}
+
+const QList<map::MapAirway> *AirwayTrackQuery::getTracks(const GeoDataLatLonBox& rect, const MapLayer *mapLayer,
+                                                         bool lazy)
+{
+  if(useTracks && mapLayer->isTrack())
+    return trackQuery->getAirways(rect, mapLayer, lazy);
+
+  return nullptr;
+}
+
 void AirwayTrackQuery::initQueries()
 {
   trackQuery->initQueries();
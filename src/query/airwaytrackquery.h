@@ -103,6 +103,11 @@ public:
   void getTracks(QList<map::MapAirway>& airways, const Marble::GeoDataLatLonBox& rect, const MapLayer *mapLayer,
                  bool lazy);
 
+  /* Same as above but returns a pointer to the cached list to avoid copying for painting.
+   * Null if the layer does not show airways or tracks. */
+  const QList<map::MapAirway> *getAirways(const Marble::GeoDataLatLonBox& rect, const MapLayer *mapLayer, bool lazy);
+  const QList<map::MapAirway> *getTracks(const Marble::GeoDataLatLonBox& rect, const MapLayer *mapLayer, bool lazy);
+
   /* Close all query objects thus disconnecting from the database */
   void initQueries();
 
@@ -34,21 +34,21 @@ InfoQuery::InfoQuery(SqlDatabase *sqlDb, atools::sql::SqlDatabase *sqlDbNav, ato
   : dbSim(sqlDb), dbNav(sqlDbNav), dbTrack(sqlDbTrack)
 {
   atools::settings::Settings& settings = atools::settings::Settings::instance();
-  airportCache.setMaxCost(settings.getAndStoreValue(lnm::SETTINGS_INFOQUERY + "AirportCache", 100).toInt());
-  vorCache.setMaxCost(settings.getAndStoreValue(lnm::SETTINGS_INFOQUERY + "VorCache", 100).toInt());
-  ndbCache.setMaxCost(settings.getAndStoreValue(lnm::SETTINGS_INFOQUERY + "NdbCache", 100).toInt());
-  runwayEndCache.setMaxCost(settings.getAndStoreValue(lnm::SETTINGS_INFOQUERY + "RunwayEndCache", 100).toInt());
-  ilsCacheSim.setMaxCost(settings.getAndStoreValue(lnm::SETTINGS_INFOQUERY + "IlsCache", 100).toInt());
-  ilsCacheNav.setMaxCost(settings.getAndStoreValue(lnm::SETTINGS_INFOQUERY + "IlsCache", 100).toInt());
-  ilsCacheSimByName.setMaxCost(settings.getAndStoreValue(lnm::SETTINGS_INFOQUERY + "IlsCache", 100).toInt());
-  comCache.setMaxCost(settings.getAndStoreValue(lnm::SETTINGS_INFOQUERY + "ComCache", 100).toInt());
-  runwayCache.setMaxCost(settings.getAndStoreValue(lnm::SETTINGS_INFOQUERY + "RunwayCache", 100).toInt());
-  helipadCache.setMaxCost(settings.getAndStoreValue(lnm::SETTINGS_INFOQUERY + "HelipadCache", 100).toInt());
-  startCache.setMaxCost(settings.getAndStoreValue(lnm::SETTINGS_INFOQUERY + "StartCache", 100).toInt());
-  approachCache.setMaxCost(settings.getAndStoreValue(lnm::SETTINGS_INFOQUERY + "ApproachCache", 100).toInt());
-  transitionCache.setMaxCost(settings.getAndStoreValue(lnm::SETTINGS_INFOQUERY + "TransitionCache", 100).toInt());
-  airportSceneryCache.setMaxCost(settings.getAndStoreValue(lnm::SETTINGS_INFOQUERY + "AirportSceneryCache",
-                                                           100).toInt());
+  airportCache.setMaxCost(query::cacheSize(settings, lnm::SETTINGS_INFOQUERY + "AirportCache", 100));
+  vorCache.setMaxCost(query::cacheSize(settings, lnm::SETTINGS_INFOQUERY + "VorCache", 100));
+  ndbCache.setMaxCost(query::cacheSize(settings, lnm::SETTINGS_INFOQUERY + "NdbCache", 100));
+  runwayEndCache.setMaxCost(query::cacheSize(settings, lnm::SETTINGS_INFOQUERY + "RunwayEndCache", 100));
+  ilsCacheSim.setMaxCost(query::cacheSize(settings, lnm::SETTINGS_INFOQUERY + "IlsCache", 100));
+  ilsCacheNav.setMaxCost(query::cacheSize(settings, lnm::SETTINGS_INFOQUERY + "IlsCache", 100));
+  ilsCacheSimByName.setMaxCost(query::cacheSize(settings, lnm::SETTINGS_INFOQUERY + "IlsCache", 100));
+  comCache.setMaxCost(query::cacheSize(settings, lnm::SETTINGS_INFOQUERY + "ComCache", 100));
+  runwayCache.setMaxCost(query::cacheSize(settings, lnm::SETTINGS_INFOQUERY + "RunwayCache", 100));
+  helipadCache.setMaxCost(query::cacheSize(settings, lnm::SETTINGS_INFOQUERY + "HelipadCache", 100));
+  startCache.setMaxCost(query::cacheSize(settings, lnm::SETTINGS_INFOQUERY + "StartCache", 100));
+  approachCache.setMaxCost(query::cacheSize(settings, lnm::SETTINGS_INFOQUERY + "ApproachCache", 100));
+  transitionCache.setMaxCost(query::cacheSize(settings, lnm::SETTINGS_INFOQUERY + "TransitionCache", 100));
+  transitionAirportCache.setMaxCost(query::cacheSize(settings, lnm::SETTINGS_INFOQUERY + "TransitionAirportCache", 100));
+  airportSceneryCache.setMaxCost(query::cacheSize(settings, lnm::SETTINGS_INFOQUERY + "AirportSceneryCache", 100));
 }
 
 InfoQuery::~InfoQuery()
@@ -58,66 +58,109 @@ InfoQuery::~InfoQuery()
 
 const SqlRecord *InfoQuery::getAirportInformation(int airportId)
 {
+  ensureQueries();
+
   airportQuery->bindValue(":id", airportId);
   return query::cachedRecord(airportCache, airportQuery, airportId);
 }
 
 const atools::sql::SqlRecordVector *InfoQuery::getAirportSceneryInformation(const QString& ident)
 {
+  ensureQueries();
+
   airportSceneryQuery->bindValue(":id", ident);
   return query::cachedRecordVector(airportSceneryCache, airportSceneryQuery, ident);
 }
 
 const SqlRecordVector *InfoQuery::getComInformation(int airportId)
 {
+  ensureQueries();
+
   comQuery->bindValue(":id", airportId);
   return query::cachedRecordVector(comCache, comQuery, airportId);
 }
 
 const SqlRecordVector *InfoQuery::getApproachInformation(int airportId)
 {
+  ensureQueries();
+
   approachQuery->bindValue(":id", airportId);
   return query::cachedRecordVector(approachCache, approachQuery, airportId);
 }
 
 const SqlRecordVector *InfoQuery::getTransitionInformation(int approachId)
 {
+  ensureQueries();
+
   transitionQuery->bindValue(":id", approachId);
   return query::cachedRecordVector(transitionCache, transitionQuery, approachId);
 }
 
+const SqlRecordVector *InfoQuery::getTransitionInformationForAirport(int airportId)
+{
+  ensureQueries();
+
+  transitionAirportQuery->bindValue(":id", airportId);
+  return query::cachedRecordVector(transitionAirportCache, transitionAirportQuery, airportId);
+}
+
 const SqlRecordVector *InfoQuery::getRunwayInformation(int airportId)
 {
+  ensureQueries();
+
+  if(!runwayCache.contains(airportId))
+  {
+    // Load all runway ends of the airport with one query and distribute the records into the
+    // runway end cache. The runway table builder asks for both ends of every runway which
+    // otherwise costs two queries per runway.
+    runwayEndAirportQuery->bindValue(":id", airportId);
+    runwayEndAirportQuery->exec();
+    while(runwayEndAirportQuery->next())
+      runwayEndCache.insert(runwayEndAirportQuery->valueInt("runway_end_id"),
+                            new SqlRecord(runwayEndAirportQuery->record()));
+    runwayEndAirportQuery->finish();
+  }
+
   runwayQuery->bindValue(":id", airportId);
   return query::cachedRecordVector(runwayCache, runwayQuery, airportId);
 }
 
 const SqlRecordVector *InfoQuery::getHelipadInformation(int airportId)
 {
+  ensureQueries();
+
   helipadQuery->bindValue(":id", airportId);
   return query::cachedRecordVector(helipadCache, helipadQuery, airportId);
 }
 
 const SqlRecordVector *InfoQuery::getStartInformation(int airportId)
 {
+  ensureQueries();
+
   startQuery->bindValue(":id", airportId);
   return query::cachedRecordVector(startCache, startQuery, airportId);
 }
 
 const atools::sql::SqlRecord *InfoQuery::getRunwayEndInformation(int runwayEndId)
 {
+  ensureQueries();
+
   runwayEndQuery->bindValue(":id", runwayEndId);
   return query::cachedRecord(runwayEndCache, runwayEndQuery, runwayEndId);
 }
 
 const atools::sql::SqlRecord *InfoQuery::getIlsInformationSim(int runwayEndId)
 {
+  ensureQueries();
+
   ilsQuerySim->bindValue(":id", runwayEndId);
   return query::cachedRecord(ilsCacheSim, ilsQuerySim, runwayEndId);
 }
 
 atools::sql::SqlRecord InfoQuery::getIlsInformationSimById(int ilsId)
 {
+  ensureQueries();
+
   ilsQuerySimById->bindValue(":id", ilsId);
   ilsQuerySimById->exec();
   atools::sql::SqlRecord rec;
@@ -131,6 +174,8 @@ atools::sql::SqlRecord InfoQuery::getIlsInformationSimById(int ilsId)
 
 atools::sql::SqlRecord InfoQuery::getIlsInformationNavById(int ilsId)
 {
+  ensureQueries();
+
   ilsQueryNavById->bindValue(":id", ilsId);
   ilsQueryNavById->exec();
   atools::sql::SqlRecord rec;
@@ -144,6 +189,8 @@ atools::sql::SqlRecord InfoQuery::getIlsInformationNavById(int ilsId)
 
 const atools::sql::SqlRecord *InfoQuery::getIlsInformationNav(int runwayEndId)
 {
+  ensureQueries();
+
   ilsQueryNav->bindValue(":id", runwayEndId);
   return query::cachedRecord(ilsCacheNav, ilsQueryNav, runwayEndId);
 }
@@ -164,6 +211,8 @@ const atools::sql::SqlRecordVector *InfoQuery::getIlsInformationSimByName(const
 const atools::sql::SqlRecordVector *InfoQuery::ilsInformationSimByName(const QString& airportIdent,
                                                                        const QString& runway)
 {
+  ensureQueries();
+
   std::pair<QString, QString> key = std::make_pair(airportIdent, runway);
   atools::sql::SqlRecordVector *rec = ilsCacheSimByName.object(key);
 
@@ -184,12 +233,16 @@ const atools::sql::SqlRecordVector *InfoQuery::ilsInformationSimByName(const QSt
 
 const atools::sql::SqlRecord *InfoQuery::getVorInformation(int vorId)
 {
+  ensureQueries();
+
   vorQuery->bindValue(":id", vorId);
   return query::cachedRecord(vorCache, vorQuery, vorId);
 }
 
 const atools::sql::SqlRecord InfoQuery::getVorByIdentAndRegion(const QString& ident, const QString& region)
 {
+  ensureQueries();
+
   vorIdentRegionQuery->bindValue(":ident", ident);
   vorIdentRegionQuery->bindValue(":region", region);
   vorIdentRegionQuery->exec();
@@ -204,6 +257,8 @@ const atools::sql::SqlRecord InfoQuery::getVorByIdentAndRegion(const QString& id
 
 const atools::sql::SqlRecord *InfoQuery::getNdbInformation(int ndbId)
 {
+  ensureQueries();
+
   ndbQuery->bindValue(":id", ndbId);
   return query::cachedRecord(ndbCache, ndbQuery, ndbId);
 }
@@ -221,6 +276,19 @@ atools::sql::SqlRecord InfoQuery::getTrackMetadata(int trackId)
 }
 
 void InfoQuery::initQueries()
+{
+  // Delete all statements and invalidate the caches only. The statements are prepared again
+  // by ensureQueries() on first access which keeps database switches fast.
+  deInitQueries();
+}
+
+void InfoQuery::ensureQueries()
+{
+  if(!queriesPrepared)
+    initQueriesInternal();
+}
+
+void InfoQuery::initQueriesInternal()
 {
   deInitQueries();
 
@@ -258,6 +326,11 @@ void InfoQuery::initQueries()
   runwayEndQuery = new SqlQuery(dbSim);
   runwayEndQuery->prepare("select * from runway_end where runway_end_id = :id");
 
+  runwayEndAirportQuery = new SqlQuery(dbSim);
+  runwayEndAirportQuery->prepare("select e.* from runway_end e join runway r on "
+                                 "e.runway_end_id = r.primary_end_id or e.runway_end_id = r.secondary_end_id "
+                                 "where r.airport_id = :id");
+
   helipadQuery = new SqlQuery(dbSim);
   helipadQuery->prepare("select h.*, s.number as start_number, s.runway_name from helipad h "
                         " left outer join start s on s.start_id= h.start_id "
@@ -292,10 +365,19 @@ void InfoQuery::initQueries()
 
   transitionQuery = new SqlQuery(dbNav);
   transitionQuery->prepare("select * from transition where approach_id = :id order by fix_ident");
+
+  transitionAirportQuery = new SqlQuery(dbNav);
+  transitionAirportQuery->prepare("select t.* from transition t "
+                                  "join approach a on t.approach_id = a.approach_id "
+                                  "where a.airport_id = :id order by t.approach_id, t.fix_ident");
+
+  queriesPrepared = true;
 }
 
 void InfoQuery::deInitQueries()
 {
+  queriesPrepared = false;
+
   airportCache.clear();
   vorCache.clear();
   ndbCache.clear();
@@ -309,6 +391,7 @@ void InfoQuery::deInitQueries()
   startCache.clear();
   approachCache.clear();
   transitionCache.clear();
+  transitionAirportCache.clear();
   airportSceneryCache.clear();
 
   delete airportQuery;
@@ -338,6 +421,9 @@ void InfoQuery::deInitQueries()
   delete runwayEndQuery;
   runwayEndQuery = nullptr;
 
+  delete runwayEndAirportQuery;
+  runwayEndAirportQuery = nullptr;
+
   delete ilsQueryNav;
   ilsQueryNav = nullptr;
 
@@ -361,4 +447,7 @@ void InfoQuery::deInitQueries()
 
   delete transitionQuery;
   transitionQuery = nullptr;
+
+  delete transitionAirportQuery;
+  transitionAirportQuery = nullptr;
 }
@@ -57,7 +57,8 @@ public:
   /* Get record for joined tables ndb, bgl_file and scenery_area */
   const atools::sql::SqlRecord *getNdbInformation(int ndbId);
 
-  /* Get record list for table runway of an airport */
+  /* Get record list for table runway of an airport. Also loads all runway ends of the airport
+   * into the runway end cache with a single query instead of two queries per runway later. */
   const atools::sql::SqlRecordVector *getRunwayInformation(int airportId);
 
   /* Get record for table runway_end */
@@ -81,16 +82,25 @@ public:
   /* Get record for table transition */
   const atools::sql::SqlRecordVector *getTransitionInformation(int approachId);
 
+  /* Get records for table transition of all approaches of an airport ordered by approach id.
+   * One query instead of one per approach when filling the procedure search tree. */
+  const atools::sql::SqlRecordVector *getTransitionInformationForAirport(int airportId);
+
   /* Get a record from table trackmeta for given track id */
   atools::sql::SqlRecord getTrackMetadata(int trackId);
 
-  /* Create all queries */
+  /* Invalidate all queries and clear the caches. The statements are prepared lazily on
+   * first use which makes switching between simulator and navdata databases fast. */
   void initQueries();
 
   /* Delete all queries */
   void deInitQueries();
 
 private:
+  /* Create and prepare all queries. Called on first access after construction or a database switch. */
+  void initQueriesInternal();
+  void ensureQueries();
+
   const atools::sql::SqlRecordVector *ilsInformationSimByName(const QString& airportIdent, const QString& runway);
 
   /* Caches */
@@ -98,19 +108,24 @@ private:
                                       ilsCacheNav, ilsCacheSim;
 
   QCache<int, atools::sql::SqlRecordVector> comCache, runwayCache, helipadCache, startCache, approachCache,
-                                            transitionCache;
+                                            transitionCache, transitionAirportCache;
   QCache<std::pair<QString, QString>, atools::sql::SqlRecordVector> ilsCacheSimByName;
 
   QCache<QString, atools::sql::SqlRecordVector> airportSceneryCache;
 
   atools::sql::SqlDatabase *dbSim, *dbNav, *dbTrack;
 
+  /* false after construction or a database switch until the statements were prepared */
+  bool queriesPrepared = false;
+
   /* Prepared database queries */
   atools::sql::SqlQuery *airportQuery = nullptr, *airportSceneryQuery = nullptr, *vorQuery = nullptr,
                         *ndbQuery = nullptr, *comQuery = nullptr, *runwayQuery = nullptr, *runwayEndQuery = nullptr,
+                        *runwayEndAirportQuery = nullptr,
                         *helipadQuery = nullptr, *startQuery = nullptr, *ilsQuerySim = nullptr, *ilsQueryNav = nullptr,
                         *ilsQuerySimByName = nullptr, *ilsQueryNavById = nullptr, *ilsQuerySimById = nullptr,
-                        *vorIdentRegionQuery = nullptr, *approachQuery = nullptr, *transitionQuery = nullptr;
+                        *vorIdentRegionQuery = nullptr, *approachQuery = nullptr, *transitionQuery = nullptr,
+                        *transitionAirportQuery = nullptr;
 
 };
 
@@ -50,14 +50,24 @@ static double queryRectInflationFactor = 0.2;
 static double queryRectInflationIncrement = 0.1;
 int MapQuery::queryMaxRows = 5000;
 
+/* Column lists shared by the prepared queries and the spatial index loaders */
+static const QString vorQueryBase(
+  "vor_id, ident, name, region, type, frequency, channel, range, dme_only, dme_altitude, "
+  "mag_var, altitude, lonx, laty ");
+static const QString ndbQueryBase(
+  "ndb_id, ident, name, region, type, frequency, range, mag_var, altitude, lonx, laty ");
+static const QString markerQueryBase(
+  "marker_id, type, ident, heading, lonx, laty ");
+static const QString ilsQueryBase(
+  "ils_id, ident, name, region, mag_var, loc_heading, gs_pitch, frequency, range, dme_range, loc_width, "
+  "end1_lonx, end1_laty, end_mid_lonx, end_mid_laty, end2_lonx, end2_laty, altitude, lonx, laty");
+
 MapQuery::MapQuery(atools::sql::SqlDatabase *sqlDb, SqlDatabase *sqlDbNav, SqlDatabase *sqlDbUser)
   : dbSim(sqlDb), dbNav(sqlDbNav), dbUser(sqlDbUser)
 {
   mapTypesFactory = new MapTypesFactory();
   atools::settings::Settings& settings = atools::settings::Settings::instance();
 
-  runwayOverwiewCache.setMaxCost(settings.getAndStoreValue(lnm::SETTINGS_MAPQUERY + "RunwayOverwiewCache",
-                                                           1000).toInt());
   queryRectInflationFactor = settings.getAndStoreValue(
     lnm::SETTINGS_MAPQUERY + "QueryRectInflationFactor", 0.3).toDouble();
   queryRectInflationIncrement = settings.getAndStoreValue(
@@ -126,6 +136,8 @@ void MapQuery::getAirportNavReplace(map::MapAirport& airport)
 
 void MapQuery::getVorForWaypoint(map::MapVor& vor, int waypointId)
 {
+  ensureQueries();
+
   vorByWaypointIdQuery->bindValue(":id", waypointId);
   vorByWaypointIdQuery->exec();
   if(vorByWaypointIdQuery->next())
@@ -135,6 +147,8 @@ void MapQuery::getVorForWaypoint(map::MapVor& vor, int waypointId)
 
 void MapQuery::getNdbForWaypoint(map::MapNdb& ndb, int waypointId)
 {
+  ensureQueries();
+
   ndbByWaypointIdQuery->bindValue(":id", waypointId);
   ndbByWaypointIdQuery->exec();
   if(ndbByWaypointIdQuery->next())
@@ -144,6 +158,8 @@ void MapQuery::getNdbForWaypoint(map::MapNdb& ndb, int waypointId)
 
 void MapQuery::getVorNearest(map::MapVor& vor, const atools::geo::Pos& pos)
 {
+  ensureQueries();
+
   vorNearestQuery->bindValue(":lonx", pos.getLonX());
   vorNearestQuery->bindValue(":laty", pos.getLatY());
   vorNearestQuery->exec();
@@ -154,6 +170,8 @@ void MapQuery::getVorNearest(map::MapVor& vor, const atools::geo::Pos& pos)
 
 void MapQuery::getNdbNearest(map::MapNdb& ndb, const atools::geo::Pos& pos)
 {
+  ensureQueries();
+
   ndbNearestQuery->bindValue(":lonx", pos.getLonX());
   ndbNearestQuery->bindValue(":laty", pos.getLatY());
   ndbNearestQuery->exec();
@@ -174,6 +192,8 @@ map::MapResultIndex *MapQuery::getNearestNavaids(const Pos& pos, float distanceN
 map::MapResultIndex *MapQuery::nearestNavaidsInternal(const Pos& pos, float distanceNm, map::MapTypes type,
                                                             int maxIls, float maxIlsDist)
 {
+  ensureQueries();
+
   query::NearestCacheKeyNavaid key = {pos, distanceNm, type};
 
   map::MapResultIndex *result = nearestNavaidCache.object(key);
@@ -189,7 +209,7 @@ map::MapResultIndex *MapQuery::nearestNavaidsInternal(const Pos& pos, float dist
     {
       query::fetchObjectsForRect(rect, vorsByRectQuery, [ =, &res](atools::sql::SqlQuery *query) -> void {
         map::MapVor obj;
-        mapTypesFactory->fillVor(query->record(), obj);
+        mapTypesFactory->fillVor(*query, obj);
         res.vors.append(obj);
       });
     }
@@ -198,7 +218,7 @@ map::MapResultIndex *MapQuery::nearestNavaidsInternal(const Pos& pos, float dist
     {
       query::fetchObjectsForRect(rect, ndbsByRectQuery, [ =, &res](atools::sql::SqlQuery *query) -> void {
         map::MapNdb obj;
-        mapTypesFactory->fillNdb(query->record(), obj);
+        mapTypesFactory->fillNdb(*query, obj);
         res.ndbs.append(obj);
       });
     }
@@ -208,14 +228,14 @@ map::MapResultIndex *MapQuery::nearestNavaidsInternal(const Pos& pos, float dist
       query::fetchObjectsForRect(rect, NavApp::getWaypointTrackQuery()->getWaypointsByRectQueryTrack(),
                                  [ =, &res](atools::sql::SqlQuery *query) -> void {
         map::MapWaypoint obj;
-        mapTypesFactory->fillWaypoint(query->record(), obj, true /* track database */);
+        mapTypesFactory->fillWaypoint(*query, obj, true /* track database */);
         res.waypoints.append(obj);
       });
 
       query::fetchObjectsForRect(rect, NavApp::getWaypointTrackQuery()->getWaypointsByRectQuery(),
                                  [ =, &res](atools::sql::SqlQuery *query) -> void {
         map::MapWaypoint obj;
-        mapTypesFactory->fillWaypoint(query->record(), obj, false /* track database */);
+        mapTypesFactory->fillWaypoint(*query, obj, false /* track database */);
 
         if(!res.waypoints.contains(obj))
           res.waypoints.append(obj);
@@ -229,7 +249,7 @@ map::MapResultIndex *MapQuery::nearestNavaidsInternal(const Pos& pos, float dist
 
       query::fetchObjectsForRect(rect, ilsByRectQuery, [ =, &ilsRes](atools::sql::SqlQuery *query) -> void {
         map::MapIls obj;
-        mapTypesFactory->fillIls(query->record(), obj);
+        mapTypesFactory->fillIls(*query, obj);
         ilsRes.append(obj);
       });
       maptools::removeByDistance(ilsRes, pos, atools::geo::nmToMeter(maxIlsDist));
@@ -270,6 +290,8 @@ void MapQuery::mapObjectByIdentInternal(map::MapResult& result, map::MapTypes ty
                                         const QString& region, const QString& airport, const Pos& sortByDistancePos,
                                         float maxDistance, bool airportFromNavDatabase)
 {
+  ensureQueries();
+
   if(type & map::AIRPORT)
   {
     map::MapAirport ap;
@@ -360,6 +382,80 @@ void MapQuery::mapObjectByIdentInternal(map::MapResult& result, map::MapTypes ty
     NavApp::getAirwayTrackQuery()->getAirwaysByName(result.airways, ident);
 }
 
+void MapQuery::getMapObjectsByIdents(QHash<QString, map::MapResult>& results, map::MapTypes type,
+                                     const QSet<QString>& idents)
+{
+  if(idents.isEmpty())
+    return;
+
+  QStringList placeholders;
+  for(int i = 0; i < idents.size(); i++)
+    placeholders.append("?");
+
+  if(type & map::VOR)
+  {
+    // Query cannot be prepared once since the number of placeholders varies
+    SqlQuery query(dbNav);
+    query.prepare("select " + vorQueryBase + " from vor where ident in (" + placeholders.join(", ") + ")");
+    int index = 0;
+    for(const QString& ident : idents)
+      query.bindValue(index++, ident);
+    query.exec();
+    while(query.next())
+    {
+      map::MapVor vor;
+      mapTypesFactory->fillVor(query, vor);
+      results[vor.ident].vors.append(vor);
+    }
+  }
+
+  if(type & map::NDB)
+  {
+    SqlQuery query(dbNav);
+    query.prepare("select " + ndbQueryBase + " from ndb where ident in (" + placeholders.join(", ") + ")");
+    int index = 0;
+    for(const QString& ident : idents)
+      query.bindValue(index++, ident);
+    query.exec();
+    while(query.next())
+    {
+      map::MapNdb ndb;
+      mapTypesFactory->fillNdb(query, ndb);
+      results[ndb.ident].ndbs.append(ndb);
+    }
+  }
+
+  if(type & map::WAYPOINT)
+  {
+    QHash<QString, QList<map::MapWaypoint> > waypoints;
+    NavApp::getWaypointTrackQuery()->getWaypointsByIdents(waypoints, idents);
+    for(auto it = waypoints.constBegin(); it != waypoints.constEnd(); ++it)
+      results[it.key()].waypoints.append(it.value());
+  }
+
+  // Airports and airways have no query base strings to share - use the prepared queries per ident
+  for(const QString& ident : idents)
+  {
+    map::MapResult& result = results[ident];
+
+    if(type & map::AIRPORT)
+    {
+      map::MapAirport ap;
+      NavApp::getAirportQuerySim()->getAirportByIdent(ap, ident);
+
+      if(!ap.isValid())
+        // Try to query using the real ICAO ident vs. X-Plane artifical ids
+        NavApp::getAirportQuerySim()->getAirportByIcao(ap, ident);
+
+      if(ap.isValid())
+        result.airports.append(ap);
+    }
+
+    if(type & map::AIRWAY)
+      NavApp::getAirwayTrackQuery()->getAirwaysByName(result.airways, ident);
+  }
+}
+
 void MapQuery::getMapObjectById(map::MapResult& result, map::MapTypes type, map::MapAirspaceSources src,
                                 int id, bool airportFromNavDatabase)
 {
@@ -438,6 +534,8 @@ void MapQuery::getMapObjectById(map::MapResult& result, map::MapTypes type, map:
 
 map::MapVor MapQuery::getVorById(int id)
 {
+  ensureQueries();
+
   map::MapVor vor;
   vorByIdQuery->bindValue(":id", id);
   vorByIdQuery->exec();
@@ -449,6 +547,8 @@ map::MapVor MapQuery::getVorById(int id)
 
 map::MapNdb MapQuery::getNdbById(int id)
 {
+  ensureQueries();
+
   map::MapNdb ndb;
   ndbByIdQuery->bindValue(":id", id);
   ndbByIdQuery->exec();
@@ -460,6 +560,8 @@ map::MapNdb MapQuery::getNdbById(int id)
 
 map::MapIls MapQuery::getIlsById(int id)
 {
+  ensureQueries();
+
   map::MapIls ils;
   ilsByIdQuery->bindValue(":id", id);
   ilsByIdQuery->exec();
@@ -483,6 +585,8 @@ QVector<map::MapIls> MapQuery::getIlsByAirportAndRunway(const QString& airportId
 
 QVector<map::MapIls> MapQuery::ilsByAirportAndRunway(const QString& airportIdent, const QString& runway)
 {
+  ensureQueries();
+
   QVector<map::MapIls> ilsList;
   ilsQuerySimByName->bindValue(":apt", airportIdent);
   ilsQuerySimByName->bindValue(":rwy", runway);
@@ -504,6 +608,15 @@ void MapQuery::getNearestScreenObjects(const CoordinateConverter& conv, const Ma
   using maptools::insertSortedByDistance;
   using maptools::insertSortedByTowerDistance;
 
+  // Reject objects by world coordinates before the expensive screen projection.
+  // The caches contain everything in the viewport which can be thousands of objects
+  // over dense terminal areas.
+  atools::geo::Rect filterRect = maptools::screenToWorldRect(conv, xs, ys, screenDistance);
+  auto nearCursor = [&filterRect](const atools::geo::Pos& pos) -> bool
+  {
+    return !filterRect.isValid() || filterRect.contains(pos);
+  };
+
   int x, y;
   if(mapLayer->isAirport() && types.testFlag(map::AIRPORT))
   {
@@ -511,7 +624,7 @@ void MapQuery::getNearestScreenObjects(const CoordinateConverter& conv, const Ma
     {
       const MapAirport& airport = airportCache.list.at(i);
 
-      if(airport.isVisible(types))
+      if(airport.isVisible(types) && nearCursor(airport.position))
       {
         if(conv.wToS(airport.position, x, y))
           if((atools::geo::manhattanDistance(x, y, xs, ys)) < screenDistance)
@@ -533,7 +646,7 @@ void MapQuery::getNearestScreenObjects(const CoordinateConverter& conv, const Ma
     for(int i = vorCache.list.size() - 1; i >= 0; i--)
     {
       const MapVor& vor = vorCache.list.at(i);
-      if(conv.wToS(vor.position, x, y))
+      if(nearCursor(vor.position) && conv.wToS(vor.position, x, y))
         if((atools::geo::manhattanDistance(x, y, xs, ys)) < screenDistance)
           insertSortedByDistance(conv, result.vors, &result.vorIds, xs, ys, vor);
     }
@@ -544,7 +657,7 @@ void MapQuery::getNearestScreenObjects(const CoordinateConverter& conv, const Ma
     for(int i = ndbCache.list.size() - 1; i >= 0; i--)
     {
       const MapNdb& ndb = ndbCache.list.at(i);
-      if(conv.wToS(ndb.position, x, y))
+      if(nearCursor(ndb.position) && conv.wToS(ndb.position, x, y))
         if((atools::geo::manhattanDistance(x, y, xs, ys)) < screenDistance)
           insertSortedByDistance(conv, result.ndbs, &result.ndbIds, xs, ys, ndb);
     }
@@ -556,7 +669,7 @@ void MapQuery::getNearestScreenObjects(const CoordinateConverter& conv, const Ma
     for(int i = userpointCache.list.size() - 1; i >= 0; i--)
     {
       const MapUserpoint& wp = userpointCache.list.at(i);
-      if(conv.wToS(wp.position, x, y))
+      if(nearCursor(wp.position) && conv.wToS(wp.position, x, y))
         if((atools::geo::manhattanDistance(x, y, xs, ys)) < screenDistance)
           insertSortedByDistance(conv, result.userpoints, &result.userpointIds, xs, ys, wp);
     }
@@ -573,7 +686,7 @@ void MapQuery::getNearestScreenObjects(const CoordinateConverter& conv, const Ma
     for(int i = markerCache.list.size() - 1; i >= 0; i--)
     {
       const MapMarker& wp = markerCache.list.at(i);
-      if(conv.wToS(wp.position, x, y))
+      if(nearCursor(wp.position) && conv.wToS(wp.position, x, y))
         if((atools::geo::manhattanDistance(x, y, xs, ys)) < screenDistance)
           insertSortedByDistance(conv, result.markers, nullptr, xs, ys, wp);
     }
@@ -584,7 +697,7 @@ void MapQuery::getNearestScreenObjects(const CoordinateConverter& conv, const Ma
     for(int i = ilsCache.list.size() - 1; i >= 0; i--)
     {
       const MapIls& wp = ilsCache.list.at(i);
-      if(conv.wToS(wp.position, x, y))
+      if(nearCursor(wp.position) && conv.wToS(wp.position, x, y))
         if((atools::geo::manhattanDistance(x, y, xs, ys)) < screenDistance)
           insertSortedByDistance(conv, result.ils, nullptr, xs, ys, wp);
     }
@@ -635,16 +748,22 @@ const QList<map::MapAirport> *MapQuery::getAirports(const Marble::GeoDataLatLonB
   switch(mapLayer->getDataSource())
   {
     case layer::ALL:
-      airportByRectQuery->bindValue(":minlength", mapLayer->getMinRunwayLength());
-      return fetchAirports(rect, airportByRectQuery, lazy, false /* overview */);
+      {
+        int minRunwayLength = mapLayer->getMinRunwayLength();
+        return fetchAirports(rect, airportIndex, "airport", lazy, false /* overview */,
+                             [minRunwayLength](const MapAirport& airport) -> bool
+        {
+          return airport.longestRunwayLength >= minRunwayLength;
+        });
+      }
 
     case layer::MEDIUM:
       // Airports > 4000 ft
-      return fetchAirports(rect, airportMediumByRectQuery, lazy, true /* overview */);
+      return fetchAirports(rect, airportMediumIndex, "airport_medium", lazy, true /* overview */, nullptr);
 
     case layer::LARGE:
       // Airports > 8000 ft
-      return fetchAirports(rect, airportLargeByRectQuery, lazy, true /* overview */);
+      return fetchAirports(rect, airportLargeIndex, "airport_large", lazy, true /* overview */, nullptr);
 
   }
   return nullptr;
@@ -661,18 +780,20 @@ const QList<map::MapVor> *MapQuery::getVors(const GeoDataLatLonBox& rect, const
 
   if(vorCache.list.isEmpty() && !lazy)
   {
-    for(const GeoDataLatLonBox& r :
-        query::splitAtAntiMeridian(rect, queryRectInflationFactor, queryRectInflationIncrement))
+    if(!vorIndex.isValid())
+      loadVorIndex();
+
+    GeoDataLatLonBox cur(rect);
+    query::inflateQueryRect(cur, queryRectInflationFactor, queryRectInflationIncrement);
+    vorIndex.query(cur, vorCache.list, queryMaxRows);
+
+    // Sort by range so the high and low VORs are painted first and terminal stations are
+    // the ones dropped when the painter runs out of its object budget
+    std::sort(vorCache.list.begin(), vorCache.list.end(),
+              [](const map::MapVor& vor1, const map::MapVor& vor2) -> bool
     {
-      query::bindRect(r, vorsByRectQuery);
-      vorsByRectQuery->exec();
-      while(vorsByRectQuery->next())
-      {
-        map::MapVor vor;
-        mapTypesFactory->fillVor(vorsByRectQuery->record(), vor);
-        vorCache.list.append(vor);
-      }
-    }
+      return vor1.range > vor2.range;
+    });
   }
   vorCache.validate(queryMaxRows);
   return &vorCache.list;
@@ -689,18 +810,19 @@ const QList<map::MapNdb> *MapQuery::getNdbs(const GeoDataLatLonBox& rect, const
 
   if(ndbCache.list.isEmpty() && !lazy)
   {
-    for(const GeoDataLatLonBox& r :
-        query::splitAtAntiMeridian(rect, queryRectInflationFactor, queryRectInflationIncrement))
+    if(!ndbIndex.isValid())
+      loadNdbIndex();
+
+    GeoDataLatLonBox cur(rect);
+    query::inflateQueryRect(cur, queryRectInflationFactor, queryRectInflationIncrement);
+    ndbIndex.query(cur, ndbCache.list, queryMaxRows);
+
+    // As for the VORs above - strongest stations first
+    std::sort(ndbCache.list.begin(), ndbCache.list.end(),
+              [](const map::MapNdb& ndb1, const map::MapNdb& ndb2) -> bool
     {
-      query::bindRect(r, ndbsByRectQuery);
-      ndbsByRectQuery->exec();
-      while(ndbsByRectQuery->next())
-      {
-        map::MapNdb ndb;
-        mapTypesFactory->fillNdb(ndbsByRectQuery->record(), ndb);
-        ndbCache.list.append(ndb);
-      }
-    }
+      return ndb1.range > ndb2.range;
+    });
   }
   ndbCache.validate(queryMaxRows);
   return &ndbCache.list;
@@ -710,7 +832,12 @@ const QList<map::MapUserpoint> MapQuery::getUserdataPoints(const GeoDataLatLonBo
                                                            const QStringList& typesAll, bool unknownType,
                                                            float distance)
 {
-  // No caching here since points can change and the dataset is usually small
+  ensureQueries();
+
+  // Rebuild here after a database switch or after UserdataController invalidated the index
+  if(!userpointIndex.isValid())
+    loadUserpointIndex();
+
   QList<map::MapUserpoint> retval;
   userpointCache.clear();
 
@@ -719,48 +846,56 @@ const QList<map::MapUserpoint> MapQuery::getUserdataPoints(const GeoDataLatLonBo
   {
     bool allTypesSelected = types == typesAll;
 
-    for(const GeoDataLatLonBox& r :
-        query::splitAtAntiMeridian(rect, queryRectInflationFactor, queryRectInflationIncrement))
+    GeoDataLatLonBox cur(rect);
+    query::inflateQueryRect(cur, queryRectInflationFactor, queryRectInflationIncrement);
+
+    userpointIndex.query(cur, retval, queryMaxRows,
+                         [&](const map::MapUserpoint& userpoint) -> bool
     {
-      query::bindRect(r, userdataPointByRectQuery);
-      userdataPointByRectQuery->bindValue(":dist", distance);
+      // Hide points which are limited to smaller map view distances
+      if(userpoint.visibleFrom <= distance)
+        return false;
 
-      QStringList queryTypes;
-      if(unknownType || (allTypesSelected && unknownType))
-        // Either query all unknows too and filter later or all and unknown are selected
-        queryTypes.append("%");
+      if(unknownType && allTypesSelected)
+        // Everything is selected
+        return true;
+
+      if(typesAll.contains(userpoint.type))
+        // Known type - has to be selected
+        return types.contains(userpoint.type);
       else
-        queryTypes = types;
+        // Unknown type
+        return unknownType;
+    });
 
-      for(const QString& queryType : queryTypes)
-      {
-        userdataPointByRectQuery->bindValue(":type", queryType);
-        userdataPointByRectQuery->exec();
-        while(userdataPointByRectQuery->next())
-        {
-          if(unknownType && !allTypesSelected)
-          {
-            // Need to filter manually here
-            QString pointType = userdataPointByRectQuery->valueStr("type");
-
-            // Ignore if not unknown and not in selected types
-            if(typesAll.contains(pointType) && !types.contains(pointType))
-              continue;
-          }
-
-          map::MapUserpoint userPoint;
-          mapTypesFactory->fillUserdataPoint(userdataPointByRectQuery->record(), userPoint);
-          retval.append(userPoint);
-
-          // Cache has to be kept for map screen index
-          userpointCache.list.append(userPoint);
-        }
-      }
-    }
+    // Cache has to be kept for map screen index
+    userpointCache.list = retval;
   }
   return retval;
 }
 
+void MapQuery::loadUserpointIndex()
+{
+  userpointIndex.clear();
+
+  SqlQuery query(dbUser);
+  query.exec("select * from userdata");
+  while(query.next())
+  {
+    map::MapUserpoint userpoint;
+    mapTypesFactory->fillUserdataPoint(query.record(), userpoint);
+    userpointIndex.append(userpoint);
+  }
+  userpointIndex.finishBuilding();
+
+  qDebug() << Q_FUNC_INFO << userpointIndex.size() << "userpoints";
+}
+
+void MapQuery::invalidateUserpointIndex()
+{
+  userpointIndex.clear();
+}
+
 const QList<map::MapMarker> *MapQuery::getMarkers(const GeoDataLatLonBox& rect, const MapLayer *mapLayer,
                                                   bool lazy)
 {
@@ -772,18 +907,12 @@ const QList<map::MapMarker> *MapQuery::getMarkers(const GeoDataLatLonBox& rect,
 
   if(markerCache.list.isEmpty() && !lazy)
   {
-    for(const GeoDataLatLonBox& r :
-        query::splitAtAntiMeridian(rect, queryRectInflationFactor, queryRectInflationIncrement))
-    {
-      query::bindRect(r, markersByRectQuery);
-      markersByRectQuery->exec();
-      while(markersByRectQuery->next())
-      {
-        map::MapMarker marker;
-        mapTypesFactory->fillMarker(markersByRectQuery->record(), marker);
-        markerCache.list.append(marker);
-      }
-    }
+    if(!markerIndex.isValid())
+      loadMarkerIndex();
+
+    GeoDataLatLonBox cur(rect);
+    query::inflateQueryRect(cur, queryRectInflationFactor, queryRectInflationIncrement);
+    markerIndex.query(cur, markerCache.list, queryMaxRows);
   }
   markerCache.validate(queryMaxRows);
   return &markerCache.list;
@@ -799,6 +928,9 @@ const QList<map::MapIls> *MapQuery::getIls(GeoDataLatLonBox rect, const MapLayer
 
   if(ilsCache.list.isEmpty() && !lazy)
   {
+    if(!ilsIndex.isValid())
+      loadIlsIndex();
+
     // ILS length is 9 NM * 1' per degree
     double increase = atools::geo::toRadians(9. / 60.);
 
@@ -806,19 +938,8 @@ const QList<map::MapIls> *MapQuery::getIls(GeoDataLatLonBox rect, const MapLayer
     rect.setBoundaries(rect.north() + increase, rect.south() - increase,
                        rect.east() + increase, rect.west() - increase);
 
-    for(const GeoDataLatLonBox& r :
-        query::splitAtAntiMeridian(rect, queryRectInflationFactor, queryRectInflationIncrement))
-    {
-      query::bindRect(r, ilsByRectQuery);
-
-      ilsByRectQuery->exec();
-      while(ilsByRectQuery->next())
-      {
-        map::MapIls ils;
-        mapTypesFactory->fillIls(ilsByRectQuery->record(), ils);
-        ilsCache.list.append(ils);
-      }
-    }
+    query::inflateQueryRect(rect, queryRectInflationFactor, queryRectInflationIncrement);
+    ilsIndex.query(rect, ilsCache.list, queryMaxRows);
   }
   ilsCache.validate(queryMaxRows);
   return &ilsCache.list;
@@ -826,63 +947,140 @@ const QList<map::MapIls> *MapQuery::getIls(GeoDataLatLonBox rect, const MapLayer
 
 /*
  * Get airport cache
- * @param reverse reverse order of airports to have unimportant small ones below in painting order
+ * @param index spatial index serving this data source - loaded from table if not valid yet
  * @param lazy do not update cache - instead return incomplete resut
  * @param overview fetch only incomplete data for overview airports
+ * @param filter optional callback to reject airports like the minimum runway length check
  * @return pointer to the airport cache
  */
 const QList<map::MapAirport> *MapQuery::fetchAirports(const Marble::GeoDataLatLonBox& rect,
-                                                      atools::sql::SqlQuery *query,
-                                                      bool lazy, bool overview)
+                                                      query::SpatialGridIndex<map::MapAirport>& index,
+                                                      const QString& table, bool lazy, bool overview,
+                                                      const query::SpatialGridIndex<map::MapAirport>::FilterFunc& filter)
 {
   if(airportCache.list.isEmpty() && !lazy)
   {
-    bool navdata = NavApp::getDatabaseManager()->getNavDatabaseStatus() == dm::NAVDATABASE_ALL;
-    for(const GeoDataLatLonBox& r :
-        query::splitAtAntiMeridian(rect, queryRectInflationFactor, queryRectInflationIncrement))
-    {
-      query::bindRect(r, query);
-      query->exec();
-      while(query->next())
-      {
-        map::MapAirport ap;
-        if(overview)
-          // Fill only a part of the object
-          mapTypesFactory->fillAirportForOverview(query->record(), ap, navdata,
-                                                  NavApp::getCurrentSimulatorDb() == atools::fs::FsPaths::XPLANE11);
-        else
-          mapTypesFactory->fillAirport(query->record(), ap, true /* complete */, navdata,
-                                       NavApp::getCurrentSimulatorDb() == atools::fs::FsPaths::XPLANE11);
-
-        airportCache.list.append(ap);
-      }
-    }
+    if(!index.isValid())
+      loadAirportIndex(index, table, overview);
+
+    GeoDataLatLonBox cur(rect);
+    query::inflateQueryRect(cur, queryRectInflationFactor, queryRectInflationIncrement);
+    index.query(cur, airportCache.list, queryMaxRows, filter);
   }
   airportCache.validate(queryMaxRows);
   return &airportCache.list;
 }
 
-const QList<map::MapRunway> *MapQuery::getRunwaysForOverview(int airportId)
+void MapQuery::loadAirportIndex(query::SpatialGridIndex<map::MapAirport>& index, const QString& table, bool overview)
 {
-  if(runwayOverwiewCache.contains(airportId))
-    return runwayOverwiewCache.object(airportId);
-  else
+  bool navdata = NavApp::getDatabaseManager()->getNavDatabaseStatus() == dm::NAVDATABASE_ALL;
+  bool xplane = NavApp::getCurrentSimulatorDb() == atools::fs::FsPaths::XPLANE11;
+  QStringList columns = overview ? AirportQuery::airportOverviewColumns(dbSim) : AirportQuery::airportColumns(dbSim);
+
+  SqlQuery query(dbSim);
+  query.exec("select " + columns.join(", ") + " from " + table);
+  while(query.next())
   {
-    using atools::geo::Pos;
+    map::MapAirport ap;
+    if(overview)
+      // Fill only a part of the object
+      mapTypesFactory->fillAirportForOverview(query.record(), ap, navdata, xplane);
+    else
+      mapTypesFactory->fillAirport(query.record(), ap, true /* complete */, navdata, xplane);
 
-    runwayOverviewQuery->bindValue(":airportId", airportId);
-    runwayOverviewQuery->exec();
+    index.append(ap);
+  }
+  index.finishBuilding();
 
-    QList<map::MapRunway> *rws = new QList<map::MapRunway>;
-    while(runwayOverviewQuery->next())
-    {
-      map::MapRunway runway;
-      mapTypesFactory->fillRunway(runwayOverviewQuery->record(), runway, true);
-      rws->append(runway);
-    }
-    runwayOverwiewCache.insert(airportId, rws);
-    return rws;
+  qDebug() << Q_FUNC_INFO << table << index.size() << "airports";
+}
+
+void MapQuery::loadVorIndex()
+{
+  SqlQuery query(dbNav);
+  query.exec("select " + vorQueryBase + " from vor");
+  while(query.next())
+  {
+    map::MapVor vor;
+    mapTypesFactory->fillVor(query, vor);
+    vorIndex.append(vor);
   }
+  vorIndex.finishBuilding();
+
+  qDebug() << Q_FUNC_INFO << vorIndex.size() << "vors";
+}
+
+void MapQuery::loadNdbIndex()
+{
+  SqlQuery query(dbNav);
+  query.exec("select " + ndbQueryBase + " from ndb");
+  while(query.next())
+  {
+    map::MapNdb ndb;
+    mapTypesFactory->fillNdb(query, ndb);
+    ndbIndex.append(ndb);
+  }
+  ndbIndex.finishBuilding();
+
+  qDebug() << Q_FUNC_INFO << ndbIndex.size() << "ndbs";
+}
+
+void MapQuery::loadMarkerIndex()
+{
+  SqlQuery query(dbNav);
+  query.exec("select " + markerQueryBase + " from marker");
+  while(query.next())
+  {
+    map::MapMarker marker;
+    mapTypesFactory->fillMarker(query, marker);
+    markerIndex.append(marker);
+  }
+  markerIndex.finishBuilding();
+
+  qDebug() << Q_FUNC_INFO << markerIndex.size() << "markers";
+}
+
+void MapQuery::loadIlsIndex()
+{
+  SqlQuery query(dbSim);
+  query.exec("select " + ilsQueryBase + " from ils");
+  while(query.next())
+  {
+    map::MapIls ils;
+    mapTypesFactory->fillIls(query, ils);
+    ilsIndex.append(ils);
+  }
+  ilsIndex.finishBuilding();
+
+  qDebug() << Q_FUNC_INFO << ilsIndex.size() << "ils";
+}
+
+const QList<map::MapRunway> *MapQuery::getRunwaysForOverview(int airportId)
+{
+  if(!runwayOverviewIndexLoaded)
+    loadRunwayOverviewIndex();
+
+  // Airports having no runway longer than 4000 feet are not in the index
+  const static QList<map::MapRunway> EMPTY_RUNWAY_LIST;
+  auto it = runwayOverviewIndex.constFind(airportId);
+  return it != runwayOverviewIndex.constEnd() ? &it.value() : &EMPTY_RUNWAY_LIST;
+}
+
+void MapQuery::loadRunwayOverviewIndex()
+{
+  // Runways > 4000 feet for simplyfied runway overview
+  SqlQuery query(dbSim);
+  query.exec("select airport_id, length, heading, lonx, laty, primary_lonx, primary_laty, "
+             "secondary_lonx, secondary_laty from runway where length > 4000");
+  while(query.next())
+  {
+    map::MapRunway runway;
+    mapTypesFactory->fillRunway(query.record(), runway, true /* overview */);
+    runwayOverviewIndex[runway.airportId].append(runway);
+  }
+  runwayOverviewIndexLoaded = true;
+
+  qDebug() << Q_FUNC_INFO << runwayOverviewIndex.size() << "airports";
 }
 
 /* Get runway end and try lower and higher numbers if nothing was found - adds a dummy entry with airport
@@ -942,6 +1140,19 @@ void MapQuery::runwayEndByNameFuzzy(QList<map::MapRunwayEnd>& runwayEnds, const
 }
 
 void MapQuery::initQueries()
+{
+  // Delete all statements and invalidate the caches only. The statements are prepared again
+  // by ensureQueries() on first access which keeps database switches fast.
+  deInitQueries();
+}
+
+void MapQuery::ensureQueries()
+{
+  if(!queriesPrepared)
+    initQueriesInternal();
+}
+
+void MapQuery::initQueriesInternal()
 {
   // Common where clauses
   static const QString whereRect("lonx between :leftx and :rightx and laty between :bottomy and :topy");
@@ -952,19 +1163,9 @@ void MapQuery::initQueries()
   QStringList const airportQueryBase = AirportQuery::airportColumns(dbSim);
   QStringList const airportQueryBaseOverview = AirportQuery::airportOverviewColumns(dbSim);
 
-  static const QString vorQueryBase(
-    "vor_id, ident, name, region, type, name, frequency, channel, range, dme_only, dme_altitude, "
-    "mag_var, altitude, lonx, laty ");
-  static const QString ndbQueryBase(
-    "ndb_id, ident, name, region, type, name, frequency, range, mag_var, altitude, lonx, laty ");
-
   static const QString parkingQueryBase(
     "parking_id, airport_id, type, name, airline_codes, number, radius, heading, has_jetway, lonx, laty ");
 
-  static const QString ilsQueryBase(
-    "ils_id, ident, name, region, mag_var, loc_heading, gs_pitch, frequency, range, dme_range, loc_width, "
-    "end1_lonx, end1_laty, end_mid_lonx, end_mid_laty, end2_lonx, end2_laty, altitude, lonx, laty");
-
   deInitQueries();
 
   vorByIdentQuery = new SqlQuery(dbNav);
@@ -1026,41 +1227,39 @@ void MapQuery::initQueries()
   airportLargeByRectQuery->prepare(
     "select " + airportQueryBaseOverview.join(", ") + " from airport_large where " + whereRect + " " + whereLimit);
 
-  // Runways > 4000 feet for simplyfied runway overview
-  runwayOverviewQuery = new SqlQuery(dbSim);
-  runwayOverviewQuery->prepare(
-    "select length, heading, lonx, laty, primary_lonx, primary_laty, secondary_lonx, secondary_laty "
-    "from runway where airport_id = :airportId and length > 4000 " + whereLimit);
-
   vorsByRectQuery = new SqlQuery(dbNav);
   vorsByRectQuery->prepare("select " + vorQueryBase + " from vor where " + whereRect + " " + whereLimit);
 
   ndbsByRectQuery = new SqlQuery(dbNav);
   ndbsByRectQuery->prepare("select " + ndbQueryBase + " from ndb where " + whereRect + " " + whereLimit);
 
-  userdataPointByRectQuery = new SqlQuery(dbUser);
-  userdataPointByRectQuery->prepare("select * from userdata "
-                                    "where " + whereRect + " and visible_from > :dist and type like :type " +
-                                    whereLimit);
-
-  markersByRectQuery = new SqlQuery(dbNav);
-  markersByRectQuery->prepare(
-    "select marker_id, type, ident, heading, lonx, laty "
-    "from marker "
-    "where " + whereRect + " " + whereLimit);
-
   ilsByRectQuery = new SqlQuery(dbSim);
   ilsByRectQuery->prepare("select " + ilsQueryBase + " from ils where " + whereRect + " " + whereLimit);
+
+  queriesPrepared = true;
 }
 
 void MapQuery::deInitQueries()
 {
+  queriesPrepared = false;
+
+  airportIndex.clear();
+  airportMediumIndex.clear();
+  airportLargeIndex.clear();
+  vorIndex.clear();
+  ndbIndex.clear();
+  markerIndex.clear();
+  ilsIndex.clear();
+  userpointIndex.clear();
+
   airportCache.clear();
   vorCache.clear();
   ndbCache.clear();
   markerCache.clear();
   ilsCache.clear();
-  runwayOverwiewCache.clear();
+
+  runwayOverviewIndex.clear();
+  runwayOverviewIndexLoaded = false;
 
   delete airportByRectQuery;
   airportByRectQuery = nullptr;
@@ -1069,20 +1268,13 @@ void MapQuery::deInitQueries()
   delete airportLargeByRectQuery;
   airportLargeByRectQuery = nullptr;
 
-  delete runwayOverviewQuery;
-  runwayOverviewQuery = nullptr;
-
   delete vorsByRectQuery;
   vorsByRectQuery = nullptr;
   delete ndbsByRectQuery;
   ndbsByRectQuery = nullptr;
-  delete markersByRectQuery;
-  markersByRectQuery = nullptr;
   delete ilsByRectQuery;
   ilsByRectQuery = nullptr;
 
-  delete userdataPointByRectQuery;
-  userdataPointByRectQuery = nullptr;
 
   delete vorByIdentQuery;
   vorByIdentQuery = nullptr;
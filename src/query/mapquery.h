@@ -19,8 +19,10 @@
 #define LITTLENAVMAP_MAPQUERY_H
 
 #include "query/querytypes.h"
+#include "query/spatialindex.h"
 
 #include <QCache>
+#include <QSet>
 
 namespace map {
 struct MapResult;
@@ -104,6 +106,11 @@ public:
                            const QString& ident, const QString& region,
                            const QString& airport, bool airportFromNavDatabase);
 
+  /* Get map objects for all given idents at once. VOR, NDB and waypoints are fetched with a single
+   * query per table instead of one query per ident. Airports and airways are resolved with the
+   * prepared queries per ident. Results are stored in the hash keyed by ident. */
+  void getMapObjectsByIdents(QHash<QString, map::MapResult>& results, map::MapTypes type, const QSet<QString>& idents);
+
   /*
    * Get a map object by type and id
    * @param result will receive objects based on type
@@ -160,24 +167,34 @@ public:
   /* Similar to getAirports */
   const QList<map::MapIls> *getIls(Marble::GeoDataLatLonBox rect, const MapLayer *mapLayer, bool lazy);
 
-  /* Get a partially filled runway list for the overview */
+  /* Get a partially filled runway list for the overview. Served from an in-memory
+   * index holding the lists for all airports. */
   const QList<map::MapRunway> *getRunwaysForOverview(int airportId);
 
-  /* Similar to getAirports but no caching since user points can change */
+  /* Similar to getAirports but served from an in-memory index which is invalidated on changes */
   const QList<map::MapUserpoint> getUserdataPoints(const Marble::GeoDataLatLonBox& rect, const QStringList& types,
                                                    const QStringList& typesAll,
                                                    bool unknownType, float distance);
 
-  /* Close all query objects thus disconnecting from the database */
+  /* Drop the userpoint index so it is rebuilt on the next map draw.
+   * Called by UserdataController after adding, changing or deleting userpoints. */
+  void invalidateUserpointIndex();
+
+  /* Invalidate all queries and clear the caches. The statements are prepared lazily on
+   * first use which makes switching between simulator and navdata databases fast. */
   void initQueries();
 
-  /* Create and prepare all queries */
+  /* Close all query objects thus disconnecting from the database */
   void deInitQueries();
 
   bool hasAnyArrivalProcedures(const map::MapAirport& airport);
   bool hasDepartureProcedures(const map::MapAirport& airport);
 
 private:
+  /* Create and prepare all queries. Called on first access after construction or a database switch. */
+  void initQueriesInternal();
+  void ensureQueries();
+
   map::MapResultIndex *nearestNavaidsInternal(const atools::geo::Pos& pos, float distanceNm,
                                                     map::MapTypes type, int maxIls, float maxIlsDist);
 
@@ -187,8 +204,20 @@ private:
                                 float maxDistance, bool airportFromNavDatabase);
 
   const QList<map::MapAirport> *fetchAirports(const Marble::GeoDataLatLonBox& rect,
-                                              atools::sql::SqlQuery *query,
-                                              bool lazy, bool overview);
+                                              query::SpatialGridIndex<map::MapAirport>& index,
+                                              const QString& table, bool lazy, bool overview,
+                                              const query::SpatialGridIndex<map::MapAirport>::FilterFunc& filter);
+
+  /* Load whole table into the respective spatial index once after a database switch */
+  void loadAirportIndex(query::SpatialGridIndex<map::MapAirport>& index, const QString& table, bool overview);
+  void loadVorIndex();
+  void loadNdbIndex();
+  void loadMarkerIndex();
+  void loadIlsIndex();
+
+  /* Load the runway overview lists for all airports with one query */
+  void loadRunwayOverviewIndex();
+  void loadUserpointIndex();
   QVector<map::MapIls> ilsByAirportAndRunway(const QString& airportIdent, const QString& runway);
 
   void runwayEndByNameFuzzy(QList<map::MapRunwayEnd>& runwayEnds, const QString& name, const map::MapAirport& airport,
@@ -197,6 +226,17 @@ private:
   MapTypesFactory *mapTypesFactory;
   atools::sql::SqlDatabase *dbSim, *dbNav, *dbUser;
 
+  /* In-memory spatial indexes built once per database load. Serve all rect queries
+   * from memory while SQL remains in place for detail and id lookups. */
+  query::SpatialGridIndex<map::MapAirport> airportIndex, airportMediumIndex, airportLargeIndex;
+  query::SpatialGridIndex<map::MapVor> vorIndex;
+  query::SpatialGridIndex<map::MapNdb> ndbIndex;
+  query::SpatialGridIndex<map::MapMarker> markerIndex;
+  query::SpatialGridIndex<map::MapIls> ilsIndex;
+
+  /* Unlike the indexes above this one is additionally invalidated by UserdataController on edits */
+  query::SpatialGridIndex<map::MapUserpoint> userpointIndex;
+
   /* Simple bounding rectangle caches */
   query::SimpleRectCache<map::MapAirport> airportCache;
   query::SimpleRectCache<map::MapUserpoint> userpointCache;
@@ -206,18 +246,23 @@ private:
   query::SimpleRectCache<map::MapIls> ilsCache;
 
   /* ID/object caches */
-  QCache<int, QList<map::MapRunway> > runwayOverwiewCache;
   QCache<query::NearestCacheKeyNavaid, map::MapResultIndex> nearestNavaidCache;
 
+  /* Compact runway records for the overview resident for all airports - a few MB.
+   * Loaded once on first use and dropped on database switch. */
+  QHash<int, QList<map::MapRunway> > runwayOverviewIndex;
+  bool runwayOverviewIndexLoaded = false;
+
   static int queryMaxRows;
 
+  /* false after construction or a database switch until the statements were prepared */
+  bool queriesPrepared = false;
+
   /* Database queries */
-  atools::sql::SqlQuery *runwayOverviewQuery = nullptr,
-                        *airportByRectQuery = nullptr, *airportMediumByRectQuery = nullptr,
+  atools::sql::SqlQuery *airportByRectQuery = nullptr, *airportMediumByRectQuery = nullptr,
                         *airportLargeByRectQuery = nullptr;
 
-  atools::sql::SqlQuery *vorsByRectQuery = nullptr, *ndbsByRectQuery = nullptr, *markersByRectQuery = nullptr,
-                        *ilsByRectQuery = nullptr, *userdataPointByRectQuery = nullptr;
+  atools::sql::SqlQuery *vorsByRectQuery = nullptr, *ndbsByRectQuery = nullptr, *ilsByRectQuery = nullptr;
 
   atools::sql::SqlQuery *vorByIdentQuery = nullptr, *ndbByIdentQuery = nullptr, *ilsByIdentQuery = nullptr;
 
@@ -1862,6 +1862,9 @@ void ProcedureQuery::initQueries()
 
   transitionIdsForApproachQuery = new SqlQuery(dbNav);
   transitionIdsForApproachQuery->prepare("select transition_id from transition where approach_id = :id");
+
+  approachIdsForAirportQuery = new SqlQuery(dbNav);
+  approachIdsForAirportQuery->prepare("select approach_id from approach where airport_ident = :apident");
 }
 
 void ProcedureQuery::deInitQueries()
@@ -1903,6 +1906,9 @@ void ProcedureQuery::deInitQueries()
 
   delete transitionIdsForApproachQuery;
   transitionIdsForApproachQuery = nullptr;
+
+  delete approachIdsForAirportQuery;
+  approachIdsForAirportQuery = nullptr;
 }
 
 void ProcedureQuery::clearFlightplanProcedureProperties(QHash<QString, QString>& properties,
@@ -2177,6 +2183,22 @@ QVector<int> ProcedureQuery::getTransitionIdsForApproach(int approachId)
   return transitionIds;
 }
 
+QVector<int> ProcedureQuery::getApproachIdsForAirport(map::MapAirport airport)
+{
+  QVector<int> approachIds;
+
+  mapQuery->getAirportNavReplace(airport);
+  if(!airport.isValid())
+    return approachIds;
+
+  approachIdsForAirportQuery->bindValue(":apident", airport.ident);
+  approachIdsForAirportQuery->exec();
+
+  while(approachIdsForAirportQuery->next())
+    approachIds.append(approachIdsForAirportQuery->value("approach_id").toInt());
+  return approachIds;
+}
+
 void ProcedureQuery::getLegsForFlightplanProperties(const QHash<QString, QString> properties,
                                                     const map::MapAirport& departure,
                                                     const map::MapAirport& destination,
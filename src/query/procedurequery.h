@@ -64,6 +64,10 @@ public:
 
   QVector<int> getTransitionIdsForApproach(int approachId);
 
+  /* Get all approach ids for an airport. Used to preload the procedure cache for the
+   * flight plan airports while the event loop is idle. */
+  QVector<int> getApproachIdsForAirport(map::MapAirport airport);
+
   void getLegsForFlightplanProperties(const QHash<QString, QString> properties,
                                       const map::MapAirport& departure,
                                       const map::MapAirport& destination,
@@ -187,7 +191,8 @@ private:
                         *transitionIdForLegQuery = nullptr, *approachIdForTransQuery = nullptr,
                         *runwayEndIdQuery = nullptr, *transitionQuery = nullptr, *approachQuery = nullptr,
                         *transitionIdByNameQuery = nullptr, *approachIdByNameQuery = nullptr,
-                        *approachIdByArincNameQuery = nullptr, *transitionIdsForApproachQuery = nullptr;
+                        *approachIdByArincNameQuery = nullptr, *transitionIdsForApproachQuery = nullptr,
+                        *approachIdsForAirportQuery = nullptr;
 
   /* approach ID and transition ID to full lists
    * The approach also has to be stored for transitions since the handover can modify approach legs (CI legs, etc.) */
@@ -17,6 +17,8 @@
 
 #include "query/querytypes.h"
 
+#include "common/constants.h"
+#include "settings/settings.h"
 #include "sql/sqlquery.h"
 #include "geo/rect.h"
 
@@ -24,6 +26,15 @@ using namespace Marble;
 
 namespace query {
 
+int cacheSize(atools::settings::Settings& settings, const QString& key, int defaultSize)
+{
+  // Global factor in percent scaling all query caches - 100 keeps the defaults
+  int factor = settings.getAndStoreValue(lnm::SETTINGS_QUERY_CACHE_SIZE_PERCENT, 100).toInt();
+
+  // Do not let caches collapse completely on bogus settings
+  return std::max(10, settings.getAndStoreValue(key, defaultSize).toInt() * factor / 100);
+}
+
 void inflateQueryRect(Marble::GeoDataLatLonBox& rect, double factor, double increment)
 {
   rect.scale(1. + factor, 1. + factor);
@@ -33,6 +33,9 @@ namespace atools {
 namespace geo {
 class Rect;
 }
+namespace settings {
+class Settings;
+}
 namespace sql {
 class SqlQuery;
 }
@@ -55,6 +58,11 @@ QList<Marble::GeoDataLatLonBox> splitAtAntiMeridian(const Marble::GeoDataLatLonB
 /* Inflate rect by width and height in degrees. If it crosses the poles or date line it will be limited */
 void inflateQueryRect(Marble::GeoDataLatLonBox& rect, double factor, double increment);
 
+/* Cache size for the given settings key scaled by the global percent factor from
+ * lnm::SETTINGS_QUERY_CACHE_SIZE_PERCENT. Allows to shrink or grow all query caches together on
+ * machines with little or plenty of memory. The per-cache keys keep working for fine tuning. */
+int cacheSize(atools::settings::Settings& settings, const QString& key, int defaultSize);
+
 template<typename ID>
 const atools::sql::SqlRecord *cachedRecord(QCache<ID, atools::sql::SqlRecord>& cache,
                                            atools::sql::SqlQuery *query, ID id);
@@ -78,6 +86,11 @@ struct SimpleRectCache
   bool updateCache(const Marble::GeoDataLatLonBox& rect, const MapLayer *mapLayer, double factor, double increment,
                    bool lazy,
                    LayerCompareFunc funcSameLayer);
+
+  /* True if the cached list does not cover the given rectangle or layer and a non-lazy
+   * updateCache() would clear it for a reload */
+  bool needsUpdate(const Marble::GeoDataLatLonBox& rect, const MapLayer *mapLayer, double factor, double increment,
+                   LayerCompareFunc funcSameLayer) const;
   void clear();
   void validate(int queryMaxRows);
 
@@ -115,6 +128,23 @@ bool SimpleRectCache<TYPE>::updateCache(const Marble::GeoDataLatLonBox& rect, co
   return false;
 }
 
+template<typename TYPE>
+bool SimpleRectCache<TYPE>::needsUpdate(const Marble::GeoDataLatLonBox& rect, const MapLayer *mapLayer, double factor,
+                                        double increment, LayerCompareFunc funcSameLayer) const
+{
+  // Same check as in updateCache() but without modifying the cache
+  Marble::GeoDataLatLonBox cur(curRect);
+  query::inflateQueryRect(cur, factor, increment);
+#ifndef DEBUG_DISABLE_RECT_CACHE
+  return curRect.isEmpty() || !cur.contains(rect) || !funcSameLayer(curMapLayer, mapLayer);
+
+#else
+  Q_UNUSED(funcSameLayer)
+  return true;
+
+#endif
+}
+
 template<typename TYPE>
 void SimpleRectCache<TYPE>::validate(int queryMaxRows)
 {
@@ -0,0 +1,198 @@
+/*****************************************************************************
+* Copyright 2015-2020 Alexander Barthel alex@littlenavmap.org
+*
+* This program is free software: you can redistribute it and/or modify
+* it under the terms of the GNU General Public License as published by
+* the Free Software Foundation, either version 3 of the License, or
+* (at your option) any later version.
+*
+* This program is distributed in the hope that it will be useful,
+* but WITHOUT ANY WARRANTY; without even the implied warranty of
+* MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+* GNU General Public License for more details.
+*
+* You should have received a copy of the GNU General Public License
+* along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*****************************************************************************/
+
+#ifndef LNM_SPATIALINDEX_H
+#define LNM_SPATIALINDEX_H
+
+#include "geo/pos.h"
+#include "geo/rect.h"
+
+#include <QList>
+#include <QVector>
+
+#include <functional>
+#include <cmath>
+
+#include <marble/GeoDataLatLonBox.h>
+
+namespace query {
+
+/*
+ * Simple packed-grid spatial index over map objects having a getPosition() method.
+ *
+ * Objects are loaded once after a database switch and kept in one-degree grid cells so
+ * all bounding rectangle queries for the map can be served from memory without hitting
+ * the database. The database remains the source for detail fields not kept in the types.
+ */
+template<typename TYPE>
+class SpatialGridIndex
+{
+public:
+  /* Optional filter callback. Return false to drop an object from the result. */
+  typedef std::function<bool (const TYPE&)> FilterFunc;
+
+  /* Add object while building the index. */
+  void append(const TYPE& obj);
+
+  /* Mark index as completely loaded. */
+  void finishBuilding()
+  {
+    valid = true;
+  }
+
+  /* true if the index was fully loaded and can serve queries */
+  bool isValid() const
+  {
+    return valid;
+  }
+
+  int size() const
+  {
+    return objects.size();
+  }
+
+  /* All objects in loading order. Positions kept in secondary indexes refer to this vector. */
+  const QVector<TYPE>& getObjects() const
+  {
+    return objects;
+  }
+
+  /* Remove all objects. Index has to be rebuilt before using it again. */
+  void clear();
+
+  /*
+   * Collect all objects inside the rectangle. The rectangle has to be inflated by the
+   * caller if needed. Deals with rectangles crossing the anti-meridian.
+   * @param result receives matching objects - not cleared before
+   * @param maxRows stop collecting after this number of objects in result
+   * @param filter optional callback that can reject objects
+   */
+  void query(const Marble::GeoDataLatLonBox& rect, QList<TYPE>& result, int maxRows,
+             const FilterFunc& filter = nullptr) const;
+
+  /* Overload for the atools rectangle used by the queries outside of the map painters */
+  void query(const atools::geo::Rect& rect, QList<TYPE>& result, int maxRows,
+             const FilterFunc& filter = nullptr) const;
+
+private:
+  /* One degree cells - x from 0 (180 west) to 359 and y from 0 (90 south) to 179 */
+  Q_DECL_CONSTEXPR static int GRID_LON = 360, GRID_LAT = 180;
+
+  static int cellX(float lonx)
+  {
+    return qBound(0, static_cast<int>(std::floor(lonx)) + 180, GRID_LON - 1);
+  }
+
+  static int cellY(float laty)
+  {
+    return qBound(0, static_cast<int>(std::floor(laty)) + 90, GRID_LAT - 1);
+  }
+
+  void queryCells(int xMin, int xMax, int yMin, int yMax, double west, double east, double south, double north,
+                  QList<TYPE>& result, int maxRows, const FilterFunc& filter) const;
+
+  QVector<TYPE> objects;
+  QVector<QVector<int> > cells = QVector<QVector<int> >(GRID_LON * GRID_LAT);
+  bool valid = false;
+};
+
+// ---------------------------------------------------------------------------------
+
+template<typename TYPE>
+void SpatialGridIndex<TYPE>::append(const TYPE& obj)
+{
+  const atools::geo::Pos& pos = obj.getPosition();
+  if(!pos.isValid())
+    return;
+
+  objects.append(obj);
+  cells[cellY(pos.getLatY()) * GRID_LON + cellX(pos.getLonX())].append(objects.size() - 1);
+}
+
+template<typename TYPE>
+void SpatialGridIndex<TYPE>::clear()
+{
+  objects.clear();
+  cells.clear();
+  cells.resize(GRID_LON * GRID_LAT);
+  valid = false;
+}
+
+template<typename TYPE>
+void SpatialGridIndex<TYPE>::query(const Marble::GeoDataLatLonBox& rect, QList<TYPE>& result, int maxRows,
+                                   const FilterFunc& filter) const
+{
+  double north = rect.north(Marble::GeoDataCoordinates::Degree),
+         south = rect.south(Marble::GeoDataCoordinates::Degree),
+         east = rect.east(Marble::GeoDataCoordinates::Degree),
+         west = rect.west(Marble::GeoDataCoordinates::Degree);
+
+  int yMin = cellY(static_cast<float>(south)), yMax = cellY(static_cast<float>(north));
+
+  if(west <= east)
+    queryCells(cellX(static_cast<float>(west)), cellX(static_cast<float>(east)), yMin, yMax,
+               west, east, south, north, result, maxRows, filter);
+  else
+  {
+    // Crossing the anti-meridian - query in two parts
+    queryCells(cellX(static_cast<float>(west)), GRID_LON - 1, yMin, yMax,
+               west, 180., south, north, result, maxRows, filter);
+    queryCells(0, cellX(static_cast<float>(east)), yMin, yMax,
+               -180., east, south, north, result, maxRows, filter);
+  }
+}
+
+template<typename TYPE>
+void SpatialGridIndex<TYPE>::query(const atools::geo::Rect& rect, QList<TYPE>& result, int maxRows,
+                                   const FilterFunc& filter) const
+{
+  query(Marble::GeoDataLatLonBox(rect.getNorth(), rect.getSouth(), rect.getEast(), rect.getWest(),
+                                 Marble::GeoDataCoordinates::Degree), result, maxRows, filter);
+}
+
+template<typename TYPE>
+void SpatialGridIndex<TYPE>::queryCells(int xMin, int xMax, int yMin, int yMax,
+                                        double west, double east, double south, double north,
+                                        QList<TYPE>& result, int maxRows, const FilterFunc& filter) const
+{
+  for(int y = yMin; y <= yMax; y++)
+  {
+    for(int x = xMin; x <= xMax; x++)
+    {
+      for(int idx : cells.at(y * GRID_LON + x))
+      {
+        if(result.size() >= maxRows)
+          return;
+
+        const TYPE& obj = objects.at(idx);
+        const atools::geo::Pos& pos = obj.getPosition();
+
+        if(pos.getLatY() < south || pos.getLatY() > north || pos.getLonX() < west || pos.getLonX() > east)
+          continue;
+
+        if(filter && !filter(obj))
+          continue;
+
+        result.append(obj);
+      }
+    }
+  }
+}
+
+} // namespace query
+
+#endif // LNM_SPATIALINDEX_H
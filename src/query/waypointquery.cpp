@@ -47,7 +47,7 @@ WaypointQuery::WaypointQuery(SqlDatabase *sqlDbNav, bool trackDatabaseParam)
   queryMaxRows = settings.getAndStoreValue(
     lnm::SETTINGS_MAPQUERY + "QueryRowLimit", 5000).toInt();
 
-  waypointInfoCache.setMaxCost(settings.getAndStoreValue(lnm::SETTINGS_INFOQUERY + "WaypointCache", 100).toInt());
+  waypointInfoCache.setMaxCost(query::cacheSize(settings, lnm::SETTINGS_INFOQUERY + "WaypointCache", 100));
 }
 
 WaypointQuery::~WaypointQuery()
@@ -58,6 +58,8 @@ WaypointQuery::~WaypointQuery()
 
 map::MapWaypoint WaypointQuery::getWaypointById(int id)
 {
+  ensureQueries();
+
   map::MapWaypoint wp;
   waypointByIdQuery->bindValue(":id", id);
   waypointByIdQuery->exec();
@@ -70,29 +72,55 @@ map::MapWaypoint WaypointQuery::getWaypointById(int id)
 void WaypointQuery::getWaypointByByIdent(QList<map::MapWaypoint>& waypoints, const QString& ident,
                                          const QString& region)
 {
-  waypointByIdentQuery->bindValue(":ident", ident);
-  waypointByIdentQuery->bindValue(":region", region.isEmpty() ? "%" : region);
-  waypointByIdentQuery->exec();
-  while(waypointByIdentQuery->next())
+  if(!waypointIndex.isValid())
+    loadWaypointIndex();
+
+  const QVector<map::MapWaypoint>& objects = waypointIndex.getObjects();
+
+  // Find the first entry for the ident by binary search in the sorted position vector
+  QVector<int>::const_iterator it =
+    std::lower_bound(identIndex.constBegin(), identIndex.constEnd(), ident,
+                     [&objects](int index, const QString& str) -> bool
   {
-    map::MapWaypoint wp;
-    mapTypesFactory->fillWaypoint(waypointByIdentQuery->record(), wp, trackDatabase);
-    waypoints.append(wp);
+    return objects.at(index).ident < str;
+  });
+
+  for(; it != identIndex.constEnd() && objects.at(*it).ident == ident; ++it)
+  {
+    const map::MapWaypoint& wp = objects.at(*it);
+    if(region.isEmpty() || wp.region == region)
+      waypoints.append(wp);
+  }
+}
+
+void WaypointQuery::getWaypointsByIdents(QHash<QString, QList<map::MapWaypoint> >& waypoints,
+                                         const QSet<QString>& idents)
+{
+  for(const QString& ident : idents)
+  {
+    QList<map::MapWaypoint> found;
+    getWaypointByByIdent(found, ident);
+    if(!found.isEmpty())
+      waypoints[ident].append(found);
   }
 }
 
 void WaypointQuery::getWaypointNearest(map::MapWaypoint& waypoint, const Pos& pos)
 {
+  ensureQueries();
+
   waypointNearestQuery->bindValue(":lonx", pos.getLonX());
   waypointNearestQuery->bindValue(":laty", pos.getLatY());
   waypointNearestQuery->exec();
   if(waypointNearestQuery->next())
-    mapTypesFactory->fillWaypoint(waypointNearestQuery->record(), waypoint, trackDatabase);
+    mapTypesFactory->fillWaypoint(*waypointNearestQuery, waypoint, trackDatabase);
   waypointNearestQuery->finish();
 }
 
 void WaypointQuery::getWaypointsRect(QVector<map::MapWaypoint>& waypoints, const Pos& pos, float distanceNm)
 {
+  ensureQueries();
+
   for(Rect r : Rect(pos, nmToMeter(distanceNm)).splitAtAntiMeridian())
   {
     query::bindRect(r, waypointRectQuery);
@@ -100,7 +128,7 @@ void WaypointQuery::getWaypointsRect(QVector<map::MapWaypoint>& waypoints, const
     while(waypointRectQuery->next())
     {
       map::MapWaypoint waypoint;
-      mapTypesFactory->fillWaypoint(waypointRectQuery->record(), waypoint, trackDatabase);
+      mapTypesFactory->fillWaypoint(*waypointRectQuery, waypoint, trackDatabase);
       waypoints.append(waypoint);
     }
   }
@@ -127,35 +155,85 @@ const QList<map::MapWaypoint> *WaypointQuery::getWaypoints(const GeoDataLatLonBo
 
   if(waypointCache.list.isEmpty() && !lazy)
   {
-    for(const GeoDataLatLonBox& r :
-        query::splitAtAntiMeridian(rect, queryRectInflationFactor, queryRectInflationIncrement))
+    if(!waypointIndex.isValid())
+      loadWaypointIndex();
+
+    GeoDataLatLonBox cur(rect);
+    query::inflateQueryRect(cur, queryRectInflationFactor, queryRectInflationIncrement);
+    waypointIndex.query(cur, waypointCache.list, queryMaxRows);
+
+    // Sort by importance so the airway and track waypoints are painted first and lone
+    // waypoints are the ones dropped when the painter runs out of its object budget
+    std::sort(waypointCache.list.begin(), waypointCache.list.end(),
+              [](const map::MapWaypoint& waypoint1, const map::MapWaypoint& waypoint2) -> bool
     {
-      query::bindRect(r, waypointsByRectQuery);
-      waypointsByRectQuery->exec();
-      while(waypointsByRectQuery->next())
-      {
-        map::MapWaypoint wp;
-        mapTypesFactory->fillWaypoint(waypointsByRectQuery->record(), wp, trackDatabase);
-        waypointCache.list.append(wp);
-      }
-    }
+      return (waypoint1.hasTracks + waypoint1.hasJetAirways + waypoint1.hasVictorAirways) >
+             (waypoint2.hasTracks + waypoint2.hasJetAirways + waypoint2.hasVictorAirways);
+    });
   }
   waypointCache.validate(queryMaxRows);
   return &waypointCache.list;
 }
 
+void WaypointQuery::loadWaypointIndex()
+{
+  QString table = trackDatabase ? "trackpoint" : "waypoint";
+  QString id = trackDatabase ? "trackpoint_id" : "waypoint_id";
+
+  QString waypointQueryBase(id + ", ident, region, type, num_victor_airway, num_jet_airway, mag_var, lonx, laty ");
+  if(atools::sql::SqlUtil(dbNav).hasTableAndColumn("waypoint", "artificial"))
+    waypointQueryBase.append(", artificial");
+
+  SqlQuery query(dbNav);
+  query.exec("select " + waypointQueryBase + " from " + table);
+  while(query.next())
+  {
+    map::MapWaypoint wp;
+    mapTypesFactory->fillWaypoint(query, wp, trackDatabase);
+    waypointIndex.append(wp);
+  }
+  waypointIndex.finishBuilding();
+
+  // Build the flat ident index which serves all ident lookups with binary search
+  const QVector<map::MapWaypoint>& objects = waypointIndex.getObjects();
+  identIndex.clear();
+  identIndex.reserve(objects.size());
+  for(int i = 0; i < objects.size(); i++)
+    identIndex.append(i);
+
+  std::sort(identIndex.begin(), identIndex.end(), [&objects](int index1, int index2) -> bool
+  {
+    const map::MapWaypoint& w1 = objects.at(index1), & w2 = objects.at(index2);
+
+    if(w1.ident == w2.ident)
+      // Disambiguate by region for stable ordering
+      return w1.region < w2.region;
+
+    return w1.ident < w2.ident;
+  });
+
+  qDebug() << Q_FUNC_INFO << table << waypointIndex.size() << "waypoints";
+}
+
 void WaypointQuery::getNearestScreenObjects(const CoordinateConverter& conv, const MapLayer *mapLayer,
                                             map::MapTypes types, int xs, int ys,
                                             int screenDistance, map::MapResult& result)
 {
   int x, y;
 
+  // Reject waypoints by world coordinates before the expensive screen projection
+  atools::geo::Rect filterRect = maptools::screenToWorldRect(conv, xs, ys, screenDistance);
+  auto nearCursor = [&filterRect](const atools::geo::Pos& pos) -> bool
+  {
+    return !filterRect.isValid() || filterRect.contains(pos);
+  };
+
   if(mapLayer->isWaypoint() && types.testFlag(map::WAYPOINT))
   {
     for(int i = waypointCache.list.size() - 1; i >= 0; i--)
     {
       const MapWaypoint& wp = waypointCache.list.at(i);
-      if(conv.wToS(wp.position, x, y))
+      if(nearCursor(wp.position) && conv.wToS(wp.position, x, y))
         if((atools::geo::manhattanDistance(x, y, xs, ys)) < screenDistance)
           maptools::insertSortedByDistance(conv, result.waypoints, &result.waypointIds, xs, ys, wp);
     }
@@ -171,7 +249,7 @@ void WaypointQuery::getNearestScreenObjects(const CoordinateConverter& conv, con
       if((wp.hasVictorAirways && types.testFlag(map::AIRWAYV)) ||
          (wp.hasJetAirways && types.testFlag(map::AIRWAYJ)) ||
          (wp.hasTracks && types.testFlag(map::TRACK)))
-        if(conv.wToS(wp.position, x, y))
+        if(nearCursor(wp.position) && conv.wToS(wp.position, x, y))
           if((atools::geo::manhattanDistance(x, y, xs, ys)) < screenDistance)
             maptools::insertSortedByDistance(conv, result.waypoints, &result.waypointIds, xs, ys, wp);
     }
@@ -180,11 +258,26 @@ void WaypointQuery::getNearestScreenObjects(const CoordinateConverter& conv, con
 
 const atools::sql::SqlRecord *WaypointQuery::getWaypointInformation(int waypointId)
 {
+  ensureQueries();
+
   waypointInfoQuery->bindValue(":id", waypointId);
   return query::cachedRecord(waypointInfoCache, waypointInfoQuery, waypointId);
 }
 
 void WaypointQuery::initQueries()
+{
+  // Delete all statements and invalidate the caches only. The statements are prepared again
+  // by ensureQueries() on first access which keeps database switches fast.
+  deInitQueries();
+}
+
+void WaypointQuery::ensureQueries()
+{
+  if(!queriesPrepared)
+    initQueriesInternal();
+}
+
+void WaypointQuery::initQueriesInternal()
 {
   QString table = trackDatabase ? "trackpoint" : "waypoint";
   QString id = trackDatabase ? "trackpoint_id" : "waypoint_id";
@@ -192,7 +285,6 @@ void WaypointQuery::initQueries()
 
   // Common where clauses
   static const QString whereRect("lonx between :leftx and :rightx and laty between :bottomy and :topy");
-  static const QString whereIdentRegion("ident = :ident and region like :region");
   static const QString whereLimit("limit " + QString::number(queryMaxRows));
 
   // Common select statements
@@ -203,9 +295,6 @@ void WaypointQuery::initQueries()
 
   deInitQueries();
 
-  waypointByIdentQuery = new SqlQuery(dbNav);
-  waypointByIdentQuery->prepare("select " + waypointQueryBase + " from " + table + " where " + whereIdentRegion);
-
   // Get nearest Waypoint
   waypointNearestQuery = new SqlQuery(dbNav);
   waypointNearestQuery->prepare(
@@ -232,18 +321,19 @@ void WaypointQuery::initQueries()
                                "join bgl_file on waypoint.file_id = bgl_file.bgl_file_id "
                                "join scenery_area on bgl_file.scenery_area_id = scenery_area.scenery_area_id "
                                "where waypoint_id = :id");
+
+  queriesPrepared = true;
 }
 
 void WaypointQuery::deInitQueries()
 {
+  queriesPrepared = false;
+
   clearCache();
 
   delete waypointsByRectQuery;
   waypointsByRectQuery = nullptr;
 
-  delete waypointByIdentQuery;
-  waypointByIdentQuery = nullptr;
-
   delete waypointNearestQuery;
   waypointNearestQuery = nullptr;
 
@@ -259,6 +349,8 @@ void WaypointQuery::deInitQueries()
 
 void WaypointQuery::clearCache()
 {
+  waypointIndex.clear();
+  identIndex.clear();
   waypointCache.clear();
   waypointInfoCache.clear();
 }
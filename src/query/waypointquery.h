@@ -19,8 +19,10 @@
 #define LITTLENAVMAP_WAYPOINTQUERY_H
 
 #include "query/querytypes.h"
+#include "query/spatialindex.h"
 
 #include <QCache>
+#include <QSet>
 
 namespace map {
 struct MapResult;
@@ -47,10 +49,14 @@ public:
   /* Get one by database id */
   map::MapWaypoint getWaypointById(int id);
 
-  /* Get a list of matching points for ident and optionally region. */
+  /* Get a list of matching points for ident and optionally region. Served from the in-memory
+   * ident index by binary search without hitting the database. */
   void getWaypointByByIdent(QList<map::MapWaypoint>& waypoints, const QString& ident,
                             const QString& region = QString());
 
+  /* Get all waypoints for the given idents. Appends to the lists in the hash keyed by ident. */
+  void getWaypointsByIdents(QHash<QString, QList<map::MapWaypoint> >& waypoints, const QSet<QString>& idents);
+
   /* Get nearest waypoint by screen coordinates for types and given map layer. */
   void getNearestScreenObjects(const CoordinateConverter& conv, const MapLayer *mapLayer, map::MapTypes types,
                                int xs, int ys, int screenDistance, map::MapResult& result);
@@ -70,23 +76,40 @@ public:
   /* Get record for joined tables waypoint, bgl_file and scenery_area */
   const atools::sql::SqlRecord *getWaypointInformation(int waypointId);
 
-  /* Close all query objects thus disconnecting from the database */
+  /* Invalidate all queries and clear the caches. The statements are prepared lazily on
+   * first use which makes switching between simulator and navdata databases fast. */
   void initQueries();
 
-  /* Create and prepare all queries */
+  /* Close all query objects thus disconnecting from the database */
   void deInitQueries();
 
-  atools::sql::SqlQuery *getWaypointsByRectQuery() const
+  /* Prepares the statements if not done already */
+  atools::sql::SqlQuery *getWaypointsByRectQuery()
   {
+    ensureQueries();
     return waypointsByRectQuery;
   }
 
   void clearCache();
 
 private:
+  /* Create and prepare all queries. Called on first access after construction or a database switch. */
+  void initQueriesInternal();
+  void ensureQueries();
+
   MapTypesFactory *mapTypesFactory;
   atools::sql::SqlDatabase *dbNav;
 
+  /* Load whole waypoint table into the spatial index once after a database switch */
+  void loadWaypointIndex();
+
+  /* In-memory spatial index built once per database load serving all rect queries */
+  query::SpatialGridIndex<map::MapWaypoint> waypointIndex;
+
+  /* Positions into the spatial index objects sorted by ident and region. Serves exact ident
+   * lookups with binary search which route string parsing calls for every plan element. */
+  QVector<int> identIndex;
+
   /* Simple bounding rectangle caches */
   query::SimpleRectCache<map::MapWaypoint> waypointCache;
   QCache<int, atools::sql::SqlRecord> waypointInfoCache;
@@ -95,9 +118,12 @@ private:
 
   bool trackDatabase;
 
+  /* false after construction or a database switch until the statements were prepared */
+  bool queriesPrepared = false;
+
   /* Database queries */
   atools::sql::SqlQuery *waypointByIdQuery = nullptr, *waypointNearestQuery = nullptr, *waypointRectQuery = nullptr,
-                        *waypointByIdentQuery = nullptr, *waypointsByRectQuery = nullptr, *waypointInfoQuery = nullptr;
+                        *waypointsByRectQuery = nullptr, *waypointInfoQuery = nullptr;
 };
 
 #endif // LITTLENAVMAP_WAYPOINTQUERY_H
@@ -57,6 +57,19 @@ void WaypointTrackQuery::getWaypointByIdent(QList<map::MapWaypoint>& waypoints,
   copy(navWaypoints, waypoints);
 }
 
+void WaypointTrackQuery::getWaypointsByIdents(QHash<QString, QList<map::MapWaypoint> >& waypoints,
+                                              const QSet<QString>& idents)
+{
+  if(useTracks)
+    trackQuery->getWaypointsByIdents(waypoints, idents);
+
+  QHash<QString, QList<map::MapWaypoint> > navWaypoints;
+  waypointQuery->getWaypointsByIdents(navWaypoints, idents);
+
+  for(auto it = navWaypoints.constBegin(); it != navWaypoints.constEnd(); ++it)
+    copy(it.value(), waypoints[it.key()]);
+}
+
 void WaypointTrackQuery::getNearestScreenObjects(const CoordinateConverter& conv, const MapLayer *mapLayer,
                                                  map::MapTypes types, int xs,
                                                  int ys, int screenDistance, map::MapResult& result)
@@ -20,6 +20,8 @@
 
 #include "query/querytypes.h"
 
+#include <QSet>
+
 namespace map {
 struct MapResult;
 }
@@ -66,6 +68,10 @@ public:
   void getWaypointByIdent(QList<map::MapWaypoint>& waypoints, const QString& ident,
                           const QString& region = QString());
 
+  /* Get all waypoints for the given idents with one query per database.
+   * Results are appended to the lists in the hash keyed by ident. */
+  void getWaypointsByIdents(QHash<QString, QList<map::MapWaypoint> >& waypoints, const QSet<QString>& idents);
+
   /* Get nearest waypoint by screen coordinates for types and given map layer. */
   void getNearestScreenObjects(const CoordinateConverter& conv, const MapLayer *mapLayer, map::MapTypes types,
                                int xs, int ys,
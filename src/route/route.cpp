@@ -56,6 +56,7 @@ const static RouteLeg EMPTY_ROUTELEG;
 Route::Route()
 {
   resetActive();
+  flightplan = std::make_shared<atools::fs::pln::Flightplan>();
   altitude = new RouteAltitude(this);
 }
 
@@ -77,6 +78,19 @@ Route& Route::operator=(const Route& other)
   return *this;
 }
 
+void Route::detachFlightplan()
+{
+  if(flightplan.use_count() > 1)
+  {
+    // Plan is still shared with other copies of this route - copy it and point the legs to the
+    // copy before modifying it. Other copies keep reading the unchanged instance.
+    flightplan = std::make_shared<atools::fs::pln::Flightplan>(*flightplan);
+
+    for(RouteLeg& routeLeg : *this)
+      routeLeg.setFlightplan(flightplan.get());
+  }
+}
+
 void Route::resetActive()
 {
   activeLegResult.distanceFrom1 =
@@ -90,10 +104,12 @@ void Route::resetActive()
 
 void Route::copy(const Route& other)
 {
-  clear();
-  QList::append(other);
+  QList::operator=(other);
 
   totalDistance = other.totalDistance;
+
+  // Share the plan with the other route. The legs keep pointing to the shared instance which
+  // stays alive until the last copy is gone. detachFlightplan() copies it on the first write.
   flightplan = other.flightplan;
   shownTypes = other.shownTypes;
   boundingRect = other.boundingRect;
@@ -113,10 +129,6 @@ void Route::copy(const Route& other)
   activeLegIndex = other.activeLegIndex;
   activeLegResult = other.activeLegResult;
 
-  // Update flightplan pointers to this instance
-  for(RouteLeg& routeLeg : *this)
-    routeLeg.setFlightplan(&flightplan);
-
   delete altitude;
   altitude = new RouteAltitude(this);
   *altitude = other.altitude->copy(this);
@@ -140,7 +152,7 @@ int Route::getNextUserWaypointNumber() const
 
   int nextNum = 0;
 
-  for(const FlightplanEntry& entry : flightplan.getEntries())
+  for(const FlightplanEntry& entry : flightplan->getEntries())
   {
     if(entry.getWaypointType() == atools::fs::pln::entry::USER)
       nextNum = std::max(QString(USER_WP_ID.match(entry.getIdent()).captured(1)).toInt(), nextNum);
@@ -628,7 +640,7 @@ int Route::getTopOfDescentLegIndex() const
 
 float Route::getCruisingAltitudeFeet() const
 {
-  return Unit::rev(flightplan.getCruisingAltitude(), Unit::altFeetF);
+  return Unit::rev(flightplan->getCruisingAltitude(), Unit::altFeetF);
 }
 
 float Route::getAltitudeForDistance(float currentDistToDest) const
@@ -939,7 +951,7 @@ bool Route::hasValidDestination() const
 {
   int destIdx = getDestinationAirportLegIndex();
   return destIdx != map::INVALID_INDEX_VALUE &&
-         flightplan.getEntries().at(destIdx).getWaypointType() == atools::fs::pln::entry::AIRPORT;
+         flightplan->getEntries().at(destIdx).getWaypointType() == atools::fs::pln::entry::AIRPORT;
 }
 
 bool Route::hasEntries() const
@@ -954,6 +966,8 @@ bool Route::canCalcRoute() const
 
 void Route::removeAlternateLegs()
 {
+  detachFlightplan();
+
   QVector<int> indexes;
 
   // Collect indexes to delete in reverse order
@@ -968,7 +982,7 @@ void Route::removeAlternateLegs()
   for(int i = 0; i < indexes.size(); i++)
   {
     removeAt(indexes.at(i));
-    flightplan.getEntries().removeAt(indexes.at(i));
+    flightplan->getEntries().removeAt(indexes.at(i));
   }
   alternateLegsOffset = map::INVALID_INDEX_VALUE;
   numAlternateLegs = 0;
@@ -1030,12 +1044,16 @@ void Route::removeProcedureLegs(proc::MapProcedureTypes type)
 
 void Route::clearFlightplanProcedureProperties(proc::MapProcedureTypes type)
 {
-  ProcedureQuery::clearFlightplanProcedureProperties(flightplan.getProperties(), type);
+  detachFlightplan();
+
+  ProcedureQuery::clearFlightplanProcedureProperties(flightplan->getProperties(), type);
 }
 
 void Route::clearFlightplanAlternateProperties()
 {
-  flightplan.getProperties().remove(atools::fs::pln::ALTERNATES);
+  detachFlightplan();
+
+  flightplan->getProperties().remove(atools::fs::pln::ALTERNATES);
 }
 
 void Route::updateAlternateProperties()
@@ -1158,6 +1176,8 @@ void Route::cleanupFlightPlanForProcedures()
 void Route::updateProcedureLegs(FlightplanEntryBuilder *entryBuilder, bool clearOldProcedureProperties,
                                 bool cleanupRoute)
 {
+  detachFlightplan();
+
   // Change STAR to connect manual legs to the arrival/approach or airport
   // This can only be done with a copy of the procedures in the route
   NavApp::getProcedureQuery()->postProcessLegsForRoute(starLegs, approachLegs, getDestinationAirportLeg().getAirport());
@@ -1177,11 +1197,11 @@ void Route::updateProcedureLegs(FlightplanEntryBuilder *entryBuilder, bool clear
     // Starts always after departure airport
     sidLegsOffset = 1;
 
-  QList<FlightplanEntry>& entries = flightplan.getEntries();
+  QList<FlightplanEntry>& entries = flightplan->getEntries();
   for(int i = 0; i < sidLegs.size(); i++)
   {
     int insertIndex = 1 + i;
-    RouteLeg obj(&flightplan);
+    RouteLeg obj(flightplan.get());
     obj.createFromProcedureLegs(i, sidLegs, &value(i));
     insert(insertIndex, obj);
 
@@ -1199,7 +1219,7 @@ void Route::updateProcedureLegs(FlightplanEntryBuilder *entryBuilder, bool clear
   {
     const RouteLeg *prev = size() >= 2 ? &value(size() - 2) : nullptr;
 
-    RouteLeg obj(&flightplan);
+    RouteLeg obj(flightplan.get());
     obj.createFromProcedureLegs(i, starLegs, prev);
     insert(size() - insertOffset, obj);
 
@@ -1216,7 +1236,7 @@ void Route::updateProcedureLegs(FlightplanEntryBuilder *entryBuilder, bool clear
   {
     const RouteLeg *prev = size() >= 2 ? &value(size() - 2) : nullptr;
 
-    RouteLeg obj(&flightplan);
+    RouteLeg obj(flightplan.get());
     obj.createFromProcedureLegs(i, approachLegs, prev);
     insert(size() - insertOffset, obj);
 
@@ -1229,23 +1249,27 @@ void Route::updateProcedureLegs(FlightplanEntryBuilder *entryBuilder, bool clear
   if(clearOldProcedureProperties)
     clearFlightplanProcedureProperties(proc::PROCEDURE_ALL);
 
-  ProcedureQuery::fillFlightplanProcedureProperties(flightplan.getProperties(), approachLegs, starLegs, sidLegs);
+  ProcedureQuery::fillFlightplanProcedureProperties(flightplan->getProperties(), approachLegs, starLegs, sidLegs);
 }
 
 void Route::removeLegs(int from, int to)
 {
+  detachFlightplan();
+
   qDebug() << Q_FUNC_INFO << "removing from" << from << "to" << to;
 
   // Delete in route legs and flight plan
   for(int i = to; i >= from; i--)
   {
     removeAt(i);
-    flightplan.getEntries().removeAt(i);
+    flightplan->getEntries().removeAt(i);
   }
 }
 
 void Route::removeRouteLegs()
 {
+  detachFlightplan();
+
   QVector<int> indexes;
 
   // Collect indexes to delete in reverse order
@@ -1260,12 +1284,14 @@ void Route::removeRouteLegs()
   for(int i = 0; i < indexes.size(); i++)
   {
     removeAt(indexes.at(i));
-    flightplan.getEntries().removeAt(indexes.at(i));
+    flightplan->getEntries().removeAt(indexes.at(i));
   }
 }
 
 void Route::clearProcedureLegs(proc::MapProcedureTypes type, bool clearRoute, bool clearFlightplan)
 {
+  detachFlightplan();
+
   QVector<int> indexes;
 
   // Collect indexes to delete in reverse order
@@ -1282,12 +1308,14 @@ void Route::clearProcedureLegs(proc::MapProcedureTypes type, bool clearRoute, bo
     if(clearRoute)
       removeAt(indexes.at(i));
     if(clearFlightplan)
-      flightplan.getEntries().removeAt(indexes.at(i));
+      flightplan->getEntries().removeAt(indexes.at(i));
   }
 }
 
 void Route::updateAll()
 {
+  detachFlightplan();
+
   updateIndicesAndOffsets();
   removeDuplicateRouteLegs();
   validateAirways();
@@ -1299,29 +1327,31 @@ void Route::updateAll()
   if(!isEmpty())
   {
     // Correct departure and destination values if missing - can happen after import of FLP or FMS plans
-    flightplan.setDepartureIdent(getDepartureAirportLeg().getIdent());
-    if(flightplan.getDepartureName().isEmpty())
-      flightplan.setDepartureName(getDepartureAirportLeg().getName());
-    if(!flightplan.getDeparturePosition().isValid())
-      flightplan.setDeparturePosition(first().getPosition());
+    flightplan->setDepartureIdent(getDepartureAirportLeg().getIdent());
+    if(flightplan->getDepartureName().isEmpty())
+      flightplan->setDepartureName(getDepartureAirportLeg().getName());
+    if(!flightplan->getDeparturePosition().isValid())
+      flightplan->setDeparturePosition(first().getPosition());
 
-    flightplan.setDestinationIdent(getDestinationAirportLeg().getIdent());
-    if(flightplan.getDestinationName().isEmpty())
-      flightplan.setDestinationName(getDestinationAirportLeg().getName());
-    if(!flightplan.getDestinationPosition().isValid())
-      flightplan.setDestinationPosition(first().getPosition());
+    flightplan->setDestinationIdent(getDestinationAirportLeg().getIdent());
+    if(flightplan->getDestinationName().isEmpty())
+      flightplan->setDestinationName(getDestinationAirportLeg().getName());
+    if(!flightplan->getDestinationPosition().isValid())
+      flightplan->setDestinationPosition(first().getPosition());
   }
 }
 
 void Route::updateAirportRegions()
 {
+  detachFlightplan();
+
   int i = 0;
   for(RouteLeg& leg : *this)
   {
     if(leg.getMapObjectType() == map::AIRPORT)
     {
       NavApp::getAirportQuerySim()->getAirportRegion(leg.getAirport());
-      flightplan.getEntries()[i].setRegion(leg.getAirport().region);
+      flightplan->getEntries()[i].setRegion(leg.getAirport().region);
     }
     i++;
   }
@@ -1825,6 +1855,8 @@ bool Route::canCalcSelection(int firstIndex, int lastIndex) const
 // Needs updateIndex called before
 void Route::validateAirways()
 {
+  detachFlightplan();
+
   if(isEmpty())
     return;
 
@@ -1840,7 +1872,7 @@ void Route::validateAirways()
 
     QString airway = arrivalLeg.getAirwayName();
     if(airway.isEmpty())
-      airway = flightplan.getProperties().value(atools::fs::pln::PROCAIRWAY);
+      airway = flightplan->getProperties().value(atools::fs::pln::PROCAIRWAY);
     if(NavApp::getAirwayTrackQuery()->hasAirwayForNameAndWaypoint(airway, routeLeg.getIdent(), arrivalLeg.getIdent()))
     {
       // Airway is valid - set into procedure leg and property
@@ -1853,7 +1885,7 @@ void Route::validateAirways()
       }
       else
         qDebug() << Q_FUNC_INFO << "Entry is null";
-      flightplan.getProperties().insert(atools::fs::pln::PROCAIRWAY, airway);
+      flightplan->getProperties().insert(atools::fs::pln::PROCAIRWAY, airway);
     }
     else
     {
@@ -1866,7 +1898,7 @@ void Route::validateAirways()
       }
       else
         qDebug() << Q_FUNC_INFO << "Entry is null";
-      flightplan.getProperties().remove(atools::fs::pln::PROCAIRWAY);
+      flightplan->getProperties().remove(atools::fs::pln::PROCAIRWAY);
     }
   }
 
@@ -1881,13 +1913,15 @@ void Route::validateAirways()
     if(!NavApp::getAirwayTrackQuery()->hasAirwayForNameAndWaypoint(routeLeg.getAirwayName(), departureLeg.getIdent(),
                                                                    routeLeg.getIdent()))
       // Airway not valid for changed waypoints - erase
-      flightplan.getEntries()[startIndexAfterProcedure].setAirway(QString());
+      flightplan->getEntries()[startIndexAfterProcedure].setAirway(QString());
   }
 }
 
 // Called after route calculation
 void Route::removeDuplicateRouteLegs()
 {
+  detachFlightplan();
+
   if(isEmpty())
     return;
 
@@ -1906,7 +1940,7 @@ void Route::removeDuplicateRouteLegs()
       qDebug() << "removing duplicate leg at" << (arrivaLegsOffset - 1) << routeLeg;
 
       // Copy airway name from the route leg to be deleted into the first procedure leg
-      flightplan.getEntries()[arrivaLegsOffset].setAirway(flightplan.getEntries().at(arrivaLegsOffset - 1).getAirway());
+      flightplan->getEntries()[arrivaLegsOffset].setAirway(flightplan->getEntries().at(arrivaLegsOffset - 1).getAirway());
 
       // Remove the route leg before the procedure
       removeAllAt(arrivaLegsOffset - 1);
@@ -1976,20 +2010,38 @@ const Pos& Route::getPrevPositionAt(int i) const
 
 void Route::createRouteLegsFromFlightplan()
 {
+  detachFlightplan();
+
   clear();
 
+  // Resolve all airport and navaid idents with one set-based query per type instead of querying
+  // the database once per entry. The legs filter the candidates by region and position.
+  QSet<QString> idents;
+  for(const atools::fs::pln::FlightplanEntry& entry : flightplan->getEntries())
+  {
+    atools::fs::pln::entry::WaypointType waypointType = entry.getWaypointType();
+    if(!entry.getIdent().isEmpty() &&
+       (waypointType == atools::fs::pln::entry::AIRPORT || waypointType == atools::fs::pln::entry::WAYPOINT ||
+        waypointType == atools::fs::pln::entry::VOR || waypointType == atools::fs::pln::entry::NDB))
+      idents.insert(entry.getIdent());
+  }
+
+  QHash<QString, map::MapResult> prefetched;
+  NavApp::getMapQuery()->getMapObjectsByIdents(prefetched, map::AIRPORT | map::WAYPOINT | map::VOR | map::NDB,
+                                               idents);
+
   const RouteLeg *lastLeg = nullptr;
 
   // Create map objects first and calculate total distance
-  for(int i = 0; i < flightplan.getEntries().size(); i++)
+  for(int i = 0; i < flightplan->getEntries().size(); i++)
   {
-    RouteLeg leg(&flightplan);
-    leg.createFromDatabaseByEntry(i, lastLeg);
+    RouteLeg leg(flightplan.get());
+    leg.createFromDatabaseByEntry(i, lastLeg, &prefetched);
 
     if(leg.getMapObjectType() == map::INVALID)
       // Not found in database
-      qWarning() << "Entry for ident" << flightplan.at(i).getIdent()
-                 << "region" << flightplan.at(i).getRegion() << "is not valid";
+      qWarning() << "Entry for ident" << flightplan->at(i).getIdent()
+                 << "region" << flightplan->at(i).getRegion() << "is not valid";
 
     append(leg);
     lastLeg = &last();
@@ -1998,9 +2050,11 @@ void Route::createRouteLegsFromFlightplan()
 
 void Route::assignAltitudes()
 {
+  detachFlightplan();
+
   QVector<float> altVector = altitude->getAltitudes();
   for(int i = 0; i < size(); i++)
-    flightplan.getEntries()[i].setAltitude(altVector.at(i));
+    flightplan->getEntries()[i].setAltitude(altVector.at(i));
 }
 
 Route Route::updatedAltitudes() const
@@ -2055,7 +2109,7 @@ Route Route::adjustedToOptions(const Route& routeParam, rf::RouteAdjustOptions o
         entry.setAirway(arrivalLeg.getAirwayName());
         entry.setFlag(atools::fs::pln::entry::PROCEDURE, false);
 
-        RouteLeg newLeg = RouteLeg(&route.flightplan);
+        RouteLeg newLeg = RouteLeg(route.flightplan.get());
         newLeg.createCopyFromProcedureLeg(arrivaLegsOffset, arrivalLeg, &routeLeg);
         newLeg.setAirway(arrivalLeg.getAirway());
 
@@ -2083,7 +2137,7 @@ Route Route::adjustedToOptions(const Route& routeParam, rf::RouteAdjustOptions o
         entry.setAirway(QString());
         entry.setFlag(atools::fs::pln::entry::PROCEDURE, false);
 
-        RouteLeg newLeg = RouteLeg(&route.flightplan);
+        RouteLeg newLeg = RouteLeg(route.flightplan.get());
         newLeg.createCopyFromProcedureLeg(startIndexAfterProcedure, departureLeg, &routeLeg);
         newLeg.setAirway(map::MapAirway());
 
@@ -2273,6 +2327,8 @@ bool Route::hasValidParking() const
 
 void Route::updateAirwaysAndAltitude(bool adjustRouteAltitude)
 {
+  detachFlightplan();
+
   if(isEmpty())
     return;
 
@@ -2317,8 +2373,8 @@ void Route::updateAirwaysAndAltitude(bool adjustRouteAltitude)
     // Check airway limits after calculation ===========================
 
     // Add 500 ft/m for VFR
-    float offset = flightplan.getFlightplanType() == atools::fs::pln::IFR ? 0.f : 500.f;
-    int cruisingAltitude = flightplan.getCruisingAltitude();
+    float offset = flightplan->getFlightplanType() == atools::fs::pln::IFR ? 0.f : 500.f;
+    int cruisingAltitude = flightplan->getCruisingAltitude();
 
     // First round up to next rule adhering altitude independent of flight direction
     // cruisingAltitude = static_cast<int>(std::ceil((cruisingAltitude - offset) / 1000.f) * 1000.f + offset);
@@ -2345,7 +2401,7 @@ void Route::updateAirwaysAndAltitude(bool adjustRouteAltitude)
     qDebug() << Q_FUNC_INFO << "Updating flight plan altitude"
              << "minAltitude" << minAltitude << "maxAltitude" << maxAltitude << "cruisingAltitude" << cruisingAltitude;
 
-    flightplan.setCruisingAltitude(cruisingAltitude);
+    flightplan->setCruisingAltitude(cruisingAltitude);
   }
 }
 
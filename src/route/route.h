@@ -23,6 +23,8 @@
 
 #include "fs/pln/flightplan.h"
 
+#include <memory>
+
 class CoordinateConverter;
 class FlightplanEntryBuilder;
 class RouteAltitude;
@@ -227,12 +229,14 @@ public:
   /* The flight plan has dummy entries for procedure points that are flagged as no save */
   const atools::fs::pln::Flightplan& getFlightplan() const
   {
-    return flightplan;
+    return *flightplan;
   }
 
+  /* Copies the plan away from other route copies before allowing modification */
   atools::fs::pln::Flightplan& getFlightplan()
   {
-    return flightplan;
+    detachFlightplan();
+    return *flightplan;
   }
 
   /* Value in flight plan is stored in local unit */
@@ -240,7 +244,8 @@ public:
 
   void setFlightplan(const atools::fs::pln::Flightplan& value)
   {
-    flightplan = value;
+    detachFlightplan();
+    *flightplan = value;
   }
 
   /* Get nearest flight plan leg to given screen position xs/ys. */
@@ -498,8 +503,9 @@ public:
   /* Removes the shadowed flight plan entry too */
   void removeAllAt(int i) // OK
   {
+    detachFlightplan();
     QList::removeAt(i);
-    flightplan.getEntries().removeAt(i);
+    flightplan->getEntries().removeAt(i);
   }
 
   /* Removes only route legs and does not touch the flight plan copy */
@@ -637,12 +643,18 @@ private:
   bool arrivalRouteToProcLegs(int& arrivaLegsOffset) const;
   bool departureProcToRouteLegs(int& startIndexAfterProcedure) const;
 
+  /* Copy the flight plan and point the legs to the copy if it is still shared with other copies
+   * of this route. Has to be called before modifying the plan or entries through the legs.
+   * Makes route copies cheap for undo and worker thread snapshots. */
+  void detachFlightplan();
+
   atools::geo::Rect boundingRect;
 
   /* Nautical miles not including missed approach and alternates */
   float totalDistance = 0.f;
 
-  atools::fs::pln::Flightplan flightplan;
+  /* Shared between cheap copies of this route and copied on the first write by detachFlightplan() */
+  std::shared_ptr<atools::fs::pln::Flightplan> flightplan;
   proc::MapProcedureLegs approachLegs, starLegs, sidLegs;
   map::MapTypes shownTypes;
 
@@ -22,10 +22,12 @@
 #include "geo/calculations.h"
 #include "fs/perf/aircraftperf.h"
 #include "grib/windquery.h"
+#include "common/perftrace.h"
 #include "common/unit.h"
 #include "navapp.h"
 #include "weather/windreporter.h"
 
+#include <QDataStream>
 #include <QLineF>
 
 using atools::interpolate;
@@ -839,6 +841,26 @@ void RouteAltitude::collectErrors(const QStringList& altRestrErrors)
 void RouteAltitude::calculateAll(const atools::fs::perf::AircraftPerf& perf, float cruiseAltitudeFt)
 {
   qDebug() << Q_FUNC_INFO;
+  perftrace::Span span("altitude calculation");
+
+  // Skip the expensive recalculation if no input value changed. This covers cosmetic updates
+  // like renamed user waypoints which do not affect the profile.
+  QByteArray fingerprint = calculationFingerprint(perf, cruiseAltitudeFt);
+  if(!isEmpty() && fingerprint == lastCalculationFingerprint)
+  {
+    // Refresh the display names in place which might have changed
+    for(int i = 0; i < size() && i < route->size(); i++)
+      (*this)[i].ident = route->value(i).getIdent();
+
+    numLegsSkipped += size();
+
+#ifdef DEBUG_INFORMATION
+    qDebug() << Q_FUNC_INFO << "Profile inputs unchanged - skipped" << size()
+             << "legs, total" << numLegsSkipped;
+#endif
+    return;
+  }
+  lastCalculationFingerprint = fingerprint;
 
   // Get default climb speed
   climbSpeedWindCorrected = perf.getClimbSpeed();
@@ -966,6 +988,42 @@ void RouteAltitude::calculateAll(const atools::fs::perf::AircraftPerf& perf, flo
   qDebug() << Q_FUNC_INFO;
 }
 
+QByteArray RouteAltitude::calculationFingerprint(const atools::fs::perf::AircraftPerf& perf,
+                                                 float cruiseAltitudeFt) const
+{
+  QByteArray bytes;
+  QDataStream out(&bytes, QIODevice::WriteOnly);
+  out.setVersion(QDataStream::Qt_5_5);
+  out.setFloatingPointPrecision(QDataStream::SinglePrecision);
+
+  // Global settings and wind situation
+  out << cruiseAltitudeFt << simplify << calcTopOfClimb << calcTopOfDescent
+      << NavApp::getWindReporter()->getChangeNumber();
+
+  // All performance values used for the profile, time and fuel calculation
+  out << perf.getClimbSpeed() << perf.getCruiseSpeed() << perf.getDescentSpeed()
+      << perf.getClimbVertSpeed() << perf.getDescentVertSpeed()
+      << perf.getClimbFuelFlow() << perf.getCruiseFuelFlow() << perf.getDescentFuelFlow()
+      << perf.getAlternateFuelFlow() << perf.getAlternateSpeed()
+      << perf.getTaxiFuel() << perf.getReserveFuel() << perf.getExtraFuel()
+      << perf.getContingencyFuelFactor() << perf.isJetFuel() << perf.useFuelAsVolume();
+
+  // All geometry and restriction values of the flight plan.
+  // Idents are excluded deliberately since they do not affect the profile.
+  for(int i = 0; i < route->size(); i++)
+  {
+    const RouteLeg& leg = route->value(i);
+    const atools::geo::Pos& pos = leg.getPosition();
+    out << pos.getLonX() << pos.getLatY() << leg.getDistanceTo()
+        << static_cast<quint32>(leg.getProcedureType()) << leg.isAlternate();
+
+    const proc::MapAltRestriction& restriction = leg.getProcedureLegAltRestr();
+    out << static_cast<quint32>(restriction.descriptor) << restriction.alt1 << restriction.alt2;
+  }
+
+  return bytes;
+}
+
 void RouteAltitude::calculate(QStringList& altRestErrors)
 {
   altRestErrors.clear();
@@ -1462,6 +1520,17 @@ void RouteAltitude::calculateTrip(const atools::fs::perf::AircraftPerf& perf)
     return;
   }
 
+  // Interpolate winds for all leg end positions in one batch ======================
+  ageo::LineString legEndPositions;
+  for(int i = 0; i < size(); i++)
+  {
+    const ageo::LineString& line = at(i).getLineString();
+    legEndPositions.append(line.isEmpty() ? ageo::EMPTY_POS : line.getPos2());
+  }
+
+  QVector<atools::grib::Wind> legEndWinds;
+  windReporter->getWindForPositionsRoute(legEndWinds, legEndPositions);
+
   for(int i = 0; i < size(); i++)
   {
     RouteAltitudeLeg& leg = (*this)[i];
@@ -1649,7 +1718,7 @@ void RouteAltitude::calculateTrip(const atools::fs::perf::AircraftPerf& perf)
         leg.cruiseFuel = perf.getCruiseFuelFlow() * leg.cruiseTime;
         leg.descentFuel = perf.getDescentFuelFlow() * leg.descentTime;
 
-        atools::grib::Wind wind = windReporter->getWindForPosRoute(leg.getLineString().getPos2());
+        atools::grib::Wind wind = legEndWinds.value(i, atools::grib::EMPTY_WIND);
         leg.windSpeed = wind.speed;
         leg.windDirection = wind.dir;
 
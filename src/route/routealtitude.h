@@ -383,6 +383,13 @@ public:
                               const atools::fs::perf::AircraftPerf& perf, float aircraftFuelFlowLbs,
                               float aircraftFuelFlowGal, float aircraftGroundSpeed, int activeLeg) const;
 
+  /* Accumulated number of legs which were not recalculated since no input value changed.
+   * Only for profiling and debugging. */
+  int getNumLegsSkipped() const
+  {
+    return numLegsSkipped;
+  }
+
 private:
   friend QDebug operator<<(QDebug out, const RouteAltitude& obj);
 
@@ -439,6 +446,10 @@ private:
 
   float windCorrectedGroundSpeed(atools::grib::Wind& wind, float course, float speed);
 
+  /* Collects all input values affecting the profile into a byte array. Used to detect
+   * changes and to skip the recalculation for cosmetic updates like renamed waypoints. */
+  QByteArray calculationFingerprint(const atools::fs::perf::AircraftPerf& perf, float cruiseAltitudeFt) const;
+
   /* NM from start */
   float distanceTopOfClimb = map::INVALID_DISTANCE_VALUE,
         distanceTopOfDescent = map::INVALID_DISTANCE_VALUE;
@@ -483,6 +494,12 @@ private:
 
   QVector<map::MapIls> destRunwayIls;
   map::MapRunwayEnd destRunwayEnd;
+
+  /* Input values of the last calculation - recalculation is skipped if these did not change */
+  QByteArray lastCalculationFingerprint;
+
+  /* Accumulated number of legs which were not recalculated */
+  int numLegsSkipped = 0;
 };
 
 QDebug operator<<(QDebug out, const RouteAltitude& obj);
@@ -16,14 +16,26 @@
 *****************************************************************************/
 
 #include "route/routecommand.h"
+
+#include "exception.h"
 #include "route/routecontroller.h"
+#include "fs/pln/flightplanio.h"
+#include "gui/errorhandler.h"
+#include "navapp.h"
 
 RouteCommand::RouteCommand(RouteController *routeController,
                            const atools::fs::pln::Flightplan& flightplanBefore, const QString& text,
                            rctype::RouteCmdType rcType)
   : QUndoCommand(text), controller(routeController), type(rcType)
 {
-  planBeforeChange = flightplanBefore;
+  try
+  {
+    planBeforeChange = atools::fs::pln::FlightplanIO().saveLnmGz(flightplanBefore);
+  }
+  catch(atools::Exception& e)
+  {
+    atools::gui::ErrorHandler(NavApp::getQMainWidget()).handleException(e);
+  }
 }
 
 RouteCommand::~RouteCommand()
@@ -33,12 +45,29 @@ RouteCommand::~RouteCommand()
 
 void RouteCommand::setFlightplanAfter(const atools::fs::pln::Flightplan& flightplanAfter)
 {
-  planAfterChange = flightplanAfter;
+  try
+  {
+    planAfterChange = atools::fs::pln::FlightplanIO().saveLnmGz(flightplanAfter);
+  }
+  catch(atools::Exception& e)
+  {
+    atools::gui::ErrorHandler(NavApp::getQMainWidget()).handleException(e);
+  }
 }
 
 void RouteCommand::undo()
 {
-  controller->changeRouteUndo(planBeforeChange);
+  try
+  {
+    // Unpack the stored plan copy
+    atools::fs::pln::Flightplan plan;
+    atools::fs::pln::FlightplanIO().loadLnmGz(plan, planBeforeChange);
+    controller->changeRouteUndo(plan);
+  }
+  catch(atools::Exception& e)
+  {
+    atools::gui::ErrorHandler(NavApp::getQMainWidget()).handleException(e);
+  }
 }
 
 void RouteCommand::redo()
@@ -47,7 +76,19 @@ void RouteCommand::redo()
     // Skip first redo - I need to do the initial changes myself
     firstRedoExecuted = true;
   else
-    controller->changeRouteRedo(planAfterChange);
+  {
+    try
+    {
+      // Unpack the stored plan copy
+      atools::fs::pln::Flightplan plan;
+      atools::fs::pln::FlightplanIO().loadLnmGz(plan, planAfterChange);
+      controller->changeRouteRedo(plan);
+    }
+    catch(atools::Exception& e)
+    {
+      atools::gui::ErrorHandler(NavApp::getQMainWidget()).handleException(e);
+    }
+  }
 }
 
 int RouteCommand::id() const
@@ -20,6 +20,7 @@
 
 #include "fs/pln/flightplan.h"
 
+#include <QByteArray>
 #include <QUndoCommand>
 
 class RouteController;
@@ -40,7 +41,9 @@ enum RouteCmdType
 
 /*
  * Flight plan undo command including a few workaround for QUndoCommand inflexibilities.
- * Keeps a copy of the flight plan before and after the change.
+ * Keeps a copy of the flight plan before and after the change as gzipped LNMPLN which
+ * keeps the memory footprint of a full undo stack of large plans small. The plans are
+ * unpacked on demand when undoing or redoing.
  */
 class RouteCommand :
   public QUndoCommand
@@ -64,7 +67,9 @@ private:
   bool firstRedoExecuted = false;
   RouteController *controller;
   rctype::RouteCmdType type;
-  atools::fs::pln::Flightplan planBeforeChange, planAfterChange;
+
+  /* Plans before and after the change as gzipped LNMPLN */
+  QByteArray planBeforeChange, planAfterChange;
 };
 
 #endif // LITTLENAVMAP_ROUTECOMMAND_H
@@ -29,6 +29,7 @@
 #include "common/tabindexes.h"
 #include "fs/db/databasemeta.h"
 #include "common/formatter.h"
+#include "common/perftrace.h"
 #include "fs/perf/aircraftperf.h"
 #include "search/proceduresearch.h"
 #include "common/unit.h"
@@ -72,9 +73,12 @@
 #include "routing/routenetworkloader.h"
 
 #include <QClipboard>
+#include <QDir>
+#include <QElapsedTimer>
 #include <QFile>
 #include <QStandardItemModel>
 #include <QInputDialog>
+#include <QMessageBox>
 #include <QFileInfo>
 #include <QTextTable>
 #include <QPlainTextEdit>
@@ -122,6 +126,9 @@ RouteController::RouteController(QMainWindow *parentWindow, QTableView *tableVie
   airportQuery = NavApp::getAirportQuerySim();
   airwayQuery = NavApp::getAirwayTrackQuery();
 
+  // Publish an initial empty snapshot so the pointer is never null
+  publishRouteSnapshot();
+
   routeColumns = QList<QString>({QObject::tr("Ident"),
                                  QObject::tr("Region"),
                                  QObject::tr("Name"),
@@ -240,6 +247,11 @@ RouteController::RouteController(QMainWindow *parentWindow, QTableView *tableVie
   connect(&routeAltDelayTimer, &QTimer::timeout, this, &RouteController::routeAltChangedDelayed);
   routeAltDelayTimer.setSingleShot(true);
 
+  // Write a crash recovery copy of the plan if it has unsaved changes
+  connect(&crashRecoveryTimer, &QTimer::timeout, this, &RouteController::saveCrashRecoveryFlightplan);
+  crashRecoveryTimer.setInterval(60 * 1000);
+  crashRecoveryTimer.start();
+
   // Clear selection after inactivity
   // Or move active to top after inactivity (no scrolling)
   connect(&cleanupTableTimer, &QTimer::timeout, this, &RouteController::cleanupTableTimeout);
@@ -733,6 +745,9 @@ void RouteController::saveState()
   atools::settings::Settings::instance().setValue(lnm::ROUTE_FILENAME, routeFilename);
   tabHandlerRoute->saveState();
   routeWindow->saveState();
+
+  // Remove the crash recovery plan on a clean shutdown
+  QFile::remove(crashRecoveryFilename());
 }
 
 void RouteController::updateTableHeaders()
@@ -757,7 +772,29 @@ void RouteController::restoreState()
   atools::gui::WidgetState state(lnm::ROUTE_VIEW, true, true);
   state.restore({view, ui->comboBoxRouteType, ui->spinBoxRouteAlt, ui->actionRouteFollowSelection});
 
-  if(OptionData::instance().getFlags() & opts::STARTUP_LOAD_ROUTE)
+  // Look for a plan left over from an unexpected exit - the file is removed on clean shutdown
+  bool recovered = false;
+  QString recoveryFile = crashRecoveryFilename();
+  if(QFile::exists(recoveryFile))
+  {
+    NavApp::deleteSplashScreen();
+    if(QMessageBox::question(mainWindow, QApplication::applicationName(),
+                             tr("Found a flight plan with unsaved changes from an unexpected exit.\n"
+                                "Restore the changed flight plan?"),
+                             QMessageBox::Yes | QMessageBox::No, QMessageBox::Yes) == QMessageBox::Yes)
+    {
+      if(loadFlightplan(recoveryFile))
+      {
+        // The restored plan has no file yet - force the changed state so the user is asked to save
+        routeFilename.clear();
+        undoIndexClean = -1;
+        recovered = true;
+      }
+    }
+    QFile::remove(recoveryFile);
+  }
+
+  if(!recovered && OptionData::instance().getFlags() & opts::STARTUP_LOAD_ROUTE)
   {
     QString newRouteFilename = atools::settings::Settings::instance().valueStr(lnm::ROUTE_FILENAME);
 
@@ -917,14 +954,17 @@ void RouteController::loadFlightplan(atools::fs::pln::Flightplan flightplan, ato
   assignFlightplanPerfProperties(flightplan);
   route.setFlightplan(flightplan);
 
-  route.createRouteLegsFromFlightplan();
+  {
+    perftrace::Span span("route legs build");
+    route.createRouteLegsFromFlightplan();
 
-  // test and error after undo/redo and switch
+    // test and error after undo/redo and switch
 
-  loadProceduresFromFlightplan(false /* clear old procedure properties */);
-  loadAlternateFromFlightplan();
-  route.updateAll();
-  route.updateAirwaysAndAltitude(adjustAltitude);
+    loadProceduresFromFlightplan(false /* clear old procedure properties */);
+    loadAlternateFromFlightplan();
+    route.updateAll();
+    route.updateAirwaysAndAltitude(adjustAltitude);
+  }
 
   // Save values for checking filename match when doing save
   fileDepartureIdent = route.getFlightplan().getDepartureIdent();
@@ -966,6 +1006,45 @@ void RouteController::loadFlightplan(atools::fs::pln::Flightplan flightplan, ato
 #endif
 
   emit routeChanged(true /* geometry changed */, true /* new flight plan */);
+
+  // Fill the procedure cache for departure and destination once the event loop is idle
+  QTimer::singleShot(0, this, &RouteController::preloadProcedures);
+}
+
+void RouteController::preloadProcedures()
+{
+  procedurePreloadQueue.clear();
+
+  if(loadingDatabaseState || route.isEmpty())
+    return;
+
+  ProcedureQuery *procedureQuery = NavApp::getProcedureQuery();
+  for(const map::MapAirport& airport : {route.getDepartureAirportLeg().getAirport(),
+                                        route.getDestinationAirportLeg().getAirport()})
+  {
+    if(airport.isValid())
+    {
+      for(int approachId : procedureQuery->getApproachIdsForAirport(airport))
+        procedurePreloadQueue.append(std::make_pair(airport, approachId));
+    }
+  }
+
+  if(!procedurePreloadQueue.isEmpty())
+    QTimer::singleShot(0, this, &RouteController::preloadProceduresStep);
+}
+
+void RouteController::preloadProceduresStep()
+{
+  if(loadingDatabaseState || procedurePreloadQueue.isEmpty())
+    return;
+
+  // Build one procedure per pass - fills the cache in ProcedureQuery which keeps the
+  // legs cheap to evict and to rebuild later
+  std::pair<map::MapAirport, int> preload = procedurePreloadQueue.takeFirst();
+  NavApp::getProcedureQuery()->getApproachLegs(preload.first, preload.second);
+
+  if(!procedurePreloadQueue.isEmpty())
+    QTimer::singleShot(0, this, &RouteController::preloadProceduresStep);
 }
 
 /* Appends alternates to the end of the flight plan */
@@ -1069,6 +1148,7 @@ bool RouteController::loadFlightplanLnmStr(const QString& string)
 bool RouteController::loadFlightplan(const QString& filename)
 {
   qDebug() << Q_FUNC_INFO << filename;
+  perftrace::Span span("flight plan load");
   Flightplan fp;
   try
   {
@@ -1327,6 +1407,40 @@ bool RouteController::saveFlightplanLnmInternal()
   return true;
 }
 
+QString RouteController::crashRecoveryFilename()
+{
+  return atools::settings::Settings::instance().getPath() + QDir::separator() + "little_navmap_recovery.lnmpln";
+}
+
+void RouteController::saveCrashRecoveryFlightplan()
+{
+  // Write only if there are unsaved changes that were not written by the last run.
+  // This keeps the simulator machine free of periodic I/O when the plan is untouched.
+  if(route.isEmpty() || !hasChanged() || undoIndex == undoIndexRecoverySaved)
+    return;
+
+  try
+  {
+    // Create a copy which allows to change altitude - same adjustments as a regular save
+    Flightplan flightplan = route.updatedAltitudes().adjustedToOptions(rf::DEFAULT_OPTS_LNMPLN).getFlightplan();
+    flightplan.setCruisingAltitude(
+      atools::roundToInt(Unit::rev(static_cast<float>(flightplan.getCruisingAltitude()), Unit::altFeetF)));
+    assignFlightplanPerfProperties(flightplan);
+
+    flightplanIO->saveLnm(flightplan, crashRecoveryFilename());
+    undoIndexRecoverySaved = undoIndex;
+  }
+  catch(atools::Exception& e)
+  {
+    // No dialogs from a background save - log and try again on the next timeout
+    qWarning() << Q_FUNC_INFO << "Error saving crash recovery plan" << e.what();
+  }
+  catch(...)
+  {
+    qWarning() << Q_FUNC_INFO << "Unknown error saving crash recovery plan";
+  }
+}
+
 void RouteController::updateRouteCycleMetadata()
 {
   QHash<QString, QString>& properties = route.getFlightplan().getProperties();
@@ -1371,6 +1485,9 @@ void RouteController::calculateRouteWindowSelection()
   routeWindow->showForSelectionCalculation(selectedRows, canCalcSelection());
   routeWindow->setCruisingAltitudeFt(route.getCruisingAltitudeFeet());
   NavApp::showRouteCalc();
+
+  // Load the network after the window is shown so the first calculation starts without delay
+  QTimer::singleShot(0, this, &RouteController::preloadRouteNetwork);
 }
 
 void RouteController::calculateRouteWindowFull()
@@ -1379,6 +1496,9 @@ void RouteController::calculateRouteWindowFull()
   routeWindow->showForFullCalculation();
   routeWindow->setCruisingAltitudeFt(route.getCruisingAltitudeFeet());
   NavApp::showRouteCalc();
+
+  // Load the network after the window is shown so the first calculation starts without delay
+  QTimer::singleShot(0, this, &RouteController::preloadRouteNetwork);
 }
 
 void RouteController::calculateRoute()
@@ -1443,6 +1563,7 @@ void RouteController::calculateRoute()
 
   if(!net->isLoaded())
   {
+    // Not preloaded when opening the window - i.e. routing type was changed afterwards
     atools::routing::RouteNetworkLoader loader(NavApp::getDatabaseNav(), NavApp::getDatabaseTrack());
     loader.load(net);
   }
@@ -1466,6 +1587,21 @@ void RouteController::calculateRoute()
   routeWindow->updateWidgets();
 }
 
+void RouteController::preloadRouteNetwork()
+{
+  // The loaded network is cached and reused until the database or the tracks change
+  atools::routing::RouteNetwork *net =
+    routeWindow->getRoutingType() == rd::RADIONNAV ? routeNetworkRadio : routeNetworkAirway;
+
+  if(!net->isLoaded())
+  {
+    QGuiApplication::setOverrideCursor(Qt::WaitCursor);
+    atools::routing::RouteNetworkLoader loader(NavApp::getDatabaseNav(), NavApp::getDatabaseTrack());
+    loader.load(net);
+    QGuiApplication::restoreOverrideCursor();
+  }
+}
+
 void RouteController::clearAirwayNetworkCache()
 {
   routeNetworkAirway->clear();
@@ -1477,6 +1613,7 @@ bool RouteController::calculateRouteInternal(atools::routing::RouteFinder *route
                                              atools::routing::Modes mode)
 {
   qDebug() << Q_FUNC_INFO;
+  perftrace::Span span("route calculation");
   bool calcRange = fromIndex != -1 && toIndex != -1;
   int oldRouteSize = route.size();
 
@@ -1513,18 +1650,28 @@ bool RouteController::calculateRouteInternal(atools::routing::RouteFinder *route
   progress.setMinimumDuration(500);
 
   bool dialogShown = false, canceled = false;
-  routeFinder->setProgressCallback([&progress, &canceled, &dialogShown](int distToDest, int currentDistToDest) -> bool
+  QElapsedTimer progressTimer;
+  progressTimer.start();
+  routeFinder->setProgressCallback([&progress, &canceled, &dialogShown,
+                                    &progressTimer](int distToDest, int currentDistToDest) -> bool
   {
-    QApplication::processEvents();
-    progress.setMaximum(distToDest);
-    progress.setValue(distToDest - currentDistToDest);
-    canceled = progress.wasCanceled();
-
-    if(!dialogShown && progress.isVisible())
+    // The callback fires for every expanded node. Update the dialog and drain the event queue
+    // at most every 100 ms since the event processing would dominate the search otherwise.
+    if(progressTimer.elapsed() > 100)
     {
-      // Dialog is shown - remove wait cursor
-      dialogShown = true;
-      QGuiApplication::restoreOverrideCursor();
+      progressTimer.restart();
+
+      QApplication::processEvents();
+      progress.setMaximum(distToDest);
+      progress.setValue(distToDest - currentDistToDest);
+      canceled = progress.wasCanceled();
+
+      if(!dialogShown && progress.isVisible())
+      {
+        // Dialog is shown - remove wait cursor
+        dialogShown = true;
+        QGuiApplication::restoreOverrideCursor();
+      }
     }
 
     return !canceled;
@@ -1752,6 +1899,9 @@ void RouteController::preDatabaseLoad()
   loadingDatabaseState = true;
   routeAltDelayTimer.stop();
 
+  // Stop preloading since the procedure queries will be invalid
+  procedurePreloadQueue.clear();
+
   // Reset active to avoid crash when indexes change
   route.resetActive();
   highlightNextWaypoint(route.getActiveLegIndex());
@@ -1796,6 +1946,11 @@ void RouteController::postDatabaseLoad()
 
   NavApp::updateWindowTitle();
   loadingDatabaseState = false;
+
+  if(NavApp::getMainUi()->dockWidgetRouteCalc->isVisible())
+    // Networks were cleared above - warm the routing network up again during user think time
+    // so the next calculation does not pay for the rebuild
+    QTimer::singleShot(0, this, &RouteController::preloadRouteNetwork);
 }
 
 /* Double click into table view */
@@ -2370,6 +2525,7 @@ void RouteController::resetActiveLeg()
 {
   qDebug() << Q_FUNC_INFO;
   route.resetActive();
+  publishRouteSnapshot();
   highlightNextWaypoint(route.getActiveLegIndex());
   // Use geometry changed flag to force redraw
   emit routeChanged(true);
@@ -2378,6 +2534,7 @@ void RouteController::resetActiveLeg()
 void RouteController::updateActiveLeg()
 {
   route.updateActiveLegAndPos(true /* force update */, aircraft.isFlying());
+  publishRouteSnapshot();
 }
 
 void RouteController::editUserWaypointTriggered()
@@ -2558,6 +2715,9 @@ void RouteController::changeRouteUndoRedo(const atools::fs::pln::Flightplan& new
 void RouteController::styleChanged()
 {
   tabHandlerRoute->styleChanged();
+
+  // Colors are based on the palette - force a full highlighting pass
+  modelHighlightStates.clear();
   updateModelHighlights();
   highlightNextWaypoint(route.getActiveLegIndexCorrected());
 }
@@ -3613,51 +3773,72 @@ QIcon RouteController::iconForLeg(const RouteLeg& leg, int size) const
   return icon;
 }
 
-/* Update table view model completely */
+/* Update table view model in place. Rows and item objects are reused so that only cells with
+ * changed content emit dataChanged signals which keeps plan edits with many procedure legs fast. */
 void RouteController::updateTableModel()
 {
   Ui::MainWindow *ui = NavApp::getMainUi();
 
-  model->removeRows(0, model->rowCount());
   float totalDistance = route.getTotalDistance();
-
-  int row = 0;
   float cumulatedDistance = 0.f;
 
-  QList<QStandardItem *> itemRow;
-  for(int i = rcol::FIRST_COLUMN; i <= rcol::LAST_COLUMN; i++)
-    itemRow.append(nullptr);
+  // Adjust the row count - remove surplus rows and append missing prepared rows
+  if(model->rowCount() > route.size())
+    model->removeRows(route.size(), model->rowCount() - route.size());
+
+  while(model->rowCount() < route.size())
+  {
+    QList<QStandardItem *> itemRow;
+    for(int col = rcol::FIRST_COLUMN; col <= rcol::LAST_COLUMN; col++)
+    {
+      QStandardItem *item = new QStandardItem();
+      item->setFlags(item->flags() & ~(Qt::ItemIsEditable | Qt::ItemIsDragEnabled | Qt::ItemIsDropEnabled));
+      itemRow.append(item);
+    }
+
+    // Ident is always bold
+    QFont font = itemRow.at(rcol::IDENT)->font();
+    font.setBold(true);
+    itemRow[rcol::IDENT]->setFont(font);
+
+    // Align cells to the right - rest is aligned in updateModelRouteTimeFuel
+    for(int col : {rcol::IDENT, rcol::REGION, rcol::REMAINING_DISTANCE, rcol::DIST, rcol::COURSE,
+                   rcol::COURSETRUE, rcol::RANGE, rcol::FREQ, rcol::RESTRICTION})
+      itemRow[col]->setTextAlignment(Qt::AlignRight);
+
+    model->appendRow(itemRow);
+  }
+
+  // Sets the text only if it changed to keep the emitted dataChanged signals fine-grained
+  auto updateCell = [this](int row, int col, const QString& text)
+  {
+    QStandardItem *item = model->item(row, col);
+    if(item->text() != text)
+      item->setText(text);
+  };
 
   for(int i = 0; i < route.size(); i++)
   {
     const RouteLeg& leg = route.value(i);
+    QVector<QString> texts(rcol::LAST_COLUMN + 1);
 
     // Ident ===========================================
-    QString identStr;
     if(leg.isAnyProcedure())
       // Get ident with IAF, FAF or other indication
-      identStr = proc::procedureLegFixStr(leg.getProcedureLeg());
+      texts[rcol::IDENT] = proc::procedureLegFixStr(leg.getProcedureLeg());
     else
-      identStr = leg.getIdent();
+      texts[rcol::IDENT] = leg.getIdent();
 
-    QStandardItem *ident =
-      new QStandardItem(iconForLeg(leg, view->verticalHeader()->defaultSectionSize() - 2), identStr);
-    QFont f = ident->font();
-    f.setBold(true);
-    ident->setFont(f);
-    ident->setTextAlignment(Qt::AlignRight);
-
-    itemRow[rcol::IDENT] = ident;
     // highlightProcedureItems() does error checking for IDENT
 
     // Region, navaid name, procedure type ===========================================
-    itemRow[rcol::REGION] = new QStandardItem(leg.getRegion());
-    itemRow[rcol::NAME] = new QStandardItem(leg.getName());
+    texts[rcol::REGION] = leg.getRegion();
+    texts[rcol::NAME] = leg.getName();
 
     if(leg.isAlternate())
-      itemRow[rcol::PROCEDURE] = new QStandardItem(tr("Alternate"));
+      texts[rcol::PROCEDURE] = tr("Alternate");
     else
-      itemRow[rcol::PROCEDURE] = new QStandardItem(route.getProcedureLegText(leg.getProcedureType()));
+      texts[rcol::PROCEDURE] = route.getProcedureLegText(leg.getProcedureType());
 
     // Airway or leg type and restriction ===========================================
     if(leg.isRoute())
@@ -3674,19 +3855,18 @@ void RouteController::updateTableModel()
         awname += " [" + map::airwayRouteTypeToStringShort(airway.routeType) +
                   "," + map::airwayTrackTypeToShortString(airway.type) + "]";
 #endif
-        itemRow[rcol::RESTRICTION] =
-          new QStandardItem(map::airwayAltTextShort(airway, false /* addUnit */, false /* narrow */));
+        texts[rcol::RESTRICTION] = map::airwayAltTextShort(airway, false /* addUnit */, false /* narrow */);
       }
 
-      itemRow[rcol::AIRWAY_OR_LEGTYPE] = new QStandardItem(awname);
+      texts[rcol::AIRWAY_OR_LEGTYPE] = awname;
       // highlightProcedureItems() does error checking
     }
     else
     {
       // Procedure ========================
-      itemRow[rcol::AIRWAY_OR_LEGTYPE] =
-        new QStandardItem(atools::strJoin({leg.getFlightplanEntry().getAirway(),
-                                           proc::procedureLegTypeStr(leg.getProcedureLegType())}, tr(",")));
+      texts[rcol::AIRWAY_OR_LEGTYPE] = atools::strJoin({leg.getFlightplanEntry().getAirway(),
+                                                        proc::procedureLegTypeStr(leg.getProcedureLegType())},
+                                                       tr(","));
 
       QString restrictions;
       if(leg.getProcedureLegAltRestr().isValid())
@@ -3694,7 +3874,7 @@ void RouteController::updateTableModel()
       if(leg.getProcedureLeg().speedRestriction.isValid())
         restrictions.append(tr("/") + proc::speedRestrictionTextShort(leg.getProcedureLeg().speedRestriction));
 
-      itemRow[rcol::RESTRICTION] = new QStandardItem(restrictions);
+      texts[rcol::RESTRICTION] = restrictions;
     }
 
     // Get ILS for approach runway if it marks the end of an ILS or localizer approach procedure
@@ -3705,59 +3885,59 @@ void RouteController::updateTableModel()
 
     // VOR/NDB type ===========================
     if(leg.getVor().isValid())
-      itemRow[rcol::TYPE] = new QStandardItem(map::vorFullShortText(leg.getVor()));
+      texts[rcol::TYPE] = map::vorFullShortText(leg.getVor());
     else if(leg.getNdb().isValid())
-      itemRow[rcol::TYPE] = new QStandardItem(map::ndbFullShortText(leg.getNdb()));
+      texts[rcol::TYPE] = map::ndbFullShortText(leg.getNdb());
     else if(leg.isAnyProcedure() && !(leg.getProcedureLeg().isMissed()) &&
             leg.getRunwayEnd().isValid())
     {
       // Build string for ILS type
-      QSet<QString> texts;
+      QSet<QString> ilsTexts;
       for(const map::MapIls& ils : ilsByAirportAndRunway)
       {
         QStringList txt(ils.slope > 0.f ? tr("ILS") : tr("LOC"));
         if(ils.hasDme)
           txt.append("DME");
-        texts.insert(txt.join("/"));
+        ilsTexts.insert(txt.join("/"));
       }
 
-      itemRow[rcol::TYPE] = new QStandardItem(texts.toList().join(","));
+      texts[rcol::TYPE] = ilsTexts.toList().join(",");
     }
 
     // VOR/NDB frequency =====================
     if(leg.getVor().isValid())
     {
       if(leg.getVor().tacan)
-        itemRow[rcol::FREQ] = new QStandardItem(leg.getVor().channel);
+        texts[rcol::FREQ] = leg.getVor().channel;
       else
-        itemRow[rcol::FREQ] = new QStandardItem(QLocale().toString(leg.getFrequency() / 1000.f, 'f', 2));
+        texts[rcol::FREQ] = QLocale().toString(leg.getFrequency() / 1000.f, 'f', 2);
     }
     else if(leg.getNdb().isValid())
-      itemRow[rcol::FREQ] = new QStandardItem(QLocale().toString(leg.getFrequency() / 100.f, 'f', 1));
+      texts[rcol::FREQ] = QLocale().toString(leg.getFrequency() / 100.f, 'f', 1);
     else if(leg.isAnyProcedure() && !(leg.getProcedureLeg().isMissed()) &&
             leg.getRunwayEnd().isValid())
     {
       // Add ILS frequencies
-      QSet<QString> texts;
+      QSet<QString> freqTexts;
       for(const map::MapIls& ils : ilsByAirportAndRunway)
-        texts.insert(QLocale().toString(ils.frequency / 1000.f, 'f', 2));
+        freqTexts.insert(QLocale().toString(ils.frequency / 1000.f, 'f', 2));
 
-      itemRow[rcol::FREQ] = new QStandardItem(texts.toList().join(","));
+      texts[rcol::FREQ] = freqTexts.toList().join(",");
     }
 
     // VOR/NDB range =====================
     if(leg.getRange() > 0 && (leg.getVor().isValid() || leg.getNdb().isValid()))
-      itemRow[rcol::RANGE] = new QStandardItem(Unit::distNm(leg.getRange(), false));
+      texts[rcol::RANGE] = Unit::distNm(leg.getRange(), false);
 
     // Course =====================
     bool afterArrivalAirport = route.isAirportAfterArrival(i);
-    if(row > 0 && !afterArrivalAirport && leg.getDistanceTo() < map::INVALID_DISTANCE_VALUE &&
+    if(i > 0 && !afterArrivalAirport && leg.getDistanceTo() < map::INVALID_DISTANCE_VALUE &&
        leg.getDistanceTo() > 0.f)
     {
       if(leg.getCourseToMag() < map::INVALID_COURSE_VALUE)
-        itemRow[rcol::COURSE] = new QStandardItem(QLocale().toString(leg.getCourseToMag(), 'f', 0));
+        texts[rcol::COURSE] = QLocale().toString(leg.getCourseToMag(), 'f', 0);
       if(leg.getCourseToTrue() < map::INVALID_COURSE_VALUE)
-        itemRow[rcol::COURSETRUE] = new QStandardItem(QLocale().toString(leg.getCourseToTrue(), 'f', 0));
+        texts[rcol::COURSETRUE] = QLocale().toString(leg.getCourseToTrue(), 'f', 0);
     }
 
     if(!afterArrivalAirport)
@@ -3765,14 +3945,14 @@ void RouteController::updateTableModel()
       if(leg.getDistanceTo() < map::INVALID_DISTANCE_VALUE) // Distance =====================
       {
         cumulatedDistance += leg.getDistanceTo();
-        itemRow[rcol::DIST] = new QStandardItem(Unit::distNm(leg.getDistanceTo(), false));
+        texts[rcol::DIST] = Unit::distNm(leg.getDistanceTo(), false);
 
         if(!leg.getProcedureLeg().isMissed() && !leg.isAlternate())
         {
           float remaining = totalDistance - cumulatedDistance;
           if(remaining < 0.f)
             remaining = 0.f; // Catch the -0 case due to rounding errors
-          itemRow[rcol::REMAINING_DISTANCE] = new QStandardItem(Unit::distNm(remaining, false));
+          texts[rcol::REMAINING_DISTANCE] = Unit::distNm(remaining, false);
         }
       }
     }
@@ -3783,35 +3963,28 @@ void RouteController::updateTableModel()
     else
       remarks = leg.getFlightplanEntry().getComment();
 
-    itemRow[rcol::REMARKS] = new QStandardItem(atools::elideTextShort(remarks, 80));
-    itemRow[rcol::REMARKS]->setToolTip(atools::elideTextLinesShort(remarks, 20, 80));
-
-    // Travel time, remaining fuel and ETA are updated in updateModelRouteTime
+    texts[rcol::REMARKS] = atools::elideTextShort(remarks, 80);
 
-    // Create empty items for missing fields
+    // Update all cells of the row in place
     for(int col = rcol::FIRST_COLUMN; col <= rcol::LAST_COLUMN; col++)
+      updateCell(i, col, texts.at(col));
+
+    QStandardItem *remarksItem = model->item(i, rcol::REMARKS);
+    QString remarksTooltip = atools::elideTextLinesShort(remarks, 20, 80);
+    if(remarksItem->toolTip() != remarksTooltip)
+      remarksItem->setToolTip(remarksTooltip);
+
+    // Update the leg icon only if the underlying object changed since icons cannot be compared
+    QStandardItem *identItem = model->item(i, rcol::IDENT);
+    QString iconKey = QString::number(static_cast<quint32>(leg.getMapObjectType())) + '_' +
+                      QString::number(leg.getId());
+    if(identItem->data(Qt::UserRole).toString() != iconKey)
     {
-      if(itemRow[col] == nullptr)
-        itemRow[col] = new QStandardItem();
-      itemRow[col]->setFlags(itemRow[col]->flags() &
-                             ~(Qt::ItemIsEditable | Qt::ItemIsDragEnabled | Qt::ItemIsDropEnabled));
+      identItem->setIcon(iconForLeg(leg, view->verticalHeader()->defaultSectionSize() - 2));
+      identItem->setData(iconKey, Qt::UserRole);
     }
 
-    // Align cells to the right - rest is aligned in updateModelRouteTimeFuel
-    itemRow[rcol::REGION]->setTextAlignment(Qt::AlignRight);
-    itemRow[rcol::REMAINING_DISTANCE]->setTextAlignment(Qt::AlignRight);
-    itemRow[rcol::DIST]->setTextAlignment(Qt::AlignRight);
-    itemRow[rcol::COURSE]->setTextAlignment(Qt::AlignRight);
-    itemRow[rcol::COURSETRUE]->setTextAlignment(Qt::AlignRight);
-    itemRow[rcol::RANGE]->setTextAlignment(Qt::AlignRight);
-    itemRow[rcol::FREQ]->setTextAlignment(Qt::AlignRight);
-    itemRow[rcol::RESTRICTION]->setTextAlignment(Qt::AlignRight);
-
-    model->appendRow(itemRow);
-
-    for(int col = rcol::FIRST_COLUMN; col <= rcol::LAST_COLUMN; col++)
-      itemRow[col] = nullptr;
-    row++;
+    // Travel time, remaining fuel and ETA are updated in updateModelRouteTime
   }
 
   updateModelRouteTimeFuel();
@@ -3838,6 +4011,16 @@ void RouteController::updateTableModel()
   updateModelHighlights();
   highlightNextWaypoint(route.getActiveLegIndexCorrected());
   updateWindowLabel();
+
+  // All change paths come through here - republish the snapshot for painters and threads
+  publishRouteSnapshot();
+}
+
+void RouteController::publishRouteSnapshot()
+{
+  // Copy is cheap since the leg list and flight plan are implicitly shared.
+  // Holders of the previous snapshot keep it alive and see consistent data.
+  routeSnapshot = QSharedPointer<const Route>::create(route);
 }
 
 /* Update travel times in table view model after speed change */
@@ -3978,6 +4161,7 @@ void RouteController::disconnectedFromSimulator()
   qDebug() << Q_FUNC_INFO;
 
   route.resetActive();
+  publishRouteSnapshot();
   highlightNextWaypoint(-1);
   emit routeChanged(false);
 }
@@ -4014,6 +4198,9 @@ void RouteController::simDataChanged(const atools::fs::sc::SimConnectData& simul
       }
       else
         route.updateActivePos(position);
+
+      // Active leg and position changed - replace the published snapshot
+      publishRouteSnapshot();
     }
     lastSimUpdate = QDateTime::currentDateTime().toMSecsSinceEpoch();
   }
@@ -4082,11 +4269,23 @@ void RouteController::highlightNextWaypoint(int nearestLegIndex)
 /* Set colors for procedures and missing objects like waypoints and airways */
 void RouteController::updateModelHighlights()
 {
+  QElapsedTimer validationTimer;
+  validationTimer.start();
+
   bool night = NavApp::isCurrentGuiStyleNight();
   const QColor defaultColor = QApplication::palette().color(QPalette::Normal, QPalette::Text);
   const QColor invalidColor = night ? mapcolors::routeInvalidTableColorDark : mapcolors::routeInvalidTableColor;
-  errors.clear();
 
+  if(modelHighlightStates.size() != model->rowCount())
+  {
+    // Row count changed - invalidate all remembered row states
+    modelHighlightStates.clear();
+    for(int row = 0; row < model->rowCount(); ++row)
+      modelHighlightStates.append(QString());
+    modelHighlightErrors = QVector<QStringList>(model->rowCount());
+  }
+
+  int updatedRows = 0;
   for(int row = 0; row < model->rowCount(); ++row)
   {
     const RouteLeg& leg = route.value(row);
@@ -4097,6 +4296,24 @@ void RouteController::updateModelHighlights()
       break;
     }
 
+    // Everything going into colors, fonts and tooltips of this row. Rows with an unchanged
+    // fingerprint keep their items untouched which limits the pass to the rows affected by
+    // an edit. The memoized airway check makes building the fingerprint cheap.
+    QStringList airwayErrors;
+    bool airwayInvalid = leg.isRoute() &&
+                         leg.isAirwaySetAndInvalid(route.getCruisingAltitudeFeet(), &airwayErrors);
+    QString rowState = QString("%1 %2 %3 %4 %5 ").
+                       arg(night).arg(leg.isAlternate()).arg(leg.isAnyProcedure()).
+                       arg(leg.isAnyProcedure() && leg.getProcedureLeg().isMissed()).
+                       arg(leg.getMapObjectType() == map::INVALID) +
+                       leg.getIdent() + airwayErrors.join(';');
+
+    if(rowState == modelHighlightStates.at(row) && !airwayInvalid && leg.getMapObjectType() != map::INVALID)
+      // Unchanged and no errors - keep colors and stored errors. Rows with errors are always
+      // refreshed since highlightNextWaypoint() resets the bold font of the airway column.
+      continue;
+
+    QStringList rowErrors;
     for(int col = 0; col < model->columnCount(); ++col)
     {
       QStandardItem *item = model->item(row, col);
@@ -4124,7 +4341,7 @@ void RouteController::updateModelHighlights()
             item->setForeground(invalidColor);
             QString err = tr("Waypoint \"%1\" not found.").arg(leg.getIdent());
             item->setToolTip(err);
-            errors.append(err);
+            rowErrors.append(err);
           }
           else
             item->setToolTip(QString());
@@ -4133,8 +4350,7 @@ void RouteController::updateModelHighlights()
         // Airway colum ==========================================
         if(col == rcol::AIRWAY_OR_LEGTYPE && leg.isRoute())
         {
-          QStringList airwayErrors;
-          if(leg.isAirwaySetAndInvalid(route.getCruisingAltitudeFeet(), &airwayErrors))
+          if(airwayInvalid)
           {
             // Has airway but errors
             item->setForeground(invalidColor);
@@ -4144,7 +4360,7 @@ void RouteController::updateModelHighlights()
             if(!airwayErrors.isEmpty())
             {
               item->setToolTip(airwayErrors.join(tr("\n")));
-              errors.append(airwayErrors);
+              rowErrors.append(airwayErrors);
             }
           }
           else
@@ -4158,7 +4374,19 @@ void RouteController::updateModelHighlights()
         }
       }
     }
+
+    modelHighlightStates[row] = rowState;
+    modelHighlightErrors[row] = rowErrors;
+    updatedRows++;
   }
+
+  // Collect the errors of all rows in order including the skipped ones
+  errors.clear();
+  for(const QStringList& rowErrors : modelHighlightErrors)
+    errors.append(rowErrors);
+
+  qDebug() << Q_FUNC_INFO << updatedRows << "of" << model->rowCount() << "rows updated in"
+           << validationTimer.elapsed() << "ms";
 }
 
 bool RouteController::hasErrors() const
@@ -4445,6 +4673,7 @@ QString RouteController::buildFlightplanLabel2(bool print) const
 /* Reset route and clear undo stack (new route) */
 void RouteController::clearRoute()
 {
+  procedurePreloadQueue.clear();
   route.clearAll();
   routeFilename.clear();
   fileDepartureIdent.clear();
@@ -23,6 +23,7 @@
 #include "route/route.h"
 #include "common/tabindexes.h"
 
+#include <QSharedPointer>
 #include <QTimer>
 
 namespace atools {
@@ -114,6 +115,15 @@ public:
     return route;
   }
 
+  /* Immutable snapshot of the current flight plan including active leg state. A new snapshot is
+   * swapped in after each change like the simulator data snapshots in MapScreenIndex. Holders
+   * keep a consistent plan for a whole paint or background calculation without locking while
+   * the live route keeps changing. Never null. */
+  QSharedPointer<const Route> getRouteSnapshot() const
+  {
+    return routeSnapshot;
+  }
+
   /* Get a copy of all route map objects (legs) that are selected in the flight plan table view */
   void getSelectedRouteLegs(QList<int>& selLegIndexes) const;
 
@@ -326,6 +336,13 @@ private:
   /* Saves flight plan using LNM format */
   bool saveFlightplanLnmInternal();
 
+  /* Writes a copy of the changed plan to the settings directory for crash recovery.
+   * Called periodically by timer and skips writing if nothing changed since the last run. */
+  void saveCrashRecoveryFlightplan();
+
+  /* Full path of the crash recovery plan in the settings directory */
+  static QString crashRecoveryFilename();
+
   /* Called by route command */
   void changeRouteUndo(const atools::fs::pln::Flightplan& newFlightplan);
 
@@ -367,6 +384,9 @@ private:
 
   void updateTableModel();
 
+  /* Replace the published snapshot with a copy of the current route state */
+  void publishRouteSnapshot();
+
   void routeAltChanged();
   void routeAltChangedDelayed();
 
@@ -376,6 +396,11 @@ private:
 
   /* Calculate flight plan pressed in dock window */
   void calculateRoute();
+
+  /* Load the routing network for the selected type ahead of the first calculation.
+   * Called deferred after showing the calculation window so the load happens during user think time. */
+  void preloadRouteNetwork();
+
   bool calculateRouteInternal(atools::routing::RouteFinder *routeFinder,
                               const QString& commandName,
                               bool fetchAirways, float altitudeFt, int fromIndex, int toIndex,
@@ -431,6 +456,11 @@ private:
   void loadProceduresFromFlightplan(bool clearOldProcedureProperties);
   void loadAlternateFromFlightplan();
 
+  /* Warm the procedure cache for the flight plan airports after loading a plan. Builds one
+   * procedure per event loop pass to avoid blocking the user interface. */
+  void preloadProcedures();
+  void preloadProceduresStep();
+
   void beforeRouteCalc();
   void updateFlightplanEntryAirway(int airwayId, atools::fs::pln::FlightplanEntry& entry);
   QIcon iconForLeg(const RouteLeg& leg, int size) const;
@@ -466,6 +496,9 @@ private:
   /* Selected rows in table. Updated on selection change. */
   QList<int> selectedRows;
 
+  /* Airport and approach id pairs which are still to preload into the procedure cache */
+  QVector<std::pair<map::MapAirport, int> > procedurePreloadQueue;
+
   /* If route distance / direct distance if bigger than this value fail routing */
   static Q_DECL_CONSTEXPR float MAX_DISTANCE_DIRECT_RATIO = 2.0f;
 
@@ -478,12 +511,18 @@ private:
   /* Clean index of the undo stack or -1 if not clean state exists */
   int undoIndexClean = 0;
 
+  /* Undo index written by the last crash recovery save - avoids writing unchanged plans */
+  int undoIndexRecoverySaved = 0;
+
   /* Network cache for flight plan calculation */
   atools::routing::RouteNetwork *routeNetworkRadio = nullptr, *routeNetworkAirway = nullptr;
 
   /* Flightplan and route objects */
   Route route; /* real route containing all segments */
 
+  /* Last published immutable copy of the route above - see getRouteSnapshot() */
+  QSharedPointer<const Route> routeSnapshot;
+
   /* Current filename of empty if no route - also remember start and dest to avoid accidental overwriting */
   QString routeFilename, fileDepartureIdent, fileDestinationIdent;
 
@@ -525,12 +564,21 @@ private:
   /* Timers for updating altitude delayer, clear selection while flying and moving active to top */
   QTimer routeAltDelayTimer, cleanupTableTimer;
 
+  /* Periodic crash recovery save of changed plans */
+  QTimer crashRecoveryTimer;
+
   // Route table colum headings
   QStringList routeColumns, routeColumnTooltips;
   UnitStringTool *units = nullptr;
 
   // Errors collected when parsing route for model
   QStringList errors, procedureErrors, alternateErrors;
+
+  /* Per row fingerprint and errors of the last updateModelHighlights() pass. Rows with an
+   * unchanged fingerprint keep their colors and tooltips and are skipped which limits the
+   * pass to the rows affected by an edit. Cleared on style change to force a full pass. */
+  QStringList modelHighlightStates;
+  QVector<QStringList> modelHighlightErrors;
 };
 
 #endif // LITTLENAVMAP_ROUTECONTROLLER_H
@@ -94,6 +94,7 @@ void RouteLeg::createCopyFromProcedureLeg(int entryIndex, const RouteLeg& leg, c
     type = map::USERPOINTROUTE;
 
   airway = leg.airway;
+  airwayCheckDone = false;
 
   procedureLeg = proc::MapProcedureLeg();
 
@@ -154,7 +155,63 @@ void RouteLeg::assignAnyNavaid(atools::fs::pln::FlightplanEntry *flightplanEntry
   }
 }
 
-void RouteLeg::createFromDatabaseByEntry(int entryIndex, const RouteLeg *prevLeg)
+void RouteLeg::fetchByIdent(map::MapResult& result, MapQuery *mapQuery,
+                            const QHash<QString, map::MapResult> *prefetched, map::MapTypes type,
+                            const QString& ident, const QString& region, const Pos& sortByDistancePos,
+                            float maxDistance)
+{
+  if(prefetched != nullptr && prefetched->contains(ident))
+  {
+    // Candidates were resolved with one set-based query per type for the whole flight plan.
+    // Apply the same region and distance filters as the single ident query would.
+    const map::MapResult& candidates = (*prefetched)[ident];
+
+    if(type & map::AIRPORT)
+    {
+      result.airports.append(candidates.airports);
+      maptools::sortByDistance(result.airports, sortByDistancePos);
+      maptools::removeByDistance(result.airports, sortByDistancePos, maxDistance);
+    }
+
+    if(type & map::VOR)
+    {
+      for(const map::MapVor& vor : candidates.vors)
+      {
+        if(region.isEmpty() || vor.region == region)
+          result.vors.append(vor);
+      }
+      maptools::sortByDistance(result.vors, sortByDistancePos);
+      maptools::removeByDistance(result.vors, sortByDistancePos, maxDistance);
+    }
+
+    if(type & map::NDB)
+    {
+      for(const map::MapNdb& ndb : candidates.ndbs)
+      {
+        if(region.isEmpty() || ndb.region == region)
+          result.ndbs.append(ndb);
+      }
+      maptools::sortByDistance(result.ndbs, sortByDistancePos);
+      maptools::removeByDistance(result.ndbs, sortByDistancePos, maxDistance);
+    }
+
+    if(type & map::WAYPOINT)
+    {
+      for(const map::MapWaypoint& waypoint : candidates.waypoints)
+      {
+        if(region.isEmpty() || waypoint.region == region)
+          result.waypoints.append(waypoint);
+      }
+      maptools::sortByDistance(result.waypoints, sortByDistancePos);
+      maptools::removeByDistance(result.waypoints, sortByDistancePos, maxDistance);
+    }
+  }
+  else
+    mapQuery->getMapObjectByIdent(result, type, ident, region, QString(), sortByDistancePos, maxDistance);
+}
+
+void RouteLeg::createFromDatabaseByEntry(int entryIndex, const RouteLeg *prevLeg,
+                                         const QHash<QString, map::MapResult> *prefetched)
 {
   index = entryIndex;
 
@@ -212,7 +269,8 @@ void RouteLeg::createFromDatabaseByEntry(int entryIndex, const RouteLeg *prevLeg
 
     // ====================== Create for airport and assign parking position
     case atools::fs::pln::entry::AIRPORT:
-      mapQuery->getMapObjectByIdent(mapobjectResult, map::AIRPORT, flightplanEntry->getIdent());
+      fetchByIdent(mapobjectResult, mapQuery, prefetched, map::AIRPORT, flightplanEntry->getIdent(),
+                   QString(), EMPTY_POS, map::INVALID_DISTANCE_VALUE);
       if(!mapobjectResult.airports.isEmpty())
       {
         assignAirport(mapobjectResult, flightplanEntry);
@@ -299,9 +357,9 @@ void RouteLeg::createFromDatabaseByEntry(int entryIndex, const RouteLeg *prevLeg
 
     // =============================== Navaid waypoint
     case atools::fs::pln::entry::WAYPOINT:
-      mapQuery->getMapObjectByIdent(mapobjectResult, map::WAYPOINT | map::AIRPORT,
-                                    flightplanEntry->getIdent(), region, /* region is ignored for airports */
-                                    QString(), flightplanEntry->getPosition(), MAX_WAYPOINT_DISTANCE_METER);
+      fetchByIdent(mapobjectResult, mapQuery, prefetched, map::WAYPOINT | map::AIRPORT,
+                   flightplanEntry->getIdent(), region, /* region is ignored for airports */
+                   flightplanEntry->getPosition(), MAX_WAYPOINT_DISTANCE_METER);
       if(!mapobjectResult.waypoints.isEmpty())
       {
         assignIntersection(mapobjectResult, flightplanEntry);
@@ -324,8 +382,8 @@ void RouteLeg::createFromDatabaseByEntry(int entryIndex, const RouteLeg *prevLeg
 
     // =============================== Navaid VOR
     case atools::fs::pln::entry::VOR:
-      mapQuery->getMapObjectByIdent(mapobjectResult, map::VOR, flightplanEntry->getIdent(), region,
-                                    QString(), flightplanEntry->getPosition(), MAX_WAYPOINT_DISTANCE_METER);
+      fetchByIdent(mapobjectResult, mapQuery, prefetched, map::VOR, flightplanEntry->getIdent(), region,
+                   flightplanEntry->getPosition(), MAX_WAYPOINT_DISTANCE_METER);
       if(!mapobjectResult.vors.isEmpty())
       {
         assignVor(mapobjectResult, flightplanEntry);
@@ -335,8 +393,8 @@ void RouteLeg::createFromDatabaseByEntry(int entryIndex, const RouteLeg *prevLeg
 
     // =============================== Navaid NDB
     case atools::fs::pln::entry::NDB:
-      mapQuery->getMapObjectByIdent(mapobjectResult, map::NDB, flightplanEntry->getIdent(), region,
-                                    QString(), flightplanEntry->getPosition(), MAX_WAYPOINT_DISTANCE_METER);
+      fetchByIdent(mapobjectResult, mapQuery, prefetched, map::NDB, flightplanEntry->getIdent(), region,
+                   flightplanEntry->getPosition(), MAX_WAYPOINT_DISTANCE_METER);
       if(!mapobjectResult.ndbs.isEmpty())
       {
         assignNdb(mapobjectResult, flightplanEntry);
@@ -781,6 +839,21 @@ bool RouteLeg::isApproachPoint() const
 }
 
 bool RouteLeg::isAirwaySetAndInvalid(float altitudeFt, QStringList *errors) const
+{
+  if(!airwayCheckDone || altitudeFt != airwayCheckAltitudeFt)
+  {
+    airwayCheckErrors.clear();
+    airwayCheckInvalid = checkAirway(altitudeFt, &airwayCheckErrors);
+    airwayCheckAltitudeFt = altitudeFt;
+    airwayCheckDone = true;
+  }
+
+  if(errors != nullptr)
+    errors->append(airwayCheckErrors);
+  return airwayCheckInvalid;
+}
+
+bool RouteLeg::checkAirway(float altitudeFt, QStringList *errors) const
 {
   bool invalid = true;
   if(airway.isValid())
@@ -841,6 +914,7 @@ bool RouteLeg::isAirwaySetAndInvalid(float altitudeFt, QStringList *errors) cons
 void RouteLeg::clearAirwayOrTrack()
 {
   airway = map::MapAirway();
+  airwayCheckDone = false;
 }
 
 // TODO assign functions are duplicatd in FlightplanEntryBuilder
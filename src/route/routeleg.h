@@ -55,8 +55,11 @@ public:
    * @param planEntry Flight plan entry used to query database objects. Valid data is written back to the entry.
    * @param query Database query object
    * @param predRouteMapObj Predecessor of this entry or null if this is the first waypoint in the list
+   * @param prefetched Optional candidates resolved with set-based queries for the whole flight plan,
+   * keyed by ident. Avoids the database queries per entry when loading a plan.
    */
-  void createFromDatabaseByEntry(int entryIndex, const RouteLeg *prevLeg);
+  void createFromDatabaseByEntry(int entryIndex, const RouteLeg *prevLeg,
+                                 const QHash<QString, map::MapResult> *prefetched = nullptr);
 
   /*
    * Creates a route map object from an airport database object.
@@ -122,6 +125,7 @@ public:
   void setAirway(const map::MapAirway& value)
   {
     airway = value;
+    airwayCheckDone = false;
   }
 
   /* Get frequency of radio navaid. 0 if not a radio navaid. Source is always database. */
@@ -315,7 +319,9 @@ public:
     return index;
   }
 
-  /* true if airway given but not found in database. Also true if one-way direction is violated */
+  /* true if airway given but not found in database. Also true if one-way direction is violated.
+   * The verdict is memoized per cruise altitude - repeated calls from the table highlighting
+   * and the painters are cheap. */
   bool isAirwaySetAndInvalid(float altitudeFt, QStringList *errors = nullptr) const;
 
   bool isTrack() const
@@ -345,6 +351,15 @@ private:
   void assignAirport(const map::MapResult& mapobjectResult, atools::fs::pln::FlightplanEntry *flightplanEntry);
   void assignUser(atools::fs::pln::FlightplanEntry *flightplanEntry);
 
+  /* Use candidates from the prefetched hash and apply the same region and distance filters as the
+   * single ident query. Falls back to the database query per entry if nothing was prefetched. */
+  void fetchByIdent(map::MapResult& result, MapQuery *mapQuery,
+                    const QHash<QString, map::MapResult> *prefetched, map::MapTypes type, const QString& ident,
+                    const QString& region, const atools::geo::Pos& sortByDistancePos, float maxDistance);
+
+  /* Airway restriction check behind isAirwaySetAndInvalid() */
+  bool checkAirway(float altitudeFt, QStringList *errors) const;
+
   /* Parent flight plan */
   atools::fs::pln::Flightplan *flightplan = nullptr;
   /* Associated flight plan entry or approach leg entry */
@@ -364,6 +379,12 @@ private:
 
   bool validWaypoint = false, alternate = false, valid = false;
 
+  /* Memoized verdict of isAirwaySetAndInvalid(). The airway can only change together with the
+   * leg which resets the flag - the cruise altitude is the only variable input of the check. */
+  mutable QStringList airwayCheckErrors;
+  mutable float airwayCheckAltitudeFt = 0.f;
+  mutable bool airwayCheckDone = false, airwayCheckInvalid = false;
+
   float distanceTo = 0.f,
         courseTo = 0.f,
         groundAltitude = 0.f,
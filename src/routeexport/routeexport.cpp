@@ -98,11 +98,21 @@ void RouteExport::routeMultiExport()
   {
     // Export all button or menu item
     int numExported = 0;
+
+    // Most formats use the same adjust options - let buildAdjustedRoute() build each
+    // snapshot only once for the whole run instead of once per format
+    multiExportRunning = true;
+    adjustedRouteCache.clear();
+
     for(const RouteExportFormat& fmt : exportFormatMap->getSelected())
     {
       if(fmt.isSelected() && fmt.isPathValid())
         numExported += fmt.callExport();
     }
+
+    multiExportRunning = false;
+    adjustedRouteCache.clear();
+
     mainWindow->setStatusMessage(tr("Exported %1 flight plans.").arg(numExported));
   }
 }
@@ -1574,6 +1584,19 @@ bool RouteExport::exportFlightplanAsGpx(const QString& filename)
 
 Route RouteExport::buildAdjustedRoute(rf::RouteAdjustOptions options)
 {
+  if(multiExportRunning)
+  {
+    // Multiexport writes many formats from the same snapshot - build it only once per
+    // run and options combination. The returned copy shares the plan copy-on-write.
+    auto it = adjustedRouteCache.constFind(static_cast<int>(options));
+    if(it != adjustedRouteCache.constEnd())
+      return it.value();
+
+    Route route = buildAdjustedRoute(NavApp::getRoute(), options);
+    adjustedRouteCache.insert(static_cast<int>(options), route);
+    return route;
+  }
+
   return buildAdjustedRoute(NavApp::getRoute(), options);
 }
 
@@ -21,6 +21,7 @@
 #include "route/routeflags.h"
 #include "routeexport/routeexportflags.h"
 
+#include <QHash>
 #include <QObject>
 #include <functional>
 
@@ -275,6 +276,13 @@ private:
   /* Create a list of backups */
   void rotateFile(const QString& filename);
 
+  /* Adjusted route snapshots built during a multiexport run keyed by the adjust options.
+   * Avoids building the same snapshot again for every format. */
+  QHash<int, Route> adjustedRouteCache;
+
+  /* true while routeMultiExport() is running and the cache above is valid */
+  bool multiExportRunning = false;
+
   MainWindow *mainWindow;
   atools::gui::Dialog *dialog;
   RouteMultiExportDialog *exportAllDialog;
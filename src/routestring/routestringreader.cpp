@@ -202,6 +202,9 @@ bool RouteStringReader::createRouteFromString(const QString& routeString, rs::Ro
   qDebug() << Q_FUNC_INFO << "after start" << timer.restart();
 #endif
 
+  // Fetch all plain ident candidates with batched queries to avoid one query set per item
+  prefetchNavaids(cleanItems);
+
   QList<ParseEntry> resultList;
   for(const QString& item : cleanItems)
   {
@@ -222,6 +225,9 @@ bool RouteStringReader::createRouteFromString(const QString& routeString, rs::Ro
       appendWarning(tr("Nothing found for %1. Ignoring.").arg(item));
   }
 
+  // Candidates are not needed any longer
+  batchedResults.clear();
+
 #ifdef DEBUG_INFORMATION
   qDebug() << Q_FUNC_INFO << "after collecting navaids" << timer.restart();
 #endif
@@ -1190,6 +1196,21 @@ void RouteStringReader::filterAirways(QList<ParseEntry>& resultList, int i)
   }
 }
 
+void RouteStringReader::prefetchNavaids(const QStringList& cleanItems)
+{
+  batchedResults.clear();
+
+  // Collect all unique plain idents - longer items are coordinates which are not queried
+  QSet<QString> idents;
+  for(const QString& item : cleanItems)
+  {
+    if(item.length() <= 5)
+      idents.insert(item);
+  }
+
+  mapQuery->getMapObjectsByIdents(batchedResults, ROUTE_TYPES_AND_AIRWAY, idents);
+}
+
 void RouteStringReader::findWaypoints(MapResult& result, const QString& item, bool matchWaypoints)
 {
   bool searchCoords = false;
@@ -1198,7 +1219,11 @@ void RouteStringReader::findWaypoints(MapResult& result, const QString& item, bo
     searchCoords = true;
   else
   {
-    mapQuery->getMapObjectByIdent(result, ROUTE_TYPES_AND_AIRWAY, item);
+    if(batchedResults.contains(item))
+      // Use candidates collected by prefetchNavaids() - copy since the result is modified later
+      result = batchedResults.value(item);
+    else
+      mapQuery->getMapObjectByIdent(result, ROUTE_TYPES_AND_AIRWAY, item);
 
     if(item.length() == 5 && result.waypoints.isEmpty())
       // Nothing found - try NAT waypoint (a few of these are also in the database)
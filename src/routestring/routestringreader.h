@@ -23,6 +23,7 @@
 
 #include <QStringList>
 #include <QApplication>
+#include <QHash>
 
 namespace atools {
 namespace fs {
@@ -122,6 +123,10 @@ private:
    * to waypoints like oceaninc or confluence points.*/
   void findWaypoints(map::MapResult& result, const QString& item, bool matchWaypoints);
 
+  /* Resolve all plain idents of the item list with batched queries and remember the candidates for
+   * findWaypoints(). Avoids one set of database queries per item. */
+  void prefetchNavaids(const QStringList& cleanItems);
+
   /* Get nearest waypoint for given position probably removing ones which are too far away. Changes given result.
    * Also checks airways and connections if lastResult is given. */
   void filterWaypoints(map::MapResult& result, atools::geo::Pos& lastPos, const map::MapResult *lastResult,
@@ -162,6 +167,10 @@ private:
   ProcedureQuery *procQuery = nullptr;
   FlightplanEntryBuilder *entryBuilder = nullptr;
   QStringList messages;
+
+  /* Candidates from the batched lookup keyed by item - used by findWaypoints() */
+  QHash<QString, map::MapResult> batchedResults;
+
   bool plaintextMessages = false, hasWarnings = false, hasErrors = false;
 };
 
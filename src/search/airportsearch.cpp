@@ -151,7 +151,7 @@ AirportSearch::AirportSearch(QMainWindow *parent, QTableView *tableView, si::Tab
   append(Column("airport_id").hidden()).
   append(Column("distance", tr("Distance\n%dist%")).distanceCol()).
   append(Column("heading", tr("Heading\n°T")).distanceCol()).
-  append(Column("ident", ui->lineEditAirportIcaoSearch, tr("ICAO")).filter().defaultSort().
+  append(Column("ident", ui->lineEditAirportIcaoSearch, tr("ICAO")).filter().defaultSort().upperIdent().
          override ().minOverrideLength(3)).
   append(Column("name", ui->lineEditAirportNameSearch, tr("Name")).filter()).
 
@@ -372,7 +372,10 @@ void AirportSearch::restoreState()
   atools::gui::WidgetState widgetState(lnm::SEARCHTAB_AIRPORT_WIDGET);
   if(OptionData::instance().getFlags() & opts::STARTUP_LOAD_SEARCH)
   {
+    // Run the query only once after all filter widgets are restored instead of once per widget
+    controller->beginRestore();
     widgetState.restore(airportSearchWidgets);
+    controller->endRestore();
 
     // Need to block signals here to avoid unwanted behavior (will enable
     // distance search and avoid saving of wrong view widget state)
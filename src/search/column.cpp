@@ -144,6 +144,12 @@ Column& Column::distanceCol(bool value)
   return *this;
 }
 
+Column& Column::upperIdent(bool value)
+{
+  colIsUpperIdent = value;
+  return *this;
+}
+
 QLineEdit *Column::getLineEditWidget() const
 {
   return dynamic_cast<QLineEdit *>(colWidget);
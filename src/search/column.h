@@ -91,6 +91,10 @@ public:
   /* Can be set to indicate that this is one of the tow distance search special columns "distance" and "heading". */
   Column& distanceCol(bool value = true);
 
+  /* Column contains only upper case idents. Prefix "like" filters get an additional index
+   * friendly range condition which avoids a full table scan. */
+  Column& upperIdent(bool value = true);
+
   /* Indicates a condition that should be use for a spin box value, i.e. ">", "<" etc. */
   Column& condition(const QString& cond);
 
@@ -167,6 +171,11 @@ public:
     return colIsDistance;
   }
 
+  bool isUpperIdent() const
+  {
+    return colIsUpperIdent;
+  }
+
   bool isDefaultSort() const
   {
     return colIsDefaultSortColumn;
@@ -277,6 +286,7 @@ private:
   bool colIsHiddenColumn = false;
   bool colQueryIncludesName = false;
   bool colIsDistance = false;
+  bool colIsUpperIdent = false;
 
   Qt::SortOrder colDefaultSortOrd = Qt::SortOrder::AscendingOrder;
 };
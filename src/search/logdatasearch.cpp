@@ -221,7 +221,10 @@ void LogdataSearch::restoreState()
   atools::gui::WidgetState widgetState(lnm::SEARCHTAB_LOGDATA_VIEW_WIDGET);
   if(OptionData::instance().getFlags() & opts::STARTUP_LOAD_SEARCH)
   {
+    // Run the query only once after all filter widgets are restored instead of once per widget
+    controller->beginRestore();
     widgetState.restore(logdataSearchWidgets);
+    controller->endRestore();
 
     restoreViewState(false);
 
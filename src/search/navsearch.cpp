@@ -136,7 +136,7 @@ NavSearch::NavSearch(QMainWindow *parent, QTableView *tableView, si::TabSearchId
   append(Column("nav_search_id").hidden()).
   append(Column("distance", tr("Distance\n%dist%")).distanceCol()).
   append(Column("heading", tr("Heading\n°T")).distanceCol()).
-  append(Column("ident", ui->lineEditNavIcaoSearch, tr("ICAO")).filter().defaultSort()).
+  append(Column("ident", ui->lineEditNavIcaoSearch, tr("ICAO")).filter().defaultSort().upperIdent()).
 
   append(Column("nav_type", ui->comboBoxNavNavAidSearch, tr("Navaid\nType")).
          indexCondMap(navTypeCondMap).includesName()).
@@ -265,7 +265,10 @@ void NavSearch::restoreState()
   atools::gui::WidgetState widgetState(lnm::SEARCHTAB_NAV_WIDGET);
   if(OptionData::instance().getFlags() & opts::STARTUP_LOAD_SEARCH)
   {
+    // Run the query only once after all filter widgets are restored instead of once per widget
+    controller->beginRestore();
     widgetState.restore(navSearchWidgets);
+    controller->endRestore();
 
     // Need to block signals here to avoid unwanted behavior (will enable
     // distance search and avoid saving of wrong view widget state)
@@ -131,7 +131,10 @@ void OnlineCenterSearch::restoreState()
   if(OptionData::instance().getFlags() & opts::STARTUP_LOAD_SEARCH)
   {
     atools::gui::WidgetState widgetState(lnm::SEARCHTAB_ONLINE_CENTER_VIEW_WIDGET);
+    // Run the query only once after all filter widgets are restored instead of once per widget
+    controller->beginRestore();
     widgetState.restore(onlineCenterSearchWidgets);
+    controller->endRestore();
 
     restoreViewState(false);
 
@@ -130,7 +130,10 @@ void OnlineClientSearch::restoreState()
   if(OptionData::instance().getFlags() & opts::STARTUP_LOAD_SEARCH)
   {
     atools::gui::WidgetState widgetState(lnm::SEARCHTAB_ONLINE_CLIENT_VIEW_WIDGET);
+    // Run the query only once after all filter widgets are restored instead of once per widget
+    controller->beginRestore();
     widgetState.restore(onlineClientSearchWidgets);
+    controller->endRestore();
 
     restoreViewState(false);
 
@@ -237,6 +237,7 @@ void ProcedureSearch::preDatabaseLoad()
   itemLoadedIndex.clear();
   currentAirportNav = map::MapAirport();
   recentTreeState.clear();
+  procedureRecordCache.clear();
 }
 
 void ProcedureSearch::postDatabaseLoad()
@@ -256,6 +257,12 @@ void ProcedureSearch::showProcedures(map::MapAirport airport)
   NavApp::getSearchController()->setCurrentSearchTabId(si::SEARCH_PROC);
   treeWidget->setFocus();
 
+  // Block the filter boxes - the tree is filled once below instead of once per changed box
+  int oldFilterIndex = ui->comboBoxProcedureSearchFilter->currentIndex();
+  int oldRunwayFilterIndex = ui->comboBoxProcedureRunwayFilter->currentIndex();
+  ui->comboBoxProcedureSearchFilter->blockSignals(true);
+  ui->comboBoxProcedureRunwayFilter->blockSignals(true);
+
   if(NavApp::getRouteConst().isAirportDeparture(airport.ident))
   {
     ui->comboBoxProcedureSearchFilter->setCurrentIndex(FILTER_DEPARTURE_PROCEDURES);
@@ -269,9 +276,22 @@ void ProcedureSearch::showProcedures(map::MapAirport airport)
   else
     ui->comboBoxProcedureSearchFilter->setCurrentIndex(FILTER_ALL_PROCEDURES);
 
+  filterIndex = static_cast<FilterIndex>(ui->comboBoxProcedureSearchFilter->currentIndex());
+  ui->comboBoxProcedureSearchFilter->blockSignals(false);
+  ui->comboBoxProcedureRunwayFilter->blockSignals(false);
+
   if(currentAirportNav.isValid() && currentAirportNav.ident == airport.ident)
+  {
     // Ignore if noting has changed - or jump out of the view mode
+    if(oldFilterIndex != ui->comboBoxProcedureSearchFilter->currentIndex() ||
+       oldRunwayFilterIndex != ui->comboBoxProcedureRunwayFilter->currentIndex())
+    {
+      // Same airport but the filters above changed - refill the tree once
+      treeWidget->clearSelection();
+      fillApproachTreeWidget();
+    }
     return;
+  }
 
   emit procedureLegSelected(proc::MapProcedureRef());
   emit procedureSelected(proc::MapProcedureRef());
@@ -380,16 +400,13 @@ void ProcedureSearch::updateFilterBoxes()
 
   if(currentAirportNav.isValid())
   {
-    QStringList runwayNames = airportQuery->getRunwayNames(currentAirportNav.id);
+    const SqlRecordVector *procedures = getProcedureRecords();
 
-    // Add a tree of transitions and approaches
-    const SqlRecordVector *recAppVector = infoQuery->getApproachInformation(currentAirportNav.id);
-
-    if(recAppVector != nullptr) // Deduplicate runways
+    if(procedures != nullptr) // Deduplicate runways
     {
       QSet<QString> runways;
-      for(const SqlRecord& recApp : *recAppVector)
-        runways.insert(map::runwayBestFit(recApp.valueStr("runway_name"), runwayNames));
+      for(const SqlRecord& recApp : *procedures)
+        runways.insert(recApp.valueStr("airport_runway_name"));
 
       // Sort list of runways
       QList<QString> runwaylist = runways.toList();
@@ -403,11 +420,93 @@ void ProcedureSearch::updateFilterBoxes()
           ui->comboBoxProcedureRunwayFilter->addItem(tr("Runway %1").arg(rw), rw);
       }
     }
-    else
-      qWarning() << Q_FUNC_INFO << "nothing found for airport id" << currentAirportNav.id;
   }
 }
 
+const SqlRecordVector *ProcedureSearch::getProcedureRecords()
+{
+  const SqlRecordVector *cached = procedureRecordCache.object(currentAirportNav.id);
+  if(cached != nullptr)
+    return cached;
+
+  const SqlRecordVector *recAppVector = infoQuery->getApproachInformation(currentAirportNav.id);
+  if(recAppVector == nullptr)
+  {
+    qWarning() << Q_FUNC_INFO << "nothing found for airport id" << currentAirportNav.id;
+    return nullptr;
+  }
+
+  QStringList runwayNames = airportQuery->getRunwayNames(currentAirportNav.id);
+  SqlRecordVector *records = new SqlRecordVector;
+
+  for(SqlRecord recApp : *recAppVector)
+  {
+    QString rwname = map::runwayBestFit(recApp.valueStr("runway_name"), runwayNames);
+
+    proc::MapProcedureTypes type = buildTypeFromApproachRec(recApp);
+
+    // Resolve parallel runway assignments
+    QStringList sidStarArincNames, sidStarRunways;
+    if((type& proc::PROCEDURE_SID) || (type & proc::PROCEDURE_STAR))
+    {
+      // arinc_name - added with database minor version 8
+      QString arincName = recApp.valueStr("arinc_name", QString());
+      if(proc::hasSidStarAllRunways(arincName))
+      {
+        sidStarArincNames.append(tr("All"));
+        sidStarRunways.append(runwayNames);
+      }
+      else if(proc::hasSidStarParallelRunways(arincName))
+      {
+        // Check which runways are assigned from values like "RW12B"
+        arincName = arincName.mid(2, 2);
+        if(runwayNames.contains(arincName + "L"))
+        {
+          sidStarArincNames.append(arincName + "L");
+          sidStarRunways.append(arincName + "L");
+        }
+        if(runwayNames.contains(arincName + "R"))
+        {
+          sidStarArincNames.append(arincName + "R");
+          sidStarRunways.append(arincName + "R");
+        }
+        if(runwayNames.contains(arincName + "C"))
+        {
+          sidStarArincNames.append(arincName + "C");
+          sidStarRunways.append(arincName + "C");
+        }
+      }
+#ifdef DEBUG_INFORMATION
+      else if(!arincName.isEmpty())
+        sidStarArincNames.append("(" + arincName + ")");
+#endif
+    }
+
+    // Add an extra field with the best airport runway name
+    recApp.appendField("airport_runway_name", QVariant::String);
+    recApp.setValue("airport_runway_name", rwname);
+
+    // Keep the runways for the context menu
+    recApp.appendField("sid_star_runways", QVariant::StringList);
+    recApp.setValue("sid_star_runways", sidStarRunways);
+
+    // Keep all assigned names for the runway filter
+    recApp.appendField("sid_star_arinc_names", QVariant::StringList);
+    recApp.setValue("sid_star_arinc_names", sidStarArincNames);
+
+    recApp.appendField("sid_star_arinc_name", QVariant::String);
+    if(((type& proc::PROCEDURE_SID) || (type & proc::PROCEDURE_STAR)) && rwname.isEmpty())
+      recApp.setValue("sid_star_arinc_name", sidStarArincNames.join("/"));
+
+    records->append(recApp);
+  }
+
+  std::sort(records->begin(), records->end(), procedureSortFunc);
+
+  procedureRecordCache.insert(currentAirportNav.id, records);
+  return records;
+}
+
 void ProcedureSearch::fillApproachTreeWidget()
 {
   treeWidget->blockSignals(true);
@@ -417,21 +516,31 @@ void ProcedureSearch::fillApproachTreeWidget()
 
   if(currentAirportNav.isValid())
   {
-    // Add a tree of transitions and approaches
-    const SqlRecordVector *recAppVector = infoQuery->getApproachInformation(currentAirportNav.id);
+    // Materialized tree of transitions and approaches with all derived fields attached
+    const SqlRecordVector *procedures = getProcedureRecords();
 
-    if(recAppVector != nullptr)
+    if(procedures != nullptr)
     {
-      QStringList runwayNames = airportQuery->getRunwayNames(currentAirportNav.id);
       Ui::MainWindow *ui = NavApp::getMainUi();
       QTreeWidgetItem *root = treeWidget->invisibleRootItem();
-      SqlRecordVector sorted;
 
-      // Collect all procedures from the database
-      for(SqlRecord recApp : *recAppVector)
+      QString allRunwayText = tr("All");
+      QString rwnamefilter = ui->comboBoxProcedureRunwayFilter->currentData(Qt::UserRole).toString();
+      int rwnameindex = ui->comboBoxProcedureRunwayFilter->currentIndex();
+
+      // Get the transitions of all approaches with one query instead of one query per
+      // approach item which adds up at large airports with a full procedure database
+      QMultiHash<int, SqlRecord> transitionsByApproachId;
+      const SqlRecordVector *recAllTransVector = infoQuery->getTransitionInformationForAirport(currentAirportNav.id);
+      if(recAllTransVector != nullptr)
       {
-        QString rwname = map::runwayBestFit(recApp.valueStr("runway_name"), runwayNames);
+        // Insert in reverse since QMultiHash returns values in reverse insertion order
+        for(int i = recAllTransVector->size() - 1; i >= 0; i--)
+          transitionsByApproachId.insert(recAllTransVector->at(i).valueInt("approach_id"), recAllTransVector->at(i));
+      }
 
+      for(const SqlRecord& recApp : *procedures)
+      {
         proc::MapProcedureTypes type = buildTypeFromApproachRec(recApp);
 
         bool filterOk = false;
@@ -451,46 +560,8 @@ void ProcedureSearch::fillApproachTreeWidget()
             break;
         }
 
-        // Resolve parallel runway assignments
-        QString allRunwayText = tr("All");
-        QStringList sidStarArincNames, sidStarRunways;
-        if((type& proc::PROCEDURE_SID) || (type & proc::PROCEDURE_STAR))
-        {
-          // arinc_name - added with database minor version 8
-          QString arincName = recApp.valueStr("arinc_name", QString());
-          if(proc::hasSidStarAllRunways(arincName))
-          {
-            sidStarArincNames.append(allRunwayText);
-            sidStarRunways.append(runwayNames);
-          }
-          else if(proc::hasSidStarParallelRunways(arincName))
-          {
-            // Check which runways are assigned from values like "RW12B"
-            arincName = arincName.mid(2, 2);
-            if(runwayNames.contains(arincName + "L"))
-            {
-              sidStarArincNames.append(arincName + "L");
-              sidStarRunways.append(arincName + "L");
-            }
-            if(runwayNames.contains(arincName + "R"))
-            {
-              sidStarArincNames.append(arincName + "R");
-              sidStarRunways.append(arincName + "R");
-            }
-            if(runwayNames.contains(arincName + "C"))
-            {
-              sidStarArincNames.append(arincName + "C");
-              sidStarRunways.append(arincName + "C");
-            }
-          }
-#ifdef DEBUG_INFORMATION
-          else if(!arincName.isEmpty())
-            sidStarArincNames.append("(" + arincName + ")");
-#endif
-        }
-
-        QString rwnamefilter = ui->comboBoxProcedureRunwayFilter->currentData(Qt::UserRole).toString();
-        int rwnameindex = ui->comboBoxProcedureRunwayFilter->currentIndex();
+        QString rwname = recApp.valueStr("airport_runway_name");
+        QStringList sidStarArincNames = recApp.value("sid_star_arinc_names").toStringList();
 
         if(rwnameindex == 0)
           // All selected
@@ -505,50 +576,25 @@ void ProcedureSearch::fillApproachTreeWidget()
                       sidStarArincNames.contains(allRunwayText);
         }
 
-        if(filterOk)
-        {
-          // Add an extra field with the best airport runway name
-          recApp.appendField("airport_runway_name", QVariant::String);
-          recApp.setValue("airport_runway_name", rwname);
-
-          // Keep the runways for the context menu
-          recApp.appendField("sid_star_runways", QVariant::StringList);
-          recApp.setValue("sid_star_runways", sidStarRunways);
-
-          recApp.appendField("sid_star_arinc_name", QVariant::String);
-          if(((type& proc::PROCEDURE_SID) || (type & proc::PROCEDURE_STAR)) && rwname.isEmpty())
-            recApp.setValue("sid_star_arinc_name", sidStarArincNames.join("/"));
-
-          sorted.append(recApp);
-        }
-      }
-
-      std::sort(sorted.begin(), sorted.end(), procedureSortFunc);
-
-      for(const SqlRecord& recApp : sorted)
-      {
-        proc::MapProcedureTypes type = buildTypeFromApproachRec(recApp);
+        if(!filterOk)
+          continue;
 
         int runwayEndId = recApp.valueInt("runway_end_id");
         QStringList sidStarRunways = recApp.value("sid_star_runways").toStringList();
 
         int apprId = recApp.valueInt("approach_id");
         itemIndex.append({MapProcedureRef(currentAirportNav.id, runwayEndId, apprId, -1, -1, type), sidStarRunways});
-        const SqlRecordVector *recTransVector = infoQuery->getTransitionInformation(recApp.valueInt("approach_id"));
 
         QTreeWidgetItem *apprItem = buildApproachItem(root, recApp, type);
 
-        if(recTransVector != nullptr)
+        // Transitions for this approach
+        for(const SqlRecord& recTrans : transitionsByApproachId.values(apprId))
         {
-          // Transitions for this approach
-          for(const SqlRecord& recTrans : *recTransVector)
-          {
-            // Also add runway from parent approach to transition
-            itemIndex.append({MapProcedureRef(currentAirportNav.id, runwayEndId, apprId,
-                                              recTrans.valueInt("transition_id"), -1, type), sidStarRunways});
-            buildTransitionItem(apprItem, recTrans,
-                                type & proc::PROCEDURE_DEPARTURE || type & proc::PROCEDURE_STAR_ALL);
-          }
+          // Also add runway from parent approach to transition
+          itemIndex.append({MapProcedureRef(currentAirportNav.id, runwayEndId, apprId,
+                                            recTrans.valueInt("transition_id"), -1, type), sidStarRunways});
+          buildTransitionItem(apprItem, recTrans,
+                              type & proc::PROCEDURE_DEPARTURE || type & proc::PROCEDURE_STAR_ALL);
         }
       }
     }
@@ -20,8 +20,10 @@
 
 #include "common/proctypes.h"
 #include "search/abstractsearch.h"
+#include "sql/sqlrecord.h"
 
 #include <QBitArray>
+#include <QCache>
 #include <QFont>
 #include <QObject>
 #include <QVector>
@@ -174,6 +176,11 @@ private:
 
   void fillApproachTreeWidget();
 
+  /* Procedure records of the current airport with the derived runway and ARINC fields attached
+   * and sorted for display. Materialized on first access per airport and kept until the next
+   * database load since procedures only change with the database cycle. */
+  const atools::sql::SqlRecordVector *getProcedureRecords();
+
   /* Fill header for tree or selected/table view */
   void updateTreeHeader();
   void createFonts();
@@ -216,6 +223,9 @@ private:
   // Maps airport ID to expanded state of the tree widget items - bit array is same content as itemLoadedIndex
   QHash<int, QBitArray> recentTreeState;
 
+  // Materialized procedure records by airport id - see getProcedureRecords()
+  QCache<int, atools::sql::SqlRecordVector> procedureRecordCache;
+
   atools::gui::GridDelegate *gridDelegate = nullptr;
 
   FilterIndex filterIndex = FILTER_ALL_PROCEDURES;
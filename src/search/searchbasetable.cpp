@@ -582,6 +582,9 @@ void SearchBaseTable::connectSearchSlots()
   connect(controller->getSqlModel(), &SqlModel::modelReset, this, &SearchBaseTable::reconnectSelectionModel);
   connect(controller->getSqlModel(), &SqlModel::fetchedMore, this, &SearchBaseTable::fetchedMore);
 
+  // Update the result count label once a deferred count query has finished
+  connect(controller->getSqlModel(), &SqlModel::totalRowCountUpdated, this, &SearchBaseTable::fetchedMore);
+
   connect(ui->dockWidgetSearch, &QDockWidget::visibilityChanged, this, &SearchBaseTable::dockVisibilityChanged);
 }
 
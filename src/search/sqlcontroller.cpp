@@ -425,6 +425,18 @@ void SqlController::resetSearch()
     model->resetSearch();
 }
 
+void SqlController::beginRestore()
+{
+  if(model != nullptr)
+    model->beginRestore();
+}
+
+void SqlController::endRestore()
+{
+  if(model != nullptr)
+    model->endRestore();
+}
+
 QString SqlController::getCurrentSqlQuery() const
 {
   return model->getCurrentSqlQuery();
@@ -57,6 +57,11 @@ public:
   /* Clear search and erase all text in search widgets */
   void resetSearch();
 
+  /* Suspends query execution while the saved search widget state is restored at startup.
+   * endRestore() builds and runs the query once for the accumulated filters. */
+  void beginRestore();
+  void endRestore();
+
   /* Filter by using query builder callback */
   void filterByBuilder(const QueryBuilder& builder);
 
@@ -31,6 +31,7 @@
 #include <QSqlError>
 #include <QRegularExpression>
 #include <QComboBox>
+#include <QTimer>
 
 using atools::sql::SqlQuery;
 using atools::sql::SqlDatabase;
@@ -323,6 +324,25 @@ void SqlModel::resetSearch()
   // no need to rebuild header - view remains the same
 }
 
+void SqlModel::beginRestore()
+{
+  restoreActive = true;
+  restoreQueryPending = false;
+}
+
+void SqlModel::endRestore()
+{
+  restoreActive = false;
+
+  if(restoreQueryPending)
+  {
+    // One or more filter widgets were restored to a non-default value - run the query
+    // once for the combined filters
+    restoreQueryPending = false;
+    buildQuery();
+  }
+}
+
 /* Clear all query conditions */
 void SqlModel::clearWhereConditions()
 {
@@ -350,7 +370,15 @@ const Column *SqlModel::getColumnModel(const QString& colName) const
 
 const Column *SqlModel::getColumnModel(int colIndex) const
 {
-  return columns->getColumn(getSqlRecord().fieldName(colIndex));
+  // Fill the cache on first use since this runs for every cell and role while scrolling
+  // and getSqlRecord() builds a full record copy for each call
+  if(columnIndexCache.isEmpty())
+  {
+    atools::sql::SqlRecord sqlRecord = getSqlRecord();
+    for(int i = 0; i < sqlRecord.count(); i++)
+      columnIndexCache.append(columns->getColumn(sqlRecord.fieldName(i)));
+  }
+  return columnIndexCache.value(colIndex, nullptr);
 }
 
 QString SqlModel::sortOrderToSql(Qt::SortOrder order)
@@ -418,6 +446,14 @@ QString SqlModel::buildColumnList(const atools::sql::SqlRecord& tableCols)
 /* Create SQL query and set it into the model */
 void SqlModel::buildQuery()
 {
+  if(restoreActive)
+  {
+    // Search widget state is being restored - collect all changes and run the query
+    // only once in endRestore()
+    restoreQueryPending = true;
+    return;
+  }
+
   atools::sql::SqlRecord tableCols = db->record(columns->getTablename());
   QString queryCols = buildColumnList(tableCols);
 
@@ -471,12 +507,32 @@ void SqlModel::buildQuery()
 
   try
   {
-    // Count total rows
-    updateTotalCount();
-
     if(!boundingRect.isValid())
+    {
       // Delay query for bounding rectangle query with proxy model
       resetSqlQuery();
+
+      if(queryWhere.isEmpty())
+      {
+        // Unfiltered query - table size only changes with the database. Count once and reuse the value.
+        if(unfilteredRowCount < 0)
+        {
+          updateTotalCount();
+          unfilteredRowCount = totalRowCount;
+        }
+        else
+          totalRowCount = unfilteredRowCount;
+      }
+      else if(!canFetchMore(QModelIndex()))
+        // Whole result fits into the first page - no need to run the count query
+        totalRowCount = rowCount();
+      else
+        // Defer the count query to the event loop so the first page is shown immediately while typing
+        scheduleTotalCount();
+    }
+    else
+      // Count total rows
+      updateTotalCount();
   }
   catch(atools::Exception& e)
   {
@@ -503,6 +559,33 @@ void SqlModel::updateTotalCount()
     totalRowCount = 0;
 }
 
+/* Run the count query for the current filter in the next event loop pass.
+ * Keeps the keystroke response in the search widgets immediate. */
+void SqlModel::scheduleTotalCount()
+{
+  int seq = ++totalCountSeq;
+  QTimer::singleShot(0, this, [ = ]()
+  {
+    if(seq != totalCountSeq)
+      // A newer filter or sort order has superseded this count
+      return;
+
+    try
+    {
+      updateTotalCount();
+      emit totalRowCountUpdated();
+    }
+    catch(atools::Exception& e)
+    {
+      ATOOLS_HANDLE_EXCEPTION(e);
+    }
+    catch(...)
+    {
+      ATOOLS_HANDLE_UNKNOWN_EXCEPTION;
+    }
+  });
+}
+
 /* Build where statement */
 QString SqlModel::buildWhere(const atools::sql::SqlRecord& tableCols, QVector<const Column *>& overrideColumns)
 {
@@ -574,14 +657,38 @@ QString SqlModel::buildWhere(const atools::sql::SqlRecord& tableCols, QVector<co
     if(numCond++ > 0)
       queryWhere += " " + WHERE_OPERATOR + " ";
 
+    QString condStr;
     if(cond.col->isIncludesName())
       // Condition includes column name
-      queryWhere += " " + cond.oper + " ";
+      condStr = " " + cond.oper + " ";
     else
-      queryWhere += cond.col->getColumnName() + " " + cond.oper + " ";
+      condStr = cond.col->getColumnName() + " " + cond.oper + " ";
 
     if(!cond.valueSql.isNull())
-      queryWhere += buildWhereValue(cond);
+      condStr += buildWhereValue(cond);
+
+    // "like" alone cannot use the column index since it is case insensitive. For pure prefix
+    // patterns on upper case ident columns add a redundant range condition which allows
+    // SQLite to narrow the scan through the index. The stored idents are upper case so the
+    // range keeps exactly the rows the "like" matches.
+    if(cond.col->isUpperIdent() && cond.oper == "like" && cond.valueSql.type() == QVariant::String)
+    {
+      QString pattern = cond.valueSql.toString();
+      QString prefix = pattern.left(pattern.size() - 1).toUpper();
+      if(pattern.endsWith('%') && !prefix.isEmpty() &&
+         !prefix.contains('%') && !prefix.contains('_') && !prefix.contains('\'') &&
+         prefix.at(prefix.size() - 1).unicode() < 0xffff)
+      {
+        // Increment the last character to get the exclusive upper bound of the range
+        QString upperBound = prefix;
+        upperBound[upperBound.size() - 1] = QChar(static_cast<ushort>(prefix.at(prefix.size() - 1).unicode() + 1));
+
+        const QString& colName = cond.col->getColumnName();
+        condStr = "(" + condStr + " and " + colName + " >= '" + prefix + "' and " +
+                  colName + " < '" + upperBound + "')";
+      }
+    }
+    queryWhere += condStr;
   }
 
   // Add where clause from callback ======================
@@ -654,6 +761,9 @@ QString SqlModel::buildWhereValue(const WhereCondition& cond)
 
 void SqlModel::refreshData()
 {
+  // Table content has changed - drop the cached unfiltered count
+  unfilteredRowCount = -1;
+
   resetSqlQuery();
   updateTotalCount();
 }
@@ -662,6 +772,9 @@ void SqlModel::resetSqlQuery()
 {
   QSqlQueryModel::setQuery(currentSqlQuery, db->getQSqlDatabase());
 
+  // Column layout might have changed with the query
+  columnIndexCache.clear();
+
   if(lastError().isValid())
     atools::gui::ErrorHandler(parentWidget).handleSqlError(lastError());
 }
@@ -701,8 +814,7 @@ QVariant SqlModel::data(const QModelIndex& index, int role) const
 
     // Get data to display
     QVariant dataValue = QSqlQueryModel::data(index, Qt::DisplayRole);
-    QString col = getSqlRecord().fieldName(index.column());
-    const Column *column = columns->getColumn(col);
+    const Column *column = getColumnModel(index.column());
 
     int row = -1;
     if(!boundingRect.isValid())
@@ -729,6 +841,9 @@ QVariant SqlModel::getRawData(int row, const QString& colname) const
 
 void SqlModel::updateSqlQuery()
 {
+  // Called after switching databases - the cached count is no longer valid
+  unfilteredRowCount = -1;
+
   buildQuery();
 }
 
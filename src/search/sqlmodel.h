@@ -68,6 +68,12 @@ public:
   /* clear all filters */
   void resetSearch();
 
+  /* Suspends query execution while the saved search widget state is restored at startup.
+   * Every restored filter widget triggers a full query rebuild and run otherwise.
+   * endRestore() builds and runs the query once for the accumulated filters. */
+  void beginRestore();
+  void endRestore();
+
   /* Set header captions based on current query and the descriptions in
    * ColumnList*/
   void fillHeaderData();
@@ -170,6 +176,9 @@ signals:
   /* Emitted when more data was fetched */
   void fetchedMore();
 
+  /* Emitted when a deferred total row count query has finished */
+  void totalRowCountUpdated();
+
   /* One or more columns overrides all other search options */
   void overrideMode(const QStringList& overrideColumnTitles);
 
@@ -198,6 +207,7 @@ private:
   QVariant defaultDataHandler(int colIndex, int rowIndex, const Column *col, const QVariant& roleValue,
                               const QVariant& displayRoleValue, Qt::ItemDataRole role) const;
   void updateTotalCount();
+  void scheduleTotalCount();
   void buildSqlWhereValue(QVariant& whereValue) const;
   void buildSqlWhereValue(QString& whereValue) const;
 
@@ -227,12 +237,25 @@ private:
   /* List of column descriptors */
   const ColumnList *columns;
 
+  /* Column descriptors by query column index. Filled lazily in getColumnModel() and
+   * cleared whenever the query is set since the column layout might change. */
+  mutable QVector<const Column *> columnIndexCache;
+
   QWidget *parentWidget;
   int totalRowCount = 0;
 
+  /* Cached row count of the unfiltered table. Only changes when the table content changes. */
+  int unfilteredRowCount = -1;
+
+  /* Sequence number to drop deferred count queries that were superseded by a newer filter */
+  int totalCountSeq = 0;
+
   /* Set by buildWhere. Will ignore all other filter options */
   bool overrideModeActive = false;
 
+  /* Set between beginRestore() and endRestore(). Query rebuilds are collected and run once. */
+  bool restoreActive = false, restoreQueryPending = false;
+
 };
 
 #endif // LITTLENAVMAP_SQLMODEL_H
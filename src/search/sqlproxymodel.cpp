@@ -29,6 +29,8 @@ using namespace atools::geo;
 SqlProxyModel::SqlProxyModel(QObject *parent, SqlModel *sqlModel)
   : QSortFilterProxyModel(parent), sourceSqlModel(sqlModel)
 {
+  // Column positions can change when the query is rebuilt
+  connect(sqlModel, &SqlModel::modelReset, this, &SqlProxyModel::sourceModelReset);
 }
 
 SqlProxyModel::~SqlProxyModel()
@@ -59,37 +61,34 @@ bool SqlProxyModel::filterAcceptsRow(int sourceRow, const QModelIndex& sourcePar
     return true;
 
   Pos pos = buildPos(sourceRow);
+
+  // Check the radius first and calculate the more expensive great circle course
+  // only for the rows within and only if a direction is selected
+  if(!matchDistance(pos))
+    return false;
+
+  if(direction == sqlproxymodel::ALL)
+    // All directions
+    return true;
+
   float heading = normalizeCourse(centerPos.angleDegTo(pos));
 
   switch(direction)
   {
     case sqlproxymodel::ALL:
-      // All directions
-      return matchDistance(pos);
+      return true;
 
     case sqlproxymodel::NORTH:
-      if(MIN_NORTH_DEG <= heading || heading <= MAX_NORTH_DEG)
-        return matchDistance(pos);
-      else
-        return false;
+      return MIN_NORTH_DEG <= heading || heading <= MAX_NORTH_DEG;
 
     case sqlproxymodel::EAST:
-      if(MIN_EAST_DEG <= heading && heading <= MAX_EAST_DEG)
-        return matchDistance(pos);
-      else
-        return false;
+      return MIN_EAST_DEG <= heading && heading <= MAX_EAST_DEG;
 
     case sqlproxymodel::SOUTH:
-      if(MIN_SOUTH_DEG <= heading && heading <= MAX_SOUTH_DEG)
-        return matchDistance(pos);
-      else
-        return false;
+      return MIN_SOUTH_DEG <= heading && heading <= MAX_SOUTH_DEG;
 
     case sqlproxymodel::WEST:
-      if(MIN_WEST_DEG <= heading && heading <= MAX_WEST_DEG)
-        return matchDistance(pos);
-      else
-        return false;
+      return MIN_WEST_DEG <= heading && heading <= MAX_WEST_DEG;
   }
   return true;
 }
@@ -176,5 +175,20 @@ QVariant SqlProxyModel::data(const QModelIndex& index, int role) const
 
 Pos SqlProxyModel::buildPos(int row) const
 {
-  return Pos(sourceSqlModel->getRawData(row, "lonx").toFloat(), sourceSqlModel->getRawData(row, "laty").toFloat());
+  if(lonXColIndex == -1 || latYColIndex == -1)
+  {
+    // Resolve the coordinate columns once - fetching raw data by name builds a new
+    // record and searches it for every call
+    atools::sql::SqlRecord rec = sourceSqlModel->getSqlRecord();
+    lonXColIndex = rec.indexOf("lonx");
+    latYColIndex = rec.indexOf("laty");
+  }
+
+  return Pos(sourceSqlModel->getRawData(row, lonXColIndex).toFloat(),
+             sourceSqlModel->getRawData(row, latYColIndex).toFloat());
+}
+
+void SqlProxyModel::sourceModelReset()
+{
+  lonXColIndex = latYColIndex = -1;
 }
@@ -81,6 +81,9 @@ private:
   bool matchDistance(const atools::geo::Pos& pos) const;
   atools::geo::Pos buildPos(int row) const;
 
+  /* Forget the cached coordinate column indexes after the source query changed */
+  void sourceModelReset();
+
   /* Direction filter ranges are decreased by this value on each side */
   static float Q_DECL_CONSTEXPR DIR_RANGE_DEG = 22.5f;
 
@@ -95,6 +98,10 @@ private:
   sqlproxymodel::SearchDirection direction;
   float minDistMeter = 0.f, maxDistMeter = 0.f;
 
+  /* Coordinate column indexes resolved once per query - looking them up by name builds
+   * a new record for every filtered row. -1 if not resolved yet. */
+  mutable int lonXColIndex = -1, latYColIndex = -1;
+
 };
 
 #endif // LITTLENAVMAP_SQLPROXYMODEL_H
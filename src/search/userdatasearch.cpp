@@ -177,7 +177,10 @@ void UserdataSearch::restoreState()
   atools::gui::WidgetState widgetState(lnm::SEARCHTAB_USERDATA_VIEW_WIDGET);
   if(OptionData::instance().getFlags() & opts::STARTUP_LOAD_SEARCH)
   {
+    // Run the query only once after all filter widgets are restored instead of once per widget
+    controller->beginRestore();
     widgetState.restore(userdataSearchWidgets);
+    controller->endRestore();
 
     restoreViewState(false);
 
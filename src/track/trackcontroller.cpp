@@ -34,10 +34,14 @@
 #include "settings/settings.h"
 
 #include <QDebug>
+#include <QTimer>
 
 using atools::track::TrackDownloader;
 using atools::settings::Settings;
 
+/* Number of tracks to load into the database per event loop pass */
+const static int TRACKS_PER_STEP = 10;
+
 TrackController::TrackController(TrackManager *trackManagerParam, MainWindow *mainWindowParam) :
   QObject(mainWindowParam), mainWindow(mainWindowParam), trackManager(trackManagerParam)
 {
@@ -121,6 +125,7 @@ void TrackController::optionsChanged()
 void TrackController::preDatabaseLoad()
 {
   downloader->cancelAllDownloads();
+  cancelTrackLoad();
   airwayTrackQuery->deInitQueries();
   waypointTrackQuery->deInitQueries();
 }
@@ -172,6 +177,7 @@ void TrackController::cancelDownload()
 {
   qDebug() << Q_FUNC_INFO;
   downloader->cancelAllDownloads();
+  cancelTrackLoad();
   downloadQueue.clear();
   trackVector.clear();
 }
@@ -197,13 +203,40 @@ void TrackController::trackDownloadFinished(const atools::track::TrackVectorType
     // notify before changing database
     emit preTrackLoad();
 
-    // Load tracks but keep raw data in vector
-    trackManager->loadTracks(trackVector, downloadOnlyValid);
+    // Load tracks chunk by chunk over several event loop passes but keep raw data in vector
+    trackManager->loadTracksStart(trackVector, downloadOnlyValid);
+    QTimer::singleShot(0, this, &TrackController::loadTracksStep);
+  }
+}
+
+void TrackController::loadTracksStep()
+{
+  if(!trackManager->isLoadingTracks())
+    // Canceled in the meantime
+    return;
+
+  if(trackManager->loadTracksNext(TRACKS_PER_STEP))
+    // More tracks left - continue with the next event loop pass
+    QTimer::singleShot(0, this, &TrackController::loadTracksStep);
+  else
+  {
+    trackManager->loadTracksFinish();
     tracksLoaded();
     emit postTrackLoad();
   }
 }
 
+void TrackController::cancelTrackLoad()
+{
+  if(trackManager->isLoadingTracks())
+  {
+    trackManager->loadTracksCancel();
+
+    // Notify listeners to leave the pre track load state
+    emit postTrackLoad();
+  }
+}
+
 void TrackController::trackDownloadSslErrors(const QStringList& errors, const QString& downloadUrl)
 {
   int result = atools::gui::Dialog(mainWindow).
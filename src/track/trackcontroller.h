@@ -84,6 +84,13 @@ private:
   void trackDownloadSslErrors(const QStringList& errors, const QString& downloadUrl);
   void tracksLoaded();
 
+  /* Load the next chunk of tracks into the database and reschedule until done.
+   * Keeps the user interface responsive while loading. */
+  void loadTracksStep();
+
+  /* Stop a chunked load and notify listeners if one is running */
+  void cancelTrackLoad();
+
   /* Avoid multiple error reports. */
   bool errorReported = false;
   bool verbose = false;
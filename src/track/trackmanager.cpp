@@ -52,6 +52,7 @@ TrackManager::TrackManager(SqlDatabase *trackDatabase, SqlDatabase *navDatabase)
 
 TrackManager::~TrackManager()
 {
+  loadTracksCancel();
   deInitQueries();
 }
 
@@ -94,189 +95,258 @@ void TrackManager::deInitQueries()
   airwayQuery = nullptr;
 }
 
-void TrackManager::loadTracks(const TrackVectorType& tracks, bool onlyValid)
+/* All state of a chunked load which has to be kept between the event loop passes */
+struct TrackManager::LoadState
 {
-  errorMessages.clear();
-  SqlTransaction transaction(db);
-  clearTracks();
+  explicit LoadState(bool verboseParam)
+    : reader(&builder, verboseParam)
+  {
+    reader.setPlaintextMessages(true);
+  }
 
-  initQueries();
+  atools::sql::SqlTransaction *transaction = nullptr;
 
-  QElapsedTimer timer;
-  timer.start();
+  /* Copy of the downloaded raw data and position of the next track to load */
+  atools::track::TrackVectorType tracks;
+  bool onlyValid = false;
+  int index = 0;
 
   // Generated ids with offset to distinguis from read airways and waypoints
   int trackpointId = atools::track::TRACKPOINT_ID_OFFSET, trackId = atools::track::TRACK_ID_OFFSET, trackmetaId = 1;
 
   FlightplanEntryBuilder builder;
-  RouteStringReader reader(&builder, verbose);
-  reader.setPlaintextMessages(true);
+  RouteStringReader reader;
 
-  // Maps trackpoint/waypoint (real or generated with offset) ids to records to insert into table trackpoint
+  /* Maps trackpoint/waypoint (real or generated with offset) ids to records to insert into table trackpoint */
   QHash<int, SqlRecord> trackpoints;
 
-  // Maps type (NAT, PACOTS, etc.) and track name to metadata record
+  /* Maps type (NAT, PACOTS, etc.) and track name to metadata record */
   QHash<std::pair<TrackType, QString>, SqlRecord> trackmeta;
 
-  // Maps name to a fragment number for airway compatibility which needs name and fragment as a key
+  /* Maps name to a fragment number for airway compatibility which needs name and fragment as a key */
   QHash<QString, int> nameFragmentHash;
 
-  QDateTime now = QDateTime::currentDateTimeUtc();
-  // Read each track into the database ==================================================
-  for(const Track& track : tracks)
-  {
-    if(verbose)
-      qDebug() << Q_FUNC_INFO << track;
+  QDateTime now;
+};
 
-    if(onlyValid && (now < track.validFrom || now > track.validTo))
-      continue;
+void TrackManager::loadTracks(const TrackVectorType& tracks, bool onlyValid)
+{
+  QElapsedTimer timer;
+  timer.start();
 
-    // Add or increment fragment number for a new name
-    if(nameFragmentHash.contains(track.name))
-      nameFragmentHash[track.name]++;
-    else
-      nameFragmentHash.insert(track.name, 1);
+  loadTracksStart(tracks, onlyValid);
+  while(loadTracksNext(50))
+    ;
 
-    // Read string into a list of references ====================================
-    map::MapObjectRefExtVector refs;
-    QString routeStr = track.route.join(" ");
-    if(reader.createRouteFromString(routeStr, rs::TRACK_DEFAULTS, nullptr, &refs))
-    {
-      if(verbose)
-        qDebug() << Q_FUNC_INFO << refs;
+  if(verbose)
+    qDebug() << Q_FUNC_INFO << "after loading tracks" << timer.restart();
 
-      if(reader.hasWarningMessages() || reader.hasErrorMessages())
-      {
-        qWarning() << Q_FUNC_INFO << routeStr;
-        qWarning() << Q_FUNC_INFO << reader.getMessages();
-      }
+  loadTracksFinish();
 
-      // Empty records
-      SqlRecord rec = getEmptyRecord(); // track table
-      SqlRecord trackpointRec = db->record("trackpoint");
+  if(verbose)
+    qDebug() << Q_FUNC_INFO << "after loading trackpoints" << timer.restart();
+}
 
-      int startPointId = -1, endPointId = -1;
-      // Write all waypoints to the database ===========================================
-      for(int i = 1; i < refs.size(); i++)
-      {
-        const map::MapObjectRefExt& ref = refs.at(i);
-
-        // Read airways later
-        if(ref.objType & map::AIRWAY)
-          continue;
-
-        const map::MapObjectRefExt *refLast2 = i > 1 ? &refs.at(i - 2) : nullptr;
-        const map::MapObjectRefExt& refLast1 = refs.at(i - 1);
-
-        rec.setValue("track_id", trackId++);
-        rec.setValue("trackmeta_id", trackmetaId);
-        rec.setValue("track_name", track.name);
-        rec.setValue("track_type", atools::charToStr(track.type));
-        rec.setValue("sequence_no", i);
-        rec.setValue("track_fragment_no", nameFragmentHash.value(track.name));
-
-        if(!track.eastLevels.isEmpty())
-          rec.setValue("altitude_levels_east", atools::io::writeVector<quint16, quint16>(track.eastLevels));
-        if(!track.westLevels.isEmpty())
-          rec.setValue("altitude_levels_west", atools::io::writeVector<quint16, quint16>(track.westLevels));
-
-        int airwayId = -1;
-        map::MapObjectRefExt fromRef, toRef;
-        if(refLast2 != nullptr && refLast1.objType & map::AIRWAY)
-        {
-          // Previous entry is an airway - second previous is from waypoint
-          fromRef = *refLast2;
-          airwayId = refLast1.id;
-        }
-        else
-          // No airway - previous is from waypoint
-          fromRef = refLast1;
+void TrackManager::loadTracksStart(const TrackVectorType& tracks, bool onlyValid)
+{
+  // Drop any leftover state from an interrupted load
+  loadTracksCancel();
 
-        // to waypoint
-        toRef = ref;
+  errorMessages.clear();
 
-        if(airwayId != -1)
-        {
-          // Save copy of certain airway fields ============
-          rec.setValue("airway_id", airwayId);
-
-          airwayQuery->bindValue(0, airwayId);
-          airwayQuery->exec();
-          if(airwayQuery->next())
-          {
-            rec.setValue("airway_minimum_altitude", airwayQuery->value("minimum_altitude"));
-            rec.setValue("airway_maximum_altitude", airwayQuery->value("maximum_altitude"));
-            rec.setValue("airway_direction", airwayQuery->value("direction"));
-          }
-        }
+  loadState = new LoadState(verbose);
+  loadState->transaction = new SqlTransaction(db);
+  loadState->tracks = tracks;
+  loadState->onlyValid = onlyValid;
+  loadState->now = QDateTime::currentDateTimeUtc();
 
-        // Add trackpoint/waypoint to hash and return id which can be generated or original waypoint id
-        int fromId = addTrackpoint(trackpoints, trackpointRec, fromRef, trackpointId);
-
-        // New generated id for waypoint in case it is needed
-        trackpointId++;
-        int toId = addTrackpoint(trackpoints, trackpointRec, toRef, trackpointId);
-
-        // Remember start and end id (real or generated) for metadata
-        if(i == 1)
-          startPointId = fromId;
-        if(i == refs.size() - 1)
-          endPointId = toId;
-
-        rec.setValue("from_waypoint_id", fromId);
-        rec.setValue("from_waypoint_name", fromRef.name);
-        rec.setValue("to_waypoint_id", toId);
-        rec.setValue("to_waypoint_name", toRef.name);
-
-        // Coordinates and bounding rectangle
-        atools::geo::Rect rect(atools::geo::LineString({fromRef.position, toRef.position}));
-        rec.setValue("left_lonx", rect.getWest());
-        rec.setValue("top_laty", rect.getNorth());
-        rec.setValue("right_lonx", rect.getEast());
-        rec.setValue("bottom_laty", rect.getSouth());
-        rec.setValue("from_lonx", fromRef.position.getLonX());
-        rec.setValue("from_laty", fromRef.position.getLatY());
-        rec.setValue("to_lonx", ref.position.getLonX());
-        rec.setValue("to_laty", ref.position.getLatY());
-
-        // Insert into database
-        insertByRecordId(rec);
-
-        // Set all to null
-        rec.clearValues();
-      }
+  clearTracks();
+  initQueries();
+}
 
-      // Add to trackmeta table if a new track was found
-      if(addTrackmeta(trackmeta, track, trackmetaId, startPointId, endPointId))
-        trackmetaId++;
+bool TrackManager::loadTracksNext(int numTracks)
+{
+  if(loadState == nullptr)
+    return false;
 
-    }
-    else
-    {
-      QString err = tr("Error when parsing track %1 (%2) with route %3.").
-                    arg(track.name).
-                    arg(track.typeString()).arg(atools::elideTextShortMiddle(track.route.join(" "), 40));
-      errorMessages.append(err);
-      errorMessages.append(reader.getMessages());
-    }
-  }
+  // Read tracks into the database ==================================================
+  for(int i = 0; i < numTracks && loadState->index < loadState->tracks.size(); i++)
+    loadTrack(loadState->tracks.at(loadState->index++));
 
-  qWarning() << errorMessages;
+  return loadState->index < loadState->tracks.size();
+}
 
-  if(verbose)
-    qDebug() << Q_FUNC_INFO << "after loading tracks" << timer.restart();
+void TrackManager::loadTracksFinish()
+{
+  if(loadState == nullptr)
+    return;
+
+  qWarning() << errorMessages;
 
   // Write collected trackpoints into database
-  insertRecords(trackpoints.values().toVector(), "trackpoint");
+  insertRecords(loadState->trackpoints.values().toVector(), "trackpoint");
 
   // Write collected metadata into database
-  insertRecords(trackmeta.values().toVector(), "trackmeta");
+  insertRecords(loadState->trackmeta.values().toVector(), "trackmeta");
+
+  loadState->transaction->commit();
+  delete loadState->transaction;
+
+  delete loadState;
+  loadState = nullptr;
+
+  deInitQueries();
+}
+
+void TrackManager::loadTracksCancel()
+{
+  if(loadState == nullptr)
+    return;
+
+  loadState->transaction->rollback();
+  delete loadState->transaction;
+
+  delete loadState;
+  loadState = nullptr;
 
-  transaction.commit();
   deInitQueries();
+}
 
+void TrackManager::loadTrack(const Track& track)
+{
   if(verbose)
-    qDebug() << Q_FUNC_INFO << "after loading trackpoints" << timer.restart();
+    qDebug() << Q_FUNC_INFO << track;
+
+  if(loadState->onlyValid && (loadState->now < track.validFrom || loadState->now > track.validTo))
+    return;
+
+  // Add or increment fragment number for a new name
+  if(loadState->nameFragmentHash.contains(track.name))
+    loadState->nameFragmentHash[track.name]++;
+  else
+    loadState->nameFragmentHash.insert(track.name, 1);
+
+  // Read string into a list of references ====================================
+  map::MapObjectRefExtVector refs;
+  QString routeStr = track.route.join(" ");
+  if(loadState->reader.createRouteFromString(routeStr, rs::TRACK_DEFAULTS, nullptr, &refs))
+  {
+    if(verbose)
+      qDebug() << Q_FUNC_INFO << refs;
+
+    if(loadState->reader.hasWarningMessages() || loadState->reader.hasErrorMessages())
+    {
+      qWarning() << Q_FUNC_INFO << routeStr;
+      qWarning() << Q_FUNC_INFO << loadState->reader.getMessages();
+    }
+
+    // Empty records
+    SqlRecord rec = getEmptyRecord(); // track table
+    SqlRecord trackpointRec = db->record("trackpoint");
+
+    int startPointId = -1, endPointId = -1;
+    // Write all waypoints to the database ===========================================
+    for(int i = 1; i < refs.size(); i++)
+    {
+      const map::MapObjectRefExt& ref = refs.at(i);
+
+      // Read airways later
+      if(ref.objType & map::AIRWAY)
+        continue;
+
+      const map::MapObjectRefExt *refLast2 = i > 1 ? &refs.at(i - 2) : nullptr;
+      const map::MapObjectRefExt& refLast1 = refs.at(i - 1);
+
+      rec.setValue("track_id", loadState->trackId++);
+      rec.setValue("trackmeta_id", loadState->trackmetaId);
+      rec.setValue("track_name", track.name);
+      rec.setValue("track_type", atools::charToStr(track.type));
+      rec.setValue("sequence_no", i);
+      rec.setValue("track_fragment_no", loadState->nameFragmentHash.value(track.name));
+
+      if(!track.eastLevels.isEmpty())
+        rec.setValue("altitude_levels_east", atools::io::writeVector<quint16, quint16>(track.eastLevels));
+      if(!track.westLevels.isEmpty())
+        rec.setValue("altitude_levels_west", atools::io::writeVector<quint16, quint16>(track.westLevels));
+
+      int airwayId = -1;
+      map::MapObjectRefExt fromRef, toRef;
+      if(refLast2 != nullptr && refLast1.objType & map::AIRWAY)
+      {
+        // Previous entry is an airway - second previous is from waypoint
+        fromRef = *refLast2;
+        airwayId = refLast1.id;
+      }
+      else
+        // No airway - previous is from waypoint
+        fromRef = refLast1;
+
+      // to waypoint
+      toRef = ref;
+
+      if(airwayId != -1)
+      {
+        // Save copy of certain airway fields ============
+        rec.setValue("airway_id", airwayId);
+
+        airwayQuery->bindValue(0, airwayId);
+        airwayQuery->exec();
+        if(airwayQuery->next())
+        {
+          rec.setValue("airway_minimum_altitude", airwayQuery->value("minimum_altitude"));
+          rec.setValue("airway_maximum_altitude", airwayQuery->value("maximum_altitude"));
+          rec.setValue("airway_direction", airwayQuery->value("direction"));
+        }
+      }
+
+      // Add trackpoint/waypoint to hash and return id which can be generated or original waypoint id
+      int fromId = addTrackpoint(loadState->trackpoints, trackpointRec, fromRef, loadState->trackpointId);
+
+      // New generated id for waypoint in case it is needed
+      loadState->trackpointId++;
+      int toId = addTrackpoint(loadState->trackpoints, trackpointRec, toRef, loadState->trackpointId);
+
+      // Remember start and end id (real or generated) for metadata
+      if(i == 1)
+        startPointId = fromId;
+      if(i == refs.size() - 1)
+        endPointId = toId;
+
+      rec.setValue("from_waypoint_id", fromId);
+      rec.setValue("from_waypoint_name", fromRef.name);
+      rec.setValue("to_waypoint_id", toId);
+      rec.setValue("to_waypoint_name", toRef.name);
+
+      // Coordinates and bounding rectangle
+      atools::geo::Rect rect(atools::geo::LineString({fromRef.position, toRef.position}));
+      rec.setValue("left_lonx", rect.getWest());
+      rec.setValue("top_laty", rect.getNorth());
+      rec.setValue("right_lonx", rect.getEast());
+      rec.setValue("bottom_laty", rect.getSouth());
+      rec.setValue("from_lonx", fromRef.position.getLonX());
+      rec.setValue("from_laty", fromRef.position.getLatY());
+      rec.setValue("to_lonx", ref.position.getLonX());
+      rec.setValue("to_laty", ref.position.getLatY());
+
+      // Insert into database
+      insertByRecordId(rec);
+
+      // Set all to null
+      rec.clearValues();
+    }
+
+    // Add to trackmeta table if a new track was found
+    if(addTrackmeta(loadState->trackmeta, track, loadState->trackmetaId, startPointId, endPointId))
+      loadState->trackmetaId++;
+  }
+  else
+  {
+    QString err = tr("Error when parsing track %1 (%2) with route %3.").
+                  arg(track.name).
+                  arg(track.typeString()).arg(atools::elideTextShortMiddle(track.route.join(" "), 40));
+    errorMessages.append(err);
+    errorMessages.append(loadState->reader.getMessages());
+  }
 }
 
 int TrackManager::addTrackpoint(QHash<int, SqlRecord>& trackpoints, atools::sql::SqlRecord rec,
@@ -48,6 +48,25 @@ public:
    * onlyValid: Do not load tracks that are currently not valid. */
   void loadTracks(const atools::track::TrackVectorType& tracks, bool onlyValid);
 
+  /* Chunked loading which allows to spread the work over several event loop passes so the user
+   * interface does not freeze. Start copies the tracks, clears the database and opens a transaction. */
+  void loadTracksStart(const atools::track::TrackVectorType& tracks, bool onlyValid);
+
+  /* Parse and insert the given number of tracks. Returns true while more tracks are left. */
+  bool loadTracksNext(int numTracks);
+
+  /* Write collected trackpoints and metadata and commit the transaction. */
+  void loadTracksFinish();
+
+  /* Roll back the transaction and drop the loading state. */
+  void loadTracksCancel();
+
+  /* True between loadTracksStart() and loadTracksFinish() or loadTracksCancel() */
+  bool isLoadingTracks() const
+  {
+    return loadState != nullptr;
+  }
+
   /* More log messages if true */
   void setVerbose(bool value)
   {
@@ -66,10 +85,16 @@ public:
   }
 
 private:
+  /* All state of a chunked load between loadTracksStart() and loadTracksFinish() */
+  struct LoadState;
+
   /* Queries are initialized and closed when entering and leaving loadTracks(). */
   void initQueries();
   void deInitQueries();
 
+  /* Parse one track and insert its segments into the database */
+  void loadTrack(const atools::track::Track& track);
+
   /* Add waypoint/trackpoint to hash returning waypoint id or new generated trackpoint id.
    * rec is an empty record for trackpoint table. */
   int addTrackpoint(QHash<int, atools::sql::SqlRecord>& trackpoints, atools::sql::SqlRecord rec,
@@ -84,6 +109,8 @@ private:
 
   bool verbose = false;
 
+  LoadState *loadState = nullptr;
+
   /* Database for querying navaids. */
   atools::sql::SqlDatabase *dbNav = nullptr;
   QStringList errorMessages;
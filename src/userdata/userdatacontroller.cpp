@@ -35,6 +35,7 @@
 #include "exception.h"
 #include "common/unit.h"
 #include "common/maptypesfactory.h"
+#include "query/mapquery.h"
 #include "gui/choicedialog.h"
 
 #include <QDebug>
@@ -335,11 +336,18 @@ void UserdataController::moveUserpointFromMap(const map::MapUserpoint& userpoint
   manager->updateByRecord(rec, {userpoint.id});
   transaction.commit();
 
+  invalidateMapIndex();
+
   // No need to update search
   emit userdataChanged();
   mainWindow->setStatusMessage(tr("Userpoint moved."));
 }
 
+void UserdataController::invalidateMapIndex()
+{
+  NavApp::getMapQuery()->invalidateUserpointIndex();
+}
+
 void UserdataController::backup()
 {
   manager->backup();
@@ -348,6 +356,7 @@ void UserdataController::backup()
 void UserdataController::clearTemporary()
 {
   manager->clearTemporary();
+  invalidateMapIndex();
 }
 
 map::MapUserpoint UserdataController::getUserpointById(int id)
@@ -425,6 +434,7 @@ void UserdataController::addUserpointInternal(int id, const atools::geo::Pos& po
     SqlTransaction transaction(manager->getDatabase());
     manager->insertByRecord(*lastAddedRecord);
     transaction.commit();
+    invalidateMapIndex();
     emit refreshUserdataSearch(false /* load all */, false /* keep selection */);
     emit userdataChanged();
     mainWindow->setStatusMessage(tr("Userpoint added."));
@@ -451,7 +461,8 @@ void UserdataController::editUserpoints(const QVector<int>& ids)
       manager->updateByRecord(dlg.getRecord(), ids);
       transaction.commit();
 
-      emit refreshUserdataSearch(false /* load all */, false /* keep selection */);
+      invalidateMapIndex();
+    emit refreshUserdataSearch(false /* load all */, false /* keep selection */);
       emit userdataChanged();
       mainWindow->setStatusMessage(tr("%n userpoint(s) updated.", "", ids.size()));
     }
@@ -476,6 +487,7 @@ void UserdataController::deleteUserpoints(const QVector<int>& ids)
     manager->removeRows(ids);
     transaction.commit();
 
+    invalidateMapIndex();
     emit refreshUserdataSearch(false /* load all */, false /* keep selection */);
     emit userdataChanged();
     mainWindow->setStatusMessage(tr("%n userpoint(s) deleted.", "", ids.size()));
@@ -496,14 +508,22 @@ void UserdataController::importCsv()
     for(const QString& file:files)
     {
       if(!file.isEmpty())
+      {
+        // One transaction per file batches all inserts - otherwise SQLite wraps each insert
+        // into an implicitly committed transaction which dominates large imports.
+        // Rolled back on import exceptions by the destructor.
+        SqlTransaction transaction(manager->getDatabase());
         numImported += manager->importCsv(file, atools::fs::userdata::NONE, ',', '"');
+        transaction.commit();
+      }
     }
 
     if(!files.isEmpty())
     {
       mainWindow->showUserpointSearch();
       mainWindow->setStatusMessage(tr("%n userpoint(s) imported.", "", numImported));
-      emit refreshUserdataSearch(false /* load all */, false /* keep selection */);
+      invalidateMapIndex();
+    emit refreshUserdataSearch(false /* load all */, false /* keep selection */);
     }
   }
   catch(atools::Exception& e)
@@ -529,10 +549,15 @@ void UserdataController::importXplaneUserFixDat()
 
     if(!file.isEmpty())
     {
+      // Batch all inserts into one transaction
+      SqlTransaction transaction(manager->getDatabase());
       int numImported = manager->importXplane(file);
+      transaction.commit();
+
       mainWindow->showUserpointSearch();
       mainWindow->setStatusMessage(tr("%n userpoint(s) imported.", "", numImported));
-      emit refreshUserdataSearch(false /* load all */, false /* keep selection */);
+      invalidateMapIndex();
+    emit refreshUserdataSearch(false /* load all */, false /* keep selection */);
     }
   }
   catch(atools::Exception& e)
@@ -557,10 +582,15 @@ void UserdataController::importGarmin()
 
     if(!file.isEmpty())
     {
+      // Batch all inserts into one transaction
+      SqlTransaction transaction(manager->getDatabase());
       int numImported = manager->importGarmin(file);
+      transaction.commit();
+
       mainWindow->showUserpointSearch();
       mainWindow->setStatusMessage(tr("%n userpoint(s) imported.", "", numImported));
-      emit refreshUserdataSearch(false /* load all */, false /* keep selection */);
+      invalidateMapIndex();
+    emit refreshUserdataSearch(false /* load all */, false /* keep selection */);
     }
   }
   catch(atools::Exception& e)
@@ -734,6 +764,7 @@ void UserdataController::clearDatabase()
   if(retval == QMessageBox::Yes)
   {
     manager->clearData();
+    invalidateMapIndex();
     emit refreshUserdataSearch(false /* load all */, false /* keep selection */);
   }
 }
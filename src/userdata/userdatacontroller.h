@@ -168,6 +168,10 @@ private:
   void typesToActions();
   void actionsToTypes();
   void addUserpointInternal(int id, const atools::geo::Pos& pos, const atools::sql::SqlRecord& prefill);
+
+  /* Drop the in-memory map index after modifying the database so the next draw reloads it.
+   * Not needed for pure display filter changes. */
+  void invalidateMapIndex();
   bool exportSelectedQuestion(bool& selected, bool& append, bool& header, bool appendAllowed, bool headerAllowed);
 
   /* Get default X-Plane path to user_fix.dat file */
@@ -29,6 +29,7 @@
 #include "fs/util/fsutil.h"
 #include "query/mapquery.h"
 #include "query/airportquery.h"
+#include "route/route.h"
 #include "fs/weather/metar.h"
 #include "util/filesystemwatcher.h"
 #include "connect/connectclient.h"
@@ -70,6 +71,9 @@ WeatherReporter::WeatherReporter(MainWindow *parentWindow, atools::fs::FsPaths::
 
   verbose = Settings::instance().getAndStoreValue(lnm::OPTIONS_WEATHER_DEBUG, false).toBool();
 
+  // Load the pressure and wind history of the last sessions for the trend display
+  weatherTrend.restoreState();
+
   auto coordFunc = std::bind(&WeatherReporter::fetchAirportCoordinates, this, _1);
 
   xpWeatherReader = new atools::fs::weather::XpWeatherReader(this, verbose);
@@ -90,11 +94,17 @@ WeatherReporter::WeatherReporter(MainWindow *parentWindow, atools::fs::FsPaths::
   // Update IVAO and NOAA timeout periods - timeout is disable if weather services are not used
   updateTimeouts();
 
-  initActiveSkyNext();
-
   // Set callback so the reader can build an index for nearest airports
   xpWeatherReader->setFetchAirportCoords(coordFunc);
-  initXplane();
+
+  // Scan for the Active Sky and X-Plane weather files once the event loop is running.
+  // The scans can block for a while on slow or network drives and are not needed before
+  // the main window is shown.
+  QTimer::singleShot(0, this, [this]()
+  {
+    initActiveSkyNext();
+    initXplane();
+  });
 
   connect(xpWeatherReader, &atools::fs::weather::XpWeatherReader::weatherUpdated,
           this, &WeatherReporter::xplaneWeatherFileChanged);
@@ -120,6 +130,8 @@ WeatherReporter::WeatherReporter(MainWindow *parentWindow, atools::fs::FsPaths::
 
 WeatherReporter::~WeatherReporter()
 {
+  weatherTrend.saveState();
+
   deleteFsWatcher();
   delete noaaWeather;
   delete vatsimWeather;
@@ -130,18 +142,21 @@ WeatherReporter::~WeatherReporter()
 
 void WeatherReporter::noaaWeatherUpdated()
 {
+  clearAirportWeatherCache();
   mainWindow->setStatusMessage(tr("NOAA weather downloaded."), true /* addToLog */);
   emit weatherUpdated();
 }
 
 void WeatherReporter::ivaoWeatherUpdated()
 {
+  clearAirportWeatherCache();
   mainWindow->setStatusMessage(tr("IVAO weather downloaded."), true /* addToLog */);
   emit weatherUpdated();
 }
 
 void WeatherReporter::vatsimWeatherUpdated()
 {
+  clearAirportWeatherCache();
   mainWindow->setStatusMessage(tr("VATSIM weather downloaded."), true /* addToLog */);
   emit weatherUpdated();
 }
@@ -231,6 +246,10 @@ void WeatherReporter::initActiveSkyNext()
 
   activeSkyType = NONE;
   activeSkyMetars.clear();
+  activeSkySnapshotTimestamp = QDateTime();
+  activeSkySnapshotSize = 0;
+  activeSkyFlightplanSnapshotTimestamp = QDateTime();
+  activeSkyFlightplanSnapshotSize = 0;
   activeSkyDepartureMetar.clear();
   activeSkyDestinationMetar.clear();
   activeSkyDepartureIdent.clear();
@@ -319,7 +338,7 @@ void WeatherReporter::initActiveSkyNext()
 }
 
 /* Loads complete ASN file into a hash map */
-void WeatherReporter::loadActiveSkySnapshot(const QString& path)
+bool WeatherReporter::loadActiveSkySnapshot(const QString& path)
 {
   // ASN
   // C:\Users\USER\AppData\Roaming\HiFi\ASNFSX\Weather\current_wx_snapshot.txt or wx_station_list.txt
@@ -332,7 +351,17 @@ void WeatherReporter::loadActiveSkySnapshot(const QString& path)
 
   // TODO overrride with settings
   if(path.isEmpty())
-    return;
+    return false;
+
+  // Skip the parse if the file did not change since the last load - the watcher
+  // reports several events per update on some systems
+  QFileInfo fileinfo(path);
+  if(!activeSkyMetars.isEmpty() && fileinfo.lastModified() == activeSkySnapshotTimestamp &&
+     fileinfo.size() == activeSkySnapshotSize)
+  {
+    qDebug() << Q_FUNC_INFO << "Snapshot" << path << "unchanged";
+    return false;
+  }
 
   QFile file(path);
   if(file.open(QIODevice::ReadOnly | QIODevice::Text))
@@ -361,14 +390,21 @@ void WeatherReporter::loadActiveSkySnapshot(const QString& path)
     }
     file.close();
 
+    activeSkySnapshotTimestamp = fileinfo.lastModified();
+    activeSkySnapshotSize = fileinfo.size();
+
     qDebug() << Q_FUNC_INFO << "Loaded" << num << "METARs";
+    return true;
   }
   else
+  {
     qWarning() << "cannot open" << file.fileName() << "reason" << file.errorString();
+    return false;
+  }
 }
 
 /* Loads flight plan weather for start and destination */
-void WeatherReporter::loadActiveSkyFlightplanSnapshot(const QString& path)
+bool WeatherReporter::loadActiveSkyFlightplanSnapshot(const QString& path)
 {
   using atools::fs::weather::MetarParser;
   // DepartureMETAR=NZTU 282151Z 33112KT 9999 FEW030 FEW168 11/05 Q0998 RMK ADVANCED INTERPOLATION
@@ -381,7 +417,18 @@ void WeatherReporter::loadActiveSkyFlightplanSnapshot(const QString& path)
   // CruiseSpeed=300
 
   if(path.isEmpty())
-    return;
+    return false;
+
+  // Skip the parse if the file did not change since the last load - the watcher
+  // reports several events per update on some systems
+  QFileInfo fileinfo(path);
+  if(!activeSkyDepartureMetar.isEmpty() &&
+     fileinfo.lastModified() == activeSkyFlightplanSnapshotTimestamp &&
+     fileinfo.size() == activeSkyFlightplanSnapshotSize)
+  {
+    qDebug() << Q_FUNC_INFO << "Snapshot" << path << "unchanged";
+    return false;
+  }
 
   QFile file(path);
   if(file.open(QIODevice::ReadOnly | QIODevice::Text))
@@ -431,11 +478,18 @@ void WeatherReporter::loadActiveSkyFlightplanSnapshot(const QString& path)
     }
     file.close();
 
+    activeSkyFlightplanSnapshotTimestamp = fileinfo.lastModified();
+    activeSkyFlightplanSnapshotSize = fileinfo.size();
+
     qDebug() << Q_FUNC_INFO << "activeSkyDepartureMetar" << activeSkyDepartureMetar
              << "activeSkyDestinationMetar" << activeSkyDestinationMetar;
+    return true;
   }
   else
+  {
     qWarning() << "cannot open" << file.fileName() << "reason" << file.errorString();
+    return false;
+  }
 }
 
 bool WeatherReporter::validateActiveSkyFile(const QString& path)
@@ -565,9 +619,32 @@ QString WeatherReporter::getCurrentActiveSkyName() const
 
 void WeatherReporter::updateAirportWeather()
 {
+  clearAirportWeatherCache();
   updateTimeouts();
 }
 
+void WeatherReporter::preloadRouteWeather()
+{
+  // Only NOAA fetches reports per airport on demand. VATSIM and IVAO weather is downloaded
+  // as a whole file periodically and the simulator sources need no prefetch.
+  optsw::FlagsWeather flags = OptionData::instance().getFlagsWeather();
+  if(flags & optsw::WEATHER_INFO_NOAA || flags & optsw::WEATHER_TOOLTIP_NOAA ||
+     NavApp::getAirportWeatherSource() == map::WEATHER_SOURCE_NOAA)
+  {
+    const Route& route = NavApp::getRouteConst();
+
+    // Covers departure, destination and all alternates - en-route legs have no airport
+    for(const RouteLeg& leg : route)
+    {
+      const map::MapAirport& airport = leg.getAirport();
+      if(airport.isValid())
+        // Starts the background download if the report is not in the downloader cache.
+        // The result lands in the cache and is served instantly on the next call.
+        getNoaaMetar(airport.ident, airport.position);
+    }
+  }
+}
+
 void WeatherReporter::weatherDownloadSslErrors(const QStringList& errors, const QString& downloadUrl)
 {
   int result = atools::gui::Dialog(mainWindow).
@@ -645,12 +722,23 @@ atools::fs::weather::Metar WeatherReporter::getAirportWeather(const QString& air
                                                               const atools::geo::Pos& airportPos,
                                                               map::MapWeatherSource source)
 {
+  // Cache parsed METARs by source and ident to avoid parsing the same report on every map repaint
+  QString key = QString::number(source) + '_' + airportIcao;
+  auto cached = airportWeatherCache.constFind(key);
+  if(cached != airportWeatherCache.constEnd())
+    return cached.value();
+
   switch(source)
   {
     case map::WEATHER_SOURCE_SIMULATOR:
       if(NavApp::getCurrentSimulatorDb() == atools::fs::FsPaths::XPLANE11)
+      {
         // X-Plane weather file
-        return Metar(getXplaneMetar(airportIcao, atools::geo::EMPTY_POS).metarForStation);
+        Metar metar(getXplaneMetar(airportIcao, atools::geo::EMPTY_POS).metarForStation);
+        airportWeatherCache.insert(key, metar);
+        addTrendObservation(airportIcao, metar);
+        return metar;
+      }
       else if(NavApp::getConnectClient()->isConnected() /*&& !NavApp::getConnectClient()->isConnectedNetwork()*/)
       {
         atools::fs::weather::MetarResult res =
@@ -658,25 +746,111 @@ atools::fs::weather::Metar WeatherReporter::getAirportWeather(const QString& air
 
         if(res.isValid() && !res.metarForStation.isEmpty())
           // FSX/P3D - Flight simulator fetched weather or network connection
+          // Not cached since updates from the simulator are not observable
           return Metar(res.metarForStation, res.requestIdent, res.timestamp, true);
       }
       return Metar();
 
     case map::WEATHER_SOURCE_ACTIVE_SKY:
-      return Metar(getActiveSkyMetar(airportIcao));
+      {
+        Metar metar(getActiveSkyMetar(airportIcao));
+        airportWeatherCache.insert(key, metar);
+        addTrendObservation(airportIcao, metar);
+        return metar;
+      }
 
     case map::WEATHER_SOURCE_NOAA:
-      return Metar(getNoaaMetar(airportIcao, atools::geo::EMPTY_POS).metarForStation);
+      {
+        Metar metar(getNoaaMetar(airportIcao, atools::geo::EMPTY_POS).metarForStation);
+        airportWeatherCache.insert(key, metar);
+        addTrendObservation(airportIcao, metar);
+        return metar;
+      }
 
     case map::WEATHER_SOURCE_VATSIM:
-      return Metar(getVatsimMetar(airportIcao, atools::geo::EMPTY_POS).metarForStation);
+      {
+        Metar metar(getVatsimMetar(airportIcao, atools::geo::EMPTY_POS).metarForStation);
+        airportWeatherCache.insert(key, metar);
+        addTrendObservation(airportIcao, metar);
+        return metar;
+      }
 
     case map::WEATHER_SOURCE_IVAO:
-      return Metar(getIvaoMetar(airportIcao, atools::geo::EMPTY_POS).metarForStation);
+      {
+        Metar metar(getIvaoMetar(airportIcao, atools::geo::EMPTY_POS).metarForStation);
+        airportWeatherCache.insert(key, metar);
+        addTrendObservation(airportIcao, metar);
+        return metar;
+      }
   }
   return Metar();
 }
 
+const Metar *WeatherReporter::getAirportWeatherCached(const QString& airportIcao,
+                                                      const atools::geo::Pos& airportPos,
+                                                      map::MapWeatherSource source)
+{
+  QString key = QString::number(source) + '_' + airportIcao;
+  auto cached = airportWeatherCache.constFind(key);
+  if(cached == airportWeatherCache.constEnd())
+  {
+    if(source == map::WEATHER_SOURCE_SIMULATOR && NavApp::getCurrentSimulatorDb() != atools::fs::FsPaths::XPLANE11)
+      // Fetched live from the simulator connection and not cached since updates from the
+      // simulator are not observable
+      return nullptr;
+
+    // Fetch and parse which inserts the report into the cache
+    getAirportWeather(airportIcao, airportPos, source);
+
+    cached = airportWeatherCache.constFind(key);
+    if(cached == airportWeatherCache.constEnd())
+      return nullptr;
+  }
+  return &cached.value();
+}
+
+const Metar& WeatherReporter::getDecodedMetar(const QString& metarString, const QString& station,
+                                              const QDateTime& timestamp, bool simFormat)
+{
+  // Key by report text - the same text decodes to the same values until the next update cycle
+  QString key = metarString + '_' + station + '_' + QString::number(simFormat);
+  auto cached = decodedMetarCache.constFind(key);
+  if(cached != decodedMetarCache.constEnd())
+    return cached.value();
+
+  return decodedMetarCache.insert(key, Metar(metarString, station, timestamp, simFormat)).value();
+}
+
+const Metar& WeatherReporter::getDecodedMetar(const QString& metarString)
+{
+  auto cached = decodedMetarCache.constFind(metarString);
+  if(cached != decodedMetarCache.constEnd())
+    return cached.value();
+
+  return decodedMetarCache.insert(metarString, Metar(metarString)).value();
+}
+
+void WeatherReporter::addTrendObservation(const QString& airportIcao, const Metar& metar)
+{
+  const atools::fs::weather::MetarParser& parsed = metar.getParsedMetar();
+  if(parsed.isValid())
+  {
+    float pressureMbar = parsed.getPressureMbar();
+    float windSpeedKts = parsed.getWindSpeedKts();
+
+    if(pressureMbar < atools::fs::weather::INVALID_METAR_VALUE &&
+       windSpeedKts < atools::fs::weather::INVALID_METAR_VALUE)
+      weatherTrend.addObservation(airportIcao, pressureMbar, windSpeedKts);
+  }
+}
+
+void WeatherReporter::clearAirportWeatherCache()
+{
+  airportWeatherCache.clear();
+  decodedMetarCache.clear();
+  changeNumber++;
+}
+
 void WeatherReporter::preDatabaseLoad()
 {
 
@@ -688,6 +862,7 @@ void WeatherReporter::postDatabaseLoad(atools::fs::FsPaths::SimulatorType type)
   {
     // Simulator has changed - reload files
     simType = type;
+    clearAirportWeatherCache();
     updateTimeouts();
     initActiveSkyNext();
     initXplane();
@@ -700,6 +875,7 @@ void WeatherReporter::optionsChanged()
   noaaWeather->setRequestUrl(OptionData::instance().getWeatherNoaaUrl());
   ivaoWeather->setRequestUrl(OptionData::instance().getWeatherIvaoUrl());
 
+  clearAirportWeatherCache();
   updateTimeouts();
   initActiveSkyNext();
   initXplane();
@@ -731,24 +907,32 @@ void WeatherReporter::updateTimeouts()
   if(flags & optsw::WEATHER_INFO_VATSIM ||
      flags & optsw::WEATHER_TOOLTIP_VATSIM ||
      airportWeatherSource == map::WEATHER_SOURCE_VATSIM)
-    ivaoWeather->setUpdatePeriod(onlineWeatherTimeoutSecs);
+    vatsimWeather->setUpdatePeriod(onlineWeatherTimeoutSecs);
   else
-    ivaoWeather->setUpdatePeriod(-1);
+    vatsimWeather->setUpdatePeriod(-1);
 }
 
 void WeatherReporter::activeSkyWeatherFileChanged(const QString& path)
 {
   qDebug() << Q_FUNC_INFO << "file" << path << "changed";
 
-  loadActiveSkySnapshot(asPath);
-  loadActiveSkyFlightplanSnapshot(asFlightplanPath);
-  mainWindow->setStatusMessage(tr("Active Sky weather information updated."), true /* addToLog */);
+  // Parse only files which really changed and do not signal an update for
+  // duplicate events of the watcher
+  bool snapshotChanged = loadActiveSkySnapshot(asPath);
+  bool flightplanChanged = loadActiveSkyFlightplanSnapshot(asFlightplanPath);
 
-  emit weatherUpdated();
+  if(snapshotChanged || flightplanChanged)
+  {
+    clearAirportWeatherCache();
+    mainWindow->setStatusMessage(tr("Active Sky weather information updated."), true /* addToLog */);
+
+    emit weatherUpdated();
+  }
 }
 
 void WeatherReporter::xplaneWeatherFileChanged()
 {
+  clearAirportWeatherCache();
   mainWindow->setStatusMessage(tr("X-Plane weather information updated."), true /* addToLog */);
   emit weatherUpdated();
 }
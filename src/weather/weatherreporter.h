@@ -20,7 +20,9 @@
 
 #include "fs/fspaths.h"
 #include "common/mapflags.h"
+#include "weather/weathertrend.h"
 
+#include <QDateTime>
 #include <QHash>
 #include <QObject>
 
@@ -101,6 +103,36 @@ public:
   atools::fs::weather::Metar getAirportWeather(const QString& airportIcao, const atools::geo::Pos& airportPos,
                                                map::MapWeatherSource source);
 
+  /* Same as above but returns a pointer into the cache which avoids copying the parsed report
+   * for every visible airport on each map repaint. Returns null for reports that cannot be
+   * cached like weather fetched through a FSX/P3D connection. Pointer is only valid until the
+   * cache is cleared by the next weather update. */
+  const atools::fs::weather::Metar *getAirportWeatherCached(const QString& airportIcao,
+                                                            const atools::geo::Pos& airportPos,
+                                                            map::MapWeatherSource source);
+
+  /* Pressure and wind speed change of a station over roughly the last three hours. Built from
+   * the reports observed by getAirportWeather() and persisted across sessions. Not valid if
+   * the history for the station is too short. */
+  WeatherTrend::Values getWeatherTrend(const QString& airportIcao) const
+  {
+    return weatherTrend.getTrend(airportIcao);
+  }
+
+  /* Parsed report for a raw METAR text from the cache. The text is decoded on the first call
+   * only so tooltips and the info panel do not decode the same report again on each build.
+   * References are valid until the cache is cleared by the next weather update. */
+  const atools::fs::weather::Metar& getDecodedMetar(const QString& metarString, const QString& station,
+                                                    const QDateTime& timestamp, bool simFormat);
+  const atools::fs::weather::Metar& getDecodedMetar(const QString& metarString);
+
+  /* Increases whenever a weather source file or download changed. Allows cached texts
+   * like tooltips to detect outdated weather. */
+  quint64 getChangeNumber() const
+  {
+    return changeNumber;
+  }
+
   /* Does nothing currently */
   void preDatabaseLoad();
 
@@ -159,6 +191,11 @@ public:
   /* Map weather source has changed */
   void updateAirportWeather();
 
+  /* Request reports for departure, destination and alternate airports of the flight plan in the
+   * background so the information panel does not have to wait for a cold fetch per airport.
+   * Connected to the route changed signal. */
+  void preloadRouteWeather();
+
 signals:
   /* Emitted when Active Sky or X-Plane weather file changes or a request to weather was fullfilled */
   void weatherUpdated();
@@ -170,8 +207,9 @@ private:
   void activeSkyWeatherFileChanged(const QString& path);
   void xplaneWeatherFileChanged();
 
-  void loadActiveSkySnapshot(const QString& path);
-  void loadActiveSkyFlightplanSnapshot(const QString& path);
+  /* Both return true if the file was parsed and false if it was unchanged or not readable */
+  bool loadActiveSkySnapshot(const QString& path);
+  bool loadActiveSkyFlightplanSnapshot(const QString& path);
   void initActiveSkyNext();
   void findActiveSkyFiles(QString& asnSnapshot, QString& flightplanSnapshot, const QString& activeSkyPrefix,
                           const QString& activeSkySimSuffix);
@@ -187,6 +225,12 @@ private:
 
   atools::geo::Pos fetchAirportCoordinates(const QString& airportIdent);
 
+  /* Remove all parsed METARs. Called whenever a weather source file or download changed. */
+  void clearAirportWeatherCache();
+
+  /* Record pressure and wind of a parsed report in the trend history */
+  void addTrendObservation(const QString& airportIcao, const atools::fs::weather::Metar& metar);
+
   /* Update IVAO and NOAA timeout periods - timeout is disable if weather services are not used */
   void updateTimeouts();
 
@@ -194,7 +238,27 @@ private:
   atools::fs::weather::WeatherNetDownload *vatsimWeather = nullptr;
   atools::fs::weather::WeatherNetDownload *ivaoWeather = nullptr;
 
+  /* Caches parsed METARs for map painting and tooltips keyed by source and ident.
+   * Avoids parsing the same report on every paint. */
+  QHash<QString, atools::fs::weather::Metar> airportWeatherCache;
+
+  /* Caches reports decoded for display keyed by the METAR text. Cleared together with the
+   * cache above on every weather update. */
+  QHash<QString, atools::fs::weather::Metar> decodedMetarCache;
+
+  /* Bumped on every weather update together with clearing the caches above */
+  quint64 changeNumber = 0;
+
+  /* Compact pressure and wind history per observed station - see getWeatherTrend() */
+  WeatherTrend weatherTrend;
+
   QHash<QString, QString> activeSkyMetars;
+
+  /* Size and timestamp of the last parsed weather and flight plan weather snapshots. The file
+   * watcher fires several times per update on some systems - an unchanged file is not parsed
+   * again and no update is signalled for it. */
+  QDateTime activeSkySnapshotTimestamp, activeSkyFlightplanSnapshotTimestamp;
+  qint64 activeSkySnapshotSize = 0, activeSkyFlightplanSnapshotSize = 0;
   QString activeSkyDepartureMetar, activeSkyDestinationMetar,
           activeSkyDepartureIdent, activeSkyDestinationIdent;
 
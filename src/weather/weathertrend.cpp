@@ -0,0 +1,178 @@
+/*****************************************************************************
+* Copyright 2015-2020 Alexander Barthel alex@littlenavmap.org
+*
+* This program is free software: you can redistribute it and/or modify
+* it under the terms of the GNU General Public License as published by
+* the Free Software Foundation, either version 3 of the License, or
+* (at your option) any later version.
+*
+* This program is distributed in the hope that it will be useful,
+* but WITHOUT ANY WARRANTY; without even the implied warranty of
+* MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+* GNU General Public License for more details.
+*
+* You should have received a copy of the GNU General Public License
+* along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*****************************************************************************/
+
+#include "weather/weathertrend.h"
+
+#include "settings/settings.h"
+
+#include <QDataStream>
+#include <QDateTime>
+#include <QDebug>
+#include <QFile>
+
+const static quint32 FILE_MAGIC_NUMBER = 0x5CB2E7A1;
+const static quint16 FILE_VERSION = 1;
+
+/* Keep at most this many samples per station. Covers more than the trend period at the
+ * usual report interval of 30 to 60 minutes. */
+const static int MAX_SAMPLES_PER_STATION = 8;
+
+/* Ignore observations following the previous one closer than this - reports do not change faster */
+const static qint64 MIN_SAMPLE_INTERVAL_SECS = 600L;
+
+/* Trend is the change over this period */
+const static qint64 TREND_PERIOD_SECS = 3L * 3600L;
+
+/* Oldest usable sample has to be at least this old for a valid trend */
+const static qint64 MIN_TREND_PERIOD_SECS = 3600L;
+
+/* Drop samples older than this when saving */
+const static qint64 MAX_SAMPLE_AGE_SECS = 12L * 3600L;
+
+QDataStream& operator>>(QDataStream& dataStream, WeatherTrend::Sample& sample)
+{
+  dataStream >> sample.timestampSecs >> sample.pressureMbar >> sample.windSpeedKts;
+  return dataStream;
+}
+
+QDataStream& operator<<(QDataStream& dataStream, const WeatherTrend::Sample& sample)
+{
+  dataStream << sample.timestampSecs << sample.pressureMbar << sample.windSpeedKts;
+  return dataStream;
+}
+
+void WeatherTrend::addObservation(const QString& station, float pressureMbar, float windSpeedKts)
+{
+  QVector<Sample>& samples = samplesByStation[station];
+  qint64 now = QDateTime::currentSecsSinceEpoch();
+
+  if(!samples.isEmpty() && now - samples.constLast().timestampSecs < MIN_SAMPLE_INTERVAL_SECS)
+    // Report cannot have changed yet - keep the existing sample
+    return;
+
+  if(samples.size() >= MAX_SAMPLES_PER_STATION)
+    samples.removeFirst();
+
+  Sample sample;
+  sample.timestampSecs = now;
+  sample.pressureMbar = pressureMbar;
+  sample.windSpeedKts = windSpeedKts;
+  samples.append(sample);
+}
+
+WeatherTrend::Values WeatherTrend::getTrend(const QString& station) const
+{
+  Values values;
+
+  auto it = samplesByStation.constFind(station);
+  if(it == samplesByStation.constEnd() || it.value().size() < 2)
+    return values;
+
+  const QVector<Sample>& samples = it.value();
+  const Sample& newest = samples.constLast();
+
+  // Use the oldest sample inside the trend period
+  const Sample *oldest = nullptr;
+  for(const Sample& sample : samples)
+  {
+    if(newest.timestampSecs - sample.timestampSecs <= TREND_PERIOD_SECS)
+    {
+      oldest = &sample;
+      break;
+    }
+  }
+
+  if(oldest != nullptr && newest.timestampSecs - oldest->timestampSecs >= MIN_TREND_PERIOD_SECS)
+  {
+    values.pressureChangeMbar = newest.pressureMbar - oldest->pressureMbar;
+    values.windSpeedChangeKts = newest.windSpeedKts - oldest->windSpeedKts;
+    values.valid = true;
+  }
+  return values;
+}
+
+void WeatherTrend::clear()
+{
+  samplesByStation.clear();
+}
+
+void WeatherTrend::saveState() const
+{
+  QFile historyFile(atools::settings::Settings::getConfigFilename(".weatherhistory"));
+
+  if(historyFile.open(QIODevice::WriteOnly))
+  {
+    QDataStream out(&historyFile);
+    out.setVersion(QDataStream::Qt_5_5);
+    out.setFloatingPointPrecision(QDataStream::SinglePrecision);
+    out << FILE_MAGIC_NUMBER << FILE_VERSION;
+
+    qint64 oldestKept = QDateTime::currentSecsSinceEpoch() - MAX_SAMPLE_AGE_SECS;
+    for(auto it = samplesByStation.constBegin(); it != samplesByStation.constEnd(); ++it)
+    {
+      // Drop stations where all samples are too old to contribute to a trend
+      if(!it.value().isEmpty() && it.value().constLast().timestampSecs > oldestKept)
+        out << it.key() << it.value();
+    }
+    historyFile.close();
+  }
+  else
+    qWarning() << "Cannot write weather history" << historyFile.fileName() << ":" << historyFile.errorString();
+}
+
+void WeatherTrend::restoreState()
+{
+  clear();
+
+  QFile historyFile(atools::settings::Settings::getConfigFilename(".weatherhistory"));
+  if(historyFile.exists())
+  {
+    if(historyFile.open(QIODevice::ReadOnly))
+    {
+      QDataStream in(&historyFile);
+      in.setVersion(QDataStream::Qt_5_5);
+      in.setFloatingPointPrecision(QDataStream::SinglePrecision);
+
+      quint32 magic;
+      quint16 version;
+      in >> magic;
+
+      if(magic == FILE_MAGIC_NUMBER)
+      {
+        in >> version;
+        if(version == FILE_VERSION)
+        {
+          while(!in.atEnd())
+          {
+            QString station;
+            QVector<Sample> samples;
+            in >> station >> samples;
+            samplesByStation.insert(station, samples);
+          }
+        }
+        else
+          qWarning() << "Weather history version mismatch" << version << "!=" << FILE_VERSION;
+      }
+      else
+        qWarning() << "Weather history file not valid";
+
+      historyFile.close();
+    }
+    else
+      qWarning() << "Cannot read weather history" << historyFile.fileName() << ":" << historyFile.errorString();
+  }
+}
@@ -0,0 +1,75 @@
+/*****************************************************************************
+* Copyright 2015-2020 Alexander Barthel alex@littlenavmap.org
+*
+* This program is free software: you can redistribute it and/or modify
+* it under the terms of the GNU General Public License as published by
+* the Free Software Foundation, either version 3 of the License, or
+* (at your option) any later version.
+*
+* This program is distributed in the hope that it will be useful,
+* but WITHOUT ANY WARRANTY; without even the implied warranty of
+* MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+* GNU General Public License for more details.
+*
+* You should have received a copy of the GNU General Public License
+* along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*****************************************************************************/
+
+#ifndef LNM_WEATHERTREND_H
+#define LNM_WEATHERTREND_H
+
+#include <QHash>
+#include <QVector>
+
+class QDataStream;
+
+/*
+ * Keeps a compact history of observed METAR values per station to compute pressure and wind
+ * trends over the last hours. Each station holds a small ring of fixed size samples so the
+ * memory cost stays at a few dozen bytes per observed station. The history is persisted as a
+ * binary file across sessions since reports only change every 30 to 60 minutes and a three
+ * hour window would rarely fill within one session otherwise.
+ */
+class WeatherTrend
+{
+public:
+  /* Change of pressure and wind speed over the trend period ending at the newest sample */
+  struct Values
+  {
+    float pressureChangeMbar = 0.f, windSpeedChangeKts = 0.f;
+
+    /* True if the history for the station spans enough time for a trend */
+    bool valid = false;
+  };
+
+  /* Add the values of an observed report for a station. Observations following the previous
+   * one too closely are ignored so repaints do not flood the ring. */
+  void addObservation(const QString& station, float pressureMbar, float windSpeedKts);
+
+  /* Get the change over the trend period for a station. Not valid if the oldest usable
+   * sample is too recent. */
+  Values getTrend(const QString& station) const;
+
+  /* Remove all samples */
+  void clear();
+
+  /* Save to and load from the binary history file in the settings directory */
+  void saveState() const;
+  void restoreState();
+
+private:
+  /* Fixed size binary sample record */
+  struct Sample
+  {
+    qint64 timestampSecs = 0L;
+    float pressureMbar = 0.f, windSpeedKts = 0.f;
+  };
+
+  friend QDataStream& operator>>(QDataStream& dataStream, Sample& sample);
+  friend QDataStream& operator<<(QDataStream& dataStream, const Sample& sample);
+
+  /* Rings of the newest samples per station - oldest sample first */
+  QHash<QString, QVector<Sample> > samplesByStation;
+};
+
+#endif // LNM_WEATHERTREND_H
@@ -17,6 +17,7 @@
 
 #include "weather/windreporter.h"
 
+#include "atools.h"
 #include "navapp.h"
 #include "ui_mainwindow.h"
 #include "grib/windquery.h"
@@ -140,15 +141,36 @@ void WindReporter::updateDataSource()
       path = NavApp::getSimulatorBasePath(NavApp::getCurrentSimulatorDb()) + QDir::separator() + "global_winds.grib";
 
     if(QFileInfo::exists(path))
-      windQuery->initFromFile(path);
+    {
+      // Skip decoding again if the same file with the same timestamp is already loaded
+      QDateTime timestamp = QFileInfo(path).lastModified();
+      if(path != loadedWindSource || timestamp != loadedWindFileTimestamp || !windQuery->hasWindData())
+      {
+        loadedWindSource = path;
+        loadedWindFileTimestamp = timestamp;
+        windQuery->initFromFile(path);
+      }
+    }
   }
   else if(ui->actionMapShowWindNOAA->isChecked())
-    // Download from NOAA - will call windDownloadFinished later
-    windQuery->initFromUrl(OptionData::instance().getWeatherNoaaWindBaseUrl());
+  {
+    // Download from NOAA - will call windDownloadFinished later.
+    // Keep the already downloaded and decoded cycle if the URL did not change.
+    QString url = OptionData::instance().getWeatherNoaaWindBaseUrl();
+    if(url != loadedWindSource || !windQuery->hasWindData())
+    {
+      loadedWindSource = url;
+      loadedWindFileTimestamp = QDateTime();
+      windQuery->initFromUrl(url);
+    }
+  }
   else
   {
     windQuery->deinit();
+    loadedWindSource.clear();
+    loadedWindFileTimestamp = QDateTime();
     updateToolButtonState();
+    changeNumber++;
     emit windUpdated();
   }
 }
@@ -174,6 +196,7 @@ void WindReporter::windDownloadFinished()
     }
     NavApp::setStatusMessage(msg, true /* addToLog */);
   }
+  changeNumber++;
   emit windUpdated();
 }
 
@@ -342,6 +365,7 @@ void WindReporter::toolbarActionFlightplanTriggered()
   {
     actionToValues();
     updateToolButtonState();
+    changeNumber++;
     emit windUpdated();
   }
 }
@@ -352,6 +376,7 @@ void WindReporter::toolbarActionTriggered()
   {
     actionToValues();
     updateToolButtonState();
+    changeNumber++;
     emit windUpdated();
   }
 }
@@ -564,6 +589,17 @@ atools::grib::Wind WindReporter::getWindForPosRoute(const atools::geo::Pos& pos)
   return (NavApp::getAircraftPerfController()->isWindManual() ? windQueryManual : windQuery)->getWindForPos(pos);
 }
 
+void WindReporter::getWindForPositionsRoute(QVector<atools::grib::Wind>& winds,
+                                            const atools::geo::LineString& positions)
+{
+  // Resolve the active query only once instead of once per position
+  atools::grib::WindQuery *query = NavApp::getAircraftPerfController()->isWindManual() ? windQueryManual : windQuery;
+
+  winds.reserve(positions.size());
+  for(const atools::geo::Pos& pos : positions)
+    winds.append(pos.isValid() ? query->getWindForPos(pos) : atools::grib::EMPTY_WIND);
+}
+
 atools::grib::Wind WindReporter::getWindForLineRoute(const atools::geo::Pos& pos1, const atools::geo::Pos& pos2)
 {
   return (NavApp::getAircraftPerfController()->isWindManual() ? windQueryManual : windQuery)->
@@ -623,9 +659,19 @@ atools::grib::WindPosVector WindReporter::getWindStackForPos(const atools::geo::
 
 void WindReporter::updateManualRouteWinds()
 {
-  windQueryManual->initFromFixedModel(NavApp::getAircraftPerfController()->getWindDir(),
-                                      NavApp::getAircraftPerfController()->getWindSpeed(),
-                                      NavApp::getRoute().getCruisingAltitudeFeet());
+  float dir = NavApp::getAircraftPerfController()->getWindDir();
+  float speed = NavApp::getAircraftPerfController()->getWindSpeed();
+  float altitude = NavApp::getRoute().getCruisingAltitudeFeet();
+
+  if(atools::almostNotEqual(dir, lastManualWindDir) || atools::almostNotEqual(speed, lastManualWindSpeed) ||
+     atools::almostNotEqual(altitude, lastManualWindAltitude))
+    changeNumber++;
+
+  lastManualWindDir = dir;
+  lastManualWindSpeed = speed;
+  lastManualWindAltitude = altitude;
+
+  windQueryManual->initFromFixedModel(dir, speed, altitude);
 }
 
 #ifdef DEBUG_INFORMATION
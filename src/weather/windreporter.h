@@ -22,6 +22,8 @@
 
 #include "query/querytypes.h"
 
+#include <QDateTime>
+
 namespace atools {
 namespace geo {
 class Rect;
@@ -97,6 +99,13 @@ public:
     return currentLevel;
   }
 
+  /* Increases whenever the wind situation changes. Allows cached calculations
+   * like the route altitude profile to detect changed winds. */
+  quint64 getChangeNumber() const
+  {
+    return changeNumber;
+  }
+
   /* true if wind barbs grid is to be drawn */
   bool isWindShown() const;
 
@@ -126,6 +135,10 @@ public:
   /* Get (interpolated) wind for given position and altitude. Use manual wind setting if checkbox is set. */
   atools::grib::Wind getWindForPosRoute(const atools::geo::Pos& pos);
 
+  /* Get interpolated winds for all positions in one pass. The altitude field of each position
+   * contains the altitude. Invalid positions get an empty wind. Use manual wind setting if checkbox is set. */
+  void getWindForPositionsRoute(QVector<atools::grib::Wind>& winds, const atools::geo::LineString& positions);
+
   /* Get interpolated winds for lines. Use manual wind setting if checkbox is set. */
   atools::grib::Wind getWindForLineRoute(const atools::geo::Pos& pos1, const atools::geo::Pos& pos2);
   atools::grib::Wind getWindForLineRoute(const atools::geo::Line& line);
@@ -212,10 +225,21 @@ private:
   /* Avoid action signals when updating GUI elements */
   bool ignoreUpdates = false;
 
+  /* Increased whenever the wind data or the manual wind setting changes */
+  quint64 changeNumber = 0;
+
+  /* Last values used for the manual wind query to detect changes */
+  float lastManualWindDir = -1.f, lastManualWindSpeed = -1.f, lastManualWindAltitude = -1.f;
+
   /* Wind positions as a result of querying the rectangle for caching */
   query::SimpleRectCache<atools::grib::WindPos> windPosCache;
   int cachedLevel = wind::NONE;
 
+  /* File or URL and file timestamp of the currently loaded wind data. Used to skip
+   * downloading and decoding the unchanged data again on option or database changes. */
+  QString loadedWindSource;
+  QDateTime loadedWindFileTimestamp;
+
   bool downloadErrorReported = false;
 };
 
@@ -0,0 +1,65 @@
+/*****************************************************************************
+* Copyright 2015-2020 Alexander Barthel alex@littlenavmap.org
+*
+* This program is free software: you can redistribute it and/or modify
+* it under the terms of the GNU General Public License as published by
+* the Free Software Foundation, either version 3 of the License, or
+* (at your option) any later version.
+*
+* This program is distributed in the hope that it will be useful,
+* but WITHOUT ANY WARRANTY; without even the implied warranty of
+* MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+* GNU General Public License for more details.
+*
+* You should have received a copy of the GNU General Public License
+* along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*****************************************************************************/
+
+#include "web/mapimagecache.h"
+
+#include <QDateTime>
+
+MapImageCache::MapImageCache(int maxCostBytes, int maxAgeMilliSec)
+  : cache(maxCostBytes), maxAgeMs(maxAgeMilliSec)
+{
+}
+
+bool MapImageCache::getImage(const QString& key, MapPixmap& mapPixmap, QByteArray& bytes)
+{
+  QMutexLocker locker(&mutex);
+
+  Entry *entry = cache.object(key);
+  if(entry == nullptr)
+    return false;
+
+  if(QDateTime::currentMSecsSinceEpoch() - entry->timestampMilliSec > maxAgeMs)
+  {
+    // Too old - aircraft and route have moved on
+    cache.remove(key);
+    return false;
+  }
+
+  mapPixmap = entry->mapPixmap;
+  bytes = entry->bytes;
+  return true;
+}
+
+void MapImageCache::insertImage(const QString& key, const MapPixmap& mapPixmap, const QByteArray& bytes)
+{
+  QMutexLocker locker(&mutex);
+
+  Entry *entry = new Entry;
+  entry->mapPixmap = mapPixmap;
+  entry->bytes = bytes;
+  entry->timestampMilliSec = QDateTime::currentMSecsSinceEpoch();
+
+  // Cost is the approximate pixmap size in memory plus the encoded bytes
+  cache.insert(key, entry, mapPixmap.pixmap.width() * mapPixmap.pixmap.height() * mapPixmap.pixmap.depth() / 8 +
+               bytes.size());
+}
+
+void MapImageCache::clear()
+{
+  QMutexLocker locker(&mutex);
+  cache.clear();
+}
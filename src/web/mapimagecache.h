@@ -0,0 +1,62 @@
+/*****************************************************************************
+* Copyright 2015-2020 Alexander Barthel alex@littlenavmap.org
+*
+* This program is free software: you can redistribute it and/or modify
+* it under the terms of the GNU General Public License as published by
+* the Free Software Foundation, either version 3 of the License, or
+* (at your option) any later version.
+*
+* This program is distributed in the hope that it will be useful,
+* but WITHOUT ANY WARRANTY; without even the implied warranty of
+* MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+* GNU General Public License for more details.
+*
+* You should have received a copy of the GNU General Public License
+* along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*****************************************************************************/
+
+#ifndef LNM_MAPIMAGECACHE_H
+#define LNM_MAPIMAGECACHE_H
+
+#include "web/webmapcontroller.h"
+
+#include <QCache>
+#include <QMutex>
+
+/*
+ * Thread safe LRU cache for rendered map images of the web server.
+ *
+ * All map rendering has to run serialized in the GUI thread. This cache allows the HTTP server
+ * threads to serve recently rendered viewports directly without blocking behind a render.
+ * The encoded image bytes are stored along with the pixmap so cache hits also skip the encoding.
+ * Entries expire after a short time since the shown aircraft and route change constantly.
+ */
+class MapImageCache
+{
+public:
+  /* maxCostBytes is the memory budget for cached pixmaps, maxAgeMilliSec the expiry time */
+  MapImageCache(int maxCostBytes, int maxAgeMilliSec);
+
+  /* Fetches a cached image and its encoded bytes for the key.
+   * Returns false if there is no entry or it is expired. */
+  bool getImage(const QString& key, MapPixmap& mapPixmap, QByteArray& bytes);
+
+  /* Adds a rendered image and its encoded bytes. The cost is the size of pixmap and bytes. */
+  void insertImage(const QString& key, const MapPixmap& mapPixmap, const QByteArray& bytes);
+
+  void clear();
+
+private:
+  struct Entry
+  {
+    MapPixmap mapPixmap;
+    QByteArray bytes;
+    qint64 timestampMilliSec;
+  };
+
+  QCache<QString, Entry> cache;
+  int maxAgeMs;
+  QMutex mutex;
+};
+
+#endif // LNM_MAPIMAGECACHE_H
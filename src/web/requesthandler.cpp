@@ -34,10 +34,13 @@
 #include "util/htmlbuilder.h"
 #include "gui/helphandler.h"
 #include "common/constants.h"
+#include "settings/settings.h"
 
 #include <QBuffer>
 #include <QCoreApplication>
+#include <QCryptographicHash>
 #include <QDir>
+#include <QImageWriter>
 #include <QPainter>
 #include <QtWidgets/QApplication>
 
@@ -45,7 +48,12 @@ using namespace stefanfrings;
 
 RequestHandler::RequestHandler(QObject *parent, WebMapController *webMapController,
                                HtmlInfoBuilder *htmlInfoBuilderParam, bool verboseParam)
-  : HttpRequestHandler(parent), htmlInfoBuilder(htmlInfoBuilderParam), verbose(verboseParam)
+  : HttpRequestHandler(parent), htmlInfoBuilder(htmlInfoBuilderParam),
+  mapImageCache(atools::settings::Settings::instance().
+                getAndStoreValue(lnm::OPTIONS_WEBSERVER_IMAGE_CACHE_SIZE, 32 * 1024 * 1024).toInt(),
+                atools::settings::Settings::instance().
+                getAndStoreValue(lnm::OPTIONS_WEBSERVER_IMAGE_CACHE_AGE_MS, 1000).toInt()),
+  verbose(verboseParam)
 {
   qDebug() << Q_FUNC_INFO;
 
@@ -72,6 +80,10 @@ RequestHandler::RequestHandler(QObject *parent, WebMapController *webMapControll
           Qt::BlockingQueuedConnection);
   connect(this, &RequestHandler::getPixmapRect, webMapController, &WebMapController::getPixmapRect,
           Qt::BlockingQueuedConnection);
+  connect(this, &RequestHandler::getMapFeatures, webMapController, &WebMapController::getFeatureJson,
+          Qt::BlockingQueuedConnection);
+  connect(this, &RequestHandler::getGeoJson, webMapController, &WebMapController::getGeoJson,
+          Qt::BlockingQueuedConnection);
 }
 
 RequestHandler::~RequestHandler()
@@ -99,6 +111,14 @@ void RequestHandler::service(HttpRequest& request, HttpResponse& response)
     // ===========================================================================
     // Requests for map images only - either with or without session
     handleMapImage(request, response);
+  else if(path == "/api/features")
+    // ===========================================================================
+    // Viewport-culled map features as compact JSON - sessionless
+    handleFeatures(request, response);
+  else if(path == "/api/geojson")
+    // ===========================================================================
+    // Flight plan, aircraft track and user aircraft as GeoJSON - sessionless
+    handleGeoJson(request, response);
   else
   {
     HttpSession session = getSession(request, response);
@@ -275,7 +295,21 @@ void RequestHandler::service(HttpRequest& request, HttpResponse& response)
 
             // ===========================================================================
             // Write resonse
-            response.write(t.toUtf8(), true);
+            QByteArray content = t.toUtf8();
+
+            // Stamp the rendered content like for the feature endpoint so polling clients
+            // can skip unchanged aircraft, progress and plan updates with an empty 304
+            QByteArray etag = "\"" + QCryptographicHash::hash(content, QCryptographicHash::Md5).toHex() + "\"";
+            response.setHeader("ETag", etag);
+
+            if(request.getHeader("If-None-Match") == etag)
+            {
+              // Client already has the current content - send the headers only
+              response.setStatus(304);
+              response.write(QByteArray(), true);
+            }
+            else
+              response.write(content, true);
           }
           else
             showError(request, response, 500, "Internal server error. Template empty.");
@@ -301,15 +335,35 @@ void RequestHandler::handleMapImage(HttpRequest& request, HttpResponse& response
   int width = params.asInt("width", 0);
   int height = params.asInt("height", 0);
 
-  // Image format, jpg is default and only jpg and png allowed ===========================================
-  QString format = params.asEnum("format", "jpg", {"jpg", "png"});
+  // Image format, jpg is default and only jpg, png and webp allowed =====================================
+  QString format = params.asEnum("format", "jpg", {"jpg", "png", "webp"});
+
+  // WEBP support depends on the installed Qt image plugins - fall back to jpg if not available
+  if(format == "webp" && !QImageWriter::supportedImageFormats().contains("webp"))
+    format = "jpg";
 
   MapPixmap mapPixmap;
+  QByteArray bytes;
 
   // Distance as KM
   float requestedDistanceKm = atools::geo::nmToKm(params.asFloat("distance", 100.0f));
 
-  if(params.has("session"))
+  // Check the image cache first to avoid blocking behind the GUI thread renderer for
+  // viewports which were just rendered for another client. Hits carry the encoded bytes.
+  QString cacheKey = mapImageCacheKey(request, response, width, height, quality, format);
+  bool cacheHit = !cacheKey.isEmpty() && mapImageCache.getImage(cacheKey, mapPixmap, bytes);
+
+  if(cacheHit && params.has("session"))
+  {
+    // Keep the session position in sync when serving from the cache
+    HttpSession session = getSession(request, response);
+    session.set("requested_distance", QVariant(mapPixmap.requestedDistanceKm));
+    session.set("corrected_distance", QVariant(mapPixmap.correctedDistanceKm));
+    session.set("lon", mapPixmap.pos.getLonX());
+    session.set("lat", mapPixmap.pos.getLatY());
+  }
+
+  if(!cacheHit && params.has("session"))
   {
     // ===========================================================================
     // Stateful handling using a session which has the last zoom and position
@@ -359,23 +413,24 @@ void RequestHandler::handleMapImage(HttpRequest& request, HttpResponse& response
   }
   // ============================================================================
   // Session-less / state-less calls ============================================
-  else if(params.has("user"))
+  else if(!cacheHit && (params.has("user")))
     // User aircraft =======================
     mapPixmap = emit getPixmapObject(width, height, web::USER_AIRCRAFT, QString(), requestedDistanceKm);
-  else if(params.has("route"))
+  else if(!cacheHit && (params.has("route")))
     // Center flight plan =======================
     mapPixmap = emit getPixmapObject(width, height, web::ROUTE, QString(), requestedDistanceKm);
-  else if(params.has("airport"))
+  else if(!cacheHit && (params.has("airport")))
     // Show airport =======================
     mapPixmap = emit getPixmapObject(width, height, web::AIRPORT, params.asStr("airport"), requestedDistanceKm);
-  else if(params.has("leftlon") && params.has("toplat") && params.has("rightlon") && params.has("bottomlat"))
+  else if(!cacheHit &&
+          (params.has("leftlon") && params.has("toplat") && params.has("rightlon") && params.has("bottomlat")))
   {
     // Show rectangle =======================
     atools::geo::Rect rect(params.asFloat("leftlon"), params.asFloat("toplat"),
                            params.asFloat("rightlon"), params.asFloat("bottomlat"));
     mapPixmap = emit getPixmapRect(width, height, rect);
   }
-  else if(params.has("distance") || (params.has("lon") && params.has("lat")))
+  else if(!cacheHit && (params.has("distance") || (params.has("lon") && params.has("lat"))))
   {
     // Show position =======================
     atools::geo::Pos pos;
@@ -387,31 +442,39 @@ void RequestHandler::handleMapImage(HttpRequest& request, HttpResponse& response
 
     mapPixmap = emit getPixmapPosDistance(width, height, pos, requestedDistanceKm, QString());
   }
-  else
+  else if(!cacheHit)
     // Show current map view =======================
     mapPixmap = emit getPixmap(width, height);
 
   if(mapPixmap.isValid() && !mapPixmap.hasError())
   {
     // ===========================================================================
-    // Write pixmap as image
-    QByteArray bytes;
-    QBuffer buffer(&bytes);
-    buffer.open(QIODevice::WriteOnly);
+    // Write pixmap as image - cache hits were already encoded
+    if(bytes.isEmpty())
+    {
+      QBuffer buffer(&bytes);
+      buffer.open(QIODevice::WriteOnly);
+
+      if(format == "jpg")
+        mapPixmap.pixmap.save(&buffer, "JPG", quality);
+      else if(format == "png")
+        mapPixmap.pixmap.save(&buffer, "PNG", quality);
+      else if(format == "webp")
+        mapPixmap.pixmap.save(&buffer, "WEBP", quality);
+      else
+        // Should never happen
+        qWarning() << Q_FUNC_INFO << "invalid format";
+
+      if(!cacheHit && !cacheKey.isEmpty())
+        mapImageCache.insertImage(cacheKey, mapPixmap, bytes);
+    }
 
     if(format == "jpg")
-    {
       response.setHeader("Content-Type", "image/jpeg");
-      mapPixmap.pixmap.save(&buffer, "JPG", quality);
-    }
     else if(format == "png")
-    {
       response.setHeader("Content-Type", "image/png");
-      mapPixmap.pixmap.save(&buffer, "PNG", quality);
-    }
-    else
-      // Should never happen
-      qWarning() << Q_FUNC_INFO << "invalid format";
+    else if(format == "webp")
+      response.setHeader("Content-Type", "image/webp");
 
     response.write(bytes);
   }
@@ -420,6 +483,68 @@ void RequestHandler::handleMapImage(HttpRequest& request, HttpResponse& response
     showErrorPixmap(response, width, height, 404, mapPixmap.error);
 }
 
+void RequestHandler::handleFeatures(HttpRequest& request, HttpResponse& response)
+{
+  Parameter params(request);
+
+  if(!params.has("leftlon") || !params.has("toplat") || !params.has("rightlon") || !params.has("bottomlat"))
+  {
+    // Viewport rectangle is required
+    response.setStatus(400);
+    response.setHeader("Content-Type", "application/json; charset=UTF-8");
+    response.write("{\"error\": \"Missing viewport parameters leftlon, toplat, rightlon and bottomlat.\"}", true);
+    return;
+  }
+
+  atools::geo::Rect rect(params.asFloat("leftlon"), params.asFloat("toplat"),
+                         params.asFloat("rightlon"), params.asFloat("bottomlat"));
+
+  // Zoom distance as NM selecting the feature detail level like for map images
+  float distanceKm = atools::geo::nmToKm(params.asFloat("distance", 100.0f));
+
+  // Collect and serialize features in the main thread
+  QByteArray features = emit getMapFeatures(rect, distanceKm);
+
+  // Stamp the content generation so unchanged viewports can be answered with 304 without a body
+  QByteArray etag = "\"" + QCryptographicHash::hash(features, QCryptographicHash::Md5).toHex() + "\"";
+  response.setHeader("ETag", etag);
+  response.setHeader("Content-Type", "application/json; charset=UTF-8");
+
+  if(request.getHeader("If-None-Match") == etag)
+  {
+    // Client already has the current generation - send the headers only
+    response.setStatus(304);
+    response.write(QByteArray(), true);
+  }
+  else
+    response.write(features, true);
+}
+
+void RequestHandler::handleGeoJson(HttpRequest& request, HttpResponse& response)
+{
+  Parameter params(request);
+
+  // Timestamp of the newest track point the client has - zero returns the whole track
+  quint32 trackTimestamp = static_cast<quint32>(params.asInt("tracktime", 0));
+
+  // Collect and serialize in the main thread
+  QByteArray geoJson = emit getGeoJson(trackTimestamp);
+
+  // Stamp the content generation so unchanged states can be answered with 304 without a body
+  QByteArray etag = "\"" + QCryptographicHash::hash(geoJson, QCryptographicHash::Md5).toHex() + "\"";
+  response.setHeader("ETag", etag);
+  response.setHeader("Content-Type", "application/geo+json; charset=UTF-8");
+
+  if(request.getHeader("If-None-Match") == etag)
+  {
+    // Client already has the current generation - send the headers only
+    response.setStatus(304);
+    response.write(QByteArray(), true);
+  }
+  else
+    response.write(geoJson, true);
+}
+
 void RequestHandler::showErrorPixmap(HttpResponse& response, int width, int height, int status, const QString& text)
 {
   qWarning() << Q_FUNC_INFO << "Error" << status << text;
@@ -471,6 +596,36 @@ void RequestHandler::showError(HttpRequest& request, HttpResponse& response, int
   response.write(t.toUtf8(), true);
 }
 
+QString RequestHandler::mapImageCacheKey(HttpRequest& request, HttpResponse& response,
+                                         int width, int height, int quality, const QString& format)
+{
+  Parameter params(request);
+
+  QString mapcmd = params.asStr("mapcmd");
+
+  // Zoom and scroll commands modify the session state and may not be served from the cache
+  if(!mapcmd.isEmpty() && mapcmd != "user" && mapcmd != "route" && mapcmd != "airport")
+    return QString();
+
+  QStringList key({QString::number(width), QString::number(height), QString::number(quality), format, mapcmd});
+
+  // All remaining parameters defining the shown viewport
+  for(const QString& name : QStringList({"distance", "airport", "user", "route", "lon", "lat",
+                                         "leftlon", "toplat", "rightlon", "bottomlat"}))
+    key.append(params.asStr(name));
+
+  if(params.has("session"))
+  {
+    // Position and zoom distance of stateful requests come from the session
+    HttpSession session = getSession(request, response);
+    key.append(session.get("lon").toString());
+    key.append(session.get("lat").toString());
+    key.append(session.get("requested_distance").toString());
+  }
+
+  return key.join('_');
+}
+
 stefanfrings::HttpSession RequestHandler::getSession(HttpRequest& request, HttpResponse& response)
 {
   HttpSession session = WebApp::getSessionStore()->getSession(request, response);
@@ -22,6 +22,7 @@
 
 #include "web/webflags.h"
 #include "web/webmapcontroller.h"
+#include "web/mapimagecache.h"
 
 #include <QPixmap>
 
@@ -66,6 +67,8 @@ signals:
   MapPixmap getPixmapObject(int width, int height, web::ObjectType type, QString ident, float distanceKm);
   MapPixmap getPixmapPosDistance(int width, int height, atools::geo::Pos pos, float distanceKm, QString mapCommand);
   MapPixmap getPixmapRect(int width, int height, atools::geo::Rect rect);
+  QByteArray getMapFeatures(atools::geo::Rect rect, float distanceKm);
+  QByteArray getGeoJson(quint32 trackTimestamp);
 
   atools::fs::sc::SimConnectUserAircraft getUserAircraft();
   Route getRoute();
@@ -87,6 +90,20 @@ private:
   /* Handle stateful and stateless map image requests. */
   void handleMapImage(stefanfrings::HttpRequest& request, stefanfrings::HttpResponse& response);
 
+  /* Handle requests for viewport-culled map features as compact JSON.
+   * Answers with 304 if the client already has the current generation. */
+  void handleFeatures(stefanfrings::HttpRequest& request, stefanfrings::HttpResponse& response);
+
+  /* Handle requests for the flight plan, the aircraft track and the user aircraft as GeoJSON.
+   * The "tracktime" parameter limits the track to newer points for incremental polling.
+   * Answers with 304 if the client already has the current generation. */
+  void handleGeoJson(stefanfrings::HttpRequest& request, stefanfrings::HttpResponse& response);
+
+  /* Build the image cache key from all parameters defining the resulting image.
+   * Returns an empty string for requests that may not be served from the cache. */
+  QString mapImageCacheKey(stefanfrings::HttpRequest& request, stefanfrings::HttpResponse& response,
+                           int width, int height, int quality, const QString& format);
+
   /* Build the select dropdown box HTML code with the default value pre-selected. */
   QString buildRefreshSelect(int defaultValue);
 
@@ -95,6 +112,10 @@ private:
 
   HtmlInfoBuilder *htmlInfoBuilder;
 
+  /* Shared by all server threads - allows to serve recently rendered viewports
+   * without blocking behind the single GUI thread renderer */
+  MapImageCache mapImageCache;
+
   bool verbose = false;
 };
 
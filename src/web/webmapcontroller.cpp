@@ -21,9 +21,19 @@
 
 #include "mapgui/mappaintwidget.h"
 #include "mapgui/mapwidget.h"
+#include "mapgui/maplayer.h"
+#include "mappainter/mappaintlayer.h"
+#include "common/aircrafttrack.h"
+#include "fs/sc/simconnectuseraircraft.h"
+#include "query/mapquery.h"
+#include "query/waypointtrackquery.h"
+#include "route/route.h"
 #include "navapp.h"
 
 #include <QDebug>
+#include <QJsonArray>
+#include <QJsonDocument>
+#include <QJsonObject>
 #include <QPixmap>
 
 WebMapController::WebMapController(QWidget *parent, bool verboseParam)
@@ -230,3 +240,232 @@ MapPixmap WebMapController::getPixmapRect(int width, int height, atools::geo::Re
     qWarning() << Q_FUNC_INFO << "mapPaintWidget is null";
   return mapPixmap;
 }
+
+QByteArray WebMapController::getFeatureJson(atools::geo::Rect rect, float distanceKm)
+{
+  if(verbose)
+    qDebug() << Q_FUNC_INFO << rect << "distanceKm" << distanceKm;
+
+  QJsonObject root;
+  if(mapPaintWidget != nullptr && rect.isValid())
+  {
+    // Use the layer stack of the map display to get the detail level for the zoom distance
+    const MapLayer *mapLayer = mapPaintWidget->getMapPaintLayer()->getMapLayerForDistance(distanceKm);
+
+    Marble::GeoDataLatLonBox box(rect.getNorth(), rect.getSouth(), rect.getEast(), rect.getWest(),
+                                 Marble::GeoDataCoordinates::Degree);
+
+    MapQuery *mapQuery = NavApp::getMapQuery();
+
+    // Airports ===========================================================
+    QJsonArray airports;
+    if(mapLayer->isAirport())
+    {
+      for(const map::MapAirport& airport : *mapQuery->getAirports(box, mapLayer, false /* lazy */))
+      {
+        // The query caches are inflated beyond the viewport - cull to the requested rectangle
+        if(!rect.contains(airport.position))
+          continue;
+
+        QJsonObject obj;
+        obj.insert("id", airport.id);
+        obj.insert("ident", airport.ident);
+        obj.insert("name", airport.name);
+        obj.insert("longestRunwayLength", airport.longestRunwayLength);
+        obj.insert("lon", airport.position.getLonX());
+        obj.insert("lat", airport.position.getLatY());
+        airports.append(obj);
+      }
+    }
+    root.insert("airports", airports);
+
+    // VOR ================================================================
+    QJsonArray vors;
+    if(mapLayer->isVor())
+    {
+      for(const map::MapVor& vor : *mapQuery->getVors(box, mapLayer, false /* lazy */))
+      {
+        if(!rect.contains(vor.position))
+          continue;
+
+        QJsonObject obj;
+        obj.insert("id", vor.id);
+        obj.insert("ident", vor.ident);
+        obj.insert("name", vor.name);
+        obj.insert("type", vor.type);
+        obj.insert("frequency", vor.frequency);
+        obj.insert("lon", vor.position.getLonX());
+        obj.insert("lat", vor.position.getLatY());
+        vors.append(obj);
+      }
+    }
+    root.insert("vors", vors);
+
+    // NDB ================================================================
+    QJsonArray ndbs;
+    if(mapLayer->isNdb())
+    {
+      for(const map::MapNdb& ndb : *mapQuery->getNdbs(box, mapLayer, false /* lazy */))
+      {
+        if(!rect.contains(ndb.position))
+          continue;
+
+        QJsonObject obj;
+        obj.insert("id", ndb.id);
+        obj.insert("ident", ndb.ident);
+        obj.insert("name", ndb.name);
+        obj.insert("type", ndb.type);
+        obj.insert("frequency", ndb.frequency);
+        obj.insert("lon", ndb.position.getLonX());
+        obj.insert("lat", ndb.position.getLatY());
+        ndbs.append(obj);
+      }
+    }
+    root.insert("ndbs", ndbs);
+
+    // Waypoints ==========================================================
+    QJsonArray waypoints;
+    if(mapLayer->isWaypoint())
+    {
+      QList<map::MapWaypoint> waypointList;
+      NavApp::getWaypointTrackQuery()->getWaypoints(waypointList, box, mapLayer, false /* lazy */);
+      for(const map::MapWaypoint& waypoint : waypointList)
+      {
+        if(!rect.contains(waypoint.position))
+          continue;
+
+        QJsonObject obj;
+        obj.insert("id", waypoint.id);
+        obj.insert("ident", waypoint.ident);
+        obj.insert("region", waypoint.region);
+        obj.insert("lon", waypoint.position.getLonX());
+        obj.insert("lat", waypoint.position.getLatY());
+        waypoints.append(obj);
+      }
+    }
+    root.insert("waypoints", waypoints);
+
+    // Active flight plan =================================================
+    // Not culled to the viewport so clients can draw the whole plan
+    QJsonArray routeLegs;
+    const Route& route = NavApp::getRouteConst();
+    for(int i = 0; i < route.size(); i++)
+    {
+      const RouteLeg& leg = route.value(i);
+
+      QJsonObject obj;
+      obj.insert("ident", leg.getIdent());
+      obj.insert("type", leg.getMapObjectTypeName());
+      obj.insert("lon", leg.getPosition().getLonX());
+      obj.insert("lat", leg.getPosition().getLatY());
+      obj.insert("alt", leg.getPosition().getAltitude());
+      routeLegs.append(obj);
+    }
+    root.insert("route", routeLegs);
+    root.insert("activeLegIndex", route.isActiveValid() ? route.getActiveLegIndex() : -1);
+  }
+  else
+    qWarning() << Q_FUNC_INFO << "mapPaintWidget is null or rect is invalid";
+
+  return QJsonDocument(root).toJson(QJsonDocument::Compact);
+}
+
+QByteArray WebMapController::getGeoJson(quint32 trackTimestamp)
+{
+  if(verbose)
+    qDebug() << Q_FUNC_INFO << "trackTimestamp" << trackTimestamp;
+
+  QJsonArray features;
+
+  // Active flight plan =================================================
+  const Route& route = NavApp::getRouteConst();
+  if(!route.isEmpty())
+  {
+    QJsonArray coordinates, idents;
+    for(int i = 0; i < route.size(); i++)
+    {
+      const RouteLeg& leg = route.value(i);
+      coordinates.append(QJsonArray({leg.getPosition().getLonX(), leg.getPosition().getLatY(),
+                                     leg.getPosition().getAltitude()}));
+      idents.append(leg.getIdent());
+    }
+
+    QJsonObject geometry;
+    geometry.insert("type", "LineString");
+    geometry.insert("coordinates", coordinates);
+
+    QJsonObject properties;
+    properties.insert("type", "route");
+    properties.insert("idents", idents);
+    properties.insert("activeLegIndex", route.isActiveValid() ? route.getActiveLegIndex() : -1);
+
+    QJsonObject feature;
+    feature.insert("type", "Feature");
+    feature.insert("geometry", geometry);
+    feature.insert("properties", properties);
+    features.append(feature);
+  }
+
+  // Aircraft track =====================================================
+  // Only the points newer than the requested timestamp - clients append them to what they have
+  const AircraftTrack& track = NavApp::getAircraftTrack();
+  if(!track.isEmpty())
+  {
+    // Deltas are at the tail - scan backwards for the first point to send
+    int start = track.size();
+    while(start > 0 && track.at(start - 1).timestamp > trackTimestamp)
+      start--;
+
+    QJsonArray coordinates;
+    for(int i = start; i < track.size(); i++)
+    {
+      const at::AircraftTrackPos& trackPos = track.at(i);
+      coordinates.append(QJsonArray({trackPos.pos.getLonX(), trackPos.pos.getLatY(), trackPos.pos.getAltitude()}));
+    }
+
+    QJsonObject geometry;
+    geometry.insert("type", "LineString");
+    geometry.insert("coordinates", coordinates);
+
+    QJsonObject properties;
+    properties.insert("type", "track");
+    properties.insert("incremental", trackTimestamp > 0);
+    // Client sends this back as "tracktime" with the next poll to receive only newer points
+    properties.insert("newestTimestamp", static_cast<qint64>(track.last().timestamp));
+
+    QJsonObject feature;
+    feature.insert("type", "Feature");
+    feature.insert("geometry", geometry);
+    feature.insert("properties", properties);
+    features.append(feature);
+  }
+
+  // User aircraft ======================================================
+  const atools::fs::sc::SimConnectUserAircraft& aircraft = NavApp::getUserAircraft();
+  if(aircraft.getPosition().isValid())
+  {
+    QJsonObject geometry;
+    geometry.insert("type", "Point");
+    geometry.insert("coordinates", QJsonArray({aircraft.getPosition().getLonX(), aircraft.getPosition().getLatY(),
+                                               aircraft.getPosition().getAltitude()}));
+
+    QJsonObject properties;
+    properties.insert("type", "aircraft");
+    properties.insert("onGround", aircraft.isOnGround());
+    if(aircraft.getHeadingDegTrue() < atools::fs::sc::SC_INVALID_FLOAT)
+      properties.insert("headingTrue", aircraft.getHeadingDegTrue());
+    if(aircraft.getGroundSpeedKts() < atools::fs::sc::SC_INVALID_FLOAT)
+      properties.insert("groundSpeedKts", aircraft.getGroundSpeedKts());
+
+    QJsonObject feature;
+    feature.insert("type", "Feature");
+    feature.insert("geometry", geometry);
+    feature.insert("properties", properties);
+    features.append(feature);
+  }
+
+  QJsonObject root;
+  root.insert("type", "FeatureCollection");
+  root.insert("features", features);
+  return QJsonDocument(root).toJson(QJsonDocument::Compact);
+}
@@ -90,6 +90,16 @@ public:
   /* Zoom to rectangel on map. */
   MapPixmap getPixmapRect(int width, int height, atools::geo::Rect rect);
 
+  /* Get airports, navaids and the active flight plan inside the rectangle as compact JSON.
+   * distanceKm selects the feature detail level like the zoom distance does for map drawing. */
+  QByteArray getFeatureJson(atools::geo::Rect rect, float distanceKm);
+
+  /* Get the active flight plan, the aircraft track and the user aircraft as a GeoJSON
+   * FeatureCollection for external moving map consumers. The track line string only contains
+   * points newer than trackTimestamp (seconds since epoch) so polling clients receive the
+   * tail they do not have yet. Zero returns the whole track. */
+  QByteArray getGeoJson(quint32 trackTimestamp);
+
 private:
   MapPaintWidget *mapPaintWidget = nullptr;
   QWidget *parentWidget;
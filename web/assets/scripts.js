@@ -9,17 +9,26 @@ function focusAirportText() {
   document.getElementById("airporttext").focus();
 }
 
+/* ETag of the last received page content. Sent back with the next poll so the server can
+ * answer with an empty 304 if nothing changed. */
+var lastEtag = null;
+
 /*
  * Reload a part of the page "pageToReload" and replace the content of id="doc".
+ * A 304 response means the content is unchanged and the page is kept as is.
  */
 function reloadPage() {
   var xhttp = new XMLHttpRequest();
   xhttp.onreadystatechange = function() {
     if (this.readyState == 4 && this.status == 200) {
       document.getElementById("doc").innerHTML = this.responseText;
+      lastEtag = this.getResponseHeader("ETag");
     }
   };
   xhttp.open("GET", pageToReload, true);
+  if (lastEtag !== null) {
+    xhttp.setRequestHeader("If-None-Match", lastEtag);
+  }
   xhttp.send();
 }
 